@@ -0,0 +1,345 @@
+#include "Benchmark/BenchmarkRunner.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/XMLUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Transform.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/VulkanRenderer/VKRenderer.hpp"
+#include "Engine/VulkanRenderer/VKFunctions.hpp"
+#include "Engine/VulkanRenderer/VKCamera.hpp"
+#include "Engine/VulkanRenderer/VKMaterial.hpp"
+#include "Engine/VulkanRenderer/VKGpuProfiler.hpp"
+#include "Engine/VulkanRenderer/VKParticleEmitter.hpp"
+#include "Engine/VulkanRenderer/Mesh/VKMesh.hpp"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Returns the nearest rank percentile of sorted samples
+//
+static double GetPercentile( const std::vector<double>& sortedSamples, double percent )
+{
+	int rank = (int) ceil(percent / 100.0 * (double) sortedSamples.size());
+	int index = ClampInt(rank - 1, 0, (int) sortedSamples.size() - 1);
+	return sortedSamples[index];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the stats as a json object member
+//
+static void AppendStatsJson( std::string& out_json, const char* name, const BenchmarkStats& stats, bool isLast )
+{
+	char text[512];
+	snprintf(text, sizeof(text),
+		"\t\"%s\": {\"samples\": %d, \"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+		name, stats.m_sampleCount, stats.m_min, stats.m_mean, stats.m_p50, stats.m_p90, stats.m_p95, stats.m_p99, stats.m_max, isLast ? "" : ",");
+	out_json.append(text);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+BenchmarkRunner::BenchmarkRunner( const char* scenePath )
+{
+	LoadScene(scenePath);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+BenchmarkRunner::~BenchmarkRunner()
+{
+	DestroyScene();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads the scene description, missing elements leave that part of the scene out
+//
+void BenchmarkRunner::LoadScene( const char* scenePath )
+{
+	m_scenePath = scenePath;
+
+	tinyxml2::XMLDocument sceneDoc;
+	GUARANTEE_OR_DIE(sceneDoc.LoadFile(scenePath) == tinyxml2::XML_SUCCESS, Stringf("Could not load benchmark scene %s", scenePath));
+	const XMLElement* root = sceneDoc.FirstChildElement("Benchmark");
+	GUARANTEE_OR_DIE(root != nullptr, "Benchmark scene needs a Benchmark root element");
+
+	m_name = ParseXmlAttribute(*root, "name", std::string("benchmark"));
+	m_width = (uint32_t) ParseXmlAttribute(*root, "width", (int) m_width);
+	m_height = (uint32_t) ParseXmlAttribute(*root, "height", (int) m_height);
+	m_warmupFrames = ParseXmlAttribute(*root, "warmupFrames", m_warmupFrames);
+	m_frameCount = ParseXmlAttribute(*root, "frames", m_frameCount);
+	m_deltaSeconds = ParseXmlAttribute(*root, "deltaSeconds", m_deltaSeconds);
+	m_outputPath = ParseXmlAttribute(*root, "output", std::string("Data/Benchmarks/") + m_name + ".results.json");
+	m_screenshotPath = ParseXmlAttribute(*root, "screenshot", std::string(""));
+
+	const XMLElement* meshes = root->FirstChildElement("Meshes");
+	if(meshes)
+	{
+		m_meshCount = ParseXmlAttribute(*meshes, "count", 1);
+		m_meshPath = ParseXmlAttribute(*meshes, "mesh", std::string("Cube"));
+		m_meshMaterialPath = ParseXmlAttribute(*meshes, "material", std::string("Data/Materials/vulkantest.mat"));
+		m_meshSpacing = ParseXmlAttribute(*meshes, "spacing", m_meshSpacing);
+		m_meshScale = ParseXmlAttribute(*meshes, "scale", m_meshScale);
+	}
+
+	const XMLElement* particles = root->FirstChildElement("Particles");
+	if(particles)
+	{
+		m_emitterCount = ParseXmlAttribute(*particles, "emitters", 1);
+		m_maxParticles = ParseXmlAttribute(*particles, "maxParticles", m_maxParticles);
+		m_spawnRate = ParseXmlAttribute(*particles, "spawnRate", m_spawnRate);
+		m_particleMaterialPath = ParseXmlAttribute(*particles, "material", std::string("Data/Materials/vulkan_particle.mat"));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lays the meshes out on a square grid on the XZ plane with the emitters above it, and points
+// the camera at the middle from above
+//
+void BenchmarkRunner::CreateScene()
+{
+	m_renderer->InitializeDefaultMeshes(); // Cube, Sphere and Quad
+
+	int gridSize = (int) ceil(sqrt((double) m_meshCount));
+	float halfExtent = 0.5f * m_meshSpacing * (float) (gridSize - 1);
+
+	if(m_meshCount > 0)
+	{
+		m_mesh = m_renderer->CreateOrGetMesh(m_meshPath);
+		m_meshMaterial = m_renderer->CreateOrGetMaterial(m_meshMaterialPath);
+
+		Transform model;
+		model.SetScaleUniform(m_meshScale);
+		for(int meshIndex = 0; meshIndex < m_meshCount; ++meshIndex)
+		{
+			float x = (float) (meshIndex % gridSize) * m_meshSpacing - halfExtent;
+			float z = (float) (meshIndex / gridSize) * m_meshSpacing - halfExtent;
+			model.SetPosition(Vector3(x, 0.f, z));
+			model.SetEulerAngles(Vector3(0.f, (float) (meshIndex * 37 % 360), 0.f));
+			m_meshModels.push_back(model.GetWorldMatrix());
+		}
+	}
+
+	if(m_emitterCount > 0)
+	{
+		m_particleMaterial = m_renderer->CreateOrGetMaterial(m_particleMaterialPath);
+		for(int emitterIndex = 0; emitterIndex < m_emitterCount; ++emitterIndex)
+		{
+			VKParticleEmitter* emitter = new VKParticleEmitter(m_renderer, m_maxParticles);
+			emitter->SetMaterial(m_particleMaterial);
+			emitter->SetVelocity(Vector3(0.f, 4.f, 0.f));
+			emitter->SetForce(Vector3(0.f, -2.f, 0.f));
+			float offset = (m_emitterCount > 1) ? ((float) emitterIndex / (float) (m_emitterCount - 1) - 0.5f) * 2.f * halfExtent : 0.f;
+			emitter->m_transform->SetPosition(Vector3(offset, 1.f, 0.f));
+			m_emitters.push_back(emitter);
+		}
+	}
+
+	float cameraDistance = Max(halfExtent * 2.f, 5.f);
+	m_camera = new VKCamera(m_renderer);
+	m_camera->SetColorTarget(m_renderer->GetDefaultColorTarget());
+	m_camera->SetDepthTarget(m_renderer->GetDefaultDepthTarget());
+	m_camera->SetPerspective(60.f, (float) m_width / (float) m_height, 0.1f, 1000.f);
+	m_camera->LookAt(Vector3(0.f, cameraDistance, -cameraDistance), Vector3::ZERO);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Frees what CreateScene made, meshes and materials belong to the renderer
+//
+void BenchmarkRunner::DestroyScene()
+{
+	for(VKParticleEmitter* emitter : m_emitters)
+	{
+		delete emitter;
+	}
+	m_emitters.clear();
+	m_meshModels.clear();
+
+	delete m_camera;
+	m_camera = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs the warmup and the measured frames, then the frames it takes for the last GPU results to
+// come back. Saves the screenshot last if one was asked for
+//
+void BenchmarkRunner::Run()
+{
+	m_renderer = VKRenderer::GetInstance();
+	GUARANTEE_OR_DIE(m_renderer != nullptr && m_renderer->IsHeadless(), "The benchmark needs a headless renderer");
+
+	VkPhysicalDeviceProperties deviceProp;
+	vkGetPhysicalDeviceProperties(m_renderer->GetPhysicalDevice(), &deviceProp);
+	m_deviceName = deviceProp.deviceName;
+
+	CreateScene();
+	m_cpuFrameMs.reserve(m_frameCount);
+	m_gpuFrameMs.reserve(m_frameCount);
+
+	DebuggerPrintf("\nBenchmark %s on %s: %d warmup frames, %d measured frames\n", m_name.c_str(), m_deviceName.c_str(), m_warmupFrames, m_frameCount);
+	for(int frameIndex = 0; frameIndex < m_warmupFrames; ++frameIndex)
+	{
+		RunFrame(false);
+	}
+	for(int frameIndex = 0; frameIndex < m_frameCount; ++frameIndex)
+	{
+		RunFrame(true);
+	}
+
+	// Nothing is drawn, the frames only read the last results back
+	for(int frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; ++frameIndex)
+	{
+		m_renderer->BeginFrame();
+		SampleGpuTime();
+		m_renderer->EndFrame();
+	}
+
+	if(!m_screenshotPath.empty())
+	{
+		m_renderer->SaveColorTargetToPng(m_screenshotPath.c_str());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs one frame on the fixed timestep, the CPU time covers everything from BeginFrame to EndFrame
+//
+void BenchmarkRunner::RunFrame( bool isMeasured )
+{
+	Profiler::GetInstance()->MarkFrame();
+	PROFILE_SCOPE("BenchmarkRunner::RunFrame");
+	uint64_t startHpc = Time::GetPerformanceCounter();
+
+	Clock::GetMasterClock()->BeginFrame();
+	JobSystem::GetInstance()->BeginFrame();
+	m_renderer->BeginFrame();
+	SampleGpuTime();
+	m_gpuPendingFrames.push_back(isMeasured);
+
+	// Spawn from the timestep instead of the clock so every run spawns the same particles
+	m_spawnCarry += m_spawnRate * m_deltaSeconds;
+	int spawnCount = (int) m_spawnCarry;
+	m_spawnCarry -= (float) spawnCount;
+	for(VKParticleEmitter* emitter : m_emitters)
+	{
+		emitter->SpawnBurst(spawnCount);
+		emitter->Update(m_deltaSeconds);
+	}
+
+	Render();
+
+	Clock::GetMasterClock()->EndFrame();
+	m_renderer->EndFrame();
+
+	if(isMeasured)
+	{
+		m_cpuFrameMs.push_back(Time::HpcToSeconds(Time::GetPerformanceCounter() - startHpc) * 1000.0);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws the mesh grid then the emitters
+//
+void BenchmarkRunner::Render() const
+{
+	PROFILE_SCOPE_FUNCTION();
+	m_renderer->SetCamera(m_camera);
+
+	if(m_mesh)
+	{
+		m_renderer->SetMaterial(m_meshMaterial);
+		for(const Matrix44& model : m_meshModels)
+		{
+			m_renderer->DrawMesh(*m_mesh, model);
+		}
+	}
+
+	for(VKParticleEmitter* emitter : m_emitters)
+	{
+		emitter->Render();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// The GPU profiler reads a frame back when its slot comes around again. Every frame records GPU
+// work, so each new read back belongs to the oldest frame still waiting
+//
+void BenchmarkRunner::SampleGpuTime()
+{
+	VKGpuProfiler* gpuProfiler = m_renderer->GetGpuProfiler();
+	if(gpuProfiler->GetReadBackCount() == m_lastGpuReadBack || m_gpuPendingFrames.empty())
+	{
+		return;
+	}
+	m_lastGpuReadBack = gpuProfiler->GetReadBackCount();
+
+	bool isMeasured = m_gpuPendingFrames.front();
+	m_gpuPendingFrames.pop_front();
+	if(isMeasured)
+	{
+		m_gpuFrameMs.push_back(gpuProfiler->GetLastBusyMs());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the min, mean, max and percentiles of the samples
+//
+STATIC BenchmarkStats BenchmarkRunner::ComputeStats( std::vector<double> samples )
+{
+	BenchmarkStats stats;
+	stats.m_sampleCount = (int) samples.size();
+	if(samples.empty())
+	{
+		return stats;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double total = 0.0;
+	for(double sample : samples)
+	{
+		total += sample;
+	}
+
+	stats.m_min = samples.front();
+	stats.m_max = samples.back();
+	stats.m_mean = total / (double) samples.size();
+	stats.m_p50 = GetPercentile(samples, 50.0);
+	stats.m_p90 = GetPercentile(samples, 90.0);
+	stats.m_p95 = GetPercentile(samples, 95.0);
+	stats.m_p99 = GetPercentile(samples, 99.0);
+	return stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the scene settings and the CPU and GPU frame time stats to the output json
+//
+bool BenchmarkRunner::WriteResults() const
+{
+	BenchmarkStats cpuStats = ComputeStats(m_cpuFrameMs);
+	BenchmarkStats gpuStats = ComputeStats(m_gpuFrameMs);
+
+	std::string json = "{\n";
+	json.append(Stringf("\t\"name\": \"%s\",\n", m_name.c_str()));
+	json.append(Stringf("\t\"scene\": \"%s\",\n", m_scenePath.c_str()));
+	json.append(Stringf("\t\"device\": \"%s\",\n", m_deviceName.c_str()));
+	json.append(Stringf("\t\"width\": %u,\n\t\"height\": %u,\n", m_width, m_height));
+	json.append(Stringf("\t\"warmupFrames\": %d,\n\t\"frames\": %d,\n", m_warmupFrames, m_frameCount));
+	json.append(Stringf("\t\"meshes\": %d,\n\t\"particleEmitters\": %d,\n\t\"maxParticles\": %d,\n", m_meshCount, m_emitterCount, m_maxParticles));
+	AppendStatsJson(json, "cpuFrameMs", cpuStats, false);
+	AppendStatsJson(json, "gpuFrameMs", gpuStats, true);
+	json.append("}\n");
+
+	DebuggerPrintf("\nBenchmark %s: CPU p50 %.3f ms p99 %.3f ms, GPU p50 %.3f ms p99 %.3f ms\n", m_name.c_str(), cpuStats.m_p50, cpuStats.m_p99, gpuStats.m_p50, gpuStats.m_p99);
+	return FileWriteToNewFile(m_outputPath.c_str(), json.c_str(), json.size());
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "Engine/Math/Matrix44.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class VKCamera;
+class VKMaterial;
+class VKMesh;
+class VKParticleEmitter;
+class VKRenderer;
+
+//-----------------------------------------------------------------------------------------------
+// Distribution of one frame time series, in milliseconds
+//
+struct BenchmarkStats
+{
+	int		m_sampleCount = 0;
+	double	m_min = 0.0;
+	double	m_mean = 0.0;
+	double	m_p50 = 0.0;
+	double	m_p90 = 0.0;
+	double	m_p95 = 0.0;
+	double	m_p99 = 0.0;
+	double	m_max = 0.0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Runs a scene described by a benchmark xml on the headless renderer for a fixed number of
+// frames with a fixed timestep, so runs on different machines render the same thing. CPU frame
+// time is measured from BeginFrame to EndFrame, GPU time is the sum of the GPU profiler's scopes
+//
+class BenchmarkRunner
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	BenchmarkRunner( const char* scenePath );
+	~BenchmarkRunner();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			uint32_t			GetWidth() const { return m_width; }
+			uint32_t			GetHeight() const { return m_height; }
+	const	std::string&		GetOutputPath() const { return m_outputPath; }
+			void				SetOutputPath( const std::string& path ) { m_outputPath = path; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				Run(); // Needs the headless renderer to be started
+			bool				WriteResults() const;
+	static	BenchmarkStats		ComputeStats( std::vector<double> samples );
+
+private:
+			void				LoadScene( const char* scenePath );
+			void				CreateScene();
+			void				DestroyScene();
+			void				RunFrame( bool isMeasured );
+			void				Render() const;
+			void				SampleGpuTime(); // Pairs a new GPU read back with the frame it belongs to
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+private:
+	// Scene description
+	std::string					m_name;
+	std::string					m_scenePath;
+	std::string					m_outputPath;
+	std::string					m_screenshotPath;
+	uint32_t					m_width = 1280;
+	uint32_t					m_height = 720;
+	int							m_warmupFrames = 60;
+	int							m_frameCount = 600;
+	float						m_deltaSeconds = 1.f / 60.f;
+	std::string					m_meshPath;
+	std::string					m_meshMaterialPath;
+	int							m_meshCount = 0;
+	float						m_meshSpacing = 2.f;
+	float						m_meshScale = 1.f;
+	std::string					m_particleMaterialPath;
+	int							m_emitterCount = 0;
+	int							m_maxParticles = 65536;
+	float						m_spawnRate = 1000.f;		// Spawned as bursts on the fixed timestep
+	float						m_spawnCarry = 0.f;
+
+	// Scene state
+	VKRenderer*						m_renderer = nullptr;
+	VKCamera*						m_camera = nullptr;
+	VKMesh*							m_mesh = nullptr;
+	VKMaterial*						m_meshMaterial = nullptr;
+	VKMaterial*						m_particleMaterial = nullptr;
+	std::vector<Matrix44>			m_meshModels;
+	std::vector<VKParticleEmitter*>	m_emitters;
+
+	// Results
+	std::vector<double>				m_cpuFrameMs;
+	std::vector<double>				m_gpuFrameMs;
+	std::deque<bool>				m_gpuPendingFrames;		// Measured flag of the frames still waiting for GPU results, oldest first
+	uint32_t						m_lastGpuReadBack = 0;
+	std::string						m_deviceName;
+};
@@ -0,0 +1,113 @@
+#define WIN32_LEAN_AND_MEAN		// Always #define this before #including <windows.h>
+#include <windows.h>
+#include "Benchmark/BenchmarkRunner.hpp"
+#include "Benchmark/MicroBenchmarks.hpp"
+#include "Benchmark/SelfTests.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/TransformSystem.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/VulkanRenderer/VKRenderer.hpp"
+#include <stdio.h>
+#include <string.h>
+
+const char* APP_NAME = "Basic Triangle Benchmark";
+const char* DEFAULT_SCENE_PATH = "Data/Benchmarks/default.bench.xml";
+
+//-----------------------------------------------------------------------------------------------
+// Runs the CPU micro benchmarks, no renderer is created
+//
+static int RunMicroBenchmarks( int argc, char** argv )
+{
+	MicroBenchmarkSuite* suite = new MicroBenchmarkSuite((argc > 2) ? argv[2] : "");
+	if(argc > 3)
+	{
+		suite->SetOutputPath(argv[3]);
+	}
+
+	Clock::CreateMasterClock();
+	Profiler::CreateInstance();
+	JobSystem::CreateInstance();
+
+	suite->Run();
+	bool isWritten = suite->WriteResults();
+	printf("%s %s\n", isWritten ? "Wrote" : "Could not write", suite->GetOutputPath().c_str());
+
+	delete suite;
+	JobSystem::DestroyInstance();
+	Profiler::DestroyInstance();
+
+	return isWritten ? 0 : 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs the correctness checks, no renderer is created. Returns the number of failures
+//
+static int RunSelfTests( int argc, char** argv )
+{
+	SelfTestSuite* suite = new SelfTestSuite((argc > 2) ? argv[2] : "");
+
+	Clock::CreateMasterClock();
+	Profiler::CreateInstance();
+	JobSystem::CreateInstance();
+
+	suite->Run();
+	int failureCount = suite->GetFailureCount();
+	printf("%d of %d checks failed\n", failureCount, suite->GetCheckCount());
+
+	delete suite;
+	JobSystem::DestroyInstance();
+	Profiler::DestroyInstance();
+
+	return failureCount;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs a benchmark scene on the headless renderer and writes its frame time stats. Runs from
+// Run_Win32 so the scene's data paths resolve
+//
+//	Benchmark.exe [scene.bench.xml] [results.json]
+//	Benchmark.exe --micro [case] [results.json]
+//	Benchmark.exe --test [case]
+//
+int main( int argc, char** argv )
+{
+	if(argc > 1 && strcmp(argv[1], "--micro") == 0)
+	{
+		return RunMicroBenchmarks(argc, argv);
+	}
+
+	if(argc > 1 && strcmp(argv[1], "--test") == 0)
+	{
+		return RunSelfTests(argc, argv);
+	}
+
+	const char* scenePath = (argc > 1) ? argv[1] : DEFAULT_SCENE_PATH;
+
+	BenchmarkRunner* runner = new BenchmarkRunner(scenePath);
+	if(argc > 2)
+	{
+		runner->SetOutputPath(argv[2]);
+	}
+
+	Clock::CreateMasterClock();
+	Profiler::CreateInstance();
+	JobSystem::CreateInstance();
+	VkRenderStartup();
+	VKRenderer::CreateHeadlessInstance(APP_NAME, runner->GetWidth(), runner->GetHeight());
+	VKRenderer::GetInstance()->PostStartup();
+
+	runner->Run();
+	bool isWritten = runner->WriteResults();
+	printf("%s %s\n", isWritten ? "Wrote" : "Could not write", runner->GetOutputPath().c_str());
+
+	delete runner; // Scene objects go before the renderer
+	VKRenderer::DestroyInstance();
+	TransformSystem::DestroyInstance();
+	JobSystem::DestroyInstance();
+	Profiler::DestroyInstance();
+
+	return isWritten ? 0 : 1;
+}
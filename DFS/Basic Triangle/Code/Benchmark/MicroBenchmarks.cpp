@@ -0,0 +1,848 @@
+#include "Benchmark/MicroBenchmarks.hpp"
+#include "Benchmark/ScalarReference.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Vertex.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/BVH.hpp"
+#include "Engine/Math/Disc3.hpp"
+#include "Engine/Math/Frustum.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Ray3.hpp"
+#include "Engine/Renderer/ParticlePool.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr int BENCHMARK_OBJECT_COUNTS[] = { 1000, 10000, 100000 };
+constexpr int BENCHMARK_MATRIX_COUNTS[] = { 1000, 100000 };
+constexpr int BENCHMARK_ROTATION_COUNT = 10000;
+constexpr int BENCHMARK_PARTICLE_COUNTS[] = { 10000, 100000, 250000, 1000000 };
+constexpr int BENCHMARK_EMPTY_JOB_COUNT = 10000;
+constexpr int BENCHMARK_PARALLEL_FOR_COUNT = 1 << 22;
+constexpr float BENCHMARK_INTERPOLATION_FRACTIONS[] = { 0.25f, 0.5f, 0.75f };
+
+//-----------------------------------------------------------------------------------------------
+// Results go through here so the optimizer can't drop the timed work
+static volatile int s_resultSink = 0;
+
+//-----------------------------------------------------------------------------------------------
+// Returns a random point in the box
+//
+static Vector3 GetRandomPointInBox( const Vector3& mins, const Vector3& maxs )
+{
+	return Vector3(GetRandomFloatInRange(mins.x, maxs.x), GetRandomFloatInRange(mins.y, maxs.y), GetRandomFloatInRange(mins.z, maxs.z));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a random rotation, translation and scale like the scene graph builds
+//
+static Matrix44 GetRandomTRS()
+{
+	Vector3 translation = GetRandomPointInBox(Vector3(-100.f), Vector3(100.f));
+	Vector3 eulerDegrees = GetRandomPointInBox(Vector3(-180.f), Vector3(180.f));
+	Vector3 scale = GetRandomPointInBox(Vector3(0.5f), Vector3(2.f));
+	return Matrix44::MakeTRS(translation, eulerDegrees, scale);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns how far the basis is from orthonormal, the worst of the lengths and the cross dots
+//
+static float GetOrthonormalError( const Matrix44& mat )
+{
+	Vector3 right(mat.Ix, mat.Iy, mat.Iz);
+	Vector3 up(mat.Jx, mat.Jy, mat.Jz);
+	Vector3 forward(mat.Kx, mat.Ky, mat.Kz);
+
+	float error = fabsf(right.GetLength() - 1.f);
+	error = Max(error, fabsf(up.GetLength() - 1.f));
+	error = Max(error, fabsf(forward.GetLength() - 1.f));
+	error = Max(error, fabsf(DotProduct(right, up)));
+	error = Max(error, fabsf(DotProduct(up, forward)));
+	error = Max(error, fabsf(DotProduct(forward, right)));
+	return error;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the angle in degrees between the rotations of two matrices, from the trace of
+// a^T * b over the normalized bases
+//
+static float GetRotationAngleBetween( const Matrix44& a, const Matrix44& b )
+{
+	float trace = DotProduct(a.GetRight(), b.GetRight()) + DotProduct(a.GetUp(), b.GetUp()) + DotProduct(a.GetForward(), b.GetForward());
+	float cosAngle = ClampFloat(0.5f * (trace - 1.f), -1.f, 1.f);
+	return ConvertRadiansToDegrees(acosf(cosAngle));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the largest element difference between two matrices
+//
+static float GetMaxElementError( const Matrix44& a, const Matrix44& b )
+{
+	float error = 0.f;
+	for(int elementIndex = 0; elementIndex < 16; ++elementIndex)
+	{
+		error = Max(error, fabsf(a.data[elementIndex] - b.data[elementIndex]));
+	}
+
+	return error;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Scene queries through the BVH against the linear scan RenderScene used to do. Objects are
+// spread so the density stays the same at every count, the camera looks across the world
+//
+static void RunBVHCase( MicroBenchmarkSuite& suite )
+{
+	constexpr int SPHERE_QUERY_COUNT = 256;
+	constexpr int RAY_QUERY_COUNT = 64;
+
+	for(int objectCount : BENCHMARK_OBJECT_COUNTS)
+	{
+		float worldSize = 4.f * cbrtf((float) objectCount);
+		Vector3 worldMins(-0.5f * worldSize);
+		Vector3 worldMaxs(0.5f * worldSize);
+
+		std::vector<AABB3> boxes;
+		boxes.reserve(objectCount);
+		for(int objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+		{
+			Vector3 center = GetRandomPointInBox(worldMins, worldMaxs);
+			Vector3 halfExtents = GetRandomPointInBox(Vector3(0.25f), Vector3(1.f));
+			boxes.push_back(AABB3(center - halfExtents, center + halfExtents));
+		}
+
+		Matrix44 view = Matrix44::InvertFast(Matrix44::LookAt(Vector3(0.f, 0.f, -0.5f * worldSize), Vector3::ZERO));
+		Matrix44 projection = Matrix44::MakePerspectiveMatrix(60.f, 16.f / 9.f, 0.1f, worldSize);
+		Frustum frustum(projection * view);
+
+		std::vector<Disc3> spheres;
+		for(int sphereIndex = 0; sphereIndex < SPHERE_QUERY_COUNT; ++sphereIndex)
+		{
+			spheres.push_back(Disc3(GetRandomPointInBox(worldMins, worldMaxs), 5.f));
+		}
+
+		std::vector<Ray3> rays;
+		for(int rayIndex = 0; rayIndex < RAY_QUERY_COUNT; ++rayIndex)
+		{
+			Vector3 direction = GetRandomPointInBox(Vector3(-1.f), Vector3(1.f));
+			rays.push_back(Ray3(GetRandomPointInBox(worldMins, worldMaxs), direction.GetNormalized()));
+		}
+
+		std::vector<void*> results;
+		std::vector<int> offsets;
+
+		// Build
+		suite.Measure("bvh", "build", objectCount, 5, [&]()
+		{
+			BVH tree;
+			for(int objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+			{
+				tree.CreateProxy(boxes[objectIndex], &boxes[objectIndex]);
+			}
+			s_resultSink += tree.GetHeight();
+		});
+
+		BVH tree;
+		std::vector<int> proxies;
+		for(int objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+		{
+			proxies.push_back(tree.CreateProxy(boxes[objectIndex], &boxes[objectIndex]));
+		}
+
+		// Frustum
+		suite.Measure("bvh", "frustum_bvh", objectCount, 30, [&]()
+		{
+			results.clear();
+			tree.QueryFrustum(frustum, results);
+			s_resultSink += (int) results.size();
+		});
+
+		suite.Measure("bvh", "frustum_linear", objectCount, 30, [&]()
+		{
+			results.clear();
+			for(AABB3& box : boxes)
+			{
+				if(frustum.IsAABBVisible(box))
+				{
+					results.push_back(&box);
+				}
+			}
+			s_resultSink += (int) results.size();
+		});
+
+		// Spheres, as the batched light and shadow queries do
+		suite.Measure("bvh", "spheres_bvh", objectCount, 10, [&]()
+		{
+			tree.QuerySpheres(spheres.data(), (int) spheres.size(), results, offsets);
+			s_resultSink += (int) results.size();
+		});
+
+		suite.Measure("bvh", "spheres_linear", objectCount, 10, [&]()
+		{
+			results.clear();
+			for(const Disc3& sphere : spheres)
+			{
+				for(AABB3& box : boxes)
+				{
+					if(DoesSphereOverlapAABB(sphere, box))
+					{
+						results.push_back(&box);
+					}
+				}
+			}
+			s_resultSink += (int) results.size();
+		});
+
+		// Rays
+		suite.Measure("bvh", "rays_bvh", objectCount, 10, [&]()
+		{
+			results.clear();
+			for(const Ray3& ray : rays)
+			{
+				tree.Raycast(ray, worldSize, results);
+			}
+			s_resultSink += (int) results.size();
+		});
+
+		suite.Measure("bvh", "rays_linear", objectCount, 10, [&]()
+		{
+			results.clear();
+			for(const Ray3& ray : rays)
+			{
+				for(AABB3& box : boxes)
+				{
+					if(RayCheckAABB(ray, box, worldSize))
+					{
+						results.push_back(&box);
+					}
+				}
+			}
+			s_resultSink += (int) results.size();
+		});
+
+		// A tenth of the objects moving each frame. Within the fat margin MoveProxy only checks
+		// containment, past it every moved leaf is removed and reinserted
+		int moveCount = objectCount / 10;
+		int movedCount = 0;
+		int reinsertedCount = 0;
+		float moveOffset = 0.f;
+		auto moveTenth = [&](float distance)
+		{
+			moveOffset = (moveOffset > 0.f) ? -distance : distance;
+			for(int moveIndex = 0; moveIndex < moveCount; ++moveIndex)
+			{
+				AABB3& box = boxes[moveIndex * 10];
+				box = AABB3(box.mins + Vector3(moveOffset), box.maxs + Vector3(moveOffset));
+				reinsertedCount += tree.MoveProxy(proxies[moveIndex * 10], box) ? 1 : 0;
+			}
+			movedCount += moveCount;
+		};
+
+		suite.Measure("bvh", "refit_within_margin", moveCount, 30, [&]() { moveTenth(0.25f * tree.GetFatMargin()); });
+		suite.Record("bvh", "refit_within_margin", "reinserted_fraction", moveCount, (double) reinsertedCount / (double) movedCount);
+
+		movedCount = 0;
+		reinsertedCount = 0;
+		suite.Measure("bvh", "refit_10_percent", moveCount, 30, [&]() { moveTenth(5.f * tree.GetFatMargin()); });
+		suite.Record("bvh", "refit_10_percent", "reinserted_fraction", moveCount, (double) reinsertedCount / (double) movedCount);
+		GUARANTEE_OR_DIE(reinsertedCount == movedCount, "Refit benchmark moved boxes without leaving their fat bounds");
+		s_resultSink += tree.GetHeight();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Matrix44's SIMD paths against the scalar math they replaced. The per-call variants go through
+// the same entry points the engine uses one matrix at a time, the batch variants through the
+// array overloads
+//
+static void RunMatrixCase( MicroBenchmarkSuite& suite )
+{
+	for(int matrixCount : BENCHMARK_MATRIX_COUNTS)
+	{
+		std::vector<Matrix44> matrices;
+		std::vector<Vector3> positions;
+		std::vector<AABB3> boxes;
+		matrices.reserve(matrixCount);
+		positions.reserve(matrixCount);
+		boxes.reserve(matrixCount);
+		for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+		{
+			matrices.push_back(GetRandomTRS());
+			positions.push_back(GetRandomPointInBox(Vector3(-100.f), Vector3(100.f)));
+
+			Vector3 center = positions.back();
+			Vector3 halfExtents = GetRandomPointInBox(Vector3(0.25f), Vector3(4.f));
+			boxes.push_back(AABB3(center - halfExtents, center + halfExtents));
+		}
+
+		Matrix44 parent = GetRandomTRS();
+		std::vector<Matrix44> outMatrices(matrixCount);
+		std::vector<Vector3> outPositions(matrixCount);
+		std::vector<AABB3> outBoxes(matrixCount);
+
+		// Multiply
+		suite.Measure("matrix", "multiply_scalar", matrixCount, 30, [&]()
+		{
+			for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+			{
+				outMatrices[matrixIndex] = ReferenceMultiply(parent, matrices[matrixIndex]);
+			}
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		suite.Measure("matrix", "multiply_simd", matrixCount, 30, [&]()
+		{
+			for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+			{
+				Matrix44::MatrixMultiply(parent, matrices[matrixIndex], outMatrices[matrixIndex]);
+			}
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		suite.Measure("matrix", "multiply_batch", matrixCount, 30, [&]()
+		{
+			Matrix44::MultiplyBatch(parent, matrices.data(), outMatrices.data(), matrixCount);
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		// Inverse
+		suite.Measure("matrix", "invert_scalar", matrixCount, 30, [&]()
+		{
+			for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+			{
+				outMatrices[matrixIndex] = ReferenceInvert(matrices[matrixIndex]);
+			}
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		suite.Measure("matrix", "invert_simd", matrixCount, 30, [&]()
+		{
+			for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+			{
+				outMatrices[matrixIndex] = Matrix44::Invert(matrices[matrixIndex]);
+			}
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		suite.Measure("matrix", "invert_affine", matrixCount, 30, [&]()
+		{
+			for(int matrixIndex = 0; matrixIndex < matrixCount; ++matrixIndex)
+			{
+				outMatrices[matrixIndex] = Matrix44::InvertAffine(matrices[matrixIndex]);
+			}
+			s_resultSink += (int) outMatrices.back().Tx;
+		});
+
+		// Points
+		suite.Measure("matrix", "transform_scalar", matrixCount, 30, [&]()
+		{
+			for(int positionIndex = 0; positionIndex < matrixCount; ++positionIndex)
+			{
+				outPositions[positionIndex] = ReferenceTransformPosition(parent, positions[positionIndex]);
+			}
+			s_resultSink += (int) outPositions.back().x;
+		});
+
+		suite.Measure("matrix", "transform_simd", matrixCount, 30, [&]()
+		{
+			for(int positionIndex = 0; positionIndex < matrixCount; ++positionIndex)
+			{
+				outPositions[positionIndex] = parent.TransformPosition3D(positions[positionIndex]);
+			}
+			s_resultSink += (int) outPositions.back().x;
+		});
+
+		suite.Measure("matrix", "transform_batch", matrixCount, 30, [&]()
+		{
+			Matrix44::TransformPositions3D(parent, positions.data(), outPositions.data(), matrixCount);
+			s_resultSink += (int) outPositions.back().x;
+		});
+
+		// Bounds
+		suite.Measure("matrix", "aabb_scalar", matrixCount, 30, [&]()
+		{
+			for(int boxIndex = 0; boxIndex < matrixCount; ++boxIndex)
+			{
+				outBoxes[boxIndex] = ReferenceTransformAABB(parent, boxes[boxIndex]);
+			}
+			s_resultSink += (int) outBoxes.back().mins.x;
+		});
+
+		suite.Measure("matrix", "aabb_batch", matrixCount, 30, [&]()
+		{
+			Matrix44::TransformAABBs(parent, boxes.data(), outBoxes.data(), matrixCount);
+			s_resultSink += (int) outBoxes.back().mins.x;
+		});
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rotation storage. Times rebuilding a local matrix the old way (three appends), with the euler
+// MakeTRS and with the quaternion MakeTRS, then interpolation through euler angles, per basis
+// slerp (the old Matrix44 Interpolate), nlerp and slerp. Quality is recorded against quaternion
+// slerp: how far off orthonormal each result is and how many degrees it strays from slerp
+//
+static void RunQuaternionCase( MicroBenchmarkSuite& suite )
+{
+	int count = BENCHMARK_ROTATION_COUNT;
+
+	std::vector<Vector3> translations;
+	std::vector<Vector3> eulers;
+	std::vector<Vector3> scales;
+	std::vector<Quaternion> rotations;
+	for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+	{
+		translations.push_back(GetRandomPointInBox(Vector3(-100.f), Vector3(100.f)));
+		eulers.push_back(GetRandomPointInBox(Vector3(-180.f), Vector3(180.f)));
+		scales.push_back(GetRandomPointInBox(Vector3(0.5f), Vector3(2.f)));
+		rotations.push_back(Quaternion::MakeFromEuler(eulers.back()));
+	}
+
+	std::vector<Matrix44> outMatrices(count);
+
+	// Recompute
+	suite.Measure("quaternion", "recompute_append", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = ReferenceMakeTRS(translations[rotationIndex], eulers[rotationIndex], scales[rotationIndex]);
+		}
+		s_resultSink += (int) outMatrices.back().Tx;
+	});
+
+	suite.Measure("quaternion", "recompute_euler", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = Matrix44::MakeTRS(translations[rotationIndex], eulers[rotationIndex], scales[rotationIndex]);
+		}
+		s_resultSink += (int) outMatrices.back().Tx;
+	});
+
+	suite.Measure("quaternion", "recompute_quaternion", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = Matrix44::MakeTRS(translations[rotationIndex], rotations[rotationIndex], scales[rotationIndex]);
+		}
+		s_resultSink += (int) outMatrices.back().Tx;
+	});
+
+	float eulerError = 0.f;
+	float quaternionError = 0.f;
+	for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+	{
+		Matrix44 expected = ReferenceMakeTRS(translations[rotationIndex], eulers[rotationIndex], scales[rotationIndex]);
+		eulerError = Max(eulerError, GetMaxElementError(Matrix44::MakeTRS(translations[rotationIndex], eulers[rotationIndex], scales[rotationIndex]), expected));
+		quaternionError = Max(quaternionError, GetMaxElementError(Matrix44::MakeTRS(translations[rotationIndex], rotations[rotationIndex], scales[rotationIndex]), expected));
+	}
+	suite.Record("quaternion", "recompute_euler", "max_error", count, eulerError);
+	suite.Record("quaternion", "recompute_quaternion", "max_error", count, quaternionError);
+
+	// Interpolate between neighbouring rotations, a quarter of the way along
+	std::vector<Matrix44> rotationMatrices;
+	for(int rotationIndex = 0; rotationIndex < count; ++rotationIndex)
+	{
+		rotationMatrices.push_back(Matrix44::MakeRotation3D(eulers[rotationIndex]));
+	}
+
+	suite.Measure("quaternion", "interpolate_euler", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex + 1 < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = Matrix44::MakeRotation3D(Interpolate(eulers[rotationIndex], eulers[rotationIndex + 1], 0.25f));
+		}
+		s_resultSink += (int) outMatrices.front().Ix;
+	});
+
+	suite.Measure("quaternion", "interpolate_basis", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex + 1 < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = ReferenceInterpolate(rotationMatrices[rotationIndex], rotationMatrices[rotationIndex + 1], 0.25f);
+		}
+		s_resultSink += (int) outMatrices.front().Ix;
+	});
+
+	suite.Measure("quaternion", "interpolate_nlerp", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex + 1 < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = Nlerp(rotations[rotationIndex], rotations[rotationIndex + 1], 0.25f).GetMatrix();
+		}
+		s_resultSink += (int) outMatrices.front().Ix;
+	});
+
+	suite.Measure("quaternion", "interpolate_slerp", count, 30, [&]()
+	{
+		for(int rotationIndex = 0; rotationIndex + 1 < count; ++rotationIndex)
+		{
+			outMatrices[rotationIndex] = Slerp(rotations[rotationIndex], rotations[rotationIndex + 1], 0.25f).GetMatrix();
+		}
+		s_resultSink += (int) outMatrices.front().Ix;
+	});
+
+	// Quality over a few fractions
+	float orthonormalErrors[4] = { 0.f, 0.f, 0.f, 0.f };
+	float angleErrors[4] = { 0.f, 0.f, 0.f, 0.f };
+	for(int rotationIndex = 0; rotationIndex + 1 < count; ++rotationIndex)
+	{
+		for(float fraction : BENCHMARK_INTERPOLATION_FRACTIONS)
+		{
+			Matrix44 expected = Slerp(rotations[rotationIndex], rotations[rotationIndex + 1], fraction).GetMatrix();
+			Matrix44 results[4] =
+			{
+				Matrix44::MakeRotation3D(Interpolate(eulers[rotationIndex], eulers[rotationIndex + 1], fraction)),
+				ReferenceInterpolate(rotationMatrices[rotationIndex], rotationMatrices[rotationIndex + 1], fraction),
+				Nlerp(rotations[rotationIndex], rotations[rotationIndex + 1], fraction).GetMatrix(),
+				expected
+			};
+
+			for(int variantIndex = 0; variantIndex < 4; ++variantIndex)
+			{
+				orthonormalErrors[variantIndex] = Max(orthonormalErrors[variantIndex], GetOrthonormalError(results[variantIndex]));
+				angleErrors[variantIndex] = Max(angleErrors[variantIndex], GetRotationAngleBetween(results[variantIndex], expected));
+			}
+		}
+	}
+
+	const char* variants[4] = { "interpolate_euler", "interpolate_basis", "interpolate_nlerp", "interpolate_slerp" };
+	for(int variantIndex = 0; variantIndex < 4; ++variantIndex)
+	{
+		suite.Record("quaternion", variants[variantIndex], "max_orthonormal_error", count, orthonormalErrors[variantIndex]);
+		suite.Record("quaternion", variants[variantIndex], "max_degrees_from_slerp", count, angleErrors[variantIndex]);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One particle the way ParticleEmitter stored them before the pool
+//
+struct ReferenceParticle
+{
+	Vector3	position;
+	Vector3	velocity;
+	Vector3	force;
+	Rgba	color;
+	float	size;
+	float	mass;
+	float	timeBorn;
+	float	timeWillDie;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Particle count against update time. The array of structs loop ParticleEmitter used to run
+// (divide by mass, size and color over time stored back, swap remove) against the pool's kernel
+// on one thread and split across the job system, plus writing the billboards the same two ways.
+// Nothing dies so every frame sees the same count
+//
+static void RunParticlesCase( MicroBenchmarkSuite& suite )
+{
+	constexpr float DELTA_SECONDS = 1.f / 60.f;
+	constexpr float LIFETIME = 1000000.f;
+	Vector3 force(0.f, -9.8f, 0.f);
+	Rgba startColor(1.f, 1.f, 1.f, 1.f);
+	Rgba endColor(1.f, 0.5f, 0.f, 0.f);
+
+	for(int particleCount : BENCHMARK_PARTICLE_COUNTS)
+	{
+		std::vector<ReferenceParticle> particles(particleCount);
+		ParticlePool pool;
+		pool.Reserve(particleCount);
+		for(int particleIndex = 0; particleIndex < particleCount; ++particleIndex)
+		{
+			ReferenceParticle& particle = particles[particleIndex];
+			particle.position = GetRandomPointInBox(Vector3(-10.f), Vector3(10.f));
+			particle.velocity = GetRandomPointInBox(Vector3(-5.f), Vector3(5.f));
+			particle.force = Vector3::ZERO;
+			particle.color = startColor;
+			particle.size = 0.1f;
+			particle.mass = GetRandomFloatInRange(0.5f, 2.f);
+			particle.timeBorn = 0.f;
+			particle.timeWillDie = LIFETIME;
+
+			pool.Add(particle.position, particle.velocity, particle.size, particle.mass, particle.color, particle.timeBorn, LIFETIME);
+		}
+
+		// Update
+		suite.Measure("particles", "update_aos", particleCount, 20, [&]()
+		{
+			float time = 1.f;
+			for(size_t index = 0; index < particles.size(); ++index)
+			{
+				ReferenceParticle& particle = particles[index];
+				particle.force = force;
+				particle.velocity += DELTA_SECONDS * (particle.force / particle.mass);
+				particle.position += DELTA_SECONDS * particle.velocity;
+				particle.force = Vector3::ZERO;
+
+				float normalizedAge = (time - particle.timeBorn) / (particle.timeWillDie - particle.timeBorn);
+				particle.size = Interpolate(0.2f, 0.05f, normalizedAge);
+				particle.color = Interpolate(startColor, endColor, normalizedAge);
+
+				if(time >= particle.timeWillDie)
+				{
+					particles[index] = particles.back();
+					particles.pop_back();
+					index--;
+				}
+			}
+			s_resultSink += (int) particles.back().position.x;
+		});
+
+		suite.Measure("particles", "update_pool_1_thread", particleCount, 20, [&]()
+		{
+			pool.IntegrateRange(0, pool.GetCount(), DELTA_SECONDS, 1.f, force);
+			pool.RemoveDead();
+			s_resultSink += (int) pool.GetPosition(pool.GetCount() - 1).x;
+		});
+
+		BenchmarkStats updateStats = suite.Measure("particles", "update_pool", particleCount, 20, [&]()
+		{
+			pool.Update(DELTA_SECONDS, 1.f, force);
+			s_resultSink += (int) pool.GetPosition(pool.GetCount() - 1).x;
+		});
+
+		// Billboards, sized and colored over time the way the emitter usually is
+		ParticleBillboardDesc desc;
+		desc.m_right = Vector3::RIGHT;
+		desc.m_up = Vector3::UP;
+		desc.m_sizeOverTime = true;
+		desc.m_startSize = 0.2f;
+		desc.m_endSize = 0.05f;
+		desc.m_colorOverTime = true;
+		desc.m_startColor = startColor;
+		desc.m_endColor = endColor;
+
+		std::vector<Vertex_3DPCU> vertices(particleCount * 4);
+		suite.Measure("particles", "write_billboards_1_thread", particleCount, 20, [&]()
+		{
+			pool.WriteBillboardRange(vertices.data(), 0, pool.GetCount(), desc);
+			s_resultSink += (int) vertices.back().m_position.x;
+		});
+
+		BenchmarkStats writeStats = suite.Measure("particles", "write_billboards", particleCount, 20, [&]()
+		{
+			pool.WriteBillboards(vertices.data(), desc);
+			s_resultSink += (int) vertices.back().m_position.x;
+		});
+
+		// What the emitter costs the CPU per frame with the job system's threads
+		suite.Record("particles", "update_and_write", "frame_ms", particleCount, updateStats.m_p50 + writeStats.m_p50);
+		suite.Record("particles", "update_and_write", "threads", particleCount, (double) JobSystem::GetInstance()->GetThreadCount());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Does nothing, the jobs case times the system around it
+//
+static void RunEmptyJob( void* userData, int begin, int end )
+{
+	UNUSED(userData);
+	UNUSED(begin);
+	UNUSED(end);
+}
+
+//-----------------------------------------------------------------------------------------------
+// A bit of math per index so the loop has work to split
+//
+static float SumParallelForWork( int begin, int end )
+{
+	float sum = 0.f;
+	for(int index = begin; index < end; ++index)
+	{
+		sum += sqrtf((float) index) * 0.001f;
+	}
+
+	return sum;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Job system overhead and scaling. The system is recreated with 1, 2, 4... threads up to the core
+// count, and at each size times empty jobs scheduled and waited on from the main thread, giving
+// the cost of one job, and a fixed loop through ParallelForRange. The others record their speedup
+// over the one thread run. The instance the suite was given is put back
+// afterwards
+//
+static void RunJobsCase( MicroBenchmarkSuite& suite )
+{
+	JobSystem* existing = JobSystem::GetInstance();
+	int restoreWorkerCount = existing ? existing->GetThreadCount() - 1 : -1;
+	JobSystem::DestroyInstance();
+
+	int coreCount = Max((int) std::thread::hardware_concurrency(), 1);
+	std::vector<int> threadCounts;
+	for(int threadCount = 1; threadCount < coreCount; threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+	threadCounts.push_back(coreCount);
+
+	double singleThreadMs = 0.0;
+	for(int threadCount : threadCounts)
+	{
+		JobSystem* jobSystem = JobSystem::CreateInstance(threadCount - 1);
+
+		// Allocation, scheduling, running and waiting, per job
+		std::string variant = Stringf("empty_jobs_%d_threads", threadCount);
+		BenchmarkStats emptyStats = suite.Measure("jobs", variant.c_str(), BENCHMARK_EMPTY_JOB_COUNT, 20, [&]()
+		{
+			JobCounter counter;
+			for(int jobIndex = 0; jobIndex < BENCHMARK_EMPTY_JOB_COUNT; ++jobIndex)
+			{
+				jobSystem->Run(&RunEmptyJob, nullptr, &counter);
+			}
+			jobSystem->Wait(counter);
+		});
+		suite.Record("jobs", variant.c_str(), "ns_per_job", BENCHMARK_EMPTY_JOB_COUNT, (emptyStats.m_p50 * 1000000.0) / BENCHMARK_EMPTY_JOB_COUNT);
+
+		// The same loop split across however many threads there are
+		variant = Stringf("parallel_for_%d_threads", threadCount);
+		std::atomic<int> sum(0);
+		BenchmarkStats loopStats = suite.Measure("jobs", variant.c_str(), BENCHMARK_PARALLEL_FOR_COUNT, 10, [&]()
+		{
+			jobSystem->ParallelForRange(BENCHMARK_PARALLEL_FOR_COUNT, [&sum](int begin, int end)
+			{
+				sum.fetch_add((int) SumParallelForWork(begin, end), std::memory_order_relaxed);
+			});
+		});
+		s_resultSink += sum.load();
+
+		if(threadCount == 1)
+		{
+			singleThreadMs = loopStats.m_p50;
+		}
+		suite.Record("jobs", variant.c_str(), "speedup", BENCHMARK_PARALLEL_FOR_COUNT, singleThreadMs / loopStats.m_p50);
+
+		JobSystem::DestroyInstance();
+	}
+
+	if(existing)
+	{
+		JobSystem::CreateInstance(restoreWorkerCount);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Cases by the name --micro takes
+//
+typedef void (*MicroBenchmarkCaseCB)( MicroBenchmarkSuite& suite );
+
+struct MicroBenchmarkCase
+{
+	const char*				m_name;
+	MicroBenchmarkCaseCB	m_function;
+};
+
+static const MicroBenchmarkCase MICRO_BENCHMARK_CASES[] =
+{
+	{ "bvh",		RunBVHCase },
+	{ "matrix",		RunMatrixCase },
+	{ "quaternion",	RunQuaternionCase },
+	{ "particles",	RunParticlesCase },
+	{ "jobs",		RunJobsCase },
+};
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+MicroBenchmarkSuite::MicroBenchmarkSuite( const std::string& caseFilter )
+	: m_caseFilter(caseFilter)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs every case matching the filter
+//
+void MicroBenchmarkSuite::Run()
+{
+	for(const MicroBenchmarkCase& benchmarkCase : MICRO_BENCHMARK_CASES)
+	{
+		if(m_caseFilter.empty() || m_caseFilter == benchmarkCase.m_name)
+		{
+			benchmarkCase.m_function(*this);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Times the work and keeps the result
+//
+const BenchmarkStats& MicroBenchmarkSuite::Measure( const char* caseName, const char* variant, int count, int sampleCount, const std::function<void()>& work )
+{
+	work();
+
+	std::vector<double> samples;
+	samples.reserve(sampleCount);
+	for(int sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		uint64_t startHpc = Time::GetPerformanceCounter();
+		work();
+		uint64_t endHpc = Time::GetPerformanceCounter();
+		samples.push_back(Time::HpcToSeconds(endHpc - startHpc) * 1000.0);
+	}
+
+	MicroBenchmarkResult result;
+	result.m_case = caseName;
+	result.m_variant = variant;
+	result.m_count = count;
+	result.m_stats = BenchmarkRunner::ComputeStats(samples);
+	m_results.push_back(result);
+
+	printf("%-12s %-24s %8d  p50 %10.4f ms  min %10.4f ms\n", caseName, variant, count, result.m_stats.m_p50, result.m_stats.m_min);
+	return m_results.back().m_stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Keeps a measured value that isn't a time
+//
+void MicroBenchmarkSuite::Record( const char* caseName, const char* variant, const char* metric, int count, double value )
+{
+	MicroBenchmarkValue result;
+	result.m_case = caseName;
+	result.m_variant = variant;
+	result.m_metric = metric;
+	result.m_count = count;
+	result.m_value = value;
+	m_values.push_back(result);
+
+	printf("%-12s %-24s %8d  %s %g\n", caseName, variant, count, metric, value);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the timings and the values as two json arrays
+//
+bool MicroBenchmarkSuite::WriteResults() const
+{
+	std::string json = "{\n\t\"micro\": [\n";
+	for(size_t resultIndex = 0; resultIndex < m_results.size(); ++resultIndex)
+	{
+		const MicroBenchmarkResult& result = m_results[resultIndex];
+		const BenchmarkStats& stats = result.m_stats;
+		json.append(Stringf("\t\t{\"case\": \"%s\", \"variant\": \"%s\", \"count\": %d, \"samples\": %d, \"min\": %.5f, \"mean\": %.5f, \"p50\": %.5f, \"p99\": %.5f, \"max\": %.5f}%s\n",
+			result.m_case.c_str(), result.m_variant.c_str(), result.m_count, stats.m_sampleCount, stats.m_min, stats.m_mean, stats.m_p50, stats.m_p99, stats.m_max,
+			(resultIndex + 1 < m_results.size()) ? "," : ""));
+	}
+	json.append("\t],\n\t\"values\": [\n");
+	for(size_t valueIndex = 0; valueIndex < m_values.size(); ++valueIndex)
+	{
+		const MicroBenchmarkValue& value = m_values[valueIndex];
+		json.append(Stringf("\t\t{\"case\": \"%s\", \"variant\": \"%s\", \"metric\": \"%s\", \"count\": %d, \"value\": %.9g}%s\n",
+			value.m_case.c_str(), value.m_variant.c_str(), value.m_metric.c_str(), value.m_count, value.m_value,
+			(valueIndex + 1 < m_values.size()) ? "," : ""));
+	}
+	json.append("\t]\n}\n");
+
+	return FileWriteToNewFile(m_outputPath.c_str(), json.c_str(), json.size());
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Benchmark/BenchmarkRunner.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// One timed variant of a case at one problem size
+//
+struct MicroBenchmarkResult
+{
+	std::string		m_case;
+	std::string		m_variant;
+	int				m_count = 0;		// Objects or elements handled per run
+	BenchmarkStats	m_stats;			// Milliseconds per run
+};
+
+//-----------------------------------------------------------------------------------------------
+// A number a case measured that isn't a time, like an error against a reference
+//
+struct MicroBenchmarkValue
+{
+	std::string		m_case;
+	std::string		m_variant;
+	std::string		m_metric;
+	int				m_count = 0;
+	double			m_value = 0.0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// CPU benchmarks of engine systems that don't need a renderer. Each case times its variants at a
+// few problem sizes, so the fast path and the path it replaced show up side by side
+//
+//	Benchmark.exe --micro [case] [results.json]
+//
+class MicroBenchmarkSuite
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	explicit MicroBenchmarkSuite( const std::string& caseFilter );
+	~MicroBenchmarkSuite() {}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	const	std::string&		GetOutputPath() const { return m_outputPath; }
+			void				SetOutputPath( const std::string& path ) { m_outputPath = path; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				Run(); // Runs every case matching the filter, all of them if it's empty
+			bool				WriteResults() const;
+
+			// For the cases. Runs the work once to warm up, then times it sampleCount times
+	const	BenchmarkStats&		Measure( const char* caseName, const char* variant, int count, int sampleCount, const std::function<void()>& work );
+			void				Record( const char* caseName, const char* variant, const char* metric, int count, double value );
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::string							m_caseFilter;
+	std::string							m_outputPath = "Data/Benchmarks/micro.results.json";
+	std::vector<MicroBenchmarkResult>	m_results;
+	std::vector<MicroBenchmarkValue>	m_values;
+};
@@ -0,0 +1,233 @@
+#include "Benchmark/ScalarReference.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Returns first * second
+//
+Matrix44 ReferenceMultiply( const Matrix44& first, const Matrix44& second )
+{
+	Matrix44 result;
+
+	result.Ix = (first.Ix * second.Ix) + (first.Jx * second.Iy) + (first.Kx * second.Iz) + (first.Tx * second.Iw);
+	result.Iy = (first.Iy * second.Ix) + (first.Jy * second.Iy) + (first.Ky * second.Iz) + (first.Ty * second.Iw);
+	result.Iz = (first.Iz * second.Ix) + (first.Jz * second.Iy) + (first.Kz * second.Iz) + (first.Tz * second.Iw);
+	result.Iw = (first.Iw * second.Ix) + (first.Jw * second.Iy) + (first.Kw * second.Iz) + (first.Tw * second.Iw);
+
+	result.Jx = (first.Ix * second.Jx) + (first.Jx * second.Jy) + (first.Kx * second.Jz) + (first.Tx * second.Jw);
+	result.Jy = (first.Iy * second.Jx) + (first.Jy * second.Jy) + (first.Ky * second.Jz) + (first.Ty * second.Jw);
+	result.Jz = (first.Iz * second.Jx) + (first.Jz * second.Jy) + (first.Kz * second.Jz) + (first.Tz * second.Jw);
+	result.Jw = (first.Iw * second.Jx) + (first.Jw * second.Jy) + (first.Kw * second.Jz) + (first.Tw * second.Jw);
+
+	result.Kx = (first.Ix * second.Kx) + (first.Jx * second.Ky) + (first.Kx * second.Kz) + (first.Tx * second.Kw);
+	result.Ky = (first.Iy * second.Kx) + (first.Jy * second.Ky) + (first.Ky * second.Kz) + (first.Ty * second.Kw);
+	result.Kz = (first.Iz * second.Kx) + (first.Jz * second.Ky) + (first.Kz * second.Kz) + (first.Tz * second.Kw);
+	result.Kw = (first.Iw * second.Kx) + (first.Jw * second.Ky) + (first.Kw * second.Kz) + (first.Tw * second.Kw);
+
+	result.Tx = (first.Ix * second.Tx) + (first.Jx * second.Ty) + (first.Kx * second.Tz) + (first.Tx * second.Tw);
+	result.Ty = (first.Iy * second.Tx) + (first.Jy * second.Ty) + (first.Ky * second.Tz) + (first.Ty * second.Tw);
+	result.Tz = (first.Iz * second.Tx) + (first.Jz * second.Ty) + (first.Kz * second.Tz) + (first.Tz * second.Tw);
+	result.Tw = (first.Iw * second.Tx) + (first.Jw * second.Ty) + (first.Kw * second.Tz) + (first.Tw * second.Tw);
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Full inverse, the determinant must not be zero
+//
+Matrix44 ReferenceInvert( const Matrix44& mat )
+{
+	double inv[16];
+	double det;
+	double m[16];
+	int index;
+
+	for (index = 0; index < 16; ++index) {
+		m[index] = (double) mat.data[index];
+	}
+
+	inv[0] = m[5]  * m[10] * m[15] - 
+		m[5]  * m[11] * m[14] - 
+		m[9]  * m[6]  * m[15] + 
+		m[9]  * m[7]  * m[14] +
+		m[13] * m[6]  * m[11] - 
+		m[13] * m[7]  * m[10];
+
+	inv[4] = -m[4]  * m[10] * m[15] + 
+		m[4]  * m[11] * m[14] + 
+		m[8]  * m[6]  * m[15] - 
+		m[8]  * m[7]  * m[14] - 
+		m[12] * m[6]  * m[11] + 
+		m[12] * m[7]  * m[10];
+
+	inv[8] = m[4]  * m[9] * m[15] - 
+		m[4]  * m[11] * m[13] - 
+		m[8]  * m[5] * m[15] + 
+		m[8]  * m[7] * m[13] + 
+		m[12] * m[5] * m[11] - 
+		m[12] * m[7] * m[9];
+
+	inv[12] = -m[4]  * m[9] * m[14] + 
+		m[4]  * m[10] * m[13] +
+		m[8]  * m[5] * m[14] - 
+		m[8]  * m[6] * m[13] - 
+		m[12] * m[5] * m[10] + 
+		m[12] * m[6] * m[9];
+
+	inv[1] = -m[1]  * m[10] * m[15] + 
+		m[1]  * m[11] * m[14] + 
+		m[9]  * m[2] * m[15] - 
+		m[9]  * m[3] * m[14] - 
+		m[13] * m[2] * m[11] + 
+		m[13] * m[3] * m[10];
+
+	inv[5] = m[0]  * m[10] * m[15] - 
+		m[0]  * m[11] * m[14] - 
+		m[8]  * m[2] * m[15] + 
+		m[8]  * m[3] * m[14] + 
+		m[12] * m[2] * m[11] - 
+		m[12] * m[3] * m[10];
+
+	inv[9] = -m[0]  * m[9] * m[15] + 
+		m[0]  * m[11] * m[13] + 
+		m[8]  * m[1] * m[15] - 
+		m[8]  * m[3] * m[13] - 
+		m[12] * m[1] * m[11] + 
+		m[12] * m[3] * m[9];
+
+	inv[13] = m[0]  * m[9] * m[14] - 
+		m[0]  * m[10] * m[13] - 
+		m[8]  * m[1] * m[14] + 
+		m[8]  * m[2] * m[13] + 
+		m[12] * m[1] * m[10] - 
+		m[12] * m[2] * m[9];
+
+	inv[2] = m[1]  * m[6] * m[15] - 
+		m[1]  * m[7] * m[14] - 
+		m[5]  * m[2] * m[15] + 
+		m[5]  * m[3] * m[14] + 
+		m[13] * m[2] * m[7] - 
+		m[13] * m[3] * m[6];
+
+	inv[6] = -m[0]  * m[6] * m[15] + 
+		m[0]  * m[7] * m[14] + 
+		m[4]  * m[2] * m[15] - 
+		m[4]  * m[3] * m[14] - 
+		m[12] * m[2] * m[7] + 
+		m[12] * m[3] * m[6];
+
+	inv[10] = m[0]  * m[5] * m[15] - 
+		m[0]  * m[7] * m[13] - 
+		m[4]  * m[1] * m[15] + 
+		m[4]  * m[3] * m[13] + 
+		m[12] * m[1] * m[7] - 
+		m[12] * m[3] * m[5];
+
+	inv[14] = -m[0]  * m[5] * m[14] + 
+		m[0]  * m[6] * m[13] + 
+		m[4]  * m[1] * m[14] - 
+		m[4]  * m[2] * m[13] - 
+		m[12] * m[1] * m[6] + 
+		m[12] * m[2] * m[5];
+
+	inv[3] = -m[1] * m[6] * m[11] + 
+		m[1] * m[7] * m[10] + 
+		m[5] * m[2] * m[11] - 
+		m[5] * m[3] * m[10] - 
+		m[9] * m[2] * m[7] + 
+		m[9] * m[3] * m[6];
+
+	inv[7] = m[0] * m[6] * m[11] - 
+		m[0] * m[7] * m[10] - 
+		m[4] * m[2] * m[11] + 
+		m[4] * m[3] * m[10] + 
+		m[8] * m[2] * m[7] - 
+		m[8] * m[3] * m[6];
+
+	inv[11] = -m[0] * m[5] * m[11] + 
+		m[0] * m[7] * m[9] + 
+		m[4] * m[1] * m[11] - 
+		m[4] * m[3] * m[9] - 
+		m[8] * m[1] * m[7] + 
+		m[8] * m[3] * m[5];
+
+	inv[15] = m[0] * m[5] * m[10] - 
+		m[0] * m[6] * m[9] - 
+		m[4] * m[1] * m[10] + 
+		m[4] * m[2] * m[9] + 
+		m[8] * m[1] * m[6] - 
+		m[8] * m[2] * m[5];
+
+	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	det = 1.0 / det;
+
+	Matrix44 inverseMatrix;
+	for (index = 0; index < 16; index++) {
+		inverseMatrix.data[index] = (float)(inv[index] * det);
+	}
+
+	return inverseMatrix;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the position transformed with w = 1
+//
+Vector3 ReferenceTransformPosition( const Matrix44& mat, const Vector3& position )
+{
+	Vector3 result;
+	result.x = (mat.Ix * position.x) + (mat.Jx * position.y) + (mat.Kx * position.z) + mat.Tx;
+	result.y = (mat.Iy * position.x) + (mat.Jy * position.y) + (mat.Ky * position.z) + mat.Ty;
+	result.z = (mat.Iz * position.x) + (mat.Jz * position.y) + (mat.Kz * position.z) + mat.Tz;
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the direction transformed with w = 0
+//
+Vector3 ReferenceTransformDirection( const Matrix44& mat, const Vector3& direction )
+{
+	Vector3 result;
+	result.x = (mat.Ix * direction.x) + (mat.Jx * direction.y) + (mat.Kx * direction.z);
+	result.y = (mat.Iy * direction.x) + (mat.Jy * direction.y) + (mat.Ky * direction.z);
+	result.z = (mat.Iz * direction.x) + (mat.Jz * direction.y) + (mat.Kz * direction.z);
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the box around the transformed corners
+//
+AABB3 ReferenceTransformAABB( const Matrix44& mat, const AABB3& box )
+{
+	AABB3 result = AABB3::MakeEmpty();
+	for(int cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+	{
+		Vector3 corner((cornerIndex & 1) ? box.maxs.x : box.mins.x, (cornerIndex & 2) ? box.maxs.y : box.mins.y, (cornerIndex & 4) ? box.maxs.z : box.mins.z);
+		result.GrowToContain(ReferenceTransformPosition(mat, corner));
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns T * R * S built one append at a time
+//
+Matrix44 ReferenceMakeTRS( const Vector3& translation, const Vector3& eulerDegrees, const Vector3& scale )
+{
+	Matrix44 matrix;
+	matrix.Append(Matrix44::MakeTranslation3D(translation));
+	matrix.Append(Matrix44::MakeRotation3D(eulerDegrees));
+	matrix.Append(Matrix44::MakeScale3D(scale));
+
+	return matrix;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Slerps the three basis vectors independently, the result drifts off orthonormal in between
+//
+Matrix44 ReferenceInterpolate( const Matrix44& start, const Matrix44& end, float fractionTowardEnd )
+{
+	Vector3 right = Slerp(start.GetRight(), end.GetRight(), fractionTowardEnd);
+	Vector3 up = Slerp(start.GetUp(), end.GetUp(), fractionTowardEnd);
+	Vector3 forward = Slerp(start.GetForward(), end.GetForward(), fractionTowardEnd);
+	Vector3 translation = Interpolate(start.GetTranslation(), end.GetTranslation(), fractionTowardEnd);
+
+	return Matrix44(right, up, forward, translation);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// The plain float math Matrix44 and transform_t did before the SIMD and quaternion paths. The
+// engine picks its SIMD path at compile time, so the benchmarks and tests keep their own copy to
+// compare against
+//
+Matrix44	ReferenceMultiply( const Matrix44& first, const Matrix44& second );
+Matrix44	ReferenceInvert( const Matrix44& mat ); // Cofactor expansion in doubles
+Vector3		ReferenceTransformPosition( const Matrix44& mat, const Vector3& position );
+Vector3		ReferenceTransformDirection( const Matrix44& mat, const Vector3& direction );
+AABB3		ReferenceTransformAABB( const Matrix44& mat, const AABB3& box ); // Bounds of the 8 transformed corners
+Matrix44	ReferenceMakeTRS( const Vector3& translation, const Vector3& eulerDegrees, const Vector3& scale ); // Three appends
+Matrix44	ReferenceInterpolate( const Matrix44& start, const Matrix44& end, float fractionTowardEnd ); // Slerps each basis on its own
@@ -0,0 +1,340 @@
+#include "Benchmark/SelfTests.hpp"
+#include "Benchmark/ScalarReference.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/TransformSystem.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr int	TEST_MATRIX_COUNT = 1000;
+constexpr int	TEST_BATCH_COUNT = 37; // Not a multiple of any lane width so the tails run too
+constexpr float	TEST_TOLERANCE = 1e-5f;
+constexpr float	TEST_INVERSE_TOLERANCE = 1e-4f; // The scalar inverse works in doubles
+
+//-----------------------------------------------------------------------------------------------
+// Returns a random point in the box
+//
+static Vector3 GetRandomPointInBox( const Vector3& mins, const Vector3& maxs )
+{
+	return Vector3(GetRandomFloatInRange(mins.x, maxs.x), GetRandomFloatInRange(mins.y, maxs.y), GetRandomFloatInRange(mins.z, maxs.z));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a random rotation, translation and scale like the scene graph builds
+//
+static Matrix44 GetRandomTRS()
+{
+	Vector3 translation = GetRandomPointInBox(Vector3(-100.f), Vector3(100.f));
+	Vector3 eulerDegrees = GetRandomPointInBox(Vector3(-180.f), Vector3(180.f));
+	Vector3 scale = GetRandomPointInBox(Vector3(0.5f), Vector3(2.f));
+	return Matrix44::MakeTRS(translation, eulerDegrees, scale);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a random matrix with every element set, including the bottom row. The diagonal is
+// pushed up so it stays well conditioned
+//
+static Matrix44 GetRandomGeneral()
+{
+	Matrix44 result;
+	for(int elementIndex = 0; elementIndex < 16; ++elementIndex)
+	{
+		result.data[elementIndex] = GetRandomFloatInRange(-1.f, 1.f);
+	}
+
+	for(int diagonalIndex = 0; diagonalIndex < 4; ++diagonalIndex)
+	{
+		result.data[diagonalIndex * 5] += (result.data[diagonalIndex * 5] < 0.f) ? -4.f : 4.f;
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Matrix44's SIMD paths against the scalar math they replaced, over random TRS and general
+// matrices. Without SIMD this checks the scalar build against itself and should always pass
+//
+static void RunMatrixTests( SelfTestSuite& suite )
+{
+	std::vector<Matrix44> matrices;
+	for(int matrixIndex = 0; matrixIndex < TEST_MATRIX_COUNT; ++matrixIndex)
+	{
+		matrices.push_back((matrixIndex & 1) ? GetRandomGeneral() : GetRandomTRS());
+	}
+
+	for(int matrixIndex = 0; matrixIndex < TEST_MATRIX_COUNT; ++matrixIndex)
+	{
+		const Matrix44& first = matrices[matrixIndex];
+		const Matrix44& second = matrices[(matrixIndex + 1) % TEST_MATRIX_COUNT];
+		bool isAffine = (matrixIndex & 1) == 0;
+
+		// Multiply, including the overload that may write over its inputs
+		Matrix44 expected = ReferenceMultiply(first, second);
+		suite.CheckNear("multiply", Matrix44::MatrixMultiply(first, second), expected, TEST_TOLERANCE);
+
+		Matrix44 aliased = first;
+		Matrix44::MatrixMultiply(aliased, second, aliased);
+		suite.CheckNear("multiply_alias_first", aliased, expected, TEST_TOLERANCE);
+
+		aliased = second;
+		Matrix44::MatrixMultiply(first, aliased, aliased);
+		suite.CheckNear("multiply_alias_second", aliased, expected, TEST_TOLERANCE);
+
+		// Inverses
+		Matrix44 inverse = Matrix44::Invert(first);
+		suite.CheckNear("invert", inverse, ReferenceInvert(first), TEST_INVERSE_TOLERANCE);
+		suite.CheckNear("invert_roundtrip", ReferenceMultiply(first, inverse), Matrix44::IDENTITY, TEST_INVERSE_TOLERANCE);
+
+		if(isAffine)
+		{
+			suite.CheckNear("invert_affine", Matrix44::InvertAffine(first), ReferenceInvert(first), TEST_INVERSE_TOLERANCE);
+		}
+
+		// Points and directions
+		Vector3 point = GetRandomPointInBox(Vector3(-100.f), Vector3(100.f));
+		suite.CheckNear("transform_position", first.TransformPosition3D(point), ReferenceTransformPosition(first, point), TEST_TOLERANCE);
+		suite.CheckNear("transform_direction", first.TransformDirection3D(point), ReferenceTransformDirection(first, point), TEST_TOLERANCE);
+	}
+
+	// Batches
+	const Matrix44& parent = matrices[0];
+
+	std::vector<Matrix44> products(TEST_BATCH_COUNT);
+	Matrix44::MultiplyBatch(parent, matrices.data(), products.data(), TEST_BATCH_COUNT);
+
+	std::vector<Vector3> positions;
+	std::vector<AABB3> boxes;
+	for(int batchIndex = 0; batchIndex < TEST_BATCH_COUNT; ++batchIndex)
+	{
+		Vector3 center = GetRandomPointInBox(Vector3(-100.f), Vector3(100.f));
+		Vector3 halfExtents = GetRandomPointInBox(Vector3(0.25f), Vector3(4.f));
+		positions.push_back(center);
+		boxes.push_back(AABB3(center - halfExtents, center + halfExtents));
+	}
+
+	std::vector<Vector3> transformedPositions(TEST_BATCH_COUNT);
+	std::vector<AABB3> transformedBoxes(TEST_BATCH_COUNT);
+	Matrix44::TransformPositions3D(parent, positions.data(), transformedPositions.data(), TEST_BATCH_COUNT);
+	Matrix44::TransformAABBs(parent, boxes.data(), transformedBoxes.data(), TEST_BATCH_COUNT);
+
+	for(int batchIndex = 0; batchIndex < TEST_BATCH_COUNT; ++batchIndex)
+	{
+		suite.CheckNear("multiply_batch", products[batchIndex], ReferenceMultiply(parent, matrices[batchIndex]), TEST_TOLERANCE);
+		suite.CheckNear("transform_positions", transformedPositions[batchIndex], ReferenceTransformPosition(parent, positions[batchIndex]), TEST_TOLERANCE);
+		suite.CheckNear("transform_aabbs", transformedBoxes[batchIndex], ReferenceTransformAABB(parent, boxes[batchIndex]), TEST_TOLERANCE);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hierarchy propagation, versions and the depth sort of a TransformSystem of its own, so the
+// engine's instance and whatever transforms it holds stay out of it
+//
+static void RunTransformTests( SelfTestSuite& suite )
+{
+	TransformSystem system;
+
+	// Children are created before their parents so the sort has something to do
+	TransformHandle grandchild = system.CreateNode();
+	TransformHandle child = system.CreateNode();
+	TransformHandle sibling = system.CreateNode();
+	TransformHandle root = system.CreateNode();
+	system.SetParent(grandchild, child);
+	system.SetParent(child, root);
+	system.SetParent(sibling, root);
+
+	system.EditLocal(root).SetPosition(Vector3(10.f, 0.f, 0.f));
+	system.EditLocal(child).SetPosition(Vector3(0.f, 5.f, 0.f));
+	system.EditLocal(child).SetScale(Vector3(2.f, 2.f, 2.f));
+	system.EditLocal(grandchild).SetPosition(Vector3(0.f, 0.f, 1.f));
+	system.EditLocal(sibling).SetPosition(Vector3(0.f, 0.f, -3.f));
+
+	// Depth sort, every node is built exactly once when parents come first
+	system.UpdateWorldMatrices();
+	suite.Check("depth_count", system.GetDepthCount() == 3);
+
+	int depthBegin;
+	int depthEnd;
+	int depthSizes[3];
+	for(int depth = 0; depth < 3; ++depth)
+	{
+		system.GetDepthRange(depth, depthBegin, depthEnd);
+		depthSizes[depth] = depthEnd - depthBegin;
+	}
+	suite.Check("depth_sizes", depthSizes[0] == 1 && depthSizes[1] == 2 && depthSizes[2] == 1);
+
+	suite.Check("sweep_builds_once", system.GetWorldVersion(root) == 1 && system.GetWorldVersion(child) == 1 && system.GetWorldVersion(sibling) == 1 && system.GetWorldVersion(grandchild) == 1);
+	suite.Check("sweep_keeps_parents", system.GetParent(grandchild) == child && system.GetParent(child) == root && system.GetParent(sibling) == root && system.GetParent(root) == INVALID_TRANSFORM);
+
+	// Propagation
+	suite.CheckNear("world_child", system.GetWorldMatrix(child).GetTranslation(), Vector3(10.f, 5.f, 0.f), TEST_TOLERANCE);
+	suite.CheckNear("world_grandchild", system.GetWorldMatrix(grandchild).GetTranslation(), Vector3(10.f, 5.f, 2.f), TEST_TOLERANCE);
+	suite.CheckNear("world_sibling", system.GetWorldMatrix(sibling).GetTranslation(), Vector3(10.f, 0.f, -3.f), TEST_TOLERANCE);
+
+	// Dirty flags through versions. Queries without changes rebuild nothing
+	uint32_t grandchildVersion = system.GetWorldVersion(grandchild);
+	uint32_t siblingVersion = system.GetWorldVersion(sibling);
+	system.GetWorldMatrix(grandchild);
+	suite.Check("clean_query_keeps_version", system.GetWorldVersion(grandchild) == grandchildVersion);
+
+	system.EditLocal(child).Translate(Vector3(0.f, 1.f, 0.f));
+	suite.Check("parent_move_bumps_child", system.GetWorldVersion(grandchild) != grandchildVersion);
+	suite.Check("parent_move_skips_sibling", system.GetWorldVersion(sibling) == siblingVersion);
+	suite.CheckNear("lazy_grandchild", system.GetWorldMatrix(grandchild).GetTranslation(), Vector3(10.f, 6.f, 2.f), TEST_TOLERANCE);
+
+	system.EditLocal(root).SetPosition(Vector3(-10.f, 0.f, 0.f));
+	system.UpdateWorldMatrices();
+	suite.CheckNear("sweep_grandchild", system.GetWorldMatrix(grandchild).GetTranslation(), Vector3(-10.f, 6.f, 2.f), TEST_TOLERANCE);
+	suite.CheckNear("sweep_sibling", system.GetWorldMatrix(sibling).GetTranslation(), Vector3(-10.f, 0.f, -3.f), TEST_TOLERANCE);
+
+	transform_t local = system.GetLocal(child);
+	suite.CheckNear("local_copy", local.GetPosition(), Vector3(0.f, 6.f, 0.f), TEST_TOLERANCE);
+
+	// Reparenting and destroying move nodes between depths
+	system.SetParent(grandchild, INVALID_TRANSFORM);
+	suite.CheckNear("detached", system.GetWorldMatrix(grandchild).GetTranslation(), Vector3(0.f, 0.f, 1.f), TEST_TOLERANCE);
+
+	system.SetParent(grandchild, sibling);
+	system.DestroyNode(child);
+	system.UpdateWorldMatrices();
+	suite.Check("destroy_count", system.GetCount() == 3);
+	suite.Check("destroy_depth_count", system.GetDepthCount() == 3);
+	suite.CheckNear("reparented", system.GetWorldMatrix(grandchild).GetTranslation(), Vector3(-10.f, 0.f, -2.f), TEST_TOLERANCE);
+
+	// A freed handle is reused as a new root
+	TransformHandle reused = system.CreateNode();
+	suite.Check("handle_reused", reused == child && system.GetParent(reused) == INVALID_TRANSFORM);
+	suite.CheckNear("reused_identity", system.GetWorldMatrix(reused).GetTranslation(), Vector3::ZERO, TEST_TOLERANCE);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Cases by the name --test takes
+//
+typedef void (*SelfTestCaseCB)( SelfTestSuite& suite );
+
+struct SelfTestCase
+{
+	const char*		m_name;
+	SelfTestCaseCB	m_function;
+};
+
+static const SelfTestCase SELF_TEST_CASES[] =
+{
+	{ "matrix",		RunMatrixTests },
+	{ "transform",	RunTransformTests },
+};
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+SelfTestSuite::SelfTestSuite( const std::string& caseFilter )
+	: m_caseFilter(caseFilter)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs every case matching the filter
+//
+void SelfTestSuite::Run()
+{
+	for(const SelfTestCase& testCase : SELF_TEST_CASES)
+	{
+		if(m_caseFilter.empty() || m_caseFilter == testCase.m_name)
+		{
+			int startFailures = m_failureCount;
+			int startChecks = m_checkCount;
+			m_currentCase = testCase.m_name;
+
+			testCase.m_function(*this);
+
+			printf("%-12s %6d checks  %6d failed\n", testCase.m_name, m_checkCount - startChecks, m_failureCount - startFailures);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Passes if the condition holds
+//
+bool SelfTestSuite::Check( const char* what, bool condition )
+{
+	return Record(what, condition, "");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Passes if the values are within tolerance
+//
+bool SelfTestSuite::CheckNear( const char* what, float actual, float expected, float tolerance )
+{
+	return Record(what, IsNear(actual, expected, tolerance), Stringf("%g, expected %g", actual, expected));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Passes if every component is within tolerance
+//
+bool SelfTestSuite::CheckNear( const char* what, const Vector3& actual, const Vector3& expected, float tolerance )
+{
+	bool isPassed = IsNear(actual.x, expected.x, tolerance) && IsNear(actual.y, expected.y, tolerance) && IsNear(actual.z, expected.z, tolerance);
+	return Record(what, isPassed, Stringf("(%g, %g, %g), expected (%g, %g, %g)", actual.x, actual.y, actual.z, expected.x, expected.y, expected.z));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Passes if every element is within tolerance, the detail names the first one that isn't
+//
+bool SelfTestSuite::CheckNear( const char* what, const Matrix44& actual, const Matrix44& expected, float tolerance )
+{
+	for(int elementIndex = 0; elementIndex < 16; ++elementIndex)
+	{
+		if(!IsNear(actual.data[elementIndex], expected.data[elementIndex], tolerance))
+		{
+			return Record(what, false, Stringf("element %d is %g, expected %g", elementIndex, actual.data[elementIndex], expected.data[elementIndex]));
+		}
+	}
+
+	return Record(what, true, "");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Passes if both corners are within tolerance
+//
+bool SelfTestSuite::CheckNear( const char* what, const AABB3& actual, const AABB3& expected, float tolerance )
+{
+	bool isPassed = IsNear(actual.mins.x, expected.mins.x, tolerance) && IsNear(actual.mins.y, expected.mins.y, tolerance) && IsNear(actual.mins.z, expected.mins.z, tolerance)
+		&& IsNear(actual.maxs.x, expected.maxs.x, tolerance) && IsNear(actual.maxs.y, expected.maxs.y, tolerance) && IsNear(actual.maxs.z, expected.maxs.z, tolerance);
+	return Record(what, isPassed, Stringf("(%g, %g, %g)-(%g, %g, %g), expected (%g, %g, %g)-(%g, %g, %g)",
+		actual.mins.x, actual.mins.y, actual.mins.z, actual.maxs.x, actual.maxs.y, actual.maxs.z,
+		expected.mins.x, expected.mins.y, expected.mins.z, expected.maxs.x, expected.maxs.y, expected.maxs.z));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Absolute tolerance near zero, relative above one
+//
+bool SelfTestSuite::IsNear( float actual, float expected, float tolerance ) const
+{
+	float scale = Max(1.f, fabsf(expected));
+	return fabsf(actual - expected) <= tolerance * scale;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Counts the check and prints it if it failed
+//
+bool SelfTestSuite::Record( const char* what, bool isPassed, const std::string& detail )
+{
+	++m_checkCount;
+	if(!isPassed)
+	{
+		++m_failureCount;
+		printf("FAILED %s/%s %s\n", m_currentCase, what, detail.c_str());
+	}
+
+	return isPassed;
+}
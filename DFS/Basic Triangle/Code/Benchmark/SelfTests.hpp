@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Matrix44;
+class Vector3;
+class AABB3;
+
+//-----------------------------------------------------------------------------------------------
+// Correctness checks for engine systems that don't need a renderer. A case runs its checks and
+// every failing one is printed, the exit code is the number of failures
+//
+//	Benchmark.exe --test [case]
+//
+class SelfTestSuite
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	explicit SelfTestSuite( const std::string& caseFilter );
+	~SelfTestSuite() {}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int			GetCheckCount() const { return m_checkCount; }
+			int			GetFailureCount() const { return m_failureCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void		Run(); // Runs every case matching the filter, all of them if it's empty
+
+			// For the cases. Tolerances are relative to the expected value once it's bigger than 1
+			bool		Check( const char* what, bool condition );
+			bool		CheckNear( const char* what, float actual, float expected, float tolerance );
+			bool		CheckNear( const char* what, const Vector3& actual, const Vector3& expected, float tolerance );
+			bool		CheckNear( const char* what, const Matrix44& actual, const Matrix44& expected, float tolerance );
+			bool		CheckNear( const char* what, const AABB3& actual, const AABB3& expected, float tolerance );
+
+private:
+			bool		IsNear( float actual, float expected, float tolerance ) const;
+			bool		Record( const char* what, bool isPassed, const std::string& detail );
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::string		m_caseFilter;
+	const char*		m_currentCase = "";
+	int				m_checkCount = 0;
+	int				m_failureCount = 0;
+};
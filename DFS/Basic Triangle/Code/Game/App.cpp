@@ -13,6 +13,9 @@
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/Window.hpp"
 #include "Engine/Core/Clock.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/VulkanRenderer/VKRenderer.hpp"
 #include "Engine/VulkanRenderer/VKCamera.hpp"
@@ -20,6 +23,7 @@
 #include "Engine/VulkanRenderer/VKMaterial.hpp"
 #include "Engine/Renderer/Mesh/MeshBuilder.hpp"
 #include "Engine/Math/Transform.hpp"
+#include "Engine/Math/TransformSystem.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -35,12 +39,18 @@ App::App( const char* appName )
 	m_appName = appName;
 	
 
+	MemoryTracker::CreateInstance(); // Before the renderer so device memory is counted
 	Clock::CreateMasterClock();
 
+	Profiler::CreateInstance();
+	JobSystem::CreateInstance();
 	InputSystem::CreateInstance();
 	AudioSystem::CreateInstance();
 	VKRenderer::CreateInstance(appName);
-	Game::CreateInstance();
+	{
+		MEMORY_TAG_SCOPE(MEMORY_TAG_GAME);
+		Game::CreateInstance();
+	}
 
 	InputSystem::ShowCursor(false);
 	InputSystem::SetMouseMode(MOUSE_RELATIVE);
@@ -54,8 +64,12 @@ App::~App()
 {
 	Game::DestroyInstance();
 	VKRenderer::DestroyInstance();
+	TransformSystem::DestroyInstance();
 	InputSystem::DestroyInstance();
 	AudioSystem::DestroyInstance();
+	JobSystem::DestroyInstance();
+	Profiler::DestroyInstance();
+	MemoryTracker::DestroyInstance();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -121,7 +135,11 @@ void App::Render()
 //
 void App::BeginFrame()
 {
+	Profiler::GetInstance()->MarkFrame(); // Closes the last frame's profile
+	MemoryTracker::GetInstance()->MarkFrame(); // Churn and budgets of the last frame
+	PROFILE_SCOPE("App::BeginFrame");
 	Clock::GetMasterClock()->BeginFrame(); // Ticks the master clock
+	JobSystem::GetInstance()->BeginFrame();
 	InputSystem::GetInstance()->BeginFrame();
 	AudioSystem::GetInstance()->BeginFrame();
 	VKRenderer::GetInstance()->BeginFrame();
@@ -132,6 +150,7 @@ void App::BeginFrame()
 //
 void App::EndFrame()
 {
+	PROFILE_SCOPE("App::EndFrame");
 	AudioSystem::GetInstance()->EndFrame();
 	InputSystem::GetInstance()->EndFrame();
 	Clock::GetMasterClock()->EndFrame();
@@ -145,8 +164,14 @@ void App::EndFrame()
 void App::RunFrame()
 {
 	BeginFrame();
-	Update();
-	Render();
+	{
+		PROFILE_SCOPE("App::Update");
+		Update();
+	}
+	{
+		PROFILE_SCOPE("App::Render");
+		Render();
+	}
 	EndFrame();
 }
 
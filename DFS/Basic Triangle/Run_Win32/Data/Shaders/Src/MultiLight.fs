@@ -1,12 +1,20 @@
-#version 420 core
-
-#define MAX_LIGHTS 8
+#version 430 core
 
 // Uniforms ==============================================
 // Constants
-uniform vec3 EYE_POSITION;  // camera related
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 
-uniform int RENDER_MODE;
+layout(binding=0, std140) uniform cFrameBlock
+{
+   float GAME_TIME;
+   float GAME_DELTA_TIME;
+   int RENDER_MODE;     float FRAME_PADDING;
+};
 
 struct Light 
 {
@@ -24,6 +32,11 @@ struct Light
 
    vec3 specAttenuation; 
    float dotOuterAngle; 
+
+   vec3 shadowAtlasTile; // xy = uv offset, z = uv scale
+   float isShadowCasting;
+
+   mat4 shadowVP;
 }; 
 
 struct LightFactor
@@ -35,7 +48,40 @@ struct LightFactor
 layout(binding=3, std140) uniform uLightBlock
 {
    vec4 AMBIENCE;
-   Light LIGHTS[MAX_LIGHTS];
+};
+
+// Clustered lighting - every visible light lives in the storage buffer (global lights first)
+// and each cluster has a range in the light index list
+layout(binding=6, std140) uniform uLightClusterBlock
+{
+   uvec4 CLUSTER_DIMENSIONS; // w is the global light count
+   vec4 CLUSTER_DEPTH_PARAMS; // near, far, slice scale, slice bias
+   vec4 CLUSTER_VIEWPORT;
+   vec4 CLUSTER_VIEW_Z_ROW;
+};
+
+layout(binding=0, std430) readonly buffer sLightBuffer
+{
+   Light LIGHTS[];
+};
+
+layout(binding=1, std430) readonly buffer sLightClusterBuffer
+{
+   uvec2 CLUSTERS[]; // offset, count
+};
+
+layout(binding=2, std430) readonly buffer sLightIndexBuffer
+{
+   uint LIGHT_INDICES[];
+};
+
+// Cascaded shadow map of the main directional light, the light's shadowAtlasTile.z is -1
+layout(binding=7, std140) uniform uShadowCascadeBlock
+{
+   mat4 CASCADE_VP[4];
+   vec4 CASCADE_SPLITS; // View depth where each cascade ends
+   vec4 CASCADE_INFO; // x = cascade count, y = texel size
+   vec4 CASCADE_VIEW_Z_ROW;
 };
 
 layout(binding=4, std140) uniform uSpecularBlock
@@ -51,6 +97,7 @@ layout(binding=4, std140) uniform uSpecularBlock
 // engine without having to query
 layout(binding = 0) uniform sampler2D gTexDiffuse;
 layout(binding = 1) uniform sampler2D gTexNormal;
+layout(binding = 9) uniform sampler2DArrayShadow gTexShadowCascades;
 
 // Attributes ============================================
 in vec2 passUV; 
@@ -126,6 +173,44 @@ LightFactor CalculateLightFactor( vec3 pos, vec3 eyeDir, vec3 normal, Light ligh
    return lightFactor;
 }
 
+// Finds the froxel this fragment is in (Must match LightClusterGrid on the CPU)
+uint GetClusterIndex( vec3 worldPos )
+{
+   vec2 screenUV = (gl_FragCoord.xy - CLUSTER_VIEWPORT.xy) / CLUSTER_VIEWPORT.zw;
+   uvec2 tile = uvec2(clamp(screenUV * vec2(CLUSTER_DIMENSIONS.xy), vec2(0.0f), vec2(CLUSTER_DIMENSIONS.xy - 1)));
+
+   float viewDepth = max(dot(CLUSTER_VIEW_Z_ROW.xyz, worldPos) + CLUSTER_VIEW_Z_ROW.w, CLUSTER_DEPTH_PARAMS.x);
+   float slice = floor(log(viewDepth) * CLUSTER_DEPTH_PARAMS.z + CLUSTER_DEPTH_PARAMS.w);
+   uint sliceIndex = uint(clamp(slice, 0.0f, float(CLUSTER_DIMENSIONS.z - 1)));
+
+   return (sliceIndex * CLUSTER_DIMENSIONS.y + tile.y) * CLUSTER_DIMENSIONS.x + tile.x;
+}
+
+// Picks the cascade by view depth and does a hardware compare, 1 is fully lit
+float GetCascadeShadow( vec3 worldPos, vec3 normal, vec3 lightDir )
+{
+   float viewDepth = dot(CASCADE_VIEW_Z_ROW.xyz, worldPos) + CASCADE_VIEW_Z_ROW.w;
+   int cascadeCount = int(CASCADE_INFO.x);
+   if(cascadeCount == 0 || viewDepth > CASCADE_SPLITS[cascadeCount - 1])
+   {
+      return 1.0f; // Past the shadow distance
+   }
+
+   int cascade = 0;
+   while(cascade < cascadeCount - 1 && viewDepth > CASCADE_SPLITS[cascade])
+   {
+      ++cascade;
+   }
+
+   // Slope scaled bias, grows with the texel footprint of the cascade
+   float slope = 1.0f - clamp(dot(normal, lightDir), 0.0f, 1.0f);
+   float bias = CASCADE_INFO.y * (1.0f + 4.0f * slope);
+
+   vec4 clipPos = CASCADE_VP[cascade] * vec4(worldPos, 1.0f);
+   vec3 shadowUVW = (clipPos.xyz / clipPos.w) * 0.5f + 0.5f;
+   return texture(gTexShadowCascades, vec4(shadowUVW.xy, float(cascade), shadowUVW.z - bias));
+}
+
 // Calculate lighting for all the lights
 LightFactor CalculateLighting( vec3 worldPos, vec3 eyeDir, vec3 normal, float specFactor, float specPower )
 {
@@ -133,9 +218,25 @@ LightFactor CalculateLighting( vec3 worldPos, vec3 eyeDir, vec3 normal, float sp
    finalFactor.diffuse = AMBIENCE.xyz * AMBIENCE.w; // Ambient light is always there
    finalFactor.specular = vec3(0.0f); // Specular initializes at 0
 
-   for(int lightIndex = 0; lightIndex < MAX_LIGHTS; ++lightIndex)
+   // Directional and other unbounded lights affect every cluster
+   for(uint lightIndex = 0; lightIndex < CLUSTER_DIMENSIONS.w; ++lightIndex)
+   {
+      Light light = LIGHTS[lightIndex];
+      LightFactor factor = CalculateLightFactor(worldPos, eyeDir, normal, light, specFactor, specPower);
+      if(light.isShadowCasting > 0.5f && light.shadowAtlasTile.z < 0.0f)
+      {
+         float shadow = GetCascadeShadow(worldPos, normal, -normalize(light.direction));
+         factor.diffuse *= shadow;
+         factor.specular *= shadow;
+      }
+      finalFactor.diffuse += factor.diffuse;
+      finalFactor.specular += factor.specular;
+   }
+
+   uvec2 cluster = CLUSTERS[GetClusterIndex(worldPos)];
+   for(uint index = 0; index < cluster.y; ++index)
    {
-      LightFactor factor = CalculateLightFactor(worldPos, eyeDir, normal, LIGHTS[lightIndex], specFactor, specPower);
+      LightFactor factor = CalculateLightFactor(worldPos, eyeDir, normal, LIGHTS[LIGHT_INDICES[cluster.x + index]], specFactor, specPower);
       finalFactor.diffuse += factor.diffuse;
       finalFactor.specular += factor.specular;
    }
@@ -2,8 +2,12 @@
 
 // Uniforms ==============================================
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION; 
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 
 // Attributes ============================================
 // Inputs
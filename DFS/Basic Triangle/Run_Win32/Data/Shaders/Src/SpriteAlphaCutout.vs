@@ -1,6 +1,10 @@
 #version 420 core
-uniform mat4 PROJECTION;								
-uniform mat4 VIEW; 									
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 uniform mat4 MODEL;
 
 in vec3 POSITION;								
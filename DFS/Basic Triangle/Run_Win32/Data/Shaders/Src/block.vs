@@ -9,8 +9,12 @@ out vec2 passUV;
 out vec2 passBorderUV; 
 out vec4 passColor; 
 
-uniform mat4 VIEW;
-uniform mat4 PROJECTION; 
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 
 
 vec2 BORDER_UVS[] = { vec2(0.0), vec2(0.0f, 1.0f), vec2(1.0f, 0.0f), vec2(1.0f) };
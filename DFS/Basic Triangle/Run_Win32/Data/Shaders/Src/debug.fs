@@ -8,6 +8,13 @@ out vec4 outColor;
 
 void main(void)									
 {													
+#ifdef SDF
+	// Distance field text, the alpha is the distance with the glyph edge at 0.5
+	float distance = texture( gTexDiffuse, passUV ).a;
+	float edgeWidth = max( fwidth( distance ) * 0.5f, 0.0001f );
+	vec4 diffuse = vec4( 1.0f, 1.0f, 1.0f, smoothstep( 0.5f - edgeWidth, 0.5f + edgeWidth, distance ) );
+#else
 	vec4 diffuse = texture( gTexDiffuse, passUV );		
+#endif
 	outColor = diffuse * passColor * passCurColor;				
 }
\ No newline at end of file
@@ -1,23 +1,48 @@
-#version 420 core									
-uniform mat4 PROJECTION;							
-uniform mat4 VIEW; 									
+#version 430 core
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 uniform mat4 MODEL;
 
 uniform vec4 CURCOLOR;
 
-in vec3 POSITION;								
-in vec4 COLOR; 										
-in vec2 UV;	
+#ifdef INSTANCED
+// One entry per instance of the shared mesh, INSTANCE_OFFSET is where this draw's run starts
+struct DebugInstance
+{
+   mat4 model;
+   vec4 color;
+};
+
+layout(binding=3, std430) readonly buffer sDebugInstanceBuffer
+{
+   DebugInstance INSTANCES[];
+};
+uniform int INSTANCE_OFFSET;
+#endif
+
+in vec3 POSITION;
+in vec4 COLOR;
+in vec2 UV;
 
 out vec4 passCurColor;
-out vec4 passColor;									
-out vec2 passUV;									
-void main( void )									
-{												
-	vec4 localPos = vec4(POSITION,1);					
-	vec4 clipPos = PROJECTION * VIEW * MODEL * localPos;		
-	gl_Position = clipPos;							
-	passColor = COLOR;								
-	passUV = UV;	
-	passCurColor = CURCOLOR;									
-}								
\ No newline at end of file
+out vec4 passColor;
+out vec2 passUV;
+void main( void )
+{
+	vec4 localPos = vec4(POSITION,1);
+#ifdef INSTANCED
+	DebugInstance instance = INSTANCES[INSTANCE_OFFSET + gl_InstanceID];
+	vec4 clipPos = PROJECTION * VIEW * MODEL * instance.model * localPos;
+	passCurColor = CURCOLOR * instance.color;
+#else
+	vec4 clipPos = PROJECTION * VIEW * MODEL * localPos;
+	passCurColor = CURCOLOR;
+#endif
+	gl_Position = clipPos;
+	passColor = COLOR;
+	passUV = UV;
+}
\ No newline at end of file
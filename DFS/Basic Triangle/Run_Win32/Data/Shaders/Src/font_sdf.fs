@@ -0,0 +1,23 @@
+#version 420 core
+
+// Signed distance field atlas, distance in alpha with the glyph edge at 0.5
+layout(binding = 0) uniform sampler2D gTexDiffuse;
+
+in vec2 passUV; 
+in vec4 passColor; 
+
+out vec4 outColor; 
+
+void main( void )
+{
+   // fwidth keeps the edge about a pixel wide whatever size the text is drawn at
+   float distance = texture( gTexDiffuse, passUV ).a;
+   float edgeWidth = max( fwidth( distance ) * 0.5f, 0.0001f );
+   float coverage = smoothstep( 0.5f - edgeWidth, 0.5f + edgeWidth, distance );
+   if(coverage <= 0.0f)
+   {
+      discard;
+   }
+
+   outColor = vec4( passColor.rgb, passColor.a * coverage );
+}
@@ -0,0 +1,26 @@
+#version 420 core
+
+// Attributes
+in vec3 POSITION;
+in vec4 COLOR;
+in vec2 UV; 
+
+out vec2 passUV; 
+out vec4 passColor; 
+
+uniform mat4 MODEL;
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
+
+void main( void )
+{
+   vec4 local_pos = vec4( POSITION, 1.0f );	
+
+   passUV = UV; 
+   passColor = COLOR; 
+   gl_Position = PROJECTION * VIEW * MODEL * local_pos;
+}
@@ -2,7 +2,12 @@
 
 // Uniforms ==============================================
 // Constants
-uniform vec3 EYE_POSITION;  // camera related
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 
 // Scene related
 uniform vec4  AMBIENT; // xyz color, w intensity
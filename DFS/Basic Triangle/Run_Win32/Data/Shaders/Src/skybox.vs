@@ -7,8 +7,12 @@ in vec4 COLOR;
 out vec3 passWorldPosition;
 out vec4 passColor; 
 
-uniform mat4 PROJECTION;
-uniform mat4 VIEW;
+layout(binding=1, std140) uniform cCameraBlock
+{
+   mat4 VIEW;
+   mat4 PROJECTION;
+   vec3 EYE_POSITION;   float CAMERA_PADDING;
+};
 uniform mat4 MODEL;
 
 void main( void )
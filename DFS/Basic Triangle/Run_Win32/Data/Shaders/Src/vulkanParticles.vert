@@ -0,0 +1,70 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Builds camera facing quads from the GPU particle buffers, there is no vertex input.
+// The draw's firstVertex selects the alive list, 6 vertices per particle
+
+layout(set = 0, binding = 0, std140) uniform CameraBlock
+{
+	mat4 VIEW;
+	mat4 PROJECTION;
+};
+
+layout(set = 0, binding = 1, std140) uniform ModelBlock
+{
+	mat4 MODEL;
+};
+
+struct Particle
+{
+	vec4 position;		// w = size
+	vec4 velocity;		// w = time born
+	vec4 color;
+	vec4 drawColor;
+	vec4 life;			// z = size after size over time
+};
+
+layout(set = 2, binding = 0, std430) readonly buffer ParticleBlock
+{
+	Particle particles[];
+};
+
+layout(set = 2, binding = 1, std430) readonly buffer AliveListBlock
+{
+	uint aliveIndices[];
+};
+
+layout(location = 0) out vec4 passColor;
+layout(location = 1) out vec2 passUV;
+
+out gl_PerVertex {
+	vec4 gl_Position;
+};
+
+// Same corners and winding as the CPU emitter's quads
+const int cornerOfVertex[6] = int[](0, 1, 3, 3, 1, 2);
+const vec2 corners[4] = vec2[](
+	vec2(0.0, 0.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 1.0),
+	vec2(0.0, 1.0)
+);
+
+void main() 
+{
+	Particle particle = particles[aliveIndices[gl_VertexIndex / 6]];
+	vec2 corner = corners[cornerOfVertex[gl_VertexIndex % 6]];
+
+	// Rows of the view rotation are the camera's axes in world space
+	vec3 right = vec3(VIEW[0][0], VIEW[1][0], VIEW[2][0]);
+	vec3 up = vec3(VIEW[0][1], VIEW[1][1], VIEW[2][1]);
+	float size = particle.life.z;
+
+	vec3 position = particle.position.xyz + (right * corner.x * size) + (up * corner.y * size);
+	vec4 worldPos = MODEL * vec4(position, 1.0f);
+
+	gl_Position = PROJECTION * VIEW * worldPos;
+	gl_Position.y = -gl_Position.y;
+	passColor = particle.drawColor;
+	passUV = corner;
+}
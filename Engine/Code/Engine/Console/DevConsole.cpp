@@ -141,12 +141,19 @@ void DevConsole::Render() const
 	renderer.SetOrtho(Matrix44::MakeOrtho3D(0.f, m_width, 0.f, m_height, -1.f, 1.f));
 	renderer.SetDefaultTexture();
 	renderer.SetDefaultMaterial();
-	renderer.DrawAABB2(GetConsoleBounds(), Rgba::FromBytes(0,0,100,50));
-	renderer.DrawAABB2(GetTextWindowBounds(), Rgba::FromBytes(100,100,100,50));
-	renderer.DrawAABB2(GetInputBounds(), Rgba::FromBytes(0,0,0,50));
+
+	// The panels, cursor and selection are all flat colored, so they go out in one draw. Layers
+	// keep them stacked in the order they used to be drawn
+	const Texture& white = *renderer.GetDefaultTexture();
+	renderer.BeginSpriteBatch();
+	renderer.DrawSprite(white, GetConsoleBounds(), AABB2::ZERO_TO_ONE, Matrix44::IDENTITY, 0, Rgba::FromBytes(0,0,100,50));
+	renderer.DrawSprite(white, GetTextWindowBounds(), AABB2::ZERO_TO_ONE, Matrix44::IDENTITY, 1, Rgba::FromBytes(100,100,100,50));
+	renderer.DrawSprite(white, GetInputBounds(), AABB2::ZERO_TO_ONE, Matrix44::IDENTITY, 1, Rgba::FromBytes(0,0,0,50));
 	
 	RenderCursor(renderer);
 	RenderSelection(renderer);
+	renderer.EndSpriteBatch();
+
 	RenderConsoleText(renderer);
 	RenderKurisu();
 }
@@ -158,6 +165,9 @@ void DevConsole::RenderConsoleText(Renderer& renderer) const
 {
 	Vector2 drawMins = GetInputBounds().mins;
 	
+	// Every line shares the font, so it all goes out in one draw
+	renderer.BeginTextBatch();
+
 	// Render input string
 	renderer.DrawText2D(drawMins, m_currentString, m_fontSize, m_font, Rgba::WHITE, m_fontAspectScale);
 	
@@ -171,6 +181,8 @@ void DevConsole::RenderConsoleText(Renderer& renderer) const
 		renderer.DrawText2D(drawMins, line->text, m_fontSize, m_font, line->color, m_fontAspectScale);
 		lineIndex++;
 	}
+
+	renderer.EndTextBatch();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -184,7 +196,7 @@ void DevConsole::RenderCursor(Renderer& renderer) const
 	cursorBounds.mins.x += fontWidth * m_cursorIndex;
 	cursorBounds.maxs.x = cursorBounds.mins.x + m_cursorThickness;
 
-	renderer.DrawAABB2(cursorBounds, m_cursorColor);
+	renderer.DrawSprite(*renderer.GetDefaultTexture(), cursorBounds, AABB2::ZERO_TO_ONE, Matrix44::IDENTITY, 2, m_cursorColor);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -214,7 +226,7 @@ void DevConsole::RenderSelection(Renderer& renderer) const
 		
 	}
 	
-	renderer.DrawAABB2(selectionBounds, m_cursorColor);
+	renderer.DrawSprite(*renderer.GetDefaultTexture(), selectionBounds, AABB2::ZERO_TO_ONE, Matrix44::IDENTITY, 2, m_cursorColor);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -224,8 +236,10 @@ void DevConsole::RenderKurisu() const
 {
 	Renderer* rend = Renderer::GetInstance();
 	
-	rend->SetTexture(0, (Texture*) m_kurisuGIF->GetCurrentTexture());
-	rend->DrawAABB2(GetKurisuBounds());
+	// Sprites put uv mins at the top left, the frame uvs have them at the bottom left
+	AABB2 frameUVs = m_kurisuGIF->GetCurrentUVs();
+	AABB2 spriteUVs(Vector2(frameUVs.mins.x, frameUVs.maxs.y), Vector2(frameUVs.maxs.x, frameUVs.mins.y));
+	rend->DrawSprite(*m_kurisuGIF->GetCurrentTexture(), GetKurisuBounds(), spriteUVs, Matrix44::IDENTITY);
 }
 
 //-----------------------------------------------------------------------------------------------
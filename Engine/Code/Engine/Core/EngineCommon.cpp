@@ -1,12 +1,15 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Blackboard.hpp"
 #include "Engine/Core/Clock.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/TransformSystem.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Console/DevConsole.hpp"
-//#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 Blackboard	g_gameConfigBlackboard;
@@ -16,13 +19,15 @@ Blackboard	g_gameConfigBlackboard;
 //
 void EngineStartup()
 {
+	MemoryTrackerStartup();
+	ProfilerStartup();
+	JobSystemStartup();
 	ClockSystemStartup();
 	RenderingSystemStartup();
 	DebugRendererStartup();
 	//InputSystemStartup();
 	AudioSystemStartup();
 	//ConsoleStartup();
-	//ProfilerStartup();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -35,6 +40,9 @@ void EngineShutdown()
 	//InputSystemShutdown();
 	DebugRendererShutdown();
 	RenderingSystemShutdown();
-	//ProfilerShutdown();
+	TransformSystemShutdown();
+	JobSystemShutdown();
+	ProfilerShutdown();
+	MemoryTrackerShutdown();
 }
 
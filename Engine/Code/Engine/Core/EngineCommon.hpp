@@ -12,6 +12,7 @@ extern Blackboard g_gameConfigBlackboard;
 // Constants
 const		int		BITMAP_FONT_TILES_WIDE = 16;
 const		int		BITMAP_FONT_TILES_HIGH = 16;
+const		int		BITMAP_FONT_GLYPH_COUNT = BITMAP_FONT_TILES_WIDE * BITMAP_FONT_TILES_HIGH;
 const		float	BITMAP_FONT_DEFAULT_BASE_ASPECT = 1.f;
 constexpr	int		NUM_VERTICES_FOR_CIRCLE = 100;
 const		float	POINT_RENDER_SCALE = 0.1f;
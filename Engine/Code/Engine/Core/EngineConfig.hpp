@@ -18,3 +18,12 @@
 //-----------------------------------------------------------------------------------------------
 // Profiler Config
 #define PROFILER_HISTORY_SIZE		128
+
+//-----------------------------------------------------------------------------------------------
+// Memory Tracker Config
+#define ENGINE_ENABLE_MEMORY_TRACKING	// Routes global new/delete through the tagged allocator
+#if defined(_DEBUG)
+#define MEMORY_TRACKER_CALLSTACK_DEPTH	12	// Frames kept per allocation, 0 compiles the live list and callstacks out
+#else
+#define MEMORY_TRACKER_CALLSTACK_DEPTH	0
+#endif
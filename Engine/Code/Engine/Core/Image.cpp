@@ -29,6 +29,16 @@ Image::Image(const Rgba& singlePixelColor, const std::string& name)
 	m_dimensions = IntVector2(1,1);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Constructor, every texel starts as the clear color
+//
+Image::Image(const IntVector2& dimensions, const Rgba& clearColor, const std::string& name)
+{
+	m_imagePath = name;
+	m_dimensions = dimensions;
+	m_texels.resize(dimensions.x * dimensions.y, clearColor);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Populates the texel vector with data from the image
 // 
@@ -14,6 +14,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors
 	Image(const Rgba& singlePixelColor, const std::string& name);
+	Image(const IntVector2& dimensions, const Rgba& clearColor, const std::string& name);
 	Image(const std::string& imageFilePath, bool flipY = true);
 
 	//-----------------------------------------------------------------------------------------------
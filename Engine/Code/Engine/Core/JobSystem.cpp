@@ -0,0 +1,445 @@
+#include "Engine/Core/JobSystem.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <chrono>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static JobSystem* g_jobSystem = nullptr;
+static thread_local int t_threadIndex = -1;
+
+constexpr int JOB_SPINS_BEFORE_SLEEP = 64;
+
+//-----------------------------------------------------------------------------------------------
+// Constructor, the calling thread becomes thread 0
+//
+JobSystem::JobSystem(int workerCount)
+	: m_mainThreadJobCount(0)
+	, m_isRunning(true)
+	, m_queuedCount(0)
+	, m_activeCount(0)
+	, m_sleepingCount(0)
+{
+	int threadCount = workerCount + 1;
+	for(int threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+	{
+		m_queues.push_back(new WorkStealingQueue());
+
+		Job* pool = new Job[JOB_POOL_SIZE];
+		for(int jobIndex = 0; jobIndex < JOB_POOL_SIZE; ++jobIndex)
+		{
+			pool[jobIndex].m_isFinished.store(true, std::memory_order_relaxed);
+		}
+		m_jobPools.push_back(pool);
+		m_nextJobIndex.push_back(0);
+	}
+
+	t_threadIndex = 0;
+	for(int threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerMain, this, threadIndex));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor, finishes everything in flight before stopping the workers
+//
+JobSystem::~JobSystem()
+{
+	WaitForAll();
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepLock);
+		m_isRunning.store(false);
+	}
+	m_wakeCondition.notify_all();
+
+	for(std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	for(int threadIndex = 0; threadIndex < (int) m_queues.size(); ++threadIndex)
+	{
+		delete m_queues[threadIndex];
+		delete[] m_jobPools[threadIndex];
+	}
+	m_queues.clear();
+	m_jobPools.clear();
+	t_threadIndex = -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the job system, must be called from the main thread
+//
+STATIC JobSystem* JobSystem::CreateInstance(int workerCount /*= -1 */)
+{
+	if(g_jobSystem == nullptr)
+	{
+		if(workerCount < 0)
+		{
+			int coreCount = (int) std::thread::hardware_concurrency();
+			workerCount = (coreCount > 1) ? coreCount - 1 : 0;
+		}
+
+		g_jobSystem = new JobSystem(workerCount);
+	}
+
+	return g_jobSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the job system instance
+//
+STATIC JobSystem* JobSystem::GetInstance()
+{
+	return g_jobSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the job system instance
+//
+STATIC void JobSystem::DestroyInstance()
+{
+	if(g_jobSystem)
+	{
+		delete g_jobSystem;
+		g_jobSystem = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the index of the calling thread in the system
+//
+STATIC int JobSystem::GetThreadIndex()
+{
+	return t_threadIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs everything that was queued for the main thread
+//
+void JobSystem::BeginFrame()
+{
+	GUARANTEE_OR_DIE(IsMainThread(), "JobSystem::BeginFrame has to be called from the main thread");
+
+	std::deque<Job*> jobs;
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadLock);
+		jobs.swap(m_mainThreadJobs);
+		m_mainThreadJobCount.store(0, std::memory_order_relaxed);
+	}
+
+	for(Job* job : jobs)
+	{
+		Execute(job);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Schedules a job on the whole range [0, 1)
+//
+void JobSystem::Run(JobFunction function, void* userData, JobCounter* counter /*= nullptr */, JobCounter* dependency /*= nullptr */)
+{
+	RunRange(function, userData, 0, 1, counter, dependency);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Schedules a job, it starts right away or once the dependency counter reaches zero
+//
+void JobSystem::RunRange(JobFunction function, void* userData, int begin, int end, JobCounter* counter /*= nullptr */, JobCounter* dependency /*= nullptr */)
+{
+	Job* job = AllocateJob(function, userData, begin, end, counter);
+
+	if(dependency)
+	{
+		std::lock_guard<std::mutex> lock(dependency->m_lock);
+		if(dependency->m_count.load(std::memory_order_acquire) != 0)
+		{
+			dependency->m_dependents.push_back(job);
+			return;
+		}
+	}
+
+	Schedule(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Queues a job that only the main thread will run, on its next BeginFrame or while it waits
+//
+void JobSystem::RunOnMainThread(JobFunction function, void* userData, JobCounter* counter /*= nullptr */)
+{
+	Job* job = AllocateJob(function, userData, 0, 1, counter);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadLock);
+		m_mainThreadJobs.push_back(job);
+		m_mainThreadJobCount.fetch_add(1, std::memory_order_release);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs other jobs until the counter is done. Taking the lock at the end makes sure the thread
+// that dropped the count to zero is done with the counter before the caller can destroy it
+//
+void JobSystem::Wait(JobCounter& counter)
+{
+	while(!counter.IsDone())
+	{
+		if(!RunOneJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(counter.m_lock);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs jobs until nothing is left in flight
+//
+void JobSystem::WaitForAll()
+{
+	while(m_activeCount.load(std::memory_order_acquire) > 0)
+	{
+		if(!RunOneJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// About four batches per thread so stealing can even out uneven batches, never less than the
+// minimum so tiny bodies still amortize the scheduling
+//
+int JobSystem::GetBatchSize(int count, int minBatchSize) const
+{
+	int targetBatches = GetThreadCount() * 4;
+	int batchSize = (count + targetBatches - 1) / targetBatches;
+	return (batchSize > minBatchSize) ? batchSize : ((minBatchSize > 0) ? minBatchSize : 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the next slot in the calling thread's pool, helps out until the slot's previous job has
+// finished if the pool wrapped around
+//
+Job* JobSystem::AllocateJob(JobFunction function, void* userData, int begin, int end, JobCounter* counter)
+{
+	int threadIndex = GetThreadIndex();
+	GUARANTEE_OR_DIE(threadIndex >= 0, "Jobs can only be scheduled from the main thread or from a job");
+
+	uint32_t jobIndex = m_nextJobIndex[threadIndex]++ & (JOB_POOL_SIZE - 1);
+	Job* job = &m_jobPools[threadIndex][jobIndex];
+	while(!job->m_isFinished.load(std::memory_order_acquire))
+	{
+		if(!RunOneJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	job->m_function = function;
+	job->m_userData = userData;
+	job->m_begin = begin;
+	job->m_end = end;
+	job->m_counter = counter;
+	job->m_isFinished.store(false, std::memory_order_relaxed);
+
+	if(counter)
+	{
+		counter->m_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_activeCount.fetch_add(1, std::memory_order_relaxed);
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes the job on the calling thread's deque and wakes a sleeping worker. A full deque runs
+// the job inline. The queued count goes up before the push, a thief that takes the job right
+// away must never take the count below zero
+//
+void JobSystem::Schedule(Job* job)
+{
+	int threadIndex = GetThreadIndex();
+	m_queuedCount.fetch_add(1, std::memory_order_release);
+	if(!m_queues[threadIndex]->Push(job))
+	{
+		m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+		Execute(job);
+		return;
+	}
+
+	if(m_sleepingCount.load(std::memory_order_acquire) > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepLock);
+		}
+		m_wakeCondition.notify_one();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs the job, signals its counter and schedules whatever was waiting on the counter
+//
+void JobSystem::Execute(Job* job)
+{
+	job->m_function(job->m_userData, job->m_begin, job->m_end);
+
+	JobCounter* counter = job->m_counter;
+	if(counter)
+	{
+		std::vector<Job*> dependents;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_lock);
+			if(counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				dependents.swap(counter->m_dependents);
+			}
+		}
+
+		for(Job* dependent : dependents)
+		{
+			Schedule(dependent);
+		}
+	}
+
+	job->m_isFinished.store(true, std::memory_order_release);
+	m_activeCount.fetch_sub(1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Own deque first, then steals starting from the next thread over so the thieves spread out
+//
+Job* JobSystem::FindJob(int threadIndex)
+{
+	Job* job = m_queues[threadIndex]->Pop();
+	if(job)
+	{
+		return job;
+	}
+
+	int threadCount = (int) m_queues.size();
+	for(int offset = 1; offset < threadCount; ++offset)
+	{
+		job = m_queues[(threadIndex + offset) % threadCount]->Steal();
+		if(job)
+		{
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the oldest job queued for the main thread
+//
+Job* JobSystem::PopMainThreadJob()
+{
+	if(m_mainThreadJobCount.load(std::memory_order_acquire) <= 0)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mainThreadLock);
+	if(m_mainThreadJobs.empty())
+	{
+		return nullptr;
+	}
+
+	Job* job = m_mainThreadJobs.front();
+	m_mainThreadJobs.pop_front();
+	m_mainThreadJobCount.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs one job if there is any, returns false if there was nothing to do. The main thread also
+// takes the jobs that are pinned to it
+//
+bool JobSystem::RunOneJob()
+{
+	int threadIndex = GetThreadIndex();
+	if(threadIndex < 0)
+	{
+		return false;
+	}
+
+	Job* job = nullptr;
+	if(m_queuedCount.load(std::memory_order_acquire) > 0)
+	{
+		job = FindJob(threadIndex);
+		if(job)
+		{
+			m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	if(job == nullptr && threadIndex == 0)
+	{
+		job = PopMainThreadJob();
+	}
+
+	if(job == nullptr)
+	{
+		return false;
+	}
+
+	Execute(job);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Worker loop, spins for a little while after running out of work before going to sleep
+//
+void JobSystem::WorkerMain(int threadIndex)
+{
+	t_threadIndex = threadIndex;
+
+	int idleSpins = 0;
+	while(m_isRunning.load(std::memory_order_acquire))
+	{
+		if(RunOneJob())
+		{
+			idleSpins = 0;
+			continue;
+		}
+
+		if(++idleSpins < JOB_SPINS_BEFORE_SLEEP)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// The timeout covers a push racing the sleeping count
+		std::unique_lock<std::mutex> lock(m_sleepLock);
+		m_sleepingCount.fetch_add(1);
+		m_wakeCondition.wait_for(lock, std::chrono::milliseconds(1), [this]()
+		{
+			return m_queuedCount.load() > 0 || !m_isRunning.load();
+		});
+		m_sleepingCount.fetch_sub(1);
+		idleSpins = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts up the job system on the calling (main) thread
+//
+void JobSystemStartup()
+{
+	JobSystem::CreateInstance();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Finishes the remaining jobs and stops the workers
+//
+void JobSystemShutdown()
+{
+	JobSystem::DestroyInstance();
+}
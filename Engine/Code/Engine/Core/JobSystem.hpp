@@ -0,0 +1,185 @@
+#pragma once
+#include "Engine/Core/WorkStealingQueue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class JobCounter;
+
+//-----------------------------------------------------------------------------------------------
+typedef void (*JobFunction)( void* userData, int begin, int end );
+
+//-----------------------------------------------------------------------------------------------
+// Lives in the scheduling thread's job pool, the slot is reused once the job is finished
+//
+struct Job
+{
+	JobFunction			m_function = nullptr;
+	void*				m_userData = nullptr;
+	int					m_begin = 0;
+	int					m_end = 0;
+	JobCounter*			m_counter = nullptr;
+	std::atomic<bool>	m_isFinished;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Counts unfinished jobs. Waiting on it runs other jobs instead of blocking, and jobs can be
+// scheduled to start once it reaches zero
+//
+class JobCounter
+{
+	friend class JobSystem;
+
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	JobCounter(): m_count(0) {}
+	~JobCounter(){}
+	JobCounter( const JobCounter& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool				IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+			int					GetCount() const { return m_count.load(std::memory_order_acquire); }
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			std::atomic<int>	m_count;
+			std::mutex			m_lock;			// Guards the dependents and the drop to zero
+			std::vector<Job*>	m_dependents;	// Scheduled when the count drops to zero
+};
+
+//-----------------------------------------------------------------------------------------------
+// Work stealing job system. Every thread owns a deque it pushes to and pops from, idle threads
+// steal from the others. The main thread is thread 0 and also drains a queue of jobs that must
+// not run anywhere else. Waiting never blocks a core, the waiting thread runs jobs until the
+// counter is done, and only workers with nothing to do go to sleep
+//
+class JobSystem
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	JobSystem( int workerCount );
+	~JobSystem();
+
+	static	JobSystem*			CreateInstance( int workerCount = -1 ); // -1 = one worker per extra core
+	static	JobSystem*			GetInstance();
+	static	void				DestroyInstance();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int					GetThreadCount() const { return (int) m_workers.size() + 1; }
+	static	int					GetThreadIndex(); // 0 is the main thread, -1 for threads the system does not own
+	static	bool				IsMainThread() { return GetThreadIndex() == 0; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				BeginFrame(); // Runs the jobs queued for the main thread
+			void				Run( JobFunction function, void* userData, JobCounter* counter = nullptr, JobCounter* dependency = nullptr );
+			void				RunRange( JobFunction function, void* userData, int begin, int end, JobCounter* counter = nullptr, JobCounter* dependency = nullptr );
+			void				RunOnMainThread( JobFunction function, void* userData, JobCounter* counter = nullptr );
+			void				Wait( JobCounter& counter );
+			void				WaitForAll();
+			int					GetBatchSize( int count, int minBatchSize ) const;
+
+	template <typename Func>
+			void				ParallelFor( int count, const Func& body, int minBatchSize = 64 );		// body(index)
+	template <typename Func>
+			void				ParallelForRange( int count, const Func& body, int minBatchSize = 64 );	// body(begin, end)
+
+private:
+			Job*				AllocateJob( JobFunction function, void* userData, int begin, int end, JobCounter* counter );
+			void				Schedule( Job* job );
+			void				Execute( Job* job );
+			Job*				FindJob( int threadIndex );
+			Job*				PopMainThreadJob();
+			bool				RunOneJob();
+			void				WorkerMain( int threadIndex );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	static	constexpr int			JOB_POOL_SIZE = 4096; // Per thread, power of two
+
+			std::vector<std::thread>		m_workers;
+			std::vector<WorkStealingQueue*>	m_queues;		// One per thread, main thread first
+			std::vector<Job*>				m_jobPools;		// JOB_POOL_SIZE jobs per thread
+			std::vector<uint32_t>			m_nextJobIndex;	// Only touched by the owning thread
+
+			std::mutex						m_mainThreadLock;
+			std::deque<Job*>				m_mainThreadJobs;
+			std::atomic<int>				m_mainThreadJobCount;	// Lets idle checks skip the lock
+
+			std::atomic<bool>				m_isRunning;
+			std::atomic<int>				m_queuedCount;	// Jobs sitting in a deque, wakes sleepers
+			std::atomic<int>				m_activeCount;	// Jobs scheduled and not finished
+			std::atomic<int>				m_sleepingCount;
+			std::mutex						m_sleepLock;
+			std::condition_variable			m_wakeCondition;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Calls the body once with the batch's range
+//
+template <typename Func>
+void RunParallelForRangeBatch(void* userData, int begin, int end)
+{
+	const Func& body = *(const Func*) userData;
+	body(begin, end);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Splits [0, count) into batches across the threads and waits for all of them. Small loops run
+// inline on the calling thread
+//
+template <typename Func>
+void JobSystem::ParallelFor(int count, const Func& body, int minBatchSize)
+{
+	ParallelForRange(count, [&body](int begin, int end)
+	{
+		for(int index = begin; index < end; ++index)
+		{
+			body(index);
+		}
+	}, minBatchSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Same as ParallelFor but hands whole batches to the body, for loops that vectorize
+//
+template <typename Func>
+void JobSystem::ParallelForRange(int count, const Func& body, int minBatchSize)
+{
+	if(count <= 0)
+	{
+		return;
+	}
+
+	int batchSize = GetBatchSize(count, minBatchSize);
+	if(batchSize >= count)
+	{
+		body(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for(int begin = batchSize; begin < count; begin += batchSize)
+	{
+		int end = (count - begin > batchSize) ? begin + batchSize : count;
+		RunRange(&RunParallelForRangeBatch<Func>, (void*) &body, begin, end, &counter);
+	}
+
+	body(0, batchSize); // The first batch runs here while the others get stolen
+	Wait(counter);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void	JobSystemStartup();
+void	JobSystemShutdown();
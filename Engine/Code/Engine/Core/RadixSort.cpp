@@ -0,0 +1,76 @@
+#include "Engine/Core/RadixSort.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+
+//-----------------------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------------------
+// LSD radix sort on the keys, only the index array is moved around. Passes where every key
+// has the same byte are skipped, so keys that only use a few bits are cheap
+//
+void RadixSortIndices(const uint64_t* keys, uint32_t count, std::vector<uint32_t>& out_order)
+{
+	out_order.resize(count);
+	for(uint32_t index = 0; index < count; ++index)
+	{
+		out_order[index] = index;
+	}
+
+	if(count < 2)
+	{
+		return;
+	}
+
+	// Histogram every byte in one go
+	uint32_t histograms[8][256] = {};
+	for(uint32_t index = 0; index < count; ++index)
+	{
+		uint64_t key = keys[index];
+		for(int pass = 0; pass < 8; ++pass)
+		{
+			histograms[pass][(key >> (pass * 8)) & 0xff]++;
+		}
+	}
+
+	std::vector<uint32_t> scratch(count);
+	uint32_t* source = out_order.data();
+	uint32_t* destination = scratch.data();
+
+	for(int pass = 0; pass < 8; ++pass)
+	{
+		uint32_t* histogram = histograms[pass];
+		int shift = pass * 8;
+
+		// All keys share this byte, nothing to do
+		if(histogram[(keys[source[0]] >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		// Prefix sum to get the start offset of each bucket
+		uint32_t offset = 0;
+		for(int bucket = 0; bucket < 256; ++bucket)
+		{
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for(uint32_t index = 0; index < count; ++index)
+		{
+			uint32_t keyIndex = source[index];
+			destination[histogram[(keys[keyIndex] >> shift) & 0xff]++] = keyIndex;
+		}
+
+		uint32_t* temp = source;
+		source = destination;
+		destination = temp;
+	}
+
+	// Odd number of passes leaves the result in the scratch buffer
+	if(source != out_order.data())
+	{
+		out_order.swap(scratch);
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+// Fills out_order with the indices of the keys in ascending key order (Stable, 8 bits per pass)
+void	RadixSortIndices( const uint64_t* keys, uint32_t count, std::vector<uint32_t>& out_order );
+
@@ -0,0 +1,90 @@
+#include "Engine/Core/WorkStealingQueue.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+WorkStealingQueue::WorkStealingQueue()
+	: m_top(0)
+	, m_bottom(0)
+{
+	for(int64_t index = 0; index < CAPACITY; ++index)
+	{
+		m_jobs[index].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if there was nothing to take at the time of the call
+//
+bool WorkStealingQueue::IsEmpty() const
+{
+	return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a job at the bottom, returns false if the queue is full
+//
+bool WorkStealingQueue::Push(Job* job)
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_acquire);
+	if(bottom - top >= CAPACITY)
+	{
+		return false;
+	}
+
+	m_jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	m_bottom.store(bottom + 1, std::memory_order_release); // Publishes the job to the thieves
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the newest job. Races the thieves for the last one through the top index
+//
+Job* WorkStealingQueue::Pop()
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if(top > bottom)
+	{
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if(top == bottom)
+	{
+		if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr; // A thief got it
+		}
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the oldest job, returns nullptr if empty or another thread won the race
+//
+Job* WorkStealingQueue::Steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(std::memory_order_acquire);
+	if(top >= bottom)
+	{
+		return nullptr;
+	}
+
+	Job* job = m_jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+struct Job;
+
+//-----------------------------------------------------------------------------------------------
+// Bounded Chase-Lev deque. The owning thread pushes and pops at the bottom (LIFO, keeps its
+// caches warm), any other thread steals from the top (FIFO, takes the oldest and usually the
+// biggest piece of work). Push fails when full so the caller can run the job inline instead
+//
+class WorkStealingQueue
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	WorkStealingQueue();
+	~WorkStealingQueue(){}
+	WorkStealingQueue( const WorkStealingQueue& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool				IsEmpty() const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool				Push( Job* job );	// Owner only
+			Job*				Pop();				// Owner only
+			Job*				Steal();			// Any thread
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	static	constexpr int64_t	CAPACITY = 4096; // Power of two
+
+private:
+	alignas(64)	std::atomic<int64_t>	m_top;
+	alignas(64)	std::atomic<int64_t>	m_bottom;
+				std::atomic<Job*>		m_jobs[CAPACITY];
+};
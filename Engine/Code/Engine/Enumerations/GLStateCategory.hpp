@@ -0,0 +1,21 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Groups of GL state the state cache counts calls for, names live in GLStateCache.cpp
+//
+enum eGLStateCategory
+{
+	STATE_CATEGORY_PROGRAM,
+	STATE_CATEGORY_VERTEX_ARRAY,
+	STATE_CATEGORY_BUFFER,				// Generic and indexed buffer bindings
+	STATE_CATEGORY_TEXTURE,				// Texture binds and the active unit switches they need
+	STATE_CATEGORY_SAMPLER,
+	STATE_CATEGORY_FRAMEBUFFER,
+	STATE_CATEGORY_FIXED_FUNCTION,		// Caps, blend, depth, cull, wind order and fill mode
+	STATE_CATEGORY_VIEWPORT,
+	NUM_STATE_CATEGORIES
+};
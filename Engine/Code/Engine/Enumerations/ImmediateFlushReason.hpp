@@ -0,0 +1,20 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Why a batch of immediate draws was submitted, names live in VKRenderer.cpp
+//
+enum eImmediateFlushReason
+{
+	IMMEDIATE_FLUSH_STATE_CHANGE,		// The next immediate draw used another material, shader, texture or render state
+	IMMEDIATE_FLUSH_DRAW,				// Other GPU work has to come after the batch
+	IMMEDIATE_FLUSH_CAMERA,
+	IMMEDIATE_FLUSH_MATERIAL_RESET,
+	IMMEDIATE_FLUSH_FULL,				// The frame's vertex range ran out
+	IMMEDIATE_FLUSH_READ_BACK,
+	IMMEDIATE_FLUSH_END_FRAME,
+	NUM_IMMEDIATE_FLUSH_REASONS
+};
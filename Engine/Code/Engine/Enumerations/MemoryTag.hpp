@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+// Subsystem an allocation is charged to, names live in MemoryTracker.cpp
+//
+enum eMemoryTag : uint8_t
+{
+	MEMORY_TAG_UNTAGGED,
+	MEMORY_TAG_ENGINE,
+	MEMORY_TAG_RENDERER,
+	MEMORY_TAG_TEXTURE,
+	MEMORY_TAG_MESH,
+	MEMORY_TAG_MATERIAL,
+	MEMORY_TAG_SHADER,
+	MEMORY_TAG_DEBUG_RENDER,
+	MEMORY_TAG_PARTICLES,
+	MEMORY_TAG_STAGING,
+	MEMORY_TAG_AUDIO,
+	MEMORY_TAG_PROFILER,
+	MEMORY_TAG_CONSOLE,
+	MEMORY_TAG_GAME,
+	NUM_MEMORY_TAGS
+};
@@ -8,6 +8,7 @@
 enum ReservedDescriptorSetSlot
 {
 	RESERVED_SLOT_UNIFORM_BUFFER,
-	RESERVED_SLOT_COMBINED_IMAGE_SAMPLER
+	RESERVED_SLOT_COMBINED_IMAGE_SAMPLER,
+	RESERVED_SLOT_STORAGE_BUFFER
 };
 
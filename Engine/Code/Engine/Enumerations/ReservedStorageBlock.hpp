@@ -0,0 +1,15 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+
+//-----------------------------------------------------------------------------------------------
+enum RESERVED_STORAGE_BLOCKS : int
+{
+	STORAGE_LIGHTS,
+	STORAGE_LIGHT_CLUSTERS,
+	STORAGE_LIGHT_INDICES,
+	STORAGE_DEBUG_INSTANCES
+};
+
@@ -12,6 +12,8 @@ enum RESERVED_UNIFORM_BLOCKS : int
 	BLOCK_MODEL,
 	BLOCK_LIGHT,
 	BLOCK_SPECULAR,
-	BLOCK_FOG
+	BLOCK_FOG,
+	BLOCK_LIGHT_CLUSTERS,
+	BLOCK_SHADOW_CASCADES
 };
 
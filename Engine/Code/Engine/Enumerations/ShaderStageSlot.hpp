@@ -23,6 +23,7 @@ enum ShaderStageSlot
 static const std::map<std::string, ShaderStageSlot> ParseShaderStageSlot =
 {
 	{"vertex", SHADER_STAGE_VERTEX},
-	{"fragment", SHADER_STAGE_FRAGMENT}
+	{"fragment", SHADER_STAGE_FRAGMENT},
+	{"compute", SHADER_STAGE_COMPUTE}
 };
 
@@ -10,5 +10,6 @@ enum TextureSlot
 	TEXTURE_SLOT_DIFFUSE,
 	TEXTURE_SLOT_NORMAL,
 	TEXTURE_SLOT_SHADOWMAP = 7,
-	TEXTURE_SLOT_SKYBOX = 8
+	TEXTURE_SLOT_SKYBOX = 8,
+	TEXTURE_SLOT_SHADOW_CASCADES = 9
 };
\ No newline at end of file
@@ -92,6 +92,22 @@ bool FileWriteToNewFile(const char* fileName, const char* bufferData, size_t cou
 	return true;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if the file can be opened for reading
+//
+bool FileExists(const char* fileName)
+{
+	FILE *fp = nullptr;
+	fopen_s( &fp, fileName, "rb" );
+
+	if (fp == nullptr) {
+		return false;
+	}
+
+	fclose(fp);
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Writes data into a png
 //
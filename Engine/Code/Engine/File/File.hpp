@@ -12,6 +12,10 @@ void* FileBinaryReadToNewBuffer( const char* fileName, size_t* outSize = nullptr
 // Writes a buffer into a file
 bool FileWriteToNewFile( const char* filename, const char* data, size_t length );
 
+//-----------------------------------------------------------------------------------------------
+// Checks if the file can be opened for reading
+bool FileExists( const char* fileName );
+
 
 //-----------------------------------------------------------------------------------------------
 // Write to a png file
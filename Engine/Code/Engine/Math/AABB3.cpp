@@ -2,6 +2,9 @@
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <cmath>
 //-----------------------------------------------------------------------------------------------
 
 
@@ -17,7 +20,7 @@ AABB3::AABB3()
 //-----------------------------------------------------------------------------------------------
 // Returns true if the AABB3 is uninitialized
 //
-bool AABB3::IsInvalid()
+bool AABB3::IsInvalid() const
 {
 	return mins.x > maxs.x;
 }
@@ -25,7 +28,7 @@ bool AABB3::IsInvalid()
 //-----------------------------------------------------------------------------------------------
 // Returns the back bottom left corner
 //
-Vector3 AABB3::GetBackBottomLeft()
+Vector3 AABB3::GetBackBottomLeft() const
 {
 	return mins;
 }
@@ -33,7 +36,7 @@ Vector3 AABB3::GetBackBottomLeft()
 //-----------------------------------------------------------------------------------------------
 // Returns the back bottom right corner
 //
-Vector3 AABB3::GetBackBottomRight()
+Vector3 AABB3::GetBackBottomRight() const
 {
 	Vector3 br = mins + Vector3(GetSizes().x, 0.f, 0.f);
 	return br;
@@ -42,7 +45,7 @@ Vector3 AABB3::GetBackBottomRight()
 //-----------------------------------------------------------------------------------------------
 // Returns the back top right corner
 //
-Vector3 AABB3::GetBackTopRight()
+Vector3 AABB3::GetBackTopRight() const
 {
 	Vector3 sizes = GetSizes();
 	Vector3 tr = mins + Vector3(sizes.x, sizes.y, 0.f);
@@ -52,7 +55,7 @@ Vector3 AABB3::GetBackTopRight()
 //-----------------------------------------------------------------------------------------------
 // Returns the back top left corner
 //
-Vector3 AABB3::GetBackTopLeft()
+Vector3 AABB3::GetBackTopLeft() const
 {
 	Vector3 sizes = GetSizes();
 	Vector3 tl = mins + Vector3(0.f, sizes.y, 0.f);
@@ -62,7 +65,7 @@ Vector3 AABB3::GetBackTopLeft()
 //-----------------------------------------------------------------------------------------------
 // Returns the front bottom left
 //
-Vector3 AABB3::GetFrontBottomLeft()
+Vector3 AABB3::GetFrontBottomLeft() const
 {
 	Vector3 sizes = GetSizes();
 	Vector3 frontMins = maxs + Vector3(-sizes.x, -sizes.y, 0.f);
@@ -72,7 +75,7 @@ Vector3 AABB3::GetFrontBottomLeft()
 //-----------------------------------------------------------------------------------------------
 // Returns the front bottom right
 //
-Vector3 AABB3::GetFrontBottomRight()
+Vector3 AABB3::GetFrontBottomRight() const
 {
 	Vector3 sizes = GetSizes();
 	Vector3 frontBR = maxs + Vector3(0.f, -sizes.y, 0.f);
@@ -82,7 +85,7 @@ Vector3 AABB3::GetFrontBottomRight()
 //-----------------------------------------------------------------------------------------------
 // Returns the front top right
 //
-Vector3 AABB3::GetFrontTopRight()
+Vector3 AABB3::GetFrontTopRight() const
 {
 	return maxs;
 }
@@ -90,7 +93,7 @@ Vector3 AABB3::GetFrontTopRight()
 //-----------------------------------------------------------------------------------------------
 // Returns the front top left
 //
-Vector3 AABB3::GetFrontTopLeft()
+Vector3 AABB3::GetFrontTopLeft() const
 {
 	Vector3 sizes = GetSizes();
 	Vector3 frontTL = maxs + Vector3(-sizes.x, 0.f, 0.f);
@@ -100,7 +103,7 @@ Vector3 AABB3::GetFrontTopLeft()
 //-----------------------------------------------------------------------------------------------
 // Returns the center position
 //
-Vector3 AABB3::GetCenter()
+Vector3 AABB3::GetCenter() const
 {
 	return (mins + maxs) * 0.5f;
 }
@@ -108,7 +111,7 @@ Vector3 AABB3::GetCenter()
 //-----------------------------------------------------------------------------------------------
 // Returns the half dimensions of the aabb3
 //
-Vector3 AABB3::GetHalfExtents()
+Vector3 AABB3::GetHalfExtents() const
 {
 	Vector3 halfSizes = maxs - mins;
 	return Abs(halfSizes * 0.5f);
@@ -117,12 +120,46 @@ Vector3 AABB3::GetHalfExtents()
 //-----------------------------------------------------------------------------------------------
 // Returns the sizes on all sides
 //
-Vector3 AABB3::GetSizes()
+Vector3 AABB3::GetSizes() const
 {
 	Vector3 sizes = maxs - mins;
 	return Abs(sizes);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if none of the bounds are infinite (default constructed aabb3 is infinite)
+//
+bool AABB3::IsFinite() const
+{
+	return isfinite(mins.x) && isfinite(mins.y) && isfinite(mins.z) && isfinite(maxs.x) && isfinite(maxs.y) && isfinite(maxs.z);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the surface area (Used as the cost metric for bounding volume trees)
+//
+float AABB3::GetSurfaceArea() const
+{
+	Vector3 sizes = maxs - mins;
+	return 2.f * (sizes.x * sizes.y + sizes.y * sizes.z + sizes.z * sizes.x);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the aabb3 that bounds this box after it is transformed by the matrix
+//
+AABB3 AABB3::GetTransformed(const Matrix44& transform) const
+{
+	Vector3 center = transform.TransformPosition3D(GetCenter());
+	Vector3 halfExtents = GetHalfExtents();
+
+	// Each new extent is the sum of the absolute basis contributions
+	Vector3 newHalfExtents;
+	newHalfExtents.x = fabsf(transform.Ix) * halfExtents.x + fabsf(transform.Jx) * halfExtents.y + fabsf(transform.Kx) * halfExtents.z;
+	newHalfExtents.y = fabsf(transform.Iy) * halfExtents.x + fabsf(transform.Jy) * halfExtents.y + fabsf(transform.Ky) * halfExtents.z;
+	newHalfExtents.z = fabsf(transform.Iz) * halfExtents.x + fabsf(transform.Jz) * halfExtents.y + fabsf(transform.Kz) * halfExtents.z;
+
+	return AABB3(center - newHalfExtents, center + newHalfExtents);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets the new center and calculates bounds from it
 //
@@ -151,15 +188,58 @@ void AABB3::GrowToContain(const Vector3& pos)
 	maxs = Max(maxs, pos);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Modifies the aabb3 to contain the other aabb3
+//
+void AABB3::GrowToContain(const AABB3& bounds)
+{
+	mins = Min(mins, bounds.mins);
+	maxs = Max(maxs, bounds.maxs);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Expands the aabb3 on all sides
+//
+void AABB3::AddPadding(float padding)
+{
+	mins -= Vector3(padding);
+	maxs += Vector3(padding);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns true if the point is inside 
 //
 bool AABB3::IsPointInside(const Vector3& pos) const
 {
-	if(pos.x >= mins.x && pos.x <= maxs.x && pos.y >= mins.y && pos.z >= mins.z && pos.z <= maxs.z)
+	if(pos.x >= mins.x && pos.x <= maxs.x && pos.y >= mins.y && pos.y <= maxs.y && pos.z >= mins.z && pos.z <= maxs.z)
 	{
 		return true;
 	}	
 	
 	return false;
 }
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the given aabb3 is completely inside this one
+//
+bool AABB3::IsContaining(const AABB3& bounds) const
+{
+	return	mins.x <= bounds.mins.x && mins.y <= bounds.mins.y && mins.z <= bounds.mins.z &&
+			maxs.x >= bounds.maxs.x && maxs.y >= bounds.maxs.y && maxs.z >= bounds.maxs.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns an inverted aabb3 that any point or box can grow from
+//
+STATIC AABB3 AABB3::MakeEmpty()
+{
+	return AABB3(Vector3(INFINITY), Vector3(-INFINITY));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the aabb3 that contains both a and b
+//
+STATIC AABB3 AABB3::MakeUnion(const AABB3& a, const AABB3& b)
+{
+	return AABB3(Min(a.mins, b.mins), Max(a.maxs, b.maxs));
+}
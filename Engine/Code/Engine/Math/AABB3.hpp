@@ -3,7 +3,7 @@
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
-
+class Matrix44;
 
 //-----------------------------------------------------------------------------------------------
 class AABB3
@@ -17,25 +17,36 @@ public:
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-	bool	IsInvalid();
-	Vector3	GetBackBottomLeft();
-	Vector3	GetBackBottomRight();
-	Vector3 GetBackTopRight();
-	Vector3 GetBackTopLeft();
-	Vector3 GetFrontBottomLeft();
-	Vector3 GetFrontBottomRight();
-	Vector3 GetFrontTopRight();
-	Vector3 GetFrontTopLeft();
-	Vector3	GetCenter();
-	Vector3 GetHalfExtents();
-	Vector3	GetSizes();
+	bool	IsInvalid() const;
+	bool	IsFinite() const;
+	Vector3	GetBackBottomLeft() const;
+	Vector3	GetBackBottomRight() const;
+	Vector3 GetBackTopRight() const;
+	Vector3 GetBackTopLeft() const;
+	Vector3 GetFrontBottomLeft() const;
+	Vector3 GetFrontBottomRight() const;
+	Vector3 GetFrontTopRight() const;
+	Vector3 GetFrontTopLeft() const;
+	Vector3	GetCenter() const;
+	Vector3 GetHalfExtents() const;
+	Vector3	GetSizes() const;
+	float	GetSurfaceArea() const;
+	AABB3	GetTransformed( const Matrix44& transform ) const;
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 	void	SetCenter( const Vector3& center );
 	void	Translate( const Vector3& translation );
 	void	GrowToContain( const Vector3& pos );
+	void	GrowToContain( const AABB3& bounds );
+	void	AddPadding( float padding );
 	bool	IsPointInside( const Vector3& pos ) const;
+	bool	IsContaining( const AABB3& bounds ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Static methods
+	static	AABB3	MakeEmpty(); // mins at +inf and maxs at -inf, ready to grow
+	static	AABB3	MakeUnion( const AABB3& a, const AABB3& b );
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
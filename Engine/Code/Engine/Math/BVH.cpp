@@ -0,0 +1,645 @@
+#include "Engine/Math/BVH.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Frustum.hpp"
+#include "Engine/Math/Disc3.hpp"
+#include "Engine/Math/Ray3.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+//-----------------------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+BVH::BVH(float fatMargin)
+	: m_fatMargin(fatMargin)
+{
+
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the user data of the proxy
+//
+void* BVH::GetUserData(int proxyId) const
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int) m_nodes.size(), "Invalid BVH proxy id");
+	return m_nodes[proxyId].userData;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the fattened bounds of the proxy
+//
+const AABB3& BVH::GetFatBounds(int proxyId) const
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int) m_nodes.size(), "Invalid BVH proxy id");
+	return m_nodes[proxyId].bounds;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the height of the tree (0 for a single leaf or an empty tree)
+//
+int BVH::GetHeight() const
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		return 0;
+	}
+
+	return m_nodes[m_root].height;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a leaf for the bounds and returns the proxy id used to move/destroy it
+//
+int BVH::CreateProxy(const AABB3& bounds, void* userData)
+{
+	int proxyId = AllocateNode();
+	BVHNode& node = m_nodes[proxyId];
+	node.bounds = bounds;
+	node.bounds.AddPadding(m_fatMargin);
+	node.userData = userData;
+	node.height = 0;
+
+	InsertLeaf(proxyId);
+	m_proxyCount++;
+
+	return proxyId;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes the leaf from the tree
+//
+void BVH::DestroyProxy(int proxyId)
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int) m_nodes.size() && m_nodes[proxyId].IsLeaf(), "Invalid BVH proxy id");
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	m_proxyCount--;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Updates the bounds of the proxy. Only reinserts when the bounds escape the fattened bounds
+//
+bool BVH::MoveProxy(int proxyId, const AABB3& bounds)
+{
+	GUARANTEE_OR_DIE(proxyId >= 0 && proxyId < (int) m_nodes.size() && m_nodes[proxyId].IsLeaf(), "Invalid BVH proxy id");
+
+	if(m_nodes[proxyId].bounds.IsContaining(bounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+
+	m_nodes[proxyId].bounds = bounds;
+	m_nodes[proxyId].bounds.AddPadding(m_fatMargin);
+
+	InsertLeaf(proxyId);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes all the proxies
+//
+void BVH::Clear()
+{
+	m_nodes.clear();
+	m_root = BVH_NULL_NODE;
+	m_freeList = BVH_NULL_NODE;
+	m_proxyCount = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the user data of all leaves overlapping the bounds
+//
+void BVH::QueryAABB(const AABB3& bounds, std::vector<void*>& out_results) const
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		return;
+	}
+
+	int stack[BVH_QUERY_STACK_SIZE];
+	int stackCount = 0;
+	stack[stackCount++] = m_root;
+
+	while(stackCount > 0)
+	{
+		const BVHNode& node = m_nodes[stack[--stackCount]];
+		if(!DoAABBsOverlap(node.bounds, bounds))
+		{
+			continue;
+		}
+
+		if(node.IsLeaf())
+		{
+			out_results.push_back(node.userData);
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(stackCount + 2 <= BVH_QUERY_STACK_SIZE, "BVH query stack overflow");
+			stack[stackCount++] = node.left;
+			stack[stackCount++] = node.right;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the user data of all leaves overlapping the sphere
+//
+void BVH::QuerySphere(const Disc3& sphere, std::vector<void*>& out_results) const
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		return;
+	}
+
+	int stack[BVH_QUERY_STACK_SIZE];
+	int stackCount = 0;
+	stack[stackCount++] = m_root;
+
+	while(stackCount > 0)
+	{
+		const BVHNode& node = m_nodes[stack[--stackCount]];
+		if(!DoesSphereOverlapAABB(sphere, node.bounds))
+		{
+			continue;
+		}
+
+		if(node.IsLeaf())
+		{
+			out_results.push_back(node.userData);
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(stackCount + 2 <= BVH_QUERY_STACK_SIZE, "BVH query stack overflow");
+			stack[stackCount++] = node.left;
+			stack[stackCount++] = node.right;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the user data of all leaves containing the point
+//
+void BVH::QueryPoint(const Vector3& point, std::vector<void*>& out_results) const
+{
+	QueryAABB(AABB3(point, point), out_results);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the user data of all leaves visible in the frustum
+//
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<void*>& out_results) const
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		return;
+	}
+
+	int stack[BVH_QUERY_STACK_SIZE];
+	int stackCount = 0;
+	stack[stackCount++] = m_root;
+
+	while(stackCount > 0)
+	{
+		int nodeIndex = stack[--stackCount];
+		const BVHNode& node = m_nodes[nodeIndex];
+
+		eCullResult result = frustum.ClassifyAABB(node.bounds);
+		if(result == CULL_OUTSIDE)
+		{
+			continue;
+		}
+
+		if(node.IsLeaf())
+		{
+			out_results.push_back(node.userData);
+		}
+		else if(result == CULL_INSIDE)
+		{
+			// Everything below is visible, no need to test the children
+			AddSubtreeLeaves(nodeIndex, out_results);
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(stackCount + 2 <= BVH_QUERY_STACK_SIZE, "BVH query stack overflow");
+			stack[stackCount++] = node.left;
+			stack[stackCount++] = node.right;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the user data of all leaves the ray passes through within the max distance (Unordered)
+//
+void BVH::Raycast(const Ray3& ray, float maxDistance, std::vector<void*>& out_results) const
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		return;
+	}
+
+	int stack[BVH_QUERY_STACK_SIZE];
+	int stackCount = 0;
+	stack[stackCount++] = m_root;
+
+	while(stackCount > 0)
+	{
+		const BVHNode& node = m_nodes[stack[--stackCount]];
+		if(!RayCheckAABB(ray, node.bounds, maxDistance))
+		{
+			continue;
+		}
+
+		if(node.IsLeaf())
+		{
+			out_results.push_back(node.userData);
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(stackCount + 2 <= BVH_QUERY_STACK_SIZE, "BVH query stack overflow");
+			stack[stackCount++] = node.left;
+			stack[stackCount++] = node.right;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs a sphere query per sphere into one flat result list. Offsets has count + 1 entries
+//
+void BVH::QuerySpheres(const Disc3* spheres, int count, std::vector<void*>& out_results, std::vector<int>& out_offsets) const
+{
+	out_results.clear();
+	out_offsets.resize(count + 1);
+
+	for(int sphereIndex = 0; sphereIndex < count; ++sphereIndex)
+	{
+		out_offsets[sphereIndex] = (int) out_results.size();
+		QuerySphere(spheres[sphereIndex], out_results);
+	}
+
+	out_offsets[count] = (int) out_results.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Runs an aabb3 query per box into one flat result list. Offsets has count + 1 entries
+//
+void BVH::QueryAABBs(const AABB3* boxes, int count, std::vector<void*>& out_results, std::vector<int>& out_offsets) const
+{
+	out_results.clear();
+	out_offsets.resize(count + 1);
+
+	for(int boxIndex = 0; boxIndex < count; ++boxIndex)
+	{
+		out_offsets[boxIndex] = (int) out_results.size();
+		QueryAABB(boxes[boxIndex], out_results);
+	}
+
+	out_offsets[count] = (int) out_results.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a node from the free list or grows the pool
+//
+int BVH::AllocateNode()
+{
+	int nodeIndex;
+	if(m_freeList != BVH_NULL_NODE)
+	{
+		nodeIndex = m_freeList;
+		m_freeList = m_nodes[nodeIndex].next;
+	}
+	else
+	{
+		nodeIndex = (int) m_nodes.size();
+		m_nodes.emplace_back();
+	}
+
+	BVHNode& node = m_nodes[nodeIndex];
+	node.parent = BVH_NULL_NODE;
+	node.left = BVH_NULL_NODE;
+	node.right = BVH_NULL_NODE;
+	node.height = 0;
+	node.userData = nullptr;
+
+	return nodeIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the node to the free list
+//
+void BVH::FreeNode(int nodeIndex)
+{
+	BVHNode& node = m_nodes[nodeIndex];
+	node.next = m_freeList;
+	node.height = -1;
+	node.userData = nullptr;
+	m_freeList = nodeIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Inserts the leaf next to the sibling that increases the total surface area the least
+//
+void BVH::InsertLeaf(int leafIndex)
+{
+	if(m_root == BVH_NULL_NODE)
+	{
+		m_root = leafIndex;
+		m_nodes[m_root].parent = BVH_NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling by walking down the cheapest side
+	AABB3 leafBounds = m_nodes[leafIndex].bounds;
+	int index = m_root;
+	while(!m_nodes[index].IsLeaf())
+	{
+		const BVHNode& node = m_nodes[index];
+		int left = node.left;
+		int right = node.right;
+
+		float area = node.bounds.GetSurfaceArea();
+		float combinedArea = AABB3::MakeUnion(node.bounds, leafBounds).GetSurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		float costLeft = AABB3::MakeUnion(leafBounds, m_nodes[left].bounds).GetSurfaceArea() + inheritanceCost;
+		if(!m_nodes[left].IsLeaf())
+		{
+			costLeft -= m_nodes[left].bounds.GetSurfaceArea();
+		}
+
+		float costRight = AABB3::MakeUnion(leafBounds, m_nodes[right].bounds).GetSurfaceArea() + inheritanceCost;
+		if(!m_nodes[right].IsLeaf())
+		{
+			costRight -= m_nodes[right].bounds.GetSurfaceArea();
+		}
+
+		if(cost < costLeft && cost < costRight)
+		{
+			break;
+		}
+
+		index = (costLeft < costRight) ? left : right;
+	}
+
+	// Create a new parent for the sibling and the leaf
+	int sibling = index;
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+
+	BVHNode& parentNode = m_nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.bounds = AABB3::MakeUnion(leafBounds, m_nodes[sibling].bounds);
+	parentNode.height = m_nodes[sibling].height + 1;
+	parentNode.left = sibling;
+	parentNode.right = leafIndex;
+
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leafIndex].parent = newParent;
+
+	if(oldParent != BVH_NULL_NODE)
+	{
+		if(m_nodes[oldParent].left == sibling)
+		{
+			m_nodes[oldParent].left = newParent;
+		}
+		else
+		{
+			m_nodes[oldParent].right = newParent;
+		}
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	RefitAncestors(m_nodes[leafIndex].parent);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes the leaf and collapses its parent into the sibling
+//
+void BVH::RemoveLeaf(int leafIndex)
+{
+	if(leafIndex == m_root)
+	{
+		m_root = BVH_NULL_NODE;
+		return;
+	}
+
+	int parent = m_nodes[leafIndex].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = (m_nodes[parent].left == leafIndex) ? m_nodes[parent].right : m_nodes[parent].left;
+
+	if(grandParent != BVH_NULL_NODE)
+	{
+		if(m_nodes[grandParent].left == parent)
+		{
+			m_nodes[grandParent].left = sibling;
+		}
+		else
+		{
+			m_nodes[grandParent].right = sibling;
+		}
+
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		RefitAncestors(grandParent);
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = BVH_NULL_NODE;
+		FreeNode(parent);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Walks up from the node rebalancing and recomputing bounds and heights
+//
+void BVH::RefitAncestors(int nodeIndex)
+{
+	int index = nodeIndex;
+	while(index != BVH_NULL_NODE)
+	{
+		index = Balance(index);
+
+		BVHNode& node = m_nodes[index];
+		const BVHNode& left = m_nodes[node.left];
+		const BVHNode& right = m_nodes[node.right];
+
+		node.height = 1 + Max(left.height, right.height);
+		node.bounds = AABB3::MakeUnion(left.bounds, right.bounds);
+
+		index = node.parent;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Performs a left or right rotation if the node A is imbalanced. Returns the new subtree root
+//
+int BVH::Balance(int iA)
+{
+	BVHNode& A = m_nodes[iA];
+	if(A.IsLeaf() || A.height < 2)
+	{
+		return iA;
+	}
+
+	int iB = A.left;
+	int iC = A.right;
+	BVHNode& B = m_nodes[iB];
+	BVHNode& C = m_nodes[iC];
+
+	int balance = C.height - B.height;
+
+	// Rotate C up
+	if(balance > 1)
+	{
+		int iF = C.left;
+		int iG = C.right;
+		BVHNode& F = m_nodes[iF];
+		BVHNode& G = m_nodes[iG];
+
+		// Swap A and C
+		C.left = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if(C.parent != BVH_NULL_NODE)
+		{
+			if(m_nodes[C.parent].left == iA)
+			{
+				m_nodes[C.parent].left = iC;
+			}
+			else
+			{
+				m_nodes[C.parent].right = iC;
+			}
+		}
+		else
+		{
+			m_root = iC;
+		}
+
+		// Rotate
+		if(F.height > G.height)
+		{
+			C.right = iF;
+			A.right = iG;
+			G.parent = iA;
+			A.bounds = AABB3::MakeUnion(B.bounds, G.bounds);
+			C.bounds = AABB3::MakeUnion(A.bounds, F.bounds);
+
+			A.height = 1 + Max(B.height, G.height);
+			C.height = 1 + Max(A.height, F.height);
+		}
+		else
+		{
+			C.right = iG;
+			A.right = iF;
+			F.parent = iA;
+			A.bounds = AABB3::MakeUnion(B.bounds, F.bounds);
+			C.bounds = AABB3::MakeUnion(A.bounds, G.bounds);
+
+			A.height = 1 + Max(B.height, F.height);
+			C.height = 1 + Max(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up
+	if(balance < -1)
+	{
+		int iD = B.left;
+		int iE = B.right;
+		BVHNode& D = m_nodes[iD];
+		BVHNode& E = m_nodes[iE];
+
+		// Swap A and B
+		B.left = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if(B.parent != BVH_NULL_NODE)
+		{
+			if(m_nodes[B.parent].left == iA)
+			{
+				m_nodes[B.parent].left = iB;
+			}
+			else
+			{
+				m_nodes[B.parent].right = iB;
+			}
+		}
+		else
+		{
+			m_root = iB;
+		}
+
+		// Rotate
+		if(D.height > E.height)
+		{
+			B.right = iD;
+			A.left = iE;
+			E.parent = iA;
+			A.bounds = AABB3::MakeUnion(C.bounds, E.bounds);
+			B.bounds = AABB3::MakeUnion(A.bounds, D.bounds);
+
+			A.height = 1 + Max(C.height, E.height);
+			B.height = 1 + Max(A.height, D.height);
+		}
+		else
+		{
+			B.right = iE;
+			A.left = iD;
+			D.parent = iA;
+			A.bounds = AABB3::MakeUnion(C.bounds, D.bounds);
+			B.bounds = AABB3::MakeUnion(A.bounds, E.bounds);
+
+			A.height = 1 + Max(C.height, D.height);
+			B.height = 1 + Max(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends every leaf below the node without any tests
+//
+void BVH::AddSubtreeLeaves(int nodeIndex, std::vector<void*>& out_results) const
+{
+	int stack[BVH_QUERY_STACK_SIZE];
+	int stackCount = 0;
+	stack[stackCount++] = nodeIndex;
+
+	while(stackCount > 0)
+	{
+		const BVHNode& node = m_nodes[stack[--stackCount]];
+		if(node.IsLeaf())
+		{
+			out_results.push_back(node.userData);
+		}
+		else
+		{
+			GUARANTEE_OR_DIE(stackCount + 2 <= BVH_QUERY_STACK_SIZE, "BVH query stack overflow");
+			stack[stackCount++] = node.left;
+			stack[stackCount++] = node.right;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Disc3;
+class Ray3;
+class Frustum;
+
+//-----------------------------------------------------------------------------------------------
+constexpr int BVH_NULL_NODE = -1;
+constexpr int BVH_QUERY_STACK_SIZE = 256;
+
+//-----------------------------------------------------------------------------------------------
+struct BVHNode
+{
+	bool	IsLeaf() const { return left == BVH_NULL_NODE; }
+
+	AABB3	bounds;						// Fattened bounds for leaves, union of the children otherwise
+	void*	userData	= nullptr;
+	union
+	{
+		int	parent;
+		int	next;					// Free list link when the node is not in use
+	};
+	int		left		= BVH_NULL_NODE;
+	int		right		= BVH_NULL_NODE;
+	int		height		= -1;			// Leaf is 0, free node is -1
+};
+
+//-----------------------------------------------------------------------------------------------
+// Dynamic aabb3 tree. Leaves are proxies that own fattened bounds so small moves don't touch the tree
+//
+class BVH
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	explicit BVH( float fatMargin = 0.1f );
+	~BVH(){}
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	void*			GetUserData( int proxyId ) const;
+	const AABB3&	GetFatBounds( int proxyId ) const;
+	int				GetProxyCount() const { return m_proxyCount; }
+	int				GetHeight() const;
+	float			GetFatMargin() const { return m_fatMargin; }
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	int				CreateProxy( const AABB3& bounds, void* userData );
+	void			DestroyProxy( int proxyId );
+	bool			MoveProxy( int proxyId, const AABB3& bounds ); // Returns true if it had to be reinserted
+	void			Clear();
+
+	// Queries append the user data of every hit leaf to out_results
+	void			QueryAABB( const AABB3& bounds, std::vector<void*>& out_results ) const;
+	void			QuerySphere( const Disc3& sphere, std::vector<void*>& out_results ) const;
+	void			QueryPoint( const Vector3& point, std::vector<void*>& out_results ) const;
+	void			QueryFrustum( const Frustum& frustum, std::vector<void*>& out_results ) const;
+	void			Raycast( const Ray3& ray, float maxDistance, std::vector<void*>& out_results ) const;
+
+	// Batch queries write flat results, hits for query i are out_results[out_offsets[i]] to out_results[out_offsets[i+1]]
+	void			QuerySpheres( const Disc3* spheres, int count, std::vector<void*>& out_results, std::vector<int>& out_offsets ) const;
+	void			QueryAABBs( const AABB3* boxes, int count, std::vector<void*>& out_results, std::vector<int>& out_offsets ) const;
+
+private:
+	int				AllocateNode();
+	void			FreeNode( int nodeIndex );
+	void			InsertLeaf( int leafIndex );
+	void			RemoveLeaf( int leafIndex );
+	int				Balance( int nodeIndex );
+	void			RefitAncestors( int nodeIndex );
+	void			AddSubtreeLeaves( int nodeIndex, std::vector<void*>& out_results ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::vector<BVHNode>	m_nodes;
+	int						m_root			= BVH_NULL_NODE;
+	int						m_freeList		= BVH_NULL_NODE;
+	int						m_proxyCount	= 0;
+	float					m_fatMargin;
+};
+
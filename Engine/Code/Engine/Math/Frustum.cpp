@@ -0,0 +1,112 @@
+#include "Engine/Math/Frustum.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Disc3.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <math.h>
+//-----------------------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+Frustum::Frustum(const Matrix44& viewProjection)
+{
+	SetFromViewProjection(viewProjection);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Extracts the planes from the rows of the view projection (Clip z is -1 to 1)
+//
+void Frustum::SetFromViewProjection(const Matrix44& vp)
+{
+	// Rows of the matrix since the data is basis major
+	Vector3 row0 = Vector3(vp.Ix, vp.Jx, vp.Kx);
+	Vector3 row1 = Vector3(vp.Iy, vp.Jy, vp.Ky);
+	Vector3 row2 = Vector3(vp.Iz, vp.Jz, vp.Kz);
+	Vector3 row3 = Vector3(vp.Iw, vp.Jw, vp.Kw);
+
+	// Plane stores dot(n,p) - distance, so the distance is the negated w component
+	m_planes[FRUSTUM_LEFT]		= Plane(row3 + row0, -(vp.Tw + vp.Tx));
+	m_planes[FRUSTUM_RIGHT]		= Plane(row3 - row0, -(vp.Tw - vp.Tx));
+	m_planes[FRUSTUM_BOTTOM]	= Plane(row3 + row1, -(vp.Tw + vp.Ty));
+	m_planes[FRUSTUM_TOP]		= Plane(row3 - row1, -(vp.Tw - vp.Ty));
+	m_planes[FRUSTUM_NEAR]		= Plane(row3 + row2, -(vp.Tw + vp.Tz));
+	m_planes[FRUSTUM_FAR]		= Plane(row3 - row2, -(vp.Tw - vp.Tz));
+
+	for(int planeIndex = 0; planeIndex < NUM_FRUSTUM_PLANES; ++planeIndex)
+	{
+		m_planes[planeIndex].Normalize();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the point is inside all the planes
+//
+bool Frustum::IsPointInside(const Vector3& point) const
+{
+	for(int planeIndex = 0; planeIndex < NUM_FRUSTUM_PLANES; ++planeIndex)
+	{
+		if(m_planes[planeIndex].GetDistanceFromPlane(point) < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the sphere is not completely behind any plane
+//
+bool Frustum::IsSphereVisible(const Disc3& sphere) const
+{
+	for(int planeIndex = 0; planeIndex < NUM_FRUSTUM_PLANES; ++planeIndex)
+	{
+		if(m_planes[planeIndex].GetDistanceFromPlane(sphere.center) < -sphere.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the aabb3 is not completely behind any plane (Conservative at the corners)
+//
+bool Frustum::IsAABBVisible(const AABB3& bounds) const
+{
+	return ClassifyAABB(bounds) != CULL_OUTSIDE;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Classifies the aabb3 using the projected extent on each plane normal
+//
+eCullResult Frustum::ClassifyAABB(const AABB3& bounds) const
+{
+	Vector3 center = bounds.GetCenter();
+	Vector3 halfExtents = bounds.GetHalfExtents();
+	eCullResult result = CULL_INSIDE;
+
+	for(int planeIndex = 0; planeIndex < NUM_FRUSTUM_PLANES; ++planeIndex)
+	{
+		const Plane& plane = m_planes[planeIndex];
+		float radius = fabsf(plane.normal.x) * halfExtents.x + fabsf(plane.normal.y) * halfExtents.y + fabsf(plane.normal.z) * halfExtents.z;
+		float distance = plane.GetDistanceFromPlane(center);
+
+		if(distance < -radius)
+		{
+			return CULL_OUTSIDE;
+		}
+
+		if(distance < radius)
+		{
+			result = CULL_INTERSECTING;
+		}
+	}
+
+	return result;
+}
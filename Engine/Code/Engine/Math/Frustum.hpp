@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Math/Plane.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Matrix44;
+class AABB3;
+class Disc3;
+
+//-----------------------------------------------------------------------------------------------
+enum eFrustumPlane
+{
+	FRUSTUM_LEFT = 0,
+	FRUSTUM_RIGHT,
+	FRUSTUM_BOTTOM,
+	FRUSTUM_TOP,
+	FRUSTUM_NEAR,
+	FRUSTUM_FAR,
+	NUM_FRUSTUM_PLANES
+};
+
+//-----------------------------------------------------------------------------------------------
+enum eCullResult
+{
+	CULL_OUTSIDE = 0,
+	CULL_INTERSECTING,
+	CULL_INSIDE
+};
+
+//-----------------------------------------------------------------------------------------------
+class Frustum
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	Frustum(){}
+	explicit Frustum( const Matrix44& viewProjection );
+	~Frustum(){}
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	const Plane&	GetPlane( eFrustumPlane plane ) const { return m_planes[plane]; }
+	void			SetFromViewProjection( const Matrix44& viewProjection ); // Planes point inwards
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	bool			IsPointInside( const Vector3& point ) const;
+	bool			IsSphereVisible( const Disc3& sphere ) const;
+	bool			IsAABBVisible( const AABB3& bounds ) const;
+	eCullResult		ClassifyAABB( const AABB3& bounds ) const; // Inside lets tree queries skip the child tests
+	
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	Plane			m_planes[NUM_FRUSTUM_PLANES];
+};
+
@@ -15,6 +15,7 @@
 #include "Engine/Math/Ray3.hpp"
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/Disc3.hpp"
+#include "Engine/Math/AABB3.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Returns the min between the values
@@ -425,6 +426,76 @@ bool DoAABBsOverlap(const AABB2& a, const AABB2& b)
 		return false;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Checks if the aabb3s overlap (Touching counts as overlapping)
+//
+bool DoAABBsOverlap(const AABB3& a, const AABB3& b)
+{
+	return	a.mins.x <= b.maxs.x && a.maxs.x >= b.mins.x &&
+			a.mins.y <= b.maxs.y && a.maxs.y >= b.mins.y &&
+			a.mins.z <= b.maxs.z && a.maxs.z >= b.mins.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Checks if the sphere overlaps the aabb3 using the closest point on the box
+//
+bool DoesSphereOverlapAABB(const Disc3& sphere, const AABB3& box)
+{
+	Vector3 closestPoint = Min(Max(sphere.center, box.mins), box.maxs);
+	return GetDistanceSquared(closestPoint, sphere.center) <= (sphere.radius * sphere.radius);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Slab test against the aabb3. Ray dir is expected to be normalized so the hit distance is in world units
+//
+bool RayCheckAABB(const Ray3& ray, const AABB3& box, float maxDistance, float* out_hitDistance /*= nullptr*/)
+{
+	float tMin = 0.f;
+	float tMax = maxDistance;
+
+	const float* start	= &ray.start.x;
+	const float* dir	= &ray.dir.x;
+	const float* mins	= &box.mins.x;
+	const float* maxs	= &box.maxs.x;
+
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		if(fabsf(dir[axis]) < EPSILON)
+		{
+			// Parallel to the slab, must already be inside it
+			if(start[axis] < mins[axis] || start[axis] > maxs[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float invDir = 1.f / dir[axis];
+		float t0 = (mins[axis] - start[axis]) * invDir;
+		float t1 = (maxs[axis] - start[axis]) * invDir;
+		if(t0 > t1)
+		{
+			float temp = t0;
+			t0 = t1;
+			t1 = temp;
+		}
+
+		tMin = Max(tMin, t0);
+		tMax = Min(tMax, t1);
+		if(tMin > tMax)
+		{
+			return false;
+		}
+	}
+
+	if(out_hitDistance != nullptr)
+	{
+		*out_hitDistance = tMin;
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns true if the line segment intersects with the plane
 //
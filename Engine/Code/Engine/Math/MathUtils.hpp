@@ -13,6 +13,7 @@ struct RaycastHit3D;
 class Ray3;
 class Matrix44;
 class Disc3;
+class AABB3;
 
 typedef unsigned int uint32_t;
 
@@ -78,6 +79,9 @@ bool			DoDiscsOverlap( const Disc2& a, const  Disc2& b);
 bool			DoDiscsOverlap( const Vector2& aCenter, float aRadius, const Vector2& bCenter, float bRadius);
 bool			DoSpheresOverlap( const Disc3& a, const Disc3& b );
 bool			DoAABBsOverlap(const AABB2& a, const AABB2& b) ;
+bool			DoAABBsOverlap( const AABB3& a, const AABB3& b );
+bool			DoesSphereOverlapAABB( const Disc3& sphere, const AABB3& box );
+bool			RayCheckAABB( const Ray3& ray, const AABB3& box, float maxDistance, float* out_hitDistance = nullptr );
 bool			DoesSegmentIntersectPlane( const Segment3& segment, const Plane& plane );
 RaycastHit3D	RayCheckPlane( const Ray3& ray, const Plane& plane );
 
@@ -2,11 +2,107 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/Vector4.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/SIMD.hpp"
+#include <string.h>
 
 //-----------------------------------------------------------------------------------------------
 // Static globals
 const Matrix44 Matrix44::IDENTITY;
 
+#if defined(ENGINE_SIMD_ENABLED)
+//-----------------------------------------------------------------------------------------------
+// Column major 4x4 multiply, out = first * second. Every column of first is loaded before
+// anything is stored and second is read one column ahead of the store, so out may alias either
+//
+static inline void MultiplyColumnsSIMD(const float* first, const float* second, float* out)
+{
+	simd4f i = SIMDLoad(first);
+	simd4f j = SIMDLoad(first + 4);
+	simd4f k = SIMDLoad(first + 8);
+	simd4f t = SIMDLoad(first + 12);
+
+	for(int column = 0; column < 4; ++column)
+	{
+		simd4f c = SIMDLoad(second + column * 4);
+		simd4f result = SIMDMul(i, SIMDSplatLane<0>(c));
+		result = SIMDMulAdd(j, SIMDSplatLane<1>(c), result);
+		result = SIMDMulAdd(k, SIMDSplatLane<2>(c), result);
+		result = SIMDMulAdd(t, SIMDSplatLane<3>(c), result);
+		SIMDStore(out + column * 4, result);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// i * x + j * y + k * z + t, w of the result is garbage for directions
+//
+static inline simd4f TransformSIMD(simd4f i, simd4f j, simd4f k, simd4f t, float x, float y, float z)
+{
+	simd4f result = SIMDMulAdd(i, SIMDSplat(x), t);
+	result = SIMDMulAdd(j, SIMDSplat(y), result);
+	return SIMDMulAdd(k, SIMDSplat(z), result);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stores xyz of the register without touching the float after the vector
+//
+static inline Vector3 ToVector3(simd4f v)
+{
+	float values[4];
+	SIMDStore(values, v);
+	return Vector3(values[0], values[1], values[2]);
+}
+#endif
+
+#if defined(ENGINE_SIMD_SSE)
+//-----------------------------------------------------------------------------------------------
+// 2x2 row major helpers for the block inverse, A# is the adjugate of A. A * B
+//
+static inline simd4f Mat2Mul(simd4f a, simd4f b)
+{
+	return SIMDAdd(SIMDMul(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		SIMDMul(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//-----------------------------------------------------------------------------------------------
+// A# * B
+//
+static inline simd4f Mat2AdjMul(simd4f a, simd4f b)
+{
+	return SIMDSub(SIMDMul(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		SIMDMul(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//-----------------------------------------------------------------------------------------------
+// A * B#
+//
+static inline simd4f Mat2MulAdj(simd4f a, simd4f b)
+{
+	return SIMDSub(SIMDMul(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		SIMDMul(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
+
+#if defined(ENGINE_SIMD_AVX2)
+//-----------------------------------------------------------------------------------------------
+// Two result columns per iteration. The first matrix's columns are duplicated into both halves
+// and each half broadcasts the entries of its own column of second
+//
+static inline void MultiplyColumnsAVX2(const __m256& i, const __m256& j, const __m256& k, const __m256& t, const float* second, float* out)
+{
+	for(int column = 0; column < 4; column += 2)
+	{
+		__m256 c = _mm256_loadu_ps(second + column * 4);
+		__m256 result = _mm256_mul_ps(i, _mm256_shuffle_ps(c, c, 0x00));
+		result = _mm256_fmadd_ps(j, _mm256_shuffle_ps(c, c, 0x55), result);
+		result = _mm256_fmadd_ps(k, _mm256_shuffle_ps(c, c, 0xAA), result);
+		result = _mm256_fmadd_ps(t, _mm256_shuffle_ps(c, c, 0xFF), result);
+		_mm256_storeu_ps(out + column * 4, result);
+	}
+}
+#endif
+
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
@@ -162,11 +258,18 @@ Vector2 Matrix44::TransformDisplacement2D(const Vector2& displacement2D)
 //
 Vector3 Matrix44::TransformDirection3D(const Vector3& direction3D) const
 {
+#if defined(ENGINE_SIMD_ENABLED)
+	simd4f result = SIMDMul(SIMDLoad(data), SIMDSplat(direction3D.x));
+	result = SIMDMulAdd(SIMDLoad(data + 4), SIMDSplat(direction3D.y), result);
+	result = SIMDMulAdd(SIMDLoad(data + 8), SIMDSplat(direction3D.z), result);
+	return ToVector3(result);
+#else
 	Vector3 newDisplacement3D;
 	newDisplacement3D.x = (Ix * direction3D.x) + (Jx * direction3D.y) + (Kx * direction3D.z);
 	newDisplacement3D.y = (Iy * direction3D.x) + (Jy * direction3D.y) + (Ky * direction3D.z);
 	newDisplacement3D.z = (Iz * direction3D.x) + (Jz * direction3D.y) + (Kz * direction3D.z);
 	return newDisplacement3D;
+#endif
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -174,11 +277,23 @@ Vector3 Matrix44::TransformDirection3D(const Vector3& direction3D) const
 //
 Vector3 Matrix44::TransformPosition3D(const Vector3& position3D) const
 {
+#if defined(ENGINE_SIMD_ENABLED)
+	return ToVector3(TransformSIMD(SIMDLoad(data), SIMDLoad(data + 4), SIMDLoad(data + 8), SIMDLoad(data + 12), position3D.x, position3D.y, position3D.z));
+#else
 	Vector3 newPosition3D;
 	newPosition3D.x = (Ix * position3D.x) + (Jx * position3D.y) + (Kx * position3D.z) + Tx;
 	newPosition3D.y = (Iy * position3D.x) + (Jy * position3D.y) + (Ky * position3D.z) + Ty;
 	newPosition3D.z = (Iz * position3D.x) + (Jz * position3D.y) + (Kz * position3D.z) + Tz;
 	return newPosition3D;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the lengths of the basis vectors
+//
+Vector3 Matrix44::GetScale() const
+{
+	return Vector3(Vector3(Ix, Iy, Iz).GetLength(), Vector3(Jx, Jy, Jz).GetLength(), Vector3(Kx, Ky, Kz).GetLength());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -342,8 +457,7 @@ void Matrix44::SetTranslation(const Vector3& translation)
 //
 void Matrix44::Append( const Matrix44& matrixToAppend )
 {
-	Matrix44 oldMatrix = *this;
-	*this = Matrix44::MatrixMultiply( oldMatrix, matrixToAppend );
+	Matrix44::MatrixMultiply( *this, matrixToAppend, *this );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -547,6 +661,33 @@ Matrix44 Matrix44::MakeScale3D(const Vector3& scale)
 	return MakeScale3D(scale.x, scale.y, scale.z);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Composes translation * rotation * scale directly, the scale just stretches the rotated basis
+//
+Matrix44 Matrix44::MakeTRS(const Vector3& translation, const Vector3& eulerDegrees, const Vector3& scale)
+{
+	Matrix44 result = MakeRotation3D(eulerDegrees);
+	result.Ix *= scale.x;	result.Iy *= scale.x;	result.Iz *= scale.x;
+	result.Jx *= scale.y;	result.Jy *= scale.y;	result.Jz *= scale.y;
+	result.Kx *= scale.z;	result.Ky *= scale.z;	result.Kz *= scale.z;
+	result.SetTranslation(translation);
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Composes translation * rotation * scale directly from a quaternion
+//
+Matrix44 Matrix44::MakeTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	Vector3 right;
+	Vector3 up;
+	Vector3 forward;
+	rotation.GetBasis(right, up, forward);
+
+	return Matrix44(right * scale.x, up * scale.y, forward * scale.z, translation);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns a scale matrix
 //
@@ -640,6 +781,25 @@ Matrix44 Matrix44::MakePerspectiveMatrix(float fovDegrees, float aspect, float z
 Matrix44 Matrix44::MatrixMultiply(const Matrix44& first, const Matrix44& second)
 {
 	Matrix44 result;
+	MatrixMultiply(first, second, result);
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies into out_result, which is allowed to be either of the inputs
+//
+STATIC void Matrix44::MatrixMultiply(const Matrix44& first, const Matrix44& second, Matrix44& out_result)
+{
+#if defined(ENGINE_SIMD_AVX2)
+	__m256 i = _mm256_broadcast_ps((const __m128*) first.data);
+	__m256 j = _mm256_broadcast_ps((const __m128*) (first.data + 4));
+	__m256 k = _mm256_broadcast_ps((const __m128*) (first.data + 8));
+	__m256 t = _mm256_broadcast_ps((const __m128*) (first.data + 12));
+	MultiplyColumnsAVX2(i, j, k, t, second.data, out_result.data);
+#elif defined(ENGINE_SIMD_ENABLED)
+	MultiplyColumnsSIMD(first.data, second.data, out_result.data);
+#else
+	Matrix44 result;
 
 	result.Ix = (first.Ix * second.Ix) + (first.Jx * second.Iy) + (first.Kx * second.Iz) + (first.Tx * second.Iw);
 	result.Iy = (first.Iy * second.Ix) + (first.Jy * second.Iy) + (first.Ky * second.Iz) + (first.Ty * second.Iw);
@@ -661,7 +821,8 @@ Matrix44 Matrix44::MatrixMultiply(const Matrix44& first, const Matrix44& second)
 	result.Tz = (first.Iz * second.Tx) + (first.Jz * second.Ty) + (first.Kz * second.Tz) + (first.Tz * second.Tw);
 	result.Tw = (first.Iw * second.Tx) + (first.Jw * second.Ty) + (first.Kw * second.Tz) + (first.Tw * second.Tw);
 
-	return result;
+	out_result = result;
+#endif
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -717,6 +878,54 @@ Matrix44 Matrix44::InvertFast(const Matrix44& mat)
 //
 Matrix44 Matrix44::Invert(const Matrix44& mat)
 {
+#if defined(ENGINE_SIMD_SSE)
+	// Block inverse over the four 2x2 sub matrices. The math is written for rows, inverting
+	// the transpose and storing it back as columns gives the same answer
+	simd4f c0 = SIMDLoad(mat.data);
+	simd4f c1 = SIMDLoad(mat.data + 4);
+	simd4f c2 = SIMDLoad(mat.data + 8);
+	simd4f c3 = SIMDLoad(mat.data + 12);
+
+	simd4f A = _mm_movelh_ps(c0, c1);
+	simd4f B = _mm_movehl_ps(c1, c0);
+	simd4f C = _mm_movelh_ps(c2, c3);
+	simd4f D = _mm_movehl_ps(c3, c2);
+
+	// (|A| |B| |C| |D|)
+	simd4f detSub = SIMDSub(
+		SIMDMul(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+		SIMDMul(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+	simd4f detA = SIMDSplatLane<0>(detSub);
+	simd4f detB = SIMDSplatLane<1>(detSub);
+	simd4f detC = SIMDSplatLane<2>(detSub);
+	simd4f detD = SIMDSplatLane<3>(detSub);
+
+	simd4f D_C = Mat2AdjMul(D, C);
+	simd4f A_B = Mat2AdjMul(A, B);
+	simd4f X_ = SIMDSub(SIMDMul(detD, A), Mat2Mul(B, D_C));
+	simd4f W_ = SIMDSub(SIMDMul(detA, D), Mat2Mul(C, A_B));
+	simd4f Y_ = SIMDSub(SIMDMul(detB, C), Mat2MulAdj(D, A_B));
+	simd4f Z_ = SIMDSub(SIMDMul(detC, B), Mat2MulAdj(A, D_C));
+
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	simd4f trace = SIMDMul(A_B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = SIMDAdd(trace, _mm_movehl_ps(trace, trace));
+	trace = SIMDAdd(trace, SIMDSplatLane<1>(trace));
+	simd4f detM = SIMDSub(SIMDAdd(SIMDMul(detA, detD), SIMDMul(detB, detC)), SIMDSplatLane<0>(trace));
+
+	simd4f rDetM = _mm_div_ps(SIMDSet(1.f, -1.f, -1.f, 1.f), detM);
+	X_ = SIMDMul(X_, rDetM);
+	Y_ = SIMDMul(Y_, rDetM);
+	Z_ = SIMDMul(Z_, rDetM);
+	W_ = SIMDMul(W_, rDetM);
+
+	Matrix44 inverseMatrix;
+	SIMDStore(inverseMatrix.data, _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(1, 3, 1, 3)));
+	SIMDStore(inverseMatrix.data + 4, _mm_shuffle_ps(X_, Y_, _MM_SHUFFLE(0, 2, 0, 2)));
+	SIMDStore(inverseMatrix.data + 8, _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(1, 3, 1, 3)));
+	SIMDStore(inverseMatrix.data + 12, _mm_shuffle_ps(Z_, W_, _MM_SHUFFLE(0, 2, 0, 2)));
+	return inverseMatrix;
+#else
 	double inv[16];
 	double det;
 	double m[16];
@@ -847,6 +1056,123 @@ Matrix44 Matrix44::Invert(const Matrix44& mat)
 	}
 
 	return inverseMatrix;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Inverse for matrices with a (0,0,0,1) bottom row. Unlike InvertFast the 3x3 part may be
+// scaled or sheared, its inverse is the cross products of the basis over the determinant
+//
+STATIC Matrix44 Matrix44::InvertAffine(const Matrix44& mat)
+{
+	Vector3 i(mat.Ix, mat.Iy, mat.Iz);
+	Vector3 j(mat.Jx, mat.Jy, mat.Jz);
+	Vector3 k(mat.Kx, mat.Ky, mat.Kz);
+
+	// Rows of the inverse
+	Vector3 row0 = CrossProduct(j, k);
+	Vector3 row1 = CrossProduct(k, i);
+	Vector3 row2 = CrossProduct(i, j);
+	float inverseDet = 1.f / DotProduct(i, row0);
+	row0 *= inverseDet;
+	row1 *= inverseDet;
+	row2 *= inverseDet;
+
+	Vector3 translation(mat.Tx, mat.Ty, mat.Tz);
+
+	Matrix44 inverseMatrix;
+	inverseMatrix.Ix = row0.x;	inverseMatrix.Jx = row0.y;	inverseMatrix.Kx = row0.z;
+	inverseMatrix.Iy = row1.x;	inverseMatrix.Jy = row1.y;	inverseMatrix.Ky = row1.z;
+	inverseMatrix.Iz = row2.x;	inverseMatrix.Jz = row2.y;	inverseMatrix.Kz = row2.z;
+	inverseMatrix.Tx = -DotProduct(row0, translation);
+	inverseMatrix.Ty = -DotProduct(row1, translation);
+	inverseMatrix.Tz = -DotProduct(row2, translation);
+	return inverseMatrix;
+}
+
+//-----------------------------------------------------------------------------------------------
+// out_positions[i] = mat * positions[i] with w = 1, the arrays may be the same
+//
+STATIC void Matrix44::TransformPositions3D(const Matrix44& mat, const Vector3* positions, Vector3* out_positions, int count)
+{
+#if defined(ENGINE_SIMD_ENABLED)
+	simd4f i = SIMDLoad(mat.data);
+	simd4f j = SIMDLoad(mat.data + 4);
+	simd4f k = SIMDLoad(mat.data + 8);
+	simd4f t = SIMDLoad(mat.data + 12);
+	for(int index = 0; index < count; ++index)
+	{
+		const Vector3& position = positions[index];
+		out_positions[index] = ToVector3(TransformSIMD(i, j, k, t, position.x, position.y, position.z));
+	}
+#else
+	for(int index = 0; index < count; ++index)
+	{
+		out_positions[index] = mat.TransformPosition3D(positions[index]);
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// out_results[i] = first * seconds[i], e.g. the view projection times every model matrix
+//
+STATIC void Matrix44::MultiplyBatch(const Matrix44& first, const Matrix44* seconds, Matrix44* out_results, int count)
+{
+#if defined(ENGINE_SIMD_AVX2)
+	__m256 i = _mm256_broadcast_ps((const __m128*) first.data);
+	__m256 j = _mm256_broadcast_ps((const __m128*) (first.data + 4));
+	__m256 k = _mm256_broadcast_ps((const __m128*) (first.data + 8));
+	__m256 t = _mm256_broadcast_ps((const __m128*) (first.data + 12));
+	for(int index = 0; index < count; ++index)
+	{
+		MultiplyColumnsAVX2(i, j, k, t, seconds[index].data, out_results[index].data);
+	}
+#else
+	for(int index = 0; index < count; ++index)
+	{
+		MatrixMultiply(first, seconds[index], out_results[index]);
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Same as AABB3::GetTransformed for every box, the arrays may be the same
+//
+STATIC void Matrix44::TransformAABBs(const Matrix44& mat, const AABB3* boxes, AABB3* out_boxes, int count)
+{
+#if defined(ENGINE_SIMD_ENABLED)
+	simd4f i = SIMDLoad(mat.data);
+	simd4f j = SIMDLoad(mat.data + 4);
+	simd4f k = SIMDLoad(mat.data + 8);
+	simd4f t = SIMDLoad(mat.data + 12);
+	simd4f absI = SIMDAbs(i);
+	simd4f absJ = SIMDAbs(j);
+	simd4f absK = SIMDAbs(k);
+	simd4f half = SIMDSplat(0.5f);
+	for(int index = 0; index < count; ++index)
+	{
+		const AABB3& box = boxes[index];
+		simd4f mins = SIMDSet(box.mins.x, box.mins.y, box.mins.z, 0.f);
+		simd4f maxs = SIMDSet(box.maxs.x, box.maxs.y, box.maxs.z, 0.f);
+		simd4f center = SIMDMul(SIMDAdd(mins, maxs), half);
+		simd4f extents = SIMDMul(SIMDSub(maxs, mins), half);
+
+		// Center goes through the full transform, extents through the absolute basis
+		simd4f newCenter = SIMDMulAdd(i, SIMDSplatLane<0>(center), t);
+		newCenter = SIMDMulAdd(j, SIMDSplatLane<1>(center), newCenter);
+		newCenter = SIMDMulAdd(k, SIMDSplatLane<2>(center), newCenter);
+		simd4f newExtents = SIMDMul(absI, SIMDSplatLane<0>(extents));
+		newExtents = SIMDMulAdd(absJ, SIMDSplatLane<1>(extents), newExtents);
+		newExtents = SIMDMulAdd(absK, SIMDSplatLane<2>(extents), newExtents);
+
+		out_boxes[index] = AABB3(ToVector3(SIMDSub(newCenter, newExtents)), ToVector3(SIMDAdd(newCenter, newExtents)));
+	}
+#else
+	for(int index = 0; index < count; ++index)
+	{
+		out_boxes[index] = boxes[index].GetTransformed(mat);
+	}
+#endif
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -854,11 +1180,7 @@ Matrix44 Matrix44::Invert(const Matrix44& mat)
 //
 void Matrix44::operator=(const Matrix44& copyFrom)
 {
-	float values[] = {copyFrom.Ix, copyFrom.Iy, copyFrom.Iz, copyFrom.Iw,     // Following Basis major. This is just float value order
-					  copyFrom.Jx,copyFrom.Jy,  copyFrom.Jz, copyFrom.Jw, 
-					  copyFrom.Kx, copyFrom.Ky, copyFrom.Kz, copyFrom.Kw,
-					  copyFrom.Tx, copyFrom.Ty, copyFrom.Tz, copyFrom.Tw};
-	SetValues(values);
+	memmove(data, copyFrom.data, sizeof(data)); // Basis major either way, so a straight copy
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -911,23 +1233,16 @@ Matrix44 Matrix44::operator*(const Matrix44& matrix) const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Interpolates between the matrices
+// Interpolates between the matrices. The rotation is slerped as a quaternion so the basis stays
+// orthonormal, blending each basis vector on its own would shear it
 //
 Matrix44 Interpolate(const Matrix44& start, const Matrix44& end, float fractionTowardEnd)
 {
-	Vector3 aRight = start.GetRight();
-	Vector3 bRight = end.GetRight(); 
-	Vector3 aUp = start.GetUp();
-	Vector3 bUp = end.GetUp(); 
-	Vector3 aForward = start.GetForward(); 
-	Vector3 bForward = end.GetForward();
-	Vector3 aTranslation = start.GetTranslation();
-	Vector3 bTranslation = end.GetTranslation(); 
-
-	Vector3 right = Slerp( aRight, bRight, fractionTowardEnd ); 
-	Vector3 up = Slerp( aUp, bUp, fractionTowardEnd ); 
-	Vector3 forward = Slerp( aForward, bForward, fractionTowardEnd ); 
-	Vector3 translation = Interpolate( aTranslation, bTranslation, fractionTowardEnd ); 
-
-	return Matrix44( right, up, forward, translation ); 
+	Vector3 aScale = start.GetScale();
+	Vector3 bScale = end.GetScale();
+	Quaternion rotation = Slerp(Quaternion::MakeFromMatrix(start), Quaternion::MakeFromMatrix(end), fractionTowardEnd);
+	Vector3 scale = Interpolate(aScale, bScale, fractionTowardEnd);
+	Vector3 translation = Interpolate(start.GetTranslation(), end.GetTranslation(), fractionTowardEnd);
+
+	return Matrix44::MakeTRS(translation, rotation, scale);
 }
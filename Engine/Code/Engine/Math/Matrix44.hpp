@@ -4,6 +4,8 @@
 
 //-----------------------------------------------------------------------------------------------
 //Forward Declarations
+class AABB3;
+class Quaternion;
 
 //-----------------------------------------------------------------------------------------------
 class Matrix44
@@ -26,6 +28,7 @@ public:
 	Vector3		GetRight() const;
 	Vector3		GetUp() const;
 	Vector3		GetTranslation() const { return Vector3(Tx, Ty, Tz); }
+	Vector3		GetScale() const; // Length of each basis, GetRight and friends are normalized
 	Vector3		GetEulerAngles() const;
 	Matrix44	GetInverse() const;
 	float		GetTrace3() const;
@@ -67,14 +70,24 @@ public:
 	static Matrix44 MakeScale2D( float scaleX, float scaleY );
 	static Matrix44 MakeScale3D( float scaleX, float scaleY, float scaleZ );
 	static Matrix44 MakeScale3D( const Vector3& scale );
+	static Matrix44 MakeTRS( const Vector3& translation, const Vector3& eulerDegrees, const Vector3& scale ); // Same as T * R * S without the multiplies
+	static Matrix44 MakeTRS( const Vector3& translation, const Quaternion& rotation, const Vector3& scale );
 	static Matrix44 MakeOrtho2D( const Vector2& bottomLeft, const Vector2& topRight );
 	static Matrix44 MakeOrtho3D( const Vector2& bottomLeft, const Vector2& topRight, float zNear, float zFar);
 	static Matrix44 MakeOrtho3D( float left, float right, float down, float up, float zNear, float zFar);
 	static Matrix44	MakePerspectiveMatrix( float fovDegrees, float aspect, float zNear, float zFar);
 	static Matrix44 MatrixMultiply( const Matrix44& first, const Matrix44& second );
+	static void		MatrixMultiply( const Matrix44& first, const Matrix44& second, Matrix44& out_result ); // out_result may alias
 	static Matrix44 LookAt( const Vector3& position, const Vector3& target, const Vector3& up = Vector3::UP);
 	static Matrix44 InvertFast( const Matrix44& mat);
 	static Matrix44 Invert( const Matrix44& mat );
+	static Matrix44 InvertAffine( const Matrix44& mat ); // Bottom row must be (0,0,0,1), scale and shear are fine
+
+	//-----------------------------------------------------------------------------------------------
+	// Batch transforms, SIMD when Engine/Math/SIMD.hpp finds an instruction set
+	static void		TransformPositions3D( const Matrix44& mat, const Vector3* positions, Vector3* out_positions, int count );
+	static void		MultiplyBatch( const Matrix44& first, const Matrix44* seconds, Matrix44* out_results, int count );
+	static void		TransformAABBs( const Matrix44& mat, const AABB3* boxes, AABB3* out_boxes, int count );
 
 	//-----------------------------------------------------------------------------------------------
 	// Operators
@@ -120,4 +133,4 @@ public:
 
 //-----------------------------------------------------------------------------------------------
 // Standalone functions
-Matrix44 Interpolate( const Matrix44& start, const Matrix44& end, float fractionTowardEnd );
\ No newline at end of file
+Matrix44 Interpolate( const Matrix44& start, const Matrix44& end, float fractionTowardEnd ); // Lerps scale and translation, slerps rotation
\ No newline at end of file
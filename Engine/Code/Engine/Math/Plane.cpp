@@ -56,3 +56,16 @@ void Plane::FlipNormal()
 	normal = -1.f * normal;
 	distance = -distance;
 }
+
+//-----------------------------------------------------------------------------------------------
+// Normalizes the normal and scales the distance along with it
+//
+void Plane::Normalize()
+{
+	float length = normal.GetLength();
+	GUARANTEE_OR_DIE(length != 0.f, "Can't normalize a plane with a zero normal");
+
+	float invLength = 1.f / length;
+	normal = normal * invLength;
+	distance *= invLength;
+}
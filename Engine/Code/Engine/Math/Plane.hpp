@@ -11,6 +11,8 @@ class Plane
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
+	Plane(): normal(Vector3::UP), distance(0.f) {}
+	explicit Plane( const Vector3& norm, float distanceFromOrigin ): normal(norm), distance(distanceFromOrigin) {}
 	explicit Plane( const Vector3& norm, const Vector3& pos );
 	explicit Plane( const Vector3& a, const Vector3& b, const Vector3& c );
 	~Plane(){}
@@ -23,6 +25,7 @@ public:
 	float	GetDistanceFromPlane ( const Vector3& pos ) const;
 	bool	IsPointInFront ( const Vector3& pos ) const;
 	void	FlipNormal();
+	void	Normalize(); // Normalizes the normal and scales the distance along with it
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
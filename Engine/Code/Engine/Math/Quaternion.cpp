@@ -0,0 +1,320 @@
+#include "Engine/Math/Quaternion.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/SIMD.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <math.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+const Quaternion Quaternion::IDENTITY;
+
+#if defined(ENGINE_SIMD_ENABLED)
+//-----------------------------------------------------------------------------------------------
+// The three swizzles of rhs the Hamilton product needs, (w,z,y,x) (z,w,x,y) and (y,x,w,z)
+//
+static void GetProductSwizzles(simd4f v, simd4f& out_wzyx, simd4f& out_zwxy, simd4f& out_yxwz)
+{
+#if defined(ENGINE_SIMD_SSE)
+	out_wzyx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+	out_zwxy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+	out_yxwz = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+#else
+	out_zwxy = vextq_f32(v, v, 2);
+	out_wzyx = vrev64q_f32(out_zwxy);
+	out_yxwz = vrev64q_f32(v);
+#endif
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Returns the length
+//
+float Quaternion::GetLength() const
+{
+	return sqrtf(DotProduct(*this, *this));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a unit length copy
+//
+Quaternion Quaternion::GetNormalized() const
+{
+	Quaternion normalized = *this;
+	normalized.Normalize();
+	return normalized;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the inverse rotation
+//
+Quaternion Quaternion::GetInverse() const
+{
+	float lengthSquared = DotProduct(*this, *this);
+	if(lengthSquared == 0.f)
+	{
+		return IDENTITY;
+	}
+
+	float inverseLengthSquared = 1.f / lengthSquared;
+	return Quaternion(-x * inverseLengthSquared, -y * inverseLengthSquared, -z * inverseLengthSquared, w * inverseLengthSquared);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the euler angles in degrees that Matrix44::MakeRotation3D would turn back into this
+// rotation. Pitch is in [-90, 90]
+//
+Vector3 Quaternion::GetEulerAngles() const
+{
+	float sinX = ClampFloatNegativeOneToOne(2.f * (w * x - y * z));
+	float xDeg = ConvertRadiansToDegrees(asinf(sinX));
+	float yDeg;
+	float zDeg;
+
+	if(fabsf(sinX) < 0.9999f)
+	{
+		yDeg = Atan2Degrees(2.f * (x * z + w * y), 1.f - 2.f * (x * x + y * y));
+		zDeg = Atan2Degrees(2.f * (x * y + w * z), 1.f - 2.f * (x * x + z * z));
+	}
+	else
+	{
+		// Gimbal lock, yaw and roll turn around the same axis so put all of it in yaw
+		yDeg = Atan2Degrees(-2.f * (x * z - w * y), 1.f - 2.f * (y * y + z * z));
+		zDeg = 0.f;
+	}
+
+	return Vector3(xDeg, yDeg, zDeg);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation matrix
+//
+Matrix44 Quaternion::GetMatrix() const
+{
+	Vector3 right;
+	Vector3 up;
+	Vector3 forward;
+	GetBasis(right, up, forward);
+
+	return Matrix44(right, up, forward);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotated basis vectors, the columns of the rotation matrix
+//
+void Quaternion::GetBasis(Vector3& out_right, Vector3& out_up, Vector3& out_forward) const
+{
+	float xx = x * x;
+	float yy = y * y;
+	float zz = z * z;
+	float xy = x * y;
+	float xz = x * z;
+	float yz = y * z;
+	float wx = w * x;
+	float wy = w * y;
+	float wz = w * z;
+
+	out_right	= Vector3(1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy));
+	out_up		= Vector3(2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx));
+	out_forward	= Vector3(2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Scales to unit length, a zero quaternion becomes the identity
+//
+void Quaternion::Normalize()
+{
+	float length = GetLength();
+	if(length == 0.f)
+	{
+		*this = IDENTITY;
+		return;
+	}
+
+	float inverseLength = 1.f / length;
+	x *= inverseLength;
+	y *= inverseLength;
+	z *= inverseLength;
+	w *= inverseLength;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rotates the vector, v + 2w(u x v) + 2u x (u x v) for a unit quaternion
+//
+Vector3 Quaternion::RotateVector(const Vector3& vector) const
+{
+	Vector3 axis(x, y, z);
+	Vector3 twiceCross = CrossProduct(axis, vector) * 2.f;
+	return vector + (twiceCross * w) + CrossProduct(axis, twiceCross);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hamilton product, the result rotates by rhs and then by this
+//
+Quaternion Quaternion::operator*(const Quaternion& rhs) const
+{
+#if defined(ENGINE_SIMD_ENABLED)
+	simd4f b = SIMDLoad(rhs.data);
+	simd4f wzyx;
+	simd4f zwxy;
+	simd4f yxwz;
+	GetProductSwizzles(b, wzyx, zwxy, yxwz);
+
+	simd4f result = SIMDMul(SIMDSplat(w), b);
+	result = SIMDMulAdd(SIMDSplat(x), SIMDMul(wzyx, SIMDSet(1.f, -1.f, 1.f, -1.f)), result);
+	result = SIMDMulAdd(SIMDSplat(y), SIMDMul(zwxy, SIMDSet(1.f, 1.f, -1.f, -1.f)), result);
+	result = SIMDMulAdd(SIMDSplat(z), SIMDMul(yxwz, SIMDSet(-1.f, 1.f, 1.f, -1.f)), result);
+
+	Quaternion product;
+	SIMDStore(product.data, result);
+	return product;
+#else
+	return Quaternion(
+		w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+		w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+		w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w,
+		w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z);
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Component wise compare, q and -q are the same rotation but not equal here
+//
+bool Quaternion::operator==(const Quaternion& compare) const
+{
+	return x == compare.x && y == compare.y && z == compare.z && w == compare.w;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation around the axis, the axis does not need to be normalized
+//
+STATIC Quaternion Quaternion::MakeFromAxisAngle(const Vector3& axis, float degrees)
+{
+	Vector3 unitAxis = axis.GetNormalized();
+	float halfDegrees = degrees * 0.5f;
+	float sinHalf = SinDegrees(halfDegrees);
+
+	return Quaternion(unitAxis.x * sinHalf, unitAxis.y * sinHalf, unitAxis.z * sinHalf, CosDegrees(halfDegrees));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Same rotation as Matrix44::MakeRotation3D, yaw * pitch * roll written out
+//
+STATIC Quaternion Quaternion::MakeFromEuler(const Vector3& eulerDegrees)
+{
+	float cx = CosDegrees(eulerDegrees.x * 0.5f);
+	float sx = SinDegrees(eulerDegrees.x * 0.5f);
+	float cy = CosDegrees(eulerDegrees.y * 0.5f);
+	float sy = SinDegrees(eulerDegrees.y * 0.5f);
+	float cz = CosDegrees(eulerDegrees.z * 0.5f);
+	float sz = SinDegrees(eulerDegrees.z * 0.5f);
+
+	return Quaternion(
+		cy * sx * cz + sy * cx * sz,
+		sy * cx * cz - cy * sx * sz,
+		cy * cx * sz - sy * sx * cz,
+		cy * cx * cz + sy * sx * sz);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation part of the matrix, picks the largest component first to stay stable
+//
+STATIC Quaternion Quaternion::MakeFromMatrix(const Matrix44& mat)
+{
+	Vector3 right = mat.GetRight().GetNormalized();
+	Vector3 up = mat.GetUp().GetNormalized();
+	Vector3 forward = mat.GetForward().GetNormalized();
+
+	float trace = right.x + up.y + forward.z;
+	Quaternion result;
+	if(trace > 0.f)
+	{
+		float s = 0.5f / sqrtf(trace + 1.f);
+		result = Quaternion((up.z - forward.y) * s, (forward.x - right.z) * s, (right.y - up.x) * s, 0.25f / s);
+	}
+	else if(right.x > up.y && right.x > forward.z)
+	{
+		float s = 2.f * sqrtf(1.f + right.x - up.y - forward.z);
+		result = Quaternion(0.25f * s, (up.x + right.y) / s, (forward.x + right.z) / s, (up.z - forward.y) / s);
+	}
+	else if(up.y > forward.z)
+	{
+		float s = 2.f * sqrtf(1.f + up.y - right.x - forward.z);
+		result = Quaternion((up.x + right.y) / s, 0.25f * s, (forward.y + up.z) / s, (forward.x - right.z) / s);
+	}
+	else
+	{
+		float s = 2.f * sqrtf(1.f + forward.z - right.x - up.y);
+		result = Quaternion((forward.x + right.z) / s, (forward.y + up.z) / s, 0.25f * s, (right.y - up.x) / s);
+	}
+
+	result.Normalize();
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// 4D dot product
+//
+float DotProduct(const Quaternion& a, const Quaternion& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Normalized lerp along the shorter arc
+//
+Quaternion Nlerp(const Quaternion& start, const Quaternion& end, float fractionTowardEnd)
+{
+	float endWeight = (DotProduct(start, end) < 0.f) ? -fractionTowardEnd : fractionTowardEnd;
+	float startWeight = 1.f - fractionTowardEnd;
+
+	Quaternion result(
+		start.x * startWeight + end.x * endWeight,
+		start.y * startWeight + end.y * endWeight,
+		start.z * startWeight + end.z * endWeight,
+		start.w * startWeight + end.w * endWeight);
+	result.Normalize();
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constant speed interpolation along the shorter arc, falls back to nlerp when the rotations
+// are close enough that the sine would lose precision
+//
+Quaternion Slerp(const Quaternion& start, const Quaternion& end, float fractionTowardEnd)
+{
+	float cosAngle = DotProduct(start, end);
+	float sign = 1.f;
+	if(cosAngle < 0.f)
+	{
+		cosAngle = -cosAngle;
+		sign = -1.f;
+	}
+
+	if(cosAngle > 0.9995f)
+	{
+		return Nlerp(start, end, fractionTowardEnd);
+	}
+
+	float angle = acosf(cosAngle);
+	float inverseSin = 1.f / sinf(angle);
+	float startWeight = sinf((1.f - fractionTowardEnd) * angle) * inverseSin;
+	float endWeight = sinf(fractionTowardEnd * angle) * inverseSin * sign;
+
+	return Quaternion(
+		start.x * startWeight + end.x * endWeight,
+		start.y * startWeight + end.y * endWeight,
+		start.z * startWeight + end.z * endWeight,
+		start.w * startWeight + end.w * endWeight);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates the rotation
+//
+Quaternion Interpolate(const Quaternion& start, const Quaternion& end, float fractionTowardEnd)
+{
+	return Slerp(start, end, fractionTowardEnd);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#pragma warning (disable:4201)
+#include "Engine/Math/Vector3.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Matrix44;
+
+//-----------------------------------------------------------------------------------------------
+// Rotation quaternion, stored x y z w so it loads straight into a SIMD register. Follows the
+// engine's euler convention (degrees, applied z then x then y) and column vectors, so a * b
+// rotates by b first
+//
+class Quaternion
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	Quaternion(): x(0.f), y(0.f), z(0.f), w(1.f) {}
+	explicit Quaternion( float initialX, float initialY, float initialZ, float initialW ): x(initialX), y(initialY), z(initialZ), w(initialW) {}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	float			GetLength() const;
+	Quaternion		GetNormalized() const;
+	Quaternion		GetConjugate() const { return Quaternion(-x, -y, -z, w); }
+	Quaternion		GetInverse() const; // Conjugate over the squared length, same as the conjugate for unit quaternions
+	Vector3			GetEulerAngles() const;
+	Matrix44		GetMatrix() const;
+	void			GetBasis( Vector3& out_right, Vector3& out_up, Vector3& out_forward ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	void			Normalize();
+	Vector3			RotateVector( const Vector3& vector ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Operators
+	Quaternion		operator*( const Quaternion& rhs ) const;
+	bool			operator==( const Quaternion& compare ) const;
+	bool			operator!=( const Quaternion& compare ) const { return !(*this == compare); }
+
+	//-----------------------------------------------------------------------------------------------
+	// Producers
+	static	Quaternion	MakeFromAxisAngle( const Vector3& axis, float degrees );
+	static	Quaternion	MakeFromEuler( const Vector3& eulerDegrees );
+	static	Quaternion	MakeFromMatrix( const Matrix44& mat ); // Uses the normalized basis, scale is ignored
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	union
+	{
+		struct
+		{
+			float x;
+			float y;
+			float z;
+			float w;
+		};
+
+		float data[4];
+	};
+
+	// Static Members
+	static	const	Quaternion	IDENTITY;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+float		DotProduct( const Quaternion& a, const Quaternion& b );
+Quaternion	Nlerp( const Quaternion& start, const Quaternion& end, float fractionTowardEnd ); // Cheap, speed is not constant
+Quaternion	Slerp( const Quaternion& start, const Quaternion& end, float fractionTowardEnd );
+Quaternion	Interpolate( const Quaternion& start, const Quaternion& end, float fractionTowardEnd ); // Slerp
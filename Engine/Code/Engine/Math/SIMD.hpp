@@ -0,0 +1,67 @@
+#pragma once
+
+//-----------------------------------------------------------------------------------------------
+// Instruction set selection. AVX2 needs /arch:AVX2 (or -mavx2 -mfma), SSE2 is always there on
+// x64. Define ENGINE_SIMD_DISABLED to force the scalar reference paths
+#if !defined(ENGINE_SIMD_DISABLED) && defined(__AVX2__)
+	#define ENGINE_SIMD_AVX2
+	#define ENGINE_SIMD_SSE
+	#include <immintrin.h>
+#elif !defined(ENGINE_SIMD_DISABLED) && (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define ENGINE_SIMD_SSE
+	#include <emmintrin.h>
+#elif !defined(ENGINE_SIMD_DISABLED) && (defined(__aarch64__) || defined(_M_ARM64))
+	#define ENGINE_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+#if defined(ENGINE_SIMD_SSE) || defined(ENGINE_SIMD_NEON)
+	#define ENGINE_SIMD_ENABLED
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Thin 4 wide float wrappers so the math code is written once for SSE and NEON. Loads and
+// stores are unaligned since the math types are plain float structs
+#if defined(ENGINE_SIMD_SSE)
+
+typedef __m128 simd4f;
+
+inline simd4f	SIMDLoad( const float* values ) { return _mm_loadu_ps(values); }
+inline void		SIMDStore( float* out_values, simd4f v ) { _mm_storeu_ps(out_values, v); }
+inline simd4f	SIMDSet( float x, float y, float z, float w ) { return _mm_setr_ps(x, y, z, w); }
+inline simd4f	SIMDSplat( float value ) { return _mm_set1_ps(value); }
+inline simd4f	SIMDAdd( simd4f a, simd4f b ) { return _mm_add_ps(a, b); }
+inline simd4f	SIMDSub( simd4f a, simd4f b ) { return _mm_sub_ps(a, b); }
+inline simd4f	SIMDMul( simd4f a, simd4f b ) { return _mm_mul_ps(a, b); }
+inline simd4f	SIMDMin( simd4f a, simd4f b ) { return _mm_min_ps(a, b); }
+inline simd4f	SIMDMax( simd4f a, simd4f b ) { return _mm_max_ps(a, b); }
+inline simd4f	SIMDAbs( simd4f v ) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+template <int lane>
+inline simd4f	SIMDSplatLane( simd4f v ) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane)); }
+
+// a * b + c
+#if defined(ENGINE_SIMD_AVX2)
+inline simd4f	SIMDMulAdd( simd4f a, simd4f b, simd4f c ) { return _mm_fmadd_ps(a, b, c); }
+#else
+inline simd4f	SIMDMulAdd( simd4f a, simd4f b, simd4f c ) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+
+#elif defined(ENGINE_SIMD_NEON)
+
+typedef float32x4_t simd4f;
+
+inline simd4f	SIMDLoad( const float* values ) { return vld1q_f32(values); }
+inline void		SIMDStore( float* out_values, simd4f v ) { vst1q_f32(out_values, v); }
+inline simd4f	SIMDSet( float x, float y, float z, float w ) { float values[4] = { x, y, z, w }; return vld1q_f32(values); }
+inline simd4f	SIMDSplat( float value ) { return vdupq_n_f32(value); }
+inline simd4f	SIMDAdd( simd4f a, simd4f b ) { return vaddq_f32(a, b); }
+inline simd4f	SIMDSub( simd4f a, simd4f b ) { return vsubq_f32(a, b); }
+inline simd4f	SIMDMul( simd4f a, simd4f b ) { return vmulq_f32(a, b); }
+inline simd4f	SIMDMin( simd4f a, simd4f b ) { return vminq_f32(a, b); }
+inline simd4f	SIMDMax( simd4f a, simd4f b ) { return vmaxq_f32(a, b); }
+inline simd4f	SIMDAbs( simd4f v ) { return vabsq_f32(v); }
+inline simd4f	SIMDMulAdd( simd4f a, simd4f b, simd4f c ) { return vfmaq_f32(c, a, b); }
+template <int lane>
+inline simd4f	SIMDSplatLane( simd4f v ) { return vdupq_laneq_f32(v, lane); }
+
+#endif
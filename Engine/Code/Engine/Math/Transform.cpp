@@ -1,4 +1,5 @@
 #include "Engine/Math/Transform.hpp"
+#include "Engine/Math/TransformSystem.hpp"
 #include "Engine/Math/Vector4.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -10,44 +11,66 @@ const transform_t transform_t::IDENTITY;
 //
 Transform::Transform()
 {
+	m_handle = TransformSystem::CreateInstance()->CreateNode();
+}
 
+//-----------------------------------------------------------------------------------------------
+// Copy constructor
+//
+Transform::Transform(const Transform& copy)
+{
+	TransformSystem* system = TransformSystem::CreateInstance();
+	m_handle = system->CreateNode();
+	system->EditLocal(m_handle) = copy.GetLocalTransform();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Computes the world matrix on demand if its dirty
+// Destructor
 //
-Matrix44 Transform::GetWorldMatrix() const
+Transform::~Transform()
 {
-	if(m_isDirty)
+	TransformSystem* system = TransformSystem::GetInstance();
+	if(system)
 	{
-		RecomputeMatrices(m_parent);
-		m_isDirty = false;
+		system->DestroyNode(m_handle);
 	}
-
-	return m_worldMatrix;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Computes the local matrix on demand if its dirty and if its not parent
+// Copies the local TRS, the parent stays as it was
 //
-Matrix44 Transform::GetLocalMatrix()
+Transform& Transform::operator=(const Transform& copy)
 {
-	if(!m_parent)
+	if(this != &copy)
 	{
-		m_localMatrix = GetWorldMatrix();
-		return m_localMatrix;
+		TransformSystem::GetInstance()->EditLocal(m_handle) = copy.GetLocalTransform();
 	}
 
-	else
-	{
-		if(m_isDirty)
-		{
-			RecomputeMatrices(true);
-			m_isDirty = false;
-		}
+	return *this;
+}
 
-		return m_localMatrix;
-	}
+//-----------------------------------------------------------------------------------------------
+// Returns the local position, rotation and scale
+//
+transform_t Transform::GetLocalTransform() const
+{
+	return TransformSystem::GetInstance()->GetLocal(m_handle);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Computes the world matrix on demand if it or a parent is dirty
+//
+Matrix44 Transform::GetWorldMatrix() const
+{
+	return TransformSystem::GetInstance()->GetWorldMatrix(m_handle);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Computes the local matrix on demand if its dirty
+//
+Matrix44 Transform::GetLocalMatrix() const
+{
+	return TransformSystem::GetInstance()->GetLocalMatrix(m_handle);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -55,14 +78,13 @@ Matrix44 Transform::GetLocalMatrix()
 //
 void Transform::SetLocalMatrix(const Matrix44& local)
 {
-	if(m_localMatrix == local)
+	TransformSystem* system = TransformSystem::GetInstance();
+	if(system->GetLocalMatrix(m_handle) == local)
 	{
 		return;
 	}
 	
-	m_localMatrix = local;
-	m_localTransform.SetMatrix(local);
-	SetDirtyOnHierarchy();
+	system->EditLocal(m_handle).SetMatrix(local);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -70,15 +92,23 @@ void Transform::SetLocalMatrix(const Matrix44& local)
 //
 void Transform::SetWorldMatrix(const Matrix44& world)
 {
-	if(m_worldMatrix == world)
+	TransformSystem* system = TransformSystem::GetInstance();
+	if(system->GetWorldMatrix(m_handle) == world)
 	{
 		return;
 	}
 
-	m_worldMatrix = world;
-	m_localMatrix = m_parent ? m_parent->GetWorldMatrix().GetInverse() * m_worldMatrix : m_worldMatrix; 
-	m_localTransform.SetMatrix(m_localMatrix);
-	SetDirtyOnHierarchy();
+	TransformHandle parent = system->GetParent(m_handle);
+	Matrix44 local = (parent != INVALID_TRANSFORM) ? Matrix44::InvertAffine(system->GetWorldMatrix(parent)) * world : world; 
+	system->EditLocal(m_handle).SetMatrix(local);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a number that changes whenever this or a parent moves
+//
+uint32_t Transform::GetVersion() const
+{
+	return TransformSystem::GetInstance()->GetWorldVersion(m_handle);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -86,10 +116,9 @@ void Transform::SetWorldMatrix(const Matrix44& world)
 //
 void Transform::SetEulerAngles(const Vector3& angles)
 {
-	if(angles != m_localTransform.GetEulerAngles())
+	if(angles != GetLocalTransform().GetEulerAngles())
 	{
-		m_localTransform.SetEulerAngles(angles);
-		SetDirtyOnHierarchy();
+		TransformSystem::GetInstance()->EditLocal(m_handle).SetEulerAngles(angles);
 	}
 }
 
@@ -98,10 +127,9 @@ void Transform::SetEulerAngles(const Vector3& angles)
 //
 void Transform::SetPosition(const Vector3& newPos)
 {
-	if(m_localTransform.GetPosition() != newPos)
+	if(GetLocalTransform().GetPosition() != newPos)
 	{
-		m_localTransform.SetPosition(newPos);
-		SetDirtyOnHierarchy();
+		TransformSystem::GetInstance()->EditLocal(m_handle).SetPosition(newPos);
 	}
 }
 
@@ -110,31 +138,38 @@ void Transform::SetPosition(const Vector3& newPos)
 //
 void Transform::SetScale(const Vector3& newScale)
 {
-	if(m_localTransform.GetScale() != newScale)
+	if(GetLocalTransform().GetScale() != newScale)
 	{
-		m_localTransform.SetScale(newScale);
-		SetDirtyOnHierarchy();
+		TransformSystem::GetInstance()->EditLocal(m_handle).SetScale(newScale);
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Computes the transform matrix for the current rotation, position and scale
+// Brings the matrices of this transform and its parents up to date now instead of on the next
+// query or sweep
 //
-void Transform::RecomputeMatrices( bool isChild ) const
+void Transform::RecomputeMatrices() const
 {
-	m_localMatrix = m_localTransform.GetMatrix(); // Recomputes the matrix 
+	TransformSystem::GetInstance()->GetWorldMatrix(m_handle);
+}
 
-	if(isChild)
-	{
-		m_worldMatrix.SetIdentity();
-		m_worldMatrix.Append(m_parent->GetWorldMatrix());
-		m_worldMatrix.Append(m_localMatrix);
-	}
-	else
+//-----------------------------------------------------------------------------------------------
+// Sets the rotation, the transform keeps it as a quaternion from then on
+//
+void Transform::SetRotation(const Quaternion& rotation)
+{
+	TransformSystem::GetInstance()->EditLocal(m_handle).SetRotation(rotation);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches between euler and quaternion storage for the rotation
+//
+void Transform::SetUsesQuaternion(bool usesQuaternion)
+{
+	if(GetLocalTransform().UsesQuaternion() != usesQuaternion)
 	{
-		m_worldMatrix = m_localMatrix; // If there's no parent localMatrix = worldMatrix
+		TransformSystem::GetInstance()->EditLocal(m_handle).SetUsesQuaternion(usesQuaternion);
 	}
-	
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -147,8 +182,7 @@ void Transform::Translate(const Vector3& offset)
 		return;
 	}
 
-	m_localTransform.Translate(offset);
-	SetDirtyOnHierarchy();
+	TransformSystem::GetInstance()->EditLocal(m_handle).Translate(offset);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -161,8 +195,15 @@ void Transform::RotateByEuler(const Vector3& rotateVec)
 		return;
 	}
 
-	m_localTransform.RotateByEuler(rotateVec);
-	SetDirtyOnHierarchy();
+	TransformSystem::GetInstance()->EditLocal(m_handle).RotateByEuler(rotateVec);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rotates in local space by the quaternion
+//
+void Transform::Rotate(const Quaternion& rotation)
+{
+	TransformSystem::GetInstance()->EditLocal(m_handle).Rotate(rotation);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -181,9 +222,9 @@ void Transform::LookAt(const Vector3& worldPosition, const Vector3& worldUp /*=
 //
 void Transform::LocalLookAt(const Vector3& localPosition, const Vector3& localUp /*= Vector3::UP */)
 {
-	m_localMatrix			=	m_localTransform.GetMatrix();
-	Vector3 worldPos		=	m_localMatrix.TransformPosition3D(localPosition);
-	Vector3 worldUp			=	m_localMatrix.TransformDirection3D(localUp);
+	Matrix44 localMatrix	=	GetLocalTransform().GetMatrix();
+	Vector3 worldPos		=	localMatrix.TransformPosition3D(localPosition);
+	Vector3 worldUp			=	localMatrix.TransformDirection3D(localUp);
 
 	return LookAt(worldPos, worldUp);
 }
@@ -193,21 +234,24 @@ void Transform::LocalLookAt(const Vector3& localPosition, const Vector3& localUp
 //
 void Transform::AddChild(Transform* child)
 {
-	m_children.push_back(child);
-	child->m_parent = this;
-	child->SetDirtyOnHierarchy();
+	child->SetParent(this);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Sets dirty on all children
+// Moves this transform under a new parent keeping its local TRS, nullptr makes it a root
+//
+void Transform::SetParent(Transform* parent)
+{
+	TransformSystem::GetInstance()->SetParent(m_handle, parent ? parent->m_handle : INVALID_TRANSFORM);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Marks this transform dirty, children pick it up through the parent's version on their next
+// update
 //
 void Transform::SetDirtyOnHierarchy()
 {
-	m_isDirty = true;
-	for(Transform* transform : m_children)
-	{
-		transform->SetDirtyOnHierarchy();
-	}
+	TransformSystem::GetInstance()->MarkDirty(m_handle);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -215,12 +259,12 @@ void Transform::SetDirtyOnHierarchy()
 //
 Matrix44 transform_t::GetMatrix() const
 {
-	Matrix44 matrix; 
-	matrix.Append(Matrix44::MakeTranslation3D(m_position));
-	matrix.Append(Matrix44::MakeRotation3D(m_euler));
-	matrix.Append(Matrix44::MakeScale3D(m_scale));
-	
-	return matrix;
+	if(m_usesQuaternion)
+	{
+		return Matrix44::MakeTRS(m_position, m_rotation, m_scale);
+	}
+
+	return Matrix44::MakeTRS(m_position, m_euler, m_scale);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -228,9 +272,87 @@ Matrix44 transform_t::GetMatrix() const
 //
 void transform_t::SetMatrix(const Matrix44& mat)
 {
-	m_euler = mat.GetEulerAngles();
+	if(m_usesQuaternion)
+	{
+		m_rotation = Quaternion::MakeFromMatrix(mat);
+	}
+	else
+	{
+		m_euler = mat.GetEulerAngles();
+	}
+
 	m_position = Vector3(mat.Tx, mat.Ty, mat.Tz); // Assuming that the matrix was computed as TRS*point
-	m_scale.x = mat.GetRight().GetLength();
-	m_scale.y = mat.GetUp().GetLength();
-	m_scale.z = mat.GetForward().GetLength();
+	m_scale = mat.GetScale();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the rotation from euler angles
+//
+void transform_t::SetEulerAngles(const Vector3& euler)
+{
+	if(m_usesQuaternion)
+	{
+		m_rotation = Quaternion::MakeFromEuler(euler);
+	}
+	else
+	{
+		m_euler = euler;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the rotation and switches to quaternion storage
+//
+void transform_t::SetRotation(const Quaternion& rotation)
+{
+	m_rotation = rotation.GetNormalized();
+	m_usesQuaternion = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches the rotation storage, going back to euler angles loses anything past gimbal lock
+//
+void transform_t::SetUsesQuaternion(bool usesQuaternion)
+{
+	if(usesQuaternion == m_usesQuaternion)
+	{
+		return;
+	}
+
+	if(usesQuaternion)
+	{
+		m_rotation = Quaternion::MakeFromEuler(m_euler);
+	}
+	else
+	{
+		m_euler = m_rotation.GetEulerAngles();
+	}
+
+	m_usesQuaternion = usesQuaternion;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds to the euler angles. With quaternion storage yaw turns around the parent's up and pitch
+// and roll around the local axes, which matches adding the angles as long as there is no roll
+//
+void transform_t::RotateByEuler(const Vector3& euler)
+{
+	if(!m_usesQuaternion)
+	{
+		m_euler += euler;
+		return;
+	}
+
+	Quaternion yaw = Quaternion::MakeFromAxisAngle(Vector3::UP, euler.y);
+	Quaternion pitchRoll = Quaternion::MakeFromEuler(Vector3(euler.x, 0.f, euler.z));
+	m_rotation = (yaw * m_rotation * pitchRoll).GetNormalized();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Applies the rotation in local space
+//
+void transform_t::Rotate(const Quaternion& rotation)
+{
+	SetUsesQuaternion(true);
+	m_rotation = (m_rotation * rotation).GetNormalized();
 }
@@ -1,12 +1,18 @@
 #pragma once
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Quaternion.hpp"
 #include <vector>
+#include <stdint.h>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 
 //-----------------------------------------------------------------------------------------------
+// Local position, rotation and scale. The rotation is kept as euler angles unless quaternion
+// storage is turned on, which skips the euler round trip in SetMatrix and composes rotations
+// without gimbal lock
+//
 struct transform_t 
 {
 	//-----------------------------------------------------------------------------------------------
@@ -24,83 +30,102 @@ struct transform_t
 	Vector3		GetPosition() const { return m_position; } 
 	void		SetPosition( const Vector3& pos ) { m_position = pos; }
 
-	void		SetEulerAngles( const Vector3& euler ) { m_euler = euler; } 
-	Vector3		GetEulerAngles() const { return m_euler; }
+	void		SetEulerAngles( const Vector3& euler );
+	Vector3		GetEulerAngles() const { return m_usesQuaternion ? m_rotation.GetEulerAngles() : m_euler; }
+
+	void		SetRotation( const Quaternion& rotation ); // Turns on quaternion storage
+	Quaternion	GetRotation() const { return m_usesQuaternion ? m_rotation : Quaternion::MakeFromEuler(m_euler); }
 
 	void		SetScale( const Vector3& scale ) { m_scale = scale; }
 	Vector3		GetScale() const { return m_scale; }
 
+	bool		UsesQuaternion() const { return m_usesQuaternion; }
+	void		SetUsesQuaternion( bool usesQuaternion ); // Converts the current rotation
+
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 	void		Translate( const Vector3& offset ) { m_position += offset; }
 	void		Translate( float x, float y, float z) { Translate(Vector3(x,y,z)); }
-	void		RotateByEuler( const Vector3& euler ) { m_euler += euler; }
+	void		RotateByEuler( const Vector3& euler );
 	void		RotateByEuler( float x, float y, float z) { RotateByEuler(Vector3(x,y,z)); }
+	void		Rotate( const Quaternion& rotation ); // Local space, turns on quaternion storage
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
 					Vector3		m_position; 
 					Vector3		m_euler; 
 					Vector3		m_scale; 
+					Quaternion	m_rotation;
+					bool		m_usesQuaternion = false;
 
 	// Static Members
 	static	const	transform_t IDENTITY; 
 };
 
 //-----------------------------------------------------------------------------------------------
+// Thin handle into the TransformSystem, which keeps the TRS and matrices of every transform in
+// flat arrays sorted by hierarchy depth. Getters may rebuild stale matrices, so jobs should only
+// read transforms after the frame's UpdateWorldMatrices
+//
 class Transform
 {
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	Transform();
-	~Transform(){}
+	Transform( const Transform& copy ); // Copies the local TRS, the copy starts as a root
+	~Transform();
+
+	Transform& operator=( const Transform& copy );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-	Vector3		GetForward() const { return m_worldMatrix.GetForward(); }
-	Vector3		GetRight() const { return m_worldMatrix.GetRight(); }
-	Vector3		GetUp() const { return m_worldMatrix.GetUp(); }
+	Vector3		GetForward() const { return GetWorldMatrix().GetForward(); }
+	Vector3		GetRight() const { return GetWorldMatrix().GetRight(); }
+	Vector3		GetUp() const { return GetWorldMatrix().GetUp(); }
 	
-	Vector3		GetLocalPosition() const { return m_localTransform.GetPosition(); }
+	Vector3		GetLocalPosition() const { return GetLocalTransform().GetPosition(); }
 	Vector3		GetWorldPosition() const { return GetWorldMatrix().GetTranslation(); }
 	void		SetPosition( const Vector3& newPos );
 	void		SetPosition( float x, float y, float z ) { SetPosition(Vector3(x,y,z)); }
 
-	Vector3		GetEulerAngles() const { return m_localTransform.GetEulerAngles(); }
+	Vector3		GetEulerAngles() const { return GetLocalTransform().GetEulerAngles(); }
 	void		SetEulerAngles( float x, float y, float z ) { SetEulerAngles(Vector3(x,y,z)); }
 	void		SetEulerAngles( const Vector3& angles );
 
-	Vector3		GetScale() const { return m_localTransform.GetScale(); }
+	Quaternion	GetRotation() const { return GetLocalTransform().GetRotation(); }
+	void		SetRotation( const Quaternion& rotation );
+	void		SetUsesQuaternion( bool usesQuaternion );
+
+	Vector3		GetScale() const { return GetLocalTransform().GetScale(); }
 	void		SetScale( const Vector3& newScale );
 	void		SetScale( float x, float y, float z ) { SetScale(Vector3(x,y,z)); }
 	void		SetScaleUniform( float xyz ) { SetScale(xyz, xyz, xyz); }
 
+	transform_t	GetLocalTransform() const; // A copy, the system moves its storage around
 	Matrix44	GetWorldMatrix() const;
-	Matrix44	GetLocalMatrix();
+	Matrix44	GetLocalMatrix() const;
 	void		SetLocalMatrix( const Matrix44& local );
 	void		SetWorldMatrix( const Matrix44& world );
+	uint32_t	GetVersion() const; // Changes whenever this or a parent moves
+	uint32_t	GetHandle() const { return m_handle; }
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
-	void		RecomputeMatrices( bool isChild = false ) const;
+	void		RecomputeMatrices() const;
 	void		Translate( const Vector3& offset );
 	void		Translate( float x, float y, float z) { Translate(Vector3(x,y,z)); }
 	void		RotateByEuler( const Vector3& rotation );
 	void		RotateByEuler( float x, float y, float z) { RotateByEuler(Vector3(x,y,z)); }
+	void		Rotate( const Quaternion& rotation );
 	void		LookAt( const Vector3& worldPosition, const Vector3& worldUp = Vector3::UP );
 	void		LocalLookAt( const Vector3& localPosition, const Vector3& localUp = Vector3::UP );
 	void		AddChild( Transform* child );
+	void		SetParent( Transform* parent ); // nullptr detaches
 	void		SetDirtyOnHierarchy();
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
 private:
-			transform_t				m_localTransform;
-	mutable	Matrix44				m_localMatrix;
-	mutable	Matrix44				m_worldMatrix;
-	mutable	bool					m_isDirty = true;
-			Transform*				m_parent = nullptr;
-			std::vector<Transform*> m_children;
+			uint32_t				m_handle;
 };
-
@@ -0,0 +1,445 @@
+#include "Engine/Math/TransformSystem.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/MathUtils.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static TransformSystem* g_transformSystem = nullptr;
+
+//-----------------------------------------------------------------------------------------------
+// Reorders a per slot array, order holds the old slot of every new slot
+//
+template <typename T>
+static void PermuteSlots(std::vector<T>& values, const std::vector<uint32_t>& order)
+{
+	std::vector<T> sorted;
+	sorted.reserve(order.size());
+	for(uint32_t oldSlot : order)
+	{
+		sorted.push_back(values[oldSlot]);
+	}
+
+	values.swap(sorted);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+TransformSystem::TransformSystem()
+{
+	m_levelStarts.push_back(0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+TransformSystem::~TransformSystem()
+{
+
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the transform system, transforms call this themselves so it can happen before startup
+//
+STATIC TransformSystem* TransformSystem::CreateInstance()
+{
+	if(g_transformSystem == nullptr)
+	{
+		g_transformSystem = new TransformSystem();
+	}
+
+	return g_transformSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the transform system instance
+//
+STATIC TransformSystem* TransformSystem::GetInstance()
+{
+	return g_transformSystem;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the transform system instance, transforms destroyed after this just let go
+//
+STATIC void TransformSystem::DestroyInstance()
+{
+	if(g_transformSystem)
+	{
+		delete g_transformSystem;
+		g_transformSystem = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the slots [begin, end) of one hierarchy depth, only valid right after a sort
+//
+void TransformSystem::GetDepthRange(int depth, int& out_begin, int& out_end) const
+{
+	GUARANTEE_OR_DIE(depth >= 0 && depth < GetDepthCount(), "Transform depth out of range");
+
+	out_begin = m_levelStarts[depth];
+	out_end = m_levelStarts[depth + 1];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the local TRS for editing and marks the node dirty
+//
+transform_t& TransformSystem::EditLocal(TransformHandle handle)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	m_isLocalDirty[slot] = 1;
+	return m_locals[slot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the local matrix, rebuilding it from the TRS if it changed
+//
+Matrix44 TransformSystem::GetLocalMatrix(TransformHandle handle)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	PrepareSlotForRead(slot);
+	return m_localMatrices[slot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the world matrix, bringing this node and its parents up to date first
+//
+Matrix44 TransformSystem::GetWorldMatrix(TransformHandle handle)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	PrepareSlotForRead(slot);
+	return m_worldMatrices[slot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a number that changes whenever the node or one of its parents moves
+//
+uint32_t TransformSystem::GetWorldVersion(TransformHandle handle)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	PrepareSlotForRead(slot);
+	return m_worldVersions[slot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the parent's handle or INVALID_TRANSFORM for a root
+//
+TransformHandle TransformSystem::GetParent(TransformHandle handle) const
+{
+	uint32_t parentSlot = m_parentSlots[m_slotOfHandle[handle]];
+	return (parentSlot == INVALID_TRANSFORM) ? INVALID_TRANSFORM : m_handleOfSlot[parentSlot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds an identity root node at the end, the next sort moves it in with the other roots
+//
+TransformHandle TransformSystem::CreateNode()
+{
+	TransformHandle handle;
+	if(!m_freeHandles.empty())
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else
+	{
+		handle = (TransformHandle) m_slotOfHandle.size();
+		m_slotOfHandle.push_back(INVALID_TRANSFORM);
+	}
+
+	uint32_t slot = (uint32_t) m_handleOfSlot.size();
+	m_slotOfHandle[handle] = slot;
+
+	m_locals.push_back(transform_t());
+	m_localMatrices.push_back(Matrix44());
+	m_worldMatrices.push_back(Matrix44());
+	m_parentSlots.push_back(INVALID_TRANSFORM);
+	m_worldVersions.push_back(0);
+	m_seenParentVersions.push_back(0);
+	m_childCounts.push_back(0);
+	m_isLocalDirty.push_back(1);
+	m_handleOfSlot.push_back(handle);
+
+	m_isOrderDirty = true;
+	return handle;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Frees the node, its children become roots. The slot is compacted away on the next sort
+//
+void TransformSystem::DestroyNode(TransformHandle handle)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	if(m_childCounts[slot] > 0)
+	{
+		for(uint32_t child = 0; child < (uint32_t) m_parentSlots.size(); ++child)
+		{
+			if(m_parentSlots[child] == slot)
+			{
+				m_parentSlots[child] = INVALID_TRANSFORM;
+				m_isLocalDirty[child] = 1;
+			}
+		}
+	}
+
+	uint32_t parentSlot = m_parentSlots[slot];
+	if(parentSlot != INVALID_TRANSFORM)
+	{
+		m_childCounts[parentSlot]--;
+	}
+
+	m_parentSlots[slot] = INVALID_TRANSFORM;
+	m_childCounts[slot] = 0;
+	m_handleOfSlot[slot] = INVALID_TRANSFORM;
+	m_slotOfHandle[handle] = INVALID_TRANSFORM;
+	m_freeHandles.push_back(handle);
+	m_freeSlotCount++;
+	m_isOrderDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reparents the node keeping its local TRS, INVALID_TRANSFORM makes it a root
+//
+void TransformSystem::SetParent(TransformHandle handle, TransformHandle parent)
+{
+	uint32_t slot = m_slotOfHandle[handle];
+	uint32_t parentSlot = (parent == INVALID_TRANSFORM) ? INVALID_TRANSFORM : m_slotOfHandle[parent];
+	if(m_parentSlots[slot] == parentSlot)
+	{
+		return;
+	}
+
+	// Walk up from the new parent to make sure this would not close a loop
+	for(uint32_t ancestor = parentSlot; ancestor != INVALID_TRANSFORM; ancestor = m_parentSlots[ancestor])
+	{
+		GUARANTEE_OR_DIE(ancestor != slot, "Transform cannot be parented to its own child");
+	}
+
+	if(m_parentSlots[slot] != INVALID_TRANSFORM)
+	{
+		m_childCounts[m_parentSlots[slot]]--;
+	}
+	if(parentSlot != INVALID_TRANSFORM)
+	{
+		m_childCounts[parentSlot]++;
+	}
+
+	m_parentSlots[slot] = parentSlot;
+	m_isLocalDirty[slot] = 1; // The parent's version number means nothing to this node yet
+	m_isOrderDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Brings every world matrix up to date. After the sort parents always come before their
+// children so a single linear sweep is enough. Big hierarchies are split across the job system
+// one depth at a time, the nodes of one depth only read the depth above
+//
+void TransformSystem::UpdateWorldMatrices()
+{
+	SortByDepth();
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if(jobSystem == nullptr || JobSystem::GetThreadIndex() < 0 || GetCount() < TRANSFORM_PARALLEL_MIN_COUNT)
+	{
+		UpdateRange(0, (int) m_handleOfSlot.size());
+		return;
+	}
+
+	for(int depth = 0; depth < GetDepthCount(); ++depth)
+	{
+		int depthBegin;
+		int depthEnd;
+		GetDepthRange(depth, depthBegin, depthEnd);
+		jobSystem->ParallelForRange(depthEnd - depthBegin, [this, depthBegin](int begin, int end)
+		{
+			UpdateRange(depthBegin + begin, depthBegin + end);
+		}, TRANSFORM_PARALLEL_MIN_BATCH);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stable counting sort of the slots by depth, drops destroyed slots. Does nothing if the
+// hierarchy did not change since the last sort
+//
+void TransformSystem::SortByDepth()
+{
+	if(!m_isOrderDirty)
+	{
+		return;
+	}
+
+	uint32_t slotCount = (uint32_t) m_handleOfSlot.size();
+	std::vector<int> depths(slotCount, -1);
+	int maxDepth = -1;
+	for(uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if(m_handleOfSlot[slot] != INVALID_TRANSFORM)
+		{
+			maxDepth = Max(maxDepth, ComputeDepth(slot, depths));
+		}
+	}
+
+	m_levelStarts.assign(maxDepth + 2, 0);
+	for(uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if(m_handleOfSlot[slot] != INVALID_TRANSFORM)
+		{
+			m_levelStarts[depths[slot] + 1]++;
+		}
+	}
+	for(int depth = 1; depth < (int) m_levelStarts.size(); ++depth)
+	{
+		m_levelStarts[depth] += m_levelStarts[depth - 1];
+	}
+
+	std::vector<uint32_t> order(m_levelStarts.back());
+	std::vector<uint32_t> newSlots(slotCount, INVALID_TRANSFORM);
+	std::vector<int> cursors(m_levelStarts.begin(), m_levelStarts.end() - 1);
+	for(uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if(m_handleOfSlot[slot] != INVALID_TRANSFORM)
+		{
+			uint32_t newSlot = (uint32_t) cursors[depths[slot]]++;
+			order[newSlot] = slot;
+			newSlots[slot] = newSlot;
+		}
+	}
+
+	PermuteSlots(m_locals, order);
+	PermuteSlots(m_localMatrices, order);
+	PermuteSlots(m_worldMatrices, order);
+	PermuteSlots(m_parentSlots, order);
+	PermuteSlots(m_worldVersions, order);
+	PermuteSlots(m_seenParentVersions, order);
+	PermuteSlots(m_childCounts, order);
+	PermuteSlots(m_isLocalDirty, order);
+	PermuteSlots(m_handleOfSlot, order);
+
+	for(uint32_t slot = 0; slot < (uint32_t) order.size(); ++slot)
+	{
+		if(m_parentSlots[slot] != INVALID_TRANSFORM)
+		{
+			m_parentSlots[slot] = newSlots[m_parentSlots[slot]];
+		}
+		m_slotOfHandle[m_handleOfSlot[slot]] = slot;
+	}
+
+	m_freeSlotCount = 0;
+	m_isOrderDirty = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Updates a run of slots. Every parent has to be up to date already, which the depth order
+// guarantees for ranges inside one depth once the shallower depths are done
+//
+void TransformSystem::UpdateRange(int beginSlot, int endSlot)
+{
+	for(int slot = beginSlot; slot < endSlot; ++slot)
+	{
+		UpdateSlot((uint32_t) slot);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the node's matrices if its TRS or its parent's world matrix changed
+//
+void TransformSystem::UpdateSlot(uint32_t slot)
+{
+	uint32_t parentSlot = m_parentSlots[slot];
+	bool isParentNewer = parentSlot != INVALID_TRANSFORM && m_seenParentVersions[slot] != m_worldVersions[parentSlot];
+	if(!m_isLocalDirty[slot] && !isParentNewer)
+	{
+		return;
+	}
+
+	if(m_isLocalDirty[slot])
+	{
+		m_localMatrices[slot] = m_locals[slot].GetMatrix();
+		m_isLocalDirty[slot] = 0;
+	}
+
+	if(parentSlot == INVALID_TRANSFORM)
+	{
+		m_worldMatrices[slot] = m_localMatrices[slot];
+	}
+	else
+	{
+		Matrix44::MatrixMultiply(m_worldMatrices[parentSlot], m_localMatrices[slot], m_worldMatrices[slot]);
+		m_seenParentVersions[slot] = m_worldVersions[parentSlot];
+	}
+
+	m_worldVersions[slot]++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lazy path for queries between sweeps, only touches the chain up to the root
+//
+void TransformSystem::UpdateSlotAndParents(uint32_t slot)
+{
+	if(m_parentSlots[slot] != INVALID_TRANSFORM)
+	{
+		UpdateSlotAndParents(m_parentSlots[slot]);
+	}
+
+	UpdateSlot(slot);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the node or one of its parents changed since its world matrix was built
+//
+bool TransformSystem::IsSlotStale(uint32_t slot) const
+{
+	for(; slot != INVALID_TRANSFORM; slot = m_parentSlots[slot])
+	{
+		uint32_t parentSlot = m_parentSlots[slot];
+		if(m_isLocalDirty[slot] || (parentSlot != INVALID_TRANSFORM && m_seenParentVersions[slot] != m_worldVersions[parentSlot]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Brings the node up to date on the main thread. Jobs only get to read, the sweep has to have
+// updated the node already
+//
+void TransformSystem::PrepareSlotForRead(uint32_t slot)
+{
+	if(JobSystem::GetThreadIndex() > 0)
+	{
+		GUARANTEE_OR_DIE(!IsSlotStale(slot), "Stale transform read from a job, run UpdateWorldMatrices before scheduling it");
+		return;
+	}
+
+	UpdateSlotAndParents(slot);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Depth of a slot, memoized since siblings share their parent's chain
+//
+int TransformSystem::ComputeDepth(uint32_t slot, std::vector<int>& depths) const
+{
+	if(depths[slot] < 0)
+	{
+		uint32_t parentSlot = m_parentSlots[slot];
+		depths[slot] = (parentSlot == INVALID_TRANSFORM) ? 0 : ComputeDepth(parentSlot, depths) + 1;
+	}
+
+	return depths[slot];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the transform system, transforms still alive after this just let go of their nodes
+//
+void TransformSystemShutdown()
+{
+	TransformSystem::DestroyInstance();
+}
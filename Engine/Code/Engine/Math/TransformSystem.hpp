@@ -0,0 +1,96 @@
+#pragma once
+#include "Engine/Math/Transform.hpp"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+//-----------------------------------------------------------------------------------------------
+typedef uint32_t TransformHandle;
+constexpr uint32_t INVALID_TRANSFORM = 0xFFFFFFFFu;
+constexpr int TRANSFORM_PARALLEL_MIN_COUNT = 4096;	// Below this the sweep stays on the calling thread
+constexpr int TRANSFORM_PARALLEL_MIN_BATCH = 512;
+
+//-----------------------------------------------------------------------------------------------
+// Owns every transform's data in flat arrays indexed by slot. Slots are kept sorted by hierarchy
+// depth so a parent always comes before its children and one linear sweep brings every world
+// matrix up to date. Handles stay stable while slots move around on a re-sort.
+//
+// Staleness is tracked with versions instead of pushing dirty flags down the tree. A node is
+// stale if its local TRS changed or its parent's world version differs from the one it was
+// built against, so marking a node dirty is O(1) and children pick it up on the next sweep or
+// lazy query.
+//
+// The lazy queries write the matrices they rebuild, so only the main thread may query a stale
+// node. Jobs can read any node UpdateWorldMatrices already brought up to date, asking for a
+// stale one from a job is a fatal error instead of a race
+//
+class TransformSystem
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	TransformSystem();
+	~TransformSystem();
+
+	static	TransformSystem*	CreateInstance();
+	static	TransformSystem*	GetInstance();
+	static	void				DestroyInstance();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int					GetCount() const { return (int) m_handleOfSlot.size() - m_freeSlotCount; }
+			int					GetDepthCount() const { return (int) m_levelStarts.size() - 1; }
+			void				GetDepthRange( int depth, int& out_begin, int& out_end ) const;
+
+			transform_t			GetLocal( TransformHandle handle ) const { return m_locals[m_slotOfHandle[handle]]; } // A copy, slots move on create and sort
+			transform_t&		EditLocal( TransformHandle handle ); // Marks the node dirty
+			Matrix44			GetLocalMatrix( TransformHandle handle );
+			Matrix44			GetWorldMatrix( TransformHandle handle );
+			uint32_t			GetWorldVersion( TransformHandle handle );
+			TransformHandle		GetParent( TransformHandle handle ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			TransformHandle		CreateNode();
+			void				DestroyNode( TransformHandle handle );
+			void				SetParent( TransformHandle handle, TransformHandle parent );
+			void				MarkDirty( TransformHandle handle ) { m_isLocalDirty[m_slotOfHandle[handle]] = 1; }
+
+			void				UpdateWorldMatrices();
+			void				SortByDepth();
+			void				UpdateRange( int beginSlot, int endSlot ); // Disjoint ranges of one depth can run on separate threads
+
+private:
+			void				UpdateSlot( uint32_t slot );
+			void				UpdateSlotAndParents( uint32_t slot );
+			bool				IsSlotStale( uint32_t slot ) const;
+			void				PrepareSlotForRead( uint32_t slot );
+			int					ComputeDepth( uint32_t slot, std::vector<int>& depths ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	// Per slot, sorted by depth after SortByDepth
+	std::vector<transform_t>		m_locals;
+	std::vector<Matrix44>			m_localMatrices;
+	std::vector<Matrix44>			m_worldMatrices;
+	std::vector<uint32_t>			m_parentSlots;
+	std::vector<uint32_t>			m_worldVersions;		// Bumped every time the world matrix is rebuilt
+	std::vector<uint32_t>			m_seenParentVersions;	// Parent's world version the world matrix was built from
+	std::vector<uint32_t>			m_childCounts;
+	std::vector<uint8_t>			m_isLocalDirty;			// Bytes, not bits, so threads can clear their own slots
+	std::vector<TransformHandle>	m_handleOfSlot;			// INVALID_TRANSFORM for destroyed nodes until the next sort
+
+	// Per handle
+	std::vector<uint32_t>			m_slotOfHandle;
+	std::vector<TransformHandle>	m_freeHandles;
+
+	std::vector<int>				m_levelStarts;			// First slot of every depth, plus the end
+	int								m_freeSlotCount = 0;
+	bool							m_isOrderDirty = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void	TransformSystemShutdown();
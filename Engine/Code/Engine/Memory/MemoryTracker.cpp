@@ -0,0 +1,1106 @@
+#include "Engine/Memory/MemoryTracker.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Console/Command.hpp"
+#include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Console/DevConsole.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <DbgHelp.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+#pragma comment(lib, "dbghelp.lib")
+
+//-----------------------------------------------------------------------------------------------
+// Prefix of every tracked block, sits right before the pointer handed out
+//
+struct MemoryHeader
+{
+	uint64_t		m_byteCount;
+	uint32_t		m_offset;			// From the start of the malloc'd block to the user pointer
+	uint32_t		m_magic;
+	eMemoryTag		m_tag;
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	uint32_t		m_frameCount;
+	uint32_t		m_callstackHash;
+	uint64_t		m_allocIndex;
+	MemoryHeader*	m_prev;
+	MemoryHeader*	m_next;
+	void*			m_callstack[MEMORY_TRACKER_CALLSTACK_DEPTH];
+#endif
+};
+
+//-----------------------------------------------------------------------------------------------
+// Counters of one tag, written from any thread
+//
+struct MemoryTagCounters
+{
+	std::atomic<int64_t>	m_bytes;
+	std::atomic<int64_t>	m_count;
+	std::atomic<int64_t>	m_highWaterBytes;
+	std::atomic<uint64_t>	m_totalAllocs;
+	std::atomic<uint64_t>	m_totalFrees;
+	std::atomic<int64_t>	m_deviceBytes;
+	std::atomic<int64_t>	m_deviceHighWaterBytes;
+};
+
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+//-----------------------------------------------------------------------------------------------
+// Copy of a live block taken for the leak report
+//
+struct MemoryLeakBlock
+{
+	uint64_t		m_byteCount;
+	eMemoryTag		m_tag;
+	uint32_t		m_frameCount;
+	uint32_t		m_callstackHash;
+	void*			m_callstack[MEMORY_TRACKER_CALLSTACK_DEPTH];
+};
+
+//-----------------------------------------------------------------------------------------------
+// Live blocks sharing one callstack
+//
+struct MemoryLeakGroup
+{
+	uint64_t					m_byteCount = 0;
+	int							m_count = 0;
+	const MemoryLeakBlock*		m_block = nullptr;		// First of the group, for its callstack
+};
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static MemoryTracker* g_memoryTracker = nullptr;
+static bool s_areCommandsRegistered = false;
+
+static thread_local eMemoryTag t_memoryTag = MEMORY_TAG_UNTAGGED;
+static MemoryTagCounters s_tagCounters[NUM_MEMORY_TAGS];		// Zero before any constructor runs, allocations during static init are counted too
+static std::atomic<uint64_t> s_allocIndex;
+
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+static std::atomic_flag s_liveListLock = ATOMIC_FLAG_INIT;		// Spin lock, a mutex could allocate
+static MemoryHeader* s_liveList = nullptr;
+static std::atomic<bool> s_isCallstackCaptureEnabled;			// Off by default, capturing is slow
+static bool s_areSymbolsLoaded = false;
+#endif
+
+constexpr uint32_t MEMORY_HEADER_MAGIC = 0x4D454D54;	// "MEMT"
+
+static const char* s_memoryTagNames[NUM_MEMORY_TAGS] =
+{
+	"untagged",
+	"engine",
+	"renderer",
+	"texture",
+	"mesh",
+	"material",
+	"shader",
+	"debug_render",
+	"particles",
+	"staging",
+	"audio",
+	"profiler",
+	"console",
+	"game"
+};
+
+//-----------------------------------------------------------------------------------------------
+// Raises a high water mark to value if it is below
+//
+static void UpdateHighWater(std::atomic<int64_t>& highWater, int64_t value)
+{
+	int64_t current = highWater.load(std::memory_order_relaxed);
+	while(value > current && !highWater.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints multi line text one console line at a time
+//
+static void ConsolePrintLines(const std::string& text)
+{
+	size_t lineStart = 0;
+	while(lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if(lineEnd == std::string::npos)
+		{
+			lineEnd = text.size();
+		}
+		ConsolePrintf("%s", text.substr(lineStart, lineEnd - lineStart).c_str());
+		lineStart = lineEnd + 1;
+	}
+}
+
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+//-----------------------------------------------------------------------------------------------
+// Locks the live block list
+//
+static void LockLiveList()
+{
+	while(s_liveListLock.test_and_set(std::memory_order_acquire))
+	{
+		YieldProcessor();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Unlocks the live block list
+//
+static void UnlockLiveList()
+{
+	s_liveListLock.clear(std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a block to the front of the live list
+//
+static void LinkLiveBlock(MemoryHeader* header)
+{
+	LockLiveList();
+	header->m_prev = nullptr;
+	header->m_next = s_liveList;
+	if(s_liveList != nullptr)
+	{
+		s_liveList->m_prev = header;
+	}
+	s_liveList = header;
+	UnlockLiveList();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes a block from the live list
+//
+static void UnlinkLiveBlock(MemoryHeader* header)
+{
+	LockLiveList();
+	if(header->m_prev != nullptr)
+	{
+		header->m_prev->m_next = header->m_next;
+	}
+	else
+	{
+		s_liveList = header->m_next;
+	}
+
+	if(header->m_next != nullptr)
+	{
+		header->m_next->m_prev = header->m_prev;
+	}
+	UnlockLiveList();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends one symbolized frame per line, loads the symbols the first time
+//
+static void AppendCallstackText(std::string& text, void* const* frames, uint32_t frameCount)
+{
+	HANDLE process = GetCurrentProcess();
+	if(!s_areSymbolsLoaded)
+	{
+		SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+		s_areSymbolsLoaded = (SymInitialize(process, nullptr, TRUE) == TRUE);
+	}
+
+	for(uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		DWORD64 address = (DWORD64) frames[frameIndex];
+
+		char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+		SYMBOL_INFO* symbol = (SYMBOL_INFO*) symbolBuffer;
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = MAX_SYM_NAME;
+
+		IMAGEHLP_LINE64 line = {};
+		line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+		DWORD lineDisplacement = 0;
+
+		if(s_areSymbolsLoaded && SymFromAddr(process, address, nullptr, symbol))
+		{
+			if(SymGetLineFromAddr64(process, address, &lineDisplacement, &line))
+			{
+				text += Stringf("      %s  %s(%u)\n", symbol->Name, line.FileName, (unsigned int) line.LineNumber);
+			}
+			else
+			{
+				text += Stringf("      %s\n", symbol->Name);
+			}
+		}
+		else
+		{
+			text += Stringf("      0x%016llx\n", (unsigned long long) address);
+		}
+	}
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+MemoryTracker::MemoryTracker()
+{
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		MemoryTagStats stats = GetMemoryTagStats((eMemoryTag) tagIndex);
+		m_budgets[tagIndex] = 0;
+		m_isBudgetStrict[tagIndex] = false;
+		m_isOverBudget[tagIndex] = false;
+		m_lastTotalAllocs[tagIndex] = stats.m_totalAllocs;
+		m_lastTotalFrees[tagIndex] = stats.m_totalFrees;
+		m_frameAllocs[tagIndex] = 0;
+		m_frameFrees[tagIndex] = 0;
+	}
+
+	if(!s_areCommandsRegistered)
+	{
+		COMMAND("mem_report", MemReportCommand, "Prints memory per tag and device heap");
+		COMMAND("mem_snapshot", MemSnapshotCommand, "Remembers the current memory counters for mem_diff");
+		COMMAND("mem_diff", MemDiffCommand, "Prints what changed since mem_snapshot, [callstacks]");
+		COMMAND("mem_budget", MemBudgetCommand, "Sets a tag's budget, <tag> <megabytes> [strict], 0 removes it");
+		COMMAND("mem_callstacks", MemCallstacksCommand, "Enables/Disables callstack capture of new allocations");
+		s_areCommandsRegistered = true;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+MemoryTracker::~MemoryTracker()
+{
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	if(s_areSymbolsLoaded)
+	{
+		SymCleanup(GetCurrentProcess());
+		s_areSymbolsLoaded = false;
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the memory tracker
+//
+STATIC MemoryTracker* MemoryTracker::CreateInstance()
+{
+	if(g_memoryTracker == nullptr)
+	{
+		MEMORY_TAG_SCOPE(MEMORY_TAG_ENGINE);
+		g_memoryTracker = new MemoryTracker();
+	}
+
+	return g_memoryTracker;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the memory tracker
+//
+STATIC MemoryTracker* MemoryTracker::GetInstance()
+{
+	return g_memoryTracker;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the memory tracker
+//
+STATIC void MemoryTracker::DestroyInstance()
+{
+	if(g_memoryTracker != nullptr)
+	{
+		delete g_memoryTracker;
+		g_memoryTracker = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the bytes a tag may hold, CPU and device memory together
+//
+void MemoryTracker::SetBudget(eMemoryTag tag, int64_t byteCount, bool isStrict)
+{
+	m_budgets[tag] = byteCount;
+	m_isBudgetStrict[tag] = isStrict;
+	m_isOverBudget[tag] = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a copy of a device heap's counters
+//
+MemoryHeapStats MemoryTracker::GetHeapStats(int heapIndex) const
+{
+	std::lock_guard<std::mutex> lock(m_deviceLock);
+	return m_heaps[heapIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Updates the churn of the frame that ended and warns about tags that went over budget
+//
+void MemoryTracker::MarkFrame()
+{
+	++m_frameIndex;
+
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		eMemoryTag tag = (eMemoryTag) tagIndex;
+		MemoryTagStats stats = GetMemoryTagStats(tag);
+
+		m_frameAllocs[tagIndex] = stats.m_totalAllocs - m_lastTotalAllocs[tagIndex];
+		m_frameFrees[tagIndex] = stats.m_totalFrees - m_lastTotalFrees[tagIndex];
+		m_lastTotalAllocs[tagIndex] = stats.m_totalAllocs;
+		m_lastTotalFrees[tagIndex] = stats.m_totalFrees;
+
+		if(m_budgets[tagIndex] <= 0)
+		{
+			continue;
+		}
+
+		int64_t usedBytes = stats.m_bytes + stats.m_deviceBytes;
+		bool isOverBudget = (usedBytes > m_budgets[tagIndex]);
+		if(isOverBudget && !m_isOverBudget[tagIndex])
+		{
+			std::string message = Stringf("Memory tag %s is over budget: %s of %s", GetMemoryTagName(tag),
+				GetMemorySizeString(usedBytes).c_str(), GetMemorySizeString(m_budgets[tagIndex]).c_str());
+			ConsolePrintf(Rgba::YELLOW, "%s", message.c_str());
+			DebuggerPrintf("%s\n", message.c_str());
+
+			if(m_isBudgetStrict[tagIndex])
+			{
+				ERROR_RECOVERABLE(message);
+			}
+		}
+
+		m_isOverBudget[tagIndex] = isOverBudget;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the counters of every tag
+//
+void MemoryTracker::TakeSnapshot(MemorySnapshot& out_snapshot) const
+{
+	out_snapshot.m_allocIndex = s_allocIndex.load();
+	out_snapshot.m_frameIndex = m_frameIndex;
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		out_snapshot.m_tags[tagIndex] = GetMemoryTagStats((eMemoryTag) tagIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a table of every tag in use and of the device heaps
+//
+std::string MemoryTracker::GetReportText() const
+{
+	std::string text = Stringf("%-14s %12s %10s %12s %12s %12s %8s %8s\n",
+		"Tag", "Bytes", "Count", "Peak", "Device", "Budget", "Allocs", "Frees");
+
+	MemoryTagStats total;
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		eMemoryTag tag = (eMemoryTag) tagIndex;
+		MemoryTagStats stats = GetMemoryTagStats(tag);
+		total.m_bytes += stats.m_bytes;
+		total.m_count += stats.m_count;
+		total.m_deviceBytes += stats.m_deviceBytes;
+
+		if(stats.m_totalAllocs == 0 && stats.m_deviceHighWaterBytes == 0 && m_budgets[tagIndex] == 0)
+		{
+			continue;
+		}
+
+		std::string budget = (m_budgets[tagIndex] > 0) ? GetMemorySizeString(m_budgets[tagIndex]) : "-";
+		text += Stringf("%-14s %12s %10lld %12s %12s %12s %8llu %8llu%s\n",
+			GetMemoryTagName(tag),
+			GetMemorySizeString(stats.m_bytes).c_str(),
+			(long long) stats.m_count,
+			GetMemorySizeString(stats.m_highWaterBytes).c_str(),
+			GetMemorySizeString(stats.m_deviceBytes).c_str(),
+			budget.c_str(),
+			(unsigned long long) m_frameAllocs[tagIndex],
+			(unsigned long long) m_frameFrees[tagIndex],
+			m_isOverBudget[tagIndex] ? "  OVER" : "");
+	}
+
+	text += Stringf("%-14s %12s %10lld %12s %12s\n", "total",
+		GetMemorySizeString(total.m_bytes).c_str(), (long long) total.m_count, "",
+		GetMemorySizeString(total.m_deviceBytes).c_str());
+
+	std::lock_guard<std::mutex> lock(m_deviceLock);
+	for(int heapIndex = 0; heapIndex < m_heapCount; ++heapIndex)
+	{
+		const MemoryHeapStats& heap = m_heaps[heapIndex];
+		text += Stringf("Heap %d (%s): %s of %s, peak %s, %d allocations\n",
+			heapIndex,
+			heap.m_isDeviceLocal ? "device" : "host",
+			GetMemorySizeString(heap.m_bytes).c_str(),
+			GetMemorySizeString((int64_t) heap.m_size).c_str(),
+			GetMemorySizeString(heap.m_highWaterBytes).c_str(),
+			heap.m_allocationCount);
+	}
+
+	return text;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns what changed per tag since the snapshot, followed by the blocks allocated since then
+// that are still alive
+//
+std::string MemoryTracker::GetDiffText(const MemorySnapshot& snapshot, int maxCallstacks) const
+{
+	std::string text = Stringf("Since frame %llu (%llu frames):\n",
+		(unsigned long long) snapshot.m_frameIndex, (unsigned long long) (m_frameIndex - snapshot.m_frameIndex));
+	text += Stringf("%-14s %12s %10s %12s %10s %10s\n", "Tag", "Bytes", "Count", "Device", "Allocs", "Frees");
+
+	bool hasChanges = false;
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		eMemoryTag tag = (eMemoryTag) tagIndex;
+		MemoryTagStats stats = GetMemoryTagStats(tag);
+		const MemoryTagStats& before = snapshot.m_tags[tagIndex];
+
+		uint64_t allocs = stats.m_totalAllocs - before.m_totalAllocs;
+		uint64_t frees = stats.m_totalFrees - before.m_totalFrees;
+		int64_t deviceBytes = stats.m_deviceBytes - before.m_deviceBytes;
+		if(allocs == 0 && frees == 0 && deviceBytes == 0)
+		{
+			continue;
+		}
+
+		text += Stringf("%-14s %12s %+10lld %12s %10llu %10llu\n",
+			GetMemoryTagName(tag),
+			GetMemorySizeString(stats.m_bytes - before.m_bytes).c_str(),
+			(long long) (stats.m_count - before.m_count),
+			GetMemorySizeString(deviceBytes).c_str(),
+			(unsigned long long) allocs,
+			(unsigned long long) frees);
+		hasChanges = true;
+	}
+
+	if(!hasChanges)
+	{
+		text += "No changes\n";
+	}
+
+	text += GetLeakText(snapshot.m_allocIndex, maxCallstacks);
+	return text;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the size of a device heap, called by the renderer once it knows its device
+//
+void MemoryTracker::SetDeviceHeap(int heapIndex, uint64_t byteCount, bool isDeviceLocal)
+{
+	GUARANTEE_OR_DIE(heapIndex >= 0 && heapIndex < MEMORY_MAX_DEVICE_HEAPS, "Device heap index out of range");
+
+	std::lock_guard<std::mutex> lock(m_deviceLock);
+	m_heaps[heapIndex].m_size = byteCount;
+	m_heaps[heapIndex].m_isDeviceLocal = isDeviceLocal;
+	m_heapCount = Max(m_heapCount, heapIndex + 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Charges a device memory allocation to a tag and heap, ignored without a tracker
+//
+STATIC void MemoryTracker::TrackDeviceAlloc(uint64_t handle, uint64_t byteCount, int heapIndex, eMemoryTag tag)
+{
+	if(g_memoryTracker != nullptr)
+	{
+		g_memoryTracker->AddDeviceAlloc(handle, byteCount, heapIndex, tag);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Releases a device memory allocation, handles the tracker never saw are ignored
+//
+STATIC void MemoryTracker::TrackDeviceFree(uint64_t handle)
+{
+	if(g_memoryTracker != nullptr)
+	{
+		g_memoryTracker->RemoveDeviceAlloc(handle);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a device allocation to the counters
+//
+void MemoryTracker::AddDeviceAlloc(uint64_t handle, uint64_t byteCount, int heapIndex, eMemoryTag tag)
+{
+	GUARANTEE_OR_DIE(heapIndex >= 0 && heapIndex < MEMORY_MAX_DEVICE_HEAPS, "Device heap index out of range");
+
+	MemoryDeviceAllocation allocation;
+	allocation.m_byteCount = byteCount;
+	allocation.m_heapIndex = heapIndex;
+	allocation.m_tag = tag;
+
+	std::lock_guard<std::mutex> lock(m_deviceLock);
+	m_deviceAllocations[handle] = allocation;
+
+	MemoryHeapStats& heap = m_heaps[heapIndex];
+	heap.m_bytes += (int64_t) byteCount;
+	heap.m_highWaterBytes = std::max(heap.m_highWaterBytes, heap.m_bytes);
+	++heap.m_allocationCount;
+	m_heapCount = Max(m_heapCount, heapIndex + 1);
+
+	MemoryTagCounters& counters = s_tagCounters[tag];
+	int64_t deviceBytes = counters.m_deviceBytes.fetch_add((int64_t) byteCount) + (int64_t) byteCount;
+	UpdateHighWater(counters.m_deviceHighWaterBytes, deviceBytes);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes a device allocation from the counters
+//
+void MemoryTracker::RemoveDeviceAlloc(uint64_t handle)
+{
+	std::lock_guard<std::mutex> lock(m_deviceLock);
+	std::map<uint64_t, MemoryDeviceAllocation>::iterator found = m_deviceAllocations.find(handle);
+	if(found == m_deviceAllocations.end())
+	{
+		return;
+	}
+
+	const MemoryDeviceAllocation& allocation = found->second;
+	MemoryHeapStats& heap = m_heaps[allocation.m_heapIndex];
+	heap.m_bytes -= (int64_t) allocation.m_byteCount;
+	--heap.m_allocationCount;
+	s_tagCounters[allocation.m_tag].m_deviceBytes -= (int64_t) allocation.m_byteCount;
+
+	m_deviceAllocations.erase(found);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the live blocks allocated after the given index, grouped by callstack with the biggest
+// groups first
+//
+std::string MemoryTracker::GetLeakText(uint64_t sinceAllocIndex, int maxCallstacks) const
+{
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	// Count first so the copy can be reserved outside the lock, allocating under it would deadlock
+	size_t blockCount = 0;
+	LockLiveList();
+	for(const MemoryHeader* header = s_liveList; header != nullptr; header = header->m_next)
+	{
+		if(header->m_allocIndex >= sinceAllocIndex)
+		{
+			++blockCount;
+		}
+	}
+	UnlockLiveList();
+
+	std::vector<MemoryLeakBlock> blocks;
+	blocks.reserve(blockCount + 1024); // Other threads may allocate meanwhile, extra blocks past the capacity are skipped
+
+	LockLiveList();
+	for(const MemoryHeader* header = s_liveList; header != nullptr && blocks.size() < blocks.capacity(); header = header->m_next)
+	{
+		if(header->m_allocIndex < sinceAllocIndex)
+		{
+			continue;
+		}
+
+		MemoryLeakBlock block;
+		block.m_byteCount = header->m_byteCount;
+		block.m_tag = header->m_tag;
+		block.m_frameCount = header->m_frameCount;
+		block.m_callstackHash = header->m_callstackHash;
+		memcpy(block.m_callstack, header->m_callstack, sizeof(block.m_callstack));
+		blocks.push_back(block);
+	}
+	UnlockLiveList();
+
+	if(blocks.empty())
+	{
+		return "No live allocations since the snapshot\n";
+	}
+
+	// Blocks without a callstack are grouped per tag
+	std::map<uint64_t, MemoryLeakGroup> groupsByKey;
+	uint64_t totalBytes = 0;
+	for(const MemoryLeakBlock& block : blocks)
+	{
+		uint64_t key = (block.m_frameCount > 0) ? (((uint64_t) block.m_callstackHash << 8) | block.m_tag) : ((1ULL << 40) | block.m_tag);
+		MemoryLeakGroup& group = groupsByKey[key];
+		if(group.m_block == nullptr)
+		{
+			group.m_block = &block;
+		}
+		group.m_byteCount += block.m_byteCount;
+		++group.m_count;
+		totalBytes += block.m_byteCount;
+	}
+
+	std::vector<MemoryLeakGroup> groups;
+	groups.reserve(groupsByKey.size());
+	for(const std::pair<const uint64_t, MemoryLeakGroup>& entry : groupsByKey)
+	{
+		groups.push_back(entry.second);
+	}
+	std::sort(groups.begin(), groups.end(), [](const MemoryLeakGroup& a, const MemoryLeakGroup& b) { return a.m_byteCount > b.m_byteCount; });
+
+	std::string text = Stringf("%d live allocations since the snapshot, %s in %d callstacks:\n",
+		(int) blocks.size(), GetMemorySizeString((int64_t) totalBytes).c_str(), (int) groups.size());
+
+	int groupCount = ClampInt((int) groups.size(), 0, Max(maxCallstacks, 0));
+	for(int groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+	{
+		const MemoryLeakGroup& group = groups[groupIndex];
+		text += Stringf("  %s in %d blocks, %s\n",
+			GetMemorySizeString((int64_t) group.m_byteCount).c_str(), group.m_count, GetMemoryTagName(group.m_block->m_tag));
+
+		if(group.m_block->m_frameCount > 0)
+		{
+			AppendCallstackText(text, group.m_block->m_callstack, group.m_block->m_frameCount);
+		}
+		else
+		{
+			text += "      No callstack, enable mem_callstacks before the snapshot\n";
+		}
+	}
+
+	return text;
+#else
+	UNUSED(sinceAllocIndex);
+	UNUSED(maxCallstacks);
+	return "Live allocations are only listed in builds with MEMORY_TRACKER_CALLSTACK_DEPTH\n";
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints memory per tag and device heap
+//
+STATIC bool MemoryTracker::MemReportCommand(Command& cmd)
+{
+	UNUSED(cmd);
+	MemoryTracker* tracker = MemoryTracker::GetInstance();
+	if(tracker == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The memory tracker is not running");
+		return false;
+	}
+
+	ConsolePrintLines(tracker->GetReportText());
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Remembers the current counters for mem_diff
+//
+STATIC bool MemoryTracker::MemSnapshotCommand(Command& cmd)
+{
+	UNUSED(cmd);
+	MemoryTracker* tracker = MemoryTracker::GetInstance();
+	if(tracker == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The memory tracker is not running");
+		return false;
+	}
+
+	tracker->TakeSnapshot(tracker->m_snapshot);
+	tracker->m_hasSnapshot = true;
+	ConsolePrintf("Memory snapshot taken at frame %llu", (unsigned long long) tracker->m_snapshot.m_frameIndex);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints what changed since mem_snapshot
+//
+STATIC bool MemoryTracker::MemDiffCommand(Command& cmd)
+{
+	MemoryTracker* tracker = MemoryTracker::GetInstance();
+	if(tracker == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The memory tracker is not running");
+		return false;
+	}
+
+	if(!tracker->m_hasSnapshot)
+	{
+		ConsolePrintf(Rgba::RED, "No snapshot to diff against, run mem_snapshot first");
+		return false;
+	}
+
+	int maxCallstacks = 8;
+	cmd.GetNextInt(maxCallstacks);
+
+	ConsolePrintLines(tracker->GetDiffText(tracker->m_snapshot, maxCallstacks));
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets a tag's budget in megabytes
+//
+STATIC bool MemoryTracker::MemBudgetCommand(Command& cmd)
+{
+	MemoryTracker* tracker = MemoryTracker::GetInstance();
+	if(tracker == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The memory tracker is not running");
+		return false;
+	}
+
+	std::string tagName = cmd.GetNextString();
+	eMemoryTag tag;
+	if(!ParseMemoryTag(tagName, tag))
+	{
+		ConsolePrintf(Rgba::RED, "Unknown memory tag \"%s\"", tagName.c_str());
+		return false;
+	}
+
+	float megabytes = 0.f;
+	if(!cmd.GetNextFloat(megabytes) || megabytes < 0.f)
+	{
+		ConsolePrintf(Rgba::RED, "mem_budget needs a size in megabytes");
+		return false;
+	}
+
+	bool isStrict = (cmd.GetNextString() == "strict");
+	int64_t byteCount = (int64_t) ((double) megabytes * 1024.0 * 1024.0);
+	tracker->SetBudget(tag, byteCount, isStrict);
+
+	if(byteCount > 0)
+	{
+		ConsolePrintf("Budget of %s set to %s%s", GetMemoryTagName(tag), GetMemorySizeString(byteCount).c_str(), isStrict ? ", strict" : "");
+	}
+	else
+	{
+		ConsolePrintf("Budget of %s removed", GetMemoryTagName(tag));
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Enables/Disables callstack capture of new allocations
+//
+STATIC bool MemoryTracker::MemCallstacksCommand(Command& cmd)
+{
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	bool isEnabled = !s_isCallstackCaptureEnabled.load();
+	cmd.GetNextBool(isEnabled);
+	s_isCallstackCaptureEnabled = isEnabled;
+
+	ConsolePrintf("Allocation callstacks %s", isEnabled ? "enabled" : "disabled");
+	return true;
+#else
+	UNUSED(cmd);
+	ConsolePrintf(Rgba::RED, "Callstacks are only captured in builds with MEMORY_TRACKER_CALLSTACK_DEPTH");
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the calling thread's tag
+//
+MemoryTagScope::MemoryTagScope(eMemoryTag tag)
+{
+	m_previousTag = SetCurrentMemoryTag(tag);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Restores the calling thread's tag
+//
+MemoryTagScope::~MemoryTagScope()
+{
+	SetCurrentMemoryTag(m_previousTag);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Allocates a block charged to the tag. The header goes in front of the user pointer, padded so
+// the pointer keeps the requested alignment
+//
+void* TrackedAlloc(size_t byteCount, eMemoryTag tag, size_t alignment)
+{
+	alignment = std::max(alignment, MEMORY_DEFAULT_ALIGNMENT);
+	size_t headerSpace = (sizeof(MemoryHeader) + MEMORY_DEFAULT_ALIGNMENT - 1) & ~(MEMORY_DEFAULT_ALIGNMENT - 1);
+	size_t alignmentSpace = alignment - MEMORY_DEFAULT_ALIGNMENT;
+
+	unsigned char* block = (unsigned char*) malloc(headerSpace + alignmentSpace + byteCount);
+	if(block == nullptr)
+	{
+		return nullptr;
+	}
+
+	uintptr_t user = ((uintptr_t) block + headerSpace + alignment - 1) & ~((uintptr_t) alignment - 1);
+	MemoryHeader* header = ((MemoryHeader*) user) - 1;
+	header->m_byteCount = byteCount;
+	header->m_offset = (uint32_t) (user - (uintptr_t) block);
+	header->m_magic = MEMORY_HEADER_MAGIC;
+	header->m_tag = tag;
+
+	uint64_t allocIndex = s_allocIndex.fetch_add(1, std::memory_order_relaxed);
+	MemoryTagCounters& counters = s_tagCounters[tag];
+	int64_t bytes = counters.m_bytes.fetch_add((int64_t) byteCount, std::memory_order_relaxed) + (int64_t) byteCount;
+	counters.m_count.fetch_add(1, std::memory_order_relaxed);
+	counters.m_totalAllocs.fetch_add(1, std::memory_order_relaxed);
+	UpdateHighWater(counters.m_highWaterBytes, bytes);
+
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	header->m_allocIndex = allocIndex;
+	header->m_frameCount = 0;
+	header->m_callstackHash = 0;
+	if(s_isCallstackCaptureEnabled.load(std::memory_order_relaxed))
+	{
+		DWORD callstackHash = 0;
+		header->m_frameCount = CaptureStackBackTrace(1, MEMORY_TRACKER_CALLSTACK_DEPTH, header->m_callstack, &callstackHash);
+		header->m_callstackHash = callstackHash;
+	}
+	LinkLiveBlock(header);
+#else
+	UNUSED(allocIndex);
+#endif
+
+	return (void*) user;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Frees a block from TrackedAlloc
+//
+void TrackedFree(void* ptr)
+{
+	if(ptr == nullptr)
+	{
+		return;
+	}
+
+	MemoryHeader* header = ((MemoryHeader*) ptr) - 1;
+	GUARANTEE_OR_DIE(header->m_magic == MEMORY_HEADER_MAGIC, "Freeing memory the memory tracker did not allocate");
+
+	MemoryTagCounters& counters = s_tagCounters[header->m_tag];
+	counters.m_bytes.fetch_sub((int64_t) header->m_byteCount, std::memory_order_relaxed);
+	counters.m_count.fetch_sub(1, std::memory_order_relaxed);
+	counters.m_totalFrees.fetch_add(1, std::memory_order_relaxed);
+
+#if MEMORY_TRACKER_CALLSTACK_DEPTH > 0
+	UnlinkLiveBlock(header);
+#endif
+
+	header->m_magic = 0;
+	free((unsigned char*) ptr - header->m_offset);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the calling thread's tag
+//
+eMemoryTag GetCurrentMemoryTag()
+{
+	return t_memoryTag;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the calling thread's tag and returns the one it replaces
+//
+eMemoryTag SetCurrentMemoryTag(eMemoryTag tag)
+{
+	eMemoryTag previousTag = t_memoryTag;
+	t_memoryTag = tag;
+	return previousTag;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a copy of a tag's counters
+//
+MemoryTagStats GetMemoryTagStats(eMemoryTag tag)
+{
+	const MemoryTagCounters& counters = s_tagCounters[tag];
+
+	MemoryTagStats stats;
+	stats.m_bytes = counters.m_bytes.load(std::memory_order_relaxed);
+	stats.m_count = counters.m_count.load(std::memory_order_relaxed);
+	stats.m_highWaterBytes = counters.m_highWaterBytes.load(std::memory_order_relaxed);
+	stats.m_totalAllocs = counters.m_totalAllocs.load(std::memory_order_relaxed);
+	stats.m_totalFrees = counters.m_totalFrees.load(std::memory_order_relaxed);
+	stats.m_deviceBytes = counters.m_deviceBytes.load(std::memory_order_relaxed);
+	stats.m_deviceHighWaterBytes = counters.m_deviceHighWaterBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the console name of a tag
+//
+const char* GetMemoryTagName(eMemoryTag tag)
+{
+	return (tag < NUM_MEMORY_TAGS) ? s_memoryTagNames[tag] : "invalid";
+}
+
+//-----------------------------------------------------------------------------------------------
+// Finds a tag by its console name
+//
+bool ParseMemoryTag(const std::string& name, eMemoryTag& out_tag)
+{
+	for(int tagIndex = 0; tagIndex < NUM_MEMORY_TAGS; ++tagIndex)
+	{
+		if(name == s_memoryTagNames[tagIndex])
+		{
+			out_tag = (eMemoryTag) tagIndex;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a byte count in the largest unit that keeps it above 1
+//
+std::string GetMemorySizeString(int64_t byteCount)
+{
+	const char* sign = (byteCount < 0) ? "-" : "";
+	uint64_t magnitude = (byteCount < 0) ? (uint64_t) -byteCount : (uint64_t) byteCount;
+
+	if(magnitude >= 1024ULL * 1024ULL * 1024ULL)
+	{
+		return Stringf("%s%.2f GB", sign, (double) magnitude / (1024.0 * 1024.0 * 1024.0));
+	}
+	else if(magnitude >= 1024ULL * 1024ULL)
+	{
+		return Stringf("%s%.2f MB", sign, (double) magnitude / (1024.0 * 1024.0));
+	}
+	else if(magnitude >= 1024ULL)
+	{
+		return Stringf("%s%.1f KB", sign, (double) magnitude / 1024.0);
+	}
+
+	return Stringf("%s%llu B", sign, (unsigned long long) magnitude);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts the memory tracker
+//
+void MemoryTrackerStartup()
+{
+	MemoryTracker::CreateInstance();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Shuts down the memory tracker
+//
+void MemoryTrackerShutdown()
+{
+	MemoryTracker::DestroyInstance();
+}
+
+#if defined(ENGINE_ENABLE_MEMORY_TRACKING)
+//-----------------------------------------------------------------------------------------------
+// Global new and delete, charged to the calling thread's tag
+//
+void* operator new(size_t byteCount)
+{
+	void* ptr = TrackedAlloc(byteCount, t_memoryTag);
+	if(ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+//
+void* operator new[](size_t byteCount)
+{
+	return operator new(byteCount);
+}
+
+//
+void* operator new(size_t byteCount, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(byteCount, t_memoryTag);
+}
+
+//
+void* operator new[](size_t byteCount, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(byteCount, t_memoryTag);
+}
+
+//
+void operator delete(void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete[](void* ptr) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete(void* ptr, size_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete[](void* ptr, size_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	TrackedFree(ptr);
+}
+
+#if defined(__cpp_aligned_new)
+//-----------------------------------------------------------------------------------------------
+// Over aligned new and delete, only called when the compiler runs C++17
+//
+void* operator new(size_t byteCount, std::align_val_t alignment)
+{
+	void* ptr = TrackedAlloc(byteCount, t_memoryTag, (size_t) alignment);
+	if(ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+//
+void* operator new[](size_t byteCount, std::align_val_t alignment)
+{
+	return operator new(byteCount, alignment);
+}
+
+//
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+	TrackedFree(ptr);
+}
+
+//
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+	TrackedFree(ptr);
+}
+#endif
+#endif
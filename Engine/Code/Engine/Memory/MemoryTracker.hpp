@@ -0,0 +1,184 @@
+#pragma once
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Enumerations/MemoryTag.hpp"
+#include <map>
+#include <mutex>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Command;
+
+//-----------------------------------------------------------------------------------------------
+constexpr size_t	MEMORY_DEFAULT_ALIGNMENT = 2 * sizeof(void*);	// What malloc and the default operator new give
+constexpr int		MEMORY_MAX_DEVICE_HEAPS = 16;		// VK_MAX_MEMORY_HEAPS
+
+//-----------------------------------------------------------------------------------------------
+// Counters of one tag. CPU counters come from the tagged allocator, device counters from the
+// renderer's device memory allocations
+//
+struct MemoryTagStats
+{
+	int64_t		m_bytes = 0;
+	int64_t		m_count = 0;
+	int64_t		m_highWaterBytes = 0;
+	uint64_t	m_totalAllocs = 0;		// Since startup, churn is the difference between two reads
+	uint64_t	m_totalFrees = 0;
+	int64_t		m_deviceBytes = 0;
+	int64_t		m_deviceHighWaterBytes = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Device memory of one heap
+//
+struct MemoryHeapStats
+{
+	uint64_t	m_size = 0;
+	int64_t		m_bytes = 0;
+	int64_t		m_highWaterBytes = 0;
+	int			m_allocationCount = 0;
+	bool		m_isDeviceLocal = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Counters of every tag at one point in time, diffed against a later point to find leaks and
+// churn
+//
+struct MemorySnapshot
+{
+	uint64_t		m_allocIndex = 0;		// Allocations after this one are new since the snapshot
+	uint64_t		m_frameIndex = 0;
+	MemoryTagStats	m_tags[NUM_MEMORY_TAGS];
+};
+
+//-----------------------------------------------------------------------------------------------
+// Device memory allocation the tracker knows the size of
+//
+struct MemoryDeviceAllocation
+{
+	uint64_t	m_byteCount = 0;
+	int			m_heapIndex = 0;
+	eMemoryTag	m_tag = MEMORY_TAG_UNTAGGED;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Tagged allocation layer. Every tracked block carries a small header with its size and tag,
+// so counters stay exact without a lookup on free. Global new and delete charge the calling
+// thread's current tag, classes can pin their own tag with MEMORY_TAG_CLASS. In builds with
+// MEMORY_TRACKER_CALLSTACK_DEPTH, live blocks are linked together and can record callstacks so a
+// snapshot diff can name what leaked. The tracker instance adds per frame churn, budgets, device
+// memory and the console commands on top of the counters, which work before it exists
+//
+class MemoryTracker
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	MemoryTracker();
+	~MemoryTracker();
+
+	static	MemoryTracker*		CreateInstance();
+	static	MemoryTracker*		GetInstance();
+	static	void				DestroyInstance();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			void				SetBudget( eMemoryTag tag, int64_t byteCount, bool isStrict = false ); // 0 removes it, strict raises an error when exceeded
+			int64_t				GetBudget( eMemoryTag tag ) const { return m_budgets[tag]; }
+			uint64_t			GetFrameAllocs( eMemoryTag tag ) const { return m_frameAllocs[tag]; }
+			uint64_t			GetFrameFrees( eMemoryTag tag ) const { return m_frameFrees[tag]; }
+			MemoryHeapStats		GetHeapStats( int heapIndex ) const;
+			int					GetHeapCount() const { return m_heapCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				MarkFrame(); // Main thread, updates churn and checks the budgets
+			void				TakeSnapshot( MemorySnapshot& out_snapshot ) const;
+			std::string			GetReportText() const;
+			std::string			GetDiffText( const MemorySnapshot& snapshot, int maxCallstacks = 8 ) const;
+
+			void				SetDeviceHeap( int heapIndex, uint64_t byteCount, bool isDeviceLocal );
+	static	void				TrackDeviceAlloc( uint64_t handle, uint64_t byteCount, int heapIndex, eMemoryTag tag );
+	static	void				TrackDeviceFree( uint64_t handle );
+
+	//-----------------------------------------------------------------------------------------------
+	// Command Callbacks
+	static	bool				MemReportCommand( Command& cmd );
+	static	bool				MemSnapshotCommand( Command& cmd );
+	static	bool				MemDiffCommand( Command& cmd );
+	static	bool				MemBudgetCommand( Command& cmd );
+	static	bool				MemCallstacksCommand( Command& cmd );
+
+private:
+			void				AddDeviceAlloc( uint64_t handle, uint64_t byteCount, int heapIndex, eMemoryTag tag );
+			void				RemoveDeviceAlloc( uint64_t handle );
+			std::string			GetLeakText( uint64_t sinceAllocIndex, int maxCallstacks ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			int64_t								m_budgets[NUM_MEMORY_TAGS];
+			bool								m_isBudgetStrict[NUM_MEMORY_TAGS];
+			bool								m_isOverBudget[NUM_MEMORY_TAGS];	// Warned once until it drops below again
+			uint64_t							m_lastTotalAllocs[NUM_MEMORY_TAGS];
+			uint64_t							m_lastTotalFrees[NUM_MEMORY_TAGS];
+			uint64_t							m_frameAllocs[NUM_MEMORY_TAGS];		// During the last marked frame
+			uint64_t							m_frameFrees[NUM_MEMORY_TAGS];
+			uint64_t							m_frameIndex = 0;
+
+		mutable	std::mutex							m_deviceLock;		// Guards the device allocations and heaps
+			std::map<uint64_t, MemoryDeviceAllocation>	m_deviceAllocations;
+			MemoryHeapStats						m_heaps[MEMORY_MAX_DEVICE_HEAPS];
+			int									m_heapCount = 0;
+
+			MemorySnapshot						m_snapshot;
+			bool								m_hasSnapshot = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Sets the calling thread's tag for its lifetime
+//
+class MemoryTagScope
+{
+public:
+	explicit MemoryTagScope( eMemoryTag tag );
+	~MemoryTagScope();
+	MemoryTagScope( const MemoryTagScope& ) = delete;
+	void operator=( const MemoryTagScope& ) = delete;
+
+private:
+	eMemoryTag	m_previousTag;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions, usable before the tracker is created
+void*				TrackedAlloc( size_t byteCount, eMemoryTag tag, size_t alignment = MEMORY_DEFAULT_ALIGNMENT );
+void				TrackedFree( void* ptr );
+eMemoryTag			GetCurrentMemoryTag();
+eMemoryTag			SetCurrentMemoryTag( eMemoryTag tag ); // Returns the previous tag
+MemoryTagStats		GetMemoryTagStats( eMemoryTag tag );
+const char*			GetMemoryTagName( eMemoryTag tag );
+bool				ParseMemoryTag( const std::string& name, eMemoryTag& out_tag );
+std::string			GetMemorySizeString( int64_t byteCount );
+void				MemoryTrackerStartup();
+void				MemoryTrackerShutdown();
+
+//-----------------------------------------------------------------------------------------------
+// Macros
+#define MEMORY_JOIN_IMPL(a, b)		a##b
+#define MEMORY_JOIN(a, b)			MEMORY_JOIN_IMPL(a, b)
+
+#if defined(ENGINE_ENABLE_MEMORY_TRACKING)
+#define MEMORY_TAG_SCOPE(tag)		MemoryTagScope MEMORY_JOIN(memoryTagScope_, __LINE__)(tag)
+
+// Charges every instance of the class to the tag, use in a public section
+#define MEMORY_TAG_CLASS(tag)																		\
+	static void* operator new( size_t byteCount ) { return TrackedAlloc(byteCount, tag); }			\
+	static void* operator new[]( size_t byteCount ) { return TrackedAlloc(byteCount, tag); }		\
+	static void operator delete( void* ptr ) { TrackedFree(ptr); }									\
+	static void operator delete[]( void* ptr ) { TrackedFree(ptr); }
+#else
+#define MEMORY_TAG_SCOPE(tag)
+#define MEMORY_TAG_CLASS(tag)
+#endif
@@ -0,0 +1,208 @@
+#include "Engine/Profiler/ProfileReport.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Column header shared by both layouts
+static const char* REPORT_HEADER = "%-48s %7s %11s %8s %11s %8s\n";
+static const char* REPORT_LINE = "%-48s %7u %8.3f ms %7.2f%% %8.3f ms %7.2f%%\n";
+
+//-----------------------------------------------------------------------------------------------
+// Appends one formatted row
+//
+static void AppendRow(std::string& out_text, const std::string& label, uint32_t calls, uint64_t totalHpc, uint64_t selfHpc, uint64_t frameHpc)
+{
+	double totalMs = Time::HpcToSeconds(totalHpc) * 1000.0;
+	double selfMs = Time::HpcToSeconds(selfHpc) * 1000.0;
+	double totalPercent = frameHpc ? (100.0 * (double) totalHpc / (double) frameHpc) : 0.0;
+	double selfPercent = frameHpc ? (100.0 * (double) selfHpc / (double) frameHpc) : 0.0;
+
+	char line[256];
+	snprintf(line, sizeof(line), REPORT_LINE, label.c_str(), calls, totalMs, totalPercent, selfMs, selfPercent);
+	out_text.append(line);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the column header
+//
+static void AppendHeader(std::string& out_text)
+{
+	char line[256];
+	snprintf(line, sizeof(line), REPORT_HEADER, "Scope", "Calls", "Total", "Total%", "Self", "Self%");
+	out_text.append(line);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfileReport::ProfileReport()
+{
+	Reset(0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Drops every node but the root, keeps the memory for the next frame
+//
+void ProfileReport::Reset(uint64_t frameHpc)
+{
+	m_nodes.clear();
+
+	ProfileReportNode root;
+	root.m_name = PROFILER_START_FRAME_TEXT;
+	root.m_callCount = 1;
+	root.m_totalHpc = frameHpc;
+	m_nodes.push_back(root);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the child of parent with the name, adds it if the path was not seen this frame.
+// Names are usually literals, so the pointer compare catches almost every match
+//
+int ProfileReport::FindOrAddChild(int parent, const char* name)
+{
+	int lastChild = -1;
+	for(int child = m_nodes[parent].m_firstChild; child >= 0; child = m_nodes[child].m_nextSibling)
+	{
+		const char* childName = m_nodes[child].m_name;
+		if(childName == name || strcmp(childName, name) == 0)
+		{
+			return child;
+		}
+		lastChild = child;
+	}
+
+	ProfileReportNode node;
+	node.m_name = name;
+	node.m_parent = parent;
+	int index = (int) m_nodes.size();
+	m_nodes.push_back(node);
+
+	if(lastChild < 0)
+	{
+		m_nodes[parent].m_firstChild = index;
+	}
+	else
+	{
+		m_nodes[lastChild].m_nextSibling = index;
+	}
+
+	return index;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds elapsed time to the node
+//
+void ProfileReport::AddTime(int node, uint64_t hpc)
+{
+	m_nodes[node].m_totalHpc += hpc;
+
+	int parent = m_nodes[node].m_parent;
+	if(parent >= 0)
+	{
+		m_nodes[parent].m_childHpc += hpc;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Collects the children of the node, largest total first
+//
+void ProfileReport::GetSortedChildren(int node, std::vector<int>& out_children) const
+{
+	out_children.clear();
+	for(int child = m_nodes[node].m_firstChild; child >= 0; child = m_nodes[child].m_nextSibling)
+	{
+		out_children.push_back(child);
+	}
+
+	std::sort(out_children.begin(), out_children.end(), [this](int a, int b)
+	{
+		return m_nodes[a].m_totalHpc > m_nodes[b].m_totalHpc;
+	});
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the call tree, one indented line per node. Nodes under minPercent of the frame are
+// skipped with their children
+//
+void ProfileReport::AppendTree(std::string& out_text, float minPercent /*= 0.f */) const
+{
+	AppendHeader(out_text);
+	AppendNode(out_text, 0, 0, minPercent);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends the node and its children
+//
+void ProfileReport::AppendNode(std::string& out_text, int node, int depth, float minPercent) const
+{
+	const ProfileReportNode& data = m_nodes[node];
+	uint64_t frameHpc = m_nodes[0].m_totalHpc;
+	if(node != 0 && frameHpc > 0 && (100.0 * (double) data.m_totalHpc / (double) frameHpc) < minPercent)
+	{
+		return;
+	}
+
+	std::string label(depth * 2, ' ');
+	label.append(data.m_name);
+	AppendRow(out_text, label, data.m_callCount, data.m_totalHpc, data.GetSelfHpc(), frameHpc);
+
+	std::vector<int> children;
+	GetSortedChildren(node, children);
+	for(int child : children)
+	{
+		AppendNode(out_text, child, depth + 1, minPercent);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends every scope merged over all its call paths, the most expensive self time first.
+// Totals of recursive scopes count the nested calls again
+//
+void ProfileReport::AppendFlat(std::string& out_text, int maxLines /*= 32 */) const
+{
+	std::vector<ProfileReportNode> merged;
+	for(int node = 1; node < (int) m_nodes.size(); ++node)
+	{
+		const ProfileReportNode& data = m_nodes[node];
+
+		size_t index = 0;
+		while(index < merged.size() && strcmp(merged[index].m_name, data.m_name) != 0)
+		{
+			index++;
+		}
+
+		if(index == merged.size())
+		{
+			ProfileReportNode entry;
+			entry.m_name = data.m_name;
+			merged.push_back(entry);
+		}
+
+		merged[index].m_callCount += data.m_callCount;
+		merged[index].m_totalHpc += data.m_totalHpc;
+		merged[index].m_childHpc += data.m_childHpc;
+	}
+
+	std::sort(merged.begin(), merged.end(), [](const ProfileReportNode& a, const ProfileReportNode& b)
+	{
+		return a.GetSelfHpc() > b.GetSelfHpc();
+	});
+
+	AppendHeader(out_text);
+	uint64_t frameHpc = m_nodes[0].m_totalHpc;
+	for(int index = 0; index < (int) merged.size() && index < maxLines; ++index)
+	{
+		const ProfileReportNode& entry = merged[index];
+		AppendRow(out_text, entry.m_name, entry.m_callCount, entry.m_totalHpc, entry.GetSelfHpc(), frameHpc);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+//-----------------------------------------------------------------------------------------------
+// One call path in a frame. Every call to the same scope from the same parent path is merged
+// into one node
+//
+struct ProfileReportNode
+{
+	const char*	m_name = nullptr;
+	int			m_parent = -1;
+	int			m_firstChild = -1;
+	int			m_nextSibling = -1;
+	uint32_t	m_callCount = 0;
+	uint64_t	m_totalHpc = 0;
+	uint64_t	m_childHpc = 0;		// Total of the children, self time is what is left
+
+	uint64_t	GetSelfHpc() const { return m_totalHpc > m_childHpc ? m_totalHpc - m_childHpc : 0; }
+};
+
+//-----------------------------------------------------------------------------------------------
+// Call tree of one thread for one frame. Node 0 is the frame itself, its self time is the time
+// no scope covered
+//
+class ProfileReport
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfileReport();
+	~ProfileReport(){}
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int							GetThreadIndex() const { return m_threadIndex; }
+			void						SetThreadIndex( int threadIndex ) { m_threadIndex = threadIndex; }
+			const char*					GetThreadName() const { return m_threadName; }
+			void						SetThreadName( const char* threadName ) { m_threadName = threadName; }
+			int							GetNodeCount() const { return (int) m_nodes.size(); }
+	const	ProfileReportNode&			GetNode( int index ) const { return m_nodes[index]; }
+	const	ProfileReportNode&			GetRoot() const { return m_nodes[0]; }
+			bool						HasScopes() const { return m_nodes[0].m_firstChild >= 0; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void						Reset( uint64_t frameHpc );
+			int							FindOrAddChild( int parent, const char* name );
+			void						AddTime( int node, uint64_t hpc ); // Also counts towards the parent's children
+			void						AddCall( int node ) { m_nodes[node].m_callCount++; }
+			void						SetFrameTime( uint64_t frameHpc ) { m_nodes[0].m_totalHpc = frameHpc; }
+
+			void						AppendTree( std::string& out_text, float minPercent = 0.f ) const;
+			void						AppendFlat( std::string& out_text, int maxLines = 32 ) const; // Merged by name, sorted by self time
+			void						GetSortedChildren( int node, std::vector<int>& out_children ) const; // Largest total first
+
+private:
+			void						AppendNode( std::string& out_text, int node, int depth, float minPercent ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::vector<ProfileReportNode>	m_nodes;
+	int								m_threadIndex = 0;
+	const char*						m_threadName = nullptr;	// Set for virtual threads, like the GPU
+};
+
@@ -0,0 +1,658 @@
+#include "Engine/Profiler/Profiler.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Console/Command.hpp"
+#include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Console/DevConsole.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static Profiler* g_profiler = nullptr;
+static std::atomic<uint32_t> g_profilerGeneration(0);		// Bumped for every new profiler so threads register again
+static bool s_areCommandsRegistered = false;
+
+static thread_local ProfileEventBuffer* t_eventBuffer = nullptr;
+static thread_local uint32_t t_eventBufferGeneration = 0;
+
+constexpr int PROFILER_UNOWNED_THREAD_INDEX = 1000;		// Threads the job system does not own start here
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ProfileEventBuffer::ProfileEventBuffer(int threadIndex)
+	: m_head(0)
+	, m_tail(0)
+	, m_droppedCount(0)
+	, m_threadIndex(threadIndex)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the start of a scope, returns false and drops it if its end would not fit
+//
+bool ProfileEventBuffer::PushBegin(const char* name, uint64_t hpc)
+{
+	uint32_t head = m_head.load(std::memory_order_relaxed);
+	uint32_t tail = m_tail.load(std::memory_order_acquire);
+	uint32_t freeCount = PROFILER_EVENT_BUFFER_SIZE - (head - tail);
+	if(freeCount < m_openCount + 2)
+	{
+		m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	ProfileEvent& event = m_events[head & (PROFILER_EVENT_BUFFER_SIZE - 1)];
+	event.m_name = name;
+	event.m_hpc = hpc;
+	event.m_type = PROFILE_EVENT_BEGIN;
+	m_head.store(head + 1, std::memory_order_release);
+	m_openCount++;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the end of the innermost scope, always has room since PushBegin kept it
+//
+void ProfileEventBuffer::PushEnd(uint64_t hpc)
+{
+	uint32_t head = m_head.load(std::memory_order_relaxed);
+
+	ProfileEvent& event = m_events[head & (PROFILER_EVENT_BUFFER_SIZE - 1)];
+	event.m_name = nullptr;
+	event.m_hpc = hpc;
+	event.m_type = PROFILE_EVENT_END;
+	m_head.store(head + 1, std::memory_order_release);
+	m_openCount--;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the oldest event if it happened before maxHpc. Events of one thread are in time order,
+// so everything after it stays for the next frame
+//
+bool ProfileEventBuffer::PopUntil(uint64_t maxHpc, ProfileEvent& out_event)
+{
+	uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	uint32_t head = m_head.load(std::memory_order_acquire);
+	if(tail == head)
+	{
+		return false;
+	}
+
+	const ProfileEvent& event = m_events[tail & (PROFILER_EVENT_BUFFER_SIZE - 1)];
+	if(event.m_hpc > maxHpc)
+	{
+		return false;
+	}
+
+	out_event = event;
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor, the calling thread is the main thread
+//
+Profiler::Profiler()
+	: m_isEnabled(true)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_PROFILER);
+	g_profilerGeneration.fetch_add(1);
+	m_frameStartHpc = Time::GetPerformanceCounter();
+
+	if(!s_areCommandsRegistered)
+	{
+		COMMAND("profile_report", ProfileReportCommand, "Prints the last frame's profile, [tree|flat]");
+		COMMAND("profile_capture", ProfileCaptureCommand, "Writes a Chrome trace of the next frames, [frames] [file]");
+		COMMAND("profile_enable", ProfileEnableCommand, "Enables/Disables the profiler");
+		s_areCommandsRegistered = true;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor, no scope can be recording on any thread anymore
+//
+Profiler::~Profiler()
+{
+	for(ProfileThreadState* state : m_threads)
+	{
+		delete state->m_buffer;
+		delete state;
+	}
+	m_threads.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the profiler, must be called from the main thread before any other thread records
+//
+STATIC Profiler* Profiler::CreateInstance()
+{
+	if(g_profiler == nullptr)
+	{
+		g_profiler = new Profiler();
+		t_eventBuffer = g_profiler->RegisterThread();
+		t_eventBufferGeneration = g_profilerGeneration.load();
+	}
+
+	return g_profiler;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the profiler instance
+//
+STATIC Profiler* Profiler::GetInstance()
+{
+	return g_profiler;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destroys the profiler instance, after every other thread that records has stopped
+//
+STATIC void Profiler::DestroyInstance()
+{
+	if(g_profiler)
+	{
+		delete g_profiler;
+		g_profiler = nullptr;
+		t_eventBuffer = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns a finished frame, nullptr if it is not in the history
+//
+const ProfileFrame* Profiler::GetFrame(int framesAgo /*= 0 */) const
+{
+	if(framesAgo < 0 || framesAgo >= m_historyCount)
+	{
+		return nullptr;
+	}
+
+	int index = (m_historyNext - 1 - framesAgo + PROFILER_HISTORY_SIZE) % PROFILER_HISTORY_SIZE;
+	return &m_history[index];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the report of one thread for a finished frame, nullptr if the thread recorded nothing
+//
+const ProfileReport* Profiler::GetReport(int framesAgo /*= 0 */, int threadIndex /*= 0 */) const
+{
+	const ProfileFrame* frame = GetFrame(framesAgo);
+	if(frame == nullptr)
+	{
+		return nullptr;
+	}
+
+	for(const ProfileReport& report : frame->m_reports)
+	{
+		if(report.GetThreadIndex() == threadIndex)
+		{
+			return &report;
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Gives the calling thread a buffer. Job system threads keep their index, others get one past
+// them
+//
+ProfileEventBuffer* Profiler::RegisterThread()
+{
+	std::lock_guard<std::mutex> lock(m_threadLock);
+
+	int threadIndex = JobSystem::GetThreadIndex();
+	if(m_threads.empty())
+	{
+		threadIndex = 0;
+	}
+	else if(threadIndex < 0)
+	{
+		threadIndex = PROFILER_UNOWNED_THREAD_INDEX + (int) m_threads.size();
+	}
+
+	return AddThreadState(threadIndex, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Gives a named timeline its own buffer. Its events are pushed with PushBegin/PushEnd by the one
+// thread that owns the work, with times in the past that are drained on the next frame mark
+//
+ProfileEventBuffer* Profiler::RegisterVirtualThread(const char* name)
+{
+	std::lock_guard<std::mutex> lock(m_threadLock);
+
+	int threadIndex = PROFILER_VIRTUAL_THREAD_INDEX;
+	for(const ProfileThreadState* state : m_threads)
+	{
+		if(state->m_report.GetThreadName() != nullptr)
+		{
+			threadIndex++;
+		}
+	}
+
+	return AddThreadState(threadIndex, name);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a thread state and its buffer, the thread lock has to be held
+//
+ProfileEventBuffer* Profiler::AddThreadState(int threadIndex, const char* name)
+{
+	ProfileThreadState* state = new ProfileThreadState();
+	state->m_buffer = new ProfileEventBuffer(threadIndex);
+	state->m_report.SetThreadIndex(threadIndex);
+	state->m_report.SetThreadName(name);
+	m_threads.push_back(state);
+
+	return state->m_buffer;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes the start of a scope on the calling thread's buffer
+//
+STATIC ProfileEventBuffer* Profiler::BeginScope(const char* name)
+{
+	Profiler* profiler = g_profiler;
+	if(profiler == nullptr || !profiler->IsEnabled())
+	{
+		return nullptr;
+	}
+
+	uint32_t generation = g_profilerGeneration.load(std::memory_order_relaxed);
+	if(t_eventBufferGeneration != generation)
+	{
+		t_eventBuffer = profiler->RegisterThread();
+		t_eventBufferGeneration = generation;
+	}
+
+	ProfileEventBuffer* buffer = t_eventBuffer;
+	if(!buffer->PushBegin(name, Time::GetPerformanceCounter()))
+	{
+		return nullptr;
+	}
+
+	return buffer;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes the end of the scope BeginScope returned the buffer for
+//
+STATIC void Profiler::EndScope(ProfileEventBuffer* buffer)
+{
+	buffer->PushEnd(Time::GetPerformanceCounter());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ends the current frame. Drains every thread's events up to now into its call tree, stores the
+// trees in the history and carries scopes that are still open over to the next frame
+//
+void Profiler::MarkFrame()
+{
+	GUARANTEE_OR_DIE(JobSystem::GetThreadIndex() <= 0, "Profiler::MarkFrame has to be called from the main thread");
+
+	uint64_t frameEndHpc = Time::GetPerformanceCounter();
+
+	ProfileFrame& frame = m_history[m_historyNext];
+	frame.m_startHpc = m_frameStartHpc;
+	frame.m_endHpc = frameEndHpc;
+	int reportCount = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_threadLock);
+		for(ProfileThreadState* state : m_threads)
+		{
+			DrainThread(*state, frameEndHpc);
+
+			if(state->m_report.HasScopes() || !state->m_openScopes.empty())
+			{
+				if(reportCount == (int) frame.m_reports.size())
+				{
+					frame.m_reports.emplace_back();
+				}
+				CloseFrameForThread(*state, frameEndHpc);
+				frame.m_reports[reportCount++] = state->m_report; // Copy assign keeps the node memory
+			}
+
+			state->m_report.Reset(0);
+			for(ProfileOpenScope& scope : state->m_openScopes)
+			{
+				int parent = (&scope == &state->m_openScopes.front()) ? 0 : (&scope - 1)->m_node;
+				scope.m_node = state->m_report.FindOrAddChild(parent, scope.m_name);
+				scope.m_startHpc = frameEndHpc;
+			}
+		}
+	}
+	frame.m_reports.resize(reportCount);
+
+	m_historyNext = (m_historyNext + 1) % PROFILER_HISTORY_SIZE;
+	m_historyCount = (m_historyCount < PROFILER_HISTORY_SIZE) ? m_historyCount + 1 : PROFILER_HISTORY_SIZE;
+
+	// Trace capture
+	if(m_captureFramesLeft > 0)
+	{
+		m_capture.push_back({ PROFILER_START_FRAME_TEXT, frameEndHpc, PROFILE_EVENT_END, 0 });
+		if(--m_captureFramesLeft == 0)
+		{
+			CaptureOpenScopes(frameEndHpc, PROFILE_EVENT_END);
+			if(WriteTrace(m_capturePath))
+			{
+				ConsolePrintf("Profile capture written to %s", m_capturePath.c_str());
+			}
+			else
+			{
+				ConsolePrintf(Rgba::RED, "Could not write profile capture to %s", m_capturePath.c_str());
+			}
+			m_capture.clear();
+		}
+	}
+	else if(m_capturePendingFrames > 0)
+	{
+		m_capture.clear();
+		m_captureStartHpc = frameEndHpc;
+		m_captureFramesLeft = m_capturePendingFrames;
+		m_capturePendingFrames = 0;
+		CaptureOpenScopes(frameEndHpc, PROFILE_EVENT_BEGIN);
+	}
+
+	if(m_captureFramesLeft > 0)
+	{
+		m_capture.push_back({ PROFILER_START_FRAME_TEXT, frameEndHpc, PROFILE_EVENT_BEGIN, 0 });
+	}
+
+	m_frameStartHpc = frameEndHpc;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Feeds the thread's events up to the end of the frame into its call tree
+//
+void Profiler::DrainThread(ProfileThreadState& state, uint64_t frameEndHpc)
+{
+	int threadIndex = state.m_buffer->GetThreadIndex();
+
+	ProfileEvent event;
+	while(state.m_buffer->PopUntil(frameEndHpc, event))
+	{
+		if(event.m_type == PROFILE_EVENT_BEGIN)
+		{
+			int parent = state.m_openScopes.empty() ? 0 : state.m_openScopes.back().m_node;
+			int node = state.m_report.FindOrAddChild(parent, event.m_name);
+			state.m_report.AddCall(node);
+			state.m_openScopes.push_back({ event.m_name, node, event.m_hpc });
+		}
+		else
+		{
+			if(state.m_openScopes.empty())
+			{
+				continue;
+			}
+
+			const ProfileOpenScope& scope = state.m_openScopes.back();
+			state.m_report.AddTime(scope.m_node, event.m_hpc - scope.m_startHpc);
+			event.m_name = scope.m_name;
+			state.m_openScopes.pop_back();
+		}
+
+		if(m_captureFramesLeft > 0)
+		{
+			m_capture.push_back({ event.m_name, event.m_hpc, event.m_type, threadIndex });
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Counts the part of the open scopes that fell in this frame and sets the frame time
+//
+void Profiler::CloseFrameForThread(ProfileThreadState& state, uint64_t frameEndHpc)
+{
+	for(int index = (int) state.m_openScopes.size() - 1; index >= 0; --index)
+	{
+		const ProfileOpenScope& scope = state.m_openScopes[index];
+		state.m_report.AddTime(scope.m_node, frameEndHpc - scope.m_startHpc);
+	}
+
+	state.m_report.SetFrameTime(frameEndHpc - m_frameStartHpc);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Opens the scopes that were already running when the capture started, or closes the ones still
+// running when it ends, so every thread's trace nests
+//
+void Profiler::CaptureOpenScopes(uint64_t hpc, ProfileEventType type)
+{
+	std::lock_guard<std::mutex> lock(m_threadLock);
+	for(ProfileThreadState* state : m_threads)
+	{
+		int threadIndex = state->m_buffer->GetThreadIndex();
+		int count = (int) state->m_openScopes.size();
+		for(int index = 0; index < count; ++index)
+		{
+			int scopeIndex = (type == PROFILE_EVENT_BEGIN) ? index : count - 1 - index;
+			m_capture.push_back({ state->m_openScopes[scopeIndex].m_name, hpc, type, threadIndex });
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records every event of the next frames, written to the path once they are done
+//
+void Profiler::StartCapture(int frameCount, const std::string& path)
+{
+	if(IsCapturing())
+	{
+		ConsolePrintf(Rgba::RED, "A profile capture is already running");
+		return;
+	}
+
+	m_capturePendingFrames = (frameCount > 0) ? frameCount : 1;
+	m_capturePath = path;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the captured events in the Chrome trace event format
+//
+bool Profiler::WriteTrace(const std::string& path) const
+{
+	std::string json;
+	json.reserve(m_capture.size() * 80 + 32);
+	json.append("{\"traceEvents\":[\n");
+
+	// Names the virtual threads' rows
+	char line[128];
+	{
+		std::lock_guard<std::mutex> lock(m_threadLock);
+		for(const ProfileThreadState* state : m_threads)
+		{
+			const char* threadName = state->m_report.GetThreadName();
+			if(threadName != nullptr)
+			{
+				snprintf(line, sizeof(line), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+					state->m_buffer->GetThreadIndex(), threadName);
+				json.append(line);
+			}
+		}
+	}
+	if(m_capture.empty() && json.size() >= 2 && json[json.size() - 2] == ',')
+	{
+		json.erase(json.size() - 2, 1);
+	}
+
+	for(size_t index = 0; index < m_capture.size(); ++index)
+	{
+		const ProfileTraceEvent& event = m_capture[index];
+
+		json.append("{\"name\":\"");
+		for(const char* character = event.m_name; *character != '\0'; ++character)
+		{
+			if(*character == '"' || *character == '\\')
+			{
+				json.push_back('\\');
+			}
+			json.push_back(*character);
+		}
+
+		// Virtual threads can report work from before the capture started
+		double microseconds = (event.m_hpc >= m_captureStartHpc) ? Time::HpcToSeconds(event.m_hpc - m_captureStartHpc) : -Time::HpcToSeconds(m_captureStartHpc - event.m_hpc);
+		microseconds *= 1000000.0;
+		snprintf(line, sizeof(line), "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}%s\n",
+			(event.m_type == PROFILE_EVENT_BEGIN) ? 'B' : 'E', microseconds, event.m_threadIndex,
+			(index + 1 < m_capture.size()) ? "," : "");
+		json.append(line);
+	}
+
+	json.append("]}\n");
+	return FileWriteToNewFile(path.c_str(), json.c_str(), json.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the frame's report of every thread that recorded something
+//
+std::string Profiler::GetReportText(int framesAgo /*= 0 */, bool flat /*= false */) const
+{
+	const ProfileFrame* frame = GetFrame(framesAgo);
+	if(frame == nullptr)
+	{
+		return "No profiled frame yet\n";
+	}
+
+	std::string text;
+	char line[128];
+	for(const ProfileReport& report : frame->m_reports)
+	{
+		if(report.GetThreadName() != nullptr)
+		{
+			snprintf(line, sizeof(line), "%s\n", report.GetThreadName());
+		}
+		else
+		{
+			snprintf(line, sizeof(line), "Thread %d\n", report.GetThreadIndex());
+		}
+		text.append(line);
+
+		if(flat)
+		{
+			report.AppendFlat(text);
+		}
+		else
+		{
+			report.AppendTree(text);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_threadLock);
+	for(const ProfileThreadState* state : m_threads)
+	{
+		uint32_t droppedCount = state->m_buffer->GetDroppedCount();
+		if(droppedCount > 0)
+		{
+			snprintf(line, sizeof(line), "Thread %d dropped %u scopes, its buffer was full\n", state->m_buffer->GetThreadIndex(), droppedCount);
+			text.append(line);
+		}
+	}
+
+	return text;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints the last frame's profile on the console
+//
+STATIC bool Profiler::ProfileReportCommand(Command& cmd)
+{
+	Profiler* profiler = Profiler::GetInstance();
+	if(profiler == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The profiler is not running");
+		return false;
+	}
+
+	std::string layout = cmd.GetNextString();
+	std::string text = profiler->GetReportText(0, layout == "flat");
+
+	size_t lineStart = 0;
+	while(lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if(lineEnd == std::string::npos)
+		{
+			lineEnd = text.size();
+		}
+		ConsolePrintf("%s", text.substr(lineStart, lineEnd - lineStart).c_str());
+		lineStart = lineEnd + 1;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts a trace capture
+//
+STATIC bool Profiler::ProfileCaptureCommand(Command& cmd)
+{
+	Profiler* profiler = Profiler::GetInstance();
+	if(profiler == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The profiler is not running");
+		return false;
+	}
+
+	int frameCount = 1;
+	cmd.GetNextInt(frameCount);
+
+	std::string path = cmd.GetNextString();
+	if(path.empty())
+	{
+		path = "ProfileCapture.json";
+	}
+
+	profiler->StartCapture(frameCount, path);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Enables/Disables recording, toggles without an argument
+//
+STATIC bool Profiler::ProfileEnableCommand(Command& cmd)
+{
+	Profiler* profiler = Profiler::GetInstance();
+	if(profiler == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The profiler is not running");
+		return false;
+	}
+
+	bool isEnabled = !profiler->IsEnabled();
+	cmd.GetNextBool(isEnabled);
+	profiler->SetEnabled(isEnabled);
+
+	ConsolePrintf("Profiler %s", isEnabled ? "enabled" : "disabled");
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Starts up the profiler
+//
+void ProfilerStartup()
+{
+	Profiler::CreateInstance();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Shuts down the profiler
+//
+void ProfilerShutdown()
+{
+	Profiler::DestroyInstance();
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include "Engine/Core/EngineConfig.hpp"
+#include "Engine/Profiler/ProfileReport.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Command;
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t PROFILER_EVENT_BUFFER_SIZE = 32768; // Events per thread between two frame marks, power of two
+constexpr int PROFILER_VIRTUAL_THREAD_INDEX = 900;		// Virtual threads start here
+
+//-----------------------------------------------------------------------------------------------
+enum ProfileEventType : uint32_t
+{
+	PROFILE_EVENT_BEGIN,
+	PROFILE_EVENT_END
+};
+
+//-----------------------------------------------------------------------------------------------
+struct ProfileEvent
+{
+	const char*			m_name;
+	uint64_t			m_hpc;
+	ProfileEventType	m_type;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Single producer single consumer ring. The owning thread pushes, the main thread drains it when
+// the frame is marked. A begin is only accepted if the ends of every open scope still fit, so a
+// full buffer drops whole scopes and never leaves one unbalanced
+//
+class ProfileEventBuffer
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ProfileEventBuffer( int threadIndex );
+	~ProfileEventBuffer(){}
+	ProfileEventBuffer( const ProfileEventBuffer& ) = delete;
+	void operator=( const ProfileEventBuffer& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int					GetThreadIndex() const { return m_threadIndex; }
+			uint32_t			GetDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			bool				PushBegin( const char* name, uint64_t hpc );	// Owning thread only
+			void				PushEnd( uint64_t hpc );						// Owning thread only
+			bool				PopUntil( uint64_t maxHpc, ProfileEvent& out_event );	// Reader only, stops at events after maxHpc
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			ProfileEvent				m_events[PROFILER_EVENT_BUFFER_SIZE];
+			std::atomic<uint32_t>		m_head;			// Next write, only moved by the owner
+			std::atomic<uint32_t>		m_tail;			// Next read, only moved by the reader
+			std::atomic<uint32_t>		m_droppedCount;
+			uint32_t					m_openCount = 0;	// Pushed begins waiting for their end, owner only
+			int							m_threadIndex;
+};
+
+//-----------------------------------------------------------------------------------------------
+// A scope that is still open on a thread while its events are aggregated
+//
+struct ProfileOpenScope
+{
+	const char*		m_name;
+	int				m_node;
+	uint64_t		m_startHpc;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Per thread aggregation state, only touched on the main thread
+//
+struct ProfileThreadState
+{
+	ProfileEventBuffer*				m_buffer = nullptr;
+	ProfileReport					m_report;		// Frame being built
+	std::vector<ProfileOpenScope>	m_openScopes;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Reports of every thread for one finished frame
+//
+struct ProfileFrame
+{
+	uint64_t					m_startHpc = 0;
+	uint64_t					m_endHpc = 0;
+	std::vector<ProfileReport>	m_reports;		// Threads that recorded anything, main thread first
+};
+
+//-----------------------------------------------------------------------------------------------
+// Captured event for the trace export
+//
+struct ProfileTraceEvent
+{
+	const char*			m_name;
+	uint64_t			m_hpc;
+	ProfileEventType	m_type;
+	int					m_threadIndex;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Hierarchical CPU profiler. Scopes record begin and end events into lock free per thread
+// buffers, MarkFrame drains them on the main thread into one call tree per thread and keeps the
+// last PROFILER_HISTORY_SIZE frames. Raw events can be captured for a number of frames and
+// written as a Chrome trace (chrome://tracing, Perfetto)
+//
+class Profiler
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	Profiler();
+	~Profiler();
+
+	static	Profiler*			CreateInstance();
+	static	Profiler*			GetInstance();
+	static	void				DestroyInstance();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool				IsEnabled() const { return m_isEnabled.load(std::memory_order_relaxed); }
+			void				SetEnabled( bool isEnabled ) { m_isEnabled.store(isEnabled, std::memory_order_relaxed); }
+			bool				IsCapturing() const { return m_captureFramesLeft > 0 || m_capturePendingFrames > 0; }
+			int					GetHistoryCount() const { return m_historyCount; }
+	const	ProfileFrame*		GetFrame( int framesAgo = 0 ) const; // 0 is the last finished frame
+	const	ProfileReport*		GetReport( int framesAgo = 0, int threadIndex = 0 ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				MarkFrame(); // Main thread, outside of any scope
+			void				StartCapture( int frameCount, const std::string& path );
+			bool				WriteTrace( const std::string& path ) const;
+			std::string			GetReportText( int framesAgo = 0, bool flat = false ) const;
+
+			ProfileEventBuffer*	RegisterVirtualThread( const char* name ); // Timeline for work that does not run on a CPU thread, fed by one thread
+
+	static	ProfileEventBuffer*	BeginScope( const char* name ); // nullptr if nothing was recorded
+	static	void				EndScope( ProfileEventBuffer* buffer );
+
+	//-----------------------------------------------------------------------------------------------
+	// Command Callbacks
+	static	bool				ProfileReportCommand( Command& cmd );
+	static	bool				ProfileCaptureCommand( Command& cmd );
+	static	bool				ProfileEnableCommand( Command& cmd );
+
+private:
+			ProfileEventBuffer*	RegisterThread();
+			ProfileEventBuffer*	AddThreadState( int threadIndex, const char* name );
+			void				DrainThread( ProfileThreadState& state, uint64_t frameEndHpc );
+			void				CloseFrameForThread( ProfileThreadState& state, uint64_t frameEndHpc );
+			void				CaptureOpenScopes( uint64_t hpc, ProfileEventType type );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			std::atomic<bool>					m_isEnabled;
+		mutable	std::mutex							m_threadLock;		// Guards the thread list, taken once per thread and frame
+			std::vector<ProfileThreadState*>	m_threads;
+			uint64_t							m_frameStartHpc = 0;
+
+			ProfileFrame						m_history[PROFILER_HISTORY_SIZE];
+			int									m_historyNext = 0;
+			int									m_historyCount = 0;
+
+			std::vector<ProfileTraceEvent>		m_capture;
+			int									m_captureFramesLeft = 0;
+			int									m_capturePendingFrames = 0;	// Starts on the next frame mark
+			uint64_t							m_captureStartHpc = 0;
+			std::string							m_capturePath;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Records a scope on the calling thread for its lifetime. The name must outlive the frame, use
+// literals
+//
+class ProfileScope
+{
+public:
+	explicit ProfileScope( const char* name ) { m_buffer = Profiler::BeginScope(name); }
+	~ProfileScope() { if(m_buffer) { Profiler::EndScope(m_buffer); } }
+	ProfileScope( const ProfileScope& ) = delete;
+	void operator=( const ProfileScope& ) = delete;
+
+private:
+	ProfileEventBuffer*	m_buffer;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Macros
+#define PROFILE_JOIN_IMPL(a, b)		a##b
+#define PROFILE_JOIN(a, b)			PROFILE_JOIN_IMPL(a, b)
+
+#if defined(ENGINE_ENABLE_PROFILING)
+	#define PROFILE_SCOPE(name)			ProfileScope PROFILE_JOIN(__profileScope, __LINE__)(name)
+	#define PROFILE_SCOPE_FUNCTION()	PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_SCOPE_FUNCTION()
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions
+void	ProfilerStartup();
+void	ProfilerShutdown();
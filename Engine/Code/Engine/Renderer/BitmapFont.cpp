@@ -8,10 +8,30 @@
 //
 BitmapFont::BitmapFont( const std::string& fontName, const SpriteSheet& glyphSheet,float baseAspect )
 	: m_fontName(fontName)
-	, m_spriteSheet(glyphSheet)
+	, m_spriteSheet(&glyphSheet)
+	, m_texture(&glyphSheet.GetSpriteSheetTexture())
 	, m_baseAspect(baseAspect)
 {
+	// Every glyph fills its cell
+	for(int glyphIndex = 0; glyphIndex < BITMAP_FONT_GLYPH_COUNT; ++glyphIndex)
+	{
+		m_glyphs[glyphIndex].m_uvs = glyphSheet.GetTexCoordsForSpriteCoords(glyphIndex);
+	}
+}
 
+//-----------------------------------------------------------------------------------------------
+// Constructor for signed distance field fonts, the glyphs are copied
+//
+BitmapFont::BitmapFont(const std::string& fontName, const Texture& distanceAtlas, const GlyphMetrics* glyphs, float baseAspect)
+	: m_fontName(fontName)
+	, m_texture(&distanceAtlas)
+	, m_isSDF(true)
+	, m_baseAspect(baseAspect)
+{
+	for(int glyphIndex = 0; glyphIndex < BITMAP_FONT_GLYPH_COUNT; ++glyphIndex)
+	{
+		m_glyphs[glyphIndex] = glyphs[glyphIndex];
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -19,8 +39,7 @@ BitmapFont::BitmapFont( const std::string& fontName, const SpriteSheet& glyphShe
 //
 AABB2 BitmapFont::GetUVsForGlyph(int glyphUnicode) const
 {
-	AABB2 uv = m_spriteSheet.GetTexCoordsForSpriteCoords(glyphUnicode);
-	return uv;
+	return GetGlyphMetrics(glyphUnicode).m_uvs;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -29,7 +48,13 @@ AABB2 BitmapFont::GetUVsForGlyph(int glyphUnicode) const
 float BitmapFont::GetStringWidth(const std::string& asciiText, float cellHeight, float aspectScale) const
 {
 	float cellWidth = cellHeight * (m_baseAspect * aspectScale);
-	return cellWidth * static_cast<float>(asciiText.length());
+	float advance = 0.f;
+	for(size_t index = 0; index < asciiText.size(); ++index)
+	{
+		advance += GetGlyphMetrics(asciiText[index]).m_advance;
+	}
+
+	return cellWidth * advance;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -43,9 +68,9 @@ float BitmapFont::GetStringHeight(const std::string& asciiText, float cellHeight
 }
 
 //-----------------------------------------------------------------------------------------------
-// Returns the sprite sheet texture
+// Returns the texture the glyphs are in, the distance atlas for SDF fonts
 //
 const Texture* BitmapFont::GetSpriteSheetTexture() const
 {
-	return &m_spriteSheet.GetSpriteSheetTexture();
+	return m_texture;
 }
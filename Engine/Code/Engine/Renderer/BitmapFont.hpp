@@ -1,12 +1,26 @@
 #pragma once
 #include <string>
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward declarations
-class AABB2;
 class SpriteSheet;
 class Texture;
 
+//-----------------------------------------------------------------------------------------------
+// Where a glyph is in the font texture and where its quad goes relative to the pen. Bounds and
+// advance are in cells, x in cell widths and y in cell heights
+//
+struct GlyphMetrics
+{
+	bool	HasInk() const { return m_bounds.maxs.x > m_bounds.mins.x && m_bounds.maxs.y > m_bounds.mins.y; }
+
+	AABB2	m_uvs;									// Mins is the top left, same as sprite sheet coords
+	AABB2	m_bounds = AABB2(0.f, 0.f, 1.f, 1.f);	// Empty for glyphs with no ink, nothing gets drawn
+	float	m_advance = 1.f;
+};
+
 //-----------------------------------------------------------------------------------------------
 class BitmapFont
 {
@@ -16,12 +30,16 @@ class BitmapFont
 	// Constructor/Destructor
 private:
 	explicit BitmapFont( const std::string& fontName, const SpriteSheet& glyphSheet,float baseAspect ); // Can only be constructed by Renderer
+	explicit BitmapFont( const std::string& fontName, const Texture& distanceAtlas, const GlyphMetrics* glyphs, float baseAspect ); // Signed distance field font
 
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
 public:
 			AABB2		GetUVsForGlyph( int glyphUnicode ) const; // pass A or 65 for A, etc.
-			float		GetGlyphAspect( int glyphUnicode ) const { return m_baseAspect; (void)(glyphUnicode); } // will change later
+			float		GetGlyphAspect( int glyphUnicode ) const { return m_baseAspect * GetGlyphMetrics(glyphUnicode).m_advance; }
+	const	GlyphMetrics&	GetGlyphMetrics( int glyphUnicode ) const { return m_glyphs[glyphUnicode & 0xff]; }
+			float		GetBaseAspect() const { return m_baseAspect; }
+			bool		IsSDF() const { return m_isSDF; } // Texture holds distances in alpha, needs the SDF text program and linear sampling
 			float		GetStringWidth( const std::string& asciiText, float cellHeight, float aspectScale ) const;
 			float		GetStringHeight( const std::string& asciiText, float cellHeight, float aspectScale ) const;
 	const	Texture*	GetSpriteSheetTexture() const;
@@ -29,7 +47,10 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Members
 private:
-	const	SpriteSheet&	m_spriteSheet; // used internally; assumed to be a 16x16 glyph sheet
+	const	SpriteSheet*	m_spriteSheet = nullptr; // 16x16 glyph sheet of fixed fonts
+	const	Texture*		m_texture = nullptr;
+			GlyphMetrics	m_glyphs[BITMAP_FONT_GLYPH_COUNT];
+			bool			m_isSDF = false;
 			float			m_baseAspect = 1.0f; // used as the base aspect ratio for all glyphs
 			std::string		m_fontName;
 
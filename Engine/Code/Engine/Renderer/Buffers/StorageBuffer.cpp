@@ -0,0 +1,39 @@
+#include "Engine/Renderer/Buffers/StorageBuffer.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+StorageBuffer::StorageBuffer()
+	: RenderBuffer()
+{
+
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the data. Reallocates only when it doesn't fit so per frame uploads don't churn
+//
+void StorageBuffer::SetGPUData(size_t byteSize, const void* data, size_t elementCount)
+{
+	// Keep at least 16 bytes around so an empty array can still be bound
+	size_t requiredSize = (byteSize < 16) ? 16 : byteSize;
+
+	if(m_handle == NULL || requiredSize > m_capacity)
+	{
+		m_capacity = requiredSize + (requiredSize >> 1);
+		CopyToGPU(m_capacity, nullptr);
+	}
+
+	if(byteSize > 0)
+	{
+		GLStateCache::GetInstance()->BindBuffer(GL_SHADER_STORAGE_BUFFER, m_handle);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, byteSize, data);
+	}
+
+	m_bufferSize = byteSize;
+	m_elementCount = elementCount;
+}
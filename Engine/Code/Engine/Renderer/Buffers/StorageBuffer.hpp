@@ -1,44 +1,40 @@
 #pragma once
-#include <string>
+#include "Engine/Renderer/RenderBuffer.hpp"
+#include <vector>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 
 //-----------------------------------------------------------------------------------------------
-enum DataType
-{
-	DATA_INVALID = -1,
-	DATA_INT,
-	DATA_FLOAT,
-	DATA_MATRIX44,
-	DATA_RGBA,
-	DATA_VECTOR3,
-	NUM_DATA_TYPES
-};
-
-//-----------------------------------------------------------------------------------------------
-class MaterialProperty
+// Shader storage buffer (std430) for arrays whose size isn't known at shader compile time
+//
+class StorageBuffer : public RenderBuffer
 {
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
-	MaterialProperty( const char* name, DataType type ) : m_name(name), m_type(type) {}
-	virtual ~MaterialProperty(){}
+	StorageBuffer();
+	~StorageBuffer(){}
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-			std::string	GetName() const { return m_name; }
-			void		SetType( DataType type ) { m_type = type; }
-			DataType	GetType() const { return m_type; }
+	size_t	GetElementCount() const { return m_elementCount; }
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
-	virtual void					Bind( unsigned int programHandle ) = 0; // Pure virtual
-	virtual MaterialProperty*		Clone() = 0;
+	void	SetGPUData( size_t byteSize, const void* data, size_t elementCount ); // Only grows the GPU buffer
+
+	//-----------------------------------------------------------------------------------------------
+	// Templates
+	template <typename T>
+	void	Set( const std::vector<T>& elements )
+	{
+		SetGPUData(sizeof(T) * elements.size(), elements.data(), elements.size());
+	}
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	std::string	m_name = "";
-	DataType	m_type;
+	size_t	m_elementCount = 0;
+	size_t	m_capacity = 0;
 };
 
@@ -0,0 +1,148 @@
+#include "Engine/Renderer/Buffers/StreamingBuffer.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor, the storage is created up front and never grows
+//
+StreamingBuffer::StreamingBuffer(size_t bytesPerFrame)
+	: RenderBuffer()
+	, m_regionSize(bytesPerFrame)
+{
+	for(int regionIndex = 0; regionIndex < STREAMING_BUFFER_REGION_COUNT; ++regionIndex)
+	{
+		m_fences[regionIndex] = nullptr;
+	}
+
+	m_bufferSize = m_regionSize * STREAMING_BUFFER_REGION_COUNT;
+	glGenBuffers(1, &m_handle);
+	GLStateCache::GetInstance()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+
+	if(glBufferStorage != nullptr)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, m_bufferSize, nullptr, flags);
+		m_persistentData = (unsigned char*) glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_bufferSize, flags);
+	}
+	else
+	{
+		glBufferData(GL_COPY_WRITE_BUFFER, m_bufferSize, nullptr, GL_STREAM_DRAW);
+	}
+
+	GL_CHECK_ERROR();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+StreamingBuffer::~StreamingBuffer()
+{
+	for(int regionIndex = 0; regionIndex < STREAMING_BUFFER_REGION_COUNT; ++regionIndex)
+	{
+		if(m_fences[regionIndex] != nullptr)
+		{
+			glDeleteSync(m_fences[regionIndex]);
+			m_fences[regionIndex] = nullptr;
+		}
+	}
+
+	if(m_persistentData != nullptr)
+	{
+		GLStateCache::GetInstance()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		m_persistentData = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Moves on to the next region, waiting for the frame that last used it to finish on the GPU
+//
+void StreamingBuffer::BeginFrame()
+{
+	PROFILE_SCOPE_FUNCTION();
+	m_regionIndex = (m_regionIndex + 1) % STREAMING_BUFFER_REGION_COUNT;
+	m_cursor = m_regionIndex * m_regionSize;
+	m_overflowCount = 0;
+
+	GLsync& fence = m_fences[m_regionIndex];
+	if(fence == nullptr)
+	{
+		return;
+	}
+
+	// Flushing on the first wait makes sure the fence is submitted at all
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	for(;;)
+	{
+		GLenum result = glClientWaitSync(fence, waitFlags, 1000000); // 1ms per try
+		if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+		{
+			break;
+		}
+		waitFlags = 0;
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Fences the draws made from this frame's region
+//
+void StreamingBuffer::EndFrame()
+{
+	GLsync& fence = m_fences[m_regionIndex];
+	if(fence != nullptr)
+	{
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reserves byteCount bytes in this frame's region. The offset is from the start of the buffer
+// and a multiple of alignment, which does not have to be a power of two so vertex strides work
+//
+void* StreamingBuffer::Allocate(size_t byteCount, size_t alignment, size_t* out_offset)
+{
+	GUARANTEE_OR_DIE(!m_isRangeMapped, "StreamingBuffer::Allocate called before FinishWrite");
+
+	size_t offset = ((m_cursor + alignment - 1) / alignment) * alignment;
+	size_t regionEnd = (m_regionIndex + 1) * m_regionSize;
+	if(byteCount == 0 || offset + byteCount > regionEnd)
+	{
+		++m_overflowCount;
+		return nullptr;
+	}
+
+	m_cursor = offset + byteCount;
+	*out_offset = offset;
+
+	if(m_persistentData != nullptr)
+	{
+		return m_persistentData + offset;
+	}
+
+	m_isRangeMapped = true;
+	GLStateCache::GetInstance()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+	return glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, byteCount, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Unmaps the last allocation when it was mapped on its own, coherent persistent memory needs
+// nothing
+//
+void StreamingBuffer::FinishWrite()
+{
+	if(m_isRangeMapped)
+	{
+		GLStateCache::GetInstance()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		m_isRangeMapped = false;
+	}
+}
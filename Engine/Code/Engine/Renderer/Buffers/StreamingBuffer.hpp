@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/Renderer/RenderBuffer.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+//-----------------------------------------------------------------------------------------------
+constexpr int STREAMING_BUFFER_REGION_COUNT = 3;	// Frames the GPU may still be reading while the CPU writes the next
+
+//-----------------------------------------------------------------------------------------------
+// Ring of per frame regions for data that lives for a single draw. Allocations only move a
+// cursor forward, and a fence per region keeps the CPU from writing over data the GPU has not
+// drawn yet. The whole buffer stays mapped when the driver has ARB_buffer_storage, otherwise
+// every allocation maps its own range unsynchronized, which the fences make safe as well. It is
+// only ever bound to the copy target, so mapping never changes a vertex array's index buffer
+//
+class StreamingBuffer : public RenderBuffer
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	StreamingBuffer( size_t bytesPerFrame );
+	~StreamingBuffer();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool		IsPersistent() const { return m_persistentData != nullptr; }
+			size_t		GetBytesPerFrame() const { return m_regionSize; }
+			size_t		GetUsedBytes() const { return m_cursor - m_regionIndex * m_regionSize; }
+			int			GetOverflowCount() const { return m_overflowCount; } // Allocations that did not fit this frame
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void		BeginFrame(); // Waits until the GPU is done with the region about to be reused
+			void		EndFrame(); // Fences everything drawn from the frame's region
+			void*		Allocate( size_t byteCount, size_t alignment, size_t* out_offset ); // Write only, nullptr when the frame's region is full
+			void		FinishWrite(); // Call after writing an allocation, before drawing from it
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+private:
+			size_t			m_regionSize;
+			int				m_regionIndex = 0;
+			size_t			m_cursor = 0;						// Offset of the next free byte from the start of the buffer
+			unsigned char*	m_persistentData = nullptr;
+			bool			m_isRangeMapped = false;
+			int				m_overflowCount = 0;
+			GLsync			m_fences[STREAMING_BUFFER_REGION_COUNT];
+};
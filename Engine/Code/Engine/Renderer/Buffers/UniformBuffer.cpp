@@ -1,4 +1,5 @@
 #include "Engine/Renderer/Buffers/UniformBuffer.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 #include <stdlib.h>
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
@@ -43,6 +44,7 @@ void UniformBuffer::SetCPUData(size_t byteSize, const void* data)
 //
 void UniformBuffer::UpdateGPU()
 {
+	PROFILE_SCOPE_FUNCTION();
 	if(m_isDirty)
 	{
 		CopyToGPU(m_cpuByteSize, m_cpuBuffer);
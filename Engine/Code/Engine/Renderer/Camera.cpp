@@ -1,6 +1,7 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/FrameBuffer.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureArray.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -90,6 +91,15 @@ void Camera::SetDepthTarget(Texture* depthTarget)
 	m_viewport.maxs = Vector2(depthTarget->GetDimensions());
 }
 
+//-----------------------------------------------------------------------------------------------
+// Renders depth into one layer of the texture array
+//
+void Camera::SetDepthTargetLayer(TextureArray* depthArray, int layer)
+{
+	m_frameBuffer->SetDepthStencilLayer(depthArray, layer);
+	m_viewport.maxs = Vector2((float) depthArray->GetWidth(), (float) depthArray->GetHeight());
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns the depth target
 //
@@ -151,6 +161,16 @@ void Camera::RotateByEuler(const Vector3& rotation)
 	m_viewMatrix = Matrix44::InvertFast(temp);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Rotates the camera in local space, the transform keeps a quaternion from then on
+//
+void Camera::Rotate(const Quaternion& rotation)
+{
+	m_transform.Rotate(rotation);
+	Matrix44 temp = m_transform.GetWorldMatrix();
+	m_viewMatrix = Matrix44::InvertFast(temp);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Calls the finalize method on the framebuffer
 //
@@ -5,6 +5,7 @@
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Texture;
+class TextureArray;
 class TextureCube;
 class FrameBuffer;
 class Material;
@@ -31,6 +32,7 @@ public:
 			void			SetPerspective( float fovDegrees, float aspect, float zNear, float zFar );
 			void			SetColorTarget( Texture* colorTarget );
 			void			SetDepthTarget( Texture* depthTarget );
+			void			SetDepthTargetLayer( TextureArray* depthArray, int layer );
 			Texture*		GetDepthTarget() const;
 			Texture*		GetColorTarget() const;
 			void			SetSkyBox( const TextureCube* cubemap ) { m_skybox = cubemap; m_usesSkybox = true; }
@@ -42,11 +44,13 @@ public:
 			AABB2			GetViewportExtents() const { return m_viewport; }
 			bool			IsSkyBoxValid() const { return m_usesSkybox; }
 	const	TextureCube*	GetSkyBoxTexture() const { return m_skybox; }
+			void			SetUsesQuaternion( bool usesQuaternion ) { m_transform.SetUsesQuaternion(usesQuaternion); }
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 			void			Translate( const Vector3& offset );
 			void			RotateByEuler( const Vector3& rotation );
+			void			Rotate( const Quaternion& rotation );
 			void			Finalize(); // Internally calls finalize on the framebuffer
 			void			UpdateMatrices();
 
@@ -19,11 +19,11 @@ void DebugRenderPoint(const Vector3& pos, const Rgba& color /*= Rgba::WHITE */)
 void DebugRenderPoint(float lifeTime, const Vector3& pos, const Rgba& startColor, const Rgba& endColor)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = startColor;
-	options->endColor = endColor;
-	options->lifetime = lifeTime;
-	dRender->DebugRenderPoint(pos, *options);
+	DebugRenderOptions options;
+	options.startColor = startColor;
+	options.endColor = endColor;
+	options.lifetime = lifeTime;
+	dRender->DebugRenderPoint(pos, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -32,12 +32,12 @@ void DebugRenderPoint(float lifeTime, const Vector3& pos, const Rgba& startColor
 void DebugRenderLine(float lifeTime, const Vector3& start, const Vector3& end, const Rgba& color /*= Rgba::WHITE*/, DebugRenderMode mode /*= DEBUG_RENDER_USE_DEPTH */)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
-	options->mode = mode;
-	dRender->DebugRenderLineSegment(start, end, *options);
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
+	options.mode = mode;
+	dRender->DebugRenderLineSegment(start, end, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -47,13 +47,13 @@ void DebugRenderQuad(float lifeTime, const Vector3& position, const Vector3& eul
 	const Rgba& tint /*= Rgba::WHITE*/, DebugRenderMode mode /*= DEBUG_RENDER_USE_DEPTH*/)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = tint;
-	options->endColor = tint;
-	options->lifetime = lifeTime;
-	options->mode = mode;
+	DebugRenderOptions options;
+	options.startColor = tint;
+	options.endColor = tint;
+	options.lifetime = lifeTime;
+	options.mode = mode;
 
-	dRender->DebugRenderQuad(position, euler, scale, *options, false, texture);
+	dRender->DebugRenderQuad(position, euler, scale, options, false, texture);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -62,13 +62,13 @@ void DebugRenderQuad(float lifeTime, const Vector3& position, const Vector3& eul
 void DebugRenderGlyph(float lifeTime, const Vector3& position, const Vector3& euler, const Vector2& scale, const Texture* texture /*= nullptr*/, const Rgba& tint /*= Rgba::WHITE*/, DebugRenderMode mode /*= DEBUG_RENDER_USE_DEPTH*/)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = tint;
-	options->endColor = tint;
-	options->lifetime = lifeTime;
-	options->mode = mode;
+	DebugRenderOptions options;
+	options.startColor = tint;
+	options.endColor = tint;
+	options.lifetime = lifeTime;
+	options.mode = mode;
 
-	dRender->DebugRenderQuad(position, euler, scale, *options, true, texture);
+	dRender->DebugRenderQuad(position, euler, scale, options, true, texture);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -77,12 +77,12 @@ void DebugRenderGlyph(float lifeTime, const Vector3& position, const Vector3& eu
 void DebugRenderWireAABB3(float lifeTime, const Vector3& pos, const Vector3& size, const Rgba& color /*= Rgba::WHITE */)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
 
-	dRender->DebugRenderAABB3(pos, size, FILLMODE_WIRE, *options);
+	dRender->DebugRenderAABB3(pos, size, FILLMODE_WIRE, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -91,12 +91,12 @@ void DebugRenderWireAABB3(float lifeTime, const Vector3& pos, const Vector3& siz
 void DebugRenderWireSphere(float lifeTime, const Vector3& pos, float radius, const Rgba& color /*= Rgba::WHITE */)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
 
-	dRender->DebugRenderSphere(pos, radius, 32, 16, FILLMODE_WIRE, *options);
+	dRender->DebugRenderSphere(pos, radius, 32, 16, FILLMODE_WIRE, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -105,17 +105,17 @@ void DebugRenderWireSphere(float lifeTime, const Vector3& pos, float radius, con
 void DebugRenderTextv(float lifeTime, const Vector3& pos, const Vector3& rotation, const Vector2& alignment, float cellHeight, const Rgba& color, const char* format, va_list varArgs)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
 
 	const int MAX_LENGTH = 2048;
 	char buffer[MAX_LENGTH];
 	vsnprintf_s( buffer, MAX_LENGTH, _TRUNCATE, format, varArgs );
 	buffer[MAX_LENGTH - 1] = '\0';
 
-	dRender->DebugRender3DText(pos, rotation, buffer, cellHeight, *options, alignment, false);
+	dRender->DebugRender3DText(pos, rotation, buffer, cellHeight, options, alignment, false);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -234,17 +234,17 @@ void DebugRenderTagf(float lifeTime, const Vector3& pos, float cellHeight, char
 void DebugRenderTagv(float lifeTime, const Vector3& pos, const Vector3& rotation, const Vector2& alignment, float cellHeight, const Rgba& color, const char* format, va_list varArgs)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
 
 	const int MAX_LENGTH = 2048;
 	char buffer[MAX_LENGTH];
 	vsnprintf_s( buffer, MAX_LENGTH, _TRUNCATE, format, varArgs );
 	buffer[MAX_LENGTH - 1] = '\0';
 
-	dRender->DebugRender3DText(pos, rotation, buffer, cellHeight, *options, alignment, true);
+	dRender->DebugRender3DText(pos, rotation, buffer, cellHeight, options, alignment, true);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -253,11 +253,11 @@ void DebugRenderTagv(float lifeTime, const Vector3& pos, const Vector3& rotation
 void DebugRenderText2D(float lifeTime, const Vector2& pos, const Vector2& alignment, float cellHeight, const Rgba& color, char const *format, ...)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
-	options->mode = DEBUG_RENDER_IGNORE_DEPTH;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
+	options.mode = DEBUG_RENDER_IGNORE_DEPTH;
 
 	const int MAX_LENGTH = 2048;
 	char buffer[MAX_LENGTH];
@@ -267,7 +267,7 @@ void DebugRenderText2D(float lifeTime, const Vector2& pos, const Vector2& alignm
 	va_end(varArgs);
 	buffer[MAX_LENGTH - 1] = '\0';
 
-	dRender->DebugRender2DText(pos, buffer, cellHeight, *options, alignment);
+	dRender->DebugRender2DText(pos, buffer, cellHeight, options, alignment);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -276,13 +276,13 @@ void DebugRenderText2D(float lifeTime, const Vector2& pos, const Vector2& alignm
 void DebugRenderQuad2D(float lifeTime, const AABB2& bounds, const Rgba& color)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->startColor = color;
-	options->endColor = color;
-	options->lifetime = lifeTime;
-	options->mode = DEBUG_RENDER_IGNORE_DEPTH;
+	DebugRenderOptions options;
+	options.startColor = color;
+	options.endColor = color;
+	options.lifetime = lifeTime;
+	options.mode = DEBUG_RENDER_IGNORE_DEPTH;
 
-	dRender->DebugRender2DQuad(bounds, *options);
+	dRender->DebugRender2DQuad(bounds, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -307,13 +307,10 @@ void DebugRenderQuad2D(float lifeTime, const Vector2& position, float sizeX, flo
 void DebugRenderBasis(float lifeTime, const Vector3& pos, const Vector3& rotation, float scale /*= 1.0f */)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.lifetime = lifeTime;
 
-	Transform localTransform;
-	localTransform.Translate(pos);
-	localTransform.SetEulerAngles(rotation);
-	dRender->DebugRenderBasis(localTransform.GetWorldMatrix(), scale, *options);
+	dRender->DebugRenderBasis(Matrix44::MakeTRS(pos, rotation, Vector3::ONE), scale, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -322,10 +319,10 @@ void DebugRenderBasis(float lifeTime, const Vector3& pos, const Vector3& rotatio
 void DebugRenderBasis(float lifeTime, const Matrix44& modelMatrix, float scale /*= 1.f */)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->lifetime = lifeTime;
+	DebugRenderOptions options;
+	options.lifetime = lifeTime;
 
-	dRender->DebugRenderBasis(modelMatrix, scale, *options);
+	dRender->DebugRenderBasis(modelMatrix, scale, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -356,17 +353,17 @@ void DebugRenderLogf(float lifeTime, const char* format, ...)
 void DebugRenderLogv(float lifeTime, const Rgba& color, const char* format, va_list varArgs)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->lifetime = lifeTime;
-	options->startColor = color;
-	options->endColor = color;
+	DebugRenderOptions options;
+	options.lifetime = lifeTime;
+	options.startColor = color;
+	options.endColor = color;
 	
 	const int MAX_LENGTH = 2048;
 	char buffer[MAX_LENGTH];
 	vsnprintf_s( buffer, MAX_LENGTH, _TRUNCATE, format, varArgs );
 	buffer[MAX_LENGTH - 1] = '\0';
 
-	dRender->DebugRenderLog(buffer, *options);
+	dRender->DebugRenderLog(buffer, options);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -375,12 +372,12 @@ void DebugRenderLogv(float lifeTime, const Rgba& color, const char* format, va_l
 void DebugRenderGrid(float lifeTime, const Vector3& right, const Vector3& up, int uniformSize, const Rgba& color /*= Rgba::WHITE*/)
 {
 	DebugRenderer* dRender = DebugRenderer::GetInstance();
-	DebugRenderOptions* options = new DebugRenderOptions();
-	options->lifetime = lifeTime;
-	options->startColor = color;
-	options->endColor = color;
+	DebugRenderOptions options;
+	options.lifetime = lifeTime;
+	options.startColor = color;
+	options.endColor = color;
 
-	dRender->DebugRenderGrid(right, up, uniformSize, *options);
+	dRender->DebugRenderGrid(right, up, uniformSize, options);
 }
 
 //-----------------------------------------------------------------------------------------------
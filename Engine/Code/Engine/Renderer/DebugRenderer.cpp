@@ -7,20 +7,54 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Console/Command.hpp"
 #include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Console/DevConsole.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Core/Window.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Renderer/Shader.hpp"
-#include "Engine/Math/Transform.hpp"
+#include "Engine/Renderer/Sampler.hpp"
+#include "Engine/Renderer/Buffers/StorageBuffer.hpp"
+#include "Engine/Enumerations/ReservedStorageBlock.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
 #include "Engine/Renderer/Mesh/Mesh.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 //-----------------------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------------------------
+// Depth test of one pass of a debug render mode. Faded passes draw with an alpha of 100
+//
+struct DebugDepthPass
+{
+	DepthTestOp		m_compare;
+	bool			m_isFaded;
+};
+
 //-----------------------------------------------------------------------------------------------
 // Static Globals
 static DebugRenderer* g_debugRenderer = nullptr;
 std::vector<DebugRenderObject*>	DebugRenderer::s_debugObjects;
 std::vector<DebugRenderObject*>	DebugRenderer::s_debugLogBuffer;
+std::vector<DebugRenderObject*>	DebugRenderer::s_freeObjects;
+
+// XRAY draws the hidden part faded before the visible part
+static const int			s_depthPassCounts[NUM_DEBUG_RENDER_MODES] = { 1, 1, 1, 2 };
+static const DebugDepthPass	s_depthPasses[NUM_DEBUG_RENDER_MODES][2] =
+{
+	{ { COMPARE_ALWAYS, false },	{ COMPARE_ALWAYS, false } },	// DEBUG_RENDER_IGNORE_DEPTH
+	{ { COMPARE_LESS, false },		{ COMPARE_LESS, false } },		// DEBUG_RENDER_USE_DEPTH
+	{ { COMPARE_GREATER, false },	{ COMPARE_GREATER, false } },	// DEBUG_RENDER_HIDDEN
+	{ { COMPARE_GREATER, true },	{ COMPARE_LESS, false } }		// DEBUG_RENDER_XRAY
+};
+
+//-----------------------------------------------------------------------------------------------
+// Modulates two colors
+//
+static Rgba MultiplyColors(const Rgba& first, const Rgba& second)
+{
+	return Rgba(first.r * second.r, first.g * second.g, first.b * second.b, first.a * second.a);
+}
 
 //-----------------------------------------------------------------------------------------------
 // Destructor
@@ -61,6 +95,33 @@ bool DebugRenderer::ShowDebugCommand(Command& cmd)
 	return true;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Command callback that scatters random lines around the origin to time the line streams
+// Usage: debugbench [lineCount = 50000] [lifetime = 10]
+//
+bool DebugRenderer::BenchmarkCommand(Command& cmd)
+{
+	int lineCount = 50000;
+	float lifetime = 10.f;
+	cmd.GetNextInt(lineCount);
+	cmd.GetNextFloat(lifetime);
+
+	DebugRenderOptions options;
+	options.lifetime = lifetime;
+	for(int lineIndex = 0; lineIndex < lineCount; ++lineIndex)
+	{
+		Vector3 start = Vector3(GetRandomFloatInRange(-50.f, 50.f), GetRandomFloatInRange(-50.f, 50.f), GetRandomFloatInRange(-50.f, 50.f));
+		Vector3 offset = Vector3(GetRandomFloatInRange(-2.f, 2.f), GetRandomFloatInRange(-2.f, 2.f), GetRandomFloatInRange(-2.f, 2.f));
+		options.startColor = Rgba(GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f));
+		options.endColor = options.startColor;
+		options.mode = (DebugRenderMode) (lineIndex % NUM_DEBUG_RENDER_MODES);
+		g_debugRenderer->DebugRenderLineSegment(start, start + offset, options);
+	}
+
+	ConsolePrintf("Added %d debug lines for %.1f seconds", lineCount, lifetime);
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Creates a debug renderer instance
 //
@@ -107,9 +168,25 @@ void DebugRenderer::Startup()
 	// Setup projection on the 2D camera
 	Window* window = Window::GetInstance();
 	m_debug2DCamera->SetOrtho(0.f, window->m_width, 0.f, window->m_height, 0.f, 1.f);
-	
+
+	// Everything the batches draw with is built once
+	m_lineShader = Shader::AcquireResource("Data/Shaders/debug.shader");
+	m_instanceShader = Shader::AcquireResource("Data/Shaders/debug_instanced.shader");
+	m_textShader = Shader::AcquireResource("Data/Shaders/debug_sdf.shader");
+	for(int spaceIndex = 0; spaceIndex < NUM_DEBUG_SPACES; ++spaceIndex)
+	{
+		for(int modeIndex = 0; modeIndex < NUM_DEBUG_RENDER_MODES; ++modeIndex)
+		{
+			m_lineStreams[spaceIndex][modeIndex] = new Mesh();
+		}
+	}
+	m_unitQuad = CreateQuad(Vector2(-0.5f, -0.5f), Vector2(0.5f, 0.5f));
+	m_unitCube = CreateCube(Vector3::ZERO, Vector3::ONE);
+	m_instanceBuffer = new StorageBuffer();
+
 	COMMAND("showdebug", ShowDebugCommand, "Enables/Disables debug draws");
 	COMMAND("cleardebug", ClearCommand, "Clears all debug draws");
+	COMMAND("debugbench", BenchmarkCommand, "Adds random debug lines. debugbench [lineCount] [lifetime]");
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -117,14 +194,63 @@ void DebugRenderer::Startup()
 //
 void DebugRenderer::Shutdown()
 {
-	g_debugRenderer->ClearDebugRenders();
+	ClearDebugRenders();
+
+	for(DebugRenderObject* debugObj : s_freeObjects)
+	{
+		delete debugObj;
+	}
+	s_freeObjects.clear();
+
+	for(int spaceIndex = 0; spaceIndex < NUM_DEBUG_SPACES; ++spaceIndex)
+	{
+		for(int modeIndex = 0; modeIndex < NUM_DEBUG_RENDER_MODES; ++modeIndex)
+		{
+			delete m_lineStreams[spaceIndex][modeIndex];
+			m_lineStreams[spaceIndex][modeIndex] = nullptr;
+		}
+	}
+
+	for(size_t sphereIndex = 0; sphereIndex < m_unitSpheres.size(); ++sphereIndex)
+	{
+		delete m_unitSpheres[sphereIndex].second;
+	}
+	m_unitSpheres.clear();
+
+	delete m_unitQuad;
+	m_unitQuad = nullptr;
+
+	delete m_unitCube;
+	m_unitCube = nullptr;
+
+	delete m_instanceBuffer;
+	m_instanceBuffer = nullptr;
+
+	delete m_lineShader;
+	m_lineShader = nullptr;
+
+	delete m_instanceShader;
+	m_instanceShader = nullptr;
+
+	delete m_textShader;
+	m_textShader = nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Clears all debug renders
+// Clears all debug renders, the objects go back to the pool
 //
 void DebugRenderer::ClearDebugRenders()
 {
+	for(DebugRenderObject* debugObj : s_debugObjects)
+	{
+		ReleaseObject(debugObj);
+	}
+
+	for(DebugRenderObject* logText : s_debugLogBuffer)
+	{
+		ReleaseObject(logText);
+	}
+
 	s_debugObjects.clear();
 	s_debugLogBuffer.clear();
 }
@@ -146,21 +272,21 @@ void DebugRenderer::Update(float deltaSeconds)
 	{
 		logText->Update(deltaSeconds);
 	}
-
-	
 }
 
 //-----------------------------------------------------------------------------------------------
 // Renders the debug render objects
 //
-void DebugRenderer::Render() const
+void DebugRenderer::Render()
 {
+	PROFILE_SCOPE_FUNCTION();
 	if(IsDebugEnabled())
 	{
-		for (DebugRenderObject* debug : s_debugObjects)
-		{
-			debug->Render();
-		}
+		// One upload of every instance for both cameras
+		BuildInstanceBatches();
+
+		RenderSpace(DEBUG_SPACE_WORLD);
+		RenderSpace(DEBUG_SPACE_SCREEN);
 
 		RenderLog();
 	}
@@ -169,37 +295,61 @@ void DebugRenderer::Render() const
 //-----------------------------------------------------------------------------------------------
 // Renders the debug log on the screen
 //
-void DebugRenderer::RenderLog() const
+void DebugRenderer::RenderLog()
 {
 	Window* window = Window::GetInstance();
 	// Font size as a ratio of the screen height
 	float fontSize = window->m_height * m_logTextScreenRatio;
 
+	Renderer* rend = Renderer::GetInstance();
+	rend->SetCamera(m_debug2DCamera);
+
+	if(s_debugLogBuffer.empty())
+	{
+		return;
+	}
+
+	// The log sits on top of everything, the line colors go in the vertices
+	m_lineShader->SetFillMode(FILLMODE_SOLID);
+	m_lineShader->DisableDepth();
+	rend->SetShader(m_lineShader);
+	rend->SetDefaultMaterial();
+	rend->SetUniform("CURCOLOR", Rgba::WHITE);
+
+	BitmapFont* font = rend->CreateOrGetSDFFont("SquirrelFixedFont");
 	Vector2 drawMins;
 	drawMins.y = window->m_height * 0.99f;
 	drawMins.x = window->m_width * 0.05f;
+
+	rend->BeginTextBatch();
 	for (DebugRenderObject* debug : s_debugLogBuffer)
 	{
 		drawMins.y -= fontSize;
-		debug->m_transform->SetPosition(drawMins);
-		debug->Render();
+		rend->DrawText2D(drawMins, debug->m_text, fontSize, font, debug->m_currentColor);
 	}
+	rend->EndTextBatch();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Removes the debug render object from the list
+// Hands finished debug objects back to the pool. Keeps the order so batches draw the same way
+// every frame
 //
 void DebugRenderer::RemoveFinishedDebugObjects()
 {
+	size_t keptCount = 0;
 	for( size_t index = 0; index < s_debugObjects.size(); ++index )
 	{
 		if(s_debugObjects[index]->IsFinished())
 		{
-			delete s_debugObjects[index];
-			s_debugObjects[index] = s_debugObjects[s_debugObjects.size() - 1];
-			s_debugObjects.pop_back();
+			ReleaseObject(s_debugObjects[index]);
+		}
+		else
+		{
+			s_debugObjects[keptCount++] = s_debugObjects[index];
 		}
 	}
+
+	s_debugObjects.resize(keptCount);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -207,15 +357,20 @@ void DebugRenderer::RemoveFinishedDebugObjects()
 //
 void DebugRenderer::RemoveFinishedLogTexts()
 {
+	size_t keptCount = 0;
 	for( size_t index = 0; index < s_debugLogBuffer.size(); ++index )
 	{
 		if(s_debugLogBuffer[index]->IsFinished())
 		{
-			delete s_debugLogBuffer[index];
-			s_debugLogBuffer.erase(s_debugLogBuffer.begin() + index);
-			index--;
+			ReleaseObject(s_debugLogBuffer[index]);
+		}
+		else
+		{
+			s_debugLogBuffer[keptCount++] = s_debugLogBuffer[index];
 		}
 	}
+
+	s_debugLogBuffer.resize(keptCount);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -223,12 +378,15 @@ void DebugRenderer::RemoveFinishedLogTexts()
 //
 void DebugRenderer::DebugRenderPoint(const Vector3& position, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreatePoint(position);
-	
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	// Same star of segments MeshBuilder::AddPoint makes
+	const Vector3 axes[] = { Vector3::RIGHT, Vector3::UP, Vector3::FORWARD, Vector3(0.5f, 0.5f), Vector3(-0.5f, 0.5f),
+		Vector3(0.f, 0.5f, 0.5f), Vector3(0.f, 0.5f, -0.5f) };
+
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_LINES, DEBUG_SPACE_WORLD, options);
+	for(const Vector3& axis : axes)
+	{
+		debugObj->AddLine(position - (axis * POINT_RENDER_SCALE), position + (axis * POINT_RENDER_SCALE));
+	}
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -238,18 +396,12 @@ void DebugRenderer::DebugRenderPoint(const Vector3& position, const DebugRenderO
 //
 void DebugRenderer::DebugRenderQuad( const Vector3& position, const Vector3& euler, const Vector2& scale, const DebugRenderOptions& options, bool isFacingCamera /*= false*/, const Texture* texture /*= nullptr*/)
 {
-	Mesh* mesh = CreateQuad(Vector2(-0.5f, -0.5f), Vector2(0.5f, 0.5f));
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
-	debugObj->SetTexture(texture);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_INSTANCE, DEBUG_SPACE_WORLD, options);
+	debugObj->m_mesh = m_unitQuad;
+	debugObj->m_texture = texture;
 	debugObj->OrientToCamera(isFacingCamera);
-	debugObj->m_shader->SetCullMode(CULLMODE_NONE);
-	debugObj->m_transform->SetPosition(position);
-	debugObj->m_transform->SetEulerAngles(euler);
-	debugObj->m_transform->SetScale(scale);
+	debugObj->SetTransform(position, euler, Vector3(scale.x, scale.y, 1.f));
+
 	s_debugObjects.push_back(debugObj);
 }
 
@@ -258,30 +410,23 @@ void DebugRenderer::DebugRenderQuad( const Vector3& position, const Vector3& eul
 //
 void DebugRenderer::DebugRenderLineSegment(const Vector3& start, const Vector3& end, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreateLine(start, end);
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_LINES, DEBUG_SPACE_WORLD, options);
+	debugObj->AddLine(start, end);
 
 	s_debugObjects.push_back(debugObj);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws a sphere on the screen 
+// Draws a sphere on the screen
 //
-void DebugRenderer::DebugRenderSphere(const Vector3& origin, float radius, uint wedges, uint slices, FillMode fillMode, const DebugRenderOptions& options, 
+void DebugRenderer::DebugRenderSphere(const Vector3& origin, float radius, uint wedges, uint slices, FillMode fillMode, const DebugRenderOptions& options,
 	const Texture* texture /*= nullptr*/)
 {
-	Mesh* mesh = CreateUVSphere(origin, radius, wedges, slices);
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
-	debugObj->SetFillMode(fillMode);
-	debugObj->SetTexture(texture);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_INSTANCE, DEBUG_SPACE_WORLD, options);
+	debugObj->m_mesh = CreateOrGetUnitSphere(wedges, slices);
+	debugObj->m_fillMode = fillMode;
+	debugObj->m_texture = texture;
+	debugObj->SetTransform(origin, Vector3::ZERO, Vector3(radius));
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -291,14 +436,11 @@ void DebugRenderer::DebugRenderSphere(const Vector3& origin, float radius, uint
 //
 void DebugRenderer::DebugRenderAABB3(const Vector3& position, const Vector3& size, FillMode fillMode, const DebugRenderOptions& options, const Texture* texture /*= nullptr */)
 {
-	Mesh* mesh = CreateCube(position, size);
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
-	debugObj->SetFillMode(fillMode);
-	debugObj->SetTexture(texture);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_INSTANCE, DEBUG_SPACE_WORLD, options);
+	debugObj->m_mesh = m_unitCube;
+	debugObj->m_fillMode = fillMode;
+	debugObj->m_texture = texture;
+	debugObj->SetTransform(position, Vector3::ZERO, size);
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -308,12 +450,12 @@ void DebugRenderer::DebugRenderAABB3(const Vector3& position, const Vector3& siz
 //
 void DebugRenderer::DebugRenderBasis(const Matrix44& basis, float scale, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreateBasisMesh(basis, scale);
+	Vector3 origin = basis.GetTranslation();
 
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_LINES, DEBUG_SPACE_WORLD, options);
+	debugObj->AddLine(origin, origin + (basis.GetRight() * scale), Rgba::RED, Rgba::RED);
+	debugObj->AddLine(origin, origin + (basis.GetUp() * scale), Rgba::GREEN, Rgba::GREEN);
+	debugObj->AddLine(origin, origin + (basis.GetForward() * scale), Rgba::BLUE, Rgba::BLUE);
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -323,33 +465,39 @@ void DebugRenderer::DebugRenderBasis(const Matrix44& basis, float scale, const D
 //
 void DebugRenderer::DebugRenderGrid(const Vector3& right, const Vector3& up, int uniformSize, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreateGridMesh(right, up, uniformSize);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_LINES, DEBUG_SPACE_WORLD, options);
 
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	float offset = -uniformSize * 0.5f;
+	Vector3 drawMins = (right * offset) + (up * offset);
+	for(int rowIndex = 0; rowIndex <= uniformSize; ++rowIndex)
+	{
+		debugObj->AddLine(drawMins, drawMins + (right * (float) uniformSize));
+		drawMins += up;
+	}
+
+	drawMins = (right * offset) + (up * offset);
+	for(int colIndex = 0; colIndex <= uniformSize; ++colIndex)
+	{
+		debugObj->AddLine(drawMins, drawMins + (up * (float) uniformSize));
+		drawMins += right;
+	}
 
 	s_debugObjects.push_back(debugObj);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws 3D text on the screen 
+// Draws 3D text on the screen
 //
-void DebugRenderer::DebugRender3DText(const Vector3& position, const Vector3& euler, const std::string& text, float cellHeight, const DebugRenderOptions& options, 
+void DebugRenderer::DebugRender3DText(const Vector3& position, const Vector3& euler, const std::string& text, float cellHeight, const DebugRenderOptions& options,
 									const Vector2& alignment, bool isFacingCamera /*= false */)
 {
-	BitmapFont* font = Renderer::GetInstance()->CreateOrGetBitmapFont("SquirrelFixedFont");
-	Mesh* mesh = CreateTextMesh2D(Vector3::ZERO, text, cellHeight, font, Rgba::WHITE, alignment);
+	BitmapFont* font = Renderer::GetInstance()->CreateOrGetSDFFont("SquirrelFixedFont");
 
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug3DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_TEXT, DEBUG_SPACE_WORLD, options);
+	debugObj->m_mesh = CreateTextMesh2D(Vector3::ZERO, text, cellHeight, font, Rgba::WHITE, alignment);
+	debugObj->m_texture = font->GetSpriteSheetTexture();
 	debugObj->OrientToCamera(isFacingCamera);
-	debugObj->SetTexture(font->GetSpriteSheetTexture());
-	debugObj->m_transform->SetPosition(position);
-	debugObj->m_transform->SetEulerAngles(euler);
+	debugObj->SetTransform(position, euler, Vector3::ONE);
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -359,12 +507,11 @@ void DebugRenderer::DebugRender3DText(const Vector3& position, const Vector3& eu
 //
 void DebugRenderer::DebugRender2DQuad(const AABB2& bounds, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreateQuad(bounds.mins, bounds.maxs);
+	Vector2 size = bounds.maxs - bounds.mins;
 
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug2DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_INSTANCE, DEBUG_SPACE_SCREEN, options);
+	debugObj->m_mesh = m_unitQuad;
+	debugObj->SetTransform(bounds.mins + (size * 0.5f), Vector3::ZERO, Vector3(size.x, size.y, 1.f));
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -374,12 +521,8 @@ void DebugRenderer::DebugRender2DQuad(const AABB2& bounds, const DebugRenderOpti
 //
 void DebugRenderer::DebugRender2DLine(const Vector2& start, const Vector2& end, const Rgba& startVertColor, const Rgba& endVertColor, const DebugRenderOptions& options)
 {
-	Mesh* mesh = CreateLine(start, end, startVertColor, endVertColor);
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug2DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_LINES, DEBUG_SPACE_SCREEN, options);
+	debugObj->AddLine(start, end, startVertColor, endVertColor);
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -389,14 +532,11 @@ void DebugRenderer::DebugRender2DLine(const Vector2& start, const Vector2& end,
 //
 void DebugRenderer::DebugRender2DText(const Vector2& position, const std::string& text, float cellHeight, const DebugRenderOptions& options, const Vector2& alignment)
 {
-	BitmapFont* font = Renderer::GetInstance()->CreateOrGetBitmapFont("SquirrelFixedFont");
-	Mesh* mesh = CreateTextMesh2D(position, text, cellHeight, font, Rgba::WHITE, alignment);  // Color set by shader
+	BitmapFont* font = Renderer::GetInstance()->CreateOrGetSDFFont("SquirrelFixedFont");
 
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug2DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
-	debugObj->SetTexture(font->GetSpriteSheetTexture());
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_TEXT, DEBUG_SPACE_SCREEN, options);
+	debugObj->m_mesh = CreateTextMesh2D(position, text, cellHeight, font, Rgba::WHITE, alignment);  // Color set by shader
+	debugObj->m_texture = font->GetSpriteSheetTexture();
 
 	s_debugObjects.push_back(debugObj);
 }
@@ -406,119 +546,363 @@ void DebugRenderer::DebugRender2DText(const Vector2& position, const std::string
 //
 void DebugRenderer::DebugRenderLog(const std::string& text, const DebugRenderOptions& options)
 {
-	BitmapFont* font = Renderer::GetInstance()->CreateOrGetBitmapFont("SquirrelFixedFont");
-	float fontSize = Window::GetInstance()->m_height * m_logTextScreenRatio;
-	Mesh* mesh = CreateTextMesh2D(Vector3::ZERO, text, fontSize, font);  // Color set by shader
-
-	DebugRenderObject* debugObj = new DebugRenderObject();
-	debugObj->SetDebugCamera(m_debug2DCamera);
-	debugObj->SetMesh(mesh);
-	debugObj->SetRenderOptions(options);
-	debugObj->SetTexture(font->GetSpriteSheetTexture());
+	// Laid out and batched by the renderer when drawn, the layout is cached while the line lives
+	DebugRenderObject* debugObj = AcquireObject(DEBUG_SHAPE_TEXT, DEBUG_SPACE_SCREEN, options);
+	debugObj->m_text = text;
 
 	s_debugLogBuffer.push_back(debugObj);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Constructor
+// Takes a blank object from the pool, or makes one when the pool is empty. The caller adds it
+// to the list it belongs in
 //
-DebugRenderObject::DebugRenderObject()
+DebugRenderObject* DebugRenderer::AcquireObject(DebugRenderShape shape, DebugRenderSpace space, const DebugRenderOptions& options)
 {
-	m_shader = Shader::AcquireResource("Data/Shaders/debug.shader");
-	m_transform = new Transform();
+	DebugRenderObject* debugObj = nullptr;
+	if(s_freeObjects.empty())
+	{
+		debugObj = new DebugRenderObject();
+	}
+	else
+	{
+		debugObj = s_freeObjects.back();
+		s_freeObjects.pop_back();
+	}
+
+	debugObj->m_shape = shape;
+	debugObj->m_space = space;
+	debugObj->m_currentColor = options.startColor;
+	debugObj->SetRenderOptions(options);
+	return debugObj;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Destructor
+// Hands the object back to the pool
 //
-DebugRenderObject::~DebugRenderObject()
+void DebugRenderer::ReleaseObject(DebugRenderObject* debugObj)
 {
-	delete m_transform;
-	m_transform = nullptr;
+	debugObj->Reset();
+	s_freeObjects.push_back(debugObj);
+}
 
-	delete m_shader;
-	m_shader = nullptr;
+//-----------------------------------------------------------------------------------------------
+// Returns the unit sphere with the tessellation, building it the first time it's asked for
+//
+Mesh* DebugRenderer::CreateOrGetUnitSphere(uint wedges, uint slices)
+{
+	uint key = (wedges << 16) | (slices & 0xFFFF);
+	for(size_t sphereIndex = 0; sphereIndex < m_unitSpheres.size(); ++sphereIndex)
+	{
+		if(m_unitSpheres[sphereIndex].first == key)
+		{
+			return m_unitSpheres[sphereIndex].second;
+		}
+	}
 
-	delete m_mesh;
-	m_mesh = nullptr;
+	Mesh* sphere = CreateUVSphere(Vector3::ZERO, 1.f, wedges, slices);
+	m_unitSpheres.push_back(std::make_pair(key, sphere));
+	return sphere;
+}
 
+//-----------------------------------------------------------------------------------------------
+// Returns the camera the space draws with
+//
+Camera* DebugRenderer::GetCamera(DebugRenderSpace space) const
+{
+	return (space == DEBUG_SPACE_SCREEN) ? m_debug2DCamera : m_debug3DCamera;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Sets the debug render options
+// Groups this frame's instances by what they draw with and uploads them in one go. Counts
+// first so every batch's instances end up next to each other
 //
-void DebugRenderObject::SetRenderOptions(const Rgba& startColor, const Rgba& endColor, float lifeTime, DebugRenderMode mode /*= DEBUG_RENDER_USE_DEPTH */)
+void DebugRenderer::BuildInstanceBatches()
 {
-	m_options.startColor = startColor;
-	m_options.endColor = endColor;
-	m_options.lifetime = lifeTime;
-	m_options.mode = mode;
+	m_instanceBatches.clear();
+	for(DebugRenderObject* debugObj : s_debugObjects)
+	{
+		if(debugObj->m_shape != DEBUG_SHAPE_INSTANCE)
+		{
+			continue;
+		}
+
+		DebugInstanceBatch batch = { debugObj->m_space, debugObj->m_mesh, debugObj->m_texture, debugObj->m_fillMode, debugObj->m_options.mode, 0, 0 };
+		size_t batchIndex = 0;
+		for(; batchIndex < m_instanceBatches.size(); ++batchIndex)
+		{
+			const DebugInstanceBatch& other = m_instanceBatches[batchIndex];
+			if(other.m_space == batch.m_space && other.m_mesh == batch.m_mesh && other.m_texture == batch.m_texture
+				&& other.m_fillMode == batch.m_fillMode && other.m_mode == batch.m_mode)
+			{
+				break;
+			}
+		}
+
+		if(batchIndex == m_instanceBatches.size())
+		{
+			m_instanceBatches.push_back(batch);
+		}
+		m_instanceBatches[batchIndex].m_instanceCount++;
+	}
+
+	// Hand out the ranges, the counts are rebuilt while filling
+	int instanceCount = 0;
+	for(DebugInstanceBatch& batch : m_instanceBatches)
+	{
+		batch.m_firstInstance = instanceCount;
+		instanceCount += batch.m_instanceCount;
+		batch.m_instanceCount = 0;
+	}
+	m_instances.resize(instanceCount);
+
+	for(const DebugRenderObject* debugObj : s_debugObjects)
+	{
+		if(debugObj->m_shape != DEBUG_SHAPE_INSTANCE)
+		{
+			continue;
+		}
+
+		for(DebugInstanceBatch& batch : m_instanceBatches)
+		{
+			if(batch.m_space == debugObj->m_space && batch.m_mesh == debugObj->m_mesh && batch.m_texture == debugObj->m_texture
+				&& batch.m_fillMode == debugObj->m_fillMode && batch.m_mode == debugObj->m_options.mode)
+			{
+				DebugInstanceData& instance = m_instances[batch.m_firstInstance + batch.m_instanceCount];
+				instance.model = debugObj->GetModelMatrix(GetCamera(debugObj->m_space));
+				debugObj->m_currentColor.GetAsFloats(instance.color[0], instance.color[1], instance.color[2], instance.color[3]);
+				batch.m_instanceCount++;
+				break;
+			}
+		}
+	}
+
+	if(instanceCount > 0)
+	{
+		m_instanceBuffer->Set(m_instances);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Sets the fill mode on the shader 
+// Draws everything seen through the space's camera
 //
-void DebugRenderObject::SetFillMode(FillMode fillMode)
+void DebugRenderer::RenderSpace(DebugRenderSpace space)
 {
-	m_shader->SetFillMode(fillMode);
+	Camera* camera = GetCamera(space);
+	if(camera == nullptr)
+	{
+		return; // No 3D camera given yet
+	}
+
+	Renderer* rend = Renderer::GetInstance();
+	rend->SetCamera(camera);
+
+	RenderLineStreams(space);
+	RenderInstances(space);
+
+	// Text owns its mesh and draws on its own
+	for(const DebugRenderObject* debugObj : s_debugObjects)
+	{
+		if(debugObj->m_shape == DEBUG_SHAPE_TEXT && debugObj->m_space == space)
+		{
+			rend->SetTexture(0, (Texture*) debugObj->m_texture, Sampler::GetLinearSampler());
+			DrawDepthPasses(m_textShader, debugObj->m_options.mode, FILLMODE_SOLID, debugObj->m_mesh, 1, debugObj->GetModelMatrix(camera), debugObj->m_currentColor);
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Updates the render object
+// Copies the segments of every line object in the space into the stream of its mode and draws
+// each stream once. The colors are applied on the way in so the streams draw untinted
 //
-void DebugRenderObject::Update(float deltaSeconds)
+void DebugRenderer::RenderLineStreams(DebugRenderSpace space)
 {
-	m_elapsedSeconds += deltaSeconds;
-	float fractionTowardsEnd = m_options.lifetime == 0.f ? 1.f : m_elapsedSeconds * 1.f / m_options.lifetime;
+	// Counted first so each stream is mapped once at its final size
+	uint vertexCounts[NUM_DEBUG_RENDER_MODES] = {};
+	for(const DebugRenderObject* debugObj : s_debugObjects)
+	{
+		if(debugObj->m_shape == DEBUG_SHAPE_LINES && debugObj->m_space == space)
+		{
+			vertexCounts[debugObj->m_options.mode] += (uint) debugObj->m_lineVertices.size();
+		}
+	}
 
-	if(m_elapsedSeconds >= m_options.lifetime)
+	Vertex_3DPCU* writeHeads[NUM_DEBUG_RENDER_MODES] = {};
+	for(int modeIndex = 0; modeIndex < NUM_DEBUG_RENDER_MODES; ++modeIndex)
 	{
-		m_isFinished = true;
-		fractionTowardsEnd = 1.f;
+		if(vertexCounts[modeIndex] > 0)
+		{
+			writeHeads[modeIndex] = (Vertex_3DPCU*) m_lineStreams[space][modeIndex]->MapVertices(vertexCounts[modeIndex], Vertex_3DPCU::s_layout);
+		}
 	}
 
-	if(m_isCameraOriented)
+	for(const DebugRenderObject* debugObj : s_debugObjects)
 	{
-		Vector3 euler = m_camera->m_transform.GetEulerAngles();
-		m_transform->SetEulerAngles(euler);
+		if(debugObj->m_shape != DEBUG_SHAPE_LINES || debugObj->m_space != space)
+		{
+			continue;
+		}
+
+		Vertex_3DPCU*& writeHead = writeHeads[debugObj->m_options.mode];
+		for(const Vertex_3DPCU& vertex : debugObj->m_lineVertices)
+		{
+			writeHead->m_position = vertex.m_position;
+			writeHead->m_color = MultiplyColors(vertex.m_color, debugObj->m_currentColor);
+			writeHead->m_UVs = vertex.m_UVs;
+			++writeHead;
+		}
 	}
 
-	m_currentColor = Interpolate(m_options.startColor, m_options.endColor, fractionTowardsEnd);
+	Renderer* rend = Renderer::GetInstance();
+	for(int modeIndex = 0; modeIndex < NUM_DEBUG_RENDER_MODES; ++modeIndex)
+	{
+		if(vertexCounts[modeIndex] == 0)
+		{
+			continue;
+		}
+
+		Mesh* stream = m_lineStreams[space][modeIndex];
+		stream->UnmapVertices();
+		stream->SetDrawInstructions(PRIMITIVE_LINES, false, 0, vertexCounts[modeIndex]);
+
+		rend->SetTexture(nullptr);
+		DrawDepthPasses(m_lineShader, (DebugRenderMode) modeIndex, FILLMODE_SOLID, stream, 1, Matrix44::IDENTITY, Rgba::WHITE);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-// Renders the debug object
+// Draws the space's batches of unit meshes, one instanced draw per batch
 //
-void DebugRenderObject::Render() const
+void DebugRenderer::RenderInstances(DebugRenderSpace space)
 {
+	if(m_instances.empty())
+	{
+		return;
+	}
+
 	Renderer* rend = Renderer::GetInstance();
-	rend->SetCamera(m_camera);
-	rend->SetTexture((Texture*) m_texture);
-	rend->SetShader(m_shader);
-	rend->SetUniform("CURCOLOR", m_currentColor);
-	rend->SetDefaultMaterial();
+	rend->BindSSBO(STORAGE_DEBUG_INSTANCES, m_instanceBuffer);
 
-	if(m_options.mode == DEBUG_RENDER_IGNORE_DEPTH)
+	for(const DebugInstanceBatch& batch : m_instanceBatches)
 	{
-		m_shader->SetDepthTest(COMPARE_ALWAYS, true);
+		if(batch.m_space != space)
+		{
+			continue;
+		}
+
+		rend->SetTexture((Texture*) batch.m_texture);
+		rend->SetUniform("INSTANCE_OFFSET", batch.m_firstInstance);
+		DrawDepthPasses(m_instanceShader, batch.m_mode, batch.m_fillMode, batch.m_mesh, batch.m_instanceCount, Matrix44::IDENTITY, Rgba::WHITE);
 	}
-	else if(m_options.mode == DEBUG_RENDER_XRAY)
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws the mesh once per depth pass of the mode
+//
+void DebugRenderer::DrawDepthPasses(Shader* shader, DebugRenderMode mode, FillMode fillMode, Mesh* mesh, int instanceCount, const Matrix44& modelMatrix, const Rgba& tint)
+{
+	Renderer* rend = Renderer::GetInstance();
+	shader->SetFillMode(fillMode);
+	rend->SetShader(shader);
+	rend->SetDefaultMaterial();
+
+	for(int passIndex = 0; passIndex < s_depthPassCounts[mode]; ++passIndex)
 	{
-		rend->SetUniform("CURCOLOR", Rgba(m_currentColor.r, m_currentColor.g, m_currentColor.b, 100));
-		m_shader->SetDepthTest(COMPARE_GREATER, true);
-		rend->DrawMesh(m_mesh, m_transform->GetWorldMatrix());
-		rend->SetUniform("CURCOLOR", m_currentColor);
-		m_shader->SetDepthTest(COMPARE_LESS, true);
+		const DebugDepthPass& pass = s_depthPasses[mode][passIndex];
+		shader->SetDepthTest(pass.m_compare, true);
+		rend->SetUniform("CURCOLOR", pass.m_isFaded ? Rgba(tint.r, tint.g, tint.b, 100) : tint);
+		rend->DrawMeshInstanced(mesh, instanceCount, modelMatrix);
 	}
-	else if(m_options.mode == DEBUG_RENDER_HIDDEN)
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+DebugRenderObject::~DebugRenderObject()
+{
+	Reset();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the debug render options
+//
+void DebugRenderObject::SetRenderOptions(const Rgba& startColor, const Rgba& endColor, float lifeTime, DebugRenderMode mode /*= DEBUG_RENDER_USE_DEPTH */)
+{
+	m_options.startColor = startColor;
+	m_options.endColor = endColor;
+	m_options.lifetime = lifeTime;
+	m_options.mode = mode;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets where the object's mesh is placed
+//
+void DebugRenderObject::SetTransform(const Vector3& position, const Vector3& euler, const Vector3& scale)
+{
+	m_position = position;
+	m_euler = euler;
+	m_scale = scale;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the model matrix, taking the camera's rotation when oriented towards it
+//
+Matrix44 DebugRenderObject::GetModelMatrix(const Camera* camera) const
+{
+	Vector3 euler = m_isCameraOriented ? camera->m_transform.GetEulerAngles() : m_euler;
+	return Matrix44::MakeTRS(m_position, euler, m_scale);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Clears the object for reuse. Text meshes are the only thing it owns
+//
+void DebugRenderObject::Reset()
+{
+	if(m_shape == DEBUG_SHAPE_TEXT)
 	{
-		m_shader->SetDepthTest(COMPARE_GREATER, true);
+		delete m_mesh;
 	}
-	else
+
+	m_shape = DEBUG_SHAPE_LINES;
+	m_space = DEBUG_SPACE_WORLD;
+	m_mesh = nullptr;
+	m_texture = nullptr;
+	m_fillMode = FILLMODE_SOLID;
+	m_isFinished = false;
+	m_isCameraOriented = false;
+	m_elapsedSeconds = 0.f;
+	m_options = DebugRenderOptions();
+	m_position = Vector3::ZERO;
+	m_euler = Vector3::ZERO;
+	m_scale = Vector3::ONE;
+	m_lineVertices.clear();
+	m_text.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a segment, the colors are tinted by the current color when drawn
+//
+void DebugRenderObject::AddLine(const Vector3& start, const Vector3& end, const Rgba& startColor /*= Rgba::WHITE*/, const Rgba& endColor /*= Rgba::WHITE */)
+{
+	m_lineVertices.push_back(Vertex_3DPCU(start, startColor, Vector2::ZERO));
+	m_lineVertices.push_back(Vertex_3DPCU(end, endColor, Vector2::ZERO));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Updates the render object
+//
+void DebugRenderObject::Update(float deltaSeconds)
+{
+	m_elapsedSeconds += deltaSeconds;
+	float fractionTowardsEnd = m_options.lifetime == 0.f ? 1.f : m_elapsedSeconds * 1.f / m_options.lifetime;
+
+	if(m_elapsedSeconds >= m_options.lifetime)
 	{
-		m_shader->SetDepthTest(COMPARE_LESS, true);
+		m_isFinished = true;
+		fractionTowardsEnd = 1.f;
 	}
-	rend->DrawMesh(m_mesh, m_transform->GetWorldMatrix());
+
+	m_currentColor = Interpolate(m_options.startColor, m_options.endColor, fractionTowardsEnd);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -2,7 +2,11 @@
 #include <vector>
 #include <string>
 #include "Engine/Core/Rgba.hpp"
+#include "Engine/Core/Vertex.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Enumerations/FillMode.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -11,8 +15,7 @@ class Camera;
 class Texture;
 class Command;
 class Shader;
-class Transform;
-enum FillMode;
+class StorageBuffer;
 
 typedef unsigned int uint;
 
@@ -22,7 +25,26 @@ enum DebugRenderMode
 	DEBUG_RENDER_IGNORE_DEPTH, // will always draw and be visible 
 	DEBUG_RENDER_USE_DEPTH,    // draw using normal depth rules
 	DEBUG_RENDER_HIDDEN,       // only draws if it would be hidden by depth
-	DEBUG_RENDER_XRAY         // always draws, but hidden area will be drawn differently
+	DEBUG_RENDER_XRAY,         // always draws, but hidden area will be drawn differently
+	NUM_DEBUG_RENDER_MODES
+};
+
+//-----------------------------------------------------------------------------------------------
+// How a debug object reaches the screen
+//
+enum DebugRenderShape
+{
+	DEBUG_SHAPE_LINES,		// Segments copied into the line stream of its mode every frame
+	DEBUG_SHAPE_INSTANCE,	// One instance of a shared unit mesh
+	DEBUG_SHAPE_TEXT		// Owns its text mesh and draws on its own, log lines keep only the string
+};
+
+//-----------------------------------------------------------------------------------------------
+enum DebugRenderSpace
+{
+	DEBUG_SPACE_WORLD,		// Debug 3D camera
+	DEBUG_SPACE_SCREEN,		// Debug 2D camera, in pixels
+	NUM_DEBUG_SPACES
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -42,44 +64,81 @@ struct DebugRenderOptions
 }; 
 
 //-----------------------------------------------------------------------------------------------
+// Per instance data of the instanced debug shader, matches DebugInstance in debug.vs (std430)
+//
+struct DebugInstanceData
+{
+	Matrix44	model;
+	float		color[4];
+};
+
+//-----------------------------------------------------------------------------------------------
+// One draw of a shared mesh, a run of instances in the frame's instance buffer
+//
+struct DebugInstanceBatch
+{
+	DebugRenderSpace	m_space;
+	Mesh*				m_mesh;
+	const Texture*		m_texture;
+	FillMode			m_fillMode;
+	DebugRenderMode		m_mode;
+	int					m_firstInstance;
+	int					m_instanceCount;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Pooled by the debug renderer, nothing is freed until shutdown. Only text owns a mesh, the
+// rest are either line segments or a transform of a shared unit mesh
+//
 struct DebugRenderObject
 {
+	MEMORY_TAG_CLASS(MEMORY_TAG_DEBUG_RENDER)
+
 	//-----------------------------------------------------------------------------------------------
 	// Constructor
-	DebugRenderObject();
+	DebugRenderObject() {}
 	~DebugRenderObject();
 
 	//-----------------------------------------------------------------------------------------------
 	// Accessors / Mutators
-	bool	IsFinished() const { return m_isFinished; }
-	void	SetRenderOptions( const DebugRenderOptions& options ) { m_options = options; }
-	void	SetRenderOptions( const Rgba& startColor, const Rgba& endColor, float lifeTime, DebugRenderMode mode = DEBUG_RENDER_USE_DEPTH );
-	void	SetDebugCamera( Camera* cam ) { m_camera = cam; }
-	void	SetMesh( Mesh* mesh ) { m_mesh = mesh; }
-	void	SetFillMode( FillMode fillMode );
-	void	SetTexture( const Texture* texture ) { m_texture = texture; }
-	void	OrientToCamera( bool flag ) { m_isCameraOriented = flag; }
+	bool		IsFinished() const { return m_isFinished; }
+	void		SetRenderOptions( const DebugRenderOptions& options ) { m_options = options; }
+	void		SetRenderOptions( const Rgba& startColor, const Rgba& endColor, float lifeTime, DebugRenderMode mode = DEBUG_RENDER_USE_DEPTH );
+	void		SetTransform( const Vector3& position, const Vector3& euler, const Vector3& scale );
+	void		OrientToCamera( bool flag ) { m_isCameraOriented = flag; }
+	Matrix44	GetModelMatrix( const Camera* camera ) const;
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
-	void	Update( float deltaSeconds );
-	void	Render() const;
+	void		Reset(); // Back to a blank object for the pool, keeps the line storage
+	void		AddLine( const Vector3& start, const Vector3& end, const Rgba& startColor = Rgba::WHITE, const Rgba& endColor = Rgba::WHITE );
+	void		Update( float deltaSeconds );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
-			Camera*				m_camera = nullptr;
-			Mesh*				m_mesh = nullptr;
-	const	Texture*			m_texture = nullptr;
-			bool				m_isFinished = false;
-			bool				m_isCameraOriented = false;
-			float				m_elapsedSeconds = 0.f;
-			Rgba				m_currentColor;
-			DebugRenderOptions	m_options;
-			Shader*				m_shader = nullptr;
-			Transform*			m_transform = nullptr;
+			DebugRenderShape			m_shape = DEBUG_SHAPE_LINES;
+			DebugRenderSpace			m_space = DEBUG_SPACE_WORLD;
+			Mesh*						m_mesh = nullptr;			// Shared unit mesh, or the text mesh it owns
+	const	Texture*					m_texture = nullptr;
+			FillMode					m_fillMode = FILLMODE_SOLID;
+			bool						m_isFinished = false;
+			bool						m_isCameraOriented = false;
+			float						m_elapsedSeconds = 0.f;
+			Rgba						m_currentColor;
+			DebugRenderOptions			m_options;
+			Vector3						m_position;
+			Vector3						m_euler;
+			Vector3						m_scale = Vector3::ONE;
+			std::vector<Vertex_3DPCU>	m_lineVertices;				// Pairs, their colors tint m_currentColor
+			std::string					m_text;						// Log lines only, they have no mesh
 };
 
 //-----------------------------------------------------------------------------------------------
+// Keeps debug draws alive for their lifetime and draws them in batches. Lines, points, bases and
+// grids are copied into one line stream per camera and mode, and spheres, boxes and quads are
+// instances of unit meshes built once. Objects come from a pool so a frame full of debug draws
+// doesn't touch the heap
+//
 class DebugRenderer
 {
 public:
@@ -99,6 +158,7 @@ public:
 	// Command Callbacks
 	static	bool			ClearCommand(Command& cmd);
 	static	bool			ShowDebugCommand(Command& cmd);
+	static	bool			BenchmarkCommand(Command& cmd);
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -109,8 +169,8 @@ public:
 			void			Shutdown();
 			void			ClearDebugRenders();
 			void			Update( float deltaSeconds );
-			void			Render() const;
-			void			RenderLog() const;
+			void			Render();
+			void			RenderLog();
 			void			RemoveFinishedDebugObjects();
 			void			RemoveFinishedLogTexts( );
 			void			EnableDebugRender() { m_isDebugEnabled = true; }
@@ -133,18 +193,46 @@ public:
 			void			DebugRender2DLine( const Vector2& start, const Vector2& end, const Rgba& startVertColor, const Rgba& endVertColor, const DebugRenderOptions& options );
 			void			DebugRender2DText( const Vector2& position, const std::string& text, float cellHeight, const DebugRenderOptions& options, const Vector2& alignment );
 			void			DebugRenderLog( const std::string& text, const DebugRenderOptions& options );
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Pool and batching
+			DebugRenderObject*	AcquireObject( DebugRenderShape shape, DebugRenderSpace space, const DebugRenderOptions& options );
+			void				ReleaseObject( DebugRenderObject* debugObj );
+			Mesh*				CreateOrGetUnitSphere( uint wedges, uint slices );
+			Camera*				GetCamera( DebugRenderSpace space ) const;
+			void				BuildInstanceBatches();
+			void				RenderSpace( DebugRenderSpace space );
+			void				RenderLineStreams( DebugRenderSpace space );
+			void				RenderInstances( DebugRenderSpace space );
+			void				DrawDepthPasses( Shader* shader, DebugRenderMode mode, FillMode fillMode, Mesh* mesh, int instanceCount, const Matrix44& modelMatrix, const Rgba& tint );
 	
+public:
 	//-----------------------------------------------------------------------------------------------
 	// Members
 			bool			m_isDebugEnabled = true;
 			Camera*			m_debug2DCamera = nullptr;
 			Camera*			m_debug3DCamera = nullptr;
 			float			m_logTextScreenRatio = 0.015f;
+
+	//-----------------------------------------------------------------------------------------------
+	// Batching resources, built at startup
+			Shader*								m_lineShader = nullptr;
+			Shader*								m_instanceShader = nullptr;
+			Shader*								m_textShader = nullptr;			// Debug text uses the SDF font so it stays sharp at any size
+			Mesh*								m_lineStreams[NUM_DEBUG_SPACES][NUM_DEBUG_RENDER_MODES] = {};	// Rewritten every frame
+			Mesh*								m_unitQuad = nullptr;
+			Mesh*								m_unitCube = nullptr;
+			std::vector<std::pair<uint, Mesh*>>	m_unitSpheres;						// Keyed by wedges << 16 | slices
+			StorageBuffer*						m_instanceBuffer = nullptr;
+			std::vector<DebugInstanceData>		m_instances;						// This frame's, grouped by batch
+			std::vector<DebugInstanceBatch>		m_instanceBatches;
 	
 	//-----------------------------------------------------------------------------------------------
 	// Static Members
 	static	std::vector<DebugRenderObject*>	s_debugObjects;
 	static	std::vector<DebugRenderObject*>	s_debugLogBuffer;
+	static	std::vector<DebugRenderObject*>	s_freeObjects;
 			
 };
 
@@ -2,6 +2,8 @@
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <string.h>
 //-----------------------------------------------------------------------------------------------
 
 
@@ -20,3 +22,36 @@ int DrawCall::GetRenderQueue() const
 {
 	return m_material->GetRenderQueue();
 }
+
+//-----------------------------------------------------------------------------------------------
+// Packs the sort key so one ascending sort gives sort order, then render queue, then state/depth
+//	63-56 : sort order (biased, clamped to a byte)
+//	55-54 : render queue
+//	53-0  : opaque/additive - material id (30) then front to back depth (24)
+//			alpha			- back to front depth (24) then material id (30)
+//
+void DrawCall::ComputeSortKey(float cameraDistance)
+{
+	uint64_t sortOrder = (uint64_t) (Max(Min(GetSortOrder(), 127), -128) + 128);
+	uint64_t renderQueue = (uint64_t) GetRenderQueue() & 0x3;
+	uint64_t materialID = (uint64_t) m_material->GetID() & 0x3fffffff;
+
+	// Positive floats sort the same as their bit patterns, keep the top 24 bits
+	float distance = Max(cameraDistance, 0.f);
+	uint32_t distanceBits;
+	memcpy(&distanceBits, &distance, sizeof(float));
+	uint64_t depth = (uint64_t) (distanceBits >> 8);
+
+	uint64_t payload;
+	if(GetRenderQueue() == RENDER_QUEUE_ALPHA)
+	{
+		// Correct blending needs depth to win over state
+		payload = ((~depth & 0xffffff) << 30) | materialID;
+	}
+	else
+	{
+		payload = (materialID << 24) | depth;
+	}
+
+	m_sortKey = (sortOrder << 56) | (renderQueue << 54) | payload;
+}
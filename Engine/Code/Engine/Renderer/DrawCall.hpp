@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include "Engine\Math\Matrix44.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -22,6 +23,7 @@ public:
 	// Accessors/Mutators
 			int					GetSortOrder() const;
 			int					GetRenderQueue() const;			
+			void				ComputeSortKey( float cameraDistance );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -33,6 +35,7 @@ public:
 			Matrix44			m_model;
 			std::vector<Light*> m_lights;
 	const	Transform*			m_transform;
+			uint64_t			m_sortKey = 0; // Sort order | render queue | material and depth, see ComputeSortKey
 };
 
 
@@ -7,10 +7,15 @@
 #include "Engine/Renderer/Renderable.hpp"
 #include "Engine/Renderer/DrawCall.hpp"
 #include "Engine/Renderer/Lights/Light.hpp"
+#include "Engine/Renderer/Lights/LightClusterGrid.hpp"
+#include "Engine/Renderer/Lights/ShadowAtlas.hpp"
+#include "Engine/Renderer/Lights/CascadedShadowMap.hpp"
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/Material.hpp"
-#include "Engine/Renderer/Sampler.hpp"
-//#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Math/Frustum.hpp"
+#include "Engine/Math/TransformSystem.hpp"
+#include "Engine/Core/RadixSort.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -18,12 +23,8 @@
 //
 ForwardRenderPath::ForwardRenderPath()
 {
-	m_shadowCamera = new Camera();
-	Texture* depthTarget = Renderer::GetInstance()->CreateDepthStencilTarget(2048, 2048);
-	depthTarget->SetSampler(Sampler::GetShadowSampler());
-	Texture* colorTarget = Renderer::GetInstance()->CreateRenderTarget(2048, 2048);
-	m_shadowCamera->SetDepthTarget( depthTarget );
-	m_shadowCamera->SetColorTarget( colorTarget );
+	m_shadowAtlas = new ShadowAtlas();
+	m_lightClusters = new LightClusterGrid();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -31,8 +32,22 @@ ForwardRenderPath::ForwardRenderPath()
 //
 ForwardRenderPath::~ForwardRenderPath()
 {
-	delete m_shadowCamera;
-	m_shadowCamera = nullptr;
+	delete m_shadowAtlas;
+	m_shadowAtlas = nullptr;
+
+	delete m_shadowCascades;
+	m_shadowCascades = nullptr;
+
+	delete m_lightClusters;
+	m_lightClusters = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns this frame's shadow atlas counters
+//
+const ShadowStats& ForwardRenderPath::GetShadowStats() const
+{
+	return m_shadowAtlas->GetStats();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -40,7 +55,7 @@ ForwardRenderPath::~ForwardRenderPath()
 //
 void ForwardRenderPath::Render(RenderScene* scene)
 {
-	//PROFILE_LOG_SCOPE_FUNCTION();
+	PROFILE_SCOPE_FUNCTION();
 
 #ifdef DEBUG_RENDER_LIGHTS 
 	for(Light* light: scene->m_lights)
@@ -55,10 +70,17 @@ void ForwardRenderPath::Render(RenderScene* scene)
 		cb();
 	}
 
-	// Light pre-render for shadow casting lights
+	// Bring every world matrix up to date in one sweep instead of one lazy query at a time
+	TransformSystem::GetInstance()->UpdateWorldMatrices();
+
+	// Refit the spatial trees for anything that moved since last frame
+	scene->UpdateSpatialTree();
+
+	// Light pre-render for shadow casting lights, each gets its own tile in the atlas
+	m_shadowAtlas->AllocateTiles(scene->m_lights, scene->m_cameras);
 	for(Light* light : scene->m_lights)
 	{
-		if(light->IsShadowCasting())
+		if(light->IsShadowCasting() && !light->UsesShadowCascades())
 		{
 			RenderShadowObjectForLight(light, scene);
 		}
@@ -76,6 +98,10 @@ void ForwardRenderPath::Render(RenderScene* scene)
 //
 void ForwardRenderPath::RenderSceneForCamera(Camera* cam, RenderScene* scene)
 {
+	PROFILE_SCOPE_FUNCTION();
+	// Cascades follow the camera so they are redone for every camera
+	RenderShadowCascadesForCamera(cam, scene);
+
 	Renderer* rend = Renderer::GetInstance();
 	rend->SetCamera(cam);
 	
@@ -91,40 +117,51 @@ void ForwardRenderPath::RenderSceneForCamera(Camera* cam, RenderScene* scene)
 		rend->ResetDefaultMaterial();
 	}
 
-	std::vector<DrawCall> drawCalls;
-
 	for(PrerenderCB preRender : scene->m_prerenders)
 	{
 		preRender(cam);
 	}
 
-	for(Renderable* renderable : scene->m_renderables)
+	// Only draw what the camera can see
+	Frustum frustum(cam->m_projMatrix * cam->m_viewMatrix);
+	std::vector<Renderable*> visibleRenderables;
+	scene->QueryRenderables(frustum, visibleRenderables);
+
+	// Assign the visible lights to the camera's clusters for the clustered shaders
+	std::vector<Light*> visibleLights;
+	scene->QueryLights(frustum, visibleLights);
+	m_lightClusters->Build(cam, visibleLights);
+	m_lightClusters->UpdateGPU();
+
+	Vector3 cameraPos = cam->m_transform.GetWorldPosition();
+	std::vector<DrawCall> drawCalls(visibleRenderables.size());
+	for(size_t drawIndex = 0; drawIndex < visibleRenderables.size(); ++drawIndex)
 	{
+		Renderable* renderable = visibleRenderables[drawIndex];
 		std::vector<Light*> lights;
-		if(renderable->IsLit())
+		if(renderable->IsLit() && !renderable->GetMaterial()->GetShader()->UsesLightClusters())
 		{
 			lights = scene->GetMostContributingLights(renderable->GetPosition());
 		}
 
 		if(renderable->IsOpaque())
 		{
-			renderable->GetEditableMaterial()->SetTexture(TEXTURE_SLOT_SHADOWMAP, m_shadowCamera->GetDepthTarget());
+			renderable->GetEditableMaterial()->SetTexture(TEXTURE_SLOT_SHADOWMAP, m_shadowAtlas->GetDepthTarget());
 		}
 
-		DrawCall dc;
+		DrawCall& dc = drawCalls[drawIndex];
 		dc.m_mesh = renderable->m_mesh;
 		dc.m_material = renderable->GetMaterial();
-		dc.m_lights = lights;
+		dc.m_lights.swap(lights);
 		dc.m_model = renderable->GetModelMatrix();
 		dc.m_transform = renderable->m_watchTransform;
-		drawCalls.push_back(dc);
+		dc.ComputeSortKey((cameraPos - dc.m_model.GetTranslation()).GetLength());
 	}
 
-	SortDrawsBySortOrder(drawCalls);
-	SortDrawsByRenderQueue(drawCalls);
-	SortDrawsByCameraDistance(drawCalls, cam);
-	for(DrawCall dc : drawCalls)
+	SortDraws(drawCalls);
+	for(uint32_t drawIndex : m_drawOrder)
 	{
+		DrawCall& dc = drawCalls[drawIndex];
 		rend->SetLightBuffer(dc.m_lights);
 		rend->SetMaterial(dc.m_material);
 		rend->DrawMesh(dc.m_mesh, dc.m_model);
@@ -132,112 +169,159 @@ void ForwardRenderPath::RenderSceneForCamera(Camera* cam, RenderScene* scene)
 }
 
 //-----------------------------------------------------------------------------------------------
-// Renders the shadow casting objects for the given light
+// Renders the shadow casting objects for the given light into its atlas tile. Static casters come
+// from the cache unless the light or one of them changed, dynamic casters are drawn on top
 //
 void ForwardRenderPath::RenderShadowObjectForLight(Light* light, RenderScene* scene)
 {
-	m_shadowCamera->SetOrtho(-128.f, 128.f, -128.f, 128.f, 0.f, 100.f);
-	
-	Vector3 worldPos = light->GetWorldPosition();
-
-	m_shadowCamera->LookAt(worldPos, worldPos + light->m_transform->GetForward());
+	PROFILE_SCOPE_FUNCTION();
+	ShadowTile* tile = m_shadowAtlas->GetTile(light);
+	if(tile == nullptr)
+	{
+		light->SetShadowAtlasTile(Vector3::ZERO); // Atlas is full, the light renders unshadowed
+		return;
+	}
 
-	Renderer* rend = Renderer::GetInstance();
-	rend->SetCamera(m_shadowCamera);
-	rend->ClearDepth();
-	rend->ClearScreen(Rgba::BLACK);
-	Matrix44 VP = m_shadowCamera->m_projMatrix * m_shadowCamera->m_viewMatrix;
+	Matrix44 VP = m_shadowAtlas->SetupCamerasForTile(light, *tile);
 	light->SetViewProjection(VP);
+	light->SetShadowAtlasTile(ShadowAtlas::GetTileUVTransform(*tile));
 
-	rend->SetMaterial(rend->CreateOrGetMaterial("Data/Materials/shadow.mat"));
-	for(Renderable* renderable : scene->m_renderables)
+	// Only the casters inside the light's view volume
+	std::vector<Renderable*> casters;
+	scene->QueryRenderables(Frustum(VP), casters);
+
+	m_staticCasters.clear();
+	m_dynamicCasters.clear();
+	for(Renderable* renderable : casters)
 	{
 		if(renderable->IsOpaque())
+		{
+			std::vector<Renderable*>& bucket = renderable->IsStatic() ? m_staticCasters : m_dynamicCasters;
+			bucket.push_back(renderable);
+		}
+	}
+
+	ShadowStats& stats = m_shadowAtlas->GetStats();
+	bool isStaticDirty = m_shadowAtlas->UpdateStaticSignature(*tile, VP, m_staticCasters);
+	if(!isStaticDirty && m_dynamicCasters.empty() && !tile->hasDynamicCasters)
+	{
+		// The atlas tile already holds exactly this
+		stats.tilesSkipped++;
+		stats.staticDrawsSkipped += (int) m_staticCasters.size();
+		return;
+	}
+
+	Renderer* rend = Renderer::GetInstance();
+	rend->SetMaterial(rend->CreateOrGetMaterial("Data/Materials/shadow.mat"));
+
+	Camera* staticCamera = m_shadowAtlas->GetStaticCamera();
+	if(isStaticDirty)
+	{
+		rend->SetCamera(staticCamera);
+		rend->ClearDepthRegion(tile->pixelRegion);
+		for(Renderable* renderable : m_staticCasters)
 		{
 			rend->DrawMesh(renderable->GetMesh(), renderable->GetModelMatrix());
 		}
+		stats.staticCachesRebuilt++;
+		stats.staticDraws += (int) m_staticCasters.size();
+	}
+	else
+	{
+		stats.staticDrawsSkipped += (int) m_staticCasters.size();
 	}
 
+	// Start from the cached depth and composite the dynamic casters over it
+	Camera* atlasCamera = m_shadowAtlas->GetAtlasCamera();
+	rend->CopyDepthRegion(atlasCamera->m_frameBuffer, staticCamera->m_frameBuffer, tile->pixelRegion);
+	rend->SetCamera(atlasCamera);
+	for(Renderable* renderable : m_dynamicCasters)
+	{
+		rend->DrawMesh(renderable->GetMesh(), renderable->GetModelMatrix());
+	}
+	stats.dynamicDraws += (int) m_dynamicCasters.size();
+	tile->hasDynamicCasters = !m_dynamicCasters.empty();
+
 	rend->ResetDefaultMaterial();
 }
+
 //-----------------------------------------------------------------------------------------------
-// Sort the draw calls by sort order
+// Renders the cascades of the strongest cascaded directional light over the camera's frustum.
+// Only one set of cascades is bound for the shaders, any other cascaded light goes unshadowed
 //
-void ForwardRenderPath::SortDrawsBySortOrder(std::vector<DrawCall>& drawCalls)
+void ForwardRenderPath::RenderShadowCascadesForCamera(Camera* cam, RenderScene* scene)
 {
-	for(size_t indexI = 0; indexI < drawCalls.size(); ++indexI)
+	PROFILE_SCOPE_FUNCTION();
+	Light* sun = nullptr;
+	for(Light* light : scene->m_lights)
 	{
-		for(size_t indexJ = indexI + 1; indexJ < drawCalls.size(); ++indexJ)
+		if(!light->UsesShadowCascades())
 		{
-			if(drawCalls[indexJ].GetSortOrder() < drawCalls[indexI].GetSortOrder())
-			{
-				std::swap(drawCalls[indexI], drawCalls[indexJ]);
-			}
+			continue;
+		}
+
+		light->SetShadowAtlasTile(Vector3::ZERO);
+		if(sun == nullptr || light->GetIntensity() > sun->GetIntensity())
+		{
+			sun = light;
 		}
 	}
-}
 
-//-----------------------------------------------------------------------------------------------
-// Sort the draws by render queue
-//
-void ForwardRenderPath::SortDrawsByRenderQueue(std::vector<DrawCall>& drawCalls)
-{
-	for(size_t indexI = 0; indexI < drawCalls.size(); ++indexI)
+	if(sun == nullptr)
 	{
-		for(size_t indexJ = indexI + 1; indexJ < drawCalls.size(); ++indexJ)
-		{
-			int sortOrderI = drawCalls[indexI].GetSortOrder();
-			int sortOrderJ = drawCalls[indexJ].GetSortOrder();
-			if( sortOrderJ > sortOrderI)
-			{
-				break;
-			}
+		return;
+	}
 
-			if((sortOrderI == sortOrderJ) && (drawCalls[indexJ].GetRenderQueue() < drawCalls[indexI].GetRenderQueue()))
+	int cascadeCount = sun->GetShadowCascadeCount();
+	int resolution = sun->GetShadowCascadeResolution();
+	if(m_shadowCascades == nullptr || m_shadowCascades->GetCascadeCount() != cascadeCount || m_shadowCascades->GetResolution() != resolution)
+	{
+		delete m_shadowCascades;
+		m_shadowCascades = new CascadedShadowMap(cascadeCount, resolution);
+	}
+
+	m_shadowCascades->Update(cam, sun);
+	sun->SetViewProjection(m_shadowCascades->GetViewProjection(0));
+	sun->SetShadowAtlasTile(Vector3(0.f, 0.f, -1.f)); // Tells the shaders to use the cascade block
+
+	Renderer* rend = Renderer::GetInstance();
+	rend->SetMaterial(rend->CreateOrGetMaterial("Data/Materials/shadow.mat"));
+
+	ShadowStats& stats = m_shadowAtlas->GetStats();
+	std::vector<Renderable*> casters;
+	for(int cascade = 0; cascade < cascadeCount; ++cascade)
+	{
+		// Each cascade only draws what lands in its own box
+		casters.clear();
+		scene->QueryRenderables(Frustum(m_shadowCascades->GetViewProjection(cascade)), casters);
+
+		rend->SetCamera(m_shadowCascades->GetCascadeCamera(cascade));
+		rend->ClearDepth();
+		for(Renderable* renderable : casters)
+		{
+			if(renderable->IsOpaque())
 			{
-				std::swap(drawCalls[indexI], drawCalls[indexJ]);
+				rend->DrawMesh(renderable->GetMesh(), renderable->GetModelMatrix());
+				stats.cascadeDraws++;
 			}
 		}
 	}
+
+	rend->ResetDefaultMaterial();
+	m_shadowCascades->UpdateGPU();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Sorts draw calls by camera depth
+// Radix sorts the draw call keys into m_drawOrder, the draw calls themselves never move
 //
-void ForwardRenderPath::SortDrawsByCameraDistance(std::vector<DrawCall>& drawCalls, Camera* cam)
+void ForwardRenderPath::SortDraws(const std::vector<DrawCall>& drawCalls)
 {
-	std::vector<float> distances;
-	for(DrawCall dc : drawCalls)
+	PROFILE_SCOPE_FUNCTION();
+	m_sortKeys.resize(drawCalls.size());
+	for(size_t index = 0; index < drawCalls.size(); ++index)
 	{
-		Vector3 pos = dc.m_model.GetTranslation();
-		Vector3 cameraPos = cam->m_transform.GetWorldPosition();
-
-		float distance = (cameraPos - pos).GetLength();
-		distances.push_back(distance);
+		m_sortKeys[index] = drawCalls[index].m_sortKey;
 	}
-	
-	for(size_t indexI = 0; indexI < drawCalls.size(); ++indexI)
-	{
-		for(size_t indexJ = indexI + 1; indexJ < drawCalls.size(); ++indexJ)
-		{
-			int sortOrderI = drawCalls[indexI].GetSortOrder();
-			int sortOrderJ = drawCalls[indexJ].GetSortOrder();
-			if( sortOrderJ > sortOrderI)
-			{
-				break;
-			}
 
-			int renderQueueI = drawCalls[indexI].GetRenderQueue();
-			int renderQueueJ = drawCalls[indexJ].GetRenderQueue();
-			if( renderQueueJ > renderQueueI )
-			{
-				break; 
-			}
-			if((sortOrderI == sortOrderJ) && (renderQueueI == renderQueueJ) && (distances[indexJ] < distances[indexI]))
-			{
-				std::swap(drawCalls[indexI], drawCalls[indexJ]);
-				std::swap(distances[indexI], distances[indexJ]);
-			}
-		}
-	}
+	RadixSortIndices(m_sortKeys.data(), (uint32_t) m_sortKeys.size(), m_drawOrder);
 }
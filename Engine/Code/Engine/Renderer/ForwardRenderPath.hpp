@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #define DEBUG_RENDER_LIGHTS
 
 //-----------------------------------------------------------------------------------------------
@@ -8,6 +9,11 @@ class Camera;
 class RenderScene;
 class DrawCall;
 class Light;
+class LightClusterGrid;
+class ShadowAtlas;
+class CascadedShadowMap;
+class Renderable;
+struct ShadowStats;
 
 //-----------------------------------------------------------------------------------------------
 class ForwardRenderPath
@@ -20,18 +26,24 @@ public:
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
+	const ShadowStats&	GetShadowStats() const;
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 	void	Render( RenderScene* scene );
 	void	RenderSceneForCamera( Camera* cam, RenderScene* scene );
 	void	RenderShadowObjectForLight( Light* light, RenderScene* scene );
-	void	SortDrawsBySortOrder( std::vector<DrawCall>& drawCalls );
-	void	SortDrawsByRenderQueue( std::vector<DrawCall>& drawCalls );
-	void	SortDrawsByCameraDistance( std::vector<DrawCall>& drawCalls, Camera* cam );
+	void	RenderShadowCascadesForCamera( Camera* cam, RenderScene* scene );
+	void	SortDraws( const std::vector<DrawCall>& drawCalls );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
-	Camera*	m_shadowCamera;
+	ShadowAtlas*				m_shadowAtlas;
+	CascadedShadowMap*			m_shadowCascades = nullptr; // Recreated when the light's cascade settings change
+	LightClusterGrid*			m_lightClusters;
+	std::vector<Renderable*>	m_staticCasters;	// Scratch for the shadow passes
+	std::vector<Renderable*>	m_dynamicCasters;
+	std::vector<uint64_t>		m_sortKeys;			// Scratch, reused every frame
+	std::vector<uint32_t>		m_drawOrder;		// Indices into the draw calls in draw order
 };
 
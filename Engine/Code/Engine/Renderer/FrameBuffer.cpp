@@ -1,6 +1,8 @@
 #include "Engine/Renderer/FrameBuffer.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureArray.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Window.hpp"
 
@@ -21,6 +23,7 @@ FrameBuffer::FrameBuffer()
 FrameBuffer::~FrameBuffer()
 {
 	if (m_handle != NULL) {
+		GLStateCache::ForgetFramebuffer( m_handle );
 		glDeleteFramebuffers( 1, &m_handle ); 
 		m_handle = NULL; 
 	}
@@ -60,12 +63,21 @@ void FrameBuffer::SetDepthStencilTarget(Texture* depthTarget)
 	m_depthStencilTarget = depthTarget;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Sets one layer of a texture array as the depth stencil target
+//
+void FrameBuffer::SetDepthStencilLayer(TextureArray* depthArray, int layer)
+{
+	m_depthStencilArray = depthArray;
+	m_depthStencilLayer = layer;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Writes to the frame buffer
 //
 void FrameBuffer::Finalize()
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, m_handle ); 
+	GLStateCache::GetInstance()->BindFramebuffer( GL_FRAMEBUFFER, m_handle ); 
 
 	// keep track of which outputs go to which attachments; 
 	GLenum targets[1]; 
@@ -85,7 +97,13 @@ void FrameBuffer::Finalize()
 	GL_CHECK_ERROR();
 
 	// Bind depth if available;
-	if (m_depthStencilTarget == nullptr) {
+	if (m_depthStencilArray != nullptr) {
+		glFramebufferTextureLayer( GL_FRAMEBUFFER, 
+			GL_DEPTH_STENCIL_ATTACHMENT, 
+			m_depthStencilArray->m_handle, 
+			0, 
+			m_depthStencilLayer ); 
+	} else if (m_depthStencilTarget == nullptr) {
 		glFramebufferTexture( GL_FRAMEBUFFER, 
 			GL_DEPTH_STENCIL_ATTACHMENT, 
 			NULL, 
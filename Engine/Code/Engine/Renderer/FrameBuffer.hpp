@@ -3,6 +3,7 @@
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Texture;
+class TextureArray;
 
 //-----------------------------------------------------------------------------------------------
 class FrameBuffer
@@ -20,6 +21,7 @@ public:
 	unsigned int	GetHeight(); 
 	void			SetColorTarget(Texture* colorTarget);
 	void			SetDepthStencilTarget(Texture* depthTarget);
+	void			SetDepthStencilLayer(TextureArray* depthArray, int layer);
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -30,6 +32,8 @@ public:
 	unsigned int	m_handle;
 	Texture*		m_colorTarget;
 	Texture*		m_depthStencilTarget;
+	TextureArray*	m_depthStencilArray = nullptr; // Takes priority over the depth target when set
+	int				m_depthStencilLayer = 0;
 	unsigned int	m_width;
 	unsigned int	m_height;
 };
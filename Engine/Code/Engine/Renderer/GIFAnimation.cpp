@@ -2,6 +2,8 @@
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
 #include "ThirdParty/stb/stb_image.h"
 #include <string.h>
@@ -24,12 +26,12 @@ GIFAnimation::GIFAnimation(const std::string& filePath)
 	unsigned char* gifData = stbi_load_gif_from_memory( (stbi_uc*)imageData,(int) length, &delays, &m_dimensions.x, &m_dimensions.y, &frames, &numComponents, numComponentsReq);
 	stbi_set_flip_vertically_on_load(false);
 
+	m_imageFilePath = filePath;
 	CreateTextureFromData(gifData, delays, frames);
 
 	free(imageData);
 	stbi_image_free(gifData);
-	m_imageFilePath = filePath;
-	m_currentTexture = GetTextureAtTime(m_elapsedSeconds);
+	m_currentFrame = GetFrameAtTime(m_elapsedSeconds);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -37,15 +39,23 @@ GIFAnimation::GIFAnimation(const std::string& filePath)
 //
 unsigned int GIFAnimation::GetCurrentHandle() const
 {
-	return m_currentTexture->GetHandle();
+	return m_currentFrame->m_texture->GetHandle();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Returns the current texture
+// Returns the texture holding the current frame
 //
 const	Texture* GIFAnimation::GetCurrentTexture() const
 {
-	return m_currentTexture;
+	return m_currentFrame->m_texture;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns where the current frame is in its texture, bottom left to top right
+//
+AABB2 GIFAnimation::GetCurrentUVs() const
+{
+	return m_currentFrame->m_uvs;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -57,13 +67,13 @@ float GIFAnimation::GetElapsedFraction() const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Returns the texture at the given time in the animation
+// Returns the frame at the given time in the animation
 //
-const	Texture* GIFAnimation::GetTextureAtTime(float seconds) const
+const	TextureAtlasRegion* GIFAnimation::GetFrameAtTime(float seconds) const
 {
 	if(m_frames.size() == 1)
 	{
-		return m_frames[0].frameTexture;
+		return m_frames[0].frameRegion;
 	}
 
 	float cumulativeTime = 0.f;
@@ -71,7 +81,7 @@ const	Texture* GIFAnimation::GetTextureAtTime(float seconds) const
 	{
 		if(seconds < (m_frames[index].delay + cumulativeTime))
 		{
-			return m_frames[index].frameTexture;
+			return m_frames[index].frameRegion;
 		}
 		cumulativeTime += m_frames[index].delay;
 	}
@@ -80,27 +90,37 @@ const	Texture* GIFAnimation::GetTextureAtTime(float seconds) const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Creates textures and appends it to the list of textures
+// Packs the frames into an atlas with pages sized for all of them, up to the largest page size,
+// and appends them to the list of frames. Frames too big for a page get a texture each, which the
+// atlas owns
 //
 void GIFAnimation::CreateTextureFromData(unsigned char* data, int* delays, int frames)
 {
+	TextureAtlasSettings settings;
+	settings.m_maxEntrySize = Max(m_dimensions.x, m_dimensions.y);
+	settings.m_pageSize = TextureAtlas::CalculatePageSize(m_dimensions, frames, settings.m_padding);
+	m_atlas = std::make_shared<TextureAtlas>(settings);
+
 	size_t frameSize = m_dimensions.x * m_dimensions.y;
-	unsigned char* subData = new unsigned char[frameSize * 4];
 	for(int frameIndex = 0; frameIndex < frames; ++frameIndex)
 	{
 		GIFFrame frame;
-		Texture* frameTex = new Texture();
-		
-		// Copy a frame each time and create a texture
-		memcpy(subData, data + (frameIndex * frameSize * 4), frameSize * 4); 
-		frameTex->PopulateFromData(subData, m_dimensions, 4);
+		std::string frameName = m_imageFilePath + "#" + std::to_string(frameIndex);
+		unsigned char* frameData = data + (frameIndex * frameSize * 4);
+
+		frame.frameRegion = m_atlas->AddRegion(frameName, frameData, m_dimensions);
+		if(!frame.frameRegion)
+		{
+			frame.frameRegion = m_atlas->AddWholeTexture(frameName, frameData, m_dimensions);
+		}
 
-		frame.frameTexture = frameTex;
 		frame.delay = (float) delays[frameIndex] * 0.001f; // data is in milliseconds
 		
 		m_duration += frame.delay;
 		m_frames.push_back(frame);
 	}
+
+	m_atlas->UpdateMips();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -126,7 +146,7 @@ void GIFAnimation::Update(float deltaSeconds)
 		}
 	}
 
-	m_currentTexture = GetTextureAtTime(m_elapsedSeconds);
+	m_currentFrame = GetFrameAtTime(m_elapsedSeconds);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1,17 +1,21 @@
 #pragma once
+#include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/IntVector2.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Texture;
+class TextureAtlas;
+struct TextureAtlasRegion;
 
 //-----------------------------------------------------------------------------------------------
 struct GIFFrame
 {
-	Texture*	frameTexture;
-	float		delay = -1.f;
+	const TextureAtlasRegion*	frameRegion = nullptr;
+	float						delay = -1.f;
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -28,11 +32,12 @@ public:
 	// Accessors/Mutators
 			unsigned int	GetCurrentHandle() const;
 			IntVector2		GetDimensions() const { return m_dimensions; }
-	const	Texture*		GetCurrentTexture() const;
+	const	Texture*		GetCurrentTexture() const; // The atlas page, draw it with GetCurrentUVs
+			AABB2			GetCurrentUVs() const;
 			float			GetElapsedSeconds() const { return m_elapsedSeconds; }
 			float			GetElapsedFraction() const;
 			float			GetDuration() const { return m_duration; }
-	const	Texture*		GetTextureAtTime( float seconds ) const;
+	const	TextureAtlasRegion*	GetFrameAtTime( float seconds ) const;
 			void			SetLoopMode( bool mode ) { m_isLooping = mode; }
 
 	//-----------------------------------------------------------------------------------------------
@@ -44,14 +49,15 @@ public:
 private:
 	//-----------------------------------------------------------------------------------------------
 	// Members
-			std::string					m_imageFilePath;
-			std::vector<GIFFrame>		m_frames;
-			float						m_elapsedSeconds = 0.f;
-			float						m_duration = 0.f;
-			IntVector2					m_dimensions;
-	const	Texture*					m_currentTexture = nullptr;
-			bool						m_isFinished = false;
-			bool						m_isPlaying = true;
-			bool						m_isLooping = true;
+			std::string						m_imageFilePath;
+			std::vector<GIFFrame>			m_frames;
+			float							m_elapsedSeconds = 0.f;
+			float							m_duration = 0.f;
+			IntVector2						m_dimensions;
+			std::shared_ptr<TextureAtlas>	m_atlas;			// All the frames. The copies AcquireGIFInstance hands out share it, the last one frees it
+	const	TextureAtlasRegion*				m_currentFrame = nullptr;
+			bool							m_isFinished = false;
+			bool							m_isPlaying = true;
+			bool							m_isLooping = true;
 };
 
@@ -17,6 +17,11 @@ PFNGLREADBUFFERPROC glReadBuffer = nullptr;
 PFNGLREADPIXELSPROC glReadPixels = nullptr;
 PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC glNamedFramebufferReadBuffer = nullptr;
 PFNGLVIEWPORTPROC glViewport = nullptr;
+PFNGLSCISSORPROC glScissor = nullptr;
+PFNGLGETINTEGERVPROC glGetIntegerv = nullptr;
+PFNGLGETINTEGERI_VPROC glGetIntegeri_v = nullptr;
+PFNGLGETBOOLEANVPROC glGetBooleanv = nullptr;
+PFNGLISENABLEDPROC glIsEnabled = nullptr;
 
 // Draw function Pointers
 PFNGLDRAWARRAYSPROC glDrawArrays = nullptr;
@@ -28,21 +33,37 @@ PFNGLLINEWIDTHPROC glLineWidth = nullptr;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = nullptr;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = nullptr;
 PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation = nullptr;
+PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation = nullptr;
+PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib = nullptr;
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = nullptr;
+PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = nullptr;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = nullptr;
 PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 PFNGLBUFFERDATAPROC glBufferData = nullptr;
+PFNGLBUFFERSUBDATAPROC glBufferSubData = nullptr;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange = nullptr;
+PFNGLBUFFERSTORAGEPROC glBufferStorage = nullptr;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer = nullptr;
 PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
 PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
 PFNGLDRAWELEMENTSPROC glDrawElements = nullptr;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced = nullptr;
+PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced = nullptr;
 PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = nullptr;
 PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers = nullptr;
 PFNGLDRAWBUFFERSPROC glDrawBuffers = nullptr;
 PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = nullptr;
 PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture = nullptr;
+PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer = nullptr;
 PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer = nullptr;
 PFNGLPOLYGONMODEPROC glPolygonMode = nullptr;
 
+// Sync function pointers
+PFNGLFENCESYNCPROC glFenceSync = nullptr;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = nullptr;
+PFNGLDELETESYNCPROC glDeleteSync = nullptr;
+PFNGLFINISHPROC glFinish = nullptr;
+
 // Texture function pointers
 PFNGLPIXELSTOREIPROC glPixelStorei = nullptr;
 PFNGLGENTEXTURESPROC glGenTextures = nullptr;
@@ -59,7 +80,9 @@ PFNGLBINDSAMPLERSPROC glBindSamplers = nullptr;
 PFNGLACTIVETEXTUREPROC glActiveTexture = nullptr;
 PFNGLGETTEXIMAGEPROC glGetTexImage = nullptr;
 PFNGLTEXSUBIMAGE2DPROC glTexSubImage2D = nullptr;
+PFNGLCLEARTEXIMAGEPROC glClearTexImage = nullptr;
 PFNGLTEXSTORAGE2DPROC glTexStorage2D = nullptr;
+PFNGLTEXSTORAGE3DPROC glTexStorage3D = nullptr;
 PFNGLDELETETEXTURESPROC glDeleteTextures = nullptr;
 PFNGLGENERATEMIPMAPPROC glGenerateMipmap = nullptr;
 
@@ -79,6 +102,7 @@ PFNGLGETPROGRAMIVPROC glGetProgramiv = nullptr;
 PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog = nullptr;
 PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = nullptr;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = nullptr;
+PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform = nullptr;
 PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex = nullptr;
 PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding = nullptr;
 PFNGLBINDBUFFERBASEPROC glBindBufferBase = nullptr;
@@ -147,6 +171,11 @@ void BindGLFunctions()
 	GL_BIND_FUNCTION(glReadPixels);
 	GL_BIND_FUNCTION(glNamedFramebufferReadBuffer);
 	GL_BIND_FUNCTION(glViewport);
+	GL_BIND_FUNCTION(glScissor);
+	GL_BIND_FUNCTION(glGetIntegerv);
+	GL_BIND_FUNCTION(glGetIntegeri_v);
+	GL_BIND_FUNCTION(glGetBooleanv);
+	GL_BIND_FUNCTION(glIsEnabled);
 
 	// Texture Stuff
 	GL_BIND_FUNCTION(glPixelStorei);
@@ -164,35 +193,53 @@ void BindGLFunctions()
 	GL_BIND_FUNCTION(glActiveTexture);
 	GL_BIND_FUNCTION(glGetTexImage);
 	GL_BIND_FUNCTION(glTexStorage2D);
+	GL_BIND_FUNCTION(glTexStorage3D);
 	GL_BIND_FUNCTION(glTexSubImage2D);
+	GL_BIND_FUNCTION(glClearTexImage);
 	GL_BIND_FUNCTION(glDeleteTextures);
 	GL_BIND_FUNCTION(glGenerateMipmap);
 	
 	// Draw Stuff
 	GL_BIND_FUNCTION(glDrawArrays);
 	GL_BIND_FUNCTION(glDrawElements);
+	GL_BIND_FUNCTION(glDrawElementsInstanced);
+	GL_BIND_FUNCTION(glDrawArraysInstanced);
 	GL_BIND_FUNCTION(glLineWidth);
 	GL_BIND_FUNCTION(glBlendFunc);
 	GL_BIND_FUNCTION(glDepthFunc);
 	GL_BIND_FUNCTION(glDepthMask);
 	GL_BIND_FUNCTION(glClearDepthf);
 	GL_BIND_FUNCTION(glGenVertexArrays);
+	GL_BIND_FUNCTION(glDeleteVertexArrays);
 	GL_BIND_FUNCTION(glBindVertexArray);
 	GL_BIND_FUNCTION(glVertexAttribPointer);
 	GL_BIND_FUNCTION(glEnableVertexAttribArray);
 	GL_BIND_FUNCTION(glGetAttribLocation);
+	GL_BIND_FUNCTION(glBindAttribLocation);
+	GL_BIND_FUNCTION(glGetActiveAttrib);
 	GL_BIND_FUNCTION(glBindBuffer);
 	GL_BIND_FUNCTION(glBufferData);
+	GL_BIND_FUNCTION(glBufferSubData);
+	GL_BIND_FUNCTION(glMapBufferRange);
+	GL_BIND_FUNCTION(glBufferStorage);
+	GL_BIND_FUNCTION(glUnmapBuffer);
 	GL_BIND_FUNCTION(glGenBuffers);
 	GL_BIND_FUNCTION(glDeleteBuffers);
 	GL_BIND_FUNCTION(glGenFramebuffers);
 	GL_BIND_FUNCTION(glDeleteFramebuffers);
 	GL_BIND_FUNCTION(glDrawBuffers);
 	GL_BIND_FUNCTION(glFramebufferTexture);
+	GL_BIND_FUNCTION(glFramebufferTextureLayer);
 	GL_BIND_FUNCTION(glBindFramebuffer);
 	GL_BIND_FUNCTION(glBlitFramebuffer);
 	GL_BIND_FUNCTION(glPolygonMode);
 
+	// Sync Stuff
+	GL_BIND_FUNCTION(glFenceSync);
+	GL_BIND_FUNCTION(glClientWaitSync);
+	GL_BIND_FUNCTION(glDeleteSync);
+	GL_BIND_FUNCTION(glFinish);
+
 	// Shader Stuff
 	GL_BIND_FUNCTION(glCreateShader);
 	GL_BIND_FUNCTION(glDeleteShader);
@@ -209,6 +256,7 @@ void BindGLFunctions()
 	GL_BIND_FUNCTION(glGetShaderInfoLog);
 	GL_BIND_FUNCTION(glGetProgramInfoLog);
 	GL_BIND_FUNCTION(glGetUniformLocation);
+	GL_BIND_FUNCTION(glGetActiveUniform);
 	GL_BIND_FUNCTION(glGetUniformBlockIndex);
 	GL_BIND_FUNCTION(glUniformBlockBinding);
 	GL_BIND_FUNCTION(glBindBufferBase);
@@ -45,6 +45,11 @@ extern PFNGLREADBUFFERPROC glReadBuffer;
 extern PFNGLREADPIXELSPROC glReadPixels;
 extern PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC glNamedFramebufferReadBuffer;
 extern PFNGLVIEWPORTPROC glViewport;
+extern PFNGLSCISSORPROC glScissor;
+extern PFNGLGETINTEGERVPROC glGetIntegerv;
+extern PFNGLGETINTEGERI_VPROC glGetIntegeri_v;
+extern PFNGLGETBOOLEANVPROC glGetBooleanv;
+extern PFNGLISENABLEDPROC glIsEnabled;
 
 //-----------------------------------------------------------------------------------------------
 // Draw functions
@@ -55,23 +60,40 @@ extern PFNGLDEPTHFUNCPROC glDepthFunc;
 extern PFNGLDEPTHMASKPROC glDepthMask;
 extern PFNGLCLEARDEPTHFPROC glClearDepthf;
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
+extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
 extern PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
+extern PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation;
+extern PFNGLGETACTIVEATTRIBPROC glGetActiveAttrib;
 extern PFNGLBINDBUFFERPROC glBindBuffer;
 extern PFNGLBUFFERDATAPROC glBufferData;
+extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+extern PFNGLBUFFERSTORAGEPROC glBufferStorage; // GL 4.4/ARB_buffer_storage, nullptr when the driver lacks it
+extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
 extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
 extern PFNGLGENBUFFERSPROC glGenBuffers;
 extern PFNGLDRAWELEMENTSPROC glDrawElements;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
+extern PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced;
 extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
 extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
 extern PFNGLDRAWBUFFERSPROC glDrawBuffers;
 extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
 extern PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture;
+extern PFNGLFRAMEBUFFERTEXTURELAYERPROC glFramebufferTextureLayer;
 extern PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
 extern PFNGLPOLYGONMODEPROC glPolygonMode;
 
+//-----------------------------------------------------------------------------------------------
+// Sync functions
+extern PFNGLFENCESYNCPROC glFenceSync;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+extern PFNGLDELETESYNCPROC glDeleteSync;
+extern PFNGLFINISHPROC glFinish;
+
 //-----------------------------------------------------------------------------------------------
 // Texture functions
 extern PFNGLPIXELSTOREIPROC glPixelStorei;
@@ -89,7 +111,9 @@ extern PFNGLBINDSAMPLERSPROC glBindSamplers;
 extern PFNGLACTIVETEXTUREPROC glActiveTexture;
 extern PFNGLGETTEXIMAGEPROC glGetTexImage;
 extern PFNGLTEXSTORAGE2DPROC glTexStorage2D;
+extern PFNGLTEXSTORAGE3DPROC glTexStorage3D;
 extern PFNGLTEXSUBIMAGE2DPROC glTexSubImage2D;
+extern PFNGLCLEARTEXIMAGEPROC glClearTexImage; // GL 4.4, nullptr when the driver doesn't have it
 extern PFNGLDELETETEXTURESPROC glDeleteTextures;
 extern PFNGLGENERATEMIPMAPPROC glGenerateMipmap;
 
@@ -110,6 +134,7 @@ extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
 extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
 extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
+extern PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
 extern PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
 extern PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
 extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
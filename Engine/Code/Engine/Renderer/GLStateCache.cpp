@@ -0,0 +1,764 @@
+#include "Engine/Renderer/GLStateCache.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Console/Command.hpp"
+#include "Engine/Console/DevConsole.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static GLStateCache* g_glStateCache = nullptr;
+
+static const char* s_stateCategoryNames[NUM_STATE_CATEGORIES] =
+{
+	"program",
+	"vertex array",
+	"buffer",
+	"texture",
+	"sampler",
+	"framebuffer",
+	"fixed function",
+	"viewport"
+};
+
+static const GLenum s_cachedCaps[STATE_CACHE_CAPS] = { GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST, GL_LINE_SMOOTH, GL_TEXTURE_CUBE_MAP_SEAMLESS };
+static const GLenum s_textureTargets[STATE_CACHE_TEXTURE_TARGETS] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP };
+static const GLenum s_textureBindings[STATE_CACHE_TEXTURE_TARGETS] = { GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_2D_ARRAY, GL_TEXTURE_BINDING_CUBE_MAP };
+static const GLenum s_bufferTargets[STATE_CACHE_BUFFER_TARGETS] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+static const GLenum s_bufferBindings[STATE_CACHE_BUFFER_TARGETS] = { GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING };
+static const GLenum s_indexedTargets[STATE_CACHE_INDEXED_TARGETS] = { GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+static const GLenum s_indexedBindings[STATE_CACHE_INDEXED_TARGETS] = { GL_UNIFORM_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING };
+
+//-----------------------------------------------------------------------------------------------
+// Returns where value sits in the table, -1 when the cache does not track it
+//
+static int GetTableIndex(const GLenum* table, int count, GLenum value)
+{
+	for(int index = 0; index < count; ++index)
+	{
+		if(table[index] == value)
+		{
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reports and adopts what GL holds when a known cached value disagrees with it, returns 1 then
+//
+static int CheckCachedValue(const std::string& name, GLuint& cached, GLint actual)
+{
+	if(cached == STATE_CACHE_UNKNOWN || cached == (GLuint) actual)
+	{
+		return 0;
+	}
+
+	ConsolePrintf(Rgba::RED, "GL state cache out of sync: %s is 0x%x in the cache, 0x%x in GL", name.c_str(), cached, (GLuint) actual);
+	cached = (GLuint) actual;
+	return 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor, nothing is known until the first call of each kind
+//
+GLStateCache::GLStateCache()
+{
+	memset(&m_frameStats, 0, sizeof(GLStateStats));
+	memset(&m_lastFrameStats, 0, sizeof(GLStateStats));
+	Invalidate();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the instance of the state cache if it's not already created
+//
+STATIC GLStateCache* GLStateCache::CreateInstance()
+{
+	if(g_glStateCache == nullptr)
+	{
+		g_glStateCache = new GLStateCache();
+	}
+
+	return g_glStateCache;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the instance of the state cache
+//
+STATIC GLStateCache* GLStateCache::GetInstance()
+{
+	return g_glStateCache;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Deletes the instance of the state cache
+//
+STATIC void GLStateCache::DestroyInstance()
+{
+	delete g_glStateCache;
+	g_glStateCache = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Counts the call, returns true when it changes nothing and can be dropped
+//
+bool GLStateCache::Filter(eGLStateCategory category, bool isSame)
+{
+	if(isSame)
+	{
+		++m_frameStats.m_filtered[category];
+		return true;
+	}
+
+	++m_frameStats.m_issued[category];
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the program
+//
+void GLStateCache::UseProgram(GLuint program)
+{
+	if(Filter(STATE_CATEGORY_PROGRAM, m_program == program))
+	{
+		return;
+	}
+
+	glUseProgram(program);
+	m_program = program;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the vertex array. The element array binding is part of it, so it is unknown afterwards
+//
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if(Filter(STATE_CATEGORY_VERTEX_ARRAY, m_vao == vao))
+	{
+		return;
+	}
+
+	glBindVertexArray(vao);
+	m_vao = vao;
+	m_buffers[1] = STATE_CACHE_UNKNOWN;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the buffer to a generic target, untracked targets always go through
+//
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	int targetIndex = GetTableIndex(s_bufferTargets, STATE_CACHE_BUFFER_TARGETS, target);
+	if(Filter(STATE_CATEGORY_BUFFER, targetIndex >= 0 && m_buffers[targetIndex] == buffer))
+	{
+		return;
+	}
+
+	glBindBuffer(target, buffer);
+	if(targetIndex >= 0)
+	{
+		m_buffers[targetIndex] = buffer;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the buffer to an indexed binding point, which binds the generic target as well
+//
+void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	int targetIndex = GetTableIndex(s_indexedTargets, STATE_CACHE_INDEXED_TARGETS, target);
+	bool isTracked = (targetIndex >= 0 && index < STATE_CACHE_BUFFER_BINDINGS);
+	if(Filter(STATE_CATEGORY_BUFFER, isTracked && m_bufferBases[targetIndex][index] == buffer))
+	{
+		return;
+	}
+
+	glBindBufferBase(target, index, buffer);
+	if(isTracked)
+	{
+		m_bufferBases[targetIndex][index] = buffer;
+	}
+
+	int genericIndex = GetTableIndex(s_bufferTargets, STATE_CACHE_BUFFER_TARGETS, target);
+	if(genericIndex >= 0)
+	{
+		m_buffers[genericIndex] = buffer;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches the active unit only when a bind needs another one
+//
+void GLStateCache::SetActiveUnit(GLuint unit)
+{
+	if(m_activeUnit != unit)
+	{
+		++m_frameStats.m_issued[STATE_CATEGORY_TEXTURE];
+		glActiveTexture(GL_TEXTURE0 + unit);
+		m_activeUnit = unit;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the texture to the target of the unit
+//
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	int targetIndex = GetTableIndex(s_textureTargets, STATE_CACHE_TEXTURE_TARGETS, target);
+	bool isTracked = (targetIndex >= 0 && unit < STATE_CACHE_TEXTURE_UNITS);
+	if(Filter(STATE_CATEGORY_TEXTURE, isTracked && m_textures[unit][targetIndex] == texture))
+	{
+		return;
+	}
+
+	SetActiveUnit(unit);
+	glBindTexture(target, texture);
+	if(isTracked)
+	{
+		m_textures[unit][targetIndex] = texture;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the sampler to the unit
+//
+void GLStateCache::BindSampler(GLuint unit, GLuint sampler)
+{
+	bool isTracked = (unit < STATE_CACHE_TEXTURE_UNITS);
+	if(Filter(STATE_CATEGORY_SAMPLER, isTracked && m_samplers[unit] == sampler))
+	{
+		return;
+	}
+
+	glBindSampler(unit, sampler);
+	if(isTracked)
+	{
+		m_samplers[unit] = sampler;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds the framebuffer, GL_FRAMEBUFFER sets both the draw and the read binding
+//
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	bool isDraw = (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER);
+	bool isRead = (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER);
+	bool isSame = (isDraw || isRead)
+		&& (!isDraw || m_drawFramebuffer == framebuffer)
+		&& (!isRead || m_readFramebuffer == framebuffer);
+	if(Filter(STATE_CATEGORY_FRAMEBUFFER, isSame))
+	{
+		return;
+	}
+
+	glBindFramebuffer(target, framebuffer);
+	if(isDraw)
+	{
+		m_drawFramebuffer = framebuffer;
+	}
+	if(isRead)
+	{
+		m_readFramebuffer = framebuffer;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Enables or disables the capability
+//
+void GLStateCache::SetEnabled(GLenum cap, bool isEnabled)
+{
+	int capIndex = GetTableIndex(s_cachedCaps, STATE_CACHE_CAPS, cap);
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, capIndex >= 0 && m_caps[capIndex] == (int8_t) isEnabled))
+	{
+		return;
+	}
+
+	if(isEnabled)
+	{
+		glEnable(cap);
+	}
+	else
+	{
+		glDisable(cap);
+	}
+
+	if(capIndex >= 0)
+	{
+		m_caps[capIndex] = (int8_t) isEnabled;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the color and alpha blend operations
+//
+void GLStateCache::BlendEquationSeparate(GLenum colorOp, GLenum alphaOp)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_blendEquations[0] == colorOp && m_blendEquations[1] == alphaOp))
+	{
+		return;
+	}
+
+	glBlendEquationSeparate(colorOp, alphaOp);
+	m_blendEquations[0] = colorOp;
+	m_blendEquations[1] = alphaOp;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the color and alpha blend factors
+//
+void GLStateCache::BlendFuncSeparate(GLenum colorSrc, GLenum colorDst, GLenum alphaSrc, GLenum alphaDst)
+{
+	bool isSame = m_blendFuncs[0] == colorSrc && m_blendFuncs[1] == colorDst
+		&& m_blendFuncs[2] == alphaSrc && m_blendFuncs[3] == alphaDst;
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, isSame))
+	{
+		return;
+	}
+
+	glBlendFuncSeparate(colorSrc, colorDst, alphaSrc, alphaDst);
+	m_blendFuncs[0] = colorSrc;
+	m_blendFuncs[1] = colorDst;
+	m_blendFuncs[2] = alphaSrc;
+	m_blendFuncs[3] = alphaDst;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the depth compare
+//
+void GLStateCache::DepthFunc(GLenum func)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_depthFunc == func))
+	{
+		return;
+	}
+
+	glDepthFunc(func);
+	m_depthFunc = func;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Turns depth writes on or off
+//
+void GLStateCache::DepthMask(bool isWriting)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_depthMask == (int8_t) isWriting))
+	{
+		return;
+	}
+
+	glDepthMask(isWriting ? GL_TRUE : GL_FALSE);
+	m_depthMask = (int8_t) isWriting;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the wind order of front faces
+//
+void GLStateCache::FrontFace(GLenum mode)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_frontFace == mode))
+	{
+		return;
+	}
+
+	glFrontFace(mode);
+	m_frontFace = mode;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets which faces are culled when culling is enabled
+//
+void GLStateCache::CullFace(GLenum mode)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_cullFace == mode))
+	{
+		return;
+	}
+
+	glCullFace(mode);
+	m_cullFace = mode;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the fill mode of both faces
+//
+void GLStateCache::PolygonMode(GLenum mode)
+{
+	if(Filter(STATE_CATEGORY_FIXED_FUNCTION, m_polygonMode == mode))
+	{
+		return;
+	}
+
+	glPolygonMode(GL_FRONT_AND_BACK, mode);
+	m_polygonMode = mode;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the viewport
+//
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	bool isSame = m_isViewportKnown && m_viewport[0] == x && m_viewport[1] == y
+		&& m_viewport[2] == width && m_viewport[3] == height;
+	if(Filter(STATE_CATEGORY_VIEWPORT, isSame))
+	{
+		return;
+	}
+
+	glViewport(x, y, width, height);
+	m_viewport[0] = x;
+	m_viewport[1] = y;
+	m_viewport[2] = width;
+	m_viewport[3] = height;
+	m_isViewportKnown = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Keeps the counters of the frame that just ended for the stats command
+//
+void GLStateCache::EndFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	memset(&m_frameStats, 0, sizeof(GLStateStats));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Forgets everything, for after code that talked to GL directly
+//
+void GLStateCache::Invalidate()
+{
+	m_program = STATE_CACHE_UNKNOWN;
+	m_vao = STATE_CACHE_UNKNOWN;
+	m_activeUnit = STATE_CACHE_UNKNOWN;
+	m_drawFramebuffer = STATE_CACHE_UNKNOWN;
+	m_readFramebuffer = STATE_CACHE_UNKNOWN;
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_BUFFER_TARGETS; ++targetIndex)
+	{
+		m_buffers[targetIndex] = STATE_CACHE_UNKNOWN;
+	}
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_INDEXED_TARGETS; ++targetIndex)
+	{
+		for(int bindIndex = 0; bindIndex < STATE_CACHE_BUFFER_BINDINGS; ++bindIndex)
+		{
+			m_bufferBases[targetIndex][bindIndex] = STATE_CACHE_UNKNOWN;
+		}
+	}
+
+	for(int unit = 0; unit < STATE_CACHE_TEXTURE_UNITS; ++unit)
+	{
+		for(int targetIndex = 0; targetIndex < STATE_CACHE_TEXTURE_TARGETS; ++targetIndex)
+		{
+			m_textures[unit][targetIndex] = STATE_CACHE_UNKNOWN;
+		}
+		m_samplers[unit] = STATE_CACHE_UNKNOWN;
+	}
+
+	for(int capIndex = 0; capIndex < STATE_CACHE_CAPS; ++capIndex)
+	{
+		m_caps[capIndex] = -1;
+	}
+
+	m_blendEquations[0] = m_blendEquations[1] = STATE_CACHE_UNKNOWN;
+	m_blendFuncs[0] = m_blendFuncs[1] = m_blendFuncs[2] = m_blendFuncs[3] = STATE_CACHE_UNKNOWN;
+	m_depthFunc = STATE_CACHE_UNKNOWN;
+	m_depthMask = -1;
+	m_frontFace = STATE_CACHE_UNKNOWN;
+	m_cullFace = STATE_CACHE_UNKNOWN;
+	m_polygonMode = STATE_CACHE_UNKNOWN;
+	m_isViewportKnown = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads back everything the cache believes it knows and compares. Slow, only meant for the
+// validating mode
+//
+int GLStateCache::Validate()
+{
+	int mismatches = 0;
+	GLint value = 0;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+	mismatches += CheckCachedValue("program", m_program, value);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+	mismatches += CheckCachedValue("vertex array", m_vao, value);
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_BUFFER_TARGETS; ++targetIndex)
+	{
+		glGetIntegerv(s_bufferBindings[targetIndex], &value);
+		mismatches += CheckCachedValue(Stringf("buffer target 0x%x", s_bufferTargets[targetIndex]), m_buffers[targetIndex], value);
+	}
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_INDEXED_TARGETS; ++targetIndex)
+	{
+		for(int bindIndex = 0; bindIndex < STATE_CACHE_BUFFER_BINDINGS; ++bindIndex)
+		{
+			glGetIntegeri_v(s_indexedBindings[targetIndex], bindIndex, &value);
+			mismatches += CheckCachedValue(Stringf("buffer base 0x%x[%d]", s_indexedTargets[targetIndex], bindIndex), m_bufferBases[targetIndex][bindIndex], value);
+		}
+	}
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &value);
+	mismatches += CheckCachedValue("draw framebuffer", m_drawFramebuffer, value);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &value);
+	mismatches += CheckCachedValue("read framebuffer", m_readFramebuffer, value);
+
+	// Texture bindings can only be read from the active unit, so walk the units and go back
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &value);
+	mismatches += CheckCachedValue("active texture unit", m_activeUnit, value - GL_TEXTURE0);
+	GLuint activeUnit = (GLuint) (value - GL_TEXTURE0);
+	for(GLuint unit = 0; unit < STATE_CACHE_TEXTURE_UNITS; ++unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		for(int targetIndex = 0; targetIndex < STATE_CACHE_TEXTURE_TARGETS; ++targetIndex)
+		{
+			glGetIntegerv(s_textureBindings[targetIndex], &value);
+			mismatches += CheckCachedValue(Stringf("texture unit %u target 0x%x", unit, s_textureTargets[targetIndex]), m_textures[unit][targetIndex], value);
+		}
+		glGetIntegerv(GL_SAMPLER_BINDING, &value);
+		mismatches += CheckCachedValue(Stringf("sampler unit %u", unit), m_samplers[unit], value);
+	}
+	glActiveTexture(GL_TEXTURE0 + activeUnit);
+
+	for(int capIndex = 0; capIndex < STATE_CACHE_CAPS; ++capIndex)
+	{
+		GLuint cap = (m_caps[capIndex] < 0) ? STATE_CACHE_UNKNOWN : (GLuint) m_caps[capIndex];
+		if(CheckCachedValue(Stringf("cap 0x%x", s_cachedCaps[capIndex]), cap, glIsEnabled(s_cachedCaps[capIndex]) ? 1 : 0) > 0)
+		{
+			m_caps[capIndex] = (int8_t) cap;
+			++mismatches;
+		}
+	}
+
+	glGetIntegerv(GL_BLEND_EQUATION_RGB, &value);
+	mismatches += CheckCachedValue("color blend op", m_blendEquations[0], value);
+	glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &value);
+	mismatches += CheckCachedValue("alpha blend op", m_blendEquations[1], value);
+
+	const GLenum blendFuncQueries[4] = { GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA };
+	for(int funcIndex = 0; funcIndex < 4; ++funcIndex)
+	{
+		glGetIntegerv(blendFuncQueries[funcIndex], &value);
+		mismatches += CheckCachedValue(Stringf("blend factor %d", funcIndex), m_blendFuncs[funcIndex], value);
+	}
+
+	glGetIntegerv(GL_DEPTH_FUNC, &value);
+	mismatches += CheckCachedValue("depth func", m_depthFunc, value);
+
+	GLboolean depthWrite = GL_FALSE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrite);
+	GLuint depthMask = (m_depthMask < 0) ? STATE_CACHE_UNKNOWN : (GLuint) m_depthMask;
+	if(CheckCachedValue("depth mask", depthMask, depthWrite ? 1 : 0) > 0)
+	{
+		m_depthMask = (int8_t) depthMask;
+		++mismatches;
+	}
+
+	glGetIntegerv(GL_FRONT_FACE, &value);
+	mismatches += CheckCachedValue("front face", m_frontFace, value);
+	glGetIntegerv(GL_CULL_FACE_MODE, &value);
+	mismatches += CheckCachedValue("cull face", m_cullFace, value);
+
+	GLint polygonModes[2] = { 0, 0 }; // Some drivers still write front and back
+	glGetIntegerv(GL_POLYGON_MODE, polygonModes);
+	mismatches += CheckCachedValue("polygon mode", m_polygonMode, polygonModes[0]);
+
+	if(m_isViewportKnown)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		if(memcmp(viewport, m_viewport, sizeof(viewport)) != 0)
+		{
+			ConsolePrintf(Rgba::RED, "GL state cache out of sync: viewport is (%d, %d, %d, %d) in the cache, (%d, %d, %d, %d) in GL",
+				m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3], viewport[0], viewport[1], viewport[2], viewport[3]);
+			memcpy(m_viewport, viewport, sizeof(viewport));
+			++mismatches;
+		}
+	}
+
+	m_desyncCount += mismatches;
+	return mismatches;
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds 0 wherever a deleted program was bound
+//
+STATIC void GLStateCache::ForgetProgram(GLuint program)
+{
+	if(g_glStateCache != nullptr && g_glStateCache->m_program == program)
+	{
+		g_glStateCache->m_program = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds vertex array 0 when the bound one is deleted, along with its element array binding
+//
+STATIC void GLStateCache::ForgetVertexArray(GLuint vao)
+{
+	if(g_glStateCache != nullptr && g_glStateCache->m_vao == vao)
+	{
+		g_glStateCache->m_vao = 0;
+		g_glStateCache->m_buffers[1] = STATE_CACHE_UNKNOWN;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds 0 wherever a deleted buffer was bound. Whether indexed bindings are reset differs
+// between drivers, so those become unknown
+//
+STATIC void GLStateCache::ForgetBuffer(GLuint buffer)
+{
+	if(g_glStateCache == nullptr)
+	{
+		return;
+	}
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_BUFFER_TARGETS; ++targetIndex)
+	{
+		if(g_glStateCache->m_buffers[targetIndex] == buffer)
+		{
+			g_glStateCache->m_buffers[targetIndex] = 0;
+		}
+	}
+
+	for(int targetIndex = 0; targetIndex < STATE_CACHE_INDEXED_TARGETS; ++targetIndex)
+	{
+		for(int bindIndex = 0; bindIndex < STATE_CACHE_BUFFER_BINDINGS; ++bindIndex)
+		{
+			if(g_glStateCache->m_bufferBases[targetIndex][bindIndex] == buffer)
+			{
+				g_glStateCache->m_bufferBases[targetIndex][bindIndex] = STATE_CACHE_UNKNOWN;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds 0 on every unit a deleted texture was bound to
+//
+STATIC void GLStateCache::ForgetTexture(GLuint texture)
+{
+	if(g_glStateCache == nullptr)
+	{
+		return;
+	}
+
+	for(int unit = 0; unit < STATE_CACHE_TEXTURE_UNITS; ++unit)
+	{
+		for(int targetIndex = 0; targetIndex < STATE_CACHE_TEXTURE_TARGETS; ++targetIndex)
+		{
+			if(g_glStateCache->m_textures[unit][targetIndex] == texture)
+			{
+				g_glStateCache->m_textures[unit][targetIndex] = 0;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds 0 on every unit a deleted sampler was bound to
+//
+STATIC void GLStateCache::ForgetSampler(GLuint sampler)
+{
+	if(g_glStateCache == nullptr)
+	{
+		return;
+	}
+
+	for(int unit = 0; unit < STATE_CACHE_TEXTURE_UNITS; ++unit)
+	{
+		if(g_glStateCache->m_samplers[unit] == sampler)
+		{
+			g_glStateCache->m_samplers[unit] = 0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// GL binds the default framebuffer in place of a deleted one
+//
+STATIC void GLStateCache::ForgetFramebuffer(GLuint framebuffer)
+{
+	if(g_glStateCache == nullptr)
+	{
+		return;
+	}
+
+	if(g_glStateCache->m_drawFramebuffer == framebuffer)
+	{
+		g_glStateCache->m_drawFramebuffer = 0;
+	}
+	if(g_glStateCache->m_readFramebuffer == framebuffer)
+	{
+		g_glStateCache->m_readFramebuffer = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Command callback printing the calls issued and filtered during the last frame
+//
+STATIC bool GLStateCache::StatsCommand(Command& cmd)
+{
+	UNUSED(cmd);
+	if(g_glStateCache == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The GL state cache is not running");
+		return false;
+	}
+
+	const GLStateStats& stats = g_glStateCache->GetFrameStats();
+	int totalIssued = 0;
+	int totalFiltered = 0;
+	for(int categoryIndex = 0; categoryIndex < NUM_STATE_CATEGORIES; ++categoryIndex)
+	{
+		totalIssued += stats.m_issued[categoryIndex];
+		totalFiltered += stats.m_filtered[categoryIndex];
+	}
+
+	ConsolePrintf("%d GL state calls issued, %d filtered last frame", totalIssued, totalFiltered);
+	for(int categoryIndex = 0; categoryIndex < NUM_STATE_CATEGORIES; ++categoryIndex)
+	{
+		ConsolePrintf("  %-16s %6d issued %6d filtered", s_stateCategoryNames[categoryIndex], stats.m_issued[categoryIndex], stats.m_filtered[categoryIndex]);
+	}
+
+	if(g_glStateCache->IsValidating())
+	{
+		ConsolePrintf("Validating before every draw, %d mismatches so far", g_glStateCache->GetDesyncCount());
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Command callback turning the check against glGet before every draw on or off, [true|false]
+//
+STATIC bool GLStateCache::ValidateCommand(Command& cmd)
+{
+	if(g_glStateCache == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The GL state cache is not running");
+		return false;
+	}
+
+	bool isValidating = !g_glStateCache->IsValidating();
+	cmd.GetNextBool(isValidating);
+	g_glStateCache->SetValidating(isValidating);
+
+	if(isValidating)
+	{
+		int mismatches = g_glStateCache->Validate();
+		ConsolePrintf("GL state validation on, %d mismatches right now", mismatches);
+	}
+	else
+	{
+		ConsolePrintf("GL state validation off");
+	}
+
+	return true;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "Engine/Renderer/External/GL/glcorearb.h"
+#include "Engine/Enumerations/GLStateCategory.hpp"
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Command;
+
+//-----------------------------------------------------------------------------------------------
+constexpr int		STATE_CACHE_TEXTURE_UNITS = 32;
+constexpr int		STATE_CACHE_TEXTURE_TARGETS = 3;		// 2D, 2D array and cube map
+constexpr int		STATE_CACHE_BUFFER_TARGETS = 4;			// Array, element array, uniform and storage
+constexpr int		STATE_CACHE_INDEXED_TARGETS = 2;		// Uniform and storage binding points
+constexpr int		STATE_CACHE_BUFFER_BINDINGS = 16;
+constexpr int		STATE_CACHE_CAPS = 6;
+constexpr GLuint	STATE_CACHE_UNKNOWN = 0xFFFFFFFF;		// Not known yet, the next call always goes through
+
+//-----------------------------------------------------------------------------------------------
+// GL calls that went to the driver and calls the cache dropped because nothing changed
+//
+struct GLStateStats
+{
+	int		m_issued[NUM_STATE_CATEGORIES];
+	int		m_filtered[NUM_STATE_CATEGORIES];
+};
+
+//-----------------------------------------------------------------------------------------------
+// Shadow copy of the GL context's bindings and fixed function state. Every bind and state call
+// in the GL renderer goes through here, and calls that would set what is already set never reach
+// the driver. Code that touches GL behind the cache's back has to call Invalidate, and deleted
+// objects have to be forgotten since GL unbinds them on its own. The validating mode compares the
+// cache against glGet before every draw and reports anything that drifted
+//
+class GLStateCache
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	GLStateCache();
+	~GLStateCache() {}
+
+	static	GLStateCache*		CreateInstance();
+	static	GLStateCache*		GetInstance();
+	static	void				DestroyInstance();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			const GLStateStats&	GetFrameStats() const { return m_lastFrameStats; } // Of the last finished frame
+			bool				IsValidating() const { return m_isValidating; }
+			void				SetValidating( bool isValidating ) { m_isValidating = isValidating; }
+			int					GetDesyncCount() const { return m_desyncCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Bindings
+			void				UseProgram( GLuint program );
+			void				BindVertexArray( GLuint vao );
+			void				BindBuffer( GLenum target, GLuint buffer );
+			void				BindBufferBase( GLenum target, GLuint index, GLuint buffer );
+			void				BindTexture( GLuint unit, GLenum target, GLuint texture );
+			void				BindSampler( GLuint unit, GLuint sampler );
+			void				BindFramebuffer( GLenum target, GLuint framebuffer );
+
+	//-----------------------------------------------------------------------------------------------
+	// Fixed function state
+			void				SetEnabled( GLenum cap, bool isEnabled );
+			void				BlendEquationSeparate( GLenum colorOp, GLenum alphaOp );
+			void				BlendFuncSeparate( GLenum colorSrc, GLenum colorDst, GLenum alphaSrc, GLenum alphaDst );
+			void				DepthFunc( GLenum func );
+			void				DepthMask( bool isWriting );
+			void				FrontFace( GLenum mode );
+			void				CullFace( GLenum mode );
+			void				PolygonMode( GLenum mode );
+			void				Viewport( GLint x, GLint y, GLsizei width, GLsizei height );
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				EndFrame(); // Rolls the counters over
+			void				Invalidate(); // Forgets everything, the next call of each kind goes through
+			int					Validate(); // Compares against glGet, reports and adopts what drifted, returns the mismatch count
+
+	static	void				ForgetProgram( GLuint program ); // Deleting a bound object binds 0 in its place
+	static	void				ForgetVertexArray( GLuint vao );
+	static	void				ForgetBuffer( GLuint buffer );
+	static	void				ForgetTexture( GLuint texture );
+	static	void				ForgetSampler( GLuint sampler );
+	static	void				ForgetFramebuffer( GLuint framebuffer );
+
+	//-----------------------------------------------------------------------------------------------
+	// Command Callbacks
+	static	bool				StatsCommand( Command& cmd );
+	static	bool				ValidateCommand( Command& cmd );
+
+private:
+			bool				Filter( eGLStateCategory category, bool isSame ); // Counts the call, true when it can be dropped
+			void				SetActiveUnit( GLuint unit );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			GLuint				m_program;
+			GLuint				m_vao;
+			GLuint				m_buffers[STATE_CACHE_BUFFER_TARGETS];			// The element array binding belongs to m_vao
+			GLuint				m_bufferBases[STATE_CACHE_INDEXED_TARGETS][STATE_CACHE_BUFFER_BINDINGS];
+			GLuint				m_activeUnit;
+			GLuint				m_textures[STATE_CACHE_TEXTURE_UNITS][STATE_CACHE_TEXTURE_TARGETS];
+			GLuint				m_samplers[STATE_CACHE_TEXTURE_UNITS];
+			GLuint				m_drawFramebuffer;
+			GLuint				m_readFramebuffer;
+
+			int8_t				m_caps[STATE_CACHE_CAPS];				// -1 unknown, otherwise 0 or 1
+			GLenum				m_blendEquations[2];
+			GLenum				m_blendFuncs[4];
+			GLenum				m_depthFunc;
+			int8_t				m_depthMask;
+			GLenum				m_frontFace;
+			GLenum				m_cullFace;
+			GLenum				m_polygonMode;
+			GLint				m_viewport[4];
+			bool				m_isViewportKnown;
+
+			GLStateStats		m_frameStats;
+			GLStateStats		m_lastFrameStats;
+			bool				m_isValidating = false;
+			int					m_desyncCount = 0;		// Since startup
+};
@@ -2,6 +2,8 @@
 #include "Engine/Renderer/IsoSpriteAnim.hpp"
 #include "Engine/Renderer/IsoSprite.hpp"
 #include "Engine/Renderer/IsoSpriteAnimSetDefinition.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -80,3 +82,33 @@ bool IsoSpriteAnimSet::IsCurrentAnimFinished()
 {
 	return m_currentAnim->IsFinished();
 }
+
+//-----------------------------------------------------------------------------------------------
+// Submits the sprite facing the camera to the sprite batch. A negative scale mirrors the sprite by
+// flipping its uvs, so the quad keeps its winding
+//
+void IsoSpriteAnimSet::Draw(Renderer& renderer, const Matrix44& transform, int layer /*= 0*/, const Rgba& tint /*= Rgba::WHITE*/) const
+{
+	const IsoSprite* sprite = GetCurrentIsoSprite();
+	Vector2 scale = sprite->GetScale();
+	AABB2 localBounds = sprite->GetBounds();
+	AABB2 uvs = sprite->GetUV();
+
+	AABB2 bounds;
+	bounds.mins.x = std::min(localBounds.mins.x * scale.x, localBounds.maxs.x * scale.x);
+	bounds.maxs.x = std::max(localBounds.mins.x * scale.x, localBounds.maxs.x * scale.x);
+	bounds.mins.y = std::min(localBounds.mins.y * scale.y, localBounds.maxs.y * scale.y);
+	bounds.maxs.y = std::max(localBounds.mins.y * scale.y, localBounds.maxs.y * scale.y);
+
+	if(scale.x < 0.f)
+	{
+		std::swap(uvs.mins.x, uvs.maxs.x);
+	}
+
+	if(scale.y < 0.f)
+	{
+		std::swap(uvs.mins.y, uvs.maxs.y);
+	}
+
+	renderer.DrawSprite(*sprite->GetTexture(), bounds, uvs, transform, layer, tint);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "Engine/Core/Rgba.hpp"
 #include <string>
 #include <map>
 
@@ -8,6 +9,8 @@ class IsoSpriteAnimSetDefinition;
 class IsoSprite;
 class Texture;
 class IsoSpriteAnim;
+class Renderer;
+class Matrix44;
 
 //-----------------------------------------------------------------------------------------------
 class IsoSpriteAnimSet
@@ -30,6 +33,7 @@ public:
 			void 			Update( float deltaSeconds );
 			void 			StartAnim( const std::string& animName );
 			bool			IsCurrentAnimFinished();
+			void			Draw( Renderer& renderer, const Matrix44& transform, int layer = 0, const Rgba& tint = Rgba::WHITE ) const; // Joins the renderer's sprite batch
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
@@ -0,0 +1,182 @@
+#include "Engine/Renderer/Lights/CascadedShadowMap.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/Lights/Light.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Sampler.hpp"
+#include "Engine/Renderer/TextureArray.hpp"
+#include "Engine/Renderer/Buffers/UniformBuffer.hpp"
+#include "Engine/Enumerations/ReservedUniformBlock.hpp"
+#include "Engine/Enumerations/TextureSlot.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <math.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+CascadedShadowMap::CascadedShadowMap(int cascadeCount, int resolution)
+	: m_cascadeCount(cascadeCount)
+	, m_resolution(resolution)
+{
+	m_depthTarget = new TextureArray();
+	m_depthTarget->CreateDepthTarget(resolution, cascadeCount);
+	m_colorTarget = Renderer::GetInstance()->CreateRenderTarget(resolution, resolution);
+
+	for(int cascade = 0; cascade < m_cascadeCount; ++cascade)
+	{
+		m_cameras[cascade] = new Camera();
+		m_cameras[cascade]->SetColorTarget(m_colorTarget);
+		m_cameras[cascade]->SetDepthTargetLayer(m_depthTarget, cascade);
+	}
+
+	m_cascadeBuffer = new UniformBuffer();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+CascadedShadowMap::~CascadedShadowMap()
+{
+	for(int cascade = 0; cascade < m_cascadeCount; ++cascade)
+	{
+		delete m_cameras[cascade];
+		m_cameras[cascade] = nullptr;
+	}
+
+	delete m_depthTarget;
+	m_depthTarget = nullptr;
+
+	delete m_colorTarget;
+	m_colorTarget = nullptr;
+
+	delete m_cascadeBuffer;
+	m_cascadeBuffer = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Splits the view camera's frustum up to the light's shadow distance and fits every cascade
+//
+void CascadedShadowMap::Update(const Camera* viewCamera, const Light* light)
+{
+	const Matrix44& proj = viewCamera->m_projMatrix;
+	bool isPerspective = proj.Kw != 0.f;
+
+	float zNear;
+	float zFar;
+	if(isPerspective)
+	{
+		zNear = -proj.Tz / (proj.Kz + 1.f);
+		zFar = -proj.Tz / (proj.Kz - 1.f);
+	}
+	else
+	{
+		zNear = (-1.f - proj.Tz) / proj.Kz;
+		zFar = (1.f - proj.Tz) / proj.Kz;
+	}
+	zFar = Min(zFar, zNear + light->GetShadowDistance());
+
+	float splits[MAX_SHADOW_CASCADES + 1];
+	ComputeSplitDepths(zNear, zFar, m_cascadeCount, SHADOW_CASCADE_SPLIT_LAMBDA, splits);
+
+	// Corner directions in view space, depth is +z. Perspective corners scale with depth
+	Vector2 cornerMins((-1.f - proj.Tx) / proj.Ix, (-1.f - proj.Ty) / proj.Jy);
+	Vector2 cornerMaxs((1.f - proj.Tx) / proj.Ix, (1.f - proj.Ty) / proj.Jy);
+	Matrix44 cameraToWorld = Matrix44::InvertFast(viewCamera->m_viewMatrix);
+	Vector3 lightDir = light->GetDirection().GetNormalized();
+
+	for(int cascade = 0; cascade < m_cascadeCount; ++cascade)
+	{
+		Vector3 sliceCorners[8];
+		for(int cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+		{
+			float depth = (cornerIndex < 4) ? splits[cascade] : splits[cascade + 1];
+			float scale = isPerspective ? depth : 1.f;
+			float x = (cornerIndex & 1) ? cornerMaxs.x : cornerMins.x;
+			float y = (cornerIndex & 2) ? cornerMaxs.y : cornerMins.y;
+			sliceCorners[cornerIndex] = cameraToWorld.TransformPosition3D(Vector3(x * scale, y * scale, depth));
+		}
+
+		m_block.viewProjections[cascade] = FitCascade(cascade, sliceCorners, lightDir);
+	}
+
+	float splitDepths[MAX_SHADOW_CASCADES] = { 0.f, 0.f, 0.f, 0.f };
+	for(int cascade = 0; cascade < m_cascadeCount; ++cascade)
+	{
+		splitDepths[cascade] = splits[cascade + 1];
+	}
+
+	const Matrix44& view = viewCamera->m_viewMatrix;
+	m_block.splitDepths = Vector4(splitDepths[0], splitDepths[1], splitDepths[2], splitDepths[3]);
+	m_block.info = Vector4((float) m_cascadeCount, 1.f / (float) m_resolution, 0.f, 0.f);
+	m_block.viewZRow = Vector4(view.Iz, view.Jz, view.Kz, view.Tz);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the cascade matrices and binds the depth array for the lit shaders
+//
+void CascadedShadowMap::UpdateGPU()
+{
+	m_cascadeBuffer->Set<ShadowCascadeBlock>(m_block);
+	m_cascadeBuffer->UpdateGPU();
+
+	Renderer* rend = Renderer::GetInstance();
+	rend->BindUBO(BLOCK_SHADOW_CASCADES, m_cascadeBuffer);
+	rend->BindTextureArray(TEXTURE_SLOT_SHADOW_CASCADES, m_depthTarget, Sampler::GetShadowSampler());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Practical split scheme, blends logarithmic splits (even texel density) with uniform splits
+// (keeps the first cascade from getting too small). out_splits holds cascadeCount + 1 depths
+//
+STATIC void CascadedShadowMap::ComputeSplitDepths(float zNear, float zFar, int cascadeCount, float lambda, float* out_splits)
+{
+	out_splits[0] = zNear;
+	for(int split = 1; split < cascadeCount; ++split)
+	{
+		float fraction = (float) split / (float) cascadeCount;
+		float logSplit = zNear * powf(zFar / zNear, fraction);
+		float uniformSplit = zNear + (zFar - zNear) * fraction;
+		out_splits[split] = lambda * logSplit + (1.f - lambda) * uniformSplit;
+	}
+	out_splits[cascadeCount] = zFar;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Fits an orthographic box around the slice's bounding sphere. The sphere does not change size
+// as the camera turns and snapping its center to texels keeps the rasterization stable
+//
+Matrix44 CascadedShadowMap::FitCascade(int cascade, const Vector3* sliceCorners, const Vector3& lightDir)
+{
+	Vector3 center = Vector3::ZERO;
+	for(int cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+	{
+		center += sliceCorners[cornerIndex];
+	}
+	center *= (1.f / 8.f);
+
+	float radius = 0.f;
+	for(int cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+	{
+		radius = Max(radius, (sliceCorners[cornerIndex] - center).GetLength());
+	}
+	radius = ceilf(radius * 16.f) / 16.f; // Float noise would otherwise change the texel size
+
+	// Rotation only light space so the snapping grid does not move with the camera
+	Vector3 up = (fabsf(DotProduct(lightDir, Vector3::UP)) > 0.99f) ? Vector3::FORWARD : Vector3::UP;
+	Camera* cam = m_cameras[cascade];
+	cam->LookAt(Vector3::ZERO, lightDir, up);
+
+	Vector3 lightSpaceCenter = cam->m_viewMatrix.TransformPosition3D(center);
+	float texelSize = (2.f * radius) / (float) m_resolution;
+	lightSpaceCenter.x = floorf(lightSpaceCenter.x / texelSize) * texelSize;
+	lightSpaceCenter.y = floorf(lightSpaceCenter.y / texelSize) * texelSize;
+
+	cam->SetOrtho(lightSpaceCenter.x - radius, lightSpaceCenter.x + radius,
+		lightSpaceCenter.y - radius, lightSpaceCenter.y + radius,
+		lightSpaceCenter.z - radius - SHADOW_CASCADE_CASTER_RANGE, lightSpaceCenter.z + radius);
+
+	return cam->m_projMatrix * cam->m_viewMatrix;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Structures/UniformStructures.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Camera;
+class Light;
+class Texture;
+class TextureArray;
+class UniformBuffer;
+
+//-----------------------------------------------------------------------------------------------
+constexpr float SHADOW_CASCADE_SPLIT_LAMBDA = 0.75f;	// 0 = uniform splits, 1 = logarithmic splits
+constexpr float SHADOW_CASCADE_CASTER_RANGE = 100.f;	// How far behind a cascade casters are still caught
+
+//-----------------------------------------------------------------------------------------------
+// Splits a camera's frustum into depth slices and fits an orthographic shadow map of the
+// directional light around each one. Every cascade renders into its own layer of one depth
+// texture array. The boxes are sized from bounding spheres and snapped to whole texels so they
+// do not shimmer when the camera moves or turns
+//
+class CascadedShadowMap
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	CascadedShadowMap( int cascadeCount, int resolution );
+	~CascadedShadowMap();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int				GetCascadeCount() const { return m_cascadeCount; }
+			int				GetResolution() const { return m_resolution; }
+			Camera*			GetCascadeCamera( int cascade ) const { return m_cameras[cascade]; }
+			TextureArray*	GetDepthTarget() const { return m_depthTarget; }
+	const	Matrix44&		GetViewProjection( int cascade ) const { return m_block.viewProjections[cascade]; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void			Update( const Camera* viewCamera, const Light* light );
+			void			UpdateGPU(); // Uploads and binds the block and the depth array for the following draws
+
+	static	void			ComputeSplitDepths( float zNear, float zFar, int cascadeCount, float lambda, float* out_splits );
+
+private:
+			Matrix44		FitCascade( int cascade, const Vector3* sliceCorners, const Vector3& lightDir );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	int					m_cascadeCount = 0;
+	int					m_resolution = 0;
+	Camera*				m_cameras[MAX_SHADOW_CASCADES] = {};
+	TextureArray*		m_depthTarget = nullptr;
+	Texture*			m_colorTarget = nullptr; // Shared by the cascade cameras, never sampled
+	UniformBuffer*		m_cascadeBuffer = nullptr;
+	ShadowCascadeBlock	m_block;
+};
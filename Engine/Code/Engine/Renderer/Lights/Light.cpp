@@ -2,6 +2,7 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Transform.hpp"
 #include "Engine/Renderer/DebugRenderUtils.hpp"
+#include <math.h>
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 
@@ -81,6 +82,80 @@ void Light::SetViewProjection(const Matrix44& vp)
 	m_lightDesc.shadowVP = vp;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the attenuated intensity at the position
+//
+float Light::GetPowerAtPosition(const Vector3& position) const
+{
+	const Vector3& atten = m_lightDesc.attenuation;
+	float distance = (GetWorldPosition() - position).GetLength();
+	return m_lightDesc.color.a / (atten.x + distance * atten.y + distance * distance * atten.z);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Solves the attenuation for the distance where the power drops below the threshold
+//
+float Light::GetInfluenceRadius(float threshold /*= LIGHT_INFLUENCE_THRESHOLD*/) const
+{
+	if(!IsBounded())
+	{
+		return INFINITY;
+	}
+
+	// intensity / (a.x + d*a.y + d*d*a.z) = threshold
+	const Vector3& atten = m_lightDesc.attenuation;
+	float c = atten.x - (m_lightDesc.color.a / threshold);
+	if(c >= 0.f)
+	{
+		return 0.f; // Never bright enough to matter
+	}
+
+	if(atten.z == 0.f)
+	{
+		return -c / atten.y;
+	}
+
+	float discriminant = atten.y * atten.y - 4.f * atten.z * c;
+	return (-atten.y + sqrtf(discriminant)) / (2.f * atten.z);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the light has a finite influence radius
+//
+bool Light::IsBounded() const
+{
+	const Vector3& atten = m_lightDesc.attenuation;
+	return !IsDirectional() && (atten.y > 0.f || atten.z > 0.f);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true for lights that only have a direction
+//
+bool Light::IsDirectional() const
+{
+	return m_lightDesc.directionFactor == 1.f && m_lightDesc.spotFactor == 0.f;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets how many cascades the directional shadow is split into and the size of each
+//
+void Light::SetShadowCascades(int cascadeCount, int resolution /*= 2048*/)
+{
+	m_shadowCascadeCount = ClampInt(cascadeCount, 0, MAX_SHADOW_CASCADES);
+	m_shadowCascadeResolution = resolution;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the light data in world space for the light buffers
+//
+LightStructure Light::GetGPUData() const
+{
+	LightStructure data = m_lightDesc;
+	data.position = GetWorldPosition();
+	data.direction = GetDirection();
+	return data;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets up the light as a point light
 //
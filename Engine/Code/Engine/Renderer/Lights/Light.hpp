@@ -2,11 +2,15 @@
 #include "Engine/Core/Rgba.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Structures/LightStructure.hpp"
+#include "Engine/Structures/UniformStructures.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Transform;
 
+//-----------------------------------------------------------------------------------------------
+constexpr float LIGHT_INFLUENCE_THRESHOLD = 0.01f; // Attenuated intensity below which a light is ignored
+
 //-----------------------------------------------------------------------------------------------
 class Light
 {
@@ -35,6 +39,18 @@ public:
 			float	GetInnerDot() const { return m_lightDesc.dotInnerAngle; }
 			float	GetOuterDot() const { return m_lightDesc.dotOuterAngle; }
 			void	SetViewProjection( const Matrix44& vp );
+			void	SetShadowAtlasTile( const Vector3& uvTransform ) { m_lightDesc.shadowAtlasTile = uvTransform; }
+			float	GetPowerAtPosition( const Vector3& position ) const;
+			float	GetInfluenceRadius( float threshold = LIGHT_INFLUENCE_THRESHOLD ) const; // Infinite for directional or non falloff lights
+			bool	IsBounded() const;
+			bool	IsDirectional() const;
+			bool	UsesShadowCascades() const { return IsShadowCasting() && IsDirectional() && m_shadowCascadeCount > 0; }
+			int		GetShadowCascadeCount() const { return m_shadowCascadeCount; }
+			int		GetShadowCascadeResolution() const { return m_shadowCascadeResolution; }
+			float	GetShadowDistance() const { return m_shadowDistance; }
+			void	SetShadowCascades( int cascadeCount, int resolution = 2048 ); // 0 cascades puts the light in the shadow atlas
+			void	SetShadowDistance( float distance ) { m_shadowDistance = distance; }
+			LightStructure	GetGPUData() const; // World space data as the shaders expect it
 
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -47,6 +63,9 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Members
 	bool			m_isShadowCasting = false;
+	int				m_shadowCascadeCount = MAX_SHADOW_CASCADES;
+	int				m_shadowCascadeResolution = 2048;
+	float			m_shadowDistance = 100.f; // Cascades cover the camera frustum up to here
 	Transform*		m_transform;
 	LightStructure	m_lightDesc;
 };
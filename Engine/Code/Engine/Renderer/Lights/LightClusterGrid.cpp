@@ -0,0 +1,279 @@
+#include "Engine/Renderer/Lights/LightClusterGrid.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/Lights/Light.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/FrameBuffer.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Buffers/StorageBuffer.hpp"
+#include "Engine/Renderer/Buffers/UniformBuffer.hpp"
+#include "Engine/Enumerations/ReservedUniformBlock.hpp"
+#include "Engine/Enumerations/ReservedStorageBlock.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <math.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+LightClusterGrid::LightClusterGrid()
+{
+	m_lightBuffer = new StorageBuffer();
+	m_clusterBuffer = new StorageBuffer();
+	m_indexBuffer = new StorageBuffer();
+	m_infoBuffer = new UniformBuffer();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+LightClusterGrid::~LightClusterGrid()
+{
+	delete m_lightBuffer;
+	m_lightBuffer = nullptr;
+
+	delete m_clusterBuffer;
+	m_clusterBuffer = nullptr;
+
+	delete m_indexBuffer;
+	m_indexBuffer = nullptr;
+
+	delete m_infoBuffer;
+	m_infoBuffer = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the cluster at the grid coords
+//
+const LightCluster& LightClusterGrid::GetCluster(int x, int y, int z) const
+{
+	int width = (int) m_info.dimensions[0];
+	int height = (int) m_info.dimensions[1];
+	return m_clusters[(z * height + y) * width + x];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Assigns the lights to the clusters of the camera. Index lists are built in two passes
+// (count, then fill) so they end up packed in one array
+//
+void LightClusterGrid::Build(Camera* cam, const std::vector<Light*>& lights)
+{
+	const Matrix44& proj = cam->m_projMatrix;
+	const Matrix44& view = cam->m_viewMatrix;
+
+	// Ortho cameras get a single cluster
+	m_isPerspective = (proj.Kw == 1.f);
+	int clustersX = m_isPerspective ? LIGHT_CLUSTERS_X : 1;
+	int clustersY = m_isPerspective ? LIGHT_CLUSTERS_Y : 1;
+	int clustersZ = m_isPerspective ? LIGHT_CLUSTERS_Z : 1;
+
+	// Recover the planes from the projection (Kz = (f+n)/(f-n), Tz = -2fn/(f-n))
+	if(m_isPerspective)
+	{
+		m_near = -proj.Tz / (proj.Kz + 1.f);
+		m_far = -proj.Tz / (proj.Kz - 1.f);
+	}
+	else
+	{
+		// Keeps the shader's log well defined, the zero slice scale maps everything to slice 0
+		m_near = 1.f;
+		m_far = 1.f;
+	}
+
+	float logDepthRatio = m_isPerspective ? logf(m_far / m_near) : 1.f;
+	float sliceScale = m_isPerspective ? (float) clustersZ / logDepthRatio : 0.f;
+	float sliceBias = m_isPerspective ? -(float) clustersZ * logf(m_near) / logDepthRatio : 0.f;
+
+	Vector2 viewportMins = cam->GetViewportMins();
+	Vector2 viewportSize = cam->GetViewportMaxs(); // SetCamera treats maxs as the size
+	if(viewportSize.x <= 0.f || viewportSize.y <= 0.f)
+	{
+		viewportSize = Vector2((float) cam->m_frameBuffer->GetWidth(), (float) cam->m_frameBuffer->GetHeight());
+	}
+
+	m_info.dimensions[0] = (uint32_t) clustersX;
+	m_info.dimensions[1] = (uint32_t) clustersY;
+	m_info.dimensions[2] = (uint32_t) clustersZ;
+	m_info.depthParams = Vector4(m_near, m_far, sliceScale, sliceBias);
+	m_info.viewport = Vector4(viewportMins.x, viewportMins.y, viewportSize.x, viewportSize.y);
+	m_info.viewZRow = Vector4(view.Iz, view.Jz, view.Kz, view.Tz);
+
+	// Global lights first so the shader can loop them without indices
+	m_lightData.clear();
+	for(const Light* light : lights)
+	{
+		if(!light->IsBounded())
+		{
+			m_lightData.push_back(light->GetGPUData());
+		}
+	}
+	m_info.dimensions[3] = (uint32_t) m_lightData.size();
+
+	// Count pass
+	int clusterCount = clustersX * clustersY * clustersZ;
+	m_clusters.assign(clusterCount, LightCluster());
+	m_lightRanges.clear();
+
+	for(const Light* light : lights)
+	{
+		if(light->IsBounded())
+		{
+			AddLightToClusters((int) m_lightData.size(), light, cam);
+			m_lightData.push_back(light->GetGPUData());
+		}
+	}
+
+	// Prefix sum into offsets
+	uint32_t offset = 0;
+	m_maxLightsPerCluster = 0;
+	for(LightCluster& cluster : m_clusters)
+	{
+		cluster.offset = offset;
+		offset += cluster.count;
+		m_maxLightsPerCluster = Max(m_maxLightsPerCluster, (int) cluster.count);
+		cluster.count = 0;
+	}
+
+	// Fill pass
+	m_lightIndices.resize(offset);
+	for(size_t rangeIndex = 0; rangeIndex < m_lightRanges.size(); rangeIndex += 7)
+	{
+		const int* range = &m_lightRanges[rangeIndex];
+		uint32_t lightIndex = (uint32_t) range[6];
+
+		for(int z = range[4]; z <= range[5]; ++z)
+		{
+			for(int y = range[2]; y <= range[3]; ++y)
+			{
+				LightCluster* row = &m_clusters[(z * clustersY + y) * clustersX];
+				for(int x = range[0]; x <= range[1]; ++x)
+				{
+					LightCluster& cluster = row[x];
+					m_lightIndices[cluster.offset + cluster.count] = lightIndex;
+					cluster.count++;
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the grid and binds it for the clustered shaders
+//
+void LightClusterGrid::UpdateGPU()
+{
+	m_lightBuffer->Set(m_lightData);
+	m_clusterBuffer->Set(m_clusters);
+	m_indexBuffer->Set(m_lightIndices);
+
+	m_infoBuffer->Set<LightClusterBlock>(m_info);
+	m_infoBuffer->UpdateGPU();
+
+	Renderer* rend = Renderer::GetInstance();
+	rend->BindUBO(BLOCK_LIGHT_CLUSTERS, m_infoBuffer);
+	rend->BindSSBO(STORAGE_LIGHTS, m_lightBuffer);
+	rend->BindSSBO(STORAGE_LIGHT_CLUSTERS, m_clusterBuffer);
+	rend->BindSSBO(STORAGE_LIGHT_INDICES, m_indexBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Finds the cluster range the light's bounding sphere covers and counts it in those clusters
+//
+void LightClusterGrid::AddLightToClusters(int lightIndex, const Light* light, const Camera* cam)
+{
+	int clustersX = (int) m_info.dimensions[0];
+	int clustersY = (int) m_info.dimensions[1];
+	int clustersZ = (int) m_info.dimensions[2];
+
+	int minX = 0;
+	int maxX = clustersX - 1;
+	int minY = 0;
+	int maxY = clustersY - 1;
+	int minZ = 0;
+	int maxZ = clustersZ - 1;
+
+	if(m_isPerspective)
+	{
+		const Matrix44& proj = cam->m_projMatrix;
+		Vector3 center = cam->m_viewMatrix.TransformPosition3D(light->GetWorldPosition());
+		float radius = light->GetInfluenceRadius();
+
+		float zNear = center.z - radius;
+		float zFar = center.z + radius;
+		if(zFar < m_near || zNear > m_far)
+		{
+			return;
+		}
+
+		zNear = Max(zNear, m_near);
+		zFar = Min(zFar, m_far);
+		minZ = GetSliceForDepth(zNear);
+		maxZ = GetSliceForDepth(zFar);
+
+		// x/z and y/z are monotonic in each term so the extremes are at the box corners
+		float xs[2] = { center.x - radius, center.x + radius };
+		float ys[2] = { center.y - radius, center.y + radius };
+		float zs[2] = { zNear, zFar };
+
+		float minNdcX = INFINITY;
+		float maxNdcX = -INFINITY;
+		float minNdcY = INFINITY;
+		float maxNdcY = -INFINITY;
+		for(int zIndex = 0; zIndex < 2; ++zIndex)
+		{
+			float invZ = 1.f / zs[zIndex];
+			for(int cornerIndex = 0; cornerIndex < 2; ++cornerIndex)
+			{
+				float ndcX = proj.Ix * xs[cornerIndex] * invZ + proj.Kx;
+				float ndcY = proj.Jy * ys[cornerIndex] * invZ + proj.Ky;
+				minNdcX = Min(minNdcX, ndcX);
+				maxNdcX = Max(maxNdcX, ndcX);
+				minNdcY = Min(minNdcY, ndcY);
+				maxNdcY = Max(maxNdcY, ndcY);
+			}
+		}
+
+		if(maxNdcX < -1.f || minNdcX > 1.f || maxNdcY < -1.f || minNdcY > 1.f)
+		{
+			return;
+		}
+
+		minX = GetTileForNDC(minNdcX, clustersX);
+		maxX = GetTileForNDC(maxNdcX, clustersX);
+		minY = GetTileForNDC(minNdcY, clustersY);
+		maxY = GetTileForNDC(maxNdcY, clustersY);
+	}
+
+	for(int z = minZ; z <= maxZ; ++z)
+	{
+		for(int y = minY; y <= maxY; ++y)
+		{
+			LightCluster* row = &m_clusters[(z * clustersY + y) * clustersX];
+			for(int x = minX; x <= maxX; ++x)
+			{
+				row[x].count++;
+			}
+		}
+	}
+
+	int range[7] = { minX, maxX, minY, maxY, minZ, maxZ, lightIndex };
+	m_lightRanges.insert(m_lightRanges.end(), range, range + 7);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the exponential depth slice for the view depth (Must match the shader)
+//
+int LightClusterGrid::GetSliceForDepth(float viewDepth) const
+{
+	int slice = (int) floorf(logf(viewDepth) * m_info.depthParams.z + m_info.depthParams.w);
+	return ClampInt(slice, 0, (int) m_info.dimensions[2] - 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the tile for the ndc coordinate
+//
+int LightClusterGrid::GetTileForNDC(float ndc, int tileCount) const
+{
+	int tile = (int) floorf((ndc * 0.5f + 0.5f) * (float) tileCount);
+	return ClampInt(tile, 0, tileCount - 1);
+}
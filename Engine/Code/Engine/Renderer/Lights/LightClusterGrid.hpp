@@ -0,0 +1,63 @@
+#pragma once
+#include "Engine/Structures/UniformStructures.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Camera;
+class Light;
+class StorageBuffer;
+class UniformBuffer;
+
+//-----------------------------------------------------------------------------------------------
+constexpr int LIGHT_CLUSTERS_X = 16;
+constexpr int LIGHT_CLUSTERS_Y = 9;
+constexpr int LIGHT_CLUSTERS_Z = 24; // Exponential depth slices
+
+//-----------------------------------------------------------------------------------------------
+// Froxel grid over a camera's frustum. Lights are assigned to the clusters their bounds touch
+// and the shaders walk only the lights of the fragment's cluster
+//
+class LightClusterGrid
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	LightClusterGrid();
+	~LightClusterGrid();
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	int					GetLightCount() const { return (int) m_lightData.size(); }
+	int					GetLightIndexCount() const { return (int) m_lightIndices.size(); }
+	int					GetMaxLightsPerCluster() const { return m_maxLightsPerCluster; }
+	const LightCluster&	GetCluster( int x, int y, int z ) const;
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	void				Build( Camera* cam, const std::vector<Light*>& lights );
+	void				UpdateGPU(); // Uploads and binds the buffers for the following draws
+
+private:
+	void				AddLightToClusters( int lightIndex, const Light* light, const Camera* cam );
+	int					GetSliceForDepth( float viewDepth ) const;
+	int					GetTileForNDC( float ndc, int tileCount ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	LightClusterBlock			m_info;
+	std::vector<LightStructure>	m_lightData;		// Global (unbounded) lights come first
+	std::vector<LightCluster>	m_clusters;
+	std::vector<uint32_t>		m_lightIndices;
+	std::vector<int>			m_lightRanges;		// Scratch, min/max cluster coords and the light index (7 ints per light)
+	int							m_maxLightsPerCluster = 0;
+	float						m_near = 0.f;
+	float						m_far = 0.f;
+	bool						m_isPerspective = true;
+
+	StorageBuffer*				m_lightBuffer = nullptr;
+	StorageBuffer*				m_clusterBuffer = nullptr;
+	StorageBuffer*				m_indexBuffer = nullptr;
+	UniformBuffer*				m_infoBuffer = nullptr;
+};
+
@@ -0,0 +1,316 @@
+#include "Engine/Renderer/Lights/ShadowAtlas.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/Lights/Light.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Renderable.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/Sampler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <algorithm>
+#include <math.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Finalizer from splitmix64, spreads the bits so the per caster hashes can be summed
+//
+static uint64_t MixHash(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+ShadowAtlas::ShadowAtlas()
+{
+	Renderer* rend = Renderer::GetInstance();
+	m_colorTarget = rend->CreateRenderTarget(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE);
+	m_staticDepthTarget = rend->CreateDepthStencilTarget(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE);
+	m_atlasDepthTarget = rend->CreateDepthStencilTarget(SHADOW_ATLAS_SIZE, SHADOW_ATLAS_SIZE);
+	m_atlasDepthTarget->SetSampler(Sampler::GetShadowSampler());
+
+	m_staticCamera = new Camera();
+	m_staticCamera->SetColorTarget(m_colorTarget);
+	m_staticCamera->SetDepthTarget(m_staticDepthTarget);
+
+	m_atlasCamera = new Camera();
+	m_atlasCamera->SetColorTarget(m_colorTarget);
+	m_atlasCamera->SetDepthTarget(m_atlasDepthTarget);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+ShadowAtlas::~ShadowAtlas()
+{
+	delete m_staticCamera;
+	m_staticCamera = nullptr;
+
+	delete m_atlasCamera;
+	m_atlasCamera = nullptr;
+
+	delete m_staticDepthTarget;
+	m_staticDepthTarget = nullptr;
+
+	delete m_atlasDepthTarget;
+	m_atlasDepthTarget = nullptr;
+
+	delete m_colorTarget;
+	m_colorTarget = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the atlas the shaders sample from
+//
+Texture* ShadowAtlas::GetDepthTarget() const
+{
+	return m_atlasDepthTarget;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the tile of the light for this frame, nullptr if the light did not get one
+//
+ShadowTile* ShadowAtlas::GetTile(const Light* light)
+{
+	std::map<const Light*, ShadowTile>::iterator found = m_tiles.find(light);
+	if(found == m_tiles.end() || found->second.lastUsedFrame != m_frame)
+	{
+		return nullptr;
+	}
+
+	return &found->second;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hands out the tiles for this frame, most important lights first. Sizes are powers of two so a
+// quadtree split packs them without gaps. A light keeping its region keeps its cached depth
+//
+void ShadowAtlas::AllocateTiles(const std::vector<Light*>& lights, const std::vector<Camera*>& cameras)
+{
+	++m_frame;
+	m_stats = ShadowStats();
+
+	std::vector<std::pair<float, Light*>> ranked;
+	for(Light* light : lights)
+	{
+		if(light->IsShadowCasting() && !light->UsesShadowCascades())
+		{
+			ranked.push_back(std::make_pair(ComputeScreenImportance(light, cameras), light));
+		}
+	}
+
+	std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<float, Light*>& a, const std::pair<float, Light*>& b)
+	{
+		return a.first > b.first;
+	});
+
+	m_freeRegions.clear();
+	m_freeRegions.push_back(AABB2(Vector2::ZERO, Vector2((float) SHADOW_ATLAS_SIZE, (float) SHADOW_ATLAS_SIZE)));
+
+	for(const std::pair<float, Light*>& entry : ranked)
+	{
+		// Fall back to smaller tiles when the atlas runs out of room
+		AABB2 region;
+		bool isAllocated = false;
+		for(int size = GetTileSizeForImportance(entry.first); size >= SHADOW_TILE_MIN_SIZE && !isAllocated; size /= 2)
+		{
+			isAllocated = AllocateRegion(size, region);
+		}
+
+		if(!isAllocated)
+		{
+			m_stats.lightsWithoutTile++;
+			continue;
+		}
+
+		ShadowTile& tile = m_tiles[entry.second];
+		if(tile.pixelRegion.mins != region.mins || tile.pixelRegion.maxs != region.maxs)
+		{
+			tile.pixelRegion = region;
+			tile.isStaticCacheValid = false;
+		}
+		tile.lastUsedFrame = m_frame;
+		m_stats.tilesAllocated++;
+	}
+
+	// Forget the lights that went away or lost their tile
+	for(std::map<const Light*, ShadowTile>::iterator iter = m_tiles.begin(); iter != m_tiles.end();)
+	{
+		if(iter->second.lastUsedFrame != m_frame)
+		{
+			iter = m_tiles.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Points both cameras at the light and the tile, returns the light's view projection
+//
+Matrix44 ShadowAtlas::SetupCamerasForTile(const Light* light, const ShadowTile& tile)
+{
+	Vector3 worldPos = light->GetWorldPosition();
+	Vector3 target = worldPos + light->m_transform->GetForward();
+	Vector2 tileSize = tile.pixelRegion.maxs - tile.pixelRegion.mins;
+
+	Camera* cameras[2] = { m_staticCamera, m_atlasCamera };
+	for(Camera* cam : cameras)
+	{
+		if(light->GetSpotFactor() == 1.f && light->IsBounded())
+		{
+			float fovDegrees = 2.f * AcosDegrees(light->GetOuterDot());
+			cam->SetPerspective(fovDegrees, 1.f, 0.1f, light->GetInfluenceRadius());
+		}
+		else
+		{
+			cam->SetOrtho(-128.f, 128.f, -128.f, 128.f, 0.f, 100.f);
+		}
+
+		cam->LookAt(worldPos, target);
+		cam->SetViewport(tile.pixelRegion.mins, tileSize); // Renderer treats the viewport maxs as the size
+	}
+
+	return m_atlasCamera->m_projMatrix * m_atlasCamera->m_viewMatrix;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rehashes the static casters, returns true if the tile's static cache has to be redrawn
+//
+bool ShadowAtlas::UpdateStaticSignature(ShadowTile& tile, const Matrix44& viewProjection, const std::vector<Renderable*>& staticCasters) const
+{
+	// Order independent so the query order of the casters does not matter
+	uint64_t signature = MixHash(staticCasters.size());
+	for(const Renderable* caster : staticCasters)
+	{
+		// Chained so every bit of the version and both pointers reaches the hash
+		uint64_t casterHash = MixHash((uint64_t) (uintptr_t) caster);
+		casterHash = MixHash(casterHash ^ (uint64_t) caster->GetTransformVersion());
+		casterHash = MixHash(casterHash ^ (uint64_t) (uintptr_t) caster->GetMesh());
+		signature += casterHash;
+	}
+
+	bool isDirty = !tile.isStaticCacheValid || tile.staticSignature != signature || !(tile.viewProjection == viewProjection);
+	tile.staticSignature = signature;
+	tile.viewProjection = viewProjection;
+	tile.isStaticCacheValid = true;
+	return isDirty;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Forces every tile to be redrawn next frame
+//
+void ShadowAtlas::InvalidateAll()
+{
+	for(std::pair<const Light* const, ShadowTile>& entry : m_tiles)
+	{
+		entry.second.isStaticCacheValid = false;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the largest fraction of a camera's screen height the light's influence can cover,
+// unbounded lights cover everything
+//
+STATIC float ShadowAtlas::ComputeScreenImportance(const Light* light, const std::vector<Camera*>& cameras)
+{
+	if(!light->IsBounded())
+	{
+		return 1.f;
+	}
+
+	float radius = light->GetInfluenceRadius();
+	Vector3 lightPos = light->GetWorldPosition();
+	float importance = 0.f;
+	for(const Camera* cam : cameras)
+	{
+		float distance = (lightPos - cam->m_transform.GetWorldPosition()).GetLength();
+		if(distance <= radius)
+		{
+			return 1.f;
+		}
+
+		// Projected radius in NDC, w is the distance for perspective and 1 for ortho
+		const Matrix44& proj = cam->m_projMatrix;
+		float w = proj.Kw * distance + proj.Tw;
+		float coverage = (radius * fabsf(proj.Jy)) / std::max(w, 0.0001f);
+		importance = std::max(importance, ClampFloat(coverage * 0.5f, 0.f, 1.f));
+	}
+
+	return importance;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Halves the tile for every halving of the importance
+//
+STATIC int ShadowAtlas::GetTileSizeForImportance(float importance)
+{
+	int size = SHADOW_TILE_MAX_SIZE;
+	while(size > SHADOW_TILE_MIN_SIZE && importance < 0.5f)
+	{
+		size /= 2;
+		importance *= 2.f;
+	}
+
+	return size;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the tile's placement in the atlas in uv space for the shaders
+//
+STATIC Vector3 ShadowAtlas::GetTileUVTransform(const ShadowTile& tile)
+{
+	float invSize = 1.f / (float) SHADOW_ATLAS_SIZE;
+	Vector2 offset = tile.pixelRegion.mins * invSize;
+	float scale = (tile.pixelRegion.maxs.x - tile.pixelRegion.mins.x) * invSize;
+	return Vector3(offset.x, offset.y, scale);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Takes the smallest free square that fits and splits it into quadrants down to the size
+//
+bool ShadowAtlas::AllocateRegion(int size, AABB2& out_region)
+{
+	int bestIndex = -1;
+	float bestSize = 0.f;
+	for(int index = 0; index < (int) m_freeRegions.size(); ++index)
+	{
+		float regionSize = m_freeRegions[index].maxs.x - m_freeRegions[index].mins.x;
+		if(regionSize >= (float) size && (bestIndex == -1 || regionSize < bestSize))
+		{
+			bestIndex = index;
+			bestSize = regionSize;
+		}
+	}
+
+	if(bestIndex == -1)
+	{
+		return false;
+	}
+
+	AABB2 region = m_freeRegions[bestIndex];
+	m_freeRegions.erase(m_freeRegions.begin() + bestIndex);
+
+	while(region.maxs.x - region.mins.x > (float) size)
+	{
+		float half = (region.maxs.x - region.mins.x) * 0.5f;
+		Vector2 center = region.mins + Vector2(half, half);
+		m_freeRegions.push_back(AABB2(Vector2(center.x, region.mins.y), Vector2(region.maxs.x, center.y)));
+		m_freeRegions.push_back(AABB2(Vector2(region.mins.x, center.y), Vector2(center.x, region.maxs.y)));
+		m_freeRegions.push_back(AABB2(center, region.maxs));
+		region = AABB2(region.mins, center);
+	}
+
+	out_region = region;
+	return true;
+}
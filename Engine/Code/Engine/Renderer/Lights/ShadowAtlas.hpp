@@ -0,0 +1,94 @@
+#pragma once
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Camera;
+class Light;
+class Renderable;
+class Texture;
+
+//-----------------------------------------------------------------------------------------------
+constexpr int SHADOW_ATLAS_SIZE = 4096;
+constexpr int SHADOW_TILE_MAX_SIZE = 2048;
+constexpr int SHADOW_TILE_MIN_SIZE = 256;
+
+//-----------------------------------------------------------------------------------------------
+struct ShadowTile
+{
+	AABB2		pixelRegion;
+	Matrix44	viewProjection;
+	uint64_t	staticSignature = 0;			// Hash of the static casters and their transform versions
+	bool		isStaticCacheValid = false;
+	bool		hasDynamicCasters = false;		// The atlas tile holds dynamic depth on top of the cache
+	uint32_t	lastUsedFrame = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Per frame counters, reset when the tiles are allocated
+//
+struct ShadowStats
+{
+	int			tilesAllocated = 0;
+	int			tilesSkipped = 0;			// Nothing changed, the atlas tile was left alone
+	int			staticCachesRebuilt = 0;
+	int			staticDraws = 0;
+	int			staticDrawsSkipped = 0;		// Static casters served from the cache
+	int			dynamicDraws = 0;
+	int			cascadeDraws = 0;			// Directional lights render cascades instead of atlas tiles
+	int			lightsWithoutTile = 0;		// The atlas was full
+};
+
+//-----------------------------------------------------------------------------------------------
+// One depth atlas shared by every shadow casting light. Each light gets a square tile sized by
+// how much of the screen it can affect. Static casters are rendered to a cache atlas which is
+// only rebuilt when the light or a static caster in its frustum changes, dynamic casters are
+// drawn over a copy of the cached tile
+//
+class ShadowAtlas
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ShadowAtlas();
+	~ShadowAtlas();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			Texture*		GetDepthTarget() const;
+			Camera*			GetStaticCamera() const { return m_staticCamera; }
+			Camera*			GetAtlasCamera() const { return m_atlasCamera; }
+			ShadowTile*		GetTile( const Light* light );
+			ShadowStats&	GetStats() { return m_stats; }
+	const	ShadowStats&	GetStats() const { return m_stats; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void			AllocateTiles( const std::vector<Light*>& lights, const std::vector<Camera*>& cameras );
+			Matrix44		SetupCamerasForTile( const Light* light, const ShadowTile& tile );
+			bool			UpdateStaticSignature( ShadowTile& tile, const Matrix44& viewProjection, const std::vector<Renderable*>& staticCasters ) const;
+			void			InvalidateAll();
+
+	static	float			ComputeScreenImportance( const Light* light, const std::vector<Camera*>& cameras );
+	static	int				GetTileSizeForImportance( float importance );
+	static	Vector3			GetTileUVTransform( const ShadowTile& tile ); // xy = uv offset, z = uv scale
+
+private:
+			bool			AllocateRegion( int size, AABB2& out_region );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::map<const Light*, ShadowTile>	m_tiles;
+	std::vector<AABB2>					m_freeRegions;	// Quadtree leaves still available this frame
+	Camera*								m_staticCamera = nullptr;
+	Camera*								m_atlasCamera = nullptr;
+	Texture*							m_staticDepthTarget = nullptr;
+	Texture*							m_atlasDepthTarget = nullptr;
+	Texture*							m_colorTarget = nullptr; // Shared by both cameras, never sampled
+	ShadowStats							m_stats;
+	uint32_t							m_frame = 0;
+};
@@ -3,11 +3,6 @@
 // Engine Includes
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty_Float.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty_Int.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty_Matrix44.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty_Rgba.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty_Vector3.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
@@ -15,6 +10,10 @@
 
 typedef tinyxml2::XMLDocument XMLDocument;
 
+//-----------------------------------------------------------------------------------------------
+// Static globals
+uint32_t Material::m_nextID = 0;
+
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
@@ -45,14 +44,6 @@ Material::~Material()
 		delete m_shaderInstance;
 		m_shaderInstance = nullptr;
 	}
-
-	for(std::map<std::string, MaterialProperty*>::iterator iter = m_properties.begin(); iter != m_properties.end(); ++iter)
-	{
-		delete iter->second;
-		iter->second = nullptr;
-	}
-
-	m_properties.clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -273,168 +264,51 @@ int Material::GetRenderQueue() const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Returns the property if it exists or returns nullptr
+// Returns true if the property is set
 //
-MaterialProperty* Material::GetProperty(const char* name) const
+bool Material::HasProperty(const char* name) const
 {
-	std::map<std::string, MaterialProperty*>::const_iterator found = m_properties.find(name);
-	if(found != m_properties.end())
-	{
-		return found->second;
-	}
-
-	return nullptr;
+	return m_properties.HasProperty(GetUniformID(name));
 }
 
 //-----------------------------------------------------------------------------------------------
-// Checks the type of the existing property (if any) and modifies accordingly
+// Sets the property, a property set with another type before is replaced
 //
 void Material::SetProperty(const char* name, float value)
 {
-	MaterialProperty* prop = GetProperty(name);
-
-	if(prop == nullptr)
-	{
-		prop = new MaterialProperty_Float(name, value);
-	}
-	else
-	{
-		// Already exists and data types match
-		if(prop->GetType() == DATA_FLOAT)
-		{
-			MaterialProperty_Float* propFloat = (MaterialProperty_Float*) prop;
-			propFloat->SetData(value);
-			return;
-		}
-		else
-		{
-			RemoveProperty(name);
-			prop = new MaterialProperty_Float(name, value);
-		}
-	}
-
-	m_properties[name] = prop;
+	m_properties.SetFloat(GetUniformID(name), value);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Checks the type of the existing property (if any) and modifies accordingly
+// Sets the property, a property set with another type before is replaced
 //
 void Material::SetProperty(const char* name, int value)
 {
-	MaterialProperty* prop = GetProperty(name);
-
-	if(prop == nullptr)
-	{
-		prop = new MaterialProperty_Int(name, value);
-	}
-	else
-	{
-		// Already exists and data types match
-		if(prop->GetType() == DATA_INT)
-		{
-			MaterialProperty_Int* propInt = (MaterialProperty_Int*) prop;
-			propInt->SetData(value);
-			return;
-		}
-		else
-		{
-			RemoveProperty(name);
-			prop = new MaterialProperty_Int(name, value);
-		}
-	}
-
-	m_properties[name] = prop;
+	m_properties.SetInt(GetUniformID(name), value);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Checks the type of the existing property (if any) and modifies accordingly
+// Sets the property, a property set with another type before is replaced
 //
 void Material::SetProperty(const char* name, const Rgba& color)
 {
-	MaterialProperty* prop = GetProperty(name);
-
-	if(prop == nullptr)
-	{
-		prop = new MaterialProperty_Rgba(name, color);
-	}
-	else
-	{
-		// Already exists and data types match
-		if(prop->GetType() == DATA_RGBA)
-		{
-			MaterialProperty_Rgba* propColor = (MaterialProperty_Rgba*) prop;
-			propColor->SetData(color);
-			return;
-		}
-		else
-		{
-			RemoveProperty(name);
-			prop = new MaterialProperty_Rgba(name, color);
-		}
-	}
-
-	m_properties[name] = prop;
+	m_properties.SetColor(GetUniformID(name), color);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Checks the type of the existing property (if any) and modifies accordingly
+// Sets the property, a property set with another type before is replaced
 //
 void Material::SetProperty(const char* name, const Matrix44& matrix, bool transpose /*= false */)
 {
-	MaterialProperty* prop = GetProperty(name);
-
-	if(prop == nullptr)
-	{
-		prop = new MaterialProperty_Matrix44(name, matrix, transpose);
-	}
-	else
-	{
-		// Already exists and data types match
-		if(prop->GetType() == DATA_MATRIX44)
-		{
-			MaterialProperty_Matrix44* propColor = (MaterialProperty_Matrix44*) prop;
-			propColor->SetData(matrix);
-			propColor->SetTransposeMode(transpose);
-			return;
-		}
-		else
-		{
-			RemoveProperty(name);
-			prop = new MaterialProperty_Matrix44(name, matrix, transpose);
-		}
-	}
-
-	m_properties[name] = prop;
+	m_properties.SetMatrix(GetUniformID(name), matrix, transpose);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Checks the type of the existing property (if any) and modifies accordingly
+// Sets the property, a property set with another type before is replaced
 //
 void Material::SetProperty(const char* name, const Vector3& value)
 {
-	MaterialProperty* prop = GetProperty(name);
-
-	if(prop == nullptr)
-	{
-		prop = new MaterialProperty_Vector3(name, value);
-	}
-	else
-	{
-		// Already exists and data types match
-		if(prop->GetType() == DATA_VECTOR3)
-		{
-			MaterialProperty_Vector3* propInt = (MaterialProperty_Vector3*) prop;
-			propInt->SetData(value);
-			return;
-		}
-		else
-		{
-			RemoveProperty(name);
-			prop = new MaterialProperty_Vector3(name, value);
-		}
-	}
-
-	m_properties[name] = prop;
+	m_properties.SetVector3(GetUniformID(name), value);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -589,13 +463,7 @@ void Material::ParseVec3sFromXML(const XMLElement& root)
 //
 void Material::RemoveProperty(const char* name)
 {
-	MaterialProperty* prop = GetProperty(name);
-	if(prop)
-	{
-		m_properties.erase(name);
-		delete prop;
-		prop = nullptr;
-	}
+	m_properties.Remove(GetUniformID(name));
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -610,15 +478,7 @@ Material* Material::Clone() const
 		clone->m_shaderInstance = new Shader(*m_shaderInstance);
 	}
 
-	if(m_properties.size() > 0) // Create copy of properties to avoid same changing same memory locations
-	{
-		std::map<std::string, MaterialProperty*>::const_iterator iter = m_properties.begin();
-		while(iter != m_properties.end())
-		{
-			clone->m_properties[iter->first] = iter->second->Clone();
-			++iter;
-		}
-	}
+	clone->m_properties = m_properties; // The block is plain values, copying it is enough
 	
 	clone->m_textures = m_textures;
 
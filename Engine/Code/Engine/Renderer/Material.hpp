@@ -2,8 +2,10 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <cstdint>
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Core/XMLUtils.hpp"
+#include "Engine/Renderer/MaterialProperties/MaterialPropertyBlock.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -12,7 +14,6 @@ class Sampler;
 class Rgba;
 class Matrix44;
 class Vector3;
-class MaterialProperty;
 
 //-----------------------------------------------------------------------------------------------
 class Material
@@ -30,6 +31,7 @@ public:
 	bool				IsValid() const { return m_shader != nullptr; }
 	bool				IsLit() const { return m_isLit; }
 	bool				IsOpaque() const;
+	uint32_t			GetID() const { return m_id; } // Unique per material instance, used to group draws
 
 	// Texture functions
 	void				SetTexture( int bind, Texture* resource, Sampler* sampler = nullptr );
@@ -58,8 +60,8 @@ public:
 	int					GetSortOrder() const;
 	int					GetRenderQueue() const;
 
-	// Property functions - Check current DataType enum and modify if types match else create new
-	MaterialProperty*	GetProperty( const char* name ) const;
+	// Property functions - Names are interned, the block takes IDs directly for hot paths
+	bool				HasProperty( const char* name ) const;
 	void				SetProperty( const char* name, float value );
 	void				SetProperty( const char* name, int value );
 	void				SetProperty( const char* name, const Rgba& color );
@@ -92,10 +94,15 @@ public:
 	std::string									m_name = "";
 	Shader*										m_shader = nullptr;
 	Shader*										m_shaderInstance = nullptr;
-	std::map<std::string, MaterialProperty*>	m_properties;
+	MaterialPropertyBlock						m_properties;
 	std::vector<Texture*>						m_textures; 
 	float										m_specFactor = 0.f;
 	float										m_specPower = 8.f;
 	bool										m_isLit = true;
+	uint32_t									m_id = m_nextID++;
+
+	//-----------------------------------------------------------------------------------------------
+	// Static members
+	static	uint32_t							m_nextID;
 };
 
@@ -0,0 +1,189 @@
+#include "Engine/Renderer/MaterialProperties/MaterialPropertyBlock.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/ShaderProgram.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Core/Rgba.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <string.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of floats a value of the type takes
+//
+static int GetFloatCount(DataType type)
+{
+	switch(type)
+	{
+	case DATA_INT:			return 1;
+	case DATA_FLOAT:		return 1;
+	case DATA_MATRIX44:		return 16;
+	case DATA_RGBA:			return 4;
+	case DATA_VECTOR3:		return 3;
+	default:				return 0;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the type of the property, invalid if it is not set
+//
+DataType MaterialPropertyBlock::GetType(UniformID id) const
+{
+	int slotIndex = FindSlot(id);
+	return (slotIndex >= 0) ? m_slots[slotIndex].m_type : DATA_INVALID;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets a float property
+//
+void MaterialPropertyBlock::SetFloat(UniformID id, float value)
+{
+	float* values = GetValues(id, DATA_FLOAT, 1);
+	values[0] = value;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets an int property
+//
+void MaterialPropertyBlock::SetInt(UniformID id, int value)
+{
+	float* values = GetValues(id, DATA_INT, 1);
+	memcpy(values, &value, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets a color property, normalized when it is stored
+//
+void MaterialPropertyBlock::SetColor(UniformID id, const Rgba& color)
+{
+	float* values = GetValues(id, DATA_RGBA, 4);
+	color.GetAsFloats(values[0], values[1], values[2], values[3]);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets a matrix property
+//
+void MaterialPropertyBlock::SetMatrix(UniformID id, const Matrix44& matrix, bool transpose /*= false */)
+{
+	float* values = GetValues(id, DATA_MATRIX44, 16);
+	memcpy(values, matrix.data, 16 * sizeof(float));
+	m_slots[FindSlot(id)].m_isTranspose = transpose;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets a Vector3 property
+//
+void MaterialPropertyBlock::SetVector3(UniformID id, const Vector3& value)
+{
+	float* values = GetValues(id, DATA_VECTOR3, 3);
+	memcpy(values, value.data, 3 * sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes the property and closes the gap it leaves in the values
+//
+void MaterialPropertyBlock::Remove(UniformID id)
+{
+	int slotIndex = FindSlot(id);
+	if(slotIndex < 0)
+	{
+		return;
+	}
+
+	MaterialPropertySlot removed = m_slots[slotIndex];
+	int floatCount = GetFloatCount(removed.m_type);
+	m_values.erase(m_values.begin() + removed.m_offset, m_values.begin() + removed.m_offset + floatCount);
+	m_slots.erase(m_slots.begin() + slotIndex);
+
+	for(MaterialPropertySlot& slot : m_slots)
+	{
+		if(slot.m_offset > removed.m_offset)
+		{
+			slot.m_offset = (uint16_t) (slot.m_offset - floatCount);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Removes every property
+//
+void MaterialPropertyBlock::Clear()
+{
+	m_slots.clear();
+	m_values.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads every property the program uses
+//
+void MaterialPropertyBlock::Bind(const ShaderProgram& program) const
+{
+	for(const MaterialPropertySlot& slot : m_slots)
+	{
+		int location = program.GetUniformLocation(slot.m_id);
+		if(location < 0)
+		{
+			continue;
+		}
+
+		const float* values = &m_values[slot.m_offset];
+		switch(slot.m_type)
+		{
+		case DATA_INT:			glUniform1iv(location, 1, (const GLint*) values);	break;
+		case DATA_FLOAT:		glUniform1fv(location, 1, values);					break;
+		case DATA_MATRIX44:		glUniformMatrix4fv(location, 1, slot.m_isTranspose, values);	break;
+		case DATA_RGBA:			glUniform4fv(location, 1, values);					break;
+		case DATA_VECTOR3:		glUniform3fv(location, 1, values);					break;
+		default:																	break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the slot index of the property, -1 if it is not set. Materials have a handful of
+// properties, so a linear walk beats any lookup structure
+//
+int MaterialPropertyBlock::FindSlot(UniformID id) const
+{
+	for(int slotIndex = 0; slotIndex < (int) m_slots.size(); ++slotIndex)
+	{
+		if(m_slots[slotIndex].m_id == id)
+		{
+			return slotIndex;
+		}
+	}
+
+	return -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns where the property's values go, adding it at the end when it is new or was set with
+// another type before
+//
+float* MaterialPropertyBlock::GetValues(UniformID id, DataType type, int floatCount)
+{
+	int slotIndex = FindSlot(id);
+	if(slotIndex >= 0 && m_slots[slotIndex].m_type == type)
+	{
+		return &m_values[m_slots[slotIndex].m_offset];
+	}
+
+	if(slotIndex >= 0)
+	{
+		Remove(id);
+	}
+
+	MaterialPropertySlot slot;
+	slot.m_id = id;
+	slot.m_type = type;
+	slot.m_offset = (uint16_t) m_values.size();
+	m_slots.push_back(slot);
+	m_values.resize(m_values.size() + floatCount, 0.f);
+
+	return &m_values[slot.m_offset];
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Engine/Renderer/UniformID.hpp"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class ShaderProgram;
+class Matrix44;
+class Rgba;
+class Vector3;
+
+//-----------------------------------------------------------------------------------------------
+enum DataType
+{
+	DATA_INVALID = -1,
+	DATA_INT,
+	DATA_FLOAT,
+	DATA_MATRIX44,
+	DATA_RGBA,
+	DATA_VECTOR3,
+	NUM_DATA_TYPES
+};
+
+//-----------------------------------------------------------------------------------------------
+// Where a property's value lives in the block
+//
+struct MaterialPropertySlot
+{
+	UniformID	m_id = INVALID_UNIFORM_ID;
+	DataType	m_type = DATA_INVALID;
+	uint16_t	m_offset = 0;			// In floats, ints are stored bit for bit
+	bool		m_isTranspose = false;	// Matrices only
+};
+
+//-----------------------------------------------------------------------------------------------
+// Material properties as one array of values with a small slot list in front, keyed by interned
+// uniform IDs. Setting an existing property overwrites it in place, binding walks the slots
+// and reads locations from the program's table. Colors are stored as normalized floats
+//
+class MaterialPropertyBlock
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool		HasProperty( UniformID id ) const { return FindSlot(id) >= 0; }
+			DataType	GetType( UniformID id ) const;
+			int			GetPropertyCount() const { return (int) m_slots.size(); }
+
+			void		SetFloat( UniformID id, float value );
+			void		SetInt( UniformID id, int value );
+			void		SetColor( UniformID id, const Rgba& color );
+			void		SetMatrix( UniformID id, const Matrix44& matrix, bool transpose = false );
+			void		SetVector3( UniformID id, const Vector3& value );
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void		Remove( UniformID id );
+			void		Clear();
+			void		Bind( const ShaderProgram& program ) const; // Program has to be in use
+
+private:
+			int			FindSlot( UniformID id ) const;
+			float*		GetValues( UniformID id, DataType type, int floatCount ); // Adds or retypes the slot
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			std::vector<MaterialPropertySlot>	m_slots;
+			std::vector<float>					m_values;
+};
@@ -4,6 +4,38 @@
 #include "Engine/Core/Vertex.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Mesh/MeshBuilder.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bounds of the layout's float3 POSITION attribute, infinite if the layout has none
+//
+static AABB3 ComputeVertexBounds(uint count, const void* vertices, const VertexLayout& layout)
+{
+	const VertexAttribute* positionAttribute = nullptr;
+	for(const VertexAttribute* attribute : layout.m_attributes)
+	{
+		if(strcmp(attribute->m_handle, "POSITION") == 0 && attribute->m_type == RT_FLOAT && attribute->m_elementCount == 3)
+		{
+			positionAttribute = attribute;
+			break;
+		}
+	}
+
+	if(positionAttribute == nullptr || count == 0 || vertices == nullptr)
+	{
+		return AABB3();
+	}
+
+	AABB3 bounds = AABB3::MakeEmpty();
+	const unsigned char* position = (const unsigned char*) vertices + positionAttribute->m_memberOffset;
+	for(uint index = 0; index < count; ++index)
+	{
+		bounds.GrowToContain(*(const Vector3*) position);
+		position += layout.m_stride;
+	}
+
+	return bounds;
+}
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -31,11 +63,44 @@ Mesh::~Mesh()
 //
 void Mesh::SetVertices(uint count, const void* vertices, const VertexLayout& layout)
 {
+	if(m_layout != &layout)
+	{
+		m_vertexArrays.Clear();
+	}
+
 	m_vbo->SetStride(layout.m_stride);
 	m_vbo->SetCount(count);
 
 	m_vbo->CopyToGPU( count * layout.m_stride, vertices ); 
 	m_layout = &layout;
+
+	SetBounds(ComputeVertexBounds(count, vertices, layout));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Maps the vertex buffer so count vertices can be written straight into it
+//
+void* Mesh::MapVertices(uint count, const VertexLayout& layout)
+{
+	if(m_layout != &layout)
+	{
+		m_vertexArrays.Clear();
+	}
+
+	m_vbo->SetStride(layout.m_stride);
+	m_vbo->SetCount(count);
+	m_layout = &layout;
+	SetBounds(AABB3()); // The writes can't be seen from here, the caller sets them if it knows them
+
+	return m_vbo->MapForWrite(count * layout.m_stride);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Unmaps the vertex buffer after MapVertices
+//
+void Mesh::UnmapVertices()
+{
+	m_vbo->Unmap();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1,5 +1,9 @@
 #pragma once
 #include "Engine/Structures/DrawInstruction.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include "Engine/Renderer/VertexArrayCache.hpp"
+#include <stdint.h>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -16,6 +20,8 @@ struct VertexLit;
 class Mesh
 {
 public:
+	MEMORY_TAG_CLASS(MEMORY_TAG_MESH)
+
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	Mesh();
@@ -25,9 +31,14 @@ public:
 	// Accessors/Mutators
 			void			SetVertices( uint count, const void* vertices, const VertexLayout& layout );
 			void			SetIndices( uint count, const uint* indices );
+			void*			MapVertices( uint count, const VertexLayout& layout ); // Write only, call UnmapVertices before drawing. Bounds become unknown until SetBounds
+			void			UnmapVertices();
 			void			SetDrawInstructions( DrawPrimitiveType type, bool useIndices, size_t startIndex, uint elementCount );
 			void			SetDrawInstructions( const DrawInstruction& instructions );
 	const	VertexLayout*	GetLayout() const { return m_layout; }
+			void			SetBounds( const AABB3& bounds ) { m_bounds = bounds; ++m_boundsVersion; }
+	const	AABB3&			GetBounds() const { return m_bounds; } // Local space, infinite if unknown
+			uint32_t		GetBoundsVersion() const { return m_boundsVersion; } // Bumped whenever the bounds are set
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -43,6 +54,9 @@ public:
 			IndexBuffer*	m_ibo = nullptr;
 	const	VertexLayout*	m_layout = nullptr;
 			DrawInstruction m_drawInstruction;
+			AABB3			m_bounds; // Default constructed aabb3 is infinite so unknown meshes never get culled
+			uint32_t		m_boundsVersion = 0;
+			VertexArrayCache	m_vertexArrays; // Per set of program inputs, cleared when the layout changes
 };
 
 template void Mesh::FromBuilder<VertexLit>( const MeshBuilder& builder );
@@ -155,11 +155,8 @@ Mesh* CreateBasisMesh(const Matrix44& basis, float scale /*= 1.f*/)
 Mesh* CreateTextMesh2D(const Vector2& position, const std::string& text, float cellHeight, const BitmapFont* font, const Rgba& tint /*= Rgba::WHITE*/, const Vector2& alignment /*= Vector2::ZERO */)
 {
 	MeshBuilder builder;
-	float cellWidth;
-	float cursorMins;
-	float cursorMaxs;
-	float lineMins = position.y;
-	float lineMaxs = position.y + cellHeight;
+	float cellWidth = cellHeight * font->GetBaseAspect();
+	float cursor;
 	int index;
 
 	// Compute offset based on alignment
@@ -168,27 +165,35 @@ Mesh* CreateTextMesh2D(const Vector2& position, const std::string& text, float c
 	// Generating the vertices 
 	builder.Begin(PRIMITIVE_TRIANGLES, true);
 	builder.SetColor(tint);
+	cursor = position.x - offsetX;
 	for(size_t textIndex = 0; textIndex < text.size(); ++textIndex)
 	{
-		cellWidth = cellHeight * font->GetGlyphAspect(text[textIndex]);
-		
-		cursorMins = (((float) textIndex * cellWidth) - offsetX) + position.x;
-		cursorMaxs = cursorMins + cellWidth;
-		AABB2 uvs = font->GetUVsForGlyph(text[textIndex]);
+		// Glyphs are placed by their metrics, the ones without ink only move the cursor
+		const GlyphMetrics& glyph = font->GetGlyphMetrics(text[textIndex]);
+		if(glyph.HasInk())
+		{
+			float glyphMinX = cursor + (glyph.m_bounds.mins.x * cellWidth);
+			float glyphMaxX = cursor + (glyph.m_bounds.maxs.x * cellWidth);
+			float glyphMinY = position.y + (glyph.m_bounds.mins.y * cellHeight);
+			float glyphMaxY = position.y + (glyph.m_bounds.maxs.y * cellHeight);
+			const AABB2& uvs = glyph.m_uvs;
 
-		builder.SetUV(uvs.mins.x, uvs.maxs.y);
-		index = builder.PushVertex(cursorMins, lineMins);
+			builder.SetUV(uvs.mins.x, uvs.maxs.y);
+			index = builder.PushVertex(glyphMinX, glyphMinY);
 
-		builder.SetUV(uvs.maxs.x, uvs.maxs.y);
-		builder.PushVertex(cursorMaxs, lineMins);
+			builder.SetUV(uvs.maxs.x, uvs.maxs.y);
+			builder.PushVertex(glyphMaxX, glyphMinY);
 
-		builder.SetUV(uvs.maxs.x, uvs.mins.y);
-		builder.PushVertex(cursorMaxs, lineMaxs);
+			builder.SetUV(uvs.maxs.x, uvs.mins.y);
+			builder.PushVertex(glyphMaxX, glyphMaxY);
 
-		builder.SetUV(uvs.mins);
-		builder.PushVertex(cursorMins, lineMaxs);
+			builder.SetUV(uvs.mins);
+			builder.PushVertex(glyphMinX, glyphMaxY);
 
-		builder.AddQuadIndices(index, index + 1, index + 2, index + 3);
+			builder.AddQuadIndices(index, index + 1, index + 2, index + 3);
+		}
+
+		cursor += glyph.m_advance * cellWidth;
 	}
 
 	builder.End();
@@ -3,9 +3,9 @@
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
-OrbitCamera::OrbitCamera():Camera()
+OrbitCamera::OrbitCamera(bool usesQuaternion):Camera()
 {
-
+	SetUsesQuaternion(usesQuaternion);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -12,7 +12,7 @@ class OrbitCamera: public Camera
 public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
-	OrbitCamera();
+	explicit OrbitCamera( bool usesQuaternion = false ); // Quaternion storage keeps LookAt exact instead of going through euler angles
 	~OrbitCamera(){}
 	
 	//-----------------------------------------------------------------------------------------------
@@ -4,41 +4,18 @@
 #include "Engine/Renderer/Renderable.hpp"
 #include "Engine/Math/Transform.hpp"
 #include "Engine/Renderer/Mesh/Mesh.hpp"
-#include "Engine/Renderer/Mesh/MeshBuilder.hpp"
 #include "Engine/Renderer/Mesh/MeshUtils.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Core/StopWatch.hpp"
+#include "Engine/Core/Vertex.hpp"
 #include "DebugRenderUtils.hpp"
 
 //-----------------------------------------------------------------------------------------------
 
 
-//-----------------------------------------------------------------------------------------------
-// Updates the particle
-//
-void Particle::Update(float deltaSeconds)
-{
-	Vector3 acceleration = force / mass; 
-	velocity += deltaSeconds * acceleration; 
-	position += deltaSeconds * velocity; 
-
-	force = Vector3::ZERO;
-}
-
-//-----------------------------------------------------------------------------------------------
-// Returns the normalized age
-//
-float Particle::GetNormalizedAge(float time)
-{
-	float duration = timeWillDie - timeBorn;
-	float elapsed = time - timeBorn;
-	
-	return elapsed * 1.f / duration;
-}
-
 //-----------------------------------------------------------------------------------------------
 // Constructor
 //
@@ -46,9 +23,9 @@ ParticleEmitter::ParticleEmitter()
 {
 	m_renderable = new Renderable();
 	m_transform = new Transform();
-	m_builder = new MeshBuilder();
 	m_clock = Clock::GetMasterClock();
 	m_mesh = new Mesh();
+	m_mesh->SetBounds(AABB3()); // Particles drift away from the emitter, never cull them
 	m_renderable->SetMesh(m_mesh);
 	m_renderable->SetWatchTransform(nullptr);
 	m_interval = new StopWatch();
@@ -59,8 +36,8 @@ ParticleEmitter::ParticleEmitter()
 //
 ParticleEmitter::~ParticleEmitter()
 {
-	delete m_builder;
-	m_builder = nullptr;
+	delete m_interval;
+	m_interval = nullptr;
 
 	delete m_transform;
 	m_transform = nullptr;
@@ -68,6 +45,9 @@ ParticleEmitter::~ParticleEmitter()
 	delete m_renderable;
 	m_renderable = nullptr;
 
+	delete m_mesh;
+	m_mesh = nullptr;
+
 	m_clock = nullptr;
 }
 
@@ -98,7 +78,7 @@ void ParticleEmitter::SetMaterial(const Material* mat)
 //
 bool ParticleEmitter::IsReadyToDestroy() const
 {
-	bool ready = !m_spawnsOverTime && m_particles.size();
+	bool ready = !m_spawnsOverTime && m_particles.GetCount();
 	return !ready;
 }
 
@@ -138,27 +118,36 @@ void ParticleEmitter::SetColorRange(const Rgba& min, const Rgba& max)
 }
 
 //-----------------------------------------------------------------------------------------------
-// Aligns the particles towards the camera
+// Aligns the particles towards the camera, the quads are written straight into the mapped
+// vertex buffer
 //
 void ParticleEmitter::PreRender(Camera* cam)
 {
-	Vector3 right = cam->GetRight(); 
-	Vector3 up = cam->GetUp(); 
-
-	m_builder->Flush();
-	m_builder->Begin(PRIMITIVE_TRIANGLES, true);
-	for (size_t index = 0; index < m_particles.size(); ++index) 
+	int count = m_particles.GetCount();
+	UpdateQuadIndices(count);
+	m_mesh->SetDrawInstructions(PRIMITIVE_TRIANGLES, true, 0, count * 6);
+	if(count == 0)
 	{
-		Particle& p = m_particles[index]; 
-		m_builder->SetColor(p.color);
-		m_builder->AddPlane(p.position, right, up, Vector2::ONE * p.size);
+		return;
 	}
-	m_builder->End();
-	m_mesh->FromBuilder<Vertex_3DPCU>(*m_builder);
+
+	ParticleBillboardDesc desc;
+	desc.m_right = cam->GetRight();
+	desc.m_up = cam->GetUp();
+	desc.m_sizeOverTime = m_sizeOverTime;
+	desc.m_startSize = m_sizeRange.max;
+	desc.m_endSize = m_sizeRange.min;
+	desc.m_colorOverTime = m_colorOverTime;
+	desc.m_startColor = m_color1;
+	desc.m_endColor = m_color2;
+
+	Vertex_3DPCU* vertices = (Vertex_3DPCU*) m_mesh->MapVertices(count * 4, Vertex_3DPCU::s_layout);
+	m_particles.WriteBillboards(vertices, desc);
+	m_mesh->UnmapVertices();
 }
 
 //-----------------------------------------------------------------------------------------------
-// Aligns particles towards camera and updates the emitter
+// Spawns the particles that are due and steps the pool
 //
 void ParticleEmitter::Update(float deltaSeconds)
 {
@@ -166,31 +155,7 @@ void ParticleEmitter::Update(float deltaSeconds)
 	SpawnBurst(count);
 
 	float time = (float) m_clock->GetTime(); 
-
-	for (size_t index = 0; index < m_particles.size(); ++index) 
-	{
-		Particle& p = m_particles[index]; 
-		p.force = m_force;
-		p.Update(deltaSeconds); 
-
-		float normalAge = p.GetNormalizedAge(time);
-		if(m_sizeOverTime)
-		{
-			p.size = Interpolate(m_sizeRange.max, m_sizeRange.min, normalAge);
-		}
-		if(m_colorOverTime)
-		{
-			p.color = Interpolate(m_color1, m_color2, normalAge);
-		}
-
-		if (p.IsDead(time)) 
-		{
-			m_particles[index] = m_particles[m_particles.size() - 1];
-			m_particles.pop_back();
-			index--;
-		} 
-	}
-
+	m_particles.Update(deltaSeconds, time, m_force);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -198,29 +163,14 @@ void ParticleEmitter::Update(float deltaSeconds)
 //
 void ParticleEmitter::SpawnParticle()
 {
-	Particle p; 
-	p.position = m_transform->GetWorldPosition(); // Model matrix moves it to the correct position
-	
-	if(m_velocityCB)
-	{
-		p.velocity = m_velocityCB();
-	}
-	else
-	{
-		p.velocity = m_velocity;
-	}
-	p.size = m_sizeRange.GetRandomInRange();
-	
-
+	Vector3 position = m_transform->GetWorldPosition(); // Model matrix moves it to the correct position
+	Vector3 velocity = m_velocityCB ? m_velocityCB() : m_velocity;
+	float size = m_sizeRange.GetRandomInRange();
 	float lifetime = m_lifeTimeRange.GetRandomInRange();
+	float timeBorn = (float) m_clock->GetTime();
+	Rgba color = Interpolate(m_color1, m_color2, GetRandomFloatZeroToOne());
 
-	p.timeBorn = (float) m_clock->GetTime();
-	p.timeWillDie = p.timeBorn + lifetime; 
-
-	p.force = Vector3::ZERO; 
-	p.mass = 1.0f; 
-	p.color = Interpolate(m_color1, m_color2, GetRandomFloatZeroToOne());
-	m_particles.push_back( p ); 
+	m_particles.Add(position, velocity, size, 1.f, color, timeBorn, lifetime);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -228,8 +178,38 @@ void ParticleEmitter::SpawnParticle()
 //
 void ParticleEmitter::SpawnBurst(int count)
 {
+	m_particles.Reserve(m_particles.GetCount() + count);
 	for(int index = 0; index < count; ++index)
 	{
 		SpawnParticle();
 	}
 }
+
+//-----------------------------------------------------------------------------------------------
+// Quad indices only depend on the particle count, so they are rebuilt when the emitter outgrows
+// them instead of every frame
+//
+void ParticleEmitter::UpdateQuadIndices(int particleCount)
+{
+	if(particleCount <= m_quadIndexCount)
+	{
+		return;
+	}
+
+	m_quadIndexCount = (particleCount > m_quadIndexCount * 2) ? particleCount : m_quadIndexCount * 2;
+
+	std::vector<uint> indices;
+	indices.reserve(m_quadIndexCount * 6);
+	for(uint quad = 0; quad < (uint) m_quadIndexCount; ++quad)
+	{
+		uint first = quad * 4;
+		indices.push_back(first + 0);
+		indices.push_back(first + 1);
+		indices.push_back(first + 3);
+		indices.push_back(first + 3);
+		indices.push_back(first + 1);
+		indices.push_back(first + 2);
+	}
+
+	m_mesh->SetIndices((uint) indices.size(), indices.data());
+}
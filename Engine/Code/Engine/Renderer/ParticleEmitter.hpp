@@ -3,12 +3,12 @@
 #include <vector>
 #include "Engine\Core\Rgba.hpp"
 #include "Engine\Math\FloatRange.hpp"
+#include "Engine\Renderer\ParticlePool.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Camera;
 class Mesh;
-class MeshBuilder;
 class Transform;
 class Renderable;
 class Clock;
@@ -17,25 +17,6 @@ class StopWatch;
 
 typedef Vector3 (*VelocityCB) ();
 
-//-----------------------------------------------------------------------------------------------
-struct Particle
-{
-	// Methods
-			void	Update( float deltaSeconds );
-	inline	bool	IsDead( float realTime ) { return realTime >= timeWillDie; }
-			float	GetNormalizedAge( float realTime );
-
-	// Members
-	Vector3 position;
-	Vector3	velocity;
-	Vector3 force;
-	Rgba	color = Rgba::WHITE;
-	float	size;
-	float	mass;
-	float	timeBorn;
-	float	timeWillDie;
-};
-
 //-----------------------------------------------------------------------------------------------
 class ParticleEmitter
 {
@@ -60,6 +41,7 @@ public:
 	void	SetForce( const Vector3& force ) { m_force = force; }
 	void	SetSizeOverTime( bool flag ) { m_sizeOverTime = flag; }
 	void	SetColorOverTime( bool flag ) { m_colorOverTime = flag; }
+	int		GetParticleCount() const { return m_particles.GetCount(); }
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -67,24 +49,25 @@ public:
 	void	Update( float deltaSeconds );
 	void	SpawnParticle();
 	void	SpawnBurst( int count );
+	void	UpdateQuadIndices( int particleCount ); // Grows the mesh's quad indices to fit the particles
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
 	Transform*				m_transform;
 	Renderable*				m_renderable;
 	Mesh*					m_mesh;
-	MeshBuilder*			m_builder;
 	bool					m_spawnsOverTime = false;
 	bool					m_colorOverTime = false;
 	bool					m_sizeOverTime = false;
 	bool					m_killWhenDone = false;
 	float					m_spawnRate = 0.f;
 	StopWatch*				m_interval;
-	std::vector<Particle>	m_particles;
+	ParticlePool			m_particles;
+	int						m_quadIndexCount = 0; // Particles the index buffer has quads for
 	Clock*					m_clock = nullptr;
 	FloatRange				m_sizeRange = FloatRange(.1f, .3f);
 	FloatRange				m_lifeTimeRange = FloatRange(1.f, 3.f);
-	VelocityCB				m_velocityCB;
+	VelocityCB				m_velocityCB = nullptr;
 	Vector3					m_velocity = Vector3::FORWARD;
 	Vector3					m_force = Vector3::ZERO;
 	Rgba					m_color1 = Rgba::WHITE;
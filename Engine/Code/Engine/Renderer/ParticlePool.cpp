@@ -0,0 +1,284 @@
+#include "Engine/Renderer/ParticlePool.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/Vertex.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/SIMD.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Moves one particle's attribute from the back into a hole
+//
+template <typename T>
+static void MoveFromBack(std::vector<T>& values, int index, int last)
+{
+	values[index] = values[last];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Makes room for capacity particles without touching the live ones
+//
+void ParticlePool::Reserve(int capacity)
+{
+	if(capacity <= GetCapacity())
+	{
+		return;
+	}
+
+	m_positionX.resize(capacity);
+	m_positionY.resize(capacity);
+	m_positionZ.resize(capacity);
+	m_velocityX.resize(capacity);
+	m_velocityY.resize(capacity);
+	m_velocityZ.resize(capacity);
+	m_inverseMass.resize(capacity);
+	m_size.resize(capacity);
+	m_timeBorn.resize(capacity);
+	m_inverseLifetime.resize(capacity);
+	m_normalizedAge.resize(capacity);
+	m_color.resize(capacity);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Appends a particle and returns its index, grows the arrays when full
+//
+int ParticlePool::Add(const Vector3& position, const Vector3& velocity, float size, float mass, const Rgba& color, float timeBorn, float lifetime)
+{
+	if(m_count == GetCapacity())
+	{
+		Reserve(m_count < 256 ? 256 : m_count * 2);
+	}
+
+	int index = m_count++;
+	m_positionX[index] = position.x;
+	m_positionY[index] = position.y;
+	m_positionZ[index] = position.z;
+	m_velocityX[index] = velocity.x;
+	m_velocityY[index] = velocity.y;
+	m_velocityZ[index] = velocity.z;
+	m_inverseMass[index] = 1.f / mass;
+	m_size[index] = size;
+	m_timeBorn[index] = timeBorn;
+	m_inverseLifetime[index] = 1.f / (lifetime > 0.0001f ? lifetime : 0.0001f);
+	m_normalizedAge[index] = 0.f;
+	m_color[index] = color;
+
+	return index;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Fills the hole with the last particle, does not keep the order
+//
+void ParticlePool::SwapRemove(int index)
+{
+	int last = --m_count;
+	if(index == last)
+	{
+		return;
+	}
+
+	MoveFromBack(m_positionX, index, last);
+	MoveFromBack(m_positionY, index, last);
+	MoveFromBack(m_positionZ, index, last);
+	MoveFromBack(m_velocityX, index, last);
+	MoveFromBack(m_velocityY, index, last);
+	MoveFromBack(m_velocityZ, index, last);
+	MoveFromBack(m_inverseMass, index, last);
+	MoveFromBack(m_size, index, last);
+	MoveFromBack(m_timeBorn, index, last);
+	MoveFromBack(m_inverseLifetime, index, last);
+	MoveFromBack(m_normalizedAge, index, last);
+	MoveFromBack(m_color, index, last);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Steps every particle, splitting the work across the job system for big pools, then drops
+// the ones that reached the end of their life
+//
+void ParticlePool::Update(float deltaSeconds, float time, const Vector3& force)
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if(jobSystem == nullptr || JobSystem::GetThreadIndex() < 0 || m_count < PARTICLE_PARALLEL_MIN_COUNT)
+	{
+		IntegrateRange(0, m_count, deltaSeconds, time, force);
+	}
+	else
+	{
+		jobSystem->ParallelForRange(m_count, [this, deltaSeconds, time, &force](int begin, int end)
+		{
+			IntegrateRange(begin, end, deltaSeconds, time, force);
+		}, PARTICLE_PARALLEL_MIN_BATCH);
+	}
+
+	RemoveDead();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Semi implicit Euler step and age for [begin, end). Ranges that do not overlap can run on
+// separate threads
+//
+void ParticlePool::IntegrateRange(int begin, int end, float deltaSeconds, float time, const Vector3& force)
+{
+	float* positionX = m_positionX.data();
+	float* positionY = m_positionY.data();
+	float* positionZ = m_positionZ.data();
+	float* velocityX = m_velocityX.data();
+	float* velocityY = m_velocityY.data();
+	float* velocityZ = m_velocityZ.data();
+	const float* inverseMass = m_inverseMass.data();
+	const float* timeBorn = m_timeBorn.data();
+	const float* inverseLifetime = m_inverseLifetime.data();
+	float* normalizedAge = m_normalizedAge.data();
+
+	int index = begin;
+
+#if defined(ENGINE_SIMD_ENABLED)
+	simd4f dt = SIMDSplat(deltaSeconds);
+	simd4f now = SIMDSplat(time);
+	simd4f forceDtX = SIMDSplat(force.x * deltaSeconds);
+	simd4f forceDtY = SIMDSplat(force.y * deltaSeconds);
+	simd4f forceDtZ = SIMDSplat(force.z * deltaSeconds);
+
+	for(; index + 4 <= end; index += 4)
+	{
+		simd4f invMass = SIMDLoad(inverseMass + index);
+
+		simd4f vx = SIMDMulAdd(forceDtX, invMass, SIMDLoad(velocityX + index));
+		simd4f vy = SIMDMulAdd(forceDtY, invMass, SIMDLoad(velocityY + index));
+		simd4f vz = SIMDMulAdd(forceDtZ, invMass, SIMDLoad(velocityZ + index));
+		SIMDStore(velocityX + index, vx);
+		SIMDStore(velocityY + index, vy);
+		SIMDStore(velocityZ + index, vz);
+
+		SIMDStore(positionX + index, SIMDMulAdd(vx, dt, SIMDLoad(positionX + index)));
+		SIMDStore(positionY + index, SIMDMulAdd(vy, dt, SIMDLoad(positionY + index)));
+		SIMDStore(positionZ + index, SIMDMulAdd(vz, dt, SIMDLoad(positionZ + index)));
+
+		simd4f age = SIMDMul(SIMDSub(now, SIMDLoad(timeBorn + index)), SIMDLoad(inverseLifetime + index));
+		SIMDStore(normalizedAge + index, age);
+	}
+#endif
+
+	// Tail, or everything when SIMD is off
+	for(; index < end; ++index)
+	{
+		velocityX[index] += force.x * deltaSeconds * inverseMass[index];
+		velocityY[index] += force.y * deltaSeconds * inverseMass[index];
+		velocityZ[index] += force.z * deltaSeconds * inverseMass[index];
+
+		positionX[index] += velocityX[index] * deltaSeconds;
+		positionY[index] += velocityY[index] * deltaSeconds;
+		positionZ[index] += velocityZ[index] * deltaSeconds;
+
+		normalizedAge[index] = (time - timeBorn[index]) * inverseLifetime[index];
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Swap removes every particle the kernel aged past 1. The particle moved into a hole is checked
+// again before moving on
+//
+void ParticlePool::RemoveDead()
+{
+	int index = 0;
+	while(index < m_count)
+	{
+		if(m_normalizedAge[index] >= 1.f)
+		{
+			SwapRemove(index);
+		}
+		else
+		{
+			++index;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Expands every live particle into a quad, splitting the work across the job system for big
+// pools. The output can be mapped GPU memory, it is only ever written
+//
+void ParticlePool::WriteBillboards(Vertex_3DPCU* out_vertices, const ParticleBillboardDesc& desc) const
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if(jobSystem == nullptr || JobSystem::GetThreadIndex() < 0 || m_count < PARTICLE_PARALLEL_MIN_COUNT)
+	{
+		WriteBillboardRange(out_vertices, 0, m_count, desc);
+		return;
+	}
+
+	jobSystem->ParallelForRange(m_count, [this, out_vertices, &desc](int begin, int end)
+	{
+		WriteBillboardRange(out_vertices, begin, end, desc);
+	}, PARTICLE_PARALLEL_MIN_BATCH);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the 4 vertices of every particle in [begin, end), same winding and uvs as
+// MeshBuilder::AddPlane with the particle at the bottom left corner. Size and color are lerped
+// inline on plain floats, the out of line Vector3/Rgba/Interpolate calls were most of the cost
+//
+void ParticlePool::WriteBillboardRange(Vertex_3DPCU* out_vertices, int begin, int end, const ParticleBillboardDesc& desc) const
+{
+	static const Vector2 uvs[4] = { Vector2(0.f, 0.f), Vector2(1.f, 0.f), Vector2(1.f, 1.f), Vector2(0.f, 1.f) };
+
+	const float* positionX = m_positionX.data();
+	const float* positionY = m_positionY.data();
+	const float* positionZ = m_positionZ.data();
+	const float* sizes = m_size.data();
+	const float* normalizedAge = m_normalizedAge.data();
+	const Rgba* colors = m_color.data();
+
+	float sizeDelta = desc.m_endSize - desc.m_startSize;
+	float startColor[4] = { desc.m_startColor.r, desc.m_startColor.g, desc.m_startColor.b, desc.m_startColor.a };
+	float colorDelta[4] = {
+		(float) desc.m_endColor.r - startColor[0],
+		(float) desc.m_endColor.g - startColor[1],
+		(float) desc.m_endColor.b - startColor[2],
+		(float) desc.m_endColor.a - startColor[3] };
+
+	for(int index = begin; index < end; ++index)
+	{
+		float age = normalizedAge[index];
+		float size = desc.m_sizeOverTime ? desc.m_startSize + (sizeDelta * age) : sizes[index];
+
+		Rgba color = colors[index];
+		if(desc.m_colorOverTime)
+		{
+			color.r = (unsigned char) (startColor[0] + (colorDelta[0] * age));
+			color.g = (unsigned char) (startColor[1] + (colorDelta[1] * age));
+			color.b = (unsigned char) (startColor[2] + (colorDelta[2] * age));
+			color.a = (unsigned char) (startColor[3] + (colorDelta[3] * age));
+		}
+
+		float x = positionX[index];
+		float y = positionY[index];
+		float z = positionZ[index];
+		float rightX = desc.m_right.x * size;
+		float rightY = desc.m_right.y * size;
+		float rightZ = desc.m_right.z * size;
+		float upX = desc.m_up.x * size;
+		float upY = desc.m_up.y * size;
+		float upZ = desc.m_up.z * size;
+
+		Vertex_3DPCU* quad = out_vertices + (index * 4);
+		quad[0].m_position.x = x;
+		quad[0].m_position.y = y;
+		quad[0].m_position.z = z;
+		quad[1].m_position.x = x + rightX;
+		quad[1].m_position.y = y + rightY;
+		quad[1].m_position.z = z + rightZ;
+		quad[2].m_position.x = x + rightX + upX;
+		quad[2].m_position.y = y + rightY + upY;
+		quad[2].m_position.z = z + rightZ + upZ;
+		quad[3].m_position.x = x + upX;
+		quad[3].m_position.y = y + upY;
+		quad[3].m_position.z = z + upZ;
+		for(int corner = 0; corner < 4; ++corner)
+		{
+			quad[corner].m_color = color;
+			quad[corner].m_UVs = uvs[corner];
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+struct Vertex_3DPCU;
+
+//-----------------------------------------------------------------------------------------------
+constexpr int PARTICLE_PARALLEL_MIN_COUNT = 8192;	// Below this the emitter stays on the calling thread
+constexpr int PARTICLE_PARALLEL_MIN_BATCH = 2048;
+
+//-----------------------------------------------------------------------------------------------
+// What the pool needs to expand particles into camera facing quads
+//
+struct ParticleBillboardDesc
+{
+	Vector3	m_right;
+	Vector3	m_up;
+	bool	m_sizeOverTime = false;
+	float	m_startSize = 0.f;	// Used instead of the particle's size when sizing over time
+	float	m_endSize = 0.f;
+	bool	m_colorOverTime = false;
+	Rgba	m_startColor;		// Used instead of the particle's color when coloring over time
+	Rgba	m_endColor;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Structure of arrays particle storage. Every attribute lives in its own tightly packed array so
+// the integrate kernel streams through only what it touches, 4 particles per instruction. Live
+// particles are always [0, count), dead ones are swap removed so the arrays never have holes
+//
+class ParticlePool
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	ParticlePool(){}
+	~ParticlePool(){}
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int					GetCount() const { return m_count; }
+			int					GetCapacity() const { return (int) m_timeBorn.size(); }
+			Vector3				GetPosition( int index ) const { return Vector3(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+			float				GetNormalizedAge( int index ) const { return m_normalizedAge[index]; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				Reserve( int capacity );
+			int					Add( const Vector3& position, const Vector3& velocity, float size, float mass, const Rgba& color, float timeBorn, float lifetime );
+			void				SwapRemove( int index );
+			void				Clear() { m_count = 0; }
+
+			void				Update( float deltaSeconds, float time, const Vector3& force ); // Integrates, ages and kills
+			void				IntegrateRange( int begin, int end, float deltaSeconds, float time, const Vector3& force );
+			void				RemoveDead();
+			void				WriteBillboards( Vertex_3DPCU* out_vertices, const ParticleBillboardDesc& desc ) const; // 4 vertices per particle
+			void				WriteBillboardRange( Vertex_3DPCU* out_vertices, int begin, int end, const ParticleBillboardDesc& desc ) const;
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	std::vector<float>	m_positionX;
+	std::vector<float>	m_positionY;
+	std::vector<float>	m_positionZ;
+	std::vector<float>	m_velocityX;
+	std::vector<float>	m_velocityY;
+	std::vector<float>	m_velocityZ;
+	std::vector<float>	m_inverseMass;		// Stored inverted so the kernel never divides
+	std::vector<float>	m_size;
+	std::vector<float>	m_timeBorn;
+	std::vector<float>	m_inverseLifetime;
+	std::vector<float>	m_normalizedAge;	// Written by the kernel, 1 or more means dead
+	std::vector<Rgba>	m_color;
+	int					m_count = 0;
+};
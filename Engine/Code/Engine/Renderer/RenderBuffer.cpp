@@ -1,5 +1,7 @@
 #include "Engine/Renderer/RenderBuffer.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -17,6 +19,7 @@ RenderBuffer::~RenderBuffer()
 {
 	// cleanup for a buffer; 
 	if (m_handle != NULL) {
+		GLStateCache::ForgetBuffer( m_handle );
 		glDeleteBuffers( 1, &m_handle ); 
 		m_handle = NULL; 
 	}
@@ -27,6 +30,7 @@ RenderBuffer::~RenderBuffer()
 //
 bool RenderBuffer::CopyToGPU(size_t const byte_count, void const *data)
 {
+	PROFILE_SCOPE_FUNCTION();
 	// handle is a GLuint member - used by OpenGL to identify this buffer
 	// if we don't have one, make one when we first need it [lazy instantiation]
 	if (m_handle == NULL) {
@@ -36,7 +40,7 @@ bool RenderBuffer::CopyToGPU(size_t const byte_count, void const *data)
 	// Bind the buffer to a slot, and copy memory
 	// GL_DYNAMIC_DRAW means the memory is likely going to change a lot (we'll get
 	// during the second project)
-	glBindBuffer( GL_ARRAY_BUFFER, m_handle ); 
+	GLStateCache::GetInstance()->BindBuffer( GL_ARRAY_BUFFER, m_handle ); 
 	glBufferData( GL_ARRAY_BUFFER, byte_count, data, GL_DYNAMIC_DRAW ); 
 
 	// buffer_size is a size_t member variable I keep around for 
@@ -45,3 +49,33 @@ bool RenderBuffer::CopyToGPU(size_t const byte_count, void const *data)
 	return true; 
 
 }
+
+//-----------------------------------------------------------------------------------------------
+// Maps the buffer so it can be filled in place instead of going through a CPU side copy. The
+// storage only grows, and invalidating lets the driver hand out fresh memory while the GPU is
+// still reading last frame's contents
+//
+void* RenderBuffer::MapForWrite(size_t const byte_count)
+{
+	PROFILE_SCOPE_FUNCTION();
+	if (m_handle == NULL) {
+		glGenBuffers( 1, &m_handle ); 
+	}
+
+	GLStateCache::GetInstance()->BindBuffer( GL_ARRAY_BUFFER, m_handle ); 
+	if (byte_count > m_bufferSize) {
+		glBufferData( GL_ARRAY_BUFFER, byte_count, nullptr, GL_STREAM_DRAW ); 
+		m_bufferSize = byte_count; 
+	}
+
+	return glMapBufferRange( GL_ARRAY_BUFFER, 0, byte_count, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ); 
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hands the mapped memory back to the GPU
+//
+void RenderBuffer::Unmap()
+{
+	GLStateCache::GetInstance()->BindBuffer( GL_ARRAY_BUFFER, m_handle ); 
+	glUnmapBuffer( GL_ARRAY_BUFFER ); 
+}
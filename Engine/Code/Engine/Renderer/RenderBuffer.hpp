@@ -16,6 +16,8 @@ public:
 	  //-----------------------------------------------------------------------------------------------
 	  // Methods
       bool		CopyToGPU( size_t const byte_count, void const *data ); // copies data to the GPU
+	  void*		MapForWrite( size_t const byte_count ); // write only memory for the whole buffer, previous contents are discarded
+	  void		Unmap(); // must be called before the buffer is drawn from
 	  GLuint	GetHandle() const{ return m_handle; } // returns the handle
 
 	  //-----------------------------------------------------------------------------------------------
@@ -2,62 +2,75 @@
 //-----------------------------------------------------------------------------------------------
 // Engine Includes
 #include "Engine/Renderer/Renderable.hpp"
+#include "Engine/Renderer/Mesh/Mesh.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Lights/Light.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Math/Frustum.hpp"
+#include "Engine/Math/Disc3.hpp"
+#include "Engine/Math/Ray3.hpp"
+#include <algorithm>
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
 // Gets the list of the most contributing lights 
 //
-std::vector<Light*> RenderScene::GetMostContributingLights(const Vector3& position)
+std::vector<Light*> RenderScene::GetMostContributingLights(const Vector3& position) const
 {
-	if(m_lights.size() <= MAX_LIGHTS)
-	{
-		return m_lights;
-	}
+	std::vector<Light*> lights;
+	QueryLights(position, lights);
 
-	std::vector<float> lightPowers;
-	// Calculate attenuation for each light
-	for(size_t lightIndex = 1; lightIndex < m_lights.size(); ++lightIndex)
+	if(lights.size() <= MAX_LIGHTS)
 	{
-		Vector3 lightDir = m_lights[lightIndex]->GetWorldPosition() - position;
-		Vector3& atten = m_lights[lightIndex]->m_lightDesc.attenuation;
-		float distance = lightDir.GetLength();
-		float distaceSq = distance * distance;
-		float lightPower = m_lights[lightIndex]->m_lightDesc.color.a * 1.f / ( atten.x + distance * atten.y + distaceSq * atten.z );
-		lightPowers.push_back(lightPower);
+		return lights;
 	}
 
-	// Sort the lights
-	for(size_t lightI = 0; lightI < m_lights.size(); ++ lightI)
+	// Calculate attenuation for each light and keep the strongest
+	std::vector<std::pair<float, Light*>> lightPowers;
+	lightPowers.reserve(lights.size());
+	for(Light* light : lights)
 	{
-		for(size_t lightJ = lightI + 1; lightJ < m_lights.size(); ++lightJ)
-		{
-			if(lightPowers[lightI] > lightPowers[lightJ])
-			{
-				std::swap(lightPowers[lightI], lightPowers[lightJ]);
-				std::swap(m_lights[lightI], m_lights[lightJ]);
-			}
-		}
+		lightPowers.push_back(std::make_pair(light->GetPowerAtPosition(position), light));
 	}
 
-	// Make a vector of contributing lights and return it
-	std::vector<Light*> lights;
+	std::partial_sort(lightPowers.begin(), lightPowers.begin() + MAX_LIGHTS, lightPowers.end(), 
+		[](const std::pair<float, Light*>& a, const std::pair<float, Light*>& b) { return a.first > b.first; });
+
+	lights.resize(MAX_LIGHTS);
 	for(int index = 0; index < MAX_LIGHTS; ++index)
 	{
-		lights.push_back(m_lights[index]);
+		lights[index] = lightPowers[index].second;
 	}
 	return lights;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Batched version, lights for position i are out_lights[out_offsets[i]] to out_lights[out_offsets[i+1]]
+//
+void RenderScene::GetMostContributingLights(const Vector3* positions, int count, std::vector<Light*>& out_lights, std::vector<int>& out_offsets) const
+{
+	out_lights.clear();
+	out_offsets.resize(count + 1);
+
+	for(int positionIndex = 0; positionIndex < count; ++positionIndex)
+	{
+		out_offsets[positionIndex] = (int) out_lights.size();
+
+		std::vector<Light*> lights = GetMostContributingLights(positions[positionIndex]);
+		out_lights.insert(out_lights.end(), lights.begin(), lights.end());
+	}
+
+	out_offsets[count] = (int) out_lights.size();
+}
+
 //-----------------------------------------------------------------------------------------------
 // Adds a renderable to the scene
 //
 void RenderScene::AddRenderable(Renderable* r)
 {
 	m_renderables.push_back(r);
+	m_renderableProxies.push_back(SceneProxy());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -66,6 +79,7 @@ void RenderScene::AddRenderable(Renderable* r)
 void RenderScene::AddLight(Light* light)
 {
 	m_lights.push_back(light);
+	m_lightProxies.push_back(SceneProxy());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -101,11 +115,20 @@ void RenderScene::RemoveRenderable(Renderable* r)
 	{
 		if(m_renderables[index] == r)
 		{
+			if(m_renderableProxies[index].proxyId != BVH_NULL_NODE)
+			{
+				m_renderableTree.DestroyProxy(m_renderableProxies[index].proxyId);
+			}
+
 			m_renderables[index] = m_renderables[m_renderables.size() - 1];
 			m_renderables.pop_back();
+			m_renderableProxies[index] = m_renderableProxies[m_renderableProxies.size() - 1];
+			m_renderableProxies.pop_back();
 			index--;
 		}
 	}
+
+	m_unboundedRenderables.erase(std::remove(m_unboundedRenderables.begin(), m_unboundedRenderables.end(), r), m_unboundedRenderables.end());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -117,11 +140,20 @@ void RenderScene::RemoveLight(Light* light)
 	{
 		if(m_lights[index] == light)
 		{
+			if(m_lightProxies[index].proxyId != BVH_NULL_NODE)
+			{
+				m_lightTree.DestroyProxy(m_lightProxies[index].proxyId);
+			}
+
 			m_lights[index] = m_lights[m_lights.size() - 1];
 			m_lights.pop_back();
+			m_lightProxies[index] = m_lightProxies[m_lightProxies.size() - 1];
+			m_lightProxies.pop_back();
 			index--;
 		}
 	}
+
+	m_unboundedLights.erase(std::remove(m_unboundedLights.begin(), m_unboundedLights.end(), light), m_unboundedLights.end());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -167,3 +199,200 @@ void RenderScene::RemovePreRenderIndie(PrerenderIndieCB cb)
 // 		m_indiePrerenders.pop_back();
 // 	}
 }
+
+//-----------------------------------------------------------------------------------------------
+// Refits the trees for anything that moved since the last update
+//
+void RenderScene::UpdateSpatialTree()
+{
+	m_unboundedRenderables.clear();
+	for(size_t index = 0; index < m_renderables.size(); ++index)
+	{
+		Renderable* renderable = m_renderables[index];
+		SceneProxy& proxy = m_renderableProxies[index];
+
+		uint32_t version = renderable->GetTransformVersion();
+		uint32_t meshBoundsVersion = renderable->GetMesh() ? renderable->GetMesh()->GetBoundsVersion() : 0;
+		if(proxy.isDirty || proxy.version != version || proxy.watch != renderable->GetWatchTransform()
+			|| proxy.mesh != renderable->GetMesh() || proxy.meshBoundsVersion != meshBoundsVersion)
+		{
+			AABB3 bounds = renderable->GetWorldBounds();
+			if(bounds.IsFinite())
+			{
+				if(proxy.proxyId == BVH_NULL_NODE)
+				{
+					proxy.proxyId = m_renderableTree.CreateProxy(bounds, renderable);
+				}
+				else
+				{
+					m_renderableTree.MoveProxy(proxy.proxyId, bounds);
+				}
+			}
+			else if(proxy.proxyId != BVH_NULL_NODE)
+			{
+				m_renderableTree.DestroyProxy(proxy.proxyId);
+				proxy.proxyId = BVH_NULL_NODE;
+			}
+
+			proxy.version = version;
+			proxy.mesh = renderable->GetMesh();
+			proxy.meshBoundsVersion = meshBoundsVersion;
+			proxy.watch = renderable->GetWatchTransform();
+			proxy.isDirty = false;
+		}
+
+		if(proxy.proxyId == BVH_NULL_NODE)
+		{
+			m_unboundedRenderables.push_back(renderable);
+		}
+	}
+
+	// Light radius depends on intensity and attenuation as well, so always refit (Cheap when inside the fat bounds)
+	m_unboundedLights.clear();
+	for(size_t index = 0; index < m_lights.size(); ++index)
+	{
+		Light* light = m_lights[index];
+		SceneProxy& proxy = m_lightProxies[index];
+
+		if(light->IsBounded())
+		{
+			float radius = light->GetInfluenceRadius();
+			Vector3 position = light->GetWorldPosition();
+			AABB3 bounds = AABB3(position - Vector3(radius), position + Vector3(radius));
+
+			if(proxy.proxyId == BVH_NULL_NODE)
+			{
+				proxy.proxyId = m_lightTree.CreateProxy(bounds, light);
+			}
+			else
+			{
+				m_lightTree.MoveProxy(proxy.proxyId, bounds);
+			}
+		}
+		else
+		{
+			if(proxy.proxyId != BVH_NULL_NODE)
+			{
+				m_lightTree.DestroyProxy(proxy.proxyId);
+				proxy.proxyId = BVH_NULL_NODE;
+			}
+
+			m_unboundedLights.push_back(light);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the renderables visible in the frustum
+//
+void RenderScene::QueryRenderables(const Frustum& frustum, std::vector<Renderable*>& out_renderables) const
+{
+	std::vector<void*> results;
+	m_renderableTree.QueryFrustum(frustum, results);
+
+	for(void* result : results)
+	{
+		out_renderables.push_back((Renderable*) result);
+	}
+	out_renderables.insert(out_renderables.end(), m_unboundedRenderables.begin(), m_unboundedRenderables.end());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the renderables overlapping the sphere
+//
+void RenderScene::QueryRenderables(const Disc3& sphere, std::vector<Renderable*>& out_renderables) const
+{
+	std::vector<void*> results;
+	m_renderableTree.QuerySphere(sphere, results);
+
+	for(void* result : results)
+	{
+		out_renderables.push_back((Renderable*) result);
+	}
+	out_renderables.insert(out_renderables.end(), m_unboundedRenderables.begin(), m_unboundedRenderables.end());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the renderables overlapping the aabb3
+//
+void RenderScene::QueryRenderables(const AABB3& bounds, std::vector<Renderable*>& out_renderables) const
+{
+	std::vector<void*> results;
+	m_renderableTree.QueryAABB(bounds, results);
+
+	for(void* result : results)
+	{
+		out_renderables.push_back((Renderable*) result);
+	}
+	out_renderables.insert(out_renderables.end(), m_unboundedRenderables.begin(), m_unboundedRenderables.end());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the renderables whose bounds the ray passes through (Unordered)
+//
+void RenderScene::RaycastRenderables(const Ray3& ray, float maxDistance, std::vector<Renderable*>& out_renderables) const
+{
+	std::vector<void*> results;
+	m_renderableTree.Raycast(ray, maxDistance, results);
+
+	for(void* result : results)
+	{
+		out_renderables.push_back((Renderable*) result);
+	}
+	out_renderables.insert(out_renderables.end(), m_unboundedRenderables.begin(), m_unboundedRenderables.end());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Batched sphere query, renderables for sphere i are out_renderables[out_offsets[i]] to out_renderables[out_offsets[i+1]]
+//
+void RenderScene::QueryRenderables(const Disc3* spheres, int count, std::vector<Renderable*>& out_renderables, std::vector<int>& out_offsets) const
+{
+	out_renderables.clear();
+	out_offsets.resize(count + 1);
+
+	std::vector<void*> results;
+	for(int sphereIndex = 0; sphereIndex < count; ++sphereIndex)
+	{
+		out_offsets[sphereIndex] = (int) out_renderables.size();
+
+		results.clear();
+		m_renderableTree.QuerySphere(spheres[sphereIndex], results);
+		for(void* result : results)
+		{
+			out_renderables.push_back((Renderable*) result);
+		}
+		out_renderables.insert(out_renderables.end(), m_unboundedRenderables.begin(), m_unboundedRenderables.end());
+	}
+
+	out_offsets[count] = (int) out_renderables.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the lights whose influence reaches the position
+//
+void RenderScene::QueryLights(const Vector3& position, std::vector<Light*>& out_lights) const
+{
+	std::vector<void*> results;
+	m_lightTree.QueryPoint(position, results);
+
+	for(void* result : results)
+	{
+		out_lights.push_back((Light*) result);
+	}
+	out_lights.insert(out_lights.end(), m_unboundedLights.begin(), m_unboundedLights.end());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the lights whose influence reaches into the frustum
+//
+void RenderScene::QueryLights(const Frustum& frustum, std::vector<Light*>& out_lights) const
+{
+	std::vector<void*> results;
+	m_lightTree.QueryFrustum(frustum, results);
+
+	for(void* result : results)
+	{
+		out_lights.push_back((Light*) result);
+	}
+	out_lights.insert(out_lights.end(), m_unboundedLights.begin(), m_unboundedLights.end());
+}
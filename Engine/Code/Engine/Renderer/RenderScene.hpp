@@ -1,4 +1,5 @@
 #pragma once
+#include "Engine/Math/BVH.hpp"
 #include <vector>
 #include <functional>
 
@@ -8,9 +9,26 @@ class Renderable;
 class Light;
 class Camera;
 class Vector3;
+class Frustum;
+class Disc3;
+class Ray3;
+class Mesh;
+class Transform;
 typedef std::function<void(Camera*)> PrerenderCB;
 typedef std::function<void()> PrerenderIndieCB;
 
+//-----------------------------------------------------------------------------------------------
+// Tree bookkeeping kept parallel to the renderable/light lists
+struct SceneProxy
+{
+	int					proxyId				= BVH_NULL_NODE; // Null when the object is unbounded
+	uint32_t			version				= 0;
+	const Transform*	watch				= nullptr; // Versions of different transforms can't be compared
+	const Mesh*			mesh				= nullptr;
+	uint32_t			meshBoundsVersion	= 0;
+	bool				isDirty				= true;
+};
+
 //-----------------------------------------------------------------------------------------------
 class RenderScene
 {
@@ -22,7 +40,8 @@ public:
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-	std::vector<Light*> GetMostContributingLights( const Vector3& position );
+	std::vector<Light*> GetMostContributingLights( const Vector3& position ) const;
+	void				GetMostContributingLights( const Vector3* positions, int count, std::vector<Light*>& out_lights, std::vector<int>& out_offsets ) const;
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -36,6 +55,16 @@ public:
 	void				RemoveCamera( Camera* cam );
 	void				RemovePreRender( PrerenderCB cb );
 	void				RemovePreRenderIndie( PrerenderIndieCB cb );
+
+	// Spatial queries. Unbounded objects are always part of the results
+	void				UpdateSpatialTree(); // Refits anything whose transform or mesh changed
+	void				QueryRenderables( const Frustum& frustum, std::vector<Renderable*>& out_renderables ) const;
+	void				QueryRenderables( const Disc3& sphere, std::vector<Renderable*>& out_renderables ) const;
+	void				QueryRenderables( const AABB3& bounds, std::vector<Renderable*>& out_renderables ) const;
+	void				RaycastRenderables( const Ray3& ray, float maxDistance, std::vector<Renderable*>& out_renderables ) const;
+	void				QueryRenderables( const Disc3* spheres, int count, std::vector<Renderable*>& out_renderables, std::vector<int>& out_offsets ) const;
+	void				QueryLights( const Vector3& position, std::vector<Light*>& out_lights ) const;
+	void				QueryLights( const Frustum& frustum, std::vector<Light*>& out_lights ) const;
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
@@ -44,5 +73,12 @@ public:
 	std::vector<Camera*>			m_cameras;
 	std::vector<PrerenderCB>		m_prerenders;
 	std::vector<PrerenderIndieCB>	m_indiePrerenders;
+
+	BVH								m_renderableTree;
+	BVH								m_lightTree;
+	std::vector<SceneProxy>			m_renderableProxies;	// Parallel to m_renderables
+	std::vector<SceneProxy>			m_lightProxies;			// Parallel to m_lights
+	std::vector<Renderable*>		m_unboundedRenderables;
+	std::vector<Light*>				m_unboundedLights;
 };
 
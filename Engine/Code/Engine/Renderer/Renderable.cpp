@@ -3,6 +3,7 @@
 // Engine Includes
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Math/Transform.hpp"
+#include "Engine/Renderer/Mesh/Mesh.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -68,24 +69,51 @@ const Material* Renderable::GetMaterial() const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Computes model matrix and returns it
+// Returns the watched transform's world matrix, or the matrix last set when nothing is watched
 //
 Matrix44 Renderable::GetModelMatrix() const
 {
 	if(m_watchTransform == nullptr)
 	{
-		return Matrix44::IDENTITY;
+		return m_modelMatrix;
 	}
 
 	return m_watchTransform->GetWorldMatrix();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the mesh bounds in world space
+//
+AABB3 Renderable::GetWorldBounds() const
+{
+	if(m_mesh == nullptr || !m_mesh->GetBounds().IsFinite())
+	{
+		return AABB3();
+	}
+
+	return m_mesh->GetBounds().GetTransformed(GetModelMatrix());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the version of the watched transform so the scene knows when the bounds are stale
+//
+uint32_t Renderable::GetTransformVersion() const
+{
+	if(m_watchTransform == nullptr)
+	{
+		return m_modelVersion;
+	}
+
+	return m_watchTransform->GetVersion();
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets the model matrix on the renderable
 //
 void Renderable::SetModelMatrix(const Matrix44& model)
 {
 	m_modelMatrix = model;
+	++m_modelVersion;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1,5 +1,7 @@
 #pragma once
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <stdint.h>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -25,23 +27,30 @@ public:
 	const	Material*	GetMaterial() const;
 			Matrix44	GetModelMatrix() const;
 			void		SetModelMatrix( const Matrix44& model );
+			AABB3		GetWorldBounds() const; // Infinite if the mesh has no bounds
+			uint32_t	GetTransformVersion() const;
 			void		SetMaterial( const Material& material );
 			void		SetMesh( Mesh* mesh ) { m_mesh = mesh; }
+	const	Transform*	GetWatchTransform() const { return m_watchTransform; }
 			void		SetWatchTransform( const Transform* transform ) { m_watchTransform = transform; }
 			bool		IsLit() const;
 			bool		IsOpaque() const;
+			bool		IsStatic() const { return m_isStatic; }
+			void		SetStatic( bool isStatic ) { m_isStatic = isStatic; }
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
-			Mesh*		m_mesh;
+			Mesh*		m_mesh = nullptr;
 			int			m_sortOrder = 0;
-	const	Material*	m_material;
+			bool		m_isStatic = false; // Static casters are cached in the shadow atlas
+			uint32_t	m_modelVersion = 0; // Bumped by SetModelMatrix when nothing is watched
+	const	Material*	m_material = nullptr;
 			Material*	m_materialInstance = nullptr;
 			Matrix44	m_modelMatrix;
-	const	Transform*	m_watchTransform;
+	const	Transform*	m_watchTransform = nullptr; // Overrides m_modelMatrix when set
 };
 
 
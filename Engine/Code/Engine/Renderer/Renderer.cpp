@@ -16,6 +16,7 @@
 #include <vector>
 #include "Engine/Core/StringTokenizer.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
 #include "Engine/Renderer/RenderBuffer.hpp"
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/Sampler.hpp"
@@ -36,18 +37,26 @@
 #include "Engine/Renderer/DebugRenderer.hpp"
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/Buffers/UniformBuffer.hpp"
+#include "Engine/Renderer/Buffers/StorageBuffer.hpp"
+#include "Engine/Renderer/Buffers/StreamingBuffer.hpp"
 #include "Engine/Renderer/GIFAnimation.hpp"
 #include "Engine/Renderer/Material.hpp"
-#include "Engine/Renderer/MaterialProperties/MaterialProperty.hpp"
+#include "Engine/Renderer/MaterialProperties/MaterialPropertyBlock.hpp"
 #include "Engine/Renderer/Lights/Light.hpp"
 #include "Engine/Renderer/Mesh/MeshUtils.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 #include "Engine/Renderer/TextureCube.hpp"
+#include "Engine/Renderer/TextureArray.hpp"
+#include "Engine/Renderer/SDFFontAtlas.hpp"
 #include "Engine/Core/Clock.hpp"
-//#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Rendering constants
 const int defaultIndices[] = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20};
+constexpr size_t IMMEDIATE_VERTEX_BYTES_PER_FRAME = 4 * 1024 * 1024;	// ~170k Vertex_3DPCU
+constexpr size_t IMMEDIATE_INDEX_BYTES_PER_FRAME = 1024 * 1024;
 
 //-----------------------------------------------------------------------------------------------
 // Context globals
@@ -65,15 +74,45 @@ Renderer::Renderer()
 	g_displayDeviceContext = ::GetDC((HWND) Window::GetInstance()->GetHandle());
 }
 
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+Renderer::~Renderer()
+{
+	delete m_immediateIndices;
+	m_immediateIndices = nullptr;
+
+	delete m_immediateVertices;
+	m_immediateVertices = nullptr;
+
+	// Frees the GIF atlases once the instances handed out are gone too
+	for(std::map<std::string,GIFAnimation*>::iterator gifIter = m_loadedGIFs.begin(); gifIter != m_loadedGIFs.end(); ++gifIter)
+	{
+		delete gifIter->second;
+	}
+	m_loadedGIFs.clear();
+
+	GLStateCache::DestroyInstance();
+}
+
 
 //-----------------------------------------------------------------------------------------------
 // Start of the frame 
 //
 void Renderer::BeginFrame()
 {
+	PROFILE_SCOPE_FUNCTION();
+	m_immediateVertices->BeginFrame();
+	m_immediateIndices->BeginFrame();
+	m_textureAtlas.UpdateMips();
+
 	ResetDefaultMaterial();
 	SetDefaultMaterial();
 	SetTexture(m_defaultTexture);
+
+	UpdateFrameBlock();
+	BindUBO(BLOCK_TIME, m_frameBuffer);
+	BindUBO(BLOCK_CAMERA, m_cameraBuffer);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -81,12 +120,18 @@ void Renderer::BeginFrame()
 //
 void Renderer::EndFrame()
 {
+	PROFILE_SCOPE_FUNCTION();
 	// copies the default camera's framebuffer to the "null" framebuffer, 
 	// also known as the back buffer.
 	CopyFrameBuffer( nullptr, m_defaultCamera->m_frameBuffer ); 
 
 	SwapBuffers(::GetDC((HWND) Window::GetInstance()->GetHandle()));
 	ClearScreen(Rgba::BLACK);
+
+	m_immediateVertices->EndFrame();
+	m_immediateIndices->EndFrame();
+	GLStateCache::GetInstance()->EndFrame();
+	m_textLayouts.EndFrame();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -94,9 +139,12 @@ void Renderer::EndFrame()
 //
 void Renderer::PostStartup()
 {
+	// Every bind below goes through the state cache
+	GLStateCache* glState = GLStateCache::CreateInstance();
+
 	// default_vao is a GLuint member variable
 	glGenVertexArrays( 1, &m_defaultVAO ); 
-	glBindVertexArray( m_defaultVAO ); 
+	glState->BindVertexArray( m_defaultVAO ); 
 
 	// Init built-in shaders (inline)
 	ShaderProgram::InitializeBuiltInShaders();
@@ -127,6 +175,10 @@ void Renderer::PostStartup()
 	// Generating engine meshes 
 	InitializeDefaultMeshes();
 
+	// Immediate mode arenas
+	m_immediateVertices = new StreamingBuffer(IMMEDIATE_VERTEX_BYTES_PER_FRAME);
+	m_immediateIndices = new StreamingBuffer(IMMEDIATE_INDEX_BYTES_PER_FRAME);
+
 	// Default shader setup
 	m_defaultShader = new Shader(g_defDiffuseProgram);
 
@@ -143,9 +195,9 @@ void Renderer::PostStartup()
 	m_copySrc = new FrameBuffer();
 	m_copyDestination = new FrameBuffer();
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
-	glEnable(GL_CULL_FACE);
+	glState->SetEnabled(GL_DEPTH_TEST, true);
+	glState->SetEnabled(GL_BLEND, true);
+	glState->SetEnabled(GL_CULL_FACE, true);
 
 	m_lightBlock = new LightBlock();
 	m_lightBuffer = new UniformBuffer();
@@ -153,11 +205,16 @@ void Renderer::PostStartup()
 	m_specularBlock = new SpecularBlock();
 	m_specularBuffer = new UniformBuffer();
 
-	m_cameraBuffer = UniformBuffer::For( CameraBlock() );
+	m_cameraBuffer = UniformBuffer::For( m_cameraBlock );
+	m_frameBuffer = UniformBuffer::For( m_frameBlock );
+	m_modelUniform = GetUniformID("MODEL");
 	
-	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+	glState->SetEnabled(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
 
 	COMMAND("screenshot", ScreenshotCommand, "Takes a screenshot of the current frame");
+	COMMAND("immediate_bench", ImmediateBenchCommand, "Times immediate quads with and without the streaming arena, [quads]");
+	COMMAND("gl_state_stats", GLStateCache::StatsCommand, "Prints the GL state calls issued and filtered last frame");
+	COMMAND("gl_state_validate", GLStateCache::ValidateCommand, "Checks the GL state cache against glGet before every draw, [true|false]");
 
 	FogBlock fogParams = {};
 	fogParams.FOG_COLOR = Rgba::WHITE.GetAsVector();
@@ -232,6 +289,54 @@ bool Renderer::ScreenshotCommand(Command& cmd)
 	return false;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Command callback timing immediate quads through the streaming arena and through a mesh per draw
+//
+bool Renderer::ImmediateBenchCommand(Command& cmd)
+{
+	int quadCount = 10000;
+	cmd.GetNextInt(quadCount);
+	quadCount = Max(quadCount, 1);
+
+	double streamedMs = g_TheRenderer->TimeImmediateQuads(quadCount, true);
+	int overflowCount = g_TheRenderer->m_immediateVertices->GetOverflowCount();
+	double meshMs = g_TheRenderer->TimeImmediateQuads(quadCount, false);
+
+	ConsolePrintf("%d immediate quads: %.3f ms streamed (%s), %.3f ms with a mesh per draw", quadCount, streamedMs,
+		g_TheRenderer->m_immediateVertices->IsPersistent() ? "persistent" : "mapped ranges", meshMs);
+	if(overflowCount > 0)
+	{
+		ConsolePrintf(Rgba::YELLOW, "%d draws did not fit the arena and used a mesh", overflowCount);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws quadCount small quads on the default camera and returns the milliseconds until the GPU
+// finished them
+//
+double Renderer::TimeImmediateQuads(int quadCount, bool isStreamed)
+{
+	bool wasStreamed = m_isImmediateStreamed;
+	m_isImmediateStreamed = isStreamed;
+	SetCamera(nullptr);
+
+	glFinish();
+	uint64_t startHpc = Time::GetPerformanceCounter();
+	for(int quadIndex = 0; quadIndex < quadCount; ++quadIndex)
+	{
+		float x = (float) (quadIndex % 100);
+		float y = (float) ((quadIndex / 100) % 100);
+		DrawAABB2(AABB2(x, y, x + 1.f, y + 1.f), Rgba::WHITE);
+	}
+	glFinish();
+	uint64_t endHpc = Time::GetPerformanceCounter();
+
+	m_isImmediateStreamed = wasStreamed;
+	return Time::HpcToSeconds(endHpc - startHpc) * 1000.0;
+}
+
 //-----------------------------------------------------------------------------------------------
 // OpenGL Ortho matrix as the current projection matrix 
 //
@@ -302,13 +407,29 @@ void Renderer::ClearScreen(const Rgba& clearColor)
 //
 void Renderer::ClearDepth(float depth /*= 1.f */)
 {
-	glDepthMask(GL_TRUE);
+	GLStateCache::GetInstance()->DepthMask(true);
 	glClearDepthf( depth );
 	GL_CHECK_ERROR();
 	glClear( GL_DEPTH_BUFFER_BIT ); 
 	GL_CHECK_ERROR();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Clears the depth buffer only inside the pixel region of the bound framebuffer
+//
+void Renderer::ClearDepthRegion(const AABB2& pixelRegion, float depth /*= 1.f */)
+{
+	IntVector2 mins = IntVector2(pixelRegion.mins);
+	IntVector2 size = IntVector2(pixelRegion.maxs - pixelRegion.mins);
+
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->SetEnabled(GL_SCISSOR_TEST, true);
+	glScissor(mins.x, mins.y, size.x, size.y);
+	ClearDepth(depth);
+	glState->SetEnabled(GL_SCISSOR_TEST, false);
+	GL_CHECK_ERROR();
+}
+
 //-----------------------------------------------------------------------------------------------
 // OpenGL Enable Blend
 //
@@ -322,7 +443,7 @@ void Renderer::EnableBlend() const
 //
 void Renderer::EnableLineSmooth() const
 {
-	glEnable(GL_LINE_SMOOTH);
+	GLStateCache::GetInstance()->SetEnabled(GL_LINE_SMOOTH, true);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -510,122 +631,31 @@ void Renderer::DrawTexturedAABB2(const AABB2& bounds, const Texture& texture, co
 	DrawMeshImmediate(vertices, 6, PRIMITIVE_TRIANGLES);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Draws a quad with the image in an atlas region
+//
+void Renderer::DrawTexturedAABB2(const AABB2& bounds, const TextureAtlasRegion& region, const Rgba& tint)
+{
+	DrawTexturedAABB2(bounds, *region.m_texture, region.m_uvs.mins, region.m_uvs.maxs, tint);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Draws the text on the screen
 //
 void Renderer::DrawText2D(const Vector2& drawMins, const std::string& asciiText, float cellHeight, const BitmapFont* font, const Rgba& tint, float aspectScale)
 {
-	SetTexture((Texture*) &font->m_spriteSheet.GetSpriteSheetTexture());
-	float cellWidth = cellHeight * (font->m_baseAspect * aspectScale);
-	Vector2 drawMaxs = drawMins + Vector2(cellWidth, cellHeight);
-	float cursorMins;
-	float cursorMaxs;
-	float lineMins = drawMins.y;
-	float lineMaxs = drawMaxs.y;
-	std::vector<Vertex_3DPCU> verticesToRender;
-	
-	for (size_t index = 0; index < asciiText.size(); ++index)
-	{
-		cursorMins = ((float)index * cellWidth) + drawMins.x;
-		cursorMaxs = ((float)(index + 1) * cellWidth) + drawMins.x;
-		AABB2 uv = font->GetUVsForGlyph(asciiText[index]); // Returns the uv coords for the unicode 
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, lineMins), tint, Vector2(uv.mins.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, lineMins), tint, Vector2(uv.maxs.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, lineMaxs), tint, Vector2(uv.mins.x, uv.mins.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, lineMaxs), tint, Vector2(uv.mins.x, uv.mins.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, lineMins), tint, Vector2(uv.maxs.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, lineMaxs), tint, Vector2(uv.maxs.x, uv.mins.y)));
-	}
-
-	DrawMeshImmediate(verticesToRender.data(), (int)verticesToRender.size(), PRIMITIVE_TRIANGLES);
+	const TextLayout& layout = m_textLayouts.CreateOrGetLine(asciiText, font, cellHeight, aspectScale);
+	DrawTextLayout(layout, drawMins, font, tint);
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws text in box with given alignment and wrap mode
+// Draws text in box with given alignment and wrap mode. The wrapped layout is reused while the
+// text and box size stay the same
 //
 void Renderer::DrawTextInBox2D(const AABB2& textBoxBounds, const std::string& asciiText, float cellHeight, const Vector2& textAligment, WrapMode wrapMode, const BitmapFont* font, const Rgba& tint /*= Rgba::WHITE*/, float aspectScale /*= 1.f */)
 {
-	// Split the string into lines based on \n
-	StringTokenizer tokenizer(asciiText, "\n");
-	tokenizer.Tokenize();
-	Strings tokens = tokenizer.GetTokens();
-	size_t lineIndex = 0;
-
-	float textWidth;
-	float paddingX;
-	float textHeight = font->GetStringHeight(asciiText, cellHeight, aspectScale);
-	float paddingY;
-	Vector2 drawMins ;
-		
-	if(wrapMode == WrapMode::OVERRUN)
-	{
-		paddingY = (textBoxBounds.maxs.y - textBoxBounds.mins.y - (textHeight / (float)tokens.size())) * textAligment.y;
-		for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
-		{
-			textWidth = font->GetStringWidth(*iter, cellHeight, aspectScale);
-			paddingX = (textBoxBounds.maxs.x - textBoxBounds.mins.x - textWidth) * textAligment.x;
-			drawMins = textBoxBounds.mins + Vector2(paddingX, paddingY);
-			drawMins.y += (float) lineIndex * cellHeight;
-			DrawText2D(drawMins, *iter, cellHeight, font, tint, aspectScale);
-			lineIndex++;
-		}
-	}
-
-	else if(wrapMode == WrapMode::SHRINK_TO_FIT)
-	{
-		float scaleX;
-		float scaleY = cellHeight;
-		float boxWidth = (textBoxBounds.maxs.x - textBoxBounds.mins.x) * 0.5f;
-		float boxHeight = (textBoxBounds.maxs.y - textBoxBounds.mins.y) * 0.5f;
-		textWidth = font->GetStringWidth(asciiText, cellHeight, aspectScale);
-		if(textWidth >= boxWidth && textHeight <= boxHeight)
-		{
-			scaleX = boxWidth / textWidth;
-			scaleY = scaleX / aspectScale;
-		}
-		
-		else if(textHeight >= boxHeight && textWidth <= boxWidth)
-		{
-			scaleY = boxHeight / textHeight;
-		}
-
-		else if(textWidth >= boxWidth && textHeight >= boxHeight)
-		{
-			scaleX = 1.f;
-			for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
-			{
-				textWidth = font->GetStringWidth(*iter, cellHeight, aspectScale);
-				if(textWidth > boxWidth)
-				{
-					float scale = boxWidth / textWidth;
-					if(scale < scaleX)
-						scaleX = scale; // Choose the highest scale along width from each line
-				}
-			}
-			scaleY = boxHeight / textHeight;
-			if(scaleX < scaleY) // Choose the one that scales down the most
-			{
-				scaleY = scaleX;
-			}
-		}
-
-		paddingY = (textBoxBounds.maxs.y - textBoxBounds.mins.y - (scaleY * (float)tokens.size())) * textAligment.y;
-		for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
-		{
-			textWidth = font->GetStringWidth(*iter, scaleY, aspectScale);
-			textHeight = font->GetStringHeight(*iter, scaleY, aspectScale);
-			paddingX = (textBoxBounds.maxs.x - textBoxBounds.mins.x - textWidth) * textAligment.x;
-			drawMins = textBoxBounds.mins + Vector2(paddingX, paddingY);
-			drawMins.y += (float) lineIndex * textHeight;
-			DrawText2D(drawMins, *iter, scaleY, font, tint, aspectScale);
-			lineIndex++;
-		}
-	}
-
-	else if(wrapMode == WrapMode::WORD_WRAP)
-	{
-
-	}
+	const TextLayout& layout = m_textLayouts.CreateOrGetBox(asciiText, font, cellHeight, aspectScale, textBoxBounds.GetDimensions(), textAligment, wrapMode);
+	DrawTextLayout(layout, textBoxBounds.mins, font, tint);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -633,33 +663,37 @@ void Renderer::DrawTextInBox2D(const AABB2& textBoxBounds, const std::string& as
 //
 void Renderer::DrawText3D(const std::string& text, const Matrix44& modelTransform, const BitmapFont* font, const Rgba& tint)
 {
-	/*Vector2 drawMins(0.f, 1.f);*/ // Always (0,1)
-	SetTexture((Texture*) &font->m_spriteSheet.GetSpriteSheetTexture());
-	float cursorMins = 0.f;
-	float cursorMaxs;
-	// Compute offset for text to be centered
-	float offsetX = font->GetStringWidth(text, 1.f , 1.f);
-	cursorMins = -offsetX * 0.5f;
+	// Same placement as always, shifted left by the string width
+	const TextLayout& layout = m_textLayouts.CreateOrGetLine(text, font, 1.f, 1.f);
+	Vector2 offset(-font->GetStringWidth(text, 1.f, 1.f), 0.f);
 
-	// Compute the vertices for each character
-	std::vector<Vertex_3DPCU> verticesToRender;
-	float cellWidth;
-	for (size_t index = 0; index < text.size(); ++index)
+	m_text3DScratch.Clear();
+	m_text3DScratch.m_texture = font->GetSpriteSheetTexture();
+	m_text3DScratch.m_isSDF = font->IsSDF();
+	m_text3DScratch.Append(layout, offset, tint);
+	if(!m_text3DScratch.IsEmpty())
 	{
-		cellWidth = font->GetGlyphAspect(text[index]);
-
-		cursorMins = ((float)index * cellWidth) - offsetX;
-		cursorMaxs =  cursorMins + cellWidth;
-		AABB2 uv = font->GetUVsForGlyph(text[index]); // Returns the uv coords for the unicode 
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, 0), tint, Vector2(uv.mins.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, 0), tint, Vector2(uv.maxs.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, 1), tint, Vector2(uv.mins.x, uv.mins.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMins, 1), tint, Vector2(uv.mins.x, uv.mins.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, 0), tint, Vector2(uv.maxs.x, uv.maxs.y)));
-		verticesToRender.push_back(Vertex_3DPCU(Vector3(cursorMaxs, 1), tint, Vector2(uv.maxs.x, uv.mins.y)));
+		DrawTextBatch(m_text3DScratch, modelTransform);
 	}
+}
 
-	DrawMeshImmediate(verticesToRender.data(), (int) verticesToRender.size(), PRIMITIVE_TRIANGLES, modelTransform);
+//-----------------------------------------------------------------------------------------------
+// Starts collecting 2D text into per glyph sheet batches
+//
+void Renderer::BeginTextBatch()
+{
+	GUARANTEE_OR_DIE(!m_isBatchingText, "Text batches can't be nested");
+	m_isBatchingText = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws the text collected since BeginTextBatch
+//
+void Renderer::EndTextBatch()
+{
+	GUARANTEE_OR_DIE(m_isBatchingText, "EndTextBatch without a BeginTextBatch");
+	m_isBatchingText = false;
+	FlushTextBatches();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -727,35 +761,82 @@ void Renderer::DrawCube(const Vector3& center, const Vector3& dimensions, const
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws a sprite on the screen
+// Draws a sprite on the screen. Goes through the sprite batch, so inside Begin/EndSpriteBatch
+// it's drawn with the rest of the sprites of its texture
 //
-void Renderer::DrawSprite(const Sprite& sprite, const Matrix44& transform)
+void Renderer::DrawSprite(const Sprite& sprite, const Matrix44& transform, int layer /*= 0*/, const Rgba& tint /*= Rgba::WHITE*/)
 {
-	AABB2 uvs = sprite.GetUV();
-	Vector2 pivot= sprite.GetPivot();
-	AABB2 bounds = sprite.GetBounds();
-	
-	float left = bounds.mins.x;
-	float right = bounds.maxs.x;
-	float bottom = bounds.mins.y;
-	float top = bounds.maxs.y;
+	DrawSprite(*sprite.GetTexture(), sprite.GetBounds(), sprite.GetUV(), transform, layer, tint);
+}
 
-	Vector3 p0(left, bottom); 
-	Vector3 p1(right, bottom);
-	Vector3 p2(right, top); 
-	Vector3 p3(left,top);
+//-----------------------------------------------------------------------------------------------
+// Draws a textured quad with local bounds, for sprite animations and anything else that only has
+// a texture and uvs
+//
+void Renderer::DrawSprite(const Texture& texture, const AABB2& bounds, const AABB2& uvs, const Matrix44& transform, int layer /*= 0*/, const Rgba& tint /*= Rgba::WHITE*/)
+{
+	m_spriteBatch.Submit(&texture, bounds, uvs, transform, layer, tint);
+	if(!m_isBatchingSprites)
+	{
+		FlushSpriteBatch();
+	}
+}
 
-	Vertex_3DPCU vertices[] = {
-		Vertex_3DPCU(p0, Rgba::WHITE, Vector2(uvs.mins.x, uvs.maxs.y)),
-		Vertex_3DPCU(p1, Rgba::WHITE, uvs.maxs),
-		Vertex_3DPCU(p2, Rgba::WHITE, Vector2(uvs.maxs.x, uvs.mins.y)),
-		Vertex_3DPCU(p3, Rgba::WHITE, uvs.mins)
-	};
+//-----------------------------------------------------------------------------------------------
+// Starts collecting sprites, they are sorted and drawn by EndSpriteBatch
+//
+void Renderer::BeginSpriteBatch()
+{
+	GUARANTEE_OR_DIE(!m_isBatchingSprites, "Sprite batches can't be nested");
+	m_isBatchingSprites = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws the sprites collected since BeginSpriteBatch with the current shader and camera
+//
+void Renderer::EndSpriteBatch()
+{
+	GUARANTEE_OR_DIE(m_isBatchingSprites, "EndSpriteBatch without a BeginSpriteBatch");
+	m_isBatchingSprites = false;
+	FlushSpriteBatch();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Streams every sprite in the batch once and draws one range of it per texture run
+//
+void Renderer::FlushSpriteBatch()
+{
+	PROFILE_SCOPE_FUNCTION();
+	if(m_spriteBatch.IsEmpty())
+	{
+		return;
+	}
+
+	m_spriteBatch.Build();
+	const std::vector<Vertex_3DPCU>& vertices = m_spriteBatch.GetVertices();
+	const std::vector<uint>& indices = m_spriteBatch.GetIndices();
 
-	unsigned int indices[] = { 0, 1, 3, 3, 1, 2 };
+	DrawInstruction drawInstruction;
+	bool isStreamed = m_isImmediateStreamed && WriteStreamed(vertices.data(), (int) vertices.size(), indices.data(), (int) indices.size(), PRIMITIVE_TRIANGLES, drawInstruction);
+	size_t batchStart = drawInstruction.m_startIndex;
 
-	SetTexture((Texture*) sprite.GetTexture());
-	DrawMeshImmediateWithIndices(vertices, 4, indices, 6, PRIMITIVE_TRIANGLES, transform);
+	for(const SpriteRun& run : m_spriteBatch.GetRuns())
+	{
+		SetTexture((Texture*) run.m_texture);
+		if(isStreamed)
+		{
+			drawInstruction.m_startIndex = batchStart + (run.m_firstIndex * sizeof(uint)); // In bytes for glDrawElements
+			drawInstruction.m_elementCount = run.m_indexCount;
+			DrawBuffers(m_immediateVertexArrays, m_immediateVertices->GetHandle(), m_immediateIndices->GetHandle(), Vertex_3DPCU::s_layout, drawInstruction, Matrix44::IDENTITY);
+		}
+		else
+		{
+			// Arenas full or streaming off, the runs go out one at a time
+			DrawMeshImmediateWithIndices(vertices.data(), (int) vertices.size(), &indices[run.m_firstIndex], (int) run.m_indexCount, PRIMITIVE_TRIANGLES);
+		}
+	}
+
+	m_spriteBatch.Clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -763,7 +844,14 @@ void Renderer::DrawSprite(const Sprite& sprite, const Matrix44& transform)
 //
 void Renderer::DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, DrawPrimitiveType mode, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */) 
 {
-	// Create the mesh container and set the vertices
+	PROFILE_SCOPE_FUNCTION();
+	if(m_isImmediateStreamed && DrawStreamed(vertices, numVerts, nullptr, 0, mode, modelMatrix))
+	{
+		return;
+	}
+
+	// Arena full or streaming disabled, fall back to a throwaway mesh
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MESH);
 	Mesh immediateMesh;
 	immediateMesh.SetVertices(numVerts, vertices, Vertex_3DPCU::s_layout);
 
@@ -779,7 +867,14 @@ void Renderer::DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, Dra
 //
 void Renderer::DrawMeshImmediateWithIndices(const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, const Matrix44& modelMatrix /*= Matrix()*/)
 {
-	// Create a mesh object to store the vertices and indices
+	PROFILE_SCOPE_FUNCTION();
+	if(m_isImmediateStreamed && DrawStreamed(vertices, numVerts, indices, numIndices, mode, modelMatrix))
+	{
+		return;
+	}
+
+	// Arena full or streaming disabled, fall back to a throwaway mesh
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MESH);
 	Mesh immediateMesh;
 	immediateMesh.SetVertices(numVerts, vertices, Vertex_3DPCU::s_layout);
 	immediateMesh.SetIndices(numIndices, indices);
@@ -792,37 +887,121 @@ void Renderer::DrawMeshImmediateWithIndices(const Vertex_3DPCU* vertices, int nu
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws a mesh with the model matrix
+// Appends the vertices and indices to this frame's arenas and draws them from there. Returns
+// false without drawing when the arenas are full
 //
-void Renderer::DrawMesh(Mesh* mesh, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */)
+bool Renderer::DrawStreamed(const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, const Matrix44& modelMatrix)
 {
-	GLenum drawMode = GetGLPrimitive(mesh->m_drawInstruction.m_drawType); // Get the actual GL primitive
-	
-	// Bind uniforms
-	// Binds projection matrix on the shader 
-	m_activeMaterial->SetProperty("PROJECTION", m_currentCamera->m_projMatrix);
+	DrawInstruction drawInstruction;
+	if(!WriteStreamed(vertices, numVerts, indices, numIndices, mode, drawInstruction))
+	{
+		return false;
+	}
 
-	// Binds view matrix on the shader
-	m_activeMaterial->SetProperty("VIEW", m_currentCamera->m_viewMatrix);
+	DrawBuffers(m_immediateVertexArrays, m_immediateVertices->GetHandle(), m_immediateIndices->GetHandle(), Vertex_3DPCU::s_layout, drawInstruction, modelMatrix);
+	return true;
+}
 
-	// Binds model matrix on the shader
-	m_activeMaterial->SetProperty("MODEL", modelMatrix);
+//-----------------------------------------------------------------------------------------------
+// Copies the vertices and indices into this frame's arenas and fills the instruction that draws
+// all of them. Indices are rebased while copying so they stay relative to the vertices' own
+// start. Returns false when the arenas are full
+//
+bool Renderer::WriteStreamed(const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, DrawInstruction& out_drawInstruction)
+{
+	const VertexLayout& layout = Vertex_3DPCU::s_layout;
+	size_t vertexBytes = numVerts * layout.m_stride;
+	size_t vertexOffset = 0;
+	void* vertexData = m_immediateVertices->Allocate(vertexBytes, layout.m_stride, &vertexOffset);
+	if(vertexData == nullptr)
+	{
+		return false;
+	}
+
+	memcpy(vertexData, vertices, vertexBytes);
+	m_immediateVertices->FinishWrite();
+	uint baseVertex = (uint) (vertexOffset / layout.m_stride);
 
-	// Binds the eye position uniform
-	m_activeMaterial->SetProperty("EYE_POSITION", m_currentCamera->m_transform.GetWorldPosition());
+	DrawInstruction& drawInstruction = out_drawInstruction;
+	drawInstruction.m_drawType = mode;
+	drawInstruction.m_useIndices = (numIndices > 0);
 
-	// Binds the render mode uniform
-	m_activeMaterial->SetProperty("RENDER_MODE", m_renderMode);
+	if(drawInstruction.m_useIndices)
+	{
+		size_t indexOffset = 0;
+		uint* indexData = (uint*) m_immediateIndices->Allocate(numIndices * sizeof(uint), sizeof(uint), &indexOffset);
+		if(indexData == nullptr)
+		{
+			return false;
+		}
 
-	// Bind the game time uniform
-	m_activeMaterial->SetProperty("GAME_TIME", (float) Clock::GetMasterClock()->GetTime());
+		for(int index = 0; index < numIndices; ++index)
+		{
+			indexData[index] = indices[index] + baseVertex;
+		}
+		m_immediateIndices->FinishWrite();
+
+		drawInstruction.m_startIndex = indexOffset; // In bytes for glDrawElements
+		drawInstruction.m_elementCount = (uint) numIndices;
+	}
+	else
+	{
+		drawInstruction.m_startIndex = baseVertex;
+		drawInstruction.m_elementCount = (uint) numVerts;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws a mesh with the model matrix
+//
+void Renderer::DrawMesh(Mesh* mesh, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */)
+{
+	PROFILE_SCOPE_FUNCTION();
+	DrawBuffers(mesh->m_vertexArrays, mesh->m_vbo->GetHandle(), mesh->m_ibo->GetHandle(), *mesh->GetLayout(), mesh->m_drawInstruction, modelMatrix);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws several instances of a mesh in one call. The shader reads its per instance data from
+// whatever the caller bound, the model matrix applies to all of them
+//
+void Renderer::DrawMeshInstanced(Mesh* mesh, int instanceCount, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */)
+{
+	PROFILE_SCOPE_FUNCTION();
+	if(instanceCount <= 0)
+	{
+		return;
+	}
+
+	DrawBuffers(mesh->m_vertexArrays, mesh->m_vbo->GetHandle(), mesh->m_ibo->GetHandle(), *mesh->GetLayout(), mesh->m_drawInstruction, modelMatrix, instanceCount);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws from a vertex and index buffer pair with the active material. Meshes and the immediate
+// mode arenas both end up here
+//
+void Renderer::DrawBuffers(VertexArrayCache& vertexArrays, unsigned int vboHandle, unsigned int iboHandle, const VertexLayout& layout, const DrawInstruction& drawInstruction, const Matrix44& modelMatrix, int instanceCount)
+{
+	GLenum drawMode = GetGLPrimitive(drawInstruction.m_drawType); // Get the actual GL primitive
+	
+	// Camera, eye position, time and render mode come from the blocks
+	UpdateCameraBlock();
 
 	// Binds the active material
 	BindMaterial(m_activeMaterial);
 
-	// Bind the mesh to the currently bound shader program
-	GLuint programHandle = m_activeMaterial->GetShader()->GetProgram()->GetHandle();
-	BindMeshToProgram(programHandle, mesh);
+	// The model matrix is the only per draw uniform
+	const ShaderProgram* program = m_activeMaterial->GetShader()->GetProgram();
+	int modelLocation = program->GetUniformLocation(m_modelUniform);
+	if(modelLocation >= 0)
+	{
+		glUniformMatrix4fv(modelLocation, 1, GL_FALSE, modelMatrix.data);
+	}
+
+	// Attribute setup lives in a vertex array built once per set of program inputs
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindVertexArray(vertexArrays.GetOrCreate(*program, vboHandle, iboHandle, layout));
 
 	// Binds the light buffer
 	m_lightBuffer->Set<LightBlock>(*m_lightBlock);
@@ -834,15 +1013,31 @@ void Renderer::DrawMesh(Mesh* mesh, const Matrix44& modelMatrix /*= Matrix44::ID
 	m_specularBuffer->UpdateGPU();
 	BindUBO(BLOCK_SPECULAR, m_specularBuffer);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, m_currentCamera->GetFrameBufferHandle());
+	glState->BindFramebuffer(GL_FRAMEBUFFER, m_currentCamera->GetFrameBufferHandle());
 
-	if(mesh->m_drawInstruction.m_useIndices)
+	if(glState->IsValidating())
 	{
-		glDrawElements(drawMode, mesh->m_drawInstruction.m_elementCount, GL_UNSIGNED_INT, (GLvoid*) mesh->m_drawInstruction.m_startIndex);
+		glState->Validate();
+	}
+
+	if(instanceCount > 1)
+	{
+		if(drawInstruction.m_useIndices)
+		{
+			glDrawElementsInstanced(drawMode, drawInstruction.m_elementCount, GL_UNSIGNED_INT, (GLvoid*) drawInstruction.m_startIndex, instanceCount);
+		}
+		else
+		{
+			glDrawArraysInstanced(drawMode, (int) drawInstruction.m_startIndex, drawInstruction.m_elementCount, instanceCount);
+		}
+	}
+	else if(drawInstruction.m_useIndices)
+	{
+		glDrawElements(drawMode, drawInstruction.m_elementCount, GL_UNSIGNED_INT, (GLvoid*) drawInstruction.m_startIndex);
 	}
 	else
 	{
-		glDrawArrays(drawMode, (int) mesh->m_drawInstruction.m_startIndex, mesh->m_drawInstruction.m_elementCount);
+		glDrawArrays(drawMode, (int) drawInstruction.m_startIndex, drawInstruction.m_elementCount);
 	}
 }
 
@@ -851,6 +1046,7 @@ void Renderer::DrawMesh(Mesh* mesh, const Matrix44& modelMatrix /*= Matrix44::ID
 //
 Mesh* Renderer::CreateOrGetMesh(const std::string& path)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MESH);
 	if(m_loadedMeshes.find(path) != m_loadedMeshes.end())
 	{
 		return m_loadedMeshes.at(path);
@@ -905,6 +1101,7 @@ void Renderer::SetTexture(unsigned int index, Texture* texture, Sampler* sampler
 //
 Texture* Renderer::CreateOrGetTexture(const std::string& path, bool genMipmaps)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
 	if(m_loadedTextures.find(path) != m_loadedTextures.end())
 	{
 		return m_loadedTextures.at(path);
@@ -922,6 +1119,7 @@ Texture* Renderer::CreateOrGetTexture(const std::string& path, bool genMipmaps)
 //
 Texture* Renderer::CreateOrGetTexture(const Image& image, bool genMipmaps)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
 	if(m_loadedTextures.find(image.GetPath()) != m_loadedTextures.end())
 	{
 		return m_loadedTextures.at(image.GetPath());
@@ -934,6 +1132,31 @@ Texture* Renderer::CreateOrGetTexture(const Image& image, bool genMipmaps)
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns where the image is in the texture atlas. Images too big to pack are loaded as usual and
+// get a region covering the whole texture, so callers always draw through the region's uvs
+//
+const TextureAtlasRegion* Renderer::CreateOrGetTextureRegion(const std::string& path)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
+	const TextureAtlasRegion* region = m_textureAtlas.FindRegion(path);
+	if(region)
+	{
+		return region;
+	}
+
+	Image image(path);
+	if(m_textureAtlas.CanPack(image.GetDimensions()))
+	{
+		unsigned char* texels = image.GetTexelsAsByteArray();
+		region = m_textureAtlas.AddRegion(path, texels, image.GetDimensions());
+		free(texels);
+		return region;
+	}
+
+	return m_textureAtlas.AddWholeTexture(path, CreateOrGetTexture(image));
+}
+
 //-----------------------------------------------------------------------------------------------
 // Checks if texture is already loaded
 //
@@ -971,12 +1194,9 @@ void Renderer::BindTexture2D(unsigned int index, const Texture* texture)
 		texture = m_defaultTexture;
 	}
 
-	// Bind the sampler;
-	glBindSampler( index, texture->GetSamplerHandle() ); 
-
-	// Bind the texture
-	glActiveTexture( GL_TEXTURE0 + index ); 
-	glBindTexture( GL_TEXTURE_2D, texture->m_textureID ); 
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindSampler( index, texture->GetSamplerHandle() ); 
+	glState->BindTexture( index, GL_TEXTURE_2D, texture->m_textureID ); 
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1222,12 +1442,19 @@ TextureCube* Renderer::CreateOrGetCubeMap(const std::string& path)
 //
 void Renderer::BindCubemap(const TextureCube* cubemap)
 {
-	// Bind the sampler;
-	glBindSampler( TEXTURE_SLOT_SKYBOX, Sampler::GetLinearSampler()->GetHandle() ); 
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindSampler( TEXTURE_SLOT_SKYBOX, Sampler::GetLinearSampler()->GetHandle() ); 
+	glState->BindTexture( TEXTURE_SLOT_SKYBOX, GL_TEXTURE_CUBE_MAP, cubemap->m_handle ); 
+}
 
-	// Bind the texture
-	glActiveTexture( GL_TEXTURE0 + TEXTURE_SLOT_SKYBOX ); 
-	glBindTexture( GL_TEXTURE_CUBE_MAP, cubemap->m_handle ); 
+//-----------------------------------------------------------------------------------------------
+// Binds a 2D texture array and its sampler to the slot
+//
+void Renderer::BindTextureArray(unsigned int index, const TextureArray* textureArray, Sampler* sampler)
+{
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindSampler( index, sampler->GetHandle() ); 
+	glState->BindTexture( index, GL_TEXTURE_2D_ARRAY, textureArray->m_handle ); 
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1273,11 +1500,12 @@ bool Renderer::CopyFrameBuffer(FrameBuffer* dest, FrameBuffer* src)
 	}
 
 	// the GL_READ_FRAMEBUFFER is where we copy from
-	glBindFramebuffer( GL_READ_FRAMEBUFFER, srcFbo ); 
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindFramebuffer( GL_READ_FRAMEBUFFER, srcFbo ); 
 	GL_CHECK_ERROR();
 
 	// what are we copying to?
-	glBindFramebuffer( GL_DRAW_FRAMEBUFFER, destFbo ); 
+	glState->BindFramebuffer( GL_DRAW_FRAMEBUFFER, destFbo ); 
 	GL_CHECK_ERROR();
 
 	// blit it over - get teh size
@@ -1297,8 +1525,39 @@ bool Renderer::CopyFrameBuffer(FrameBuffer* dest, FrameBuffer* src)
 
 	GL_CHECK_ERROR();
 							  // cleanup after ourselves
-	glBindFramebuffer( GL_READ_FRAMEBUFFER, NULL ); 
-	glBindFramebuffer( GL_DRAW_FRAMEBUFFER, NULL ); 
+	glState->BindFramebuffer( GL_READ_FRAMEBUFFER, NULL ); 
+	glState->BindFramebuffer( GL_DRAW_FRAMEBUFFER, NULL ); 
+
+	return GLSucceeded();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the depth inside the pixel region from src to the same region on dst
+//
+bool Renderer::CopyDepthRegion(FrameBuffer* dst, FrameBuffer* src, const AABB2& pixelRegion)
+{
+	if(dst == nullptr || src == nullptr || dst->GetHandle() == src->GetHandle())
+	{
+		return false;
+	}
+
+	IntVector2 mins = IntVector2(pixelRegion.mins);
+	IntVector2 maxs = IntVector2(pixelRegion.maxs);
+
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindFramebuffer( GL_READ_FRAMEBUFFER, src->GetHandle() );
+	glState->BindFramebuffer( GL_DRAW_FRAMEBUFFER, dst->GetHandle() );
+	GL_CHECK_ERROR();
+
+	// Depth blits have to be unfiltered
+	glBlitFramebuffer( mins.x, mins.y, maxs.x, maxs.y,
+		mins.x, mins.y, maxs.x, maxs.y,
+		GL_DEPTH_BUFFER_BIT,
+		GL_NEAREST );
+	GL_CHECK_ERROR();
+
+	glState->BindFramebuffer( GL_READ_FRAMEBUFFER, NULL ); 
+	glState->BindFramebuffer( GL_DRAW_FRAMEBUFFER, NULL ); 
 
 	return GLSucceeded();
 }
@@ -1314,7 +1573,7 @@ void Renderer::SetCamera(Camera* cam)
 	}
 	IntVector2 viewMins = IntVector2(cam->GetViewportMins());
 	IntVector2 viewMaxs = IntVector2(cam->GetViewportMaxs());
-	glViewport(viewMins.x, viewMins.y, viewMaxs.x, viewMaxs.y);
+	GLStateCache::GetInstance()->Viewport(viewMins.x, viewMins.y, viewMaxs.x, viewMaxs.y);
 
 	cam->Finalize();
 	m_currentCamera = cam;
@@ -1367,6 +1626,49 @@ BitmapFont* Renderer::CreateOrGetBitmapFont( const char* bitmapFontName )
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the distance field version of the bitmap font. The atlas is generated from the glyph
+// sheet the first time and cached as Data/Fonts/<name>.sdf.png and .xml, delete those to rebuild
+//
+BitmapFont* Renderer::CreateOrGetSDFFont(const char* bitmapFontName)
+{
+	std::string fontKey = Stringf("%s.sdf", bitmapFontName);
+	std::map<std::string, BitmapFont*>::iterator found = m_loadedFonts.find(fontKey);
+	if(found != m_loadedFonts.end())
+	{
+		return found->second;
+	}
+
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	std::string cachePath = Stringf("Data/Fonts/%s", fontKey.c_str());
+	SDFFontAtlas atlas;
+	if(!atlas.LoadFromCache(cachePath))
+	{
+		std::string glyphSheetPath = Stringf("Data/Fonts/%s.png", bitmapFontName);
+		GUARANTEE_OR_DIE(FileExists(glyphSheetPath.c_str()), Stringf("Missing glyph sheet %s", glyphSheetPath.c_str()).c_str());
+
+		Image glyphSheet(glyphSheetPath);
+		atlas.GenerateFromGlyphSheet(glyphSheet);
+		if(!atlas.SaveToCache(cachePath))
+		{
+			DebuggerPrintf("Could not cache the SDF atlas of %s\n", bitmapFontName);
+		}
+	}
+
+	// Kept with the other textures so it's freed with them
+	Texture* atlasTexture = new Texture(*atlas.GetImage(), Sampler::GetLinearSampler(), false);
+	m_loadedTextures[cachePath + ".png"] = atlasTexture;
+
+	if(m_sdfTextProgram == nullptr)
+	{
+		m_sdfTextProgram = CreateOrGetShaderProgram("Data/Shaders/Src/font_sdf");
+	}
+
+	BitmapFont* newFont = new BitmapFont(fontKey, *atlasTexture, atlas.GetGlyphs(), BITMAP_FONT_DEFAULT_BASE_ASPECT);
+	m_loadedFonts[fontKey] = newFont;
+	return newFont;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns true if the font is already in memory
 //
@@ -1401,6 +1703,7 @@ void Renderer::SetShader(Shader* shader)
 //
 ShaderProgram* Renderer::CreateOrGetShaderProgram(const std::string& path, const char* defines /*= nullptr*/)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_SHADER);
 	if(path.compare("default") == 0)
 	{
 		return g_defaultProgram; // Return default shader when requested
@@ -1451,7 +1754,7 @@ void Renderer::UseShaderProgram(const ShaderProgram* shaderProgram)
 		current = g_defaultProgram;
 	}
 	
-	glUseProgram(current->GetHandle());
+	GLStateCache::GetInstance()->UseProgram(current->GetHandle());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1463,31 +1766,12 @@ void Renderer::BindDefaultShader()
 }
 
 //-----------------------------------------------------------------------------------------------
-// Binds the vertex layout to a shader program
+// Binds the mesh's vertex array for the program, building it on first use
 //
-void Renderer::BindMeshToProgram(unsigned int programHandle, const Mesh* mesh)
+void Renderer::BindMeshToProgram(const ShaderProgram* program, Mesh* mesh)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->m_vbo->GetHandle());
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->m_ibo->GetHandle());
-
-	const VertexLayout* layout = mesh->GetLayout();
-	for(int attribIndex = 0; attribIndex < layout->m_attributes.size(); attribIndex++)
-	{
-		const VertexAttribute* attrib = layout->GetAttribute(attribIndex);
-		GLenum dataType = GetGLDataType(attrib->m_type);
-		GLint bind = glGetAttribLocation(programHandle, attrib->m_handle);
-		if(bind >= 0)
-		{
-			glEnableVertexAttribArray(bind);
-			glVertexAttribPointer(bind,				// Where?
-				attrib->m_elementCount,				// How many ?
-				dataType,							// What's the data type?
-				attrib->m_isNormalized,				// Should the data be normalized?
-				layout->m_stride,					// How much space between each vertex
-				(GLvoid*) attrib->m_memberOffset);	// How far away is the needed data from the start of each?
-			GL_CHECK_ERROR();
-		}
-	}
+	GLuint vao = mesh->m_vertexArrays.GetOrCreate(*program, mesh->m_vbo->GetHandle(), mesh->m_ibo->GetHandle(), *mesh->GetLayout());
+	GLStateCache::GetInstance()->BindVertexArray(vao);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -1496,36 +1780,33 @@ void Renderer::BindMeshToProgram(unsigned int programHandle, const Mesh* mesh)
 void Renderer::BindRenderState(RenderState state)
 {
 	GL_CHECK_ERROR();
+	GLStateCache* glState = GLStateCache::GetInstance();
+
 	// Blend mode
-	glBlendEquationSeparate(GetGLBlendOp(state.m_colorBlendOp), GetGLBlendOp(state.m_alphaBlendOp));
-	glBlendFuncSeparate(GetGLBlendFactor(state.m_colorSrcFactor), GetGLBlendFactor(state.m_colorDstFactor), 
+	glState->BlendEquationSeparate(GetGLBlendOp(state.m_colorBlendOp), GetGLBlendOp(state.m_alphaBlendOp));
+	glState->BlendFuncSeparate(GetGLBlendFactor(state.m_colorSrcFactor), GetGLBlendFactor(state.m_colorDstFactor), 
 						GetGLBlendFactor(state.m_alphaSrcFactor), GetGLBlendFactor(state.m_alphaDstFactor));
-	GL_CHECK_ERROR();
 
 	// Depth mode
-	glDepthFunc(GetGLDepthTestMode(state.m_depthCompare));
-	glDepthMask(state.m_depthWrite);
-	GL_CHECK_ERROR();
+	glState->DepthFunc(GetGLDepthTestMode(state.m_depthCompare));
+	glState->DepthMask(state.m_depthWrite);
 
 	// Wind order
-	glFrontFace(GetGLWindOrder(state.m_frontFace));
-	GL_CHECK_ERROR();
+	glState->FrontFace(GetGLWindOrder(state.m_frontFace));
 
 	// Culling
 	if(state.m_cullMode == CULLMODE_NONE)
 	{
-		glDisable(GL_CULL_FACE);
+		glState->SetEnabled(GL_CULL_FACE, false);
 	}
 	else
 	{
-		glEnable(GL_CULL_FACE);
-		glCullFace(GetGLCullMode(state.m_cullMode));
+		glState->SetEnabled(GL_CULL_FACE, true);
+		glState->CullFace(GetGLCullMode(state.m_cullMode));
 	}
-	
-	GL_CHECK_ERROR();
 
 	// Fill mode
-	glPolygonMode(GL_FRONT_AND_BACK, GetGLFillMode(state.m_fillMode));
+	glState->PolygonMode(GetGLFillMode(state.m_fillMode));
 	GL_CHECK_ERROR();
 }
 
@@ -1534,12 +1815,16 @@ void Renderer::BindRenderState(RenderState state)
 //
 void Renderer::ReloadShaderPrograms()
 {
+	// Reloaded programs may put their attributes elsewhere
+	VertexArrayCache::InvalidateAll();
+
 	std::map<std::string, ShaderProgram*>::iterator found = m_loadedShaderPrograms.begin();
 
 	while(found != m_loadedShaderPrograms.end())
 	{
 		if(found->second)
 		{
+			GLStateCache::ForgetProgram(found->second->GetHandle());
 			glDeleteProgram(found->second->GetHandle()); // Remove it from GPU 
 			found->second->m_programHandle = NULL;
 		}
@@ -1577,11 +1862,7 @@ void Renderer::BindMaterial(const Material* material /*= nullptr */)
 	}
 
 	// Bind the material properties
-	std::map<std::string, MaterialProperty*>::const_iterator iter = material->m_properties.begin();
-	for(; iter != material->m_properties.end(); ++iter )
-	{
-		iter->second->Bind( material->GetShader()->GetProgram()->GetHandle() );
-	}
+	material->m_properties.Bind(*material->GetShader()->GetProgram());
 
 	// Specular block
 	m_specularBlock->specFactor = material->m_specFactor;
@@ -1601,6 +1882,7 @@ void Renderer::SetMaterial(const Material* material /*= nullptr */)
 //
 Material* Renderer::CreateOrGetMaterial(const std::string& path)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MATERIAL);
 	if(m_loadedMaterials.find(path) != m_loadedMaterials.end())
 	{
 		return m_loadedMaterials.at(path);
@@ -1777,20 +2059,7 @@ void Renderer::SetLightBuffer(std::vector<Light*>& lights)
 
 	for(size_t index = 0; index < lights.size(); ++index)
 	{
-		Light* light = lights[index];
-		LightStructure* lightBuf = &m_lightBlock->lights[index];
-		
-		lightBuf->attenuation = light->GetAttenuation();
-		lightBuf->position = light->GetWorldPosition();
-		lightBuf->color = light->GetColor().GetAsVector();
-		lightBuf->color.a = light->GetIntensity();
-		lightBuf->direction = light->GetDirection();
-		lightBuf->directionFactor = light->GetDirFactor();
-		lightBuf->spotFactor = light->GetSpotFactor();
-		lightBuf->dotInnerAngle = light->GetInnerDot();
-		lightBuf->dotOuterAngle = light->GetOuterDot();
-		lightBuf->isShadowCasting = light->m_lightDesc.isShadowCasting;
-		lightBuf->shadowVP = light->m_lightDesc.shadowVP;
+		m_lightBlock->lights[index] = lights[index]->GetGPUData();
 	}
 }
 
@@ -1800,7 +2069,129 @@ void Renderer::SetLightBuffer(std::vector<Light*>& lights)
 void Renderer::BindUBO(int bindPoint, const UniformBuffer* ubo)
 {
 	GL_CHECK_ERROR();
-	glBindBufferBase(GL_UNIFORM_BUFFER, bindPoint, ubo->GetHandle());
+	GLStateCache::GetInstance()->BindBufferBase(GL_UNIFORM_BUFFER, bindPoint, ubo->GetHandle());
+	GL_CHECK_ERROR();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the render mode the lit shaders debug draw with
+//
+void Renderer::SetRenderMode(int mode)
+{
+	m_renderMode = mode;
+	UpdateFrameBlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the current camera's matrices and eye position when they differ from what the camera
+// block already holds, so a camera drawing many meshes uploads once
+//
+void Renderer::UpdateCameraBlock()
+{
+	CameraBlock block;
+	block.view = m_currentCamera->m_viewMatrix;
+	block.projection = m_currentCamera->m_projMatrix;
+	block.eyePosition = m_currentCamera->m_transform.GetWorldPosition();
+
+	if(memcmp(&block, &m_cameraBlock, sizeof(CameraBlock)) != 0)
+	{
+		m_cameraBlock = block;
+		m_cameraBuffer->Set<CameraBlock>(m_cameraBlock);
+		m_cameraBuffer->UpdateGPU();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the time and render mode
+//
+void Renderer::UpdateFrameBlock()
+{
+	Clock* masterClock = Clock::GetMasterClock();
+	m_frameBlock.gameTime = (float) masterClock->GetTime();
+	m_frameBlock.gameDeltaTime = (float) masterClock->GetDeltaSeconds();
+	m_frameBlock.renderMode = m_renderMode;
+
+	m_frameBuffer->Set<FrameBlock>(m_frameBlock);
+	m_frameBuffer->UpdateGPU();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the layout to the batch of its glyph sheet, drawn right away unless a text batch is open
+//
+void Renderer::DrawTextLayout(const TextLayout& layout, const Vector2& offset, const BitmapFont* font, const Rgba& tint)
+{
+	const Texture* glyphSheet = font->GetSpriteSheetTexture();
+	TextBatch* batch = nullptr;
+	for(TextBatch& candidate : m_textBatches)
+	{
+		if(candidate.m_texture == glyphSheet || candidate.m_texture == nullptr)
+		{
+			batch = &candidate;
+			break;
+		}
+	}
+
+	if(batch == nullptr)
+	{
+		m_textBatches.emplace_back();
+		batch = &m_textBatches.back();
+	}
+
+	batch->m_texture = glyphSheet;
+	batch->m_isSDF = font->IsSDF();
+	batch->Append(layout, offset, tint);
+
+	if(!m_isBatchingText)
+	{
+		FlushTextBatches();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One indexed draw per glyph sheet, then the batches are emptied for reuse
+//
+void Renderer::FlushTextBatches()
+{
+	for(TextBatch& batch : m_textBatches)
+	{
+		if(!batch.IsEmpty())
+		{
+			DrawTextBatch(batch, Matrix44::IDENTITY);
+		}
+
+		batch.Clear();
+		batch.m_texture = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One indexed draw of the batch. SDF batches sample linearly and swap the SDF text program into
+// the current shader for the draw, so depth, blending and culling are whatever the caller set
+//
+void Renderer::DrawTextBatch(const TextBatch& batch, const Matrix44& modelMatrix)
+{
+	if(!batch.m_isSDF)
+	{
+		SetTexture((Texture*) batch.m_texture);
+		DrawMeshImmediateWithIndices(batch.m_vertices.data(), (int) batch.m_vertices.size(), batch.m_indices.data(), (int) batch.m_indices.size(), PRIMITIVE_TRIANGLES, modelMatrix);
+		return;
+	}
+
+	SetTexture(0, (Texture*) batch.m_texture, Sampler::GetLinearSampler());
+	Shader* shader = m_activeMaterial->GetShader();
+	ShaderProgram* callerProgram = shader->GetProgram();
+	shader->SetProgram(m_sdfTextProgram);
+	DrawMeshImmediateWithIndices(batch.m_vertices.data(), (int) batch.m_vertices.size(), batch.m_indices.data(), (int) batch.m_indices.size(), PRIMITIVE_TRIANGLES, modelMatrix);
+	shader->SetProgram(callerProgram);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Binds a shader storage buffer to the storage binding point
+//
+void Renderer::BindSSBO(int bindPoint, const StorageBuffer* ssbo)
+{
+	GL_CHECK_ERROR();
+	GLStateCache::GetInstance()->BindBufferBase(GL_SHADER_STORAGE_BUFFER, bindPoint, ssbo->GetHandle());
 	GL_CHECK_ERROR();
 }
 
@@ -2066,8 +2457,8 @@ bool RenderContextStartup()
 	::wglMakeCurrent( (HDC) g_displayDeviceContext, temp_context ); 
 	BindNewGLFunctions();  // find the functions we'll need to create the real context; 
 
-						   // create the real context, using opengl version 4.2
-	HGLRC real_context = CreateRealRenderContext( (HDC) g_displayDeviceContext, 4, 2 ); 
+						   // create the real context, using opengl version 4.3 (shader storage buffers)
+	HGLRC real_context = CreateRealRenderContext( (HDC) g_displayDeviceContext, 4, 3 ); 
 
 	// Set and cleanup
 	::wglMakeCurrent( (HDC) g_displayDeviceContext, real_context ); 
@@ -17,6 +17,11 @@
 #include "Engine/Enumerations/WrapMode.hpp"
 #include "Engine/Math/Vector4.hpp"
 #include "Engine/Renderer/FogBlock.hpp"
+#include "Engine/Renderer/UniformID.hpp"
+#include "Engine/Renderer/VertexArrayCache.hpp"
+#include "Engine/Renderer/TextLayoutCache.hpp"
+#include "Engine/Renderer/SpriteBatch.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constants
@@ -36,8 +41,12 @@ class Mesh;
 class Sprite;
 class Texture;
 class TextureCube;
+class TextureArray;
 class Shader;
 class UniformBuffer;
+class StorageBuffer;
+class StreamingBuffer;
+struct DrawInstruction;
 class Light;
 class Material;
 struct VertexLayout;
@@ -64,7 +73,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	Renderer();
-	~Renderer(){}
+	~Renderer();
 
 	//-----------------------------------------------------------------------------------------------
 	// Member Functions
@@ -78,6 +87,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Command Callbacks
 	static	bool			ScreenshotCommand(Command& cmd);
+	static	bool			ImmediateBenchCommand(Command& cmd);
 
 	//-----------------------------------------------------------------------------------------------
 	// Draw Functions
@@ -97,22 +107,29 @@ public:
 	
 	void			DrawAABB2( const AABB2& bounds, const Rgba& color = Rgba::WHITE );
 	void			DrawTexturedAABB2( const AABB2& bounds, const Texture& texture, const Vector2& texCoordsAtMins, const Vector2& texCoordsAtMaxs, const Rgba& tint = Rgba::WHITE);
+	void			DrawTexturedAABB2( const AABB2& bounds, const TextureAtlasRegion& region, const Rgba& tint = Rgba::WHITE );
 
 	void			DrawText2D( const Vector2& drawMins, const std::string& asciiText, float cellHeight, const BitmapFont* font, const Rgba& tint = Rgba::WHITE, float aspectScale = 1.f );
 	void			DrawTextInBox2D( const AABB2& textBoxBounds, const std::string& asciiText, float cellHeight, const Vector2& textAlignment, WrapMode wrapMode, const BitmapFont* font, const Rgba& tint = Rgba::WHITE, float aspectScale = 1.f );
 	void			DrawText3D( const std::string& text, const Matrix44& transform,  const BitmapFont* font, const Rgba& tint = Rgba::WHITE );
+	void			BeginTextBatch(); // Until EndTextBatch, 2D text is collected and drawn one call per glyph sheet. Draw nothing else in between
+	void			EndTextBatch();
 
 	void			DrawCube( const Vector3& center, const Vector3& dimensions, const Rgba& color, const AABB2& uvTop = AABB2::ZERO_TO_ONE, const AABB2& uvSide = AABB2::ZERO_TO_ONE, const AABB2& uvBottom = AABB2::ZERO_TO_ONE);
 
-	void			DrawSprite( const Sprite& sprite, const Matrix44& transform );
+	void			DrawSprite( const Sprite& sprite, const Matrix44& transform, int layer = 0, const Rgba& tint = Rgba::WHITE );
+	void			DrawSprite( const Texture& texture, const AABB2& bounds, const AABB2& uvs, const Matrix44& transform, int layer = 0, const Rgba& tint = Rgba::WHITE );
+	void			BeginSpriteBatch(); // Until EndSpriteBatch, sprites are sorted by layer, texture and depth and drawn one call per texture run
+	void			EndSpriteBatch();
 
 	void			DrawMeshImmediate( const Vertex_3DPCU* vertices, int numVerts, DrawPrimitiveType mode, const Matrix44& modelMatrix = Matrix44::IDENTITY );
 	void			DrawMeshImmediateWithIndices( const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, const Matrix44& modelMatrix = Matrix44::IDENTITY );
 	void			DrawMesh( Mesh* mesh, const Matrix44& modelMatrix = Matrix44::IDENTITY );
+	void			DrawMeshInstanced( Mesh* mesh, int instanceCount, const Matrix44& modelMatrix = Matrix44::IDENTITY ); // Per instance data comes from buffers the shader indexes with gl_InstanceID
 
 	//-----------------------------------------------------------------------------------------------
 	// Debug Stuff
-	void			SetRenderMode( int mode ) { m_renderMode = mode; }
+	void			SetRenderMode( int mode );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Mesh functions
@@ -125,10 +142,12 @@ public:
 	void			SetTexture( unsigned int index, Texture* texture, Sampler* sampler = nullptr );
 	Texture*		CreateOrGetTexture(const std::string& path, bool genMipmaps = true);
 	Texture*		CreateOrGetTexture(const Image& image, bool genMipmaps = true);
+	const TextureAtlasRegion*	CreateOrGetTextureRegion( const std::string& path ); // Small images share atlas pages, larger ones get a region covering their own texture
 	bool			IsTextureLoaded(const std::string& path) const;
 	void			BindTexture2D( const Texture* texture );
 	void			BindTexture2D( unsigned int index, const Texture* texture );
 	void			SetDefaultTexture();
+	const Texture*	GetDefaultTexture() const { return m_defaultTexture; } // White, for flat colored quads in a sprite batch
 	void			CopyTexture2D( Texture* dest, Texture* src );
 	Texture*		CreateRenderTarget(unsigned int width, unsigned int height, eTextureFormat fmt = TEXTURE_FORMAT_RGBA8);
 	Texture*		CreateDepthStencilTarget( unsigned int width, unsigned int height );
@@ -137,6 +156,7 @@ public:
 	// Cubemap functions
 	TextureCube*	CreateOrGetCubeMap( const std::string& path );
 	void			BindCubemap( const TextureCube* cubemap );
+	void			BindTextureArray( unsigned int index, const TextureArray* textureArray, Sampler* sampler );
 
 	//-----------------------------------------------------------------------------------------------
 	// GIF Functions
@@ -145,6 +165,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Bitmap Font functions
 	BitmapFont*		CreateOrGetBitmapFont( const char* bitmapFontName );
+	BitmapFont*		CreateOrGetSDFFont( const char* bitmapFontName ); // Distance field of the font's glyph sheet, cached next to it on disk
 	bool			IsBitmapFontLoaded( const std::string& bitmapFontName ) const;
 
 	//-----------------------------------------------------------------------------------------------
@@ -153,7 +174,7 @@ public:
 	ShaderProgram*	CreateOrGetShaderProgram(const std::string& path, const char* defines = nullptr);
 	void			UseShaderProgram(const ShaderProgram* shaderProgram);
 	void			BindDefaultShader();
-	void			BindMeshToProgram( unsigned int programHandle, const Mesh* mesh );
+	void			BindMeshToProgram( const ShaderProgram* program, Mesh* mesh ); // Binds the mesh's vertex array for the program
 	void			BindRenderState( RenderState state );
 	void			BlendFunction(BlendFactor sfactor, BlendFactor dfactor );
 	void			ColorBlendFunction(BlendFactor sfactor, BlendFactor dfactor);
@@ -193,6 +214,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Setting uniforms on shaders
 	void			BindUBO( int bindPoint, const UniformBuffer* ubo );
+	void			BindSSBO( int bindPoint, const StorageBuffer* ssbo );
 	void			SetUniform( const char* name, float value );
 	void			SetUniform( const char* name, int value );
 	void			SetUniform( const char* name, const Rgba& color );
@@ -225,8 +247,10 @@ public:
 	void			SetViewMatrix(const Matrix44& viewMatrix);
 	void			ClearScreen ( const Rgba& clearColor);
 	void			ClearDepth( float depth = 1.f );
+	void			ClearDepthRegion( const AABB2& pixelRegion, float depth = 1.f );
 	void			LineWidth(float width) const;
 	bool			CopyFrameBuffer( FrameBuffer *dst, FrameBuffer *src );
+	bool			CopyDepthRegion( FrameBuffer* dst, FrameBuffer* src, const AABB2& pixelRegion );
 	void			SetCamera(Camera* cam);
 	void			TakeScreenshot(const char* fileName);
 	
@@ -256,10 +280,38 @@ public:
 			UniformBuffer*							m_lightBuffer = nullptr;
 			UniformBuffer*							m_specularBuffer = nullptr;
 			UniformBuffer*							m_cameraBuffer = nullptr;
+			UniformBuffer*							m_frameBuffer = nullptr;
 			UniformBuffer*							m_fogBuffer = nullptr;
 			int										m_renderMode = 0;
 
 	private:	
+			bool			DrawStreamed( const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, const Matrix44& modelMatrix );
+			bool			WriteStreamed( const Vertex_3DPCU* vertices, int numVerts, const unsigned int* indices, int numIndices, DrawPrimitiveType mode, DrawInstruction& out_drawInstruction );
+			void			FlushSpriteBatch();
+			void			DrawBuffers( VertexArrayCache& vertexArrays, unsigned int vboHandle, unsigned int iboHandle, const VertexLayout& layout, const DrawInstruction& drawInstruction, const Matrix44& modelMatrix, int instanceCount = 1 );
+			double			TimeImmediateQuads( int quadCount, bool isStreamed );
+			void			UpdateCameraBlock();
+			void			UpdateFrameBlock();
+			void			DrawTextLayout( const TextLayout& layout, const Vector2& offset, const BitmapFont* font, const Rgba& tint );
+			void			FlushTextBatches();
+			void			DrawTextBatch( const TextBatch& batch, const Matrix44& modelMatrix );
+
+			CameraBlock								m_cameraBlock;						// What m_cameraBuffer holds
+			FrameBlock								m_frameBlock;
+			UniformID								m_modelUniform = INVALID_UNIFORM_ID;	// Per draw, everything else is in the blocks
+
+			StreamingBuffer*						m_immediateVertices = nullptr;		// Per frame arenas behind DrawMeshImmediate
+			StreamingBuffer*						m_immediateIndices = nullptr;
+			VertexArrayCache						m_immediateVertexArrays;			// Of the arenas, their offsets live in the draw calls
+			bool									m_isImmediateStreamed = true;
+			TextLayoutCache							m_textLayouts;
+			std::vector<TextBatch>					m_textBatches;						// One per glyph sheet drawn from, kept for their storage
+			TextBatch								m_text3DScratch;
+			ShaderProgram*							m_sdfTextProgram = nullptr;			// Swapped in for SDF font batches, the caller's render state stays
+			bool									m_isBatchingText = false;
+			SpriteBatch								m_spriteBatch;
+			bool									m_isBatchingSprites = false;
+			TextureAtlas							m_textureAtlas;						// Behind CreateOrGetTextureRegion, mips catch up in BeginFrame
 			Camera*									m_effectCamera = nullptr;
 			Texture*								m_effectTarget = nullptr;
 			Texture*								m_effectScratch = nullptr;
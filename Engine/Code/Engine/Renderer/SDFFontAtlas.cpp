@@ -0,0 +1,310 @@
+#include "Engine/Renderer/SDFFontAtlas.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/XMLUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/File/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+//-----------------------------------------------------------------------------------------------
+typedef tinyxml2::XMLDocument XMLDocument;
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr int SDF_FONT_CACHE_VERSION = 1;		// Bump when the generator output changes
+
+//-----------------------------------------------------------------------------------------------
+// Distances of one glyph before it's packed. Rows go bottom up like the images
+//
+struct SDFGlyphBitmap
+{
+	int							m_glyphIndex = 0;
+	IntVector2					m_size;
+	IntVector2					m_atlasPosition;
+	std::vector<unsigned char>	m_distances;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Returns the smallest power of two that's at least the value
+//
+static int GetNextPowerOfTwo(int value)
+{
+	int power = 1;
+	while(power < value)
+	{
+		power <<= 1;
+	}
+	return power;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the texel is part of a glyph. Bright opaque texels are ink
+//
+static bool IsInk(const Image& glyphSheet, int x, int y)
+{
+	Rgba texel = glyphSheet.GetTexel(x, y);
+	float brightness = std::max(texel.r, std::max(texel.g, texel.b));
+	return std::min(texel.a, brightness) >= 0.5f;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+SDFFontAtlas::SDFFontAtlas(const SDFFontSettings& settings)
+	: m_settings(settings)
+{
+	GUARANTEE_OR_DIE(m_settings.m_spread > 0 && m_settings.m_downscale > 0, "SDF font spread and downscale must be positive");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+SDFFontAtlas::~SDFFontAtlas()
+{
+	delete m_image;
+	m_image = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Builds the distance atlas and glyph metrics from a 16x16 glyph sheet. Distances are brute
+// forced within the spread, which is quick at glyph sheet sizes
+//
+void SDFFontAtlas::GenerateFromGlyphSheet(const Image& glyphSheet)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	IntVector2 sheetSize = glyphSheet.GetDimensions();
+	int cellWidth = sheetSize.x / BITMAP_FONT_TILES_WIDE;
+	int cellHeight = sheetSize.y / BITMAP_FONT_TILES_HIGH;
+	int spread = m_settings.m_spread;
+	int downscale = m_settings.m_downscale;
+	int searchRadius = spread + downscale;
+
+	// Crop each glyph to its ink and compute its distances
+	std::vector<SDFGlyphBitmap> bitmaps;
+	for(int glyphIndex = 0; glyphIndex < BITMAP_FONT_GLYPH_COUNT; ++glyphIndex)
+	{
+		// Glyph 0 is the top left cell, the image rows go bottom up
+		int cellMinX = (glyphIndex % BITMAP_FONT_TILES_WIDE) * cellWidth;
+		int cellMinY = sheetSize.y - (((glyphIndex / BITMAP_FONT_TILES_WIDE) + 1) * cellHeight);
+		int cellMaxX = cellMinX + cellWidth;
+		int cellMaxY = cellMinY + cellHeight;
+
+		IntVector2 inkMins(cellMaxX, cellMaxY);
+		IntVector2 inkMaxs(cellMinX - 1, cellMinY - 1);
+		for(int y = cellMinY; y < cellMaxY; ++y)
+		{
+			for(int x = cellMinX; x < cellMaxX; ++x)
+			{
+				if(IsInk(glyphSheet, x, y))
+				{
+					inkMins = IntVector2(std::min(inkMins.x, x), std::min(inkMins.y, y));
+					inkMaxs = IntVector2(std::max(inkMaxs.x, x), std::max(inkMaxs.y, y));
+				}
+			}
+		}
+
+		GlyphMetrics& glyph = m_glyphs[glyphIndex];
+		glyph = GlyphMetrics();
+		if(inkMaxs.x < inkMins.x)
+		{
+			// Nothing to draw, only the advance matters
+			glyph.m_uvs = AABB2(0.f, 0.f, 0.f, 0.f);
+			glyph.m_bounds = AABB2(0.f, 0.f, 0.f, 0.f);
+			continue;
+		}
+
+		IntVector2 sourceMins(inkMins.x - spread, inkMins.y - spread);
+		IntVector2 sourceSize((inkMaxs.x - inkMins.x) + 1 + (2 * spread), (inkMaxs.y - inkMins.y) + 1 + (2 * spread));
+
+		SDFGlyphBitmap bitmap;
+		bitmap.m_glyphIndex = glyphIndex;
+		bitmap.m_size = IntVector2((sourceSize.x + downscale - 1) / downscale, (sourceSize.y + downscale - 1) / downscale);
+		bitmap.m_distances.resize(bitmap.m_size.x * bitmap.m_size.y);
+
+		for(int atlasY = 0; atlasY < bitmap.m_size.y; ++atlasY)
+		{
+			for(int atlasX = 0; atlasX < bitmap.m_size.x; ++atlasX)
+			{
+				int sampleX = sourceMins.x + (atlasX * downscale) + (downscale / 2);
+				int sampleY = sourceMins.y + (atlasY * downscale) + (downscale / 2);
+				bool isInside = sampleX >= cellMinX && sampleX < cellMaxX && sampleY >= cellMinY && sampleY < cellMaxY && IsInk(glyphSheet, sampleX, sampleY);
+
+				// Nearest texel on the other side of the edge, neighbouring cells count as empty
+				int closestSquared = (searchRadius + 1) * (searchRadius + 1);
+				for(int offsetY = -searchRadius; offsetY <= searchRadius; ++offsetY)
+				{
+					for(int offsetX = -searchRadius; offsetX <= searchRadius; ++offsetX)
+					{
+						int x = sampleX + offsetX;
+						int y = sampleY + offsetY;
+						bool isInk = x >= cellMinX && x < cellMaxX && y >= cellMinY && y < cellMaxY && IsInk(glyphSheet, x, y);
+						int distanceSquared = (offsetX * offsetX) + (offsetY * offsetY);
+						if(isInk != isInside && distanceSquared < closestSquared)
+						{
+							closestSquared = distanceSquared;
+						}
+					}
+				}
+
+				// The edge is halfway between the texel centers
+				float distance = sqrtf((float) closestSquared) - 0.5f;
+				float signedDistance = isInside ? distance : -distance;
+				float normalized = ClampFloat(0.5f + (signedDistance / (2.f * (float) spread)), 0.f, 1.f);
+				bitmap.m_distances[(atlasY * bitmap.m_size.x) + atlasX] = (unsigned char) (normalized * 255.f);
+			}
+		}
+
+		// Quad placement relative to the cell, the quad covers the whole cropped area
+		glyph.m_bounds.mins = Vector2((float) (sourceMins.x - cellMinX) / (float) cellWidth, (float) (sourceMins.y - cellMinY) / (float) cellHeight);
+		glyph.m_bounds.maxs = glyph.m_bounds.mins + Vector2((float) (bitmap.m_size.x * downscale) / (float) cellWidth, (float) (bitmap.m_size.y * downscale) / (float) cellHeight);
+		bitmaps.push_back(bitmap);
+	}
+
+	// Shelf pack, tallest first so the shelves waste little
+	std::vector<SDFGlyphBitmap*> packOrder;
+	int padding = m_settings.m_padding;
+	int totalArea = 0;
+	int widestGlyph = 0;
+	for(SDFGlyphBitmap& bitmap : bitmaps)
+	{
+		packOrder.push_back(&bitmap);
+		totalArea += (bitmap.m_size.x + padding) * (bitmap.m_size.y + padding);
+		widestGlyph = std::max(widestGlyph, bitmap.m_size.x + (2 * padding));
+	}
+
+	std::sort(packOrder.begin(), packOrder.end(), [](const SDFGlyphBitmap* a, const SDFGlyphBitmap* b) { return a->m_size.y > b->m_size.y; });
+
+	int atlasWidth = GetNextPowerOfTwo(std::max(widestGlyph, (int) ceilf(sqrtf((float) totalArea))));
+	IntVector2 cursor(padding, padding);
+	int shelfHeight = 0;
+	for(SDFGlyphBitmap* bitmap : packOrder)
+	{
+		if(cursor.x + bitmap->m_size.x + padding > atlasWidth)
+		{
+			cursor = IntVector2(padding, cursor.y + shelfHeight + padding);
+			shelfHeight = 0;
+		}
+
+		bitmap->m_atlasPosition = cursor;
+		cursor.x += bitmap->m_size.x + padding;
+		shelfHeight = std::max(shelfHeight, bitmap->m_size.y);
+	}
+
+	int atlasHeight = GetNextPowerOfTwo(cursor.y + shelfHeight + padding);
+
+	// Copy the distances in, white with the distance in alpha so tinting works
+	delete m_image;
+	m_image = new Image(IntVector2(atlasWidth, atlasHeight), Rgba(1.f, 1.f, 1.f, 0.f), "SDFFontAtlas");
+	for(const SDFGlyphBitmap& bitmap : bitmaps)
+	{
+		for(int y = 0; y < bitmap.m_size.y; ++y)
+		{
+			for(int x = 0; x < bitmap.m_size.x; ++x)
+			{
+				float distance = (float) bitmap.m_distances[(y * bitmap.m_size.x) + x] / 255.f;
+				m_image->SetTexel(bitmap.m_atlasPosition.x + x, bitmap.m_atlasPosition.y + y, Rgba(1.f, 1.f, 1.f, distance));
+			}
+		}
+
+		float uvLeft = (float) bitmap.m_atlasPosition.x / (float) atlasWidth;
+		float uvRight = (float) (bitmap.m_atlasPosition.x + bitmap.m_size.x) / (float) atlasWidth;
+		float uvBottom = (float) bitmap.m_atlasPosition.y / (float) atlasHeight;
+		float uvTop = (float) (bitmap.m_atlasPosition.y + bitmap.m_size.y) / (float) atlasHeight;
+		m_glyphs[bitmap.m_glyphIndex].m_uvs = AABB2(uvLeft, uvTop, uvRight, uvBottom);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Loads the atlas written by SaveToCache. Fails if either file is missing or was made with
+// other settings
+//
+bool SDFFontAtlas::LoadFromCache(const std::string& cachePath)
+{
+	std::string imagePath = cachePath + ".png";
+	std::string metricsPath = cachePath + ".xml";
+	if(!FileExists(imagePath.c_str()))
+	{
+		return false;
+	}
+
+	XMLDocument doc;
+	if(doc.LoadFile(metricsPath.c_str()) != tinyxml2::XML_SUCCESS)
+	{
+		return false;
+	}
+
+	XMLElement* root = doc.FirstChildElement("SDFFont");
+	if(root == nullptr
+		|| ParseXmlAttribute(*root, "version", 0) != SDF_FONT_CACHE_VERSION
+		|| ParseXmlAttribute(*root, "spread", 0) != m_settings.m_spread
+		|| ParseXmlAttribute(*root, "downscale", 0) != m_settings.m_downscale
+		|| ParseXmlAttribute(*root, "padding", -1) != m_settings.m_padding)
+	{
+		return false;
+	}
+
+	for(XMLElement* glyphElement = root->FirstChildElement("Glyph"); glyphElement != nullptr; glyphElement = glyphElement->NextSiblingElement("Glyph"))
+	{
+		int glyphIndex = ParseXmlAttribute(*glyphElement, "index", -1);
+		if(glyphIndex < 0 || glyphIndex >= BITMAP_FONT_GLYPH_COUNT)
+		{
+			continue;
+		}
+
+		GlyphMetrics& glyph = m_glyphs[glyphIndex];
+		glyph.m_uvs = ParseXmlAttribute(*glyphElement, "uvs", glyph.m_uvs);
+		glyph.m_bounds = ParseXmlAttribute(*glyphElement, "bounds", glyph.m_bounds);
+		glyph.m_advance = ParseXmlAttribute(*glyphElement, "advance", glyph.m_advance);
+	}
+
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	delete m_image;
+	m_image = new Image(imagePath);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the atlas as a png and the metrics and settings as xml next to it
+//
+bool SDFFontAtlas::SaveToCache(const std::string& cachePath) const
+{
+	GUARANTEE_OR_DIE(m_image != nullptr, "Generate the SDF font atlas before saving it");
+
+	std::string imagePath = cachePath + ".png";
+	std::string metricsPath = cachePath + ".xml";
+	IntVector2 dimensions = m_image->GetDimensions();
+	unsigned char* texels = m_image->GetTexelsAsByteArray();
+	bool isImageSaved = WriteToPng(imagePath.c_str(), texels, dimensions.x, dimensions.y, 4);
+	free(texels);
+	if(!isImageSaved)
+	{
+		return false;
+	}
+
+	XMLDocument doc;
+	XMLElement* root = doc.NewElement("SDFFont");
+	root->SetAttribute("version", SDF_FONT_CACHE_VERSION);
+	root->SetAttribute("spread", m_settings.m_spread);
+	root->SetAttribute("downscale", m_settings.m_downscale);
+	root->SetAttribute("padding", m_settings.m_padding);
+	doc.InsertFirstChild(root);
+
+	for(int glyphIndex = 0; glyphIndex < BITMAP_FONT_GLYPH_COUNT; ++glyphIndex)
+	{
+		const GlyphMetrics& glyph = m_glyphs[glyphIndex];
+		XMLElement* glyphElement = doc.NewElement("Glyph");
+		glyphElement->SetAttribute("index", glyphIndex);
+		glyphElement->SetAttribute("uvs", Stringf("%f,%f,%f,%f", glyph.m_uvs.mins.x, glyph.m_uvs.mins.y, glyph.m_uvs.maxs.x, glyph.m_uvs.maxs.y).c_str());
+		glyphElement->SetAttribute("bounds", Stringf("%f,%f,%f,%f", glyph.m_bounds.mins.x, glyph.m_bounds.mins.y, glyph.m_bounds.maxs.x, glyph.m_bounds.maxs.y).c_str());
+		glyphElement->SetAttribute("advance", glyph.m_advance);
+		root->InsertEndChild(glyphElement);
+	}
+
+	return doc.SaveFile(metricsPath.c_str()) == tinyxml2::XML_SUCCESS;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Renderer/BitmapFont.hpp"
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Image;
+
+//-----------------------------------------------------------------------------------------------
+// What the atlas is generated with. A cache made with different settings gets rebuilt
+//
+struct SDFFontSettings
+{
+	int		m_spread = 4;		// Source texels from the edge to a distance of 0 or 1
+	int		m_downscale = 1;	// Source texels per atlas texel along each axis
+	int		m_padding = 1;		// Empty atlas texels between packed glyphs
+};
+
+//-----------------------------------------------------------------------------------------------
+// Signed distance field version of a 16x16 glyph sheet. Glyphs are cropped to their ink plus the
+// spread and shelf packed into one small atlas with their metrics, so the font stays sharp at
+// any size. The distance is in alpha with the glyph edge at 0.5
+//
+class SDFFontAtlas
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	explicit SDFFontAtlas( const SDFFontSettings& settings = SDFFontSettings() );
+	~SDFFontAtlas();
+	SDFFontAtlas( const SDFFontAtlas& ) = delete;
+	void operator=( const SDFFontAtlas& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	const	Image*				GetImage() const { return m_image; }
+	const	GlyphMetrics*		GetGlyphs() const { return m_glyphs; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void				GenerateFromGlyphSheet( const Image& glyphSheet );
+			bool				LoadFromCache( const std::string& cachePath ); // Path without extension, reads the .png and .xml pair
+			bool				SaveToCache( const std::string& cachePath ) const;
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			SDFFontSettings		m_settings;
+			Image*				m_image = nullptr;
+			GlyphMetrics		m_glyphs[BITMAP_FONT_GLYPH_COUNT];
+};
@@ -1,5 +1,6 @@
 #include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Rgba.hpp"
 
@@ -118,6 +119,7 @@ bool Sampler::CreateShadowSampler()
 void Sampler::DestroySampler()
 {
 	if (m_samplerHandle != NULL) {
+		GLStateCache::ForgetSampler( m_samplerHandle );
 		glDeleteSamplers( 1, &m_samplerHandle ); 
 		m_samplerHandle = NULL; 
 	}
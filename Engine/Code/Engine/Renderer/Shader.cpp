@@ -61,6 +61,7 @@ Shader::Shader(const XMLElement& element)
 	{
 		const char* defines = nullptr;
 		defines = ParseXmlAttribute(*defElement, "define", defines);
+		m_usesLightClusters = (defines != nullptr) && (std::string(defines).find("CLUSTERED_LIGHTING") != std::string::npos);
 
 		// Program element has the src so the program cannot have defines and stage definitions
 		if(defElement->FindAttribute("src"))
@@ -31,6 +31,7 @@ public:
 			ShaderProgram*	GetProgram() const { return m_program; }
 			int				GetSortOrder() const { return m_sortOrder; }
 			RenderQueue		GetRenderQueue() const { return m_renderQueue; }
+			bool			UsesLightClusters() const { return m_usesLightClusters; }
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
@@ -53,6 +54,7 @@ public:
 			RenderState			m_renderState;
 			RenderQueue			m_renderQueue = RENDER_QUEUE_OPAQUE;
 			int					m_sortOrder = 0;
+			bool				m_usesLightClusters = false; // Program defines CLUSTERED_LIGHTING, reads the cluster buffers instead of the light block
 
 	//-----------------------------------------------------------------------------------------------
 	// Static members
@@ -5,6 +5,8 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringTokenizer.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <map>
 
 //#define ToString(x) #x
 
@@ -12,9 +14,34 @@ ShaderProgram*	g_defaultProgram = nullptr;
 ShaderProgram*	g_invalidProgram = nullptr;
 ShaderProgram*	g_defDiffuseProgram = nullptr;
 
+//-----------------------------------------------------------------------------------------------
+// Locations every program gets for the engine's vertex attribute names (Vertex.cpp) before it is
+// linked, so the same mesh layout lines up with every shader. A layout qualifier in the shader
+// still wins over these
+//
+struct StandardAttributeLocation
+{
+	const char*	m_name;
+	GLuint		m_location;
+};
+
+static const StandardAttributeLocation s_standardAttributeLocations[] =
+{
+	{ "POSITION",	0 },
+	{ "COLOR",		1 },
+	{ "UV",			2 },
+	{ "NORMAL",		3 },
+	{ "TANGENT",	4 }
+};
+
 const char* defaultVS =		"#version 420 core\n									\
-							 uniform mat4 PROJECTION;\n								\
-							 uniform mat4 VIEW; \n									\
+							 layout(binding=1, std140) uniform cCameraBlock\n			\
+							 {\n													\
+								mat4 VIEW;\n										\
+								mat4 PROJECTION;\n									\
+								vec3 EYE_POSITION;\n								\
+								float CAMERA_PADDING;\n							\
+							 };\n												\
 							 uniform mat4 MODEL; \n									\
 							 in vec3 POSITION;\n									\
 							 in vec4 COLOR;\n 										\
@@ -80,6 +107,8 @@ bool ShaderProgram::LoadShaderFromSource(const char* name, const char* vsSource,
 	GLuint vertShader = CompileShader(vsSource, GL_VERTEX_SHADER, name);
 	GLuint fragShader = CompileShader(fsSource, GL_FRAGMENT_SHADER, name);
 	m_programHandle = CreateAndLinkProgram( vertShader, fragShader, name ); 
+	CacheUniformLocations();
+	CacheVertexInputID();
 	return (m_programHandle != NULL); 
 }
 
@@ -118,10 +147,129 @@ bool ShaderProgram::LoadFromFiles(const char* vsPath, const char* fsPath /*= nul
 	m_programHandle = CreateAndLinkProgram( vertShader, fragShader, vsPath ); 
 	glDeleteShader( vertShader ); 
 	glDeleteShader( fragShader ); 
+	CacheUniformLocations();
+	CacheVertexInputID();
 
 	return (m_programHandle != NULL); 
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the location of the uniform, looked up in the table made at link time
+//
+int ShaderProgram::GetUniformLocation(UniformID id) const
+{
+	if(id >= m_uniformLocations.size())
+	{
+		return -1;
+	}
+
+	return m_uniformLocations[id];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Asks GL for every active uniform once and stores their locations by interned name, so binds
+// never look a location up by string
+//
+void ShaderProgram::CacheUniformLocations()
+{
+	m_uniformLocations.clear();
+	if(m_programHandle == NULL)
+	{
+		return;
+	}
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(m_programHandle, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(m_programHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> nameBuffer((size_t) maxNameLength + 1);
+	for(GLint uniformIndex = 0; uniformIndex < uniformCount; ++uniformIndex)
+	{
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_programHandle, (GLuint) uniformIndex, maxNameLength, &nameLength, &arraySize, &type, nameBuffer.data());
+
+		// Block members have no location, they are set through the buffers
+		GLint location = glGetUniformLocation(m_programHandle, nameBuffer.data());
+		if(location < 0)
+		{
+			continue;
+		}
+
+		// Arrays are reported as NAME[0], properties use the plain name
+		std::string name(nameBuffer.data(), (size_t) nameLength);
+		size_t bracketIndex = name.find('[');
+		if(bracketIndex != std::string::npos)
+		{
+			name.erase(bracketIndex);
+		}
+
+		UniformID id = GetUniformID(name.c_str());
+		if(id >= m_uniformLocations.size())
+		{
+			m_uniformLocations.resize(id + 1, -1);
+		}
+		m_uniformLocations[id] = location;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Names the set of active vertex attributes and their locations with an ID shared by every
+// program that has the same set, so vertex arrays built for one of them fit all of them
+//
+void ShaderProgram::CacheVertexInputID()
+{
+	static std::map<std::string, uint32_t> s_vertexInputIDs;
+
+	m_vertexInputID = INVALID_VERTEX_INPUT_ID;
+	if(m_programHandle == NULL)
+	{
+		return;
+	}
+
+	GLint attributeCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(m_programHandle, GL_ACTIVE_ATTRIBUTES, &attributeCount);
+	glGetProgramiv(m_programHandle, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> nameBuffer((size_t) maxNameLength + 1);
+	std::vector<std::string> inputs;
+	for(GLint attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+	{
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		GLenum type = 0;
+		glGetActiveAttrib(m_programHandle, (GLuint) attributeIndex, maxNameLength, &nameLength, &arraySize, &type, nameBuffer.data());
+
+		// Built-ins like gl_VertexID are active but have no location
+		GLint location = glGetAttribLocation(m_programHandle, nameBuffer.data());
+		if(location >= 0)
+		{
+			inputs.push_back(Stringf("%s@%d", nameBuffer.data(), location));
+		}
+	}
+
+	// GL reports attributes in any order
+	std::sort(inputs.begin(), inputs.end());
+	std::string key;
+	for(size_t inputIndex = 0; inputIndex < inputs.size(); ++inputIndex)
+	{
+		key += inputs[inputIndex] + ";";
+	}
+
+	std::map<std::string, uint32_t>::const_iterator found = s_vertexInputIDs.find(key);
+	if(found != s_vertexInputIDs.end())
+	{
+		m_vertexInputID = found->second;
+		return;
+	}
+
+	m_vertexInputID = (uint32_t) s_vertexInputIDs.size();
+	s_vertexInputIDs[key] = m_vertexInputID;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Compiles the shader and returns a shader_id
 //
@@ -261,6 +409,12 @@ GLuint CreateAndLinkProgram( GLint vs, GLint fs, const char* fileName )
 	glAttachShader( program_id, vs );
 	glAttachShader( program_id, fs );
 
+	// Fixed locations for the engine's attribute names, they only take effect at link time
+	for(const StandardAttributeLocation& attribute : s_standardAttributeLocations)
+	{
+		glBindAttribLocation( program_id, attribute.m_location, attribute.m_name );
+	}
+
 	// Link the program (create the GPU program)
 	glLinkProgram( program_id );
 
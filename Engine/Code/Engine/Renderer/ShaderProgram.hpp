@@ -1,4 +1,11 @@
+#pragma once
 #include "Engine/Renderer/External/GL/glcorearb.h"
+#include "Engine/Renderer/UniformID.hpp"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t INVALID_VERTEX_INPUT_ID = UINT32_MAX;
 
 //-----------------------------------------------------------------------------------------------
 class ShaderProgram
@@ -16,11 +23,20 @@ public:
       bool LoadFromFiles( const char* vsPath, const char* fsPath = nullptr, const char* defines = nullptr ); // load a shader from file
 	  
 	  GLuint GetHandle() const{ return m_programHandle; }
+	  int GetUniformLocation( UniformID id ) const; // -1 when the program does not use the uniform
+	  uint32_t GetVertexInputID() const { return m_vertexInputID; } // Equal for programs with the same attributes at the same locations
 	  static void InitializeBuiltInShaders();
 
+private:
+	  void CacheUniformLocations(); // Called once after linking
+	  void CacheVertexInputID();
+
+public:
 	  //-----------------------------------------------------------------------------------------------
 	  // Members
       GLuint m_programHandle; // OpenGL handle for this program, default 0
+	  std::vector<int> m_uniformLocations; // Indexed by UniformID, block members are not in it
+	  uint32_t m_vertexInputID = INVALID_VERTEX_INPUT_ID;
 };
 
 //-----------------------------------------------------------------------------------------------
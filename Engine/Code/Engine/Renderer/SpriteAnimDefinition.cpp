@@ -24,7 +24,7 @@ SpriteAnimDefinition::SpriteAnimDefinition(const XMLElement& element, const Spri
 		std::string path = Stringf("Data/Images/%s", spriteSheetName.c_str());
 		IntVector2 layout = ParseXmlAttribute(element, "spriteLayout", IntVector2(0,0));
 
-		m_spriteSheet = new SpriteSheet(*renderer.CreateOrGetTexture(path), layout.x, layout.y);
+		m_spriteSheet = new SpriteSheet(*renderer.CreateOrGetTextureRegion(path), layout.x, layout.y);
 		m_spriteSheetOverride = true;
 	}
 	
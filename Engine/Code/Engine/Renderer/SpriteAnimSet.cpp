@@ -4,6 +4,7 @@
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Engine/Renderer/Renderer.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -104,3 +105,14 @@ std::string SpriteAnimSet::GetCurrentAnimName() const
 	return m_currentAnim->GetName();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Submits the current frame to the sprite batch, so between Begin/EndSpriteBatch every anim set
+// on the same sheet shares a draw
+//
+void SpriteAnimSet::Draw(Renderer& renderer, const AABB2& bounds, const Matrix44& transform, int layer /*= 0*/, const Rgba& tint /*= Rgba::WHITE*/) const
+{
+	// Sheet uvs have their mins at the bottom left, sprites want them at the top left
+	AABB2 uvs = GetCurrentUVs();
+	AABB2 spriteUVs(Vector2(uvs.mins.x, uvs.maxs.y), Vector2(uvs.maxs.x, uvs.mins.y));
+	renderer.DrawSprite(GetCurrentTexture(), bounds, spriteUVs, transform, layer, tint);
+}
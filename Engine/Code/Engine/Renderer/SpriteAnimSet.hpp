@@ -1,4 +1,5 @@
 #pragma once
+#include "Engine/Core/Rgba.hpp"
 #include <map>
 
 //-----------------------------------------------------------------------------------------------
@@ -8,6 +9,8 @@ class AABB2;
 class Vector2;
 class SpriteAnimSetDefinition;
 class SpriteAnim;
+class Renderer;
+class Matrix44;
 
 //-----------------------------------------------------------------------------------------------
 class SpriteAnimSet
@@ -28,6 +31,7 @@ public:
 			Vector2			GetTexCoordsAtMins() const;
 			Vector2			GetTexCoordsAtMaxs() const;
 			std::string		GetCurrentAnimName() const;
+			void			Draw( Renderer& renderer, const AABB2& bounds, const Matrix44& transform, int layer = 0, const Rgba& tint = Rgba::WHITE ) const; // Joins the renderer's sprite batch
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
@@ -19,7 +19,7 @@ SpriteAnimSetDefinition::SpriteAnimSetDefinition( const XMLElement& animSetEleme
 	GUARANTEE_OR_DIE(spriteSheetName != "Invalid", "SpriteSheet name not specified in the spriteAnimSet element");
 
 	std::string path = Stringf("Data/Images/%s", spriteSheetName.c_str());
-	SpriteSheet* spriteSheet = new SpriteSheet(*renderer.CreateOrGetTexture(path), spriteLayout.x, spriteLayout.y);
+	SpriteSheet* spriteSheet = new SpriteSheet(*renderer.CreateOrGetTextureRegion(path), spriteLayout.x, spriteLayout.y);
 
 	for(const XMLElement* animElement = animSetElement.FirstChildElement(); animElement; animElement = animElement->NextSiblingElement())
 	{
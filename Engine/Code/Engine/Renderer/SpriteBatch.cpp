@@ -0,0 +1,126 @@
+#include "Engine/Renderer/SpriteBatch.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr int SPRITE_BATCH_MIN_LAYER = -32768;	// Layers are clamped into 16 bits of the sort key
+constexpr int SPRITE_BATCH_MAX_LAYER = 32767;
+
+//-----------------------------------------------------------------------------------------------
+// Maps the depth to bits that sort far to near, larger z is further from the camera
+//
+static uint32_t GetDepthSortBits(float depth)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &depth, sizeof(bits));
+	uint32_t ascending = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	return ~ascending;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a quad with the bounds in the sprite's local space
+//
+void SpriteBatch::Submit(const Texture* texture, const AABB2& bounds, const AABB2& uvs, const Matrix44& transform, int layer, const Rgba& tint)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	uint16_t layerBits = (uint16_t) (ClampInt(layer, SPRITE_BATCH_MIN_LAYER, SPRITE_BATCH_MAX_LAYER) - SPRITE_BATCH_MIN_LAYER);
+	Vector3 center = transform.TransformPosition3D(Vector3(bounds.GetCenter()));
+
+	SubmittedSprite sprite;
+	sprite.m_sortKey = ((uint64_t) layerBits << 48) | ((uint64_t) GetTextureOrdinal(texture) << 32) | GetDepthSortBits(center.z);
+	sprite.m_texture = texture;
+	sprite.m_corners[0] = Vertex_3DPCU(transform.TransformPosition3D(Vector3(bounds.mins.x, bounds.mins.y)), tint, Vector2(uvs.mins.x, uvs.maxs.y));
+	sprite.m_corners[1] = Vertex_3DPCU(transform.TransformPosition3D(Vector3(bounds.maxs.x, bounds.mins.y)), tint, uvs.maxs);
+	sprite.m_corners[2] = Vertex_3DPCU(transform.TransformPosition3D(Vector3(bounds.maxs.x, bounds.maxs.y)), tint, Vector2(uvs.maxs.x, uvs.mins.y));
+	sprite.m_corners[3] = Vertex_3DPCU(transform.TransformPosition3D(Vector3(bounds.mins.x, bounds.maxs.y)), tint, uvs.mins);
+	m_sprites.push_back(sprite);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sorts the sprites and fills the vertices, indices and texture runs
+//
+void SpriteBatch::Build()
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	m_sortEntries.clear();
+	m_vertices.clear();
+	m_indices.clear();
+	m_runs.clear();
+
+	// Sort the small entries, the sprites stay where they are
+	m_sortEntries.reserve(m_sprites.size());
+	for(uint spriteIndex = 0; spriteIndex < (uint) m_sprites.size(); ++spriteIndex)
+	{
+		m_sortEntries.push_back({ m_sprites[spriteIndex].m_sortKey, spriteIndex });
+	}
+
+	std::stable_sort(m_sortEntries.begin(), m_sortEntries.end(), [](const SortEntry& a, const SortEntry& b) { return a.m_sortKey < b.m_sortKey; });
+
+	m_vertices.reserve(m_sprites.size() * 4);
+	m_indices.reserve(m_sprites.size() * 6);
+	for(const SortEntry& entry : m_sortEntries)
+	{
+		const SubmittedSprite& sprite = m_sprites[entry.m_spriteIndex];
+		if(m_runs.empty() || m_runs.back().m_texture != sprite.m_texture)
+		{
+			SpriteRun run;
+			run.m_texture = sprite.m_texture;
+			run.m_firstIndex = (uint) m_indices.size();
+			m_runs.push_back(run);
+		}
+
+		uint baseVertex = (uint) m_vertices.size();
+		m_vertices.insert(m_vertices.end(), sprite.m_corners, sprite.m_corners + 4);
+
+		// Same winding as the immediate sprite quad
+		m_indices.push_back(baseVertex);
+		m_indices.push_back(baseVertex + 1);
+		m_indices.push_back(baseVertex + 3);
+		m_indices.push_back(baseVertex + 3);
+		m_indices.push_back(baseVertex + 1);
+		m_indices.push_back(baseVertex + 2);
+		m_runs.back().m_indexCount += 6;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Empties the batch for the next frame
+//
+void SpriteBatch::Clear()
+{
+	m_sprites.clear();
+	m_sortEntries.clear();
+	m_textures.clear();
+	m_vertices.clear();
+	m_indices.clear();
+	m_runs.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the index of the texture in the order textures were first submitted. Sprites tend to
+// come in runs of one texture so the last one is checked first
+//
+uint16_t SpriteBatch::GetTextureOrdinal(const Texture* texture)
+{
+	if(!m_textures.empty() && m_textures.back() == texture)
+	{
+		return (uint16_t) (m_textures.size() - 1);
+	}
+
+	for(size_t textureIndex = 0; textureIndex < m_textures.size(); ++textureIndex)
+	{
+		if(m_textures[textureIndex] == texture)
+		{
+			return (uint16_t) textureIndex;
+		}
+	}
+
+	m_textures.push_back(texture);
+	return (uint16_t) (m_textures.size() - 1);
+}
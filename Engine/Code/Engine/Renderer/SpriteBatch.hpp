@@ -0,0 +1,75 @@
+#pragma once
+#include "Engine/Core/Vertex.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Texture;
+class Matrix44;
+
+//-----------------------------------------------------------------------------------------------
+// Consecutive sorted sprites sharing a texture, one draw each
+//
+struct SpriteRun
+{
+	const	Texture*	m_texture = nullptr;
+			uint		m_firstIndex = 0;
+			uint		m_indexCount = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Sprites collected over a frame. Build sorts them by layer, then texture, then depth back to
+// front, and expands them into one vertex and index array with a run per texture change. The
+// corners are transformed on the CPU so any number of sprites share a draw
+//
+class SpriteBatch
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	SpriteBatch() {}
+	~SpriteBatch() {}
+	SpriteBatch( const SpriteBatch& ) = delete;
+	void operator=( const SpriteBatch& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int								GetSpriteCount() const { return (int) m_sprites.size(); }
+			bool							IsEmpty() const { return m_sprites.empty(); }
+	const	std::vector<Vertex_3DPCU>&		GetVertices() const { return m_vertices; }
+	const	std::vector<uint>&				GetIndices() const { return m_indices; }
+	const	std::vector<SpriteRun>&			GetRuns() const { return m_runs; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void		Submit( const Texture* texture, const AABB2& bounds, const AABB2& uvs, const Matrix44& transform, int layer, const Rgba& tint );
+			void		Build();
+			void		Clear(); // Keeps the storage for the next frame
+
+private:
+			uint16_t	GetTextureOrdinal( const Texture* texture );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	struct SubmittedSprite
+	{
+		uint64_t		m_sortKey;
+		const Texture*	m_texture;
+		Vertex_3DPCU	m_corners[4];		// Bottom left, bottom right, top right, top left
+	};
+
+	struct SortEntry
+	{
+		uint64_t		m_sortKey;
+		uint			m_spriteIndex;
+	};
+
+			std::vector<SubmittedSprite>	m_sprites;
+			std::vector<SortEntry>			m_sortEntries;
+			std::vector<const Texture*>		m_textures;				// Ordinal in the sort key is the index in here
+			std::vector<Vertex_3DPCU>		m_vertices;
+			std::vector<uint>				m_indices;
+			std::vector<SpriteRun>			m_runs;
+};
@@ -2,6 +2,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 #include "../Console/DevConsole.hpp"
 
 typedef tinyxml2::XMLDocument XMLDocument;
@@ -23,8 +24,9 @@ SpriteDefinition::SpriteDefinition(const XMLElement& element)
 	GUARANTEE_OR_DIE(defElement != nullptr, Stringf("Texture path invalid for Sprite:%s", m_name.c_str()).c_str());
 	std::string texturePath =	ParseXmlAttribute(*defElement, "src", "Invalid Path");
 	GUARANTEE_OR_DIE(texturePath != "Invalid Path", Stringf("Texture path not found for Sprite:%s", m_name.c_str()).c_str());
-	m_texture = Renderer::GetInstance()->CreateOrGetTexture(texturePath);
-	GUARANTEE_OR_DIE(m_texture->GetDimensions().x > 0, Stringf("Texture path not found for Sprite:%s", m_name.c_str()).c_str());
+	m_region = Renderer::GetInstance()->CreateOrGetTextureRegion(texturePath);
+	m_texture = m_region->m_texture;
+	GUARANTEE_OR_DIE(m_region->m_dimensions.x > 0, Stringf("Texture path not found for Sprite:%s", m_name.c_str()).c_str());
 
 	// Load the uv data
 	defElement = element.FirstChildElement("uv");
@@ -54,6 +56,9 @@ SpriteDefinition::SpriteDefinition(const XMLElement& element)
 	m_uvs.mins.y = 1.f - m_uvs.mins.y;
 	SetDimensionsFromUVs(m_uvs);
 	SetLocalBoundsFromDimensions(m_worldDimensions, m_pivot);
+
+	// The uvs so far are over the image, move them to where it is in the atlas
+	m_uvs = m_region->MapUVs(m_uvs);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -81,7 +86,7 @@ SpriteDefinition* SpriteDefinition::GetDefinition(const std::string& name)
 void SpriteDefinition::SetDimensionsFromUVs(const AABB2& uvs)
 {
 	IntVector2 mins, maxs;
-	IntVector2 texDimensions = m_texture->GetDimensions();
+	IntVector2 texDimensions = m_region->m_dimensions;
 	mins.x = (int) (uvs.mins.x * (float) texDimensions.x);
 	maxs.x = (int) (uvs.maxs.x * (float) texDimensions.x);
 	mins.y = (int) (uvs.mins.y * (float) texDimensions.y);
@@ -100,7 +105,7 @@ void SpriteDefinition::SetDimensionsFromUVs(const AABB2& uvs)
 void SpriteDefinition::SetUVsFromPixels(const AABB2& pixels)
 {
 	AABB2 uvs;
-	IntVector2 texDimensions = m_texture->GetDimensions();
+	IntVector2 texDimensions = m_region->m_dimensions;
 	uvs.mins.x = pixels.mins.x / (float) texDimensions.x;
 	uvs.mins.y = pixels.mins.y / (float) texDimensions.y;
 
@@ -9,6 +9,7 @@
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
 class Texture;
+struct TextureAtlasRegion;
 
 //-----------------------------------------------------------------------------------------------
 class SpriteDefinition
@@ -40,6 +41,7 @@ public:
 	// Members
 	static		std::map<std::string, SpriteDefinition*>	s_definitions;
 	const		Texture*									m_texture = nullptr;
+	const		TextureAtlasRegion*							m_region = nullptr;		// Where the image is in m_texture, m_uvs are already mapped into it
 				AABB2										m_uvs;
 				IntVector2									m_dimensions;
 				Vector2										m_pivot = Vector2(0.5f, 0.5f);
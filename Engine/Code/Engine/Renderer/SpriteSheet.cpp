@@ -1,5 +1,6 @@
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureAtlas.hpp"
 #include "Engine/Math/AABB2.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -10,6 +11,17 @@ SpriteSheet::SpriteSheet(const Texture& texture, int tilesWide, int tilesHigh):
 
 }
 
+//-----------------------------------------------------------------------------------------------
+// Constructor for a sheet in the texture atlas
+//
+SpriteSheet::SpriteSheet(const TextureAtlasRegion& region, int tilesWide, int tilesHigh)
+	: m_spriteSheetTexture(*region.m_texture)
+	, m_spriteLayout(IntVector2(tilesWide,tilesHigh))
+	, m_region(&region)
+{
+
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns the texture coords for the sprite from the sprite sheet
 //
@@ -24,6 +36,12 @@ AABB2 SpriteSheet::GetTexCoordsForSpriteCoords(const IntVector2& spriteCoords) c
 
 	texCoords.mins.y = 1.f - texCoords.mins.y; // Offset the texture y-flip
 	texCoords.maxs.y = 1.f - texCoords.maxs.y;
+
+	if(m_region)
+	{
+		return m_region->MapUVs(texCoords);
+	}
+
 	return texCoords;
 }
 
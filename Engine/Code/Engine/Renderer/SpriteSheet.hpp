@@ -2,6 +2,7 @@
 #include "Engine/Math/IntVector2.hpp"
 class Texture;
 class AABB2;
+struct TextureAtlasRegion;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -11,6 +12,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	SpriteSheet(const Texture& texture, int tilesWide, int tilesHigh);
+	SpriteSheet(const TextureAtlasRegion& region, int tilesWide, int tilesHigh); // Tex coords land inside the region
 	~SpriteSheet(){}
 
 	//-----------------------------------------------------------------------------------------------
@@ -22,8 +24,9 @@ public:
 
 	
 private:
-	const	Texture&	m_spriteSheetTexture;
-			IntVector2	m_spriteLayout;
+	const	Texture&				m_spriteSheetTexture;
+			IntVector2				m_spriteLayout;
+	const	TextureAtlasRegion*		m_region = nullptr;		// Null when the sheet is a whole texture
 
 
 };
\ No newline at end of file
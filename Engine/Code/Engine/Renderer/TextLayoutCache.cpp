@@ -0,0 +1,357 @@
+#include "Engine/Renderer/TextLayoutCache.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/StringTokenizer.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr uint32_t TEXT_LAYOUT_MAX_IDLE_FRAMES = 120;		// Unused for this long and the layout goes
+constexpr uint32_t TEXT_LAYOUT_SWEEP_INTERVAL = 60;		// Frames between looking for idle layouts
+
+//-----------------------------------------------------------------------------------------------
+// Scrambles the bits so nearby values land in different buckets
+//
+static uint64_t MixHash(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the raw bits of the float for hashing
+//
+static uint64_t GetFloatBits(float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hashes the text (FNV-1a) and folds the params in
+//
+static uint64_t HashTextLayout(const std::string& text, const TextLayoutParams& params)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for(size_t charIndex = 0; charIndex < text.size(); ++charIndex)
+	{
+		hash ^= (unsigned char) text[charIndex];
+		hash *= 0x100000001b3ULL;
+	}
+
+	hash = MixHash(hash ^ (uint64_t) (uintptr_t) params.m_font);
+	hash = MixHash(hash ^ (GetFloatBits(params.m_cellHeight) | (GetFloatBits(params.m_aspectScale) << 32)));
+	hash = MixHash(hash ^ (GetFloatBits(params.m_boxSize.x) | (GetFloatBits(params.m_boxSize.y) << 32)));
+	hash = MixHash(hash ^ (GetFloatBits(params.m_alignment.x) | (GetFloatBits(params.m_alignment.y) << 32)));
+	return MixHash(hash ^ (uint64_t) params.m_wrapMode);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Compares all the params
+//
+bool TextLayoutParams::operator==(const TextLayoutParams& compare) const
+{
+	return m_font == compare.m_font
+		&& m_cellHeight == compare.m_cellHeight
+		&& m_aspectScale == compare.m_aspectScale
+		&& m_boxSize == compare.m_boxSize
+		&& m_alignment == compare.m_alignment
+		&& m_wrapMode == compare.m_wrapMode;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds the layout's glyphs at the offset, two triangles a glyph
+//
+void TextBatch::Append(const TextLayout& layout, const Vector2& offset, const Rgba& tint)
+{
+	uint32_t baseVertex = (uint32_t) m_vertices.size();
+	m_vertices.reserve(m_vertices.size() + layout.m_vertices.size());
+	m_indices.reserve(m_indices.size() + (layout.GetGlyphCount() * 6));
+
+	for(const Vertex_3DPCU& vertex : layout.m_vertices)
+	{
+		m_vertices.push_back(Vertex_3DPCU(vertex.m_position + Vector3(offset), tint, vertex.m_UVs));
+	}
+
+	for(int glyphIndex = 0; glyphIndex < layout.GetGlyphCount(); ++glyphIndex)
+	{
+		uint32_t glyphStart = baseVertex + (glyphIndex * 4);
+		m_indices.push_back(glyphStart);
+		m_indices.push_back(glyphStart + 1);
+		m_indices.push_back(glyphStart + 2);
+		m_indices.push_back(glyphStart + 2);
+		m_indices.push_back(glyphStart + 1);
+		m_indices.push_back(glyphStart + 3);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Empties the batch, keeping the storage for the next frame
+//
+void TextBatch::Clear()
+{
+	m_vertices.clear();
+	m_indices.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+TextLayoutCache::~TextLayoutCache()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the layout of a single line starting at the origin
+//
+const TextLayout& TextLayoutCache::CreateOrGetLine(const std::string& text, const BitmapFont* font, float cellHeight, float aspectScale)
+{
+	TextLayoutParams params;
+	params.m_font = font;
+	params.m_cellHeight = cellHeight;
+	params.m_aspectScale = aspectScale;
+	return CreateOrGet(text, params);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the layout of the text fitted to a box of the size, relative to the box mins
+//
+const TextLayout& TextLayoutCache::CreateOrGetBox(const std::string& text, const BitmapFont* font, float cellHeight, float aspectScale, const Vector2& boxSize,
+	const Vector2& alignment, WrapMode wrapMode)
+{
+	TextLayoutParams params;
+	params.m_font = font;
+	params.m_cellHeight = cellHeight;
+	params.m_aspectScale = aspectScale;
+	params.m_boxSize = boxSize;
+	params.m_alignment = alignment;
+	params.m_wrapMode = wrapMode;
+	return CreateOrGet(text, params);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Drops the layouts that weren't used for a while. Only looks every so often, the cache is
+// mostly hits
+//
+void TextLayoutCache::EndFrame()
+{
+	++m_frameIndex;
+	if((m_frameIndex % TEXT_LAYOUT_SWEEP_INTERVAL) != 0)
+	{
+		return;
+	}
+
+	std::map<uint64_t, std::vector<TextLayout*>>::iterator bucket = m_layouts.begin();
+	while(bucket != m_layouts.end())
+	{
+		std::vector<TextLayout*>& layouts = bucket->second;
+		for(size_t layoutIndex = 0; layoutIndex < layouts.size(); ++layoutIndex)
+		{
+			if(m_frameIndex - layouts[layoutIndex]->m_lastUsedFrame > TEXT_LAYOUT_MAX_IDLE_FRAMES)
+			{
+				delete layouts[layoutIndex];
+				layouts[layoutIndex] = layouts.back();
+				layouts.pop_back();
+				--layoutIndex;
+				--m_layoutCount;
+			}
+		}
+
+		if(layouts.empty())
+		{
+			bucket = m_layouts.erase(bucket);
+		}
+		else
+		{
+			++bucket;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Deletes every layout
+//
+void TextLayoutCache::Clear()
+{
+	for(std::pair<const uint64_t, std::vector<TextLayout*>>& bucket : m_layouts)
+	{
+		for(TextLayout* layout : bucket.second)
+		{
+			delete layout;
+		}
+	}
+
+	m_layouts.clear();
+	m_layoutCount = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Finds the layout, or lays the text out and keeps it
+//
+const TextLayout& TextLayoutCache::CreateOrGet(const std::string& text, const TextLayoutParams& params)
+{
+	uint64_t hash = HashTextLayout(text, params);
+	std::vector<TextLayout*>& bucket = m_layouts[hash];
+	for(TextLayout* layout : bucket)
+	{
+		if(layout->m_params == params && layout->m_text == text)
+		{
+			layout->m_lastUsedFrame = m_frameIndex;
+			return *layout;
+		}
+	}
+
+	MEMORY_TAG_SCOPE(MEMORY_TAG_RENDERER);
+	TextLayout* layout = new TextLayout();
+	layout->m_text = text;
+	layout->m_params = params;
+	layout->m_lastUsedFrame = m_frameIndex;
+
+	if(params.m_boxSize == Vector2::ZERO)
+	{
+		layout->m_vertices.reserve(text.size() * 4);
+		AppendGlyphRun(*layout, text, Vector2::ZERO, params.m_cellHeight);
+	}
+	else
+	{
+		BuildBox(*layout);
+	}
+
+	bucket.push_back(layout);
+	++m_layoutCount;
+	return *layout;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Splits the text into lines and places them in the box as the wrap mode says
+//
+STATIC void TextLayoutCache::BuildBox(TextLayout& layout)
+{
+	const TextLayoutParams& params = layout.m_params;
+	const BitmapFont* font = params.m_font;
+	float cellHeight = params.m_cellHeight;
+	float aspectScale = params.m_aspectScale;
+
+	// Split the string into lines based on \n
+	StringTokenizer tokenizer(layout.m_text, "\n");
+	tokenizer.Tokenize();
+	Strings tokens = tokenizer.GetTokens();
+	size_t lineIndex = 0;
+
+	float textWidth;
+	float paddingX;
+	float textHeight = font->GetStringHeight(layout.m_text, cellHeight, aspectScale);
+	float paddingY;
+	Vector2 drawMins;
+
+	if(params.m_wrapMode == WrapMode::OVERRUN)
+	{
+		paddingY = (params.m_boxSize.y - (textHeight / (float) tokens.size())) * params.m_alignment.y;
+		for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
+		{
+			textWidth = font->GetStringWidth(*iter, cellHeight, aspectScale);
+			paddingX = (params.m_boxSize.x - textWidth) * params.m_alignment.x;
+			drawMins = Vector2(paddingX, paddingY);
+			drawMins.y += (float) lineIndex * cellHeight;
+			AppendGlyphRun(layout, *iter, drawMins, cellHeight);
+			lineIndex++;
+		}
+	}
+
+	else if(params.m_wrapMode == WrapMode::SHRINK_TO_FIT)
+	{
+		float scaleX;
+		float scaleY = cellHeight;
+		float boxWidth = params.m_boxSize.x * 0.5f;
+		float boxHeight = params.m_boxSize.y * 0.5f;
+		textWidth = font->GetStringWidth(layout.m_text, cellHeight, aspectScale);
+		if(textWidth >= boxWidth && textHeight <= boxHeight)
+		{
+			scaleX = boxWidth / textWidth;
+			scaleY = scaleX / aspectScale;
+		}
+
+		else if(textHeight >= boxHeight && textWidth <= boxWidth)
+		{
+			scaleY = boxHeight / textHeight;
+		}
+
+		else if(textWidth >= boxWidth && textHeight >= boxHeight)
+		{
+			scaleX = 1.f;
+			for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
+			{
+				textWidth = font->GetStringWidth(*iter, cellHeight, aspectScale);
+				if(textWidth > boxWidth)
+				{
+					float scale = boxWidth / textWidth;
+					if(scale < scaleX)
+						scaleX = scale; // Choose the highest scale along width from each line
+				}
+			}
+			scaleY = boxHeight / textHeight;
+			if(scaleX < scaleY) // Choose the one that scales down the most
+			{
+				scaleY = scaleX;
+			}
+		}
+
+		paddingY = (params.m_boxSize.y - (scaleY * (float) tokens.size())) * params.m_alignment.y;
+		for(Strings::reverse_iterator iter = tokens.rbegin(); iter != tokens.rend(); ++iter)
+		{
+			textWidth = font->GetStringWidth(*iter, scaleY, aspectScale);
+			textHeight = font->GetStringHeight(*iter, scaleY, aspectScale);
+			paddingX = (params.m_boxSize.x - textWidth) * params.m_alignment.x;
+			drawMins = Vector2(paddingX, paddingY);
+			drawMins.y += (float) lineIndex * textHeight;
+			AppendGlyphRun(layout, *iter, drawMins, scaleY);
+			lineIndex++;
+		}
+	}
+
+	else if(params.m_wrapMode == WrapMode::WORD_WRAP)
+	{
+
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds one quad per inked glyph of a single line starting at drawMins, placed by the glyph
+// metrics. Glyphs with empty bounds only move the cursor
+//
+STATIC void TextLayoutCache::AppendGlyphRun(TextLayout& layout, const std::string& text, const Vector2& drawMins, float cellHeight)
+{
+	const BitmapFont* font = layout.m_params.m_font;
+	float cellWidth = cellHeight * (font->GetBaseAspect() * layout.m_params.m_aspectScale);
+	float cursor = drawMins.x;
+
+	for(size_t index = 0; index < text.size(); ++index)
+	{
+		const GlyphMetrics& glyph = font->GetGlyphMetrics(text[index]);
+		if(glyph.HasInk())
+		{
+			float glyphMinX = cursor + (glyph.m_bounds.mins.x * cellWidth);
+			float glyphMaxX = cursor + (glyph.m_bounds.maxs.x * cellWidth);
+			float glyphMinY = drawMins.y + (glyph.m_bounds.mins.y * cellHeight);
+			float glyphMaxY = drawMins.y + (glyph.m_bounds.maxs.y * cellHeight);
+			const AABB2& uv = glyph.m_uvs;
+			layout.m_vertices.push_back(Vertex_3DPCU(Vector3(glyphMinX, glyphMinY), Rgba::WHITE, Vector2(uv.mins.x, uv.maxs.y)));
+			layout.m_vertices.push_back(Vertex_3DPCU(Vector3(glyphMaxX, glyphMinY), Rgba::WHITE, Vector2(uv.maxs.x, uv.maxs.y)));
+			layout.m_vertices.push_back(Vertex_3DPCU(Vector3(glyphMinX, glyphMaxY), Rgba::WHITE, Vector2(uv.mins.x, uv.mins.y)));
+			layout.m_vertices.push_back(Vertex_3DPCU(Vector3(glyphMaxX, glyphMaxY), Rgba::WHITE, Vector2(uv.maxs.x, uv.mins.y)));
+		}
+
+		cursor += glyph.m_advance * cellWidth;
+	}
+}
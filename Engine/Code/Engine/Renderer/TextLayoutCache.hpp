@@ -0,0 +1,95 @@
+#pragma once
+#include "Engine/Core/Vertex.hpp"
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Enumerations/WrapMode.hpp"
+#include <map>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class BitmapFont;
+class Texture;
+
+//-----------------------------------------------------------------------------------------------
+// Everything besides the text a layout depends on. Single lines leave the box size at zero
+//
+struct TextLayoutParams
+{
+	bool	operator==( const TextLayoutParams& compare ) const;
+
+	const	BitmapFont*		m_font = nullptr;
+			float			m_cellHeight = 0.f;
+			float			m_aspectScale = 1.f;
+			Vector2			m_boxSize;
+			Vector2			m_alignment;
+			WrapMode		m_wrapMode = OVERRUN;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Glyph quads of a laid out string, relative to where it gets drawn. Four white vertices per
+// glyph in bottom left, bottom right, top left, top right order. Glyphs with empty bounds get no
+// quad, SDF fonts measure the ink so their spaces are skipped while grid fonts fill every cell
+//
+struct TextLayout
+{
+	int		GetGlyphCount() const { return (int) m_vertices.size() / 4; }
+
+	std::string					m_text;
+	TextLayoutParams			m_params;
+	std::vector<Vertex_3DPCU>	m_vertices;
+	uint32_t					m_lastUsedFrame = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Glyph quads of every string drawn from one glyph sheet, indexed so they go out in one draw
+//
+struct TextBatch
+{
+	void	Append( const TextLayout& layout, const Vector2& offset, const Rgba& tint );
+	void	Clear();
+	bool	IsEmpty() const { return m_vertices.empty(); }
+
+	const	Texture*					m_texture = nullptr;
+			bool						m_isSDF = false;
+			std::vector<Vertex_3DPCU>	m_vertices;
+			std::vector<uint32_t>		m_indices;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Laid out strings, so text that doesn't change between frames isn't measured, wrapped and
+// turned into quads again. Layouts nobody asked for in a while are dropped at the end of a frame
+//
+class TextLayoutCache
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	TextLayoutCache() {}
+	~TextLayoutCache();
+	TextLayoutCache( const TextLayoutCache& ) = delete;
+	void operator=( const TextLayoutCache& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int					GetLayoutCount() const { return m_layoutCount; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	const	TextLayout&			CreateOrGetLine( const std::string& text, const BitmapFont* font, float cellHeight, float aspectScale );
+	const	TextLayout&			CreateOrGetBox( const std::string& text, const BitmapFont* font, float cellHeight, float aspectScale, const Vector2& boxSize, const Vector2& alignment, WrapMode wrapMode );
+			void				EndFrame();
+			void				Clear();
+
+private:
+	const	TextLayout&			CreateOrGet( const std::string& text, const TextLayoutParams& params );
+	static	void				BuildBox( TextLayout& layout );
+	static	void				AppendGlyphRun( TextLayout& layout, const std::string& text, const Vector2& drawMins, float cellHeight );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			std::map<uint64_t, std::vector<TextLayout*>>	m_layouts;		// By hash of the text and params, collisions share the bucket
+			uint32_t										m_frameIndex = 0;
+			int												m_layoutCount = 0;
+};
@@ -9,9 +9,11 @@
 #include "Engine/Renderer/Texture.hpp"
 #include "ThirdParty/stb/stb_image.h"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Sampler.hpp"
+#include <vector>
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -79,8 +81,7 @@ void Texture::PopulateFromData( unsigned char* imageData, const IntVector2& texe
 	glGenTextures( 1, (GLuint*) &m_textureID );
 	
 	// Tell OpenGL to bind (set) this as the currently active texture
-	glActiveTexture( GL_TEXTURE0 );
-	glBindTexture( GL_TEXTURE_2D, m_textureID );
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_2D, m_textureID );
 	
 	
 	if( numComponents == 3 )
@@ -120,6 +121,80 @@ void Texture::PopulateFromData( unsigned char* imageData, const IntVector2& texe
 	GL_CHECK_ERROR();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Creates an RGBA8 texture identity with the given mip levels and leaves its contents undefined
+//
+void Texture::AllocateStorage(const IntVector2& texelSize, int mipCount)
+{
+	m_dimensions = texelSize;
+	m_format = TEXTURE_FORMAT_RGBA8;
+	GLenum format;
+	GLenum channels;
+	GLenum pixelLayout;
+	GetGLFormats(&format, &channels, &pixelLayout, m_format);
+
+	glGenTextures( 1, (GLuint*) &m_textureID );
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_2D, m_textureID );
+	glTexStorage2D(GL_TEXTURE_2D, mipCount, format, m_dimensions.x, m_dimensions.y);
+
+	GL_CHECK_ERROR();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes RGBA8 texels into the top mip, offset from the bottom left
+//
+void Texture::UploadRegion(const IntVector2& offset, const IntVector2& texelSize, const unsigned char* rgbaData)
+{
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_2D, m_textureID );
+	glTexSubImage2D( GL_TEXTURE_2D,
+		0,
+		offset.x, offset.y,
+		texelSize.x, texelSize.y,
+		GL_RGBA,
+		GL_UNSIGNED_BYTE,
+		rgbaData);
+
+	GL_CHECK_ERROR();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Zeroes the top mip on the GPU. Without glClearTexImage it uploads zeroed strips, so the scratch
+// stays a few rows no matter how big the texture is
+//
+void Texture::ClearToTransparent()
+{
+	const unsigned char transparent[4] = { 0, 0, 0, 0 };
+	if(glClearTexImage != nullptr)
+	{
+		glClearTexImage(m_textureID, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+	}
+	else
+	{
+		constexpr int CLEAR_STRIP_ROWS = 16;
+		int stripRows = (m_dimensions.y < CLEAR_STRIP_ROWS) ? m_dimensions.y : CLEAR_STRIP_ROWS;
+		std::vector<unsigned char> zeroes(m_dimensions.x * stripRows * 4, 0);
+		for(int y = 0; y < m_dimensions.y; y += stripRows)
+		{
+			int rows = (m_dimensions.y - y < stripRows) ? (m_dimensions.y - y) : stripRows;
+			UploadRegion(IntVector2(0, y), IntVector2(m_dimensions.x, rows), zeroes.data());
+		}
+	}
+
+	GL_CHECK_ERROR();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the lower mips from the top one
+//
+void Texture::GenerateMipMaps()
+{
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_2D, m_textureID );
+	glGenerateMipmap( GL_TEXTURE_2D );
+
+	GL_CHECK_ERROR();
+}
+
 //-----------------------------------------------------------------------------------------------
 // Creates a render target texture with null data
 //
@@ -137,8 +212,8 @@ bool Texture::CreateRenderTarget(unsigned int width, unsigned int height, eTextu
 	}
 
 	// Copy the texture - first, get use to be using texture unit 0 for this; 
-	glActiveTexture( GL_TEXTURE0 ); 
-	glBindTexture( GL_TEXTURE_2D, m_textureID );    // bind our texture to our current texture unit (0)
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindTexture( 0, GL_TEXTURE_2D, m_textureID );    // bind our texture to texture unit 0
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
@@ -155,7 +230,7 @@ bool Texture::CreateRenderTarget(unsigned int width, unsigned int height, eTextu
 		nullptr );     // don't need to pass it initialization data 
 	GL_CHECK_ERROR();
 
-	glBindTexture( GL_TEXTURE_2D, NULL ); // unset it; 
+	glState->BindTexture( 0, GL_TEXTURE_2D, NULL ); // unset it; 
 
 	// Save this all off
 	m_dimensions.x = width;  
@@ -5,6 +5,7 @@
 #include "Engine/Math/IntVector2.hpp"
 #include <string>
 #include <map>
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -25,15 +26,21 @@ enum eTextureFormat
 class Texture
 {
 	friend class Renderer; // Textures are managed by a Renderer instance
-	friend class GIFAnimation; // Manages textures as frames
+	friend class TextureAtlas; // Creates and fills the pages
 
 private:
 	Texture();
 	Texture( const std::string& imageFilePath, Sampler* sampler = nullptr, bool generateMipMap = true ); // Use renderer->CreateOrGetTexture() instead!
 	Texture( const Image& image, Sampler* sampler = nullptr, bool generateMipMap = true );
 	void PopulateFromData( unsigned char* imageData, const IntVector2& texelSize, int numComponents, bool generateMipMap = true );
+	void AllocateStorage( const IntVector2& texelSize, int mipCount );
+	void UploadRegion( const IntVector2& offset, const IntVector2& texelSize, const unsigned char* rgbaData );
+	void ClearToTransparent(); // Top mip only
+	void GenerateMipMaps();
 
 public:
+	MEMORY_TAG_CLASS(MEMORY_TAG_TEXTURE)
+
 			bool			CreateRenderTarget( unsigned int width, unsigned int height, eTextureFormat fmt );
 	static	Texture*		CreateCompatibleTarget( const Texture* src );
 			unsigned int	GetHandle() const { return m_textureID; }
@@ -0,0 +1,65 @@
+#include "Engine/Renderer/TextureArray.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+TextureArray::TextureArray()
+{
+	m_format = TEXTURE_FORMAT_UNKNOWN;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+TextureArray::~TextureArray()
+{
+	Cleanup();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Tidy up the array
+//
+void TextureArray::Cleanup()
+{
+	if (IsValid()) {
+		GLStateCache::ForgetTexture( m_handle );
+		glDeleteTextures( 1, &m_handle );
+		m_handle = NULL; 
+	}
+
+	m_size = 0; 
+	m_layerCount = 0;
+	m_format = TEXTURE_FORMAT_UNKNOWN; 
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates square depth stencil layers to render shadow maps into
+//
+bool TextureArray::CreateDepthTarget(int size, int layerCount)
+{
+	Cleanup();
+
+	glGenTextures( 1, &m_handle ); 
+	if (m_handle == NULL) {
+		return false; 
+	}
+
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindTexture( 0, GL_TEXTURE_2D_ARRAY, m_handle ); 
+
+	// Immutable storage needs a sized format
+	glTexStorage3D( GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH24_STENCIL8, size, size, layerCount ); 
+	GL_CHECK_ERROR(); 
+
+	glState->BindTexture( 0, GL_TEXTURE_2D_ARRAY, NULL ); 
+
+	m_size = size;
+	m_layerCount = layerCount;
+	m_format = TEXTURE_FORMAT_D24S8;
+	return true;
+}
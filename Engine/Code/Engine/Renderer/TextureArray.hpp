@@ -0,0 +1,34 @@
+#pragma once
+#include "Engine/Renderer/Texture.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// 2D texture array, every layer has the same size and format. Layers are rendered to one at a
+// time by attaching them to a framebuffer
+//
+class TextureArray
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	TextureArray();
+	~TextureArray();
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	inline int	GetWidth() const { return m_size; }
+	inline int	GetHeight() const { return m_size; }
+	inline int	GetLayerCount() const { return m_layerCount; }
+	inline bool IsValid() const { return (m_handle != 0); }
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void Cleanup();
+			bool CreateDepthTarget( int size, int layerCount );
+	
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	unsigned int	m_handle = 0;
+	eTextureFormat	m_format;
+	int				m_size = 0;
+	int				m_layerCount = 0;
+};
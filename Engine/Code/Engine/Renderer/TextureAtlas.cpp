@@ -0,0 +1,404 @@
+#include "Engine/Renderer/TextureAtlas.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include <climits>
+#include <string.h>
+
+//-----------------------------------------------------------------------------------------------
+// Constants
+constexpr int TEXTURE_ATLAS_MAX_PAGE_SIZE = 2048; // Past this entries spill onto more pages
+
+//-----------------------------------------------------------------------------------------------
+// Rounds up to the next multiple of the alignment, which is a power of two
+//
+static int AlignUp(int value, int alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// A mip texel covers 2^level texels, keeps the levels whose blocks don't reach past the padding
+//
+static int GetBleedFreeMipCount(int padding)
+{
+	int mipCount = 1;
+	while((1 << mipCount) <= padding)
+	{
+		++mipCount;
+	}
+
+	return mipCount;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Maps a point over the image to the texture
+//
+Vector2 TextureAtlasRegion::MapUV(const Vector2& localUV) const
+{
+	return Vector2(m_uvs.mins.x + localUV.x * (m_uvs.maxs.x - m_uvs.mins.x), m_uvs.mins.y + localUV.y * (m_uvs.maxs.y - m_uvs.mins.y));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Maps both corners, so flipped sprite sheet uvs stay flipped
+//
+AABB2 TextureAtlasRegion::MapUVs(const AABB2& localUVs) const
+{
+	return AABB2(MapUV(localUVs.mins), MapUV(localUVs.maxs));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor. Pages are created as entries need them
+//
+TextureAtlas::TextureAtlas(const TextureAtlasSettings& settings)
+	: m_settings(settings)
+{
+	GUARANTEE_OR_DIE(m_settings.m_padding >= 0, "Texture atlas padding can't be negative");
+
+	m_mipCount = GetBleedFreeMipCount(m_settings.m_padding);
+	m_settings.m_pageSize = AlignUp(m_settings.m_pageSize, GetAlignment());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+TextureAtlas::~TextureAtlas()
+{
+	for(std::map<std::string, TextureAtlasRegion*>::iterator regionIter = m_regions.begin(); regionIter != m_regions.end(); ++regionIter)
+	{
+		delete regionIter->second;
+	}
+	m_regions.clear();
+
+	for(AtlasPage* page : m_pages)
+	{
+		delete page->m_texture;
+		delete page;
+	}
+	m_pages.clear();
+
+	for(Texture* texture : m_ownedTextures)
+	{
+		delete texture;
+	}
+	m_ownedTextures.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the image is small enough to share a page
+//
+bool TextureAtlas::CanPack(const IntVector2& dimensions) const
+{
+	if(dimensions.x <= 0 || dimensions.y <= 0)
+	{
+		return false;
+	}
+
+	int paddedSize = (m_settings.m_padding * 2) + Max(dimensions.x, dimensions.y);
+	return Max(dimensions.x, dimensions.y) <= m_settings.m_maxEntrySize && AlignUp(paddedSize, GetAlignment()) <= m_settings.m_pageSize;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the region added under the name, nullptr if there is none
+//
+const TextureAtlasRegion* TextureAtlas::FindRegion(const std::string& name) const
+{
+	std::map<std::string, TextureAtlasRegion*>::const_iterator regionIter = m_regions.find(name);
+	if(regionIter != m_regions.end())
+	{
+		return regionIter->second;
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Packs the texels, bottom row first, onto the first page with room
+//
+const TextureAtlasRegion* TextureAtlas::AddRegion(const std::string& name, const unsigned char* rgbaTexels, const IntVector2& dimensions)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
+	const TextureAtlasRegion* existing = FindRegion(name);
+	if(existing)
+	{
+		return existing;
+	}
+
+	if(!CanPack(dimensions))
+	{
+		return nullptr;
+	}
+
+	int padding = m_settings.m_padding;
+	IntVector2 paddedSize(dimensions.x + (padding * 2), dimensions.y + (padding * 2));
+	IntVector2 reservedSize(AlignUp(paddedSize.x, GetAlignment()), AlignUp(paddedSize.y, GetAlignment()));
+
+	AtlasPage* page = nullptr;
+	IntVector2 position;
+	for(AtlasPage* candidate : m_pages)
+	{
+		if(FindPosition(*candidate, reservedSize, position))
+		{
+			page = candidate;
+			break;
+		}
+	}
+
+	if(!page)
+	{
+		page = CreatePage();
+		FindPosition(*page, reservedSize, position);
+	}
+
+	InsertNode(*page, position, reservedSize);
+
+	// Replicate the edge texels into the padding so filtering past the edge reads the edge
+	m_paddedTexels.resize(paddedSize.x * paddedSize.y * 4);
+	for(int y = 0; y < paddedSize.y; ++y)
+	{
+		int sourceY = ClampInt(y - padding, 0, dimensions.y - 1);
+		for(int x = 0; x < paddedSize.x; ++x)
+		{
+			int sourceX = ClampInt(x - padding, 0, dimensions.x - 1);
+			memcpy(&m_paddedTexels[(y * paddedSize.x + x) * 4], &rgbaTexels[(sourceY * dimensions.x + sourceX) * 4], 4);
+		}
+	}
+
+	page->m_texture->UploadRegion(position, paddedSize, m_paddedTexels.data());
+	page->m_areMipsDirty = true;
+
+	float pageSize = (float) m_settings.m_pageSize;
+	TextureAtlasRegion* region = new TextureAtlasRegion();
+	region->m_texture = page->m_texture;
+	region->m_dimensions = dimensions;
+	region->m_uvs.mins = Vector2((float) (position.x + padding) / pageSize, (float) (position.y + padding) / pageSize);
+	region->m_uvs.maxs = Vector2((float) (position.x + padding + dimensions.x) / pageSize, (float) (position.y + padding + dimensions.y) / pageSize);
+	m_regions[name] = region;
+	return region;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Registers a texture that didn't fit as a region covering all of it, so callers handle both
+// the same way
+//
+const TextureAtlasRegion* TextureAtlas::AddWholeTexture(const std::string& name, const Texture* texture)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
+	const TextureAtlasRegion* existing = FindRegion(name);
+	if(existing)
+	{
+		return existing;
+	}
+
+	TextureAtlasRegion* region = new TextureAtlasRegion();
+	region->m_texture = texture;
+	region->m_dimensions = texture->GetDimensions();
+	m_regions[name] = region;
+	return region;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Uploads an image that can't be packed to a texture of its own, freed with the atlas
+//
+const TextureAtlasRegion* TextureAtlas::AddWholeTexture(const std::string& name, const unsigned char* rgbaTexels, const IntVector2& dimensions)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
+	const TextureAtlasRegion* existing = FindRegion(name);
+	if(existing)
+	{
+		return existing;
+	}
+
+	Texture* texture = new Texture();
+	texture->AllocateStorage(dimensions, CalculateMipCount(Max(dimensions.x, dimensions.y)));
+	texture->UploadRegion(IntVector2(0, 0), dimensions, rgbaTexels);
+	texture->GenerateMipMaps();
+	m_ownedTextures.push_back(texture);
+
+	return AddWholeTexture(name, texture);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Regenerates the mips of the pages written to since the last call
+//
+void TextureAtlas::UpdateMips()
+{
+	if(m_mipCount == 1)
+	{
+		return;
+	}
+
+	for(AtlasPage* page : m_pages)
+	{
+		if(page->m_areMipsDirty)
+		{
+			page->m_texture->GenerateMipMaps();
+			page->m_areMipsDirty = false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the smallest power of two page holding the entries in a grid. It stops at 2048, the
+// entries that don't fit go on more pages of that size
+//
+STATIC int TextureAtlas::CalculatePageSize(const IntVector2& entryDimensions, int entryCount, int padding)
+{
+	int pageSize = 64;
+	int alignment = 1 << (GetBleedFreeMipCount(padding) - 1);
+	IntVector2 cellSize(AlignUp(entryDimensions.x + (padding * 2), alignment), AlignUp(entryDimensions.y + (padding * 2), alignment));
+	while(pageSize < TEXTURE_ATLAS_MAX_PAGE_SIZE)
+	{
+		int columns = pageSize / cellSize.x;
+		int rows = pageSize / cellSize.y;
+		if(columns * rows >= entryCount)
+		{
+			break;
+		}
+		pageSize *= 2;
+	}
+
+	return pageSize;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates an empty page with a flat skyline across its bottom
+//
+TextureAtlas::AtlasPage* TextureAtlas::CreatePage()
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
+	IntVector2 pageDimensions(m_settings.m_pageSize, m_settings.m_pageSize);
+
+	AtlasPage* page = new AtlasPage();
+	page->m_texture = new Texture();
+	page->m_texture->AllocateStorage(pageDimensions, m_mipCount);
+
+	// Storage starts undefined, clear it so unused space samples as transparent
+	page->m_texture->ClearToTransparent();
+
+	page->m_skyline.push_back({ 0, 0, m_settings.m_pageSize });
+	m_pages.push_back(page);
+	return page;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Picks the node that leaves the lowest top edge, ties go to the narrower node
+//
+bool TextureAtlas::FindPosition(const AtlasPage& page, const IntVector2& size, IntVector2& out_position) const
+{
+	int bestTop = INT_MAX;
+	int bestWidth = INT_MAX;
+	bool isFound = false;
+
+	for(int nodeIndex = 0; nodeIndex < (int) page.m_skyline.size(); ++nodeIndex)
+	{
+		int y = 0;
+		if(!FitAtNode(page, nodeIndex, size, y))
+		{
+			continue;
+		}
+
+		const SkylineNode& node = page.m_skyline[nodeIndex];
+		int top = y + size.y;
+		if(top < bestTop || (top == bestTop && node.m_width < bestWidth))
+		{
+			bestTop = top;
+			bestWidth = node.m_width;
+			out_position = IntVector2(node.m_x, y);
+			isFound = true;
+		}
+	}
+
+	return isFound;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the rect fits with its left edge on the node, resting on the highest node
+// it spans
+//
+bool TextureAtlas::FitAtNode(const AtlasPage& page, int nodeIndex, const IntVector2& size, int& out_y) const
+{
+	int x = page.m_skyline[nodeIndex].m_x;
+	if(x + size.x > m_settings.m_pageSize)
+	{
+		return false;
+	}
+
+	int widthLeft = size.x;
+	out_y = page.m_skyline[nodeIndex].m_y;
+	while(widthLeft > 0)
+	{
+		out_y = Max(out_y, page.m_skyline[nodeIndex].m_y);
+		if(out_y + size.y > m_settings.m_pageSize)
+		{
+			return false;
+		}
+
+		widthLeft -= page.m_skyline[nodeIndex].m_width;
+		++nodeIndex;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Raises the skyline over the placed rect, trims the nodes it covers and merges level neighbours
+//
+void TextureAtlas::InsertNode(AtlasPage& page, const IntVector2& position, const IntVector2& size)
+{
+	std::vector<SkylineNode>& skyline = page.m_skyline;
+
+	int nodeIndex = 0;
+	while(skyline[nodeIndex].m_x != position.x)
+	{
+		++nodeIndex;
+	}
+
+	skyline.insert(skyline.begin() + nodeIndex, { position.x, position.y + size.y, size.x });
+
+	int nextIndex = nodeIndex + 1;
+	while(nextIndex < (int) skyline.size())
+	{
+		const SkylineNode& previous = skyline[nextIndex - 1];
+		SkylineNode& node = skyline[nextIndex];
+		int overlap = (previous.m_x + previous.m_width) - node.m_x;
+		if(overlap <= 0)
+		{
+			break;
+		}
+
+		node.m_x += overlap;
+		node.m_width -= overlap;
+		if(node.m_width > 0)
+		{
+			break;
+		}
+
+		skyline.erase(skyline.begin() + nextIndex);
+	}
+
+	for(int mergeIndex = 0; mergeIndex + 1 < (int) skyline.size();)
+	{
+		if(skyline[mergeIndex].m_y == skyline[mergeIndex + 1].m_y)
+		{
+			skyline[mergeIndex].m_width += skyline[mergeIndex + 1].m_width;
+			skyline.erase(skyline.begin() + mergeIndex + 1);
+		}
+		else
+		{
+			++mergeIndex;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Entries start and end on multiples of the coarsest mip texel
+//
+int TextureAtlas::GetAlignment() const
+{
+	return 1 << (m_mipCount - 1);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class Texture;
+
+//-----------------------------------------------------------------------------------------------
+// How pages are sized and what fits on them
+//
+struct TextureAtlasSettings
+{
+	int		m_pageSize = 1024;		// Pages are square
+	int		m_maxEntrySize = 256;	// Larger images are not packed
+	int		m_padding = 4;			// Edge texels replicated around each entry, also limits the page mips
+};
+
+//-----------------------------------------------------------------------------------------------
+// Where an image ended up. m_uvs go from the bottom left to the top right of the image in the
+// texture, which is the whole texture when the image was too big to pack
+//
+struct TextureAtlasRegion
+{
+	const	Texture*	m_texture = nullptr;
+			AABB2		m_uvs = AABB2(0.f, 0.f, 1.f, 1.f);
+			IntVector2	m_dimensions;
+
+			Vector2		MapUV( const Vector2& localUV ) const;		// From 0-1 over the image to the texture
+			AABB2		MapUVs( const AABB2& localUVs ) const;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Packs small images into shared pages with a bottom left skyline so they can be drawn without
+// rebinding. Each entry is surrounded by copies of its edge texels and aligned so the bleed
+// stays out of every mip the page keeps. Pages regenerate their mips in UpdateMips
+//
+class TextureAtlas
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	explicit TextureAtlas( const TextureAtlasSettings& settings = TextureAtlasSettings() );
+	~TextureAtlas();
+	TextureAtlas( const TextureAtlas& ) = delete;
+	void operator=( const TextureAtlas& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool						CanPack( const IntVector2& dimensions ) const;
+	const	TextureAtlasRegion*			FindRegion( const std::string& name ) const;
+			int							GetPageCount() const { return (int) m_pages.size(); }
+	const	Texture*					GetPage( int pageIndex ) const { return m_pages[pageIndex]->m_texture; }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	const	TextureAtlasRegion*			AddRegion( const std::string& name, const unsigned char* rgbaTexels, const IntVector2& dimensions ); // Returns nullptr if it can't be packed
+	const	TextureAtlasRegion*			AddWholeTexture( const std::string& name, const Texture* texture ); // The caller keeps owning the texture
+	const	TextureAtlasRegion*			AddWholeTexture( const std::string& name, const unsigned char* rgbaTexels, const IntVector2& dimensions ); // Makes a texture the atlas owns
+			void						UpdateMips();
+
+	static	int							CalculatePageSize( const IntVector2& entryDimensions, int entryCount, int padding ); // Smallest power of two page that fits them all, up to 2048
+
+private:
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	struct SkylineNode
+	{
+		int		m_x;
+		int		m_y;
+		int		m_width;
+	};
+
+	struct AtlasPage
+	{
+		Texture*					m_texture = nullptr;
+		std::vector<SkylineNode>	m_skyline;
+		bool						m_areMipsDirty = false;
+	};
+
+			AtlasPage*					CreatePage();
+			bool						FindPosition( const AtlasPage& page, const IntVector2& size, IntVector2& out_position ) const;
+			bool						FitAtNode( const AtlasPage& page, int nodeIndex, const IntVector2& size, int& out_y ) const;
+			void						InsertNode( AtlasPage& page, const IntVector2& position, const IntVector2& size );
+			int							GetAlignment() const;
+
+			TextureAtlasSettings						m_settings;
+			int											m_mipCount = 1;
+			std::vector<AtlasPage*>						m_pages;
+			std::map<std::string, TextureAtlasRegion*>	m_regions;
+			std::vector<Texture*>						m_ownedTextures;	// Made by AddWholeTexture for images that didn't fit
+			std::vector<unsigned char>					m_paddedTexels;		// Scratch for the entry with its bleed
+};
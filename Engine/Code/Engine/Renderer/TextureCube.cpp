@@ -4,6 +4,7 @@
 #include "Engine/Core/Image.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 //-----------------------------------------------------------------------------------------------
 
@@ -82,6 +83,7 @@ TextureCube::~TextureCube()
 void TextureCube::Cleanup()
 {
 	if (IsValid()) {
+		GLStateCache::ForgetTexture( m_handle );
 		glDeleteTextures( 1, &m_handle );
 		m_handle = NULL; 
 	}
@@ -108,7 +110,7 @@ bool TextureCube::MakeFromImages(const Image* images)
 	GetGLFormats(&internal_format, &channels, &pixel_layout, m_format);
 
 	// bind it; 
-	glBindTexture( GL_TEXTURE_CUBE_MAP, m_handle ); 
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_CUBE_MAP, m_handle ); 
 
 	glTexStorage2D( GL_TEXTURE_CUBE_MAP, 1, internal_format, m_size, m_size ); 
 	glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 ); 
@@ -146,7 +148,7 @@ bool TextureCube::MakeFromImage(const Image& image)
 	GetGLFormats( &internal_format, &channels, &pixel_layout, m_format ); 
 
 	// bind it; 
-	glBindTexture( GL_TEXTURE_CUBE_MAP, m_handle ); 
+	GLStateCache::GetInstance()->BindTexture( 0, GL_TEXTURE_CUBE_MAP, m_handle ); 
 	glTexStorage2D( GL_TEXTURE_CUBE_MAP, 1, internal_format, m_size, m_size ); 
 	GL_CHECK_ERROR(); 
 
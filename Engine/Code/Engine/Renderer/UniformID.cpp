@@ -0,0 +1,60 @@
+#include "Engine/Renderer/UniformID.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <map>
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Name to ID table, a function static so IDs can be made during static initialization
+//
+static std::map<std::string, UniformID>& GetUniformIDTable()
+{
+	static std::map<std::string, UniformID> s_ids;
+	return s_ids;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Names indexed by ID
+//
+static std::vector<std::string>& GetUniformNameTable()
+{
+	static std::vector<std::string> s_names;
+	return s_names;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the ID of the uniform name, the first call with a name gives it the next free ID
+//
+UniformID GetUniformID(const char* name)
+{
+	std::map<std::string, UniformID>& ids = GetUniformIDTable();
+	std::map<std::string, UniformID>::const_iterator found = ids.find(name);
+	if(found != ids.end())
+	{
+		return found->second;
+	}
+
+	MEMORY_TAG_SCOPE(MEMORY_TAG_SHADER);
+	std::vector<std::string>& names = GetUniformNameTable();
+	UniformID id = (UniformID) names.size();
+	names.push_back(name);
+	ids[name] = id;
+	return id;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the name the ID was made from
+//
+const std::string& GetUniformName(UniformID id)
+{
+	const std::vector<std::string>& names = GetUniformNameTable();
+	GUARANTEE_OR_DIE(id < names.size(), "Unknown uniform ID");
+	return names[id];
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+
+//-----------------------------------------------------------------------------------------------
+// Interned uniform name. IDs are small and dense, so shader programs can keep their uniform
+// locations in a table indexed by them
+typedef uint32_t UniformID;
+constexpr UniformID INVALID_UNIFORM_ID = UINT32_MAX;
+
+//-----------------------------------------------------------------------------------------------
+// Standalone functions, main thread only
+UniformID			GetUniformID( const char* name ); // Interns the name on first use
+const std::string&	GetUniformName( UniformID id );
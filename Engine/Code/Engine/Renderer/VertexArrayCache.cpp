@@ -0,0 +1,109 @@
+#include "Engine/Renderer/VertexArrayCache.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/Renderer/GLFunctions.hpp"
+#include "Engine/Renderer/GLStateCache.hpp"
+#include "Engine/Renderer/ShaderProgram.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Vertex.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static uint32_t s_vertexArrayGeneration = 0;	// Bumped by InvalidateAll
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+VertexArrayCache::~VertexArrayCache()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertex array for the program's inputs, building it on first use. Entries whose
+// buffers were recreated are rebuilt in place
+//
+GLuint VertexArrayCache::GetOrCreate(const ShaderProgram& program, GLuint vbo, GLuint ibo, const VertexLayout& layout)
+{
+	if(m_generation != s_vertexArrayGeneration)
+	{
+		Clear();
+		m_generation = s_vertexArrayGeneration;
+	}
+
+	uint32_t inputID = program.GetVertexInputID();
+	VertexArrayEntry* entry = nullptr;
+	for(size_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+	{
+		if(m_entries[entryIndex].m_inputID == inputID && m_entries[entryIndex].m_layout == &layout)
+		{
+			entry = &m_entries[entryIndex];
+			break;
+		}
+	}
+
+	if(entry != nullptr && entry->m_vbo == vbo && entry->m_ibo == ibo)
+	{
+		return entry->m_vao;
+	}
+
+	if(entry == nullptr)
+	{
+		VertexArrayEntry newEntry = { inputID, &layout, 0, 0, 0 };
+		glGenVertexArrays(1, &newEntry.m_vao);
+		m_entries.push_back(newEntry);
+		entry = &m_entries.back();
+	}
+	entry->m_vbo = vbo;
+	entry->m_ibo = ibo;
+
+	// The element array binding and the attribute pointers are recorded into the vertex array
+	GLStateCache* glState = GLStateCache::GetInstance();
+	glState->BindVertexArray(entry->m_vao);
+	glState->BindBuffer(GL_ARRAY_BUFFER, vbo);
+	glState->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+
+	GLuint programHandle = program.GetHandle();
+	const Renderer* renderer = Renderer::GetInstance();
+	for(int attribIndex = 0; attribIndex < (int) layout.m_attributes.size(); ++attribIndex)
+	{
+		const VertexAttribute* attrib = layout.GetAttribute(attribIndex);
+		GLint bind = glGetAttribLocation(programHandle, attrib->m_handle);
+		if(bind >= 0)
+		{
+			glEnableVertexAttribArray(bind);
+			glVertexAttribPointer(bind,				// Where?
+				attrib->m_elementCount,				// How many ?
+				renderer->GetGLDataType(attrib->m_type),	// What's the data type?
+				attrib->m_isNormalized,				// Should the data be normalized?
+				layout.m_stride,					// How much space between each vertex
+				(GLvoid*) attrib->m_memberOffset);	// How far away is the needed data from the start of each?
+		}
+	}
+	GL_CHECK_ERROR();
+
+	return entry->m_vao;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Deletes every vertex array of the cache
+//
+void VertexArrayCache::Clear()
+{
+	for(size_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+	{
+		GLStateCache::ForgetVertexArray(m_entries[entryIndex].m_vao);
+		glDeleteVertexArrays(1, &m_entries[entryIndex].m_vao);
+	}
+
+	m_entries.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Makes every cache drop its vertex arrays the next time it is used
+//
+STATIC void VertexArrayCache::InvalidateAll()
+{
+	++s_vertexArrayGeneration;
+}
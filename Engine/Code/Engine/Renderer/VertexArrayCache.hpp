@@ -0,0 +1,53 @@
+#pragma once
+#include "Engine/Renderer/External/GL/glcorearb.h"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class ShaderProgram;
+struct VertexLayout;
+
+//-----------------------------------------------------------------------------------------------
+// One vertex array and everything it was built from
+//
+struct VertexArrayEntry
+{
+	uint32_t				m_inputID;		// ShaderProgram::GetVertexInputID
+	const VertexLayout*		m_layout;
+	GLuint					m_vbo;
+	GLuint					m_ibo;
+	GLuint					m_vao;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Vertex arrays of one set of buffers, built the first time a program with a new set of vertex
+// inputs draws from them. Programs sharing their attribute locations share the vertex array, so
+// there are only a few entries and a draw is a single bind. Owned by whatever owns the buffers
+//
+class VertexArrayCache
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	VertexArrayCache() {}
+	~VertexArrayCache();
+	VertexArrayCache( const VertexArrayCache& ) = delete;
+	void operator=( const VertexArrayCache& ) = delete;
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			int				GetCount() const { return (int) m_entries.size(); }
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			GLuint			GetOrCreate( const ShaderProgram& program, GLuint vbo, GLuint ibo, const VertexLayout& layout );
+			void			Clear(); // Deletes the vertex arrays, for when the buffers or layout change
+	static	void			InvalidateAll(); // Every cache clears itself on its next use, for shader reloads
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+private:
+			std::vector<VertexArrayEntry>	m_entries;
+			uint32_t						m_generation = 0;
+};
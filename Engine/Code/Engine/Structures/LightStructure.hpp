@@ -23,7 +23,7 @@ struct LightStructure
 	Vector3 specAttenuation; 
 	float dotOuterAngle;
 
-	Vector3 padding;
+	Vector3 shadowAtlasTile; // xy = uv offset, z = uv scale of the light's tile in the shadow atlas, -1 when using the cascades
 	float isShadowCasting = 0.f;
 
 	Matrix44 shadowVP;
@@ -2,10 +2,12 @@
 #include "Engine/Structures/LightStructure.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include <cstdint>
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
-constexpr int MAX_LIGHTS = 8;
+constexpr int MAX_LIGHTS = 8; // Per draw lights for the non clustered shaders
+constexpr int MAX_SHADOW_CASCADES = 4;
 
 //-----------------------------------------------------------------------------------------------
 struct LightBlock
@@ -23,11 +25,49 @@ struct SpecularBlock
 };
 
 //-----------------------------------------------------------------------------------------------
+// std140, updated when the current camera's data changes
 struct CameraBlock
 {
 	Matrix44 view;
 	Matrix44 projection;
-// 	Vector3	 cameraPos;
-// 	float	 padding;
+	Vector3	 eyePosition;
+	float	 padding = 0.f;
 };
 
+//-----------------------------------------------------------------------------------------------
+// std140, updated once per frame
+struct FrameBlock
+{
+	float	 gameTime = 0.f;
+	float	 gameDeltaTime = 0.f;
+	int		 renderMode = 0;
+	float	 padding = 0.f;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Read by the clustered lighting shaders along with the storage buffers
+struct LightClusterBlock
+{
+	uint32_t dimensions[4];		// x, y and z cluster counts, w is the number of global lights
+	Vector4	 depthParams;		// near, far, slice scale, slice bias (slice = log(viewZ) * scale + bias)
+	Vector4	 viewport;			// x, y, width, height in pixels
+	Vector4	 viewZRow;			// Row of the view matrix that gives view space depth
+};
+
+//-----------------------------------------------------------------------------------------------
+// Offset and count into the light index list
+struct LightCluster
+{
+	uint32_t offset = 0;
+	uint32_t count = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Cascaded shadow map of the main directional light
+struct ShadowCascadeBlock
+{
+	Matrix44 viewProjections[MAX_SHADOW_CASCADES];
+	Vector4	 splitDepths;		// View space depth where each cascade ends
+	Vector4	 info;				// x = cascade count, y = texel size in uv
+	Vector4	 viewZRow;			// Row of the camera's view matrix that gives view space depth
+};
@@ -4,6 +4,8 @@
 #include "Engine/VulkanRenderer/VKRenderer.hpp"
 #include "Engine/VulkanRenderer/VKFunctions.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -35,6 +37,7 @@ VKIndexBuffer::~VKIndexBuffer()
 //
 bool VKIndexBuffer::CopyToGPU(size_t byteCount, const void* data)
 {
+	PROFILE_SCOPE_FUNCTION();
 	if(byteCount == 0)
 		return true;
 
@@ -65,6 +68,7 @@ bool VKIndexBuffer::CopyToGPU(size_t byteCount, const void* data)
 
 	// Destroy the temporary staging buffer
 	vkDestroyBuffer((VkDevice) m_logicalDevice, stagingBuffer, nullptr);
+	MemoryTracker::TrackDeviceFree((uint64_t) stagingMemory);
 	vkFreeMemory((VkDevice) m_logicalDevice, stagingMemory, nullptr);
 
 	return true;
@@ -4,6 +4,7 @@
 #include "Engine/VulkanRenderer/VKFunctions.hpp"
 #include "Engine/VulkanRenderer/VKRenderer.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -36,6 +37,7 @@ void VKRenderBuffer::Cleanup()
 		vkDestroyBuffer((VkDevice)m_logicalDevice, (VkBuffer)m_bufferHandle, nullptr);
 		m_bufferHandle = VK_NULL_HANDLE;
 
+		MemoryTracker::TrackDeviceFree((uint64_t) (VkDeviceMemory) m_deviceMemoryHandle);
 		vkFreeMemory((VkDevice)m_logicalDevice, (VkDeviceMemory)m_deviceMemoryHandle, nullptr);
 	}
 }
@@ -29,8 +29,8 @@ public:
 	size_t		m_bufferSize = 0;
 	void*		m_physicalDevice;
 	void*		m_logicalDevice;
-	void*		m_bufferHandle;
-	void*		m_deviceMemoryHandle;
+	void*		m_bufferHandle = nullptr;
+	void*		m_deviceMemoryHandle = nullptr;
 };
 
 
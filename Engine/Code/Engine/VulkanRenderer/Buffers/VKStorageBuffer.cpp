@@ -0,0 +1,86 @@
+#include "Engine/VulkanRenderer/Buffers/VKStorageBuffer.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/VulkanRenderer/VKRenderer.hpp"
+#include "Engine/VulkanRenderer/VKFunctions.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <memory.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Usage flags of every storage buffer
+static const VkBufferUsageFlags STORAGE_BUFFER_USAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+VKStorageBuffer::VKStorageBuffer(VKRenderer* renderer)
+	: VKRenderBuffer(renderer->GetLogicalDevice(), renderer->GetPhysicalDevice())
+{
+
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+VKStorageBuffer::~VKStorageBuffer()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the device buffer, the old one is destroyed if the size changed
+//
+void VKStorageBuffer::Create(size_t byteCount)
+{
+	GUARANTEE_OR_DIE(byteCount > 0, "Bad byteCount. Cannot allocate memory");
+
+	if(m_bufferHandle != VK_NULL_HANDLE && byteCount == m_bufferSize)
+	{
+		return;
+	}
+
+	Cleanup();
+	VKRenderer::GetInstance()->CreateAndGetBuffer((VkBuffer*) &m_bufferHandle, (VkDeviceMemory*) &m_deviceMemoryHandle, byteCount, STORAGE_BUFFER_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	m_bufferSize = byteCount;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies data to GPU through a staging buffer
+//
+bool VKStorageBuffer::CopyToGPU(size_t byteCount, const void* data)
+{
+	PROFILE_SCOPE_FUNCTION();
+	if(byteCount == 0)
+		return true;
+
+	Create(byteCount);
+
+	VKRenderer* rend = VKRenderer::GetInstance();
+
+	// Create a low-performance staging buffer to copy data from CPU -> GPU
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingMemory;
+	rend->CreateAndGetBuffer(&stagingBuffer, &stagingMemory, byteCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	// Copy data to staging buffer
+	void* mappedMemHandle;
+	vkMapMemory((VkDevice) m_logicalDevice, stagingMemory, 0, byteCount, 0, &mappedMemHandle);
+	memcpy(mappedMemHandle, data, byteCount);
+	vkUnmapMemory((VkDevice) m_logicalDevice, stagingMemory);
+
+	// Copy staging buffer to storage buffer
+	rend->CopyBuffers((VkBuffer) m_bufferHandle, stagingBuffer, byteCount);
+
+	// Destroy the temporary staging buffer
+	vkDestroyBuffer((VkDevice) m_logicalDevice, stagingBuffer, nullptr);
+	MemoryTracker::TrackDeviceFree((uint64_t) stagingMemory);
+	vkFreeMemory((VkDevice) m_logicalDevice, stagingMemory, nullptr);
+
+	return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Engine/VulkanRenderer/Buffers/VKRenderBuffer.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class VKRenderer;
+
+//-----------------------------------------------------------------------------------------------
+// Device local buffer that shaders read and write. Can also be the source of indirect draw and
+// dispatch arguments
+//
+class VKStorageBuffer : public VKRenderBuffer
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	VKStorageBuffer( VKRenderer* renderer );
+	~VKStorageBuffer();
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void		Create( size_t byteCount ); // Allocates without uploading, contents are undefined
+	virtual	bool		CopyToGPU( size_t byteCount, const void* data ) override; 
+};
+
@@ -4,6 +4,7 @@
 #include "Engine/VulkanRenderer/VkRenderer.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/VulkanRenderer/VKFunctions.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -59,6 +60,7 @@ void VKUniformBuffer::SetCPUData(size_t byteSize, const void* data)
 //
 void VKUniformBuffer::UpdateGPU()
 {
+	PROFILE_SCOPE_FUNCTION();
 	if(m_isDirty)
 	{
 		CopyToGPU(m_cpuByteSize, m_cpuBuffer);
@@ -80,6 +82,7 @@ void VKUniformBuffer::SetGPUData(size_t byte_size, const void* data)
 //
 bool VKUniformBuffer::CopyToGPU(size_t byteCount, const void* data)
 {
+	PROFILE_SCOPE_FUNCTION();
 	if(byteCount == 0)
 		return true;
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Structures/DrawInstruction.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -15,6 +16,8 @@ class MeshBuilder;
 class VKMesh
 {
 public:
+	MEMORY_TAG_CLASS(MEMORY_TAG_MESH)
+
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	VKMesh( VKRenderer* renderer );
@@ -213,6 +213,25 @@ void VKCamera::RotateByEuler(const Vector3& rotation)
 	SetViewMatrix(Matrix44::Invert(temp));
 }
 
+//-----------------------------------------------------------------------------------------------
+// Rotates the camera in local space, the transform keeps a quaternion from then on
+//
+void VKCamera::Rotate(const Quaternion& rotation)
+{
+	m_transform->Rotate(rotation);
+	Matrix44 temp = m_transform->GetWorldMatrix();
+	SetViewMatrix(Matrix44::Invert(temp));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches the camera's rotation between euler angles and a quaternion. With a quaternion
+// RotateByEuler yaws around the up axis and pitches around the camera's right
+//
+void VKCamera::SetUsesQuaternion(bool usesQuaternion)
+{
+	m_transform->SetUsesQuaternion(usesQuaternion);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Finalizes the framebuffer
 //
@@ -7,6 +7,7 @@
 class TextureCube;
 class VKFramebuffer;
 class Material;
+class Quaternion;
 class Transform;
 class VKRenderer;
 class VKTexture;
@@ -46,12 +47,14 @@ public:
 			AABB2			GetViewportExtents() const { return m_viewport; }
 			bool			IsSkyBoxValid() const { return m_usesSkybox; }
 	const	TextureCube*	GetSkyBoxTexture() const { return m_skybox; }
+			void			SetUsesQuaternion( bool usesQuaternion );
 			void*			GetRenderPass() const; 
 	
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 			void			Translate( const Vector3& offset );
 			void			RotateByEuler( const Vector3& rotation );
+			void			Rotate( const Quaternion& rotation );
 			void			Finalize(); // Internally calls finalize on the framebuffer
 			void			UpdateMatrices();
 	
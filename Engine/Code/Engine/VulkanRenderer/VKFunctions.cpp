@@ -76,6 +76,7 @@ PFN_vkDestroyDebugReportCallbackEXT				vkDestroyDebugReportCallbackEXT = nullptr
 PFN_vkGetDeviceProcAddr							vkGetDeviceProcAddr = nullptr;
 PFN_vkEnumeratePhysicalDevices					vkEnumeratePhysicalDevices = nullptr;
 PFN_vkGetPhysicalDeviceProperties				vkGetPhysicalDeviceProperties = nullptr;
+PFN_vkGetPhysicalDeviceFeatures					vkGetPhysicalDeviceFeatures = nullptr;
 PFN_vkGetPhysicalDeviceQueueFamilyProperties	vkGetPhysicalDeviceQueueFamilyProperties = nullptr;
 PFN_vkDestroyInstance							vkDestroyInstance = nullptr;
 PFN_vkCreateDevice								vkCreateDevice = nullptr;
@@ -143,6 +144,7 @@ PFN_vkCmdDrawIndexed							vkCmdDrawIndexed = nullptr;
 PFN_vkCreateImage								vkCreateImage = nullptr;
 PFN_vkBindImageMemory							vkBindImageMemory = nullptr;
 PFN_vkCmdCopyBufferToImage						vkCmdCopyBufferToImage = nullptr;
+PFN_vkCmdCopyImageToBuffer						vkCmdCopyImageToBuffer = nullptr;
 PFN_vkCmdPipelineBarrier						vkCmdPipelineBarrier = nullptr;
 PFN_vkGetImageMemoryRequirements				vkGetImageMemoryRequirements = nullptr;
 PFN_vkDestroyImage								vkDestroyImage = nullptr;
@@ -156,6 +158,19 @@ PFN_vkAllocateDescriptorSets					vkAllocateDescriptorSets = nullptr;
 PFN_vkUpdateDescriptorSets						vkUpdateDescriptorSets = nullptr;
 PFN_vkCmdBindDescriptorSets						vkCmdBindDescriptorSets = nullptr;
 PFN_vkCmdCopyImage								vkCmdCopyImage = nullptr;
+PFN_vkCreateComputePipelines					vkCreateComputePipelines = nullptr;
+PFN_vkCmdDispatch								vkCmdDispatch = nullptr;
+PFN_vkCmdDispatchIndirect						vkCmdDispatchIndirect = nullptr;
+PFN_vkCmdDrawIndirect							vkCmdDrawIndirect = nullptr;
+PFN_vkCmdPushConstants							vkCmdPushConstants = nullptr;
+PFN_vkCmdFillBuffer								vkCmdFillBuffer = nullptr;
+PFN_vkCreateQueryPool							vkCreateQueryPool = nullptr;
+PFN_vkDestroyQueryPool							vkDestroyQueryPool = nullptr;
+PFN_vkGetQueryPoolResults						vkGetQueryPoolResults = nullptr;
+PFN_vkCmdResetQueryPool							vkCmdResetQueryPool = nullptr;
+PFN_vkCmdWriteTimestamp							vkCmdWriteTimestamp = nullptr;
+PFN_vkCmdBeginQuery								vkCmdBeginQuery = nullptr;
+PFN_vkCmdEndQuery								vkCmdEndQuery = nullptr;
 									
 //-----------------------------------------------------------------------------------------------
 // Loads the vulkan library 
@@ -235,6 +250,7 @@ void LoadDeviceVkFunctions(void* vkDevice)
 	VK_DEVICE_BIND(vkDevice, vkCreateImage);
 	VK_DEVICE_BIND(vkDevice, vkBindImageMemory);
 	VK_DEVICE_BIND(vkDevice, vkCmdCopyBufferToImage);
+	VK_DEVICE_BIND(vkDevice, vkCmdCopyImageToBuffer);
 	VK_DEVICE_BIND(vkDevice, vkCmdPipelineBarrier);
 	VK_DEVICE_BIND(vkDevice, vkGetImageMemoryRequirements);
 	VK_DEVICE_BIND(vkDevice, vkDestroyImage);
@@ -248,6 +264,19 @@ void LoadDeviceVkFunctions(void* vkDevice)
 	VK_DEVICE_BIND(vkDevice, vkUpdateDescriptorSets);
 	VK_DEVICE_BIND(vkDevice, vkCmdBindDescriptorSets);
 	VK_DEVICE_BIND(vkDevice, vkCmdCopyImage);
+	VK_DEVICE_BIND(vkDevice, vkCreateComputePipelines);
+	VK_DEVICE_BIND(vkDevice, vkCmdDispatch);
+	VK_DEVICE_BIND(vkDevice, vkCmdDispatchIndirect);
+	VK_DEVICE_BIND(vkDevice, vkCmdDrawIndirect);
+	VK_DEVICE_BIND(vkDevice, vkCmdPushConstants);
+	VK_DEVICE_BIND(vkDevice, vkCmdFillBuffer);
+	VK_DEVICE_BIND(vkDevice, vkCreateQueryPool);
+	VK_DEVICE_BIND(vkDevice, vkDestroyQueryPool);
+	VK_DEVICE_BIND(vkDevice, vkGetQueryPoolResults);
+	VK_DEVICE_BIND(vkDevice, vkCmdResetQueryPool);
+	VK_DEVICE_BIND(vkDevice, vkCmdWriteTimestamp);
+	VK_DEVICE_BIND(vkDevice, vkCmdBeginQuery);
+	VK_DEVICE_BIND(vkDevice, vkCmdEndQuery);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -258,6 +287,7 @@ void LoadInstanceVkFunctions(void* vkInstance)
 	VK_INSTANCE_BIND(vkInstance, vkCreateDebugReportCallbackEXT);
 	VK_INSTANCE_BIND(vkInstance, vkDestroyDebugReportCallbackEXT);
 	VK_INSTANCE_BIND(vkInstance, vkGetPhysicalDeviceProperties);
+	VK_INSTANCE_BIND(vkInstance, vkGetPhysicalDeviceFeatures);
 	VK_INSTANCE_BIND(vkInstance, vkGetPhysicalDeviceQueueFamilyProperties);
 	VK_INSTANCE_BIND(vkInstance, vkEnumeratePhysicalDevices);
 	VK_INSTANCE_BIND(vkInstance, vkGetDeviceProcAddr);
@@ -26,6 +26,7 @@ extern PFN_vkDestroyDebugReportCallbackEXT				vkDestroyDebugReportCallbackEXT;
 extern PFN_vkDestroyInstance							vkDestroyInstance;
 extern PFN_vkEnumeratePhysicalDevices					vkEnumeratePhysicalDevices;
 extern PFN_vkGetPhysicalDeviceProperties				vkGetPhysicalDeviceProperties;
+extern PFN_vkGetPhysicalDeviceFeatures					vkGetPhysicalDeviceFeatures;
 extern PFN_vkGetPhysicalDeviceQueueFamilyProperties		vkGetPhysicalDeviceQueueFamilyProperties;
 extern PFN_vkGetDeviceProcAddr							vkGetDeviceProcAddr;
 extern PFN_vkCreateDevice								vkCreateDevice;
@@ -93,6 +94,7 @@ extern PFN_vkCmdDrawIndexed								vkCmdDrawIndexed;
 extern PFN_vkCreateImage								vkCreateImage;
 extern PFN_vkBindImageMemory							vkBindImageMemory;
 extern PFN_vkCmdCopyBufferToImage						vkCmdCopyBufferToImage;
+extern PFN_vkCmdCopyImageToBuffer						vkCmdCopyImageToBuffer;
 extern PFN_vkCmdPipelineBarrier							vkCmdPipelineBarrier;
 extern PFN_vkGetImageMemoryRequirements					vkGetImageMemoryRequirements;
 extern PFN_vkDestroyImage								vkDestroyImage;
@@ -106,6 +108,19 @@ extern PFN_vkAllocateDescriptorSets						vkAllocateDescriptorSets;
 extern PFN_vkUpdateDescriptorSets						vkUpdateDescriptorSets;
 extern PFN_vkCmdBindDescriptorSets						vkCmdBindDescriptorSets;
 extern PFN_vkCmdCopyImage								vkCmdCopyImage;
+extern PFN_vkCreateComputePipelines						vkCreateComputePipelines;
+extern PFN_vkCmdDispatch								vkCmdDispatch;
+extern PFN_vkCmdDispatchIndirect						vkCmdDispatchIndirect;
+extern PFN_vkCmdDrawIndirect							vkCmdDrawIndirect;
+extern PFN_vkCmdPushConstants							vkCmdPushConstants;
+extern PFN_vkCmdFillBuffer								vkCmdFillBuffer;
+extern PFN_vkCreateQueryPool							vkCreateQueryPool;
+extern PFN_vkDestroyQueryPool							vkDestroyQueryPool;
+extern PFN_vkGetQueryPoolResults						vkGetQueryPoolResults;
+extern PFN_vkCmdResetQueryPool							vkCmdResetQueryPool;
+extern PFN_vkCmdWriteTimestamp							vkCmdWriteTimestamp;
+extern PFN_vkCmdBeginQuery								vkCmdBeginQuery;
+extern PFN_vkCmdEndQuery								vkCmdEndQuery;
 
 //-----------------------------------------------------------------------------------------------
 // Standalone functions - Specific loaders
@@ -0,0 +1,373 @@
+#include "Engine/VulkanRenderer/VKGpuProfiler.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/VulkanRenderer/VKRenderer.hpp"
+#include "Engine/VulkanRenderer/VKFunctions.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Console/Command.hpp"
+#include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Console/DevConsole.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <stdio.h>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static bool s_areCommandsRegistered = false;
+
+static const VkQueryPipelineStatisticFlags GPU_PROFILER_STATISTICS = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+static const char* GPU_FRAME_SCOPE_NAME = "GPU Frame";
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+VKGpuProfiler::VKGpuProfiler(VKRenderer* renderer, int frameCount, uint32_t queueFamilyIndex, bool usePipelineStatistics)
+	: m_renderer(renderer)
+	, m_usePipelineStatistics(usePipelineStatistics)
+{
+	VkPhysicalDevice physicalDevice = renderer->GetPhysicalDevice();
+	VkDevice device = renderer->GetLogicalDevice();
+
+	// Timestamps need a queue that writes them and a device that counts them
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	m_timestampPeriodNs = (double) properties.limits.timestampPeriod;
+
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+	if(queueFamilyIndex < familyCount && m_timestampPeriodNs > 0.0)
+	{
+		m_timestampValidBits = families[queueFamilyIndex].timestampValidBits;
+	}
+
+	if(!IsSupported())
+	{
+		m_usePipelineStatistics = false;
+		return;
+	}
+
+	m_frames.resize(frameCount);
+	for(VKGpuQueryFrame& frame : m_frames)
+	{
+		VkQueryPoolCreateInfo timestampInfo = {};
+		timestampInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		timestampInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		timestampInfo.queryCount = VK_GPU_PROFILER_MAX_SCOPES * 2;
+		if(vkCreateQueryPool(device, &timestampInfo, nullptr, &frame.m_timestampPool) != VK_SUCCESS)
+		{
+			GUARANTEE_OR_DIE(false, "Timestamp query pool could not be created");
+		}
+
+		if(m_usePipelineStatistics)
+		{
+			VkQueryPoolCreateInfo statisticsInfo = {};
+			statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			statisticsInfo.queryCount = VK_GPU_PROFILER_MAX_SCOPES;
+			statisticsInfo.pipelineStatistics = GPU_PROFILER_STATISTICS;
+			if(vkCreateQueryPool(device, &statisticsInfo, nullptr, &frame.m_statisticsPool) != VK_SUCCESS)
+			{
+				GUARANTEE_OR_DIE(false, "Pipeline statistics query pool could not be created");
+			}
+		}
+
+		frame.m_names.reserve(VK_GPU_PROFILER_MAX_SCOPES);
+		ResetQueries(frame); // Scopes can be written before the first frame begins
+	}
+	m_queryData.resize(VK_GPU_PROFILER_MAX_SCOPES * 2 * 2);
+
+	if(!s_areCommandsRegistered)
+	{
+		COMMAND("gpu_profile", GpuProfileCommand, "Prints the GPU time of the last read back frame");
+		s_areCommandsRegistered = true;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor, the device has to be idle
+//
+VKGpuProfiler::~VKGpuProfiler()
+{
+	VkDevice device = m_renderer->GetLogicalDevice();
+	for(VKGpuQueryFrame& frame : m_frames)
+	{
+		vkDestroyQueryPool(device, frame.m_timestampPool, nullptr);
+		if(frame.m_statisticsPool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(device, frame.m_statisticsPool, nullptr);
+		}
+	}
+	m_frames.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Switches to the frame in flight's queries. What it recorded last time is read back first,
+// queries the GPU has not finished yet are counted as dropped instead of waited on
+//
+void VKGpuProfiler::BeginFrame(uint32_t frameIndex)
+{
+	if(!IsSupported())
+	{
+		return;
+	}
+
+	m_currentFrame = frameIndex % (uint32_t) m_frames.size();
+	VKGpuQueryFrame& frame = m_frames[m_currentFrame];
+	if(frame.m_hasResults)
+	{
+		ReadBack(frame);
+	}
+
+	ResetQueries(frame);
+	frame.m_cpuStartHpc = Time::GetPerformanceCounter();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records a reset of the frame's queries, they have to be reset before they are written again
+//
+void VKGpuProfiler::ResetQueries(VKGpuQueryFrame& frame)
+{
+	VkCommandBuffer cmdBuffer = m_renderer->BeginTemporaryCommandBuffer();
+	vkCmdResetQueryPool(cmdBuffer, frame.m_timestampPool, 0, VK_GPU_PROFILER_MAX_SCOPES * 2);
+	if(frame.m_statisticsPool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(cmdBuffer, frame.m_statisticsPool, 0, VK_GPU_PROFILER_MAX_SCOPES);
+	}
+	m_renderer->EndTemporaryCommandBuffer(cmdBuffer);
+
+	frame.m_names.clear();
+	frame.m_droppedCount = 0;
+	frame.m_hasResults = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes the start timestamp and starts the statistics query. Returns the scope to end
+//
+int VKGpuProfiler::BeginScope(VkCommandBuffer cmdBuffer, const char* name)
+{
+	if(!IsSupported())
+	{
+		return -1;
+	}
+
+	VKGpuQueryFrame& frame = m_frames[m_currentFrame];
+	if(frame.m_names.size() >= VK_GPU_PROFILER_MAX_SCOPES)
+	{
+		frame.m_droppedCount++;
+		return -1;
+	}
+
+	uint32_t scope = (uint32_t) frame.m_names.size();
+	frame.m_names.push_back(name);
+	frame.m_hasResults = true;
+
+	vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.m_timestampPool, scope * 2);
+	if(frame.m_statisticsPool != VK_NULL_HANDLE)
+	{
+		vkCmdBeginQuery(cmdBuffer, frame.m_statisticsPool, scope, 0);
+	}
+
+	return (int) scope;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ends the statistics query and writes the end timestamp, in the command buffer it began in
+//
+void VKGpuProfiler::EndScope(VkCommandBuffer cmdBuffer, int scope)
+{
+	if(scope < 0)
+	{
+		return;
+	}
+
+	VKGpuQueryFrame& frame = m_frames[m_currentFrame];
+	if(frame.m_statisticsPool != VK_NULL_HANDLE)
+	{
+		vkCmdEndQuery(cmdBuffer, frame.m_statisticsPool, (uint32_t) scope);
+	}
+	vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.m_timestampPool, (uint32_t) scope * 2 + 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the frame's finished queries out without waiting and converts them to milliseconds
+//
+void VKGpuProfiler::ReadBack(VKGpuQueryFrame& frame)
+{
+	PROFILE_SCOPE_FUNCTION();
+	VkDevice device = m_renderer->GetLogicalDevice();
+	uint32_t scopeCount = (uint32_t) frame.m_names.size();
+	uint64_t validMask = (m_timestampValidBits >= 64) ? ~0ull : ((1ull << m_timestampValidBits) - 1);
+
+	// VK_NOT_READY still fills in every query that is available
+	VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+	vkGetQueryPoolResults(device, frame.m_timestampPool, 0, scopeCount * 2, scopeCount * 2 * 2 * sizeof(uint64_t), m_queryData.data(), 2 * sizeof(uint64_t), flags);
+
+	m_lastResults.clear();
+	m_lastDroppedCount = frame.m_droppedCount;
+	uint64_t firstTimestamp = 0;
+	uint64_t lastTimestamp = 0;
+	std::vector<uint64_t> startTimestamps;
+	std::vector<uint32_t> resultScopes;
+	for(uint32_t scope = 0; scope < scopeCount; ++scope)
+	{
+		const uint64_t* begin = &m_queryData[scope * 4];
+		const uint64_t* end = &m_queryData[scope * 4 + 2];
+		if(begin[1] == 0 || end[1] == 0)
+		{
+			m_lastDroppedCount++;
+			continue;
+		}
+
+		uint64_t startTicks = begin[0] & validMask;
+		uint64_t endTicks = end[0] & validMask;
+		if(m_lastResults.empty() || startTicks < firstTimestamp)
+		{
+			firstTimestamp = startTicks;
+		}
+		if(m_lastResults.empty() || endTicks > lastTimestamp)
+		{
+			lastTimestamp = endTicks;
+		}
+
+		VKGpuScopeResult result;
+		result.m_name = frame.m_names[scope];
+		result.m_durationMs = (double) ((endTicks - startTicks) & validMask) * m_timestampPeriodNs / 1000000.0;
+		startTimestamps.push_back(startTicks);
+		resultScopes.push_back(scope);
+		m_lastResults.push_back(result);
+	}
+
+	m_lastBusyMs = 0.0;
+	for(size_t index = 0; index < m_lastResults.size(); ++index)
+	{
+		m_lastResults[index].m_startMs = (double) (startTimestamps[index] - firstTimestamp) * m_timestampPeriodNs / 1000000.0;
+		m_lastBusyMs += m_lastResults[index].m_durationMs;
+	}
+	m_lastFrameMs = m_lastResults.empty() ? 0.0 : (double) (lastTimestamp - firstTimestamp) * m_timestampPeriodNs / 1000000.0;
+
+	// Statistics, two counters and the availability per query
+	if(frame.m_statisticsPool != VK_NULL_HANDLE && scopeCount > 0)
+	{
+		std::vector<uint64_t> statistics(scopeCount * 3);
+		vkGetQueryPoolResults(device, frame.m_statisticsPool, 0, scopeCount, statistics.size() * sizeof(uint64_t), statistics.data(), 3 * sizeof(uint64_t), flags);
+
+		for(size_t index = 0; index < m_lastResults.size(); ++index)
+		{
+			const uint64_t* values = &statistics[resultScopes[index] * 3];
+			VKGpuScopeResult& result = m_lastResults[index];
+			result.m_hasStatistics = values[2] != 0;
+			result.m_vertexInvocations = values[0];
+			result.m_fragmentInvocations = values[1];
+		}
+	}
+
+	SubmitToProfiler(frame);
+	frame.m_hasResults = false;
+	m_readBackCount++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes the read back scopes on the CPU profiler's GPU timeline. GPU and CPU clocks are not
+// calibrated, the frame's first timestamp is placed where the CPU started the frame
+//
+void VKGpuProfiler::SubmitToProfiler(const VKGpuQueryFrame& frame)
+{
+	Profiler* profiler = Profiler::GetInstance();
+	if(profiler != m_cpuProfiler)
+	{
+		m_cpuProfiler = profiler;
+		m_timeline = (profiler != nullptr) ? profiler->RegisterVirtualThread("GPU") : nullptr;
+	}
+
+	if(m_timeline == nullptr || m_lastResults.empty() || !profiler->IsEnabled())
+	{
+		return;
+	}
+
+	uint64_t frameStartHpc = frame.m_cpuStartHpc;
+	if(!m_timeline->PushBegin(GPU_FRAME_SCOPE_NAME, frameStartHpc))
+	{
+		return;
+	}
+
+	for(const VKGpuScopeResult& result : m_lastResults)
+	{
+		uint64_t startHpc = frameStartHpc + Time::SecondsToHpc((float) (result.m_startMs / 1000.0));
+		uint64_t endHpc = startHpc + Time::SecondsToHpc((float) (result.m_durationMs / 1000.0));
+		if(m_timeline->PushBegin(result.m_name, startHpc))
+		{
+			m_timeline->PushEnd(endHpc);
+		}
+	}
+
+	m_timeline->PushEnd(frameStartHpc + Time::SecondsToHpc((float) (m_lastFrameMs / 1000.0)));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the last read back frame, one line per scope
+//
+std::string VKGpuProfiler::GetReportText() const
+{
+	if(!IsSupported())
+	{
+		return "GPU timestamps are not supported on this device\n";
+	}
+
+	std::string text;
+	char line[256];
+	snprintf(line, sizeof(line), "GPU frame %.3f ms, %u scopes, %u not timed\n", m_lastFrameMs, (uint32_t) m_lastResults.size(), m_lastDroppedCount);
+	text.append(line);
+
+	for(const VKGpuScopeResult& result : m_lastResults)
+	{
+		if(result.m_hasStatistics)
+		{
+			snprintf(line, sizeof(line), "%-32s %8.3f ms at %8.3f ms  vs %10llu  fs %10llu\n", result.m_name, result.m_durationMs, result.m_startMs,
+				(unsigned long long) result.m_vertexInvocations, (unsigned long long) result.m_fragmentInvocations);
+		}
+		else
+		{
+			snprintf(line, sizeof(line), "%-32s %8.3f ms at %8.3f ms\n", result.m_name, result.m_durationMs, result.m_startMs);
+		}
+		text.append(line);
+	}
+
+	return text;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Prints the last read back GPU frame on the console
+//
+STATIC bool VKGpuProfiler::GpuProfileCommand(Command& cmd)
+{
+	UNUSED(cmd);
+	VKRenderer* renderer = VKRenderer::GetInstance();
+	if(renderer == nullptr || renderer->GetGpuProfiler() == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The GPU profiler is not running");
+		return false;
+	}
+
+	std::string text = renderer->GetGpuProfiler()->GetReportText();
+	size_t lineStart = 0;
+	while(lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if(lineEnd == std::string::npos)
+		{
+			lineEnd = text.size();
+		}
+		ConsolePrintf("%s", text.substr(lineStart, lineEnd - lineStart).c_str());
+		lineStart = lineEnd + 1;
+	}
+
+	return true;
+}
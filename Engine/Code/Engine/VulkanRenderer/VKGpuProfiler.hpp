@@ -0,0 +1,101 @@
+#pragma once
+#define VK_NO_PROTOTYPES
+#include "External/Vulkan/vulkan_core.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class VKRenderer;
+class Profiler;
+class ProfileEventBuffer;
+class Command;
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t VK_GPU_PROFILER_MAX_SCOPES = 256; // Per frame, later scopes are not timed
+
+//-----------------------------------------------------------------------------------------------
+// Read back timing of one GPU scope
+//
+struct VKGpuScopeResult
+{
+	const char*		m_name = nullptr;
+	double			m_startMs = 0.0;		// From the frame's first timestamp
+	double			m_durationMs = 0.0;
+	uint64_t		m_vertexInvocations = 0;
+	uint64_t		m_fragmentInvocations = 0;
+	bool			m_hasStatistics = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Queries of one frame in flight
+//
+struct VKGpuQueryFrame
+{
+	VkQueryPool					m_timestampPool = VK_NULL_HANDLE;	// Begin and end per scope
+	VkQueryPool					m_statisticsPool = VK_NULL_HANDLE;	// One per scope, null if unsupported
+	std::vector<const char*>	m_names;							// Scopes written this frame
+	uint64_t					m_cpuStartHpc = 0;
+	uint32_t					m_droppedCount = 0;
+	bool						m_hasResults = false;				// Written since its last read back
+};
+
+//-----------------------------------------------------------------------------------------------
+// Times GPU work with timestamp queries, one query pool per frame in flight. A frame's results
+// are read back without waiting when its slot comes around again, so they show up
+// frameCount frames late. Optional pipeline statistics count vertex and fragment shader
+// invocations per scope. Read back scopes are fed to the CPU profiler on a "GPU" timeline
+//
+class VKGpuProfiler
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	VKGpuProfiler( VKRenderer* renderer, int frameCount, uint32_t queueFamilyIndex, bool usePipelineStatistics );
+	~VKGpuProfiler();
+
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+			bool					IsSupported() const { return m_timestampValidBits > 0; }
+			bool					HasPipelineStatistics() const { return m_usePipelineStatistics; }
+	const	std::vector<VKGpuScopeResult>&	GetLastResults() const { return m_lastResults; }
+			double					GetLastFrameMs() const { return m_lastFrameMs; }		// First scope start to last scope end
+			double					GetLastBusyMs() const { return m_lastBusyMs; }		// Sum of the scope durations
+			uint32_t				GetReadBackCount() const { return m_readBackCount; }	// Changes when new results are in
+
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+			void					BeginFrame( uint32_t frameIndex ); // Reads the slot's last results back and resets it
+			int						BeginScope( VkCommandBuffer cmdBuffer, const char* name ); // Outside of a render pass, -1 if not timed
+			void					EndScope( VkCommandBuffer cmdBuffer, int scope );
+			std::string				GetReportText() const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Command Callbacks
+	static	bool					GpuProfileCommand( Command& cmd );
+
+private:
+			void					ReadBack( VKGpuQueryFrame& frame );
+			void					SubmitToProfiler( const VKGpuQueryFrame& frame );
+			void					ResetQueries( VKGpuQueryFrame& frame );
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+			VKRenderer*						m_renderer;
+			std::vector<VKGpuQueryFrame>	m_frames;
+			uint32_t						m_currentFrame = 0;
+			uint32_t						m_timestampValidBits = 0;
+			double							m_timestampPeriodNs = 1.0;		// Nanoseconds per tick
+			bool							m_usePipelineStatistics = false;
+
+			std::vector<uint64_t>			m_queryData;		// Read back scratch, value and availability pairs
+			std::vector<VKGpuScopeResult>	m_lastResults;
+			double							m_lastFrameMs = 0.0;
+			double							m_lastBusyMs = 0.0;
+			uint32_t						m_readBackCount = 0;
+			uint32_t						m_lastDroppedCount = 0;
+
+			Profiler*						m_cpuProfiler = nullptr;	// Profiler the timeline was registered with
+			ProfileEventBuffer*				m_timeline = nullptr;
+};
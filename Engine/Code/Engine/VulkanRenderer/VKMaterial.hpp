@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 #include <vector>
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -15,6 +16,8 @@ class VKTexSampler;
 class VKMaterial
 {
 public:
+	MEMORY_TAG_CLASS(MEMORY_TAG_MATERIAL)
+
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	explicit VKMaterial( VKRenderer* renderer, VKShader* shader );
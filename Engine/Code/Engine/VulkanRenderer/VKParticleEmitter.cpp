@@ -0,0 +1,345 @@
+#include "Engine/VulkanRenderer/VKParticleEmitter.hpp"
+//-----------------------------------------------------------------------------------------------
+// Engine Includes
+#include "Engine/VulkanRenderer/VKRenderer.hpp"
+#include "Engine/VulkanRenderer/VKGpuProfiler.hpp"
+#include "Engine/VulkanRenderer/VKFunctions.hpp"
+#include "Engine/VulkanRenderer/VKShader.hpp"
+#include "Engine/VulkanRenderer/VKShaderProgram.hpp"
+#include "Engine/VulkanRenderer/VKPipeline.hpp"
+#include "Engine/VulkanRenderer/VKMaterial.hpp"
+#include "Engine/VulkanRenderer/Buffers/VKStorageBuffer.hpp"
+#include "Engine/Math/Transform.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/StopWatch.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Standard Includes
+#include <vector>
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+// Static globals
+static const char* s_kernelDefines[NUM_PARTICLE_KERNELS] = { "EMIT_ARGS", "EMIT", "SIMULATE_ARGS", "SIMULATE", "DRAW_ARGS" };
+
+static const uint32_t PARTICLE_BYTE_SIZE = 80;			// Particle struct in the kernels
+static const uint32_t PARTICLE_GROUP_SIZE = 64;			// GROUP_SIZE in the kernels
+static const size_t EMIT_DISPATCH_OFFSET = 0;				// Byte offsets into the indirect args
+static const size_t SIMULATE_DISPATCH_OFFSET = 12;
+static const size_t DRAW_ARGS_OFFSET = 24;
+static const size_t INDIRECT_ARGS_SIZE = 40;
+
+// Storage buffer bindings of the kernels
+enum ParticleKernelBinding
+{
+	PARTICLE_BINDING_PARTICLES,
+	PARTICLE_BINDING_DEAD_LIST,
+	PARTICLE_BINDING_ALIVE_LISTS,
+	PARTICLE_BINDING_COUNTERS,
+	PARTICLE_BINDING_INDIRECT_ARGS,
+	NUM_PARTICLE_BINDINGS
+};
+
+//-----------------------------------------------------------------------------------------------
+// Makes the previous kernel's writes visible to the next kernel and to indirect argument reads
+//
+static void RecordKernelBarrier(VkCommandBuffer cmdBuffer, VkPipelineStageFlags dstStages)
+{
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+	vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Copies the vector into a float4
+//
+static void WriteFloat4(float* out_values, const Vector3& vector, float w)
+{
+	out_values[0] = vector.x;
+	out_values[1] = vector.y;
+	out_values[2] = vector.z;
+	out_values[3] = w;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+VKParticleEmitter::VKParticleEmitter(VKRenderer* renderer, int maxParticles /*= 65536*/, const char* kernelPath /*= "Data/Shaders/Src/vulkanParticles" */)
+{
+	MEMORY_TAG_SCOPE(MEMORY_TAG_PARTICLES);
+	GUARANTEE_OR_DIE(maxParticles > 0, "GPU particle emitter needs room for at least one particle");
+
+	m_renderer = renderer;
+	m_maxParticles = maxParticles;
+	m_transform = new Transform();
+	m_clock = Clock::GetMasterClock();
+	m_interval = new StopWatch();
+
+	m_particleBuffer = new VKStorageBuffer(m_renderer);
+	m_particleBuffer->Create(maxParticles * PARTICLE_BYTE_SIZE);
+	m_deadList = new VKStorageBuffer(m_renderer);
+	m_deadList->Create(maxParticles * sizeof(uint32_t));
+	m_aliveLists = new VKStorageBuffer(m_renderer);
+	m_aliveLists->Create(maxParticles * 2 * sizeof(uint32_t));
+	m_counters = new VKStorageBuffer(m_renderer);
+	m_counters->Create(4 * sizeof(uint32_t));
+	m_indirectArgs = new VKStorageBuffer(m_renderer);
+	m_indirectArgs->Create(INDIRECT_ARGS_SIZE);
+
+	CreateKernels(kernelPath);
+	Reset();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+VKParticleEmitter::~VKParticleEmitter()
+{
+	for(int kernel = 0; kernel < NUM_PARTICLE_KERNELS; ++kernel)
+	{
+		delete m_kernelPipelines[kernel];
+		m_kernelPipelines[kernel] = nullptr;
+
+		delete m_kernelShaders[kernel];
+		m_kernelShaders[kernel] = nullptr;
+
+		delete m_kernelPrograms[kernel];
+		m_kernelPrograms[kernel] = nullptr;
+	}
+
+	delete m_indirectArgs;
+	m_indirectArgs = nullptr;
+
+	delete m_counters;
+	m_counters = nullptr;
+
+	delete m_aliveLists;
+	m_aliveLists = nullptr;
+
+	delete m_deadList;
+	m_deadList = nullptr;
+
+	delete m_particleBuffer;
+	m_particleBuffer = nullptr;
+
+	delete m_interval;
+	m_interval = nullptr;
+
+	delete m_transform;
+	m_transform = nullptr;
+
+	m_clock = nullptr;
+	m_material = nullptr;
+	m_renderer = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Compiles every kernel, creates its pipeline and points its descriptors at the buffers
+//
+void VKParticleEmitter::CreateKernels(const char* kernelPath)
+{
+	const VKStorageBuffer* buffers[NUM_PARTICLE_BINDINGS] = { m_particleBuffer, m_deadList, m_aliveLists, m_counters, m_indirectArgs };
+
+	for(int kernel = 0; kernel < NUM_PARTICLE_KERNELS; ++kernel)
+	{
+		m_kernelPrograms[kernel] = new VKShaderProgram(m_renderer);
+		m_kernelPrograms[kernel]->LoadComputeFromFile(kernelPath, s_kernelDefines[kernel]);
+		m_kernelShaders[kernel] = new VKShader(m_kernelPrograms[kernel], m_renderer);
+		m_kernelPipelines[kernel] = m_renderer->CreateComputePipeline(m_kernelPrograms[kernel], sizeof(ParticleConstants));
+
+		for(uint32_t binding = 0; binding < NUM_PARTICLE_BINDINGS; ++binding)
+		{
+			if(m_kernelPrograms[kernel]->HasBinding(0, binding))
+			{
+				m_renderer->BindStorageBuffer(m_kernelShaders[kernel]->GetDescriptorSets()[0], binding, buffers[binding]);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the spawn rate
+//
+void VKParticleEmitter::SetSpawnRate(float particlesPerSecond)
+{
+	m_spawnRate = particlesPerSecond;
+	m_spawnsOverTime = m_spawnRate > 0.f;
+
+	if(m_spawnsOverTime)
+	{
+		m_interval->SetTimer(1.f / m_spawnRate);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the clock the particles age with
+//
+void VKParticleEmitter::SetClock(Clock* clock)
+{
+	m_clock = clock;
+	m_interval->SetClock(clock);
+}
+
+//-----------------------------------------------------------------------------------------------
+// The count is never read back, so the emitter is done once nothing spawned for the longest
+// lifetime
+//
+bool VKParticleEmitter::IsReadyToDestroy() const
+{
+	if(!m_killWhenDone || m_spawnsOverTime || m_pendingSpawnCount > 0)
+	{
+		return false;
+	}
+
+	return m_lastSpawnTime < 0.0 || (m_clock->GetTime() - m_lastSpawnTime) > (double) m_lifeTimeRange.max;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the size range
+//
+void VKParticleEmitter::SetSizeRange(float min, float max)
+{
+	m_sizeRange.min = min;
+	m_sizeRange.max = max;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the lifetime range
+//
+void VKParticleEmitter::SetLifeRange(float min, float max)
+{
+	m_lifeTimeRange.min = min;
+	m_lifeTimeRange.max = max;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Sets the color range
+//
+void VKParticleEmitter::SetColorRange(const Rgba& min, const Rgba& max)
+{
+	m_color1 = min;
+	m_color2 = max;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Puts every slot on the dead list and empties both alive lists. Sizes match the buffers, so the
+// uploads never reallocate and the kernels' descriptors stay valid
+//
+void VKParticleEmitter::Reset()
+{
+	std::vector<uint32_t> deadIndices(m_maxParticles);
+	for(uint32_t index = 0; index < (uint32_t) m_maxParticles; ++index)
+	{
+		deadIndices[index] = index;
+	}
+	m_deadList->CopyToGPU(deadIndices.size() * sizeof(uint32_t), deadIndices.data());
+
+	uint32_t counters[4] = { (uint32_t) m_maxParticles, 0, 0, 0 };
+	m_counters->CopyToGPU(sizeof(counters), counters);
+
+	uint32_t args[INDIRECT_ARGS_SIZE / sizeof(uint32_t)] = {};
+	m_indirectArgs->CopyToGPU(sizeof(args), args);
+
+	m_currentList = 0;
+	m_pendingSpawnCount = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Fills the push constants for this update
+//
+void VKParticleEmitter::FillConstants(ParticleConstants& out_constants, float deltaSeconds, uint32_t emitRequest) const
+{
+	WriteFloat4(out_constants.emitterPosition, m_transform->GetWorldPosition(), deltaSeconds);
+	WriteFloat4(out_constants.velocity, m_velocity, (float) m_clock->GetTime());
+	WriteFloat4(out_constants.force, m_force, 0.f);
+	m_color1.GetAsFloats(out_constants.color1[0], out_constants.color1[1], out_constants.color1[2], out_constants.color1[3]);
+	m_color2.GetAsFloats(out_constants.color2[0], out_constants.color2[1], out_constants.color2[2], out_constants.color2[3]);
+
+	out_constants.ranges[0] = m_sizeRange.min;
+	out_constants.ranges[1] = m_sizeRange.max;
+	out_constants.ranges[2] = m_lifeTimeRange.min;
+	out_constants.ranges[3] = m_lifeTimeRange.max;
+
+	out_constants.counts[0] = emitRequest;
+	out_constants.counts[1] = m_currentList;
+	out_constants.counts[2] = m_updateCount * 0x9e3779b9u;
+	out_constants.counts[3] = (uint32_t) m_maxParticles;
+
+	out_constants.flags[0] = (m_sizeOverTime ? 1u : 0u) | (m_colorOverTime ? 2u : 0u);
+	out_constants.flags[1] = 0;
+	out_constants.flags[2] = 0;
+	out_constants.flags[3] = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Records the five kernels in one command buffer. Spawn requests past the free slots are
+// dropped on the GPU
+//
+void VKParticleEmitter::Update(float deltaSeconds)
+{
+	PROFILE_SCOPE_FUNCTION();
+	int spawnCount = m_pendingSpawnCount + (m_spawnsOverTime ? m_interval->DecrementAll() : 0);
+	m_pendingSpawnCount = 0;
+	if(spawnCount > 0)
+	{
+		m_lastSpawnTime = m_clock->GetTime();
+	}
+
+	ParticleConstants constants;
+	FillConstants(constants, deltaSeconds, (uint32_t) spawnCount);
+
+	VkCommandBuffer cmdBuffer = m_renderer->BeginTemporaryCommandBuffer();
+	int gpuScope = m_renderer->GetGpuProfiler()->BeginScope(cmdBuffer, "ParticleSimulate");
+	for(int kernel = 0; kernel < NUM_PARTICLE_KERNELS; ++kernel)
+	{
+		VKPipeline* pipeline = m_kernelPipelines[kernel];
+		const std::vector<void*>& sets = m_kernelShaders[kernel]->GetDescriptorSets();
+
+		vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetPipelineHandle());
+		vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetLayoutHandle(), 0, (uint32_t) sets.size(), (VkDescriptorSet*) sets.data(), 0, nullptr);
+		vkCmdPushConstants(cmdBuffer, pipeline->GetLayoutHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ParticleConstants), &constants);
+
+		switch (kernel)
+		{
+		case PARTICLE_KERNEL_EMIT:
+			vkCmdDispatchIndirect(cmdBuffer, (VkBuffer) m_indirectArgs->GetBufferHandle(), EMIT_DISPATCH_OFFSET);
+			break;
+		case PARTICLE_KERNEL_SIMULATE:
+			vkCmdDispatchIndirect(cmdBuffer, (VkBuffer) m_indirectArgs->GetBufferHandle(), SIMULATE_DISPATCH_OFFSET);
+			break;
+		default:
+			vkCmdDispatch(cmdBuffer, 1, 1, 1); // Argument kernels are a single thread
+			break;
+		}
+
+		// The last kernel's writes are read by the particle draw
+		VkPipelineStageFlags dstStages = (kernel == PARTICLE_KERNEL_DRAW_ARGS) ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT : VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		RecordKernelBarrier(cmdBuffer, dstStages);
+	}
+	m_renderer->GetGpuProfiler()->EndScope(cmdBuffer, gpuScope);
+	m_renderer->EndTemporaryCommandBuffer(cmdBuffer);
+
+	// Survivors are in the other list now
+	m_currentList = 1 - m_currentList;
+	m_updateCount++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws every live particle with one indirect draw, the count never leaves the GPU
+//
+void VKParticleEmitter::Render() const
+{
+	GUARANTEE_OR_DIE(m_material != nullptr, "GPU particle emitter has no material");
+
+	m_renderer->SetMaterial(m_material);
+	m_renderer->BindStorageBuffer(0, m_particleBuffer);
+	m_renderer->BindStorageBuffer(1, m_aliveLists);
+	m_renderer->DrawIndirect(m_indirectArgs, DRAW_ARGS_OFFSET);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------------------------
+// Forward Declarations
+class VKRenderer;
+class VKMaterial;
+class VKShader;
+class VKShaderProgram;
+class VKPipeline;
+class VKStorageBuffer;
+class Transform;
+class Clock;
+class StopWatch;
+
+//-----------------------------------------------------------------------------------------------
+// Compute kernels of the emitter, all built from one source with the kernel name as the define
+//
+enum ParticleKernel
+{
+	PARTICLE_KERNEL_EMIT_ARGS,		// Clamps the spawn request to the free slots, writes the emit dispatch
+	PARTICLE_KERNEL_EMIT,			// Pops dead slots, initializes them, appends them to the current list
+	PARTICLE_KERNEL_SIMULATE_ARGS,	// Writes the simulate dispatch from the current list's count
+	PARTICLE_KERNEL_SIMULATE,		// Integrates the current list, survivors go to the next list, the rest back to the dead list
+	PARTICLE_KERNEL_DRAW_ARGS,		// Writes the indirect draw for the next list
+	NUM_PARTICLE_KERNELS
+};
+
+//-----------------------------------------------------------------------------------------------
+// Push constants shared by every kernel, 128 bytes which every device supports
+//
+struct ParticleConstants
+{
+	float		emitterPosition[4];	// w = delta seconds
+	float		velocity[4];		// w = time
+	float		force[4];
+	float		color1[4];
+	float		color2[4];
+	float		ranges[4];			// size min, size max, life min, life max
+	uint32_t	counts[4];			// emit request, current list, seed, max particles
+	uint32_t	flags[4];			// x: bit 0 size over time, bit 1 color over time
+};
+
+//-----------------------------------------------------------------------------------------------
+// Particle emitter that lives entirely on the GPU. Spawning, integration and killing run as
+// compute kernels over storage buffers, free slots come from a dead list and live particles are
+// tracked in two alive lists that swap every update. The kernels write their own dispatch and
+// draw arguments, so the CPU never reads a count back. Configured like ParticleEmitter
+//
+class VKParticleEmitter
+{
+public:
+	//-----------------------------------------------------------------------------------------------
+	// Constructors/Destructors
+	VKParticleEmitter( VKRenderer* renderer, int maxParticles = 65536, const char* kernelPath = "Data/Shaders/Src/vulkanParticles" );
+	~VKParticleEmitter();
+	
+	//-----------------------------------------------------------------------------------------------
+	// Accessors/Mutators
+	void	SetSpawnRate( float particlesPerSecond );
+	void	SetClock( Clock* clock );
+	void	SetMaterial( VKMaterial* material ) { m_material = material; }
+	void	SetKillAutomatic( bool flag ) { m_killWhenDone = flag; }
+	bool	IsReadyToDestroy() const;
+	void	SetSizeRange( float min, float max );
+	void	SetLifeRange( float min, float max );
+	void	SetVelocity( const Vector3& velocity ) { m_velocity = velocity; }
+	void	SetColorRange( const Rgba& min, const Rgba& max );
+	void	SetForce( const Vector3& force ) { m_force = force; }
+	void	SetSizeOverTime( bool flag ) { m_sizeOverTime = flag; }
+	void	SetColorOverTime( bool flag ) { m_colorOverTime = flag; }
+	int		GetMaxParticles() const { return m_maxParticles; }
+	
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	void	Update( float deltaSeconds ); // Records and submits the kernels
+	void	Render() const; // Draws with the material, needs a camera set on the renderer
+	void	SpawnBurst( int count ) { m_pendingSpawnCount += count; } // Spawned on the next update
+	void	Reset(); // Kills every particle
+
+private:
+	void	CreateKernels( const char* kernelPath );
+	void	FillConstants( ParticleConstants& out_constants, float deltaSeconds, uint32_t emitRequest ) const;
+	
+	//-----------------------------------------------------------------------------------------------
+	// Members
+public:
+	Transform*				m_transform;
+
+private:
+	VKRenderer*				m_renderer;
+	VKMaterial*				m_material = nullptr;
+	Clock*					m_clock = nullptr;
+	StopWatch*				m_interval;
+	int						m_maxParticles;
+	bool					m_spawnsOverTime = false;
+	bool					m_colorOverTime = false;
+	bool					m_sizeOverTime = false;
+	bool					m_killWhenDone = false;
+	float					m_spawnRate = 0.f;
+	int						m_pendingSpawnCount = 0;
+	double					m_lastSpawnTime = -1.0;
+	uint32_t				m_currentList = 0;	// Alive list the kernels start from, flips every update
+	uint32_t				m_updateCount = 0;	// Seeds the spawn randomness
+	FloatRange				m_sizeRange = FloatRange(.1f, .3f);
+	FloatRange				m_lifeTimeRange = FloatRange(1.f, 3.f);
+	Vector3					m_velocity = Vector3::FORWARD;
+	Vector3					m_force = Vector3::ZERO;
+	Rgba					m_color1 = Rgba::WHITE;
+	Rgba					m_color2 = Rgba::WHITE;
+
+	// GPU state
+	VKStorageBuffer*		m_particleBuffer;
+	VKStorageBuffer*		m_deadList;
+	VKStorageBuffer*		m_aliveLists;		// Two lists of max particles
+	VKStorageBuffer*		m_counters;			// Dead count, emit count, alive count per list
+	VKStorageBuffer*		m_indirectArgs;		// Emit dispatch, simulate dispatch, draw
+	VKShaderProgram*		m_kernelPrograms[NUM_PARTICLE_KERNELS];
+	VKShader*				m_kernelShaders[NUM_PARTICLE_KERNELS];	// Owns the kernel's descriptor sets
+	VKPipeline*				m_kernelPipelines[NUM_PARTICLE_KERNELS];
+};
+
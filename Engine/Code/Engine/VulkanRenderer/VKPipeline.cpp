@@ -6,6 +6,7 @@
 #include "Engine/Core/Vertex.hpp"
 #include "Engine/VulkanRenderer/VKShaderStage.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -122,6 +123,19 @@ void VKPipeline::SetVertexLayout(const VertexLayout& layout)
 	m_vertexInputInfo.pVertexAttributeDescriptions = m_attribInfos.data();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Removes every vertex binding and attribute, the vertex shader builds its own data
+//
+void VKPipeline::ClearVertexLayout()
+{
+	m_attribInfos.clear();
+
+	m_vertexInputInfo.vertexBindingDescriptionCount = 0;
+	m_vertexInputInfo.pVertexBindingDescriptions = nullptr;
+	m_vertexInputInfo.vertexAttributeDescriptionCount = 0;
+	m_vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets the shader stages
 //
@@ -272,6 +286,19 @@ void VKPipeline::SetRenderPass(VkRenderPass renderPass)
 	m_renderPass = renderPass;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Sets a single push constant range starting at offset 0, a size of 0 removes it
+//
+void VKPipeline::SetPushConstantRange(VkShaderStageFlags stages, uint32_t size)
+{
+	m_pushConstantRange.stageFlags = stages;
+	m_pushConstantRange.offset = 0;
+	m_pushConstantRange.size = size;
+
+	m_pipelineLayoutInfo.pushConstantRangeCount = (size > 0) ? 1 : 0;
+	m_pipelineLayoutInfo.pPushConstantRanges = (size > 0) ? &m_pushConstantRange : nullptr;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Destroys the pipeline
 //
@@ -282,6 +309,7 @@ void VKPipeline::DestroyPipeline()
 	if(m_pipeline != VK_NULL_HANDLE)
 	{
 		vkDestroyPipeline(m_renderer->GetLogicalDevice(), m_pipeline, nullptr);
+		m_pipeline = VK_NULL_HANDLE;
 	}
 }
 
@@ -293,6 +321,7 @@ void VKPipeline::DestroyPipelineLayout()
 	if(m_pipelineLayout != VK_NULL_HANDLE)
 	{
 		vkDestroyPipelineLayout(m_renderer->GetLogicalDevice(), m_pipelineLayout, nullptr);
+		m_pipelineLayout = VK_NULL_HANDLE;
 	}
 }
 
@@ -314,6 +343,7 @@ void VKPipeline::CreatePipelineLayout()
 //
 void VKPipeline::UpdatePipeline()
 {
+	PROFILE_SCOPE_FUNCTION();
 	DestroyPipeline();
 
 	CreatePipelineLayout();
@@ -341,3 +371,28 @@ void VKPipeline::UpdatePipeline()
 		GUARANTEE_OR_DIE(false, "Couldn't create the pipeline");
 	}
 }
+
+//-----------------------------------------------------------------------------------------------
+// Creates a compute pipeline from the first shader stage and destroys the existing one
+//
+void VKPipeline::UpdateComputePipeline()
+{
+	PROFILE_SCOPE_FUNCTION();
+	GUARANTEE_OR_DIE(m_shaderStages.size() == 1 && m_shaderStages[0].stage == VK_SHADER_STAGE_COMPUTE_BIT, "Compute pipeline needs exactly one compute stage");
+
+	DestroyPipeline();
+
+	CreatePipelineLayout();
+
+	VkComputePipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = m_shaderStages[0];
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+	pipelineInfo.basePipelineIndex = -1;
+
+	if(vkCreateComputePipelines(m_renderer->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+	{
+		GUARANTEE_OR_DIE(false, "Couldn't create the compute pipeline");
+	}
+}
@@ -26,12 +26,16 @@ private:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	VKPipeline( VKRenderer* renderer );
+
+public:
 	~VKPipeline();
 	
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
-	VkPipeline	GetPipelineHandle() { return m_pipeline; }
+	VkPipeline			GetPipelineHandle() const { return m_pipeline; }
+	VkPipelineLayout	GetLayoutHandle() const { return m_pipelineLayout; }
 	
+private:
 	//-----------------------------------------------------------------------------------------------
 	// Methods
 
@@ -41,9 +45,11 @@ private:
 	void	DestroyPipelineLayout();
 	void	CreatePipelineLayout();
 	void	UpdatePipeline();
+	void	UpdateComputePipeline(); // Only uses the first shader stage and the layout
 
 	// Pipeline state helpers
 	void	SetVertexLayout( const VertexLayout& layout );
+	void	ClearVertexLayout(); // For draws that pull their data from storage buffers
 	void	SetShaderStages( const std::vector<VKShaderStage*>& stages );
 	void	SetDrawType( DrawPrimitiveType type );
 	void	SetViewport( const AABB2& extent, float minDepth = 0.f, float maxDepth = 1.f );
@@ -57,13 +63,14 @@ private:
 	void	SetAlphaBlending( BlendOp op, BlendFactor sFactor, BlendFactor dFactor );
 	void	SetDescriptorSetLayouts( size_t count, void* layouts );
 	void	SetRenderPass( VkRenderPass renderPass );
+	void	SetPushConstantRange( VkShaderStageFlags stages, uint32_t size );
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
 	VKRenderer*								m_renderer = nullptr;
 	VkPipelineLayoutCreateInfo				m_pipelineLayoutInfo = {};
-	VkPipelineLayout						m_pipelineLayout;
-	VkPipeline								m_pipeline;
+	VkPipelineLayout						m_pipelineLayout = VK_NULL_HANDLE;
+	VkPipeline								m_pipeline = VK_NULL_HANDLE;
 	VkViewport								m_viewport;
 	VkRect2D								m_scissorRect;
 	VkRenderPass							m_renderPass;
@@ -71,6 +78,7 @@ private:
 	// Pipeline layout data
 	uint32_t								m_descriptorSetCount;
 	void*									m_descriptorSetLayouts;
+	VkPushConstantRange						m_pushConstantRange = {};
 
 	// Pipeline data
 	VkVertexInputBindingDescription					m_vertexBindingInfo = {};
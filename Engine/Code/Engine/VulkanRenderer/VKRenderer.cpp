@@ -28,13 +28,31 @@
 #include "Engine/VulkanRenderer/Mesh/VKMeshUtils.hpp"
 #include "Engine/Enumerations/ReservedDescriptorSetSlot.hpp"
 #include "Engine/VulkanRenderer/Buffers/VKUniformBuffer.hpp"
+#include "Engine/VulkanRenderer/Buffers/VKStorageBuffer.hpp"
+#include "Engine/VulkanRenderer/VKGpuProfiler.hpp"
 #include "Engine/VulkanRenderer/VKCamera.hpp"
 #include "Engine/Enumerations/ReservedUniformBlock.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
+#include "Engine/Console/Command.hpp"
+#include "Engine/Console/CommandDefinition.hpp"
+#include "Engine/Console/DevConsole.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
 // Static globals
 static	VKRenderer* g_renderer = nullptr;
+static	bool	s_areCommandsRegistered = false;
+
+static	const char* s_immediateFlushReasonNames[NUM_IMMEDIATE_FLUSH_REASONS] = {
+	"State change",
+	"Other draw",
+	"Camera",
+	"Material reset",
+	"Range full",
+	"Read back",
+	"End frame"
+};
 
 static	const std::vector<const char*> s_deviceExtensions = {
 	VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -69,16 +87,19 @@ static	const std::vector<const char*> s_globalExtensions = {
 //
 VKRenderer::VKRenderer( const char* appName )
 {
-	m_defaultPipeline = new VKPipeline(this);
+	Initialize(appName);
+}
 
-	InitializeVulkanInstance(appName);
-	SetupDebugCallback();
-	CreateSurface();
-	PickPhysicalDevice();
-	CreateLogicalDevice();
-	CreateSwapChain();
-	CreateImageViews();
-	CreateCommandPool();
+//-----------------------------------------------------------------------------------------------
+// Constructor for headless rendering, the default targets are sized to width x height
+//
+VKRenderer::VKRenderer( const char* appName, uint32_t headlessWidth, uint32_t headlessHeight )
+{
+	m_isHeadless = true;
+	m_swapChainExtent = { headlessWidth, headlessHeight };
+	m_swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+	Initialize(appName);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -86,14 +107,15 @@ VKRenderer::VKRenderer( const char* appName )
 //
 VKRenderer::~VKRenderer()
 {
+	vkDeviceWaitIdle(m_logicalDevice);
+	delete m_gpuProfiler;
+	m_gpuProfiler = nullptr;
+
 	CleanupSwapchain();
 	
 	delete m_immediateVBO;
 	m_immediateVBO = nullptr;
 
-	delete m_immediateIBO;
-	m_immediateIBO = nullptr;
-
 	for(int index = 0; index < MAX_FRAMES_IN_FLIGHT; ++index)
 	{
 		vkDestroySemaphore(m_logicalDevice, m_renderFinishedSemaphore[index], nullptr);
@@ -104,7 +126,10 @@ VKRenderer::~VKRenderer()
 	vkDestroyCommandPool(m_logicalDevice, m_commandPool, nullptr);
 	
 	vkDestroyDevice(m_logicalDevice, nullptr);
-	vkDestroySurfaceKHR(m_vkInstance, m_surface, nullptr);
+	if(m_surface != VK_NULL_HANDLE)
+	{
+		vkDestroySurfaceKHR(m_vkInstance, m_surface, nullptr);
+	}
 	
 	if(s_enableValidationLayers)
 	{
@@ -113,6 +138,59 @@ VKRenderer::~VKRenderer()
 	vkDestroyInstance(m_vkInstance, nullptr);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Creates the instance, device and command pool. Surface and swapchain are skipped when headless
+//
+void VKRenderer::Initialize( const char* appName )
+{
+	m_defaultPipeline = new VKPipeline(this);
+
+	InitializeVulkanInstance(appName);
+	SetupDebugCallback();
+	if(!m_isHeadless)
+	{
+		CreateSurface();
+	}
+	PickPhysicalDevice();
+	CreateLogicalDevice();
+	if(!m_isHeadless)
+	{
+		CreateSwapChain();
+		CreateImageViews();
+	}
+	CreateCommandPool();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the instance extensions to enable, the surface extensions are left out when headless
+//
+std::vector<const char*> VKRenderer::GetRequestedGlobalExtensions() const
+{
+	std::vector<const char*> extensions;
+	for(const char* extensionName : s_globalExtensions)
+	{
+		bool isSurfaceExtension = (strcmp(extensionName, VK_KHR_SURFACE_EXTENSION_NAME) == 0) || (strcmp(extensionName, VK_KHR_WIN32_SURFACE_EXTENSION_NAME) == 0);
+		if(m_isHeadless && isSurfaceExtension)
+		{
+			continue;
+		}
+		extensions.push_back(extensionName);
+	}
+	return extensions;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the device extensions to enable, headless rendering needs no swapchain
+//
+std::vector<const char*> VKRenderer::GetRequestedDeviceExtensions() const
+{
+	if(m_isHeadless)
+	{
+		return std::vector<const char*>();
+	}
+	return s_deviceExtensions;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Initializes the vulkan instance
 //
@@ -141,11 +219,12 @@ void VKRenderer::InitializeVulkanInstance( const char* appName )
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 	createInfo.pApplicationInfo = &appInfo;
 	createInfo.enabledLayerCount = 0;
-	createInfo.enabledExtensionCount = (uint32_t) s_globalExtensions.size();
+	std::vector<const char*> globalExtensions = GetRequestedGlobalExtensions();
+	createInfo.enabledExtensionCount = (uint32_t) globalExtensions.size();
 
 	if(createInfo.enabledExtensionCount)
 	{
-		createInfo.ppEnabledExtensionNames = s_globalExtensions.data();
+		createInfo.ppEnabledExtensionNames = globalExtensions.data();
 	}
 
 	if(s_enableValidationLayers)
@@ -164,7 +243,8 @@ void VKRenderer::InitializeVulkanInstance( const char* appName )
 }
 
 //-----------------------------------------------------------------------------------------------
-// Picks the first physical device that's available on the computer
+// Picks the first physical device that's available on the computer. Headless prefers a discrete
+// GPU but falls back to any suitable device, software rasterizers included
 //
 void VKRenderer::PickPhysicalDevice()
 {
@@ -179,8 +259,18 @@ void VKRenderer::PickPhysicalDevice()
 	{
 		if(IsDeviceSuitable(device))
 		{
-			m_physicalDevice = device;
-			break;
+			VkPhysicalDeviceProperties deviceProp;
+			vkGetPhysicalDeviceProperties(device, &deviceProp);
+			bool isDiscreteGPU = (deviceProp.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
+
+			if(m_physicalDevice == VK_NULL_HANDLE || isDiscreteGPU)
+			{
+				m_physicalDevice = device;
+			}
+			if(isDiscreteGPU)
+			{
+				break;
+			}
 		}
 	}
 
@@ -391,19 +481,21 @@ void VKRenderer::CreateCommandPool()
 }
 
 //-----------------------------------------------------------------------------------------------
-// Creates the VBO for immediate drawing 
+// Creates the VBO for immediate drawing. It is host visible and stays mapped, so batches are
+// written in place and drawn without a staging copy
 //
 void VKRenderer::CreateVertexBuffer()
 {
 	m_immediateVBO = new VKVertexBuffer(m_logicalDevice, m_physicalDevice);
-}
 
-//-----------------------------------------------------------------------------------------------
-// Creates the IBO for immediate drawing
-//
-void VKRenderer::CreateIndexBuffer()
-{
-	m_immediateIBO = new VKIndexBuffer(m_logicalDevice, m_physicalDevice);
+	VkDeviceSize byteCount = sizeof(Vertex_3DPCU) * VK_IMMEDIATE_VERTICES_PER_FRAME * MAX_FRAMES_IN_FLIGHT;
+	CreateAndGetBuffer((VkBuffer*) &m_immediateVBO->m_bufferHandle, (VkDeviceMemory*) &m_immediateVBO->m_deviceMemoryHandle, byteCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	m_immediateVBO->m_bufferSize = (size_t) byteCount;
+	m_immediateVBO->SetStride(sizeof(Vertex_3DPCU));
+
+	void* mappedMemory = nullptr;
+	vkMapMemory(m_logicalDevice, (VkDeviceMemory) m_immediateVBO->m_deviceMemoryHandle, 0, byteCount, 0, &mappedMemory);
+	m_immediateVertices = (Vertex_3DPCU*) mappedMemory;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -465,7 +557,11 @@ void VKRenderer::CleanupSwapchain()
 		vkDestroyImageView(m_logicalDevice, view, nullptr);
 	}
 
-	vkDestroySwapchainKHR(m_logicalDevice, m_swapChain, nullptr);
+	if(m_swapChain != VK_NULL_HANDLE)
+	{
+		vkDestroySwapchainKHR(m_logicalDevice, m_swapChain, nullptr);
+		m_swapChain = VK_NULL_HANDLE;
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -492,6 +588,10 @@ bool VKRenderer::IsDeviceSuitable(VkPhysicalDevice device)
 	QueueFamilyIndices indices = GetQueueFamilyIndices(device);
 
 	bool extensionsSupported = CheckDeviceExtensionsSupport(device);
+	if(m_isHeadless)
+	{
+		return indices.IsComplete() && extensionsSupported;
+	}
 
 	bool isSwapChainSupportEnough = false;
 	if(extensionsSupported) // Swapchain itself is an extension
@@ -514,7 +614,7 @@ bool VKRenderer::CheckDeviceExtensionsSupport( VkPhysicalDevice device )
 	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-	for(const char* extensionName : s_deviceExtensions)
+	for(const char* extensionName : GetRequestedDeviceExtensions())
 	{
 		bool extensionFound = false;
 		for(uint32_t index = 0; index < extensionCount; ++index)
@@ -558,6 +658,17 @@ QueueFamilyIndices VKRenderer::GetQueueFamilyIndices(VkPhysicalDevice device)
 			indices.graphicsFamily = iterIndex;
 		}
 
+		// Nothing is presented when headless, the graphics queue stands in
+		if( m_isHeadless )
+		{
+			indices.presentFamily = indices.graphicsFamily;
+			if(indices.IsComplete())
+			{
+				break;
+			}
+			continue;
+		}
+
 		VkBool32 presentSupport = false;
 		vkGetPhysicalDeviceSurfaceSupportKHR(device, iterIndex, m_surface, &presentSupport);
 
@@ -614,9 +725,13 @@ void VKRenderer::CreateLogicalDevice()
 	// Get the queue indices supported by the physical device
 	QueueFamilyIndices indices = GetQueueFamilyIndices(m_physicalDevice);
 	
-	// Multiple queues are needed
+	// Multiple queues are needed, a family may only be requested once
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::vector<int> uniqueQueueFamilies = { indices.graphicsFamily, indices.presentFamily };
+	std::vector<int> uniqueQueueFamilies = { indices.graphicsFamily };
+	if(indices.presentFamily != indices.graphicsFamily)
+	{
+		uniqueQueueFamilies.push_back(indices.presentFamily);
+	}
 	float queuePriority = 1.f;
 	for( int queueIndex : uniqueQueueFamilies )
 	{
@@ -629,7 +744,12 @@ void VKRenderer::CreateLogicalDevice()
 	}
 	
 	// Device create info takes this as a struct member to enable certain features
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+
 	VkPhysicalDeviceFeatures deviceFeatures = {};
+	deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery; // For the GPU profiler, optional
+	m_isPipelineStatisticsEnabled = (supportedFeatures.pipelineStatisticsQuery == VK_TRUE);
 	
 	// Logical device creation info
 	VkDeviceCreateInfo deviceCreateInfo = {};
@@ -637,8 +757,9 @@ void VKRenderer::CreateLogicalDevice()
 	deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
 	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 	deviceCreateInfo.queueCreateInfoCount = (uint32_t) queueCreateInfos.size();
-	deviceCreateInfo.enabledExtensionCount = (uint32_t) s_deviceExtensions.size();
-	deviceCreateInfo.ppEnabledExtensionNames = s_deviceExtensions.data();
+	std::vector<const char*> deviceExtensions = GetRequestedDeviceExtensions();
+	deviceCreateInfo.enabledExtensionCount = (uint32_t) deviceExtensions.size();
+	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.empty() ? nullptr : deviceExtensions.data();
 	deviceCreateInfo.enabledLayerCount = 0;
 
 	// Check if validation layers are enabled. Enable those layers on the logical device
@@ -660,6 +781,19 @@ void VKRenderer::CreateLogicalDevice()
 	// Get the queue handle for Graphics and Presentation
 	vkGetDeviceQueue(m_logicalDevice, indices.graphicsFamily, 0, &m_graphicsQueue);
 	vkGetDeviceQueue(m_logicalDevice, indices.presentFamily, 0, &m_presentQueue);
+
+	// Lets the memory tracker report device memory per heap
+	MemoryTracker* memoryTracker = MemoryTracker::GetInstance();
+	if(memoryTracker != nullptr)
+	{
+		VkPhysicalDeviceMemoryProperties memProps = {};
+		vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProps);
+		for(uint32_t heapIndex = 0; heapIndex < memProps.memoryHeapCount; ++heapIndex)
+		{
+			const VkMemoryHeap& heap = memProps.memoryHeaps[heapIndex];
+			memoryTracker->SetDeviceHeap((int) heapIndex, heap.size, (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0);
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -699,6 +833,17 @@ void VKRenderer::PostStartup()
 	m_defaultColorTarget->CreateRenderTarget(m_swapChainExtent.width, m_swapChainExtent.height, TEXTURE_FORMAT_RGBA8);
 
 	CreateSyncStuff();
+
+	QueueFamilyIndices indices = GetQueueFamilyIndices(m_physicalDevice);
+	m_gpuProfiler = new VKGpuProfiler(this, MAX_FRAMES_IN_FLIGHT, (uint32_t) indices.graphicsFamily, m_isPipelineStatisticsEnabled);
+
+	CreateVertexBuffer();
+
+	if(!s_areCommandsRegistered)
+	{
+		COMMAND("immediate_stats", ImmediateStatsCommand, "Prints the immediate draw batches of the last frame");
+		s_areCommandsRegistered = true;
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -706,16 +851,177 @@ void VKRenderer::PostStartup()
 //
 void VKRenderer::BeginFrame()
 {
-	vkAcquireNextImageKHR(m_logicalDevice, m_swapChain, UINT32_MAX, m_imageAvailableSemaphore[m_currentFrame], VK_NULL_HANDLE, &m_swapImageIndex);
+	PROFILE_SCOPE_FUNCTION();
+	if(!m_isHeadless)
+	{
+		vkAcquireNextImageKHR(m_logicalDevice, m_swapChain, UINT32_MAX, m_imageAvailableSemaphore[m_currentFrame], VK_NULL_HANDLE, &m_swapImageIndex);
+	}
+	m_gpuProfiler->BeginFrame(m_currentFrame);
+	m_immediateCursor = 0;
 }
 
 //-----------------------------------------------------------------------------------------------
-// Draws mesh vertices using PCU vertex layout
+// Queues mesh vertices using PCU vertex layout. Vertices are moved to world space on the CPU so
+// draws with different model matrices still share a batch, and strips and loops are unrolled
+// into lists so they can be appended to one. The batch is drawn when the state changes or
+// something else needs the GPU
 //
 void VKRenderer::DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, DrawPrimitiveType mode, const Matrix44& modelMatrix)
 {
+	PROFILE_SCOPE_FUNCTION();
+	DrawPrimitiveType listType = mode;
+	int primitiveSize = 1;
+	int primitiveCount = 0;
+	switch(mode)
+	{
+	case PRIMITIVE_LINES:			primitiveSize = 2; primitiveCount = numVerts / 2; break;
+	case PRIMITIVE_LINE_LOOP:		listType = PRIMITIVE_LINES; primitiveSize = 2; primitiveCount = (numVerts > 1) ? numVerts : 0; break;
+	case PRIMITIVE_TRIANGLES:		primitiveSize = 3; primitiveCount = numVerts / 3; break;
+	case PRIMITIVE_TRIANGLE_STRIP:	listType = PRIMITIVE_TRIANGLES; primitiveSize = 3; primitiveCount = (numVerts > 2) ? numVerts - 2 : 0; break;
+	case PRIMITIVE_POINT:			primitiveSize = 1; primitiveCount = numVerts; break;
+	default:
+		GUARANTEE_OR_DIE(false, "Unsupported topology");
+		break;
+	}
 
-	
+	if(primitiveCount == 0)
+	{
+		return;
+	}
+
+	VKImmediateBatchState state = GetImmediateBatchState(listType);
+	if(m_immediateBatchCount > 0 && !state.IsSameAs(m_immediateBatch))
+	{
+		FlushImmediateBatch(IMMEDIATE_FLUSH_STATE_CHANGE);
+	}
+
+	Vertex_3DPCU* frameVertices = m_immediateVertices + m_currentFrame * VK_IMMEDIATE_VERTICES_PER_FRAME;
+	int corners[3] = {0, 1, 2};
+	for(int primIndex = 0; primIndex < primitiveCount; ++primIndex)
+	{
+		if(m_immediateCursor + primitiveSize > VK_IMMEDIATE_VERTICES_PER_FRAME)
+		{
+			// Draws wait for the queue, so once flushed nothing reads the range anymore
+			FlushImmediateBatch(IMMEDIATE_FLUSH_FULL);
+			m_immediateCursor = 0;
+		}
+
+		if(m_immediateBatchCount == 0)
+		{
+			m_immediateBatch = state;
+			m_immediateBatchStart = m_immediateCursor;
+		}
+
+		switch(mode)
+		{
+		case PRIMITIVE_LINE_LOOP:
+			corners[0] = primIndex;
+			corners[1] = (primIndex + 1) % numVerts;
+			break;
+		case PRIMITIVE_TRIANGLE_STRIP: // Every other triangle is flipped to keep the winding
+			corners[0] = ((primIndex & 1) == 0) ? primIndex : primIndex + 1;
+			corners[1] = ((primIndex & 1) == 0) ? primIndex + 1 : primIndex;
+			corners[2] = primIndex + 2;
+			break;
+		default:
+			corners[0] = primIndex * primitiveSize;
+			corners[1] = corners[0] + 1;
+			corners[2] = corners[0] + 2;
+			break;
+		}
+
+		// Built on the stack, the mapped memory is only written to
+		for(int cornerIndex = 0; cornerIndex < primitiveSize; ++cornerIndex)
+		{
+			Vertex_3DPCU vertex = vertices[corners[cornerIndex]];
+			vertex.m_position = modelMatrix.TransformPosition3D(vertex.m_position);
+			frameVertices[m_immediateCursor++] = vertex;
+		}
+		m_immediateBatchCount += primitiveSize;
+	}
+
+	m_immediateStats.m_drawCount++;
+	m_immediateStats.m_vertexCount += primitiveCount * primitiveSize;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws the pending immediate vertices in one draw call with the state they were queued under.
+// The active material is restored afterwards
+//
+void VKRenderer::FlushImmediateBatch(eImmediateFlushReason reason)
+{
+	if(m_immediateBatchCount == 0)
+	{
+		return;
+	}
+
+	PROFILE_SCOPE_FUNCTION();
+	VKMaterial* activeMaterial = m_activeMaterial;
+	m_activeMaterial = const_cast<VKMaterial*>(m_immediateBatch.m_material);
+
+	ModelBuffer* modelBuffer = m_modelBuffer->As<ModelBuffer>();
+	modelBuffer->MODEL = Matrix44::IDENTITY; // Vertices are already in world space
+	m_modelBuffer->UpdateGPU();
+
+	m_defaultPipeline->SetDrawType(m_immediateBatch.m_drawType);
+	UseShaderProgram(m_immediateBatch.m_shader->GetProgram());
+	BindRenderState(m_immediateBatch.m_renderState);
+
+	for(size_t texIdx = 0; texIdx < m_activeMaterial->m_textures.size(); ++texIdx)
+	{
+		const VKTexture* texture = ((int) texIdx < m_immediateBatch.m_textureCount) ? m_immediateBatch.m_textures[texIdx] : m_activeMaterial->m_textures[texIdx];
+		BindTexture2D((int) texIdx, texture);
+	}
+
+	m_defaultPipeline->SetVertexLayout(Vertex_3DPCU::s_layout);
+
+	m_currentCamera->m_cameraUBO->UpdateGPU();
+	BindUBO(0, m_currentCamera->m_cameraUBO);
+	BindUBO(1, m_modelBuffer);
+
+	m_defaultPipeline->UpdatePipeline();
+
+	VkCommandBuffer cmdBuffer = BeginTemporaryCommandBuffer();
+	int gpuScope = m_gpuProfiler->BeginScope(cmdBuffer, "DrawImmediate");
+	BeginCameraRenderPass(cmdBuffer);
+
+	VkBuffer vbo = (VkBuffer) m_immediateVBO->GetBufferHandle();
+	VkDeviceSize offsets[] = {0};
+	vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &vbo, offsets);
+	vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_defaultPipeline->m_pipelineLayout, 0, (uint32_t) m_activeMaterial->GetDescriptorSets().size(), (VkDescriptorSet*) m_activeMaterial->GetDescriptorSets().data(), 0, nullptr);
+
+	uint32_t firstVertex = m_currentFrame * VK_IMMEDIATE_VERTICES_PER_FRAME + m_immediateBatchStart;
+	vkCmdDraw(cmdBuffer, m_immediateBatchCount, 1, firstVertex, 0);
+
+	vkCmdEndRenderPass(cmdBuffer);
+	m_gpuProfiler->EndScope(cmdBuffer, gpuScope);
+
+	SubmitDrawCommandBuffer(cmdBuffer);
+
+	m_activeMaterial = activeMaterial;
+	m_immediateBatchCount = 0;
+	m_immediateStats.m_batchCount++;
+	m_immediateStats.m_flushCounts[reason]++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Returns the state an immediate draw made now would be drawn with
+//
+VKImmediateBatchState VKRenderer::GetImmediateBatchState(DrawPrimitiveType listType) const
+{
+	VKImmediateBatchState state;
+	state.m_material = m_activeMaterial;
+	state.m_shader = m_activeMaterial->GetShader();
+	state.m_renderState = state.m_shader->m_renderState;
+	state.m_drawType = listType;
+
+	state.m_textureCount = Min((int) m_activeMaterial->m_textures.size(), VK_IMMEDIATE_BATCH_TEXTURE_SLOTS);
+	for(int texIdx = 0; texIdx < state.m_textureCount; ++texIdx)
+	{
+		state.m_textures[texIdx] = m_activeMaterial->m_textures[texIdx];
+	}
+
+	return state;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -723,6 +1029,8 @@ void VKRenderer::DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, D
 //
 void VKRenderer::DrawMesh(const VKMesh& mesh, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */)
 {
+	PROFILE_SCOPE_FUNCTION();
+	FlushImmediateBatch(IMMEDIATE_FLUSH_DRAW);
 	const DrawInstruction& drawInstruct = mesh.m_drawInstruction;
 	ModelBuffer* modelBuffer = m_modelBuffer->As<ModelBuffer>();
 	modelBuffer->MODEL = modelMatrix;
@@ -748,6 +1056,73 @@ void VKRenderer::DrawMesh(const VKMesh& mesh, const Matrix44& modelMatrix /*= Ma
 	// Recreate the pipeline
 	m_defaultPipeline->UpdatePipeline();
 
+	VkCommandBuffer cmdBuffer = BeginTemporaryCommandBuffer();
+	int gpuScope = m_gpuProfiler->BeginScope(cmdBuffer, "DrawMesh");
+	BeginCameraRenderPass(cmdBuffer);
+
+	VkBuffer vbo = (VkBuffer) mesh.m_vbo->GetBufferHandle();
+	VkDeviceSize offsets[] = {0};
+	VkBuffer ibo = (VkBuffer) mesh.m_ibo->GetBufferHandle();
+	vkCmdBindVertexBuffers(cmdBuffer, (uint32_t) drawInstruct.m_startIndex, 1, &vbo, offsets );
+	vkCmdBindIndexBuffer(cmdBuffer, ibo, 0, VK_INDEX_TYPE_UINT32);
+
+	vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_defaultPipeline->m_pipelineLayout, 0, (uint32_t) m_activeMaterial->GetDescriptorSets().size(), (VkDescriptorSet*) m_activeMaterial->GetDescriptorSets().data(), 0, nullptr);
+	
+	if(drawInstruct.m_useIndices)
+	{
+		vkCmdDrawIndexed(cmdBuffer, mesh.m_ibo->GetIndexCount(), 1,(uint32_t) drawInstruct.m_startIndex, 0, 0);
+	}
+	else
+	{
+		vkCmdDraw(cmdBuffer, mesh.m_vbo->GetVertexCount(), 1, (uint32_t) drawInstruct.m_startIndex, 0);
+	}
+	vkCmdEndRenderPass(cmdBuffer);
+	m_gpuProfiler->EndScope(cmdBuffer, gpuScope);
+
+	SubmitDrawCommandBuffer(cmdBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Draws triangles with the active material, the vertex count comes from a VkDrawIndirectCommand
+// in the args buffer so the CPU never needs to know it. The vertex shader builds its vertices
+// from storage buffers bound to the material
+//
+void VKRenderer::DrawIndirect(const VKStorageBuffer* argsBuffer, size_t argsOffset, const Matrix44& modelMatrix /*= Matrix44::IDENTITY */)
+{
+	PROFILE_SCOPE_FUNCTION();
+	FlushImmediateBatch(IMMEDIATE_FLUSH_DRAW);
+	ModelBuffer* modelBuffer = m_modelBuffer->As<ModelBuffer>();
+	modelBuffer->MODEL = modelMatrix;
+	m_modelBuffer->UpdateGPU();
+
+	m_defaultPipeline->SetDrawType(PRIMITIVE_TRIANGLES);
+	BindMaterial(m_activeMaterial);
+	m_defaultPipeline->ClearVertexLayout();
+
+	m_currentCamera->m_cameraUBO->UpdateGPU();
+	BindUBO(0, m_currentCamera->m_cameraUBO);
+	BindUBO(1, m_modelBuffer);
+
+	m_defaultPipeline->UpdatePipeline();
+
+	VkCommandBuffer cmdBuffer = BeginTemporaryCommandBuffer();
+	int gpuScope = m_gpuProfiler->BeginScope(cmdBuffer, "DrawIndirect");
+	BeginCameraRenderPass(cmdBuffer);
+
+	vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_defaultPipeline->m_pipelineLayout, 0, (uint32_t) m_activeMaterial->GetDescriptorSets().size(), (VkDescriptorSet*) m_activeMaterial->GetDescriptorSets().data(), 0, nullptr);
+	vkCmdDrawIndirect(cmdBuffer, (VkBuffer) argsBuffer->GetBufferHandle(), (VkDeviceSize) argsOffset, 1, sizeof(VkDrawIndirectCommand));
+
+	vkCmdEndRenderPass(cmdBuffer);
+	m_gpuProfiler->EndScope(cmdBuffer, gpuScope);
+
+	SubmitDrawCommandBuffer(cmdBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Begins the current camera's render pass and binds the default pipeline
+//
+void VKRenderer::BeginCameraRenderPass(VkCommandBuffer cmdBuffer)
+{
 	VkExtent2D renderExtent = {};
 	renderExtent.height = (uint32_t) m_currentCamera->GetViewportMaxs().y;
 	renderExtent.width = (uint32_t) m_currentCamera->GetViewportMaxs().x;
@@ -756,7 +1131,6 @@ void VKRenderer::DrawMesh(const VKMesh& mesh, const Matrix44& modelMatrix /*= Ma
 	renderOffset.x = (int32_t) m_currentCamera->GetViewportMins().x;
 	renderOffset.y = (int32_t) m_currentCamera->GetViewportMins().y;
 
-	VkCommandBuffer cmdBuffer = BeginTemporaryCommandBuffer();
 	VkRenderPassBeginInfo renderPassBeginInfo = {};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassBeginInfo.renderPass = (VkRenderPass) m_currentCamera->GetRenderPass();
@@ -773,39 +1147,26 @@ void VKRenderer::DrawMesh(const VKMesh& mesh, const Matrix44& modelMatrix /*= Ma
 
 	vkCmdBeginRenderPass(cmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 	vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipeline) m_defaultPipeline->GetPipelineHandle());
+}
 
-	VkBuffer vbo = (VkBuffer) mesh.m_vbo->GetBufferHandle();
-	VkDeviceSize offsets[] = {0};
-	VkBuffer ibo = (VkBuffer) mesh.m_ibo->GetBufferHandle();
-	vkCmdBindVertexBuffers(cmdBuffer, (uint32_t) drawInstruct.m_startIndex, 1, &vbo, offsets );
-	vkCmdBindIndexBuffer(cmdBuffer, ibo, 0, VK_INDEX_TYPE_UINT32);
-
-	vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_defaultPipeline->m_pipelineLayout, 0, (uint32_t) m_activeMaterial->GetDescriptorSets().size(), (VkDescriptorSet*) m_activeMaterial->GetDescriptorSets().data(), 0, nullptr);
-	
-	if(drawInstruct.m_useIndices)
-	{
-		vkCmdDrawIndexed(cmdBuffer, mesh.m_ibo->GetIndexCount(), 1,(uint32_t) drawInstruct.m_startIndex, 0, 0);
-	}
-	else
-	{
-		vkCmdDraw(cmdBuffer, mesh.m_vbo->GetVertexCount(), 1, (uint32_t) drawInstruct.m_startIndex, 0);
-	}
-	vkCmdEndRenderPass(cmdBuffer);
-
+//-----------------------------------------------------------------------------------------------
+// Ends and submits a draw command buffer, waits for it and frees it
+//
+void VKRenderer::SubmitDrawCommandBuffer(VkCommandBuffer cmdBuffer)
+{
 	vkEndCommandBuffer(cmdBuffer);
 
 	VkSubmitInfo submitInfo = {};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &cmdBuffer;
-	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.signalSemaphoreCount = m_isHeadless ? 0 : 1; // Headless never waits on it in EndFrame
 	submitInfo.pSignalSemaphores = &m_renderFinishedSemaphore[m_currentFrame];
 
 	vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE); // For now no fences
 	vkQueueWaitIdle(m_graphicsQueue);
 
 	vkFreeCommandBuffers(m_logicalDevice, m_commandPool, 1, &cmdBuffer);
-
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -813,6 +1174,7 @@ void VKRenderer::DrawMesh(const VKMesh& mesh, const Matrix44& modelMatrix /*= Ma
 //
 VKMesh* VKRenderer::CreateOrGetMesh(const std::string& path)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MESH);
 	if(m_loadedMeshes.find(path) != m_loadedMeshes.end())
 	{
 		return m_loadedMeshes.at(path);
@@ -926,6 +1288,9 @@ void VKRenderer::CreateAndGetImage(VkImage* out_image, VkDeviceMemory* out_devMe
 		GUARANTEE_OR_DIE(false, "Cannot allocate memory for the image");
 	}
 
+	eMemoryTag tag = GetCurrentMemoryTag();
+	TrackDeviceMemory(memory, allocationInfo, (tag != MEMORY_TAG_UNTAGGED) ? tag : MEMORY_TAG_TEXTURE);
+
 	vkBindImageMemory(m_logicalDevice, image, memory, 0);
 
 	*out_devMem = memory; 
@@ -1015,9 +1380,9 @@ void VKRenderer::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t widt
 }
 
 //-----------------------------------------------------------------------------------------------
-// Copies one image into another using the copy info
+// Copies one image into another using the copy info, timed on the GPU under the scope name
 //
-void VKRenderer::CopyImages(VkImage dst, VkImageLayout dstLayout, VkImage src, VkImageLayout srcLayout, VkImageCopy copyInfo, VkSemaphore* waitSemaphores, uint32_t waitCount, VkSemaphore* signalSemaphores, uint32_t signalCount)
+void VKRenderer::CopyImages(VkImage dst, VkImageLayout dstLayout, VkImage src, VkImageLayout srcLayout, VkImageCopy copyInfo, VkSemaphore* waitSemaphores, uint32_t waitCount, VkSemaphore* signalSemaphores, uint32_t signalCount, const char* gpuScopeName /*= "CopyImages" */)
 {
 	VkCommandBuffer tempBuffer = BeginTemporaryCommandBuffer();
 
@@ -1032,12 +1397,17 @@ void VKRenderer::CopyImages(VkImage dst, VkImageLayout dstLayout, VkImage src, V
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 
+	int gpuScope = (m_gpuProfiler != nullptr) ? m_gpuProfiler->BeginScope(tempBuffer, gpuScopeName) : -1;
 	vkCmdCopyImage(
 		tempBuffer, 
 		src, srcLayout,
 		dst, dstLayout,
 		1,	&copyInfo
 	);
+	if(m_gpuProfiler != nullptr)
+	{
+		m_gpuProfiler->EndScope(tempBuffer, gpuScope);
+	}
 
 	vkEndCommandBuffer(tempBuffer);
 
@@ -1109,6 +1479,7 @@ void VKRenderer::BindTexture2D(unsigned int index, const VKTexture* texture)
 //
 VKTexture* VKRenderer::CreateOrGetTexture(const std::string& path, bool genMipmaps /*= true*/)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
 	TODO("MIPMAPPING");
 	UNUSED(genMipmaps);
 
@@ -1129,6 +1500,7 @@ VKTexture* VKRenderer::CreateOrGetTexture(const std::string& path, bool genMipma
 //
 VKTexture* VKRenderer::CreateOrGetTexture(const Image& image, bool genMipmaps /*= true*/)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_TEXTURE);
 	TODO("MIPMAPPING");
 	UNUSED(genMipmaps);
 
@@ -1169,6 +1541,7 @@ void VKRenderer::SetDefaultTexture()
 //
 void VKRenderer::CopyTexture2D(VKTexture* dst, VKTexture* src, VkSemaphore* waitSemaphores, uint32_t waitCount, VkSemaphore* signalSemaphores, uint32_t signalCount)
 {
+	FlushImmediateBatch(IMMEDIATE_FLUSH_DRAW);
 	IntVector2 dimensions = src->GetDimensions();
 	VkExtent3D extent = {(uint32_t) dimensions.x, (uint32_t) dimensions.y, 1};
 
@@ -1221,6 +1594,103 @@ VKTexture* VKRenderer::CreateColorTarget(unsigned int width, unsigned int height
 	return CreateRenderTarget(width, height, TEXTURE_FORMAT_RGBA8);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Copies an RGBA8 texture into host memory through a staging buffer, waits for the copy. The
+// texture is moved out of and back into the given layout, an undefined layout is left as a
+// transfer source
+//
+void VKRenderer::ReadTexturePixels(const VKTexture* texture, VkImageLayout layout, std::vector<unsigned char>& out_pixels)
+{
+	PROFILE_SCOPE_FUNCTION();
+	GUARANTEE_OR_DIE(texture->GetFormat() == TEXTURE_FORMAT_RGBA8, "Only RGBA8 textures can be read back");
+	FlushImmediateBatch(IMMEDIATE_FLUSH_READ_BACK);
+
+	IntVector2 dimensions = texture->GetDimensions();
+	VkDeviceSize byteCount = (VkDeviceSize) dimensions.x * (VkDeviceSize) dimensions.y * 4U;
+	VkImage image = (VkImage) texture->GetHandle();
+
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingMemory;
+	CreateAndGetBuffer(&stagingBuffer, &stagingMemory, byteCount, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	VkCommandBuffer tempBuffer = BeginTemporaryCommandBuffer();
+
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.image = image;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	// Wait for color writes and move the image into a transfer source
+	barrier.oldLayout = layout;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier(tempBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1U, &barrier);
+
+	VkBufferImageCopy copyInfo = {};
+	copyInfo.bufferOffset = 0;
+	copyInfo.bufferRowLength = 0;		// Tightly packed
+	copyInfo.bufferImageHeight = 0;
+	copyInfo.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	copyInfo.imageSubresource.baseArrayLayer = 0;
+	copyInfo.imageSubresource.layerCount = 1;
+	copyInfo.imageSubresource.mipLevel = 0;
+	copyInfo.imageOffset = {0,0,0};
+	copyInfo.imageExtent = {(uint32_t) dimensions.x, (uint32_t) dimensions.y, 1};
+	vkCmdCopyImageToBuffer(tempBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer, 1, &copyInfo);
+
+	// Put the image back the way it was found
+	if(layout != VK_IMAGE_LAYOUT_UNDEFINED && layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+	{
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = layout;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		vkCmdPipelineBarrier(tempBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1U, &barrier);
+	}
+
+	EndTemporaryCommandBuffer(tempBuffer); // Waits for the queue to go idle
+
+	void* mappedData = nullptr;
+	vkMapMemory(m_logicalDevice, stagingMemory, 0, byteCount, 0, &mappedData);
+	out_pixels.resize((size_t) byteCount);
+	memcpy(out_pixels.data(), mappedData, (size_t) byteCount);
+	vkUnmapMemory(m_logicalDevice, stagingMemory);
+
+	vkDestroyBuffer(m_logicalDevice, stagingBuffer, nullptr);
+	MemoryTracker::TrackDeviceFree((uint64_t) stagingMemory);
+	vkFreeMemory(m_logicalDevice, stagingMemory, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads the default color target back as RGBA8 rows, top row first. Call after the frame's
+// draws and before EndFrame
+//
+void VKRenderer::ReadColorTargetPixels(std::vector<unsigned char>& out_pixels)
+{
+	// Render passes leave the color target in their final layout
+	VkImageLayout layout = m_isHeadless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	ReadTexturePixels(m_defaultColorTarget, layout, out_pixels);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Reads the default color target back and writes it to a png file
+//
+bool VKRenderer::SaveColorTargetToPng(const char* filename)
+{
+	std::vector<unsigned char> pixels;
+	ReadColorTargetPixels(pixels);
+
+	IntVector2 dimensions = m_defaultColorTarget->GetDimensions();
+	return WriteToPng(filename, pixels.data(), dimensions.x, dimensions.y, 4);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Sets the shader to the default material
 //
@@ -1242,6 +1712,7 @@ void VKRenderer::SetShader(VKShader* shader /*= nullptr */)
 //
 void VKRenderer::SetCamera(VKCamera* cam)
 {
+	FlushImmediateBatch(IMMEDIATE_FLUSH_CAMERA);
 	if(cam == nullptr)
 	{
 		cam = m_defaultCamera;
@@ -1275,6 +1746,18 @@ uint32_t VKRenderer::FindMemoryType(uint32_t requiredTypes, uint32_t requiredPro
 	return UINT32_MAX;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Charges a device memory allocation to a tag and to the heap its memory type lives in
+//
+void VKRenderer::TrackDeviceMemory(VkDeviceMemory memory, const VkMemoryAllocateInfo& allocationInfo, eMemoryTag tag) const
+{
+	VkPhysicalDeviceMemoryProperties memProps = {};
+	vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProps);
+
+	uint32_t heapIndex = memProps.memoryTypes[allocationInfo.memoryTypeIndex].heapIndex;
+	MemoryTracker::TrackDeviceAlloc((uint64_t) memory, allocationInfo.allocationSize, (int) heapIndex, tag);
+}
+
 //-----------------------------------------------------------------------------------------------
 // Creates the buffer and allocates the memory to it
 //
@@ -1307,6 +1790,25 @@ void VKRenderer::CreateAndGetBuffer(VkBuffer* out_buffer, VkDeviceMemory* out_de
 		GUARANTEE_OR_DIE(false, "Cannot allocate memory for the buffer");
 	}
 
+	// Without a tag in scope the usage tells what the buffer is for
+	eMemoryTag tag = GetCurrentMemoryTag();
+	if(tag == MEMORY_TAG_UNTAGGED)
+	{
+		if(usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+		{
+			tag = MEMORY_TAG_STAGING;
+		}
+		else if((usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) != 0)
+		{
+			tag = MEMORY_TAG_MESH;
+		}
+		else
+		{
+			tag = MEMORY_TAG_RENDERER;
+		}
+	}
+	TrackDeviceMemory(memory, allocationInfo, tag);
+
 	vkBindBufferMemory(m_logicalDevice, buffer, memory, 0);
 	
 	*out_buffer = buffer;
@@ -1318,6 +1820,7 @@ void VKRenderer::CreateAndGetBuffer(VkBuffer* out_buffer, VkDeviceMemory* out_de
 //
 void VKRenderer::CopyBuffers(VkBuffer dstBuffer, VkBuffer srcBuffer, VkDeviceSize byteCount) 
 {
+	PROFILE_SCOPE_FUNCTION();
 	VkCommandBuffer tempCmdBuffer = BeginTemporaryCommandBuffer();
 	
 	VkBufferCopy copyInfo = {};
@@ -1333,6 +1836,7 @@ void VKRenderer::CopyBuffers(VkBuffer dstBuffer, VkBuffer srcBuffer, VkDeviceSiz
 //
 VKShaderProgram* VKRenderer::CreateOrGetShaderProgram(const std::string& path, const char* defines /*= nullptr */)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_SHADER);
 	if(path.compare("default") == 0)
 	{
 		//return g_defaultProgram; // Return default shader when requested
@@ -1490,6 +1994,7 @@ void VKRenderer::SetMaterial(const VKMaterial* material /*= nullptr */)
 //
 VKMaterial* VKRenderer::CreateOrGetMaterial(const std::string& path)
 {
+	MEMORY_TAG_SCOPE(MEMORY_TAG_MATERIAL);
 	if(m_loadedMaterials.find(path) != m_loadedMaterials.end())
 	{
 		return m_loadedMaterials.at(path);
@@ -1515,6 +2020,7 @@ void VKRenderer::SetDefaultMaterial()
 //
 void VKRenderer::ResetDefaultMaterial()
 {
+	FlushImmediateBatch(IMMEDIATE_FLUSH_MATERIAL_RESET);
 	delete m_defaultMaterial;
 	m_defaultMaterial = m_defaultMaterialShared->Clone();
 }
@@ -1541,11 +2047,68 @@ void VKRenderer::BindUBO(int bindPoint, const VKUniformBuffer* ubo)
 	vkUpdateDescriptorSets(m_logicalDevice, 1, &uboWrite, 0, nullptr);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Binds a storage buffer to the active material
+//
+void VKRenderer::BindStorageBuffer(int bindPoint, const VKStorageBuffer* ssbo)
+{
+	BindStorageBuffer(m_activeMaterial->GetDescriptorSets()[RESERVED_SLOT_STORAGE_BUFFER], bindPoint, ssbo);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes a storage buffer to a binding of the descriptor set
+//
+void VKRenderer::BindStorageBuffer(void* descriptorSet, int bindPoint, const VKStorageBuffer* ssbo)
+{
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer = (VkBuffer) ssbo->GetBufferHandle();
+	bufferInfo.offset = 0;
+	bufferInfo.range = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet ssboWrite = {};
+	ssboWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	ssboWrite.dstBinding = bindPoint;
+	ssboWrite.dstArrayElement = 0;
+	ssboWrite.dstSet = (VkDescriptorSet) descriptorSet;
+	ssboWrite.descriptorCount = 1;
+	ssboWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	ssboWrite.pBufferInfo = &bufferInfo;
+
+	vkUpdateDescriptorSets(m_logicalDevice, 1, &ssboWrite, 0, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates a compute pipeline for the program. The push constant range, if any, starts at 0
+//
+VKPipeline* VKRenderer::CreateComputePipeline(const VKShaderProgram* program, uint32_t pushConstantSize /*= 0 */)
+{
+	GUARANTEE_OR_DIE(program->IsCompute(), "Compute pipeline needs a compute program");
+
+	VKPipeline* pipeline = new VKPipeline(this);
+	pipeline->SetShaderStages(program->GetActiveModules());
+	pipeline->SetDescriptorSetLayouts(program->GetDescSetLayouts().size(), (void*) program->GetDescSetLayouts().data());
+	pipeline->SetPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, pushConstantSize);
+	pipeline->UpdateComputePipeline();
+
+	return pipeline;
+}
+
 //-----------------------------------------------------------------------------------------------
 // End of frame
 //
 void VKRenderer::EndFrame()
 {
+	PROFILE_SCOPE_FUNCTION();
+	FlushImmediateBatch(IMMEDIATE_FLUSH_END_FRAME);
+	m_lastImmediateStats = m_immediateStats;
+	m_immediateStats = VKImmediateStats();
+
+	if(m_isHeadless) // Draws are already waited on, the color target stays for read back
+	{
+		m_currentFrame = (m_currentFrame+1) % MAX_FRAMES_IN_FLIGHT;
+		return;
+	}
+
 	IntVector2 dimensions = m_defaultColorTarget->GetDimensions();
 	VkExtent3D extent = {(uint32_t) dimensions.x, (uint32_t) dimensions.y, 1};
 	VkImageCopy swapCopyInfo = {};
@@ -1581,7 +2144,8 @@ void VKRenderer::EndFrame()
 		(VkImage) m_defaultColorTarget->GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 		swapCopyInfo,
 		waitSemaphores, 2,
-		&m_colorTargetAvailableSemaphore[m_currentFrame], 1
+		&m_colorTargetAvailableSemaphore[m_currentFrame], 1,
+		"PresentCopy"
 	);
 
 	TransitionImageLayout(
@@ -1626,6 +2190,19 @@ VKRenderer* VKRenderer::CreateInstance( const char* appName )
 	return g_renderer;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Creates a VkRenderer Instance that renders offscreen without a window
+//
+VKRenderer* VKRenderer::CreateHeadlessInstance( const char* appName, uint32_t width, uint32_t height )
+{
+	if(!g_renderer)
+	{
+		g_renderer = new VKRenderer( appName, width, height );
+	}
+
+	return g_renderer;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Destroys the VkRenderer instance
 //
@@ -1646,6 +2223,57 @@ VKRenderer* VKRenderer::GetInstance()
 	return g_renderer;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Prints the immediate draws of the last frame, how many batches they took and what broke them
+//
+STATIC bool VKRenderer::ImmediateStatsCommand(Command& cmd)
+{
+	UNUSED(cmd);
+	if(g_renderer == nullptr)
+	{
+		ConsolePrintf(Rgba::RED, "The renderer is not running");
+		return false;
+	}
+
+	const VKImmediateStats& stats = g_renderer->GetImmediateStats();
+	ConsolePrintf("%d immediate draws, %d vertices, in %d batches", stats.m_drawCount, stats.m_vertexCount, stats.m_batchCount);
+	for(int reasonIndex = 0; reasonIndex < NUM_IMMEDIATE_FLUSH_REASONS; ++reasonIndex)
+	{
+		if(stats.m_flushCounts[reasonIndex] > 0)
+		{
+			ConsolePrintf("  %-16s %d", s_immediateFlushReasonNames[reasonIndex], stats.m_flushCounts[reasonIndex]);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// True when a draw with the other state can be appended to a batch with this one
+//
+bool VKImmediateBatchState::IsSameAs(const VKImmediateBatchState& other) const
+{
+	if(m_material != other.m_material || m_shader != other.m_shader || m_drawType != other.m_drawType || m_textureCount != other.m_textureCount)
+	{
+		return false;
+	}
+
+	for(int texIdx = 0; texIdx < m_textureCount; ++texIdx)
+	{
+		if(m_textures[texIdx] != other.m_textures[texIdx])
+		{
+			return false;
+		}
+	}
+
+	const RenderState& a = m_renderState;
+	const RenderState& b = other.m_renderState;
+	return a.m_cullMode == b.m_cullMode && a.m_fillMode == b.m_fillMode && a.m_frontFace == b.m_frontFace
+		&& a.m_depthCompare == b.m_depthCompare && a.m_depthWrite == b.m_depthWrite
+		&& a.m_colorBlendOp == b.m_colorBlendOp && a.m_colorSrcFactor == b.m_colorSrcFactor && a.m_colorDstFactor == b.m_colorDstFactor
+		&& a.m_alphaBlendOp == b.m_alphaBlendOp && a.m_alphaSrcFactor == b.m_alphaSrcFactor && a.m_alphaDstFactor == b.m_alphaDstFactor;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Debug callback when validation is enabled
 //
@@ -1711,7 +2339,7 @@ bool VKRenderer::CheckExtensionsSupport()
 	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data()); 
 
 	// Iterate through requested extensions layers
-	for(const char* extensionName : s_globalExtensions)
+	for(const char* extensionName : GetRequestedGlobalExtensions())
 	{
 		// Check availability of requested extensions
 		bool extensionFound = false; // To support multiple extensions layers
@@ -6,6 +6,10 @@
 #include "Engine/Core/XMLUtils.hpp"
 #include "Engine/Enumerations/TextureFormat.hpp"
 #include "Engine/Enumerations/ShaderStageSlot.hpp"
+#include "Engine/Enumerations/MemoryTag.hpp"
+#include "Engine/Enumerations/DrawPrimitiveType.hpp"
+#include "Engine/Enumerations/ImmediateFlushReason.hpp"
+#include "Engine/Structures/RenderState.hpp"
 #include <vector>
 #include <map>
 
@@ -13,6 +17,8 @@
 // Constants
 constexpr int QUEUE_FAMILY_INDICES_MAX = 16;
 constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+constexpr int VK_IMMEDIATE_VERTICES_PER_FRAME = 65536;	// Per frame in flight, a batch that does not fit is split
+constexpr int VK_IMMEDIATE_BATCH_TEXTURE_SLOTS = 4;		// Texture slots a batch remembers, the rest are bound as the material has them
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -21,7 +27,6 @@ class Matrix44;
 enum VKRenderType;
 enum eTextureFormat;
 class VKVertexBuffer;
-class VKIndexBuffer;
 class VKTexture;
 class VKShaderProgram;
 class Image;
@@ -32,7 +37,10 @@ class VKMaterial;
 class VKMesh;
 class VKPipeline;
 class VKUniformBuffer;
+class VKStorageBuffer;
+class VKGpuProfiler;
 class VKCamera;
+class Command;
 struct VertexLayout;
 struct RenderState;
 enum DrawPrimitiveType;
@@ -83,6 +91,37 @@ struct ModelBuffer
 	Matrix44 MODEL;
 };
 
+//-----------------------------------------------------------------------------------------------
+// State an immediate draw is batched under, a draw with different state starts a new batch. The
+// state is copied so a batch draws as it was set up even when the material changes afterwards
+//
+struct VKImmediateBatchState
+{
+	//-----------------------------------------------------------------------------------------------
+	// Methods
+	bool IsSameAs( const VKImmediateBatchState& other ) const;
+
+	//-----------------------------------------------------------------------------------------------
+	// Members
+	const VKMaterial*	m_material = nullptr;
+	const VKShader*		m_shader = nullptr;
+	const VKTexture*	m_textures[VK_IMMEDIATE_BATCH_TEXTURE_SLOTS];
+	int					m_textureCount = 0;
+	RenderState			m_renderState;
+	DrawPrimitiveType	m_drawType = PRIMITIVE_TRIANGLES;	// Always a list type
+};
+
+//-----------------------------------------------------------------------------------------------
+// Immediate draw counters of one frame
+//
+struct VKImmediateStats
+{
+	int		m_drawCount = 0;		// DrawMeshImmediate calls
+	int		m_batchCount = 0;		// Draw calls they were merged into
+	int		m_vertexCount = 0;		// After strips and loops became lists
+	int		m_flushCounts[NUM_IMMEDIATE_FLUSH_REASONS] = {};
+};
+
 //-----------------------------------------------------------------------------------------------
 class VKRenderer
 {
@@ -90,6 +129,7 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Constructors/Destructors
 	VKRenderer( const char* appName );
+	VKRenderer( const char* appName, uint32_t headlessWidth, uint32_t headlessHeight ); // No window, surface or swapchain
 	~VKRenderer();
 	
 	//-----------------------------------------------------------------------------------------------
@@ -98,10 +138,16 @@ public:
 			VkPhysicalDevice		GetPhysicalDevice() const { return m_physicalDevice; }
 			VKTexture*			GetDefaultColorTarget() const { return m_defaultColorTarget; }
 			VKTexture*			GetDefaultDepthTarget() const { return m_defaultDepthTarget; }
+			VKGpuProfiler*			GetGpuProfiler() const { return m_gpuProfiler; }
+			bool				IsHeadless() const { return m_isHeadless; }
+			const VKImmediateStats&		GetImmediateStats() const { return m_lastImmediateStats; } // Of the last ended frame
 	
 	//-----------------------------------------------------------------------------------------------
 	// Vulkan Initialization Operations
 private:
+			void				Initialize( const char* appName );
+			std::vector<const char*>	GetRequestedGlobalExtensions() const;
+			std::vector<const char*>	GetRequestedDeviceExtensions() const;
 			bool				CheckValidationLayerSupport();
 			bool				CheckExtensionsSupport();
 			void				SetupDebugCallback();
@@ -120,7 +166,6 @@ private:
 			void				CreateImageViews();
 			void				CreateCommandPool();
 			void				CreateVertexBuffer();
-			void				CreateIndexBuffer();
 			void				CreateSyncStuff();
 			void				CleanupSwapchain();
 			void				RecreateSwapchain();
@@ -134,8 +179,15 @@ public:
 
 	//-----------------------------------------------------------------------------------------------
 	// Draw commands
-			void				DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, DrawPrimitiveType mode, const Matrix44& modelMatrix);
+			void				DrawMeshImmediate(const Vertex_3DPCU* vertices, int numVerts, DrawPrimitiveType mode, const Matrix44& modelMatrix); // Batched, drawn on the next flush
+			void				FlushImmediateBatch( eImmediateFlushReason reason ); // Draws the pending immediate vertices
 			void				DrawMesh( const VKMesh& mesh, const Matrix44& modelMatrix = Matrix44::IDENTITY );
+			void				DrawIndirect( const VKStorageBuffer* argsBuffer, size_t argsOffset, const Matrix44& modelMatrix = Matrix44::IDENTITY ); // No vertex input, VkDrawIndirectCommand read on the GPU
+private:
+			void				BeginCameraRenderPass( VkCommandBuffer cmdBuffer );
+			void				SubmitDrawCommandBuffer( VkCommandBuffer cmdBuffer );
+			VKImmediateBatchState		GetImmediateBatchState( DrawPrimitiveType listType ) const;
+public:
 
 	//-----------------------------------------------------------------------------------------------
 	// Mesh functions
@@ -152,7 +204,7 @@ public:
 			VkImageView			CreateAndGetImageView( VkImage image, VkFormat format, VkImageAspectFlags aspectFlags );
 			void				TransitionImageLayout( VkImage image, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkAccessFlags srcMask, VkAccessFlags dstMask );
 			void				CopyBufferToImage( VkBuffer buffer, VkImage image, uint32_t width, uint32_t height );
-			void				CopyImages( VkImage dst, VkImageLayout dstLayout, VkImage src, VkImageLayout srcLayout, VkImageCopy copyInfo, VkSemaphore* waitSemaphore = nullptr, uint32_t waitCount = 0, VkSemaphore* signalSemaphores = nullptr, uint32_t signalCount = 0 );
+			void				CopyImages( VkImage dst, VkImageLayout dstLayout, VkImage src, VkImageLayout srcLayout, VkImageCopy copyInfo, VkSemaphore* waitSemaphore = nullptr, uint32_t waitCount = 0, VkSemaphore* signalSemaphores = nullptr, uint32_t signalCount = 0, const char* gpuScopeName = "CopyImages" );
 
 	//-----------------------------------------------------------------------------------------------
 	// Texture Helpers
@@ -169,6 +221,9 @@ public:
 			VKTexture*			CreateRenderTarget(unsigned int width, unsigned int height, eTextureFormat fmt = TEXTURE_FORMAT_RGBA8);
 			VKTexture*			CreateDepthStencilTarget( unsigned int width, unsigned int height );
 			VKTexture*			CreateColorTarget( unsigned int width, unsigned int height );
+			void				ReadTexturePixels( const VKTexture* texture, VkImageLayout layout, std::vector<unsigned char>& out_pixels ); // RGBA8 color textures only
+			void				ReadColorTargetPixels( std::vector<unsigned char>& out_pixels );
+			bool				SaveColorTargetToPng( const char* filename );
 
 	//-----------------------------------------------------------------------------------------------
 	// Shader functions
@@ -196,12 +251,18 @@ public:
 	//-----------------------------------------------------------------------------------------------
 	// Setting uniforms on shaders
 			void				BindUBO( int bindPoint, const VKUniformBuffer* ubo );
+			void				BindStorageBuffer( int bindPoint, const VKStorageBuffer* ssbo );
+			void				BindStorageBuffer( void* descriptorSet, int bindPoint, const VKStorageBuffer* ssbo );
 			void				SetUniform( const char* name, float value );
 			void				SetUniform( const char* name, int value );
 			void				SetUniform( const char* name, const Rgba& color );
 			void				SetUniform( const char* name, const Matrix44& matrix, bool transpose = false );
 			void				SetUniform( const char* name, const Vector3& value );
 
+	//-----------------------------------------------------------------------------------------------
+	// Compute functions
+			VKPipeline*			CreateComputePipeline( const VKShaderProgram* program, uint32_t pushConstantSize = 0 ); // Caller owns the pipeline
+
 	//-----------------------------------------------------------------------------------------------
 	// Camera Functions
 			void				SetCamera(VKCamera* cam);
@@ -213,13 +274,19 @@ public:
 									   VkDeviceSize size, VkBufferUsageFlags usage, 
 									   VkMemoryPropertyFlags props );
 			void				CopyBuffers( VkBuffer dstBuffer, VkBuffer srcBuffer, VkDeviceSize byteCount );
+			void				TrackDeviceMemory( VkDeviceMemory memory, const VkMemoryAllocateInfo& allocationInfo, eMemoryTag tag ) const; // Charges it to the memory tracker
 	
 	//-----------------------------------------------------------------------------------------------
 	// Static methods
 	static		VKRenderer*			CreateInstance( const char* appName );
+	static		VKRenderer*			CreateHeadlessInstance( const char* appName, uint32_t width, uint32_t height );
 	static		void				DestroyInstance();
 	static		VKRenderer*			GetInstance();
 
+	//-----------------------------------------------------------------------------------------------
+	// Command Callbacks
+	static		bool				ImmediateStatsCommand( Command& cmd );
+
 	// Debug callback
 	static	VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(VkDebugReportFlagsEXT flags,
 		VkDebugReportObjectTypeEXT objType,
@@ -239,9 +306,9 @@ private:
 			VkPhysicalDevice				m_physicalDevice = VK_NULL_HANDLE;
 			VkDevice					m_logicalDevice = VK_NULL_HANDLE;
 			VkQueue						m_graphicsQueue;
-			VkSurfaceKHR					m_surface;
+			VkSurfaceKHR					m_surface = VK_NULL_HANDLE;
 			VkQueue						m_presentQueue;
-			VkSwapchainKHR					m_swapChain;
+			VkSwapchainKHR					m_swapChain = VK_NULL_HANDLE;
 			VkExtent2D					m_swapChainExtent;
 			VkFormat					m_swapChainImageFormat;
 			std::vector<VkImage>				m_swapChainImages;
@@ -256,6 +323,8 @@ private:
 			std::vector<VkSemaphore>			m_renderFinishedSemaphore;
 			std::vector<VkSemaphore>			m_colorTargetAvailableSemaphore;
 			std::vector<VkFence>				m_fences;
+			bool						m_isPipelineStatisticsEnabled = false;
+			bool						m_isHeadless = false;			// Renders only into the default color target
 	
 	//-----------------------------------------------------------------------------------------------
 	// Data Members
@@ -263,8 +332,14 @@ private:
 			std::map<std::string,VKShaderProgram*>		m_loadedShaderPrograms;
 			std::map<std::string,VKMesh*>			m_loadedMeshes;
 			std::map<std::string,VKMaterial*>		m_loadedMaterials;
-			VKVertexBuffer*					m_immediateVBO;
-			VKIndexBuffer*					m_immediateIBO;
+			VKVertexBuffer*					m_immediateVBO = nullptr;		// Host visible, a range of VK_IMMEDIATE_VERTICES_PER_FRAME per frame in flight
+			Vertex_3DPCU*					m_immediateVertices = nullptr;	// Stays mapped
+			uint32_t					m_immediateCursor = 0;			// Next free vertex in the frame's range
+			uint32_t					m_immediateBatchStart = 0;
+			uint32_t					m_immediateBatchCount = 0;
+			VKImmediateBatchState				m_immediateBatch;
+			VKImmediateStats				m_immediateStats;
+			VKImmediateStats				m_lastImmediateStats;
 			VKTexture*					m_immediateTexture = nullptr;
 			VKTexture*					m_defaultTexture = nullptr;
 			VkDescriptorSetLayout				m_descriptorSetLayout;
@@ -285,6 +360,7 @@ private:
 			VkBuffer					m_ubo;
 			VkDeviceMemory					m_uboMemory;
 			VkDescriptorSet					m_descriptorSet;
+			VKGpuProfiler*					m_gpuProfiler = nullptr;
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -10,10 +10,6 @@
 #include "Engine/VulkanRenderer/VKRenderer.hpp"
 //-----------------------------------------------------------------------------------------------
 
-//-----------------------------------------------------------------------------------------------
-// Static globals
-VkDescriptorType descriptorTypes[] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER};
-
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -76,6 +72,24 @@ std::vector<VKShaderStage*> VKShaderProgram::GetActiveModules() const
 	return activeStages;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if any stage declares the binding. Compilers drop unused resources, so kernels
+// sharing buffer slots do not all see the same bindings
+//
+bool VKShaderProgram::HasBinding(int setIndex, uint32_t binding) const
+{
+	for(VKShaderStage* stage : GetActiveModules())
+	{
+		BindingList list = stage->GetBindingList(setIndex);
+		if(binding < list.size() && list[binding].binding == binding)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 //-----------------------------------------------------------------------------------------------
 // Returns the vertex shader module
 //
@@ -92,6 +106,14 @@ void* VKShaderProgram::GetFragmentModule() const
 	return m_shaderStages[SHADER_STAGE_FRAGMENT]->GetShaderModule();
 }
 
+//-----------------------------------------------------------------------------------------------
+// Returns the compute shader module
+//
+void* VKShaderProgram::GetComputeModule() const
+{
+	return m_shaderStages[SHADER_STAGE_COMPUTE]->GetShaderModule();
+}
+
 //-----------------------------------------------------------------------------------------------
 // Loads a shader program from source string
 //
@@ -109,39 +131,63 @@ bool VKShaderProgram::LoadShaderFromSource(const char* vsPath, const char* fsPat
 }
 
 //-----------------------------------------------------------------------------------------------
-// Creates the descriptor set layouts from the program stages
+// Loads a compute only program from source string
+//
+bool VKShaderProgram::LoadComputeFromSource(const char* csPath, const char* csSource, const char* defines)
+{
+	m_shaderStages[SHADER_STAGE_COMPUTE] = new VKShaderStage(csPath, "compute", csSource, m_renderer, defines);
+
+	CreateDescriptorSetLayouts();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Creates the descriptor set layouts from the program stages. A binding used by several stages
+// is visible to all of them
 //
 void VKShaderProgram::CreateDescriptorSetLayouts()
 {
-	VKShaderStage* vertStage = m_shaderStages[SHADER_STAGE_VERTEX];
-	VKShaderStage* fragStage = m_shaderStages[SHADER_STAGE_FRAGMENT];
-	int vertBindSetCount = (int) vertStage->GetBindingListSetCount();
-	int fragBindSetCount = (int) fragStage->GetBindingListSetCount();
+	std::vector<VKShaderStage*> stages = GetActiveModules();
 
-	int count = Max(vertBindSetCount, fragBindSetCount);
+	int count = 0;
+	for(VKShaderStage* stage : stages)
+	{
+		count = Max(count, (int) stage->GetBindingListSetCount());
+	}
 
 	std::vector<BindingList> combinedList(count);
 	for(int setIndex = 0; setIndex < count; ++setIndex)
 	{
-		BindingList vertList = vertStage->GetBindingList(setIndex);
-		BindingList fragList = fragStage->GetBindingList(setIndex);
-
-		int vertBindCount = (int) vertList.size();
-		int fragBindCount = (int) fragList.size();
-		combinedList[setIndex].resize(Max(vertBindCount, fragBindCount));
-
-		for(size_t bindIndex = 0; bindIndex < vertList.size(); ++bindIndex)
+		for(VKShaderStage* stage : stages)
 		{
-			if (vertList[bindIndex].binding != UINT32_MAX) // To prevent overwriting
+			BindingList stageList = stage->GetBindingList(setIndex);
+			if(stageList.size() > combinedList[setIndex].size())
 			{
-				combinedList[setIndex][bindIndex] = vertList[bindIndex];
+				combinedList[setIndex].resize(stageList.size());
+			}
+
+			for(size_t bindIndex = 0; bindIndex < stageList.size(); ++bindIndex)
+			{
+				if (stageList[bindIndex].binding == UINT32_MAX) // To prevent overwriting
+				{
+					continue;
+				}
+
+				VkShaderStageFlags usedBy = combinedList[setIndex][bindIndex].stageFlags;
+				combinedList[setIndex][bindIndex] = stageList[bindIndex];
+				combinedList[setIndex][bindIndex].stageFlags |= usedBy;
 			}
 		}
-		for(size_t bindIndex = 0; bindIndex < fragList.size(); ++bindIndex)
+	}
+
+	// Drop the binding slots no stage uses, they would all alias binding 0
+	for(BindingList& list : combinedList)
+	{
+		for(size_t bindIndex = list.size(); bindIndex > 0; --bindIndex)
 		{
-			if (fragList[bindIndex].binding != UINT32_MAX) // To prevent overwriting
+			if(list[bindIndex - 1].descriptorCount == 0)
 			{
-				combinedList[setIndex][bindIndex] = fragList[bindIndex];
+				list.erase(list.begin() + (bindIndex - 1));
 			}
 		}
 	}
@@ -149,7 +195,6 @@ void VKShaderProgram::CreateDescriptorSetLayouts()
 	m_descriptorSetLayouts.resize(combinedList.size());
 	m_descriptorPools.resize(combinedList.size());
 
-	//std::vector<VkDescriptorPoolSize> poolSizes;
 	// Iterate over the combinedlist to create the DescriptorSetLayouts and pools
 	for(size_t index = 0; index < combinedList.size(); ++index)
 	{
@@ -165,16 +210,39 @@ void VKShaderProgram::CreateDescriptorSetLayouts()
 			GUARANTEE_OR_DIE(false, "Can't create descriptor set layout");
 		}
 
-		VkDescriptorPoolSize poolSize = {};
-		poolSize.type = descriptorTypes[index];
-		poolSize.descriptorCount = descriptorCount;
-		//poolSizes.push_back(poolSize);
+		// One pool size per descriptor type used in the set
+		std::vector<VkDescriptorPoolSize> poolSizes;
+		for(const VkDescriptorSetLayoutBinding& binding : combinedList[index])
+		{
+			size_t sizeIndex = 0;
+			while(sizeIndex < poolSizes.size() && poolSizes[sizeIndex].type != binding.descriptorType)
+			{
+				sizeIndex++;
+			}
+
+			if(sizeIndex == poolSizes.size())
+			{
+				VkDescriptorPoolSize poolSize = {};
+				poolSize.type = binding.descriptorType;
+				poolSizes.push_back(poolSize);
+			}
+			poolSizes[sizeIndex].descriptorCount++;
+		}
+
+		if(poolSizes.empty())
+		{
+			// Unused set below a used one, the pool still needs a size to allocate the empty set from
+			VkDescriptorPoolSize poolSize = {};
+			poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			poolSize.descriptorCount = 1;
+			poolSizes.push_back(poolSize);
+		}
 
 		VkDescriptorPoolCreateInfo poolInfo = {};
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		poolInfo.maxSets = 1;
-		poolInfo.poolSizeCount = 1;
-		poolInfo.pPoolSizes = &poolSize;
+		poolInfo.poolSizeCount = (uint32_t) poolSizes.size();
+		poolInfo.pPoolSizes = poolSizes.data();
 		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
 
 		if(vkCreateDescriptorPool(m_renderer->GetLogicalDevice(), &poolInfo, nullptr, (VkDescriptorPool*) &m_descriptorPools[index]) != VK_SUCCESS)
@@ -182,8 +250,6 @@ void VKShaderProgram::CreateDescriptorSetLayouts()
 			GUARANTEE_OR_DIE(false, "Can't create descriptor pools");
 		}
 	}
-
-	
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -208,3 +274,19 @@ bool VKShaderProgram::LoadFromFiles(const char* vsPath, const char* fsPath /*= n
 	return LoadShaderFromSource(vsFile.c_str(), fsFile.c_str(), vsSrc, fsSrc, defines);
 }
 
+//-----------------------------------------------------------------------------------------------
+// Loads a compute only program from file, the .comp extension is added to the path
+//
+bool VKShaderProgram::LoadComputeFromFile(const char* csPath, const char* defines /*= nullptr */)
+{
+	std::string csFile = csPath;
+	csFile += ".comp";
+
+	const char* csSrc = (char*) FileReadToNewBuffer(csFile.c_str());
+	GUARANTEE_OR_DIE(csSrc != nullptr, "Compute shader file not found");
+
+	bool result = LoadComputeFromSource(csFile.c_str(), csSrc, defines);
+	free((void*) csSrc);
+
+	return result;
+}
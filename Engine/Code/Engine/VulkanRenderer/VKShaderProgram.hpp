@@ -23,6 +23,9 @@ public:
 			std::vector<VKShaderStage*>		GetActiveModules() const;
 			void*							GetVertexModule() const;
 			void*							GetFragmentModule() const;
+			void*							GetComputeModule() const;
+			bool							IsCompute() const { return m_shaderStages[SHADER_STAGE_COMPUTE] != nullptr; }
+			bool							HasBinding( int setIndex, uint32_t binding ) const; // True if any stage uses it
 	const	std::vector<void*>&				GetDescSetLayouts() const { return m_descriptorSetLayouts; }
 			std::vector<void*>&				GetDescSetLayouts() { return m_descriptorSetLayouts; }
 			std::vector<void*>&				GetDescPools() { return m_descriptorPools; }
@@ -33,6 +36,8 @@ public:
 			bool	LoadShaderFromSource(const char* vsPath, const char* fsPath, const char* vsSource, const char* fsSource, const char* defines = nullptr ); // Loads a shader program from the source
 			void	CreateDescriptorSetLayouts();
 			bool	LoadFromFiles( const char* vsPath, const char* fsPath = nullptr, const char* defines = nullptr ); // load a shader from file
+			bool	LoadComputeFromSource( const char* csPath, const char* csSource, const char* defines = nullptr );
+			bool	LoadComputeFromFile( const char* csPath, const char* defines = nullptr ); // load a compute shader from file
 
 	//-----------------------------------------------------------------------------------------------
 	// Members
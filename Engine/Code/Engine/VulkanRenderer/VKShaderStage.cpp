@@ -19,7 +19,8 @@
 static const std::map<std::string, VkDescriptorType>  ParseDescriptorType
 {
 	{"ubo", VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},
-	{"imgsampler", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER}
+	{"imgsampler", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER},
+	{"ssbo", VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -27,7 +28,8 @@ static const std::map<std::string, VkDescriptorType>  ParseDescriptorType
 static const std::map<std::string, VkShaderStageFlags> ParseStageFlags
 {
 	{"vertex", VK_SHADER_STAGE_VERTEX_BIT},
-	{"fragment", VK_SHADER_STAGE_FRAGMENT_BIT}
+	{"fragment", VK_SHADER_STAGE_FRAGMENT_BIT},
+	{"compute", VK_SHADER_STAGE_COMPUTE_BIT}
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -130,7 +132,7 @@ void* VKShaderStage::GetShaderModule() const
 //
 BindingList VKShaderStage::GetBindingList(int setIndex) const
 {
-	if(setIndex > m_bindingLists.size() - 1)
+	if(setIndex >= (int) m_bindingLists.size())
 	{
 		return BindingList(); 
 	}
@@ -191,38 +193,7 @@ bool VKShaderStage::ReflectAndCreateBindings(std::vector<uint32_t>& byteCode)
 	{
 		uint32_t set = compiler.get_decoration(ubo.id, spv::DecorationDescriptorSet);
 		uint32_t binding = compiler.get_decoration(ubo.id, spv::DecorationBinding);
-
-		if(set >= m_bindingLists.size())
-		{
-			// Create the slots for the sets to populate
-			int diff = set - (int) m_bindingLists.size() + 1;
-			int index = 0;
-			do 
-			{
-				m_bindingLists.push_back(BindingList());
-				index++;
-			} while (index < diff);
-		}
-
-		if(binding >= m_bindingLists[set].size())
-		{
-			// Create the slots for the bindings in the corresponding set to populate
-			int diff = binding - (int) m_bindingLists[set].size() + 1;
-			int index = 0;
-			do 
-			{
-				VkDescriptorSetLayoutBinding bind = {};
-				bind.binding = UINT32_MAX;
-				m_bindingLists[set].push_back(bind);
-				index++;
-			} while (index < diff);
-		}
-
-		m_bindingLists[set][binding].binding = binding;
-		m_bindingLists[set][binding].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		m_bindingLists[set][binding].descriptorCount = 1;
-		m_bindingLists[set][binding].pImmutableSamplers = nullptr;
-		m_bindingLists[set][binding].stageFlags = GetVKShaderStageFlag(m_stage);
+		AddReflectedBinding(set, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
 	}
 
 	// Combined samplers
@@ -230,40 +201,54 @@ bool VKShaderStage::ReflectAndCreateBindings(std::vector<uint32_t>& byteCode)
 	{
 		uint32_t set = compiler.get_decoration(combSampler.id, spv::DecorationDescriptorSet);
 		uint32_t binding = compiler.get_decoration(combSampler.id, spv::DecorationBinding);
+		AddReflectedBinding(set, binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+	}
 
-		if(set >= m_bindingLists.size())
-		{
-			// Create the slots for the sets to populate
-			int diff = set - (int) m_bindingLists.size() + 1;
-			int index = 0;
-			do 
-			{
-				m_bindingLists.push_back(BindingList());
-				index++;
-			} while (index < diff);
-		}
+	// Storage buffers
+	for(auto& ssbo : resources.storage_buffers)
+	{
+		uint32_t set = compiler.get_decoration(ssbo.id, spv::DecorationDescriptorSet);
+		uint32_t binding = compiler.get_decoration(ssbo.id, spv::DecorationBinding);
+		AddReflectedBinding(set, binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+	}
 
-		if(binding >= m_bindingLists[set].size())
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Adds a reflected descriptor to the binding lists, growing the set and binding slots as needed
+//
+void VKShaderStage::AddReflectedBinding(uint32_t set, uint32_t binding, VkDescriptorType type)
+{
+	if(set >= m_bindingLists.size())
+	{
+		// Create the slots for the sets to populate
+		int diff = set - (int) m_bindingLists.size() + 1;
+		int index = 0;
+		do 
 		{
-			// Create the slots for the bindings in the corresponding set to populate
-			int diff = binding - (int) m_bindingLists[set].size() + 1;
-			int index = 0;
-			do 
-			{
-				VkDescriptorSetLayoutBinding bind = {};
-				bind.binding = UINT32_MAX;
-				m_bindingLists[set].push_back(bind);
-				index++;
-			} while (index < diff);
-		}
+			m_bindingLists.push_back(BindingList());
+			index++;
+		} while (index < diff);
+	}
 
-		m_bindingLists[set][binding].binding = binding;
-		m_bindingLists[set][binding].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		m_bindingLists[set][binding].descriptorCount = 1;
-		m_bindingLists[set][binding].pImmutableSamplers = nullptr;
-		m_bindingLists[set][binding].stageFlags = GetVKShaderStageFlag(m_stage);
+	if(binding >= m_bindingLists[set].size())
+	{
+		// Create the slots for the bindings in the corresponding set to populate
+		int diff = binding - (int) m_bindingLists[set].size() + 1;
+		int index = 0;
+		do 
+		{
+			VkDescriptorSetLayoutBinding bind = {};
+			bind.binding = UINT32_MAX;
+			m_bindingLists[set].push_back(bind);
+			index++;
+		} while (index < diff);
 	}
 
-	return true;
+	m_bindingLists[set][binding].binding = binding;
+	m_bindingLists[set][binding].descriptorType = type;
+	m_bindingLists[set][binding].descriptorCount = 1;
+	m_bindingLists[set][binding].pImmutableSamplers = nullptr;
+	m_bindingLists[set][binding].stageFlags = GetVKShaderStageFlag(m_stage);
 }
-
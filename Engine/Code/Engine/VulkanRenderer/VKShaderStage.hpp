@@ -36,6 +36,7 @@ public:
 	void*			CreateShaderModule(void* byteCode, size_t size);
 	bool			LoadShaderFromSource(const std::string& path, const std::string& src, const char* defines = nullptr ); // Loads the shader stage from the source
 	bool			ReflectAndCreateBindings( std::vector<uint32_t>& byteCode );
+	void			AddReflectedBinding( uint32_t set, uint32_t binding, VkDescriptorType type );
 	
 	//-----------------------------------------------------------------------------------------------
 	// Members
@@ -8,6 +8,7 @@
 #include "Engine/VulkanRenderer/VKRenderer.hpp"
 #include "Engine/VulkanRenderer/VKFunctions.hpp"
 #include "Engine/VulkanRenderer/VKTexSampler.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
@@ -66,6 +67,7 @@ VKTexture::~VKTexture()
 
 	vkDestroyImageView(device, (VkImageView) m_viewHandle, nullptr);
 	vkDestroyImage(device, (VkImage) m_texHandle, nullptr);
+	MemoryTracker::TrackDeviceFree((uint64_t) (VkDeviceMemory) m_memHandle);
 	vkFreeMemory(device, (VkDeviceMemory) m_memHandle, nullptr);
 }
 
@@ -234,6 +236,7 @@ void VKTexture::PopulateFromData(unsigned char* imageData, const IntVector2& tex
 	);
 
 	vkDestroyBuffer(m_renderer.GetLogicalDevice(), stagingBuffer, nullptr);
+	MemoryTracker::TrackDeviceFree((uint64_t) stagingMemory);
 	vkFreeMemory(m_renderer.GetLogicalDevice(), stagingMemory, nullptr);
 
 	m_imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
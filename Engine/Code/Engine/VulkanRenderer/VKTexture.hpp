@@ -2,6 +2,7 @@
 #include "Engine/Enumerations/TextureFormat.hpp"
 #include <string>
 #include "Engine/Math/IntVector2.hpp"
+#include "Engine/Memory/MemoryTracker.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Forward Declarations
@@ -23,6 +24,8 @@ private:
 	~VKTexture();
 
 public:
+	MEMORY_TAG_CLASS(MEMORY_TAG_TEXTURE)
+
 	//-----------------------------------------------------------------------------------------------
 	// Accessors/Mutators
 	void*			GetHandle() const { return m_texHandle; }